@@ -249,6 +249,24 @@ public:
         *this << cell;
     }
 
+    /**
+     * Elements added by growing the array are not reset: they retain
+     * whatever values were last stored in their slots, so callers are
+     * expected to overwrite them (e.g. via load() on an accessor).
+     */
+    inline
+    __host__ __device__
+    void resize(std::size_t new_elements)
+    {
+#ifndef __CUDA_ARCH__
+        if (new_elements > SIZE) {
+            throw std::out_of_range("capacity exceeded");
+        }
+#endif
+
+        elements = new_elements;
+    }
+
     inline
     __host__ __device__
     std::size_t size() const
@@ -3,6 +3,7 @@
 #include <libgeodecomp/io/simpleinitializer.h>
 #include <libgeodecomp/io/simplecellplotter.h>
 #include <libgeodecomp/io/tracingwriter.h>
+#include <libgeodecomp/misc/counterbasedrandom.h>
 
 using namespace LibGeoDecomp;
 
@@ -26,15 +27,20 @@ public:
 
     enum State {EMPTY, FOOD, IDLE_ANT, BUSY_ANT, BARRIER};
     static const double PI;
+    static const unsigned SEED = 1234;
 
-    explicit Cell(State state=EMPTY) :
+    explicit Cell(State state=EMPTY, unsigned id=0) :
         state(state),
         posX(0),
         posY(0),
-        dropFood(false)
+        dropFood(false),
+        id(id),
+        step(0)
     {
+        // the initial heading is drawn from a separate stream, so it
+        // doesn't coincide with the first turn in nano step 0:
         if (isAnt())
-            randomTurn();
+            randomTurn(0, 1);
     }
 
     template<typename COORD_MAP>
@@ -63,7 +69,7 @@ public:
                         if (targetCell.state == FOOD && state == BUSY_ANT) {
                             dropFood = true;
                         }
-                        randomTurn();
+                        randomTurn(nanoStep);
                     }
                 }
             }
@@ -95,7 +101,7 @@ public:
                         if (neighborhood[Coord<2>(0, 0)].state == FOOD) {
                             state = BUSY_ANT;
                             dropFood = false;
-                            randomTurn();
+                            randomTurn(nanoStep);
                         }
                     }
                 }
@@ -104,11 +110,14 @@ public:
                     if (neighborhood[target].incoming == 1) {
                         *this = Cell(dropFood? FOOD :EMPTY);
                     } else {
-                        randomTurn();
+                        randomTurn(nanoStep);
                     }
                 }
             }
 
+            // cells may have been replaced above, but all of them
+            // share the same time step:
+            step = neighborhood[Coord<2>(0, 0)].step + 1;
         }
     }
 
@@ -130,10 +139,14 @@ private:
     int incoming;
     Coord<2> target;
     bool dropFood;
+    // each ant draws from its own random stream, so its path doesn't
+    // depend on the order in which cells are being updated:
+    unsigned id;
+    unsigned step;
 
-    void randomTurn()
+    void randomTurn(unsigned nanoStep, unsigned stream = 0)
     {
-        dir = rand() % 360;
+        dir = CounterBasedRandom(SEED, id, step, nanoStep, stream).genUnsigned(360);
         posX = 0;
         posY = 0;
         target = Coord<2>(0, 0);
@@ -180,20 +193,22 @@ public:
         int numAnts =  100;
         int numFood = 500;
 
+        CounterBasedRandom random(Cell::SEED, Coord<2>(), 0);
+
         for (int i = 0; i < numFood; ++i) {
-            ret->set(randCoord(), Cell(Cell::FOOD));
+            ret->set(randCoord(&random), Cell(Cell::FOOD));
         }
 
         for (int i = 0; i < numAnts; ++i) {
-            ret->set(randCoord(), Cell(Cell::IDLE_ANT));
+            ret->set(randCoord(&random), Cell(Cell::IDLE_ANT, i));
         }
     }
 
 private:
-    Coord<2> randCoord() const
+    Coord<2> randCoord(CounterBasedRandom *random) const
     {
-        int x = rand() % gridDimensions().x();
-        int y = rand() % gridDimensions().y();
+        int x = random->genUnsigned(gridDimensions().x());
+        int y = random->genUnsigned(gridDimensions().y());
         return Coord<2>(x, y);
     }
 };
@@ -238,7 +253,6 @@ public:
 
 void runSimulation()
 {
-    srand(1234);
     int outputFrequency = 1;
     CellInitializer *init = new CellInitializer();
     SerialSimulator<Cell> sim(init);
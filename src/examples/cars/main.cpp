@@ -5,6 +5,7 @@
 #include <libgeodecomp/io/simpleinitializer.h>
 #include <libgeodecomp/io/tracingwriter.h>
 #include <libgeodecomp/io/visitwriter.h>
+#include <libgeodecomp/misc/counterbasedrandom.h>
 #include <libgeodecomp/io/remotesteerer.h>
 #include <libgeodecomp/parallelization/serialsimulator.h>
 #include <libgeodecomp/storage/dataaccessor.h>
@@ -30,10 +31,14 @@ public:
         public APITraits::HasNanoSteps<2>
     {};
 
-    explicit Cell(int direction = FREE, int border = 0, const int rate = 5) :
+    static const unsigned SEED = 47;
+
+    explicit Cell(int direction = FREE, int border = 0, const int rate = 5, unsigned id = 0) :
         direction(direction),
         border(border),
-        rate(rate)
+        rate(rate),
+        id(id),
+        step(0)
     {}
 
     // fixme: shorten by decomposition
@@ -79,18 +84,22 @@ public:
             }
         }
         if (nanoStep == 1) {
+            CounterBasedRandom random(SEED, id, step, nanoStep);
+
             if ((direction == FREE) && (border == 1)) {
-                int random_integer = (rand()%100);;
+                int random_integer = random.genUnsigned(100);
                 if (random_integer >= (100 - rate)) {
                     direction = SOUTH;
                 }
             }
             if ((direction == FREE) && (border == -1)) {
-                int random_integer = (rand()%100);;
+                int random_integer = random.genUnsigned(100);
                 if (random_integer >= (100 - rate)) {
                     direction = EAST;
                 }
             }
+
+            ++step;
         }
     }
 
@@ -98,6 +107,12 @@ private:
     int direction;
     int border;
     int rate;
+    // cars enter only at the borders, each border cell draws from
+    // its own random stream:
+    unsigned id;
+    // all cells are updated in lockstep, so counting the steps
+    // locally yields the global time step:
+    unsigned step;
 };
 
 class CellInitializer : public SimpleInitializer<Cell>
@@ -110,13 +125,13 @@ public:
     virtual void grid(GridBase<Cell, 2> *ret)
     {
         for (int i = 1; i < 90; ++i) {
-            ret->set(Coord<2>(i, 89), Cell(0, 1));
+            ret->set(Coord<2>(i, 89), Cell(0, 1, 5, 90 + i));
         }
 
         for (int j = 0; j < 89; ++j) {
             for (int i = 0; i < 90; ++i) {
                 if (i == 0) {
-                    ret->set(Coord<2>(i, j), Cell(0, -1));
+                    ret->set(Coord<2>(i, j), Cell(0, -1, 5, j));
                 } else {
                     ret->set(Coord<2>(i, j), Cell(0));
                 }
@@ -9,7 +9,8 @@ class ConwayCell
 public:
     class API :
         public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
-        public APITraits::HasCubeTopology<3>
+        public APITraits::HasCubeTopology<3>,
+        public APITraits::HasActiveRegion
     {};
 
     explicit ConwayCell(const bool& alive = false) :
@@ -43,6 +44,11 @@ public:
         }
     }
 
+    bool reachedFixedPoint(const ConwayCell& previousState) const
+    {
+        return alive == previousState.alive;
+    }
+
     char alive;
 };
 
@@ -10,6 +10,7 @@
 #include <libgeodecomp/loadbalancer/noopbalancer.h>
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/parallelization/hiparsimulator.h>
+#include <libgeodecomp/storage/linearstencil.h>
 #include <libflatarray/short_vec.hpp>
 
 using namespace LibGeoDecomp;
@@ -25,37 +26,22 @@ public:
         public APITraits::HasPredefinedMPIDataType<double>
     {};
 
+    typedef LinearStencil<
+        StencilWeight< 0,  0, -1, 1, 6>,
+        StencilWeight< 0, -1,  0, 1, 6>,
+        StencilWeight<-1,  0,  0, 1, 6>,
+        StencilWeight< 1,  0,  0, 1, 6>,
+        StencilWeight< 0,  1,  0, 1, 6>,
+        StencilWeight< 0,  0,  1, 1, 6> > Jacobi;
+
     inline explicit Cell(double v = 0) :
         temp(v)
     {}
 
     template<typename NEIGHBORHOOD>
-    static void updateLineX(Cell *target, long *x, long endX, const NEIGHBORHOOD& hood, const int nanoStep)
+    static void updateLineX(Cell *target, long *x, long endX, const NEIGHBORHOOD& hood, const int /* nanoStep */)
     {
-        typedef LibFlatArray::short_vec<double, 16> MyShortVec;
-        LIBFLATARRAY_LOOP_PEELER(MyShortVec, long, (*x), endX, updateLineImplementation, target, hood, nanoStep);
-    }
-
-    template<typename DOUBLE, typename NEIGHBORHOOD>
-    static void updateLineImplementation(
-        long& x,
-        long endX,
-        Cell *target,
-        const NEIGHBORHOOD& hood,
-        const int /* nanoStep */)
-    {
-        DOUBLE oneSixth = 1.0 / 6.0;
-
-        for (; x < endX; x += DOUBLE::ARITY) {
-            DOUBLE buf = &hood[FixedCoord< 0,  0, -1>()].temp;
-            buf += &hood[FixedCoord< 0,  -1,  0>()].temp;
-            buf += &hood[FixedCoord<-1,   0,  0>()].temp;
-            buf += &hood[FixedCoord< 1,   0,  0>()].temp;
-            buf += &hood[FixedCoord< 0,   1,  0>()].temp;
-            buf += &hood[FixedCoord< 0,   0,  1>()].temp;
-            buf *= oneSixth;
-            &target[x].temp << buf;
-        }
+        Jacobi::updateLineX<LibFlatArray::short_vec<double, 16> >(target, x, endX, hood, &Cell::temp);
     }
 
     double temp;
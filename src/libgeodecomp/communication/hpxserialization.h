@@ -30,6 +30,9 @@ public:
     static void serialize(ARCHIVE& archive, LibGeoDecomp::Chronometer& object, const unsigned /*version*/)
     {
         archive & object.totalTimes;
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        archive & object.totalCounters;
+#endif
     }
 
     template<typename ARCHIVE>
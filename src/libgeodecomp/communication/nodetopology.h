@@ -0,0 +1,83 @@
+#ifndef LIBGEODECOMP_COMMUNICATION_NODETOPOLOGY_H
+#define LIBGEODECOMP_COMMUNICATION_NODETOPOLOGY_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+
+#include <mpi.h>
+#include <map>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Discovers which ranks of a communicator share a node (i.e. are
+ * able to share memory), via MPI_Comm_split_type(). Nodes are
+ * numbered in the order of their lowest rank, so rank 0 always
+ * resides on node 0. Construction is a collective operation.
+ */
+class NodeTopology
+{
+public:
+    friend class NodeTopologyTest;
+
+    explicit NodeTopology(MPI_Comm communicator = MPI_COMM_WORLD) :
+        numNodesCounter(0)
+    {
+        MPILayer mpiLayer(communicator);
+        int rank = mpiLayer.rank();
+
+        // using the rank as key makes the lowest rank of each node
+        // the root of its node-local communicator:
+        MPI_Comm nodeComm;
+        MPI_Comm_split_type(communicator, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &nodeComm);
+        int leader = rank;
+        MPI_Bcast(&leader, 1, MPI_INT, 0, nodeComm);
+        MPI_Comm_free(&nodeComm);
+
+        std::vector<int> leaders = mpiLayer.allGather(leader);
+        std::map<int, int> leaderToNode;
+        for (std::size_t i = 0; i < leaders.size(); ++i) {
+            if (leaderToNode.count(leaders[i]) == 0) {
+                leaderToNode[leaders[i]] = numNodesCounter++;
+            }
+            nodes << leaderToNode[leaders[i]];
+        }
+    }
+
+    /**
+     * Returns the node ID for each rank.
+     */
+    inline const std::vector<int>& getNodes() const
+    {
+        return nodes;
+    }
+
+    inline int node(int rank) const
+    {
+        return nodes[rank];
+    }
+
+    inline int numNodes() const
+    {
+        return numNodesCounter;
+    }
+
+    inline bool sameNode(int rankA, int rankB) const
+    {
+        return nodes[rankA] == nodes[rankB];
+    }
+
+private:
+    std::vector<int> nodes;
+    int numNodesCounter;
+};
+
+}
+
+#endif
+
+#endif
@@ -1,4 +1,5 @@
 #include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/misc/chronometer.h>
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
 #include <libgeodecomp/misc/testhelper.h>
 
@@ -65,6 +66,34 @@ public:
         }
     }
 
+    void testGatherChronometer()
+    {
+        MPILayer layer;
+        Chronometer chrono;
+        chrono.addTime<TimeCompute>(layer.rank() + 1);
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        chrono.rawTotalCounters()[TimeCompute::ID * PerfCounters::NUM_COUNTERS + PerfCounters::CYCLES] =
+            10 * (layer.rank() + 1);
+#endif
+
+        std::vector<Chronometer> stats = layer.gather(chrono, 0);
+        if (layer.rank() != 0) {
+            TS_ASSERT_EQUALS(std::size_t(0), stats.size());
+            return;
+        }
+
+        TS_ASSERT_EQUALS(std::size_t(layer.size()), stats.size());
+        for (int i = 0; i < layer.size(); ++i) {
+            TS_ASSERT_EQUALS(i + 1,        stats[i].interval<TimeCompute>());
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+            TS_ASSERT_EQUALS(10 * (i + 1), stats[i].counter<TimeCompute>(PerfCounters::CYCLES));
+#else
+            TS_ASSERT_EQUALS(0,            stats[i].counter<TimeCompute>(PerfCounters::CYCLES));
+#endif
+            TS_ASSERT_EQUALS(0,            stats[i].counter<TimeCompute>(PerfCounters::INSTRUCTIONS));
+        }
+    }
+
     void testBroadcast()
     {
         MPILayer layer;
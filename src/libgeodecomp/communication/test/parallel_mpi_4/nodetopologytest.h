@@ -0,0 +1,68 @@
+#include <libgeodecomp/communication/nodetopology.h>
+#include <libgeodecomp/geometry/partitions/nodeawarepartition.h>
+#include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class NodeTopologyTest : public CxxTest::TestSuite
+{
+public:
+    void testBasic()
+    {
+        MPILayer mpiLayer;
+        NodeTopology topology;
+
+        TS_ASSERT_EQUALS(std::size_t(4), topology.getNodes().size());
+        TS_ASSERT_EQUALS(0, topology.node(0));
+        TS_ASSERT_LESS_THAN_EQUALS(1, topology.numNodes());
+        TS_ASSERT_LESS_THAN_EQUALS(topology.numNodes(), 4);
+
+        // our node ID should cover exactly those ranks which share
+        // memory with us:
+        MPI_Comm nodeComm;
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm);
+        int localRanks;
+        MPI_Comm_size(nodeComm, &localRanks);
+        MPI_Comm_free(&nodeComm);
+
+        int counter = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (topology.sameNode(i, mpiLayer.rank())) {
+                ++counter;
+            }
+        }
+        TS_ASSERT_EQUALS(localRanks, counter);
+    }
+
+    void testPartition()
+    {
+        NodeTopology topology;
+        std::vector<std::size_t> weights(4, 100);
+        NodeAwarePartition<ZCurvePartition<2> > partition(
+            Coord<2>(), Coord<2>(20, 20), 0, weights, topology.getNodes());
+
+        TS_ASSERT_EQUALS(topology.getNodes(), partition.getNodes());
+        TS_ASSERT_EQUALS(
+            NodeAwarePartition<ZCurvePartition<2> >::placement(topology.getNodes()),
+            partition.getPlacement());
+    }
+
+    void testPartitionOnSubsetOfRanks()
+    {
+        // constructing a partition must not involve any collective
+        // operation, otherwise this would deadlock:
+        MPILayer mpiLayer;
+        if (mpiLayer.rank() == 0) {
+            std::vector<std::size_t> weights(4, 100);
+            NodeAwarePartition<ZCurvePartition<2> > partition(Coord<2>(), Coord<2>(20, 20), 0, weights);
+            TS_ASSERT_EQUALS(std::size_t(4), partition.getNodes().size());
+        }
+        mpiLayer.barrier();
+    }
+};
+
+}
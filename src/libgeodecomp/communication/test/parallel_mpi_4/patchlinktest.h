@@ -19,11 +19,44 @@
 #include <libgeodecomp/io/testinitializer.h>
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/misc/testhelper.h>
+#include <libgeodecomp/storage/soaboxcell.h>
 #include <libgeodecomp/storage/soagrid.h>
 
 namespace LibGeoDecomp {}
 using namespace LibGeoDecomp;
 
+/**
+ * Test particle for SoABoxCell, which is transmitted via pack()/unpack()
+ */
+class PackedParticle
+{
+public:
+    class API : public APITraits::HasCubeTopology<2>
+    {};
+
+    explicit PackedParticle(
+        const FloatCoord<2>& pos = FloatCoord<2>(),
+        const int id = 0) :
+        posX(pos[0]),
+        posY(pos[1]),
+        id(id)
+    {}
+
+    template<typename CONTAINER, typename NEIGHBORS>
+    static void updateBox(CONTAINER& /* particles */, const NEIGHBORS& /* hood */, int /* nanoStep */)
+    {}
+
+    double posX;
+    double posY;
+    int id;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    PackedParticle,
+    ((double)(posX))
+    ((double)(posY))
+    ((int)(id)))
+
 namespace LibGeoDecomp {
 
 /**
@@ -63,6 +96,9 @@ public:
 
     typedef DisplacedGrid<MyComplicatedCell> GridType3;
 
+    typedef SoABoxCell<PackedParticle, 20> PackedCellType;
+    typedef DisplacedGrid<PackedCellType> GridType4;
+
     void setUp()
     {
         mpiLayer.reset(new MPILayer());
@@ -379,6 +415,80 @@ public:
 #endif
     }
 
+    void testPacking()
+    {
+        Coord<2> dim(30, 20);
+        CoordBox<2> box(Coord<2>(), dim);
+        Region<2> boxRegion;
+        boxRegion << box;
+
+        GridType4 sendGrid(box);
+        GridType4 recvGrid(box);
+
+        // boxes are sparsely populated, so packing pays off:
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            PackedCellType cell(FloatCoord<2>(*i), FloatCoord<2>(1, 1));
+            for (int j = 0; j < (i->x() % 4); ++j) {
+                cell << PackedParticle(FloatCoord<2>(*i), mpiLayer->rank() * 1000 + j);
+            }
+            sendGrid.set(*i, cell);
+        }
+
+        std::vector<Region<2> > regions(mpiLayer->size());
+        for (int i = 0; i < mpiLayer->size(); ++i) {
+            regions[i] << Streak<2>(Coord<2>(0, i), dim.x());
+        }
+
+        PatchLink<GridType4>::Accepter accepter(
+            regions[mpiLayer->rank()],
+            0,
+            2701,
+            MPI_CHAR);
+        accepter.charge(4, 4, 1);
+        accepter.put(sendGrid, boxRegion, dim, 4, mpiLayer->rank());
+
+        TS_ASSERT_LESS_THAN(
+            accepter.buffer.size(),
+            SerializationBuffer<PackedCellType>::storageSize(regions[mpiLayer->rank()]));
+
+        std::vector<SharedPtr<PatchLink<GridType4>::Provider>::Type> providers;
+        if (mpiLayer->rank() == 0) {
+            for (int i = 0; i < mpiLayer->size(); ++i) {
+                providers.push_back(
+                    SharedPtr<PatchLink<GridType4>::Provider>::Type(
+                        new PatchLink<GridType4>::Provider(
+                            regions[i],
+                            i,
+                            2701,
+                            MPI_CHAR)));
+
+                providers.back()->charge(4, 4, 1);
+            }
+
+            for (int i = 0; i < mpiLayer->size(); ++i) {
+                providers[i]->get(&recvGrid, boxRegion, dim, 4, i);
+            }
+
+            for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+                PackedCellType cell = recvGrid.get(*i);
+
+                if (i->y() < mpiLayer->size()) {
+                    TS_ASSERT_EQUALS(FloatCoord<2>(*i), cell.getOrigin());
+                    TS_ASSERT_EQUALS(std::size_t(i->x() % 4), cell.size());
+                    for (std::size_t j = 0; j < cell.size(); ++j) {
+                        TS_ASSERT_EQUALS(double(i->x()),            cell[j].posX);
+                        TS_ASSERT_EQUALS(double(i->y()),            cell[j].posY);
+                        TS_ASSERT_EQUALS(int(i->y() * 1000 + j), cell[j].id);
+                    }
+                } else {
+                    TS_ASSERT_EQUALS(std::size_t(0), cell.size());
+                }
+            }
+        }
+
+        accepter.wait();
+    }
+
 private:
     int tag;
 
@@ -0,0 +1,158 @@
+#include <cxxtest/TestSuite.h>
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/unstructuredpatchlink.h>
+#include <libgeodecomp/misc/unstructuredtestcell.h>
+#include <libgeodecomp/storage/reorderingunstructuredgrid.h>
+#include <libgeodecomp/storage/unstructuredgrid.h>
+#include <libgeodecomp/storage/unstructuredsoagrid.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class UnstructuredPatchLinkTest : public CxxTest::TestSuite
+{
+public:
+    void testAoS()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+#ifdef LIBGEODECOMP_WITH_MPI_NEIGHBOR_COLLECTIVES
+        typedef UnstructuredTestCell<> TestCellType;
+        typedef ReorderingUnstructuredGrid<UnstructuredGrid<TestCellType, 1, double, 4, 4> > GridType;
+        checkExchange<GridType>();
+#endif
+#endif
+    }
+
+    void testSoA()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+#ifdef LIBGEODECOMP_WITH_MPI_NEIGHBOR_COLLECTIVES
+        typedef UnstructuredTestCellSoA1 TestCellType;
+        typedef ReorderingUnstructuredGrid<UnstructuredSoAGrid<TestCellType, 1, double, 4, 4> > GridType;
+        checkExchange<GridType>();
+#endif
+#endif
+    }
+
+private:
+#ifdef LIBGEODECOMP_WITH_CPP14
+#ifdef LIBGEODECOMP_WITH_MPI_NEIGHBOR_COLLECTIVES
+    /**
+     * Each rank owns 100 cells and sends a scattered subset of them
+     * to its successor. Rank 3 has no successor, rank 0 no
+     * predecessor, so both also cover the case of processes which
+     * only send or only receive. Before the last exchange the
+     * target grid gets reordered, which has to invalidate the
+     * fragments compiled for it earlier.
+     */
+    template<typename GRID_TYPE>
+    void checkExchange()
+    {
+        typedef typename GRID_TYPE::CellType CellType;
+        typedef UnstructuredPatchLink<GRID_TYPE> LinkType;
+
+        MPILayer mpiLayer;
+        int rank = mpiLayer.rank();
+        int size = mpiLayer.size();
+
+        Region<1> boundingRegion;
+        boundingRegion << Streak<1>(Coord<1>(0), 100 * size);
+        GRID_TYPE gridA(boundingRegion, CellType(), CellType());
+        GRID_TYPE gridB(boundingRegion, CellType(), CellType());
+
+        typename LinkType::RegionMap sendRegions;
+        typename LinkType::RegionMap recvRegions;
+        if (rank < (size - 1)) {
+            sendRegions[rank + 1] = fragment(rank);
+        }
+        if (rank > 0) {
+            recvRegions[rank - 1] = fragment(rank - 1);
+        }
+
+        typename LinkType::ExchangePtr exchange(
+            new typename LinkType::Exchange(sendRegions, recvRegions));
+        typename LinkType::Accepter accepter(exchange);
+        typename LinkType::Provider provider(exchange);
+        accepter.charge(2, 8, 2);
+        provider.charge(2, 8, 2);
+
+        TS_ASSERT_EQUALS(sendRegions.size(), exchange->sendRankVec().size());
+        TS_ASSERT_EQUALS(recvRegions.size(), exchange->recvRankVec().size());
+
+        for (int nanoStep = 2; nanoStep <= 6; nanoStep += 2) {
+            // alternate between grids to exercise the cache of compiled fragments:
+            GRID_TYPE *source = (nanoStep == 4) ? &gridB : &gridA;
+            GRID_TYPE *target = (nanoStep == 4) ? &gridA : &gridB;
+
+            if (nanoStep == 6) {
+                std::size_t oldLayoutID = target->layoutID();
+                target->setWeights(0, weights<typename GRID_TYPE::SparseMatrix>(100 * size));
+                TS_ASSERT_DIFFERS(oldLayoutID, target->layoutID());
+            }
+
+            for (int i = 0; i < 100; ++i) {
+                int id = rank * 100 + i;
+                source->set(Coord<1>(id), CellType(id, nanoStep, true));
+            }
+
+            // non-matching time steps need to be ignored:
+            provider.get(target, Region<1>(), Coord<1>(), nanoStep - 1, rank);
+            accepter.put(*source, Region<1>(), Coord<1>(), nanoStep - 1, rank);
+            accepter.put(*source, Region<1>(), Coord<1>(), nanoStep,     rank);
+            provider.get(target, Region<1>(), Coord<1>(), nanoStep,     rank);
+
+            if (rank > 0) {
+                Region<1> expected = fragment(rank - 1);
+                for (int id = (rank - 1) * 100; id < rank * 100; ++id) {
+                    Coord<1> c(id);
+                    CellType cell = target->get(c);
+
+                    if (expected.count(c)) {
+                        TS_ASSERT_EQUALS(id,       cell.id);
+                        TS_ASSERT_EQUALS(nanoStep, int(cell.cycleCounter));
+                        TS_ASSERT(cell.isValid);
+                    } else {
+                        TS_ASSERT_EQUALS(-1, cell.id);
+                    }
+                }
+            }
+        }
+
+        // last nano step is exclusive:
+        TS_ASSERT(accepter.requestedNanoSteps.empty());
+    }
+
+    /**
+     * Row lengths vary within each chunk of 4 cells, so that
+     * setWeights() reverses the cells' order within each chunk.
+     */
+    template<typename SPARSE_MATRIX>
+    SPARSE_MATRIX weights(int numCells)
+    {
+        SPARSE_MATRIX ret;
+        for (int id = 0; id < numCells; ++id) {
+            for (int neighbor = 0; neighbor < (id % 4); ++neighbor) {
+                ret << std::make_pair(Coord<2>(id, neighbor), 1.0);
+            }
+        }
+        return ret;
+    }
+
+    Region<1> fragment(int rank)
+    {
+        Region<1> ret;
+        int offset = rank * 100;
+        ret << Streak<1>(Coord<1>(offset +  0), offset +  5);
+        ret << Streak<1>(Coord<1>(offset + 17), offset + 18);
+        ret << Streak<1>(Coord<1>(offset + 40), offset + 63);
+        ret << Streak<1>(Coord<1>(offset + 97), offset + 100);
+        return ret;
+    }
+#endif
+#endif
+};
+
+}
@@ -942,11 +942,18 @@ Typemaps::generateMapLibGeoDecomp_Chronometer() {
     char fakeObject[sizeof(LibGeoDecomp::Chronometer)];
     LibGeoDecomp::Chronometer *obj = (LibGeoDecomp::Chronometer*)fakeObject;
 
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+    const int count = 2;
+#else
     const int count = 1;
+#endif
     int lengths[count];
 
     // sort addresses in ascending order
     MemberSpec rawSpecs[] = {
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        MemberSpec(getAddress(&obj->totalCounters), lookup<double >(), Chronometer::NUM_COUNTER_VALUES),
+#endif
         MemberSpec(getAddress(&obj->totalTimes), lookup<FixedArray<double,Chronometer::NUM_INTERVALS > >(), 1)
     };
     std::sort(rawSpecs, rawSpecs + count, addressLower);
@@ -0,0 +1,396 @@
+#ifndef LIBGEODECOMP_COMMUNICATION_UNSTRUCTUREDPATCHLINK_H
+#define LIBGEODECOMP_COMMUNICATION_UNSTRUCTUREDPATCHLINK_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/patchlink.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/misc/limits.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/patchaccepter.h>
+#include <libgeodecomp/storage/patchprovider.h>
+#include <libgeodecomp/storage/serializationbuffer.h>
+
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+// MPI_Neighbor_alltoallv() and friends were introduced with MPI 3.0:
+#if MPI_VERSION >= 3
+#define LIBGEODECOMP_WITH_MPI_NEIGHBOR_COLLECTIVES
+#endif
+
+namespace LibGeoDecomp {
+
+#ifdef LIBGEODECOMP_WITH_MPI_NEIGHBOR_COLLECTIVES
+
+/**
+ * Halo exchange for unstructured grids (i.e.
+ * ReorderingUnstructuredGrid). Contrary to PatchLink, which requires
+ * one Accepter/Provider pair per neighboring process, this class
+ * handles all neighbors of a process at once: the ghost zone
+ * fragments are sent via a single MPI_Ineighbor_alltoallv() on a
+ * distributed graph communicator which is derived from the fragment
+ * maps of a PartitionManager.
+ *
+ * Unstructured ghost zones are typically scattered, so saving them
+ * via saveRegion() would need to look up every single ID. Instead
+ * the fragments are compiled (see
+ * ReorderingUnstructuredGrid::compileRegion()) into lists of
+ * physical Streaks once per grid and are reused for every exchange.
+ *
+ * The exchange is collective: all processes within the communicator
+ * need to set up their links at the same time, even if they have no
+ * neighbors.
+ */
+template<class GRID_TYPE>
+class UnstructuredPatchLink
+{
+public:
+    friend class UnstructuredPatchLinkTest;
+
+    typedef typename GRID_TYPE::CellType CellType;
+    typedef typename SerializationBuffer<CellType>::BufferType BufferType;
+    typedef typename GRID_TYPE::PhysicalStreakVec PhysicalStreakVec;
+    typedef std::map<int, Region<1> > RegionMap;
+
+    const static int DIM = GRID_TYPE::DIM;
+
+    /**
+     * Holds the graph communicator, the compiled ghost zone
+     * fragments and the buffers. Shared by Accepter and Provider.
+     */
+    class Exchange
+    {
+    public:
+        /**
+         * sendRegions maps target ranks to the Regions they should
+         * receive from us (i.e. our inner ghost zone fragments),
+         * recvRegions source ranks to the Regions we'll receive
+         * (i.e. our outer ghost zone fragments).
+         */
+        Exchange(
+            const RegionMap& sendRegions,
+            const RegionMap& recvRegions,
+            MPI_Comm communicator = MPI_COMM_WORLD,
+            const MPI_Datatype& cellMPIDatatype = SerializationBuffer<CellType>::cellMPIDataType()) :
+            cellMPIDatatype(cellMPIDatatype),
+            requestInFlight(false)
+        {
+            addRegions(sendRegions, &sendRanks, &this->sendRegions, &sendCounts, &sendDisplacements);
+            addRegions(recvRegions, &recvRanks, &this->recvRegions, &recvCounts, &recvDisplacements);
+
+            sendBuffer.resize(sendDisplacements.back() + (sendCounts.empty() ? 0 : sendCounts.back()));
+            recvBuffer.resize(recvDisplacements.back() + (recvCounts.empty() ? 0 : recvCounts.back()));
+            sendDisplacements.pop_back();
+            recvDisplacements.pop_back();
+
+            MPI_Dist_graph_create_adjacent(
+                communicator,
+                recvRanks.size(),
+                recvRanks.data(),
+                MPI_UNWEIGHTED,
+                sendRanks.size(),
+                sendRanks.data(),
+                MPI_UNWEIGHTED,
+                MPI_INFO_NULL,
+                false,
+                &graphCommunicator);
+        }
+
+        ~Exchange()
+        {
+            wait();
+            MPI_Comm_free(&graphCommunicator);
+        }
+
+        /**
+         * Packs the fragments for all neighbors and initiates their
+         * transmission.
+         */
+        void send(const GRID_TYPE& grid)
+        {
+            wait();
+
+            const Compiled& compiled = compile(grid);
+            for (std::size_t i = 0; i < sendRanks.size(); ++i) {
+                grid.saveStreaks(
+                    &sendBuffer[sendDisplacements[i]],
+                    compiled.send[i],
+                    sendRegions[i].size());
+            }
+
+            MPI_Ineighbor_alltoallv(
+                sendBuffer.data(), sendCounts.data(), sendDisplacements.data(), cellMPIDatatype,
+                recvBuffer.data(), recvCounts.data(), recvDisplacements.data(), cellMPIDatatype,
+                graphCommunicator,
+                &request);
+            requestInFlight = true;
+        }
+
+        /**
+         * Waits for the transmission initiated by send() to complete
+         * and unpacks the received fragments into grid.
+         */
+        void recv(GRID_TYPE *grid)
+        {
+            if (!requestInFlight) {
+                throw std::logic_error("UnstructuredPatchLink::Exchange::recv() called without prior send()");
+            }
+
+            wait();
+
+            const Compiled& compiled = compile(*grid);
+            for (std::size_t i = 0; i < recvRanks.size(); ++i) {
+                grid->loadStreaks(
+                    &recvBuffer[recvDisplacements[i]],
+                    compiled.recv[i],
+                    recvRegions[i].size());
+            }
+        }
+
+        inline void wait()
+        {
+            if (requestInFlight) {
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+                requestInFlight = false;
+            }
+        }
+
+        inline const std::vector<int>& sendRankVec() const
+        {
+            return sendRanks;
+        }
+
+        inline const std::vector<int>& recvRankVec() const
+        {
+            return recvRanks;
+        }
+
+        inline MPI_Comm communicator() const
+        {
+            return graphCommunicator;
+        }
+
+    private:
+        /**
+         * Upper bound for the number of grid layouts we keep compiled
+         * fragments for. Grids get reordered (and thus change their
+         * layout) only rarely, so this mainly keeps the cache from
+         * growing without bounds.
+         */
+        static const std::size_t MAX_CACHED_LAYOUTS = 8;
+
+        /**
+         * Fragments translated to physical IDs of one grid.
+         */
+        class Compiled
+        {
+        public:
+            std::vector<PhysicalStreakVec> send;
+            std::vector<PhysicalStreakVec> recv;
+        };
+
+        MPI_Comm graphCommunicator;
+        MPI_Datatype cellMPIDatatype;
+        MPI_Request request;
+        bool requestInFlight;
+        std::vector<int> sendRanks;
+        std::vector<int> recvRanks;
+        std::vector<Region<1> > sendRegions;
+        std::vector<Region<1> > recvRegions;
+        std::vector<int> sendCounts;
+        std::vector<int> recvCounts;
+        std::vector<int> sendDisplacements;
+        std::vector<int> recvDisplacements;
+        BufferType sendBuffer;
+        BufferType recvBuffer;
+        // Steppers alternate between (usually) two grids, hence we
+        // cache the compiled fragments for each of their layouts:
+        std::map<std::size_t, Compiled> compiledFragments;
+
+        static void addRegions(
+            const RegionMap& regions,
+            std::vector<int> *ranks,
+            std::vector<Region<1> > *fragments,
+            std::vector<int> *counts,
+            std::vector<int> *displacements)
+        {
+            displacements->push_back(0);
+
+            for (typename RegionMap::const_iterator i = regions.begin(); i != regions.end(); ++i) {
+                if (i->second.empty()) {
+                    continue;
+                }
+
+                std::size_t size = SerializationBuffer<CellType>::storageSize(i->second);
+                if ((displacements->back() + size) > std::size_t(Limits<int>::getMax())) {
+                    throw std::invalid_argument("buffer size exceeds std::numeric_limits<int>::max()");
+                }
+
+                *ranks << i->first;
+                *fragments << i->second;
+                *counts << int(size);
+                *displacements << int(displacements->back() + size);
+            }
+        }
+
+        const Compiled& compile(const GRID_TYPE& grid)
+        {
+            typename std::map<std::size_t, Compiled>::iterator iter = compiledFragments.find(grid.layoutID());
+            if (iter != compiledFragments.end()) {
+                return iter->second;
+            }
+
+            // layouts of discarded grids will never show up again:
+            if (compiledFragments.size() >= MAX_CACHED_LAYOUTS) {
+                compiledFragments.clear();
+            }
+
+            Compiled& compiled = compiledFragments[grid.layoutID()];
+            for (std::size_t i = 0; i < sendRegions.size(); ++i) {
+                compiled.send << grid.compileRegion(sendRegions[i]);
+            }
+            for (std::size_t i = 0; i < recvRegions.size(); ++i) {
+                compiled.recv << grid.compileRegion(recvRegions[i]);
+            }
+
+            return compiled;
+        }
+    };
+
+    typedef typename SharedPtr<Exchange>::Type ExchangePtr;
+
+    typedef typename PatchLink<GRID_TYPE>::Link Link;
+
+    /**
+     * Initiates the halo exchange whenever the Stepper hands over
+     * the grid at one of the requested time steps. Derives from
+     * PatchLink::Link so an UpdateGroup can manage it alongside
+     * regular PatchLinks; the Link's own buffer remains unused.
+     */
+    class Accepter :
+        public Link,
+        public PatchAccepter<GRID_TYPE>
+    {
+    public:
+        using Link::lastNanoStep;
+        using Link::stride;
+        using PatchAccepter<GRID_TYPE>::checkNanoStepPut;
+        using PatchAccepter<GRID_TYPE>::infinity;
+        using PatchAccepter<GRID_TYPE>::pushRequest;
+        using PatchAccepter<GRID_TYPE>::requestedNanoSteps;
+
+        explicit Accepter(ExchangePtr exchange) :
+            Link(Region<DIM>(), 0, exchange->communicator()),
+            exchange(exchange)
+        {}
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            Link::charge(next, last, newStride);
+            pushRequest(next);
+        }
+
+        virtual void put(
+            const GRID_TYPE& grid,
+            const Region<DIM>& /* validRegion */,
+            const Coord<DIM>& /* globalGridDimensions */,
+            const std::size_t nanoStep,
+            const std::size_t /* rank */)
+        {
+            if (!checkNanoStepPut(nanoStep)) {
+                return;
+            }
+
+            exchange->send(grid);
+
+            std::size_t nextNanoStep = (min)(requestedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                requestedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(requestedNanoSteps);
+        }
+
+    private:
+        ExchangePtr exchange;
+    };
+
+    /**
+     * Completes the halo exchange and copies the received fragments
+     * to the grid.
+     */
+    class Provider :
+        public Link,
+        public PatchProvider<GRID_TYPE>
+    {
+    public:
+        using Link::lastNanoStep;
+        using Link::stride;
+        using PatchProvider<GRID_TYPE>::checkNanoStepGet;
+        using PatchProvider<GRID_TYPE>::infinity;
+        using PatchProvider<GRID_TYPE>::storedNanoSteps;
+
+        explicit Provider(ExchangePtr exchange) :
+            Link(Region<DIM>(), 0, exchange->communicator()),
+            exchange(exchange)
+        {}
+
+        /**
+         * Completes a pending transmission so the exchange can be
+         * torn down safely.
+         */
+        virtual void cleanup()
+        {
+            exchange->wait();
+        }
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            Link::charge(next, last, newStride);
+            storedNanoSteps << next;
+        }
+
+        virtual void get(
+            GRID_TYPE *grid,
+            const Region<DIM>& /* patchableRegion */,
+            const Coord<DIM>& /* globalGridDimensions */,
+            const std::size_t nanoStep,
+            const std::size_t /* rank */,
+            const bool /* remove */ = true)
+        {
+            if (storedNanoSteps.empty() || (nanoStep < (min)(storedNanoSteps))) {
+                return;
+            }
+
+            checkNanoStepGet(nanoStep);
+            exchange->recv(grid);
+
+            std::size_t nextNanoStep = (min)(storedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                storedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(storedNanoSteps);
+        }
+
+    private:
+        ExchangePtr exchange;
+    };
+};
+
+#endif
+
+}
+
+#endif
+#endif
+
+#endif
@@ -4,9 +4,10 @@
 #include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/floatcoord.h>
 #include <libgeodecomp/geometry/plane.h>
-#include <libgeodecomp/misc/random.h>
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
 
+#include <cmath>
+
 namespace LibGeoDecomp {
 
 /**
@@ -24,17 +25,30 @@ public:
 
     explicit ConvexPolytope(
         const COORD& center = COORD(),
-        const COORD& simSpaceDim = COORD()) :
-        center(center),
-        simSpaceDim(simSpaceDim),
-        area(simSpaceDim.prod()),
-        diameter(simSpaceDim.maxElement())
+        const COORD& simSpaceDim = COORD())
+    {
+        reset(center, simSpaceDim);
+    }
+
+    /**
+     * Reinitializes the polytope to cover the whole simulation
+     * space, but retains already allocated storage. This is useful
+     * when generating many polytopes in a row.
+     */
+    void reset(const COORD& newCenter, const COORD& newSimSpaceDim)
     {
+        center = newCenter;
+        simSpaceDim = newSimSpaceDim;
+        area = simSpaceDim.prod();
+        diameter = simSpaceDim.maxElement();
+        myBoundingBox = CoordBox<DIM>();
+
+        limits.clear();
         limits << EquationType(COORD(center[0], 0),              COORD( 0,  1))
                << EquationType(COORD(0, center[1]),              COORD( 1,  0))
                << EquationType(COORD(simSpaceDim[0], center[1]), COORD(-1,  0))
                << EquationType(COORD(center[0], simSpaceDim[1]), COORD( 0, -1));
-        cutPoints = generateCutPoints(limits);
+        generateCutPoints(limits, &cutPoints);
     }
 
     ConvexPolytope& operator<<(const EquationType& eq)
@@ -48,8 +62,9 @@ public:
             }
         }
 
-        std::set<int> deleteSet;
+        std::size_t numDeleted = 0;
         bool newLimitIsSuperfluous = true;
+        deleteFlags.assign(limits.size(), false);
         for (std::size_t i = 0; i < limits.size(); ++i) {
             COORD delta1 = cutPoints[2 * i + 0] - eq.base;
             COORD delta2 = cutPoints[2 * i + 1] - eq.base;
@@ -61,28 +76,28 @@ public:
             }
 
             if (pointIsBelow1 && pointIsBelow2) {
-                deleteSet.insert(i);
+                deleteFlags[i] = true;
+                ++numDeleted;
             }
         }
 
-        if (!deleteSet.empty()) {
-            std::vector<EquationType> newLimits;
+        if (numDeleted > 0) {
+            std::size_t target = 0;
             for (std::size_t i = 0; i < limits.size(); ++i) {
-                if (!deleteSet.count(i)) {
-                    newLimits << limits[i];
+                if (!deleteFlags[i]) {
+                    limits[target++] = limits[i];
                 }
             }
 
-            using std::swap;
-            swap(limits, newLimits);
+            limits.erase(limits.begin() + target, limits.end());
         }
 
         if (!newLimitIsSuperfluous) {
             limits << eq;
         }
 
-        if (!deleteSet.empty() || !newLimitIsSuperfluous) {
-            cutPoints = generateCutPoints(limits);
+        if ((numDeleted > 0) || !newLimitIsSuperfluous) {
+            generateCutPoints(limits, &cutPoints);
         }
 
         return *this;
@@ -180,15 +195,20 @@ public:
             return;
         }
 
+        // sampling on a regular lattice (instead of random points)
+        // keeps this function deterministic and thread-safe:
+        int samplesPerDim = std::ceil(std::sqrt(double(SAMPLES)));
         int hits = 0;
-        for (std::size_t i = 0; i < SAMPLES; ++i) {
-            COORD p = COORD(Random::genDouble(delta[0]),
-                            Random::genDouble(delta[1])) + minCoord;
-            if (includes(p)) {
-                ++hits;
+        for (int y = 0; y < samplesPerDim; ++y) {
+            for (int x = 0; x < samplesPerDim; ++x) {
+                COORD p = COORD((x + 0.5) * delta[0] / samplesPerDim,
+                                (y + 0.5) * delta[1] / samplesPerDim) + minCoord;
+                if (includes(p)) {
+                    ++hits;
+                }
             }
         }
-        area = 1.0 * hits / SAMPLES * delta.prod();
+        area = 1.0 * hits / (samplesPerDim * samplesPerDim) * delta.prod();
 
         double newDiameter = delta.maxElement();
         if (newDiameter > diameter) {
@@ -204,10 +224,15 @@ public:
         return center;
     }
 
+    const COORD& getSimSpaceDim() const
+    {
+        return simSpaceDim;
+    }
+
     /**
-     * The ConvexPolytope's volume is determined via random sampling
-     * integration. Few samples are used, so this method is highly
-     * inaccurate.
+     * The ConvexPolytope's volume is determined via sampling
+     * integration on a regular lattice. Few samples are used, so
+     * this method is highly inaccurate.
      */
     double getVolume() const
     {
@@ -237,6 +262,7 @@ private:
     double diameter;
     std::vector<EquationType> limits;
     std::vector<COORD> cutPoints;
+    std::vector<char> deleteFlags;
 
     template<int DIM>
     static Coord<DIM> farAway()
@@ -249,9 +275,10 @@ private:
         return COORD(c[1], -c[0]);
     }
 
-    std::vector<COORD> generateCutPoints(const std::vector<EquationType>& equations) const
+    void generateCutPoints(const std::vector<EquationType>& equations, std::vector<COORD> *target) const
     {
-        std::vector<COORD> buf(2 * equations.size(), farAway<2>());
+        std::vector<COORD>& buf = *target;
+        buf.assign(2 * equations.size(), farAway<2>());
 
         for (std::size_t i = 0; i < equations.size(); ++i) {
             for (std::size_t j = 0; j < equations.size(); ++j) {
@@ -293,8 +320,6 @@ private:
                 }
             }
         }
-
-        return buf;
     }
 
     COORD cutPoint(EquationType eq1, EquationType eq2) const
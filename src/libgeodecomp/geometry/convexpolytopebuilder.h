@@ -0,0 +1,263 @@
+#ifndef LIBGEODECOMP_GEOMETRY_CONVEXPOLYTOPEBUILDER_H
+#define LIBGEODECOMP_GEOMETRY_CONVEXPOLYTOPEBUILDER_H
+
+#include <libgeodecomp/geometry/convexpolytope.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Cuts a ConvexPolytope with the bisectors between its center and a
+ * whole batch of points at once. This yields the same limits and
+ * shape as inserting all points one by one via
+ * ConvexPolytope::operator<<(), but is much faster for large
+ * batches (e.g. in Voronoi meshing):
+ *
+ * - Points are processed in order of increasing distance, so the
+ *   polygon shrinks quickly, and processing stops once all remaining
+ *   points are farther away than twice the polygon's circumradius.
+ *
+ * - Points are clipped against a lightweight polygon representation,
+ *   whose corners are kept in fixed-capacity Struct of Arrays (SoA)
+ *   buffers so the clipping loops vectorize. Only those points which
+ *   actually cut the polygon are handed on to the ConvexPolytope.
+ *
+ * A builder may be reused for any number of polytopes. It isn't
+ * thread-safe, so each thread needs its own instance.
+ */
+template<typename COORD, typename ID = int, int MAX_CORNERS = 64>
+class ConvexPolytopeBuilder
+{
+public:
+    typedef ConvexPolytope<COORD, ID> PolytopeType;
+
+    /**
+     * ITERATOR needs to be a random access iterator which
+     * dereferences to std::pair<POINT, ID>. Points coinciding with
+     * the polytope's center are ignored.
+     */
+    template<typename ITERATOR>
+    void operator()(PolytopeType *polytope, const ITERATOR& begin, const ITERATOR& end)
+    {
+        const COORD& center = polytope->getCenter();
+        centerX = center[0];
+        centerY = center[1];
+
+        initCorners(*polytope);
+
+        candidates.clear();
+        int index = 0;
+        for (ITERATOR i = begin; i != end; ++i, ++index) {
+            double deltaX = i->first[0] - centerX;
+            double deltaY = i->first[1] - centerY;
+            double distance2 = deltaX * deltaX + deltaY * deltaY;
+            if (distance2 > 0) {
+                candidates.push_back(std::make_pair(distance2, index));
+            }
+        }
+
+        // Sorting all candidates would be too expensive for large
+        // batches. Instead we clip with the nearest few, which
+        // usually yields a tight circumradius, and then sort only
+        // those remaining candidates which are within reach. Ties
+        // are broken by the points' order to keep the results
+        // deterministic.
+        cutting.clear();
+        std::vector<std::pair<double, int> >::iterator middle = candidates.begin() +
+            (std::min)(candidates.size(), std::size_t(PRESELECTION_SIZE));
+        std::nth_element(candidates.begin(), middle, candidates.end());
+        std::sort(candidates.begin(), middle);
+        if (!clipAll(begin, candidates.begin(), middle)) {
+            flush(polytope, begin);
+            return;
+        }
+
+        double cutoff = 4 * maxCornerDistanceSquared();
+        std::vector<std::pair<double, int> >::iterator last = middle;
+        for (std::vector<std::pair<double, int> >::iterator i = middle; i != candidates.end(); ++i) {
+            if (i->first <= cutoff) {
+                *last++ = *i;
+            }
+        }
+        std::sort(middle, last);
+        clipAll(begin, middle, last);
+
+        flush(polytope, begin);
+    }
+
+    /**
+     * Number of points which cut the polygon during the last build.
+     */
+    std::size_t numCuttingPoints() const
+    {
+        return cutting.size();
+    }
+
+private:
+    static const int PRESELECTION_SIZE = 16;
+
+    double centerX;
+    double centerY;
+    int numCorners;
+    double cornersX[MAX_CORNERS];
+    double cornersY[MAX_CORNERS];
+    double newCornersX[MAX_CORNERS];
+    double newCornersY[MAX_CORNERS];
+    double distances[MAX_CORNERS];
+    std::vector<std::pair<double, int> > candidates;
+    std::vector<int> cutting;
+
+    /**
+     * Starts with the simulation space and clips it with all limits
+     * the polytope already has.
+     */
+    void initCorners(const PolytopeType& polytope)
+    {
+        const COORD& dim = polytope.getSimSpaceDim();
+        numCorners = 4;
+        cornersX[0] = 0;
+        cornersY[0] = 0;
+        cornersX[1] = dim[0];
+        cornersY[1] = 0;
+        cornersX[2] = dim[0];
+        cornersY[2] = dim[1];
+        cornersX[3] = 0;
+        cornersY[3] = dim[1];
+
+        const std::vector<typename PolytopeType::EquationType>& limits = polytope.getLimits();
+        for (std::size_t i = 0; i < limits.size(); ++i) {
+            clipHalfSpace(limits[i].base[0], limits[i].base[1], limits[i].dir[0], limits[i].dir[1]);
+        }
+    }
+
+    /**
+     * Clips with all points in the given range of (sorted)
+     * candidates. Returns false if it could stop early as all
+     * remaining points were out of reach.
+     */
+    template<typename ITERATOR>
+    bool clipAll(
+        const ITERATOR& points,
+        const std::vector<std::pair<double, int> >::iterator& begin,
+        const std::vector<std::pair<double, int> >::iterator& end)
+    {
+        double cutoff = 4 * maxCornerDistanceSquared();
+
+        for (std::vector<std::pair<double, int> >::iterator i = begin; i != end; ++i) {
+            if (i->first > cutoff) {
+                return false;
+            }
+
+            ITERATOR point = points;
+            std::advance(point, i->second);
+            if (clip(point->first[0], point->first[1])) {
+                cutting.push_back(i->second);
+                cutoff = 4 * maxCornerDistanceSquared();
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Hands all points which did cut the polygon to the polytope.
+     */
+    template<typename ITERATOR>
+    void flush(PolytopeType *polytope, const ITERATOR& points)
+    {
+        for (std::vector<int>::iterator i = cutting.begin(); i != cutting.end(); ++i) {
+            ITERATOR point = points;
+            std::advance(point, *i);
+            *polytope << *point;
+        }
+    }
+
+    inline double maxCornerDistanceSquared() const
+    {
+        double ret = 0;
+        for (int i = 0; i < numCorners; ++i) {
+            double deltaX = cornersX[i] - centerX;
+            double deltaY = cornersY[i] - centerY;
+            ret = (std::max)(ret, deltaX * deltaX + deltaY * deltaY);
+        }
+
+        return ret;
+    }
+
+    /**
+     * Clips the polygon with the bisector between center and the
+     * given point. Returns true if the bisector touches the polygon,
+     * i.e. ConvexPolytope would record a limit for this point.
+     */
+    inline bool clip(double pointX, double pointY)
+    {
+        double baseX = (centerX + pointX) * 0.5;
+        double baseY = (centerY + pointY) * 0.5;
+        double dirX = centerX - pointX;
+        double dirY = centerY - pointY;
+
+        return clipHalfSpace(baseX, baseY, dirX, dirY);
+    }
+
+    /**
+     * Sutherland-Hodgman clipping, retaining all corners "above" the
+     * plane given by base and dir.
+     */
+    inline bool clipHalfSpace(double baseX, double baseY, double dirX, double dirY)
+    {
+        double minDistance = 1;
+        for (int i = 0; i < numCorners; ++i) {
+            distances[i] = (cornersX[i] - baseX) * dirX + (cornersY[i] - baseY) * dirY;
+        }
+        for (int i = 0; i < numCorners; ++i) {
+            minDistance = (std::min)(minDistance, distances[i]);
+        }
+
+        if (minDistance > 0) {
+            return false;
+        }
+
+        int newNumCorners = 0;
+        for (int i = 0; i < numCorners; ++i) {
+            int next = (i + 1) % numCorners;
+
+            if (distances[i] >= 0) {
+                append(&newNumCorners, cornersX[i], cornersY[i]);
+            }
+
+            if (((distances[i] < 0) && (distances[next] > 0)) ||
+                ((distances[i] > 0) && (distances[next] < 0))) {
+                double weight = distances[i] / (distances[i] - distances[next]);
+                append(
+                    &newNumCorners,
+                    cornersX[i] + weight * (cornersX[next] - cornersX[i]),
+                    cornersY[i] + weight * (cornersY[next] - cornersY[i]));
+            }
+        }
+
+        numCorners = newNumCorners;
+        std::copy(newCornersX, newCornersX + numCorners, cornersX);
+        std::copy(newCornersY, newCornersY + numCorners, cornersY);
+
+        return true;
+    }
+
+    inline void append(int *newNumCorners, double x, double y)
+    {
+        if (*newNumCorners >= MAX_CORNERS) {
+            throw std::logic_error("ConvexPolytopeBuilder: too many corners, increase MAX_CORNERS");
+        }
+
+        newCornersX[*newNumCorners] = x;
+        newCornersY[*newNumCorners] = y;
+        ++*newNumCorners;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_CELLCOSTMAP_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_CELLCOSTMAP_H
+
+#include <libgeodecomp/geometry/coordbox.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/streak.h>
+#include <libgeodecomp/geometry/topologies.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/storage/grid.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace LibGeoDecomp {
+
+/**
+ * Stores the (relative) update cost of every cell in the simulation
+ * space. CostAwarePartition and RecursiveBisectionPartition use it to
+ * cut the domain by accumulated cost instead of by cell count.
+ *
+ * To keep the memory footprint independent of the domain size, costs
+ * are stored per block of blockDim cells; all cells within a block
+ * share the same cost. Costs may be declared by the model (see
+ * APITraits::HasCellCost), set explicitly, or measured at runtime via
+ * addSample() and calibrate().
+ */
+template<int DIM>
+class CellCostMap
+{
+public:
+    typedef Grid<double, typename Topologies::Cube<DIM>::Topology> GridType;
+
+    /**
+     * Upper bound on the number of blocks used by defaultBlockDim().
+     */
+    static const int MAX_BLOCKS = 1 << 20;
+
+    /**
+     * smoothing is the weight of a new sample in addSample(),
+     * 1.0 means that old measurements are discarded.
+     */
+    inline explicit CellCostMap(
+        const CoordBox<DIM>& box = CoordBox<DIM>(),
+        const Coord<DIM>& blockDim = Coord<DIM>::diagonal(1),
+        const double defaultCost = 1.0,
+        const double smoothing = 0.5) :
+        box(box),
+        blockDim(blockDim),
+        smoothing(smoothing)
+    {
+        for (int d = 0; d < DIM; ++d) {
+            if (blockDim[d] <= 0) {
+                throw std::invalid_argument("block dimensions need to be positive");
+            }
+        }
+        if ((smoothing <= 0) || (smoothing > 1)) {
+            throw std::invalid_argument("smoothing needs to be in (0, 1]");
+        }
+
+        Coord<DIM> gridDim;
+        for (int d = 0; d < DIM; ++d) {
+            gridDim[d] = (box.dimensions[d] + blockDim[d] - 1) / blockDim[d];
+        }
+        costs = GridType(gridDim, defaultCost, defaultCost);
+    }
+
+    /**
+     * Initializes the map from the costs declared by CELL (see
+     * APITraits::HasCellCost). Each block gets the average cost of
+     * the cells it contains.
+     */
+    template<typename CELL>
+    static CellCostMap fromCellTraits(
+        const CoordBox<DIM>& box,
+        const Coord<DIM>& blockDim)
+    {
+        CellCostMap ret(box, blockDim, 0.0);
+
+        for (typename CoordBox<DIM>::Iterator i = box.begin(); i != box.end(); ++i) {
+            ret.costs[ret.blockIndex(*i)] += APITraits::SelectCellCost<CELL>::value(*i);
+        }
+
+        CoordBox<DIM> blocks = ret.costs.boundingBox();
+        for (typename CoordBox<DIM>::Iterator i = blocks.begin(); i != blocks.end(); ++i) {
+            ret.costs[*i] /= ret.blockVolume(*i);
+        }
+
+        return ret;
+    }
+
+    /**
+     * Chooses the smallest power-of-two block size which keeps the
+     * number of blocks for the given domain below MAX_BLOCKS.
+     */
+    static Coord<DIM> defaultBlockDim(const Coord<DIM>& dimensions)
+    {
+        Coord<DIM> ret = Coord<DIM>::diagonal(1);
+
+        for (;;) {
+            long numBlocks = 1;
+            int coarsest = 0;
+            long maxBlocks = 0;
+
+            for (int d = 0; d < DIM; ++d) {
+                long blocks = (dimensions[d] + ret[d] - 1) / ret[d];
+                numBlocks *= blocks;
+                if (blocks > maxBlocks) {
+                    maxBlocks = blocks;
+                    coarsest = d;
+                }
+            }
+
+            if (numBlocks <= MAX_BLOCKS) {
+                return ret;
+            }
+            ret[coarsest] *= 2;
+        }
+    }
+
+    /**
+     * returns the cost of the cell at pos.
+     */
+    inline double operator[](const Coord<DIM>& pos) const
+    {
+        return costs[blockIndex(pos)];
+    }
+
+    /**
+     * sets the per-cell cost of the whole block containing pos.
+     */
+    inline void setCost(const Coord<DIM>& pos, const double cost)
+    {
+        costs[blockIndex(pos)] = cost;
+    }
+
+    /**
+     * Feeds back a measured update time for a streak. The time is
+     * spread evenly over the streak's cells and blended into all
+     * blocks the streak touches. Cells outside of the map's bounding
+     * box are ignored.
+     */
+    inline void addSample(const Streak<DIM>& streak, const double time)
+    {
+        int length = streak.length();
+        if (length <= 0) {
+            return;
+        }
+        double sample = time / length;
+
+        for (int d = 1; d < DIM; ++d) {
+            if ((streak.origin[d] < box.origin[d]) ||
+                (streak.origin[d] >= (box.origin[d] + box.dimensions[d]))) {
+                return;
+            }
+        }
+
+        Coord<DIM> cursor = streak.origin;
+        cursor.x() = (std::max)(cursor.x(), box.origin.x());
+        int endX = (std::min)(streak.endX, box.origin.x() + box.dimensions.x());
+        while (cursor.x() < endX) {
+            double& cost = costs[blockIndex(cursor)];
+            cost = (1.0 - smoothing) * cost + smoothing * sample;
+            cursor.x() = nextBlockBoundary(cursor.x());
+        }
+    }
+
+    /**
+     * Rescales the costs of all blocks touching region so that the
+     * region's total cost matches the measured time (up to blocks
+     * which straddle the region's boundary). This is the natural way
+     * to feed back per-rank timings, see CostBalancer.
+     */
+    inline void calibrate(const Region<DIM>& region, const double measuredTime)
+    {
+        double current = totalCost(region);
+        if ((current <= 0) || (measuredTime <= 0)) {
+            return;
+        }
+        double factor = measuredTime / current;
+
+        Region<DIM> blocks;
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            Coord<DIM> last = i->end();
+            last.x() -= 1;
+            blocks << Streak<DIM>(blockIndex(i->origin), blockIndex(last).x() + 1);
+        }
+
+        for (typename Region<DIM>::Iterator i = blocks.begin(); i != blocks.end(); ++i) {
+            costs[*i] *= factor;
+        }
+    }
+
+    /**
+     * accumulated cost of all cells in region.
+     */
+    inline double totalCost(const Region<DIM>& region) const
+    {
+        double sum = 0;
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            sum += totalCost(*i);
+        }
+        return sum;
+    }
+
+    inline double totalCost(const Streak<DIM>& streak) const
+    {
+        double sum = 0;
+        Coord<DIM> cursor = streak.origin;
+        while (cursor.x() < streak.endX) {
+            int next = (std::min)(nextBlockBoundary(cursor.x()), streak.endX);
+            sum += (*this)[cursor] * (next - cursor.x());
+            cursor.x() = next;
+        }
+        return sum;
+    }
+
+    inline double totalCost() const
+    {
+        Region<DIM> r;
+        r << box;
+        return totalCost(r);
+    }
+
+    inline const CoordBox<DIM>& boundingBox() const
+    {
+        return box;
+    }
+
+    inline const Coord<DIM>& getBlockDim() const
+    {
+        return blockDim;
+    }
+
+private:
+    CoordBox<DIM> box;
+    Coord<DIM> blockDim;
+    double smoothing;
+    GridType costs;
+
+    inline Coord<DIM> blockIndex(const Coord<DIM>& pos) const
+    {
+        Coord<DIM> ret;
+        for (int d = 0; d < DIM; ++d) {
+            ret[d] = (pos[d] - box.origin[d]) / blockDim[d];
+        }
+        return ret;
+    }
+
+    inline int nextBlockBoundary(const int x) const
+    {
+        int relative = x - box.origin.x();
+        return box.origin.x() + (relative / blockDim.x() + 1) * blockDim.x();
+    }
+
+    inline int blockVolume(const Coord<DIM>& block) const
+    {
+        int ret = 1;
+        for (int d = 0; d < DIM; ++d) {
+            int begin = block[d] * blockDim[d];
+            int end = (std::min)(begin + blockDim[d], box.dimensions[d]);
+            ret *= end - begin;
+        }
+        return ret;
+    }
+};
+
+}
+
+#endif
@@ -11,10 +11,12 @@ namespace LibGeoDecomp {
  * balancing (neither static nor dynamic). General advice is to use
  * the RecursiveBisectionPartition or the ZCurvePartition instead.
  */
-template<int DIM>
-class CheckerboardingPartition : public Partition<DIM>
+template<int DIMENSIONS>
+class CheckerboardingPartition : public Partition<DIMENSIONS>
 {
 public:
+    const static int DIM = DIMENSIONS;
+
     using Partition<DIM>::startOffsets;
     using Partition<DIM>::weights;
 
@@ -0,0 +1,294 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_COSTAWAREPARTITION_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_COSTAWAREPARTITION_H
+
+#include <libgeodecomp/geometry/partitions/cellcostmap.h>
+#include <libgeodecomp/geometry/partitions/recursivebisectionpartition.h>
+#include <libgeodecomp/misc/apitraits.h>
+
+namespace LibGeoDecomp {
+
+/**
+ * Adapts a space-filling curve (StripingPartition, ZCurvePartition,
+ * HilbertPartition, HIndexingPartition...) so that it cuts the curve
+ * by accumulated cell cost instead of by cell count. The weights
+ * passed in are interpreted as target shares of the total cost; as
+ * with plain partitions their sum should equal the number of cells,
+ * so the output of a LoadBalancer can be passed in unchanged.
+ *
+ * Costs are taken either from an explicit CellCostMap (e.g. filled
+ * from measurements) or from the cell's APITraits::HasCellCost
+ * declaration. If CELL doesn't declare any costs, the partition
+ * degenerates to PARTITION.
+ */
+template<typename PARTITION, typename CELL = void>
+class CostAwarePartition : public PARTITION
+{
+public:
+    typedef void SupportsCellCostMap;
+    const static int DIM = PARTITION::DIM;
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+    typedef std::vector<std::size_t> SizeTVec;
+
+    inline explicit CostAwarePartition(
+        const Coord<DIM>& origin = Coord<DIM>(),
+        const Coord<DIM>& dimensions = Coord<DIM>(),
+        const long& offset = 0,
+        const SizeTVec& weights = SizeTVec(2),
+        const AdjacencyPtr& /* unused: adjacency */ = AdjacencyPtr()) :
+        PARTITION(
+            origin,
+            dimensions,
+            offset,
+            costWeights(
+                origin,
+                dimensions,
+                offset,
+                weights,
+                typename APITraits::SelectCellCost<CELL>::Value())),
+        costShares(weights)
+    {}
+
+    inline CostAwarePartition(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const SizeTVec& weights,
+        const CellCostMap<DIM>& costs) :
+        PARTITION(
+            origin,
+            dimensions,
+            offset,
+            costWeights(origin, dimensions, offset, weights, costs)),
+        costShares(weights)
+    {}
+
+    /**
+     * The weights passed in upon construction, i.e. the share of the
+     * total cost each node is supposed to get. getWeights() returns
+     * the resulting number of cells per node.
+     */
+    inline const SizeTVec& getCostShares() const
+    {
+        return costShares;
+    }
+
+private:
+    SizeTVec costShares;
+
+    static SizeTVec costWeights(
+        const Coord<DIM>& /* origin */,
+        const Coord<DIM>& /* dimensions */,
+        const long& /* offset */,
+        const SizeTVec& weights,
+        APITraits::FalseType)
+    {
+        return weights;
+    }
+
+    static SizeTVec costWeights(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const SizeTVec& weights,
+        APITraits::TrueType)
+    {
+        CoordBox<DIM> box(origin, dimensions);
+        return costWeights(
+            origin,
+            dimensions,
+            offset,
+            weights,
+            CellCostMap<DIM>::template fromCellTraits<CELL>(
+                box,
+                CellCostMap<DIM>::defaultBlockDim(dimensions)));
+    }
+
+    /**
+     * Walks along the curve and places the cut between two nodes so
+     * that the accumulated cost matches the target share. A cell is
+     * assigned to the node its cost's midpoint falls into.
+     */
+    static SizeTVec costWeights(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const SizeTVec& weights,
+        const CellCostMap<DIM>& costs)
+    {
+        std::size_t numCells = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            numCells += weights[i];
+        }
+        if (numCells == 0) {
+            return weights;
+        }
+
+        PARTITION curve(origin, dimensions, offset, weights);
+        typename PARTITION::Iterator end = curve.end();
+
+        double totalCost = 0;
+        std::size_t counter = 0;
+        for (typename PARTITION::Iterator i = curve[offset]; (i != end) && (counter < numCells); ++i, ++counter) {
+            totalCost += costs[*i];
+        }
+        if (totalCost <= 0) {
+            return weights;
+        }
+
+        SizeTVec cuts(weights.size() + 1, counter);
+        cuts[0] = 0;
+        std::size_t node = 0;
+        std::size_t accumulatedShares = weights[0];
+        double target = totalCost * accumulatedShares / numCells;
+        double accumulatedCost = 0;
+
+        counter = 0;
+        for (typename PARTITION::Iterator i = curve[offset]; (i != end) && (counter < numCells); ++i, ++counter) {
+            double cost = costs[*i];
+            while (((node + 1) < weights.size()) && ((accumulatedCost + cost * 0.5) > target)) {
+                ++node;
+                cuts[node] = counter;
+                accumulatedShares += weights[node];
+                target = totalCost * accumulatedShares / numCells;
+            }
+            accumulatedCost += cost;
+        }
+
+        for (std::size_t i = node + 1; i < weights.size(); ++i) {
+            cuts[i] = counter;
+        }
+
+        SizeTVec ret(weights.size());
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            ret[i] = cuts[i + 1] - cuts[i];
+        }
+        // keep the sum of weights intact, even if the curve was
+        // shorter than expected:
+        ret.back() += numCells - counter;
+
+        return ret;
+    }
+};
+
+/**
+ * Recursive bisection can't be expressed as a cut along a curve, so
+ * here the costs are handed over to the partition which will then
+ * place its cutting planes accordingly.
+ */
+template<int DIMENSIONS, typename CELL>
+class CostAwarePartition<RecursiveBisectionPartition<DIMENSIONS>, CELL> :
+        public RecursiveBisectionPartition<DIMENSIONS>
+{
+public:
+    typedef void SupportsCellCostMap;
+    const static int DIM = DIMENSIONS;
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+    typedef std::vector<std::size_t> SizeTVec;
+    typedef typename RecursiveBisectionPartition<DIM>::CostMapPtr CostMapPtr;
+
+    inline explicit CostAwarePartition(
+        const Coord<DIM>& origin = Coord<DIM>(),
+        const Coord<DIM>& dimensions = Coord<DIM>(),
+        const long& offset = 0,
+        const SizeTVec& weights = SizeTVec(),
+        const AdjacencyPtr& adjacency = AdjacencyPtr()) :
+        RecursiveBisectionPartition<DIM>(
+            origin,
+            dimensions,
+            offset,
+            weights,
+            adjacency,
+            Coord<DIM>::diagonal(1),
+            costMap(origin, dimensions, typename APITraits::SelectCellCost<CELL>::Value()))
+    {}
+
+    inline CostAwarePartition(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const SizeTVec& weights,
+        const CellCostMap<DIM>& costs) :
+        RecursiveBisectionPartition<DIM>(
+            origin,
+            dimensions,
+            offset,
+            weights,
+            AdjacencyPtr(),
+            Coord<DIM>::diagonal(1),
+            CostMapPtr(new CellCostMap<DIM>(costs)))
+    {}
+
+    inline const SizeTVec& getCostShares() const
+    {
+        return this->getWeights();
+    }
+
+private:
+    static CostMapPtr costMap(const Coord<DIM>&, const Coord<DIM>&, APITraits::FalseType)
+    {
+        return CostMapPtr();
+    }
+
+    static CostMapPtr costMap(const Coord<DIM>& origin, const Coord<DIM>& dimensions, APITraits::TrueType)
+    {
+        return CostMapPtr(
+            new CellCostMap<DIM>(
+                CellCostMap<DIM>::template fromCellTraits<CELL>(
+                    CoordBox<DIM>(origin, dimensions),
+                    CellCostMap<DIM>::defaultBlockDim(dimensions))));
+    }
+};
+
+namespace CostAwarePartitionHelpers {
+
+/**
+ * Lets simulators construct any PARTITION uniformly: if PARTITION
+ * accepts a CellCostMap (i.e. it's a CostAwarePartition) and a map
+ * is given, the partition will be built from it. Otherwise costs are
+ * ignored and the adjacency is passed on, as for plain partitions.
+ */
+template<typename PARTITION, int DIM, typename SUPPORTS_CELL_COST_MAP = void>
+class PartitionBuilder
+{
+public:
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+
+    static PARTITION *build(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const std::vector<std::size_t>& weights,
+        const AdjacencyPtr& adjacency,
+        const CellCostMap<DIM> * /* unused: costs */)
+    {
+        return new PARTITION(origin, dimensions, offset, weights, adjacency);
+    }
+};
+
+template<typename PARTITION, int DIM>
+class PartitionBuilder<PARTITION, DIM, typename PARTITION::SupportsCellCostMap>
+{
+public:
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+
+    static PARTITION *build(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const std::vector<std::size_t>& weights,
+        const AdjacencyPtr& adjacency,
+        const CellCostMap<DIM> *costs)
+    {
+        if (costs) {
+            return new PARTITION(origin, dimensions, offset, weights, *costs);
+        }
+
+        return new PARTITION(origin, dimensions, offset, weights, adjacency);
+    }
+};
+
+}
+
+}
+
+#endif
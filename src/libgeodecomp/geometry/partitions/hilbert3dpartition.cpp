@@ -0,0 +1,9 @@
+#include <libgeodecomp/geometry/partitions/hilbert3dpartition.h>
+
+namespace LibGeoDecomp {
+
+SharedPtr<Hilbert3DPartition::CacheType>::Type Hilbert3DPartition::cubeCoordsCache;
+Coord<3> Hilbert3DPartition::maxCachedDimensions;
+bool Hilbert3DPartition::cachesInitialized = Hilbert3DPartition::fillCaches();
+
+}
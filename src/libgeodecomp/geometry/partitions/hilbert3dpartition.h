@@ -0,0 +1,560 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_HILBERT3DPARTITION_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_HILBERT3DPARTITION_H
+
+#include <libgeodecomp/geometry/partitions/spacefillingcurve.h>
+#include <libgeodecomp/geometry/topologies.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/grid.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace LibGeoDecomp {
+
+/**
+ * Hilbert's space-filling curve for 3D. Compared to the
+ * ZCurvePartition it avoids jumps between consecutive cells and thus
+ * yields more compact subdomains with smaller halos.
+ *
+ * The curve through a box is defined by its entry corner and the
+ * dimension along which its exit corner lies next to the entry. The
+ * box is recursively split into up to eight octants which are
+ * traversed in Gray code order, each octant's entry and exit corners
+ * are chosen so that the sub-curves connect. Dimensions which are
+ * much shorter than the longest one aren't split, lest we end up with
+ * flat slabs, so arbitrary cuboids are supported. Odd dimensions are
+ * split into unequal halves, which may cause a few short jumps.
+ * Iteration over small boxes is sped up by a cache, just like in
+ * HilbertPartition.
+ */
+class Hilbert3DPartition : public SpaceFillingCurve<3>
+{
+public:
+    friend class Hilbert3DPartitionTest;
+
+    const static int DIM = 3;
+    const static unsigned MAX_OCTANTS = 8;
+
+    /**
+     * A form encodes the orientation of a (sub-)curve: bits 0-2 hold
+     * the entry corner (a set bit denotes the upper end of the
+     * respective dimension), bits 3-4 the dimension in which the
+     * exit corner differs from the entry corner.
+     */
+    const static unsigned NUM_FORMS = 24;
+
+    typedef std::vector<Coord<3> > CoordVector;
+    typedef Grid<std::vector<CoordVector>, Topologies::Cube<3>::Topology> CacheType;
+
+    using Partition<3>::AdjacencyPtr;
+
+    static SharedPtr<CacheType>::Type cubeCoordsCache;
+    static Coord<3> maxCachedDimensions;
+    static bool cachesInitialized;
+
+    class Cube
+    {
+    public:
+        inline Cube(const Coord<3>& origin, const Coord<3>& dimensions, unsigned octant, unsigned form) :
+            origin(origin),
+            dimensions(dimensions),
+            octant(octant),
+            form(form)
+        {}
+
+        inline std::string toString() const
+        {
+            std::stringstream s;
+            s << "Cube(origin:" << origin << ", dimensions:" << dimensions << ", octant: " << octant << ", form: " << form << ")";
+            return s.str();
+        }
+
+        /**
+         * Splits the cube into octants and stores them in the order
+         * of traversal. Returns the number of octants.
+         */
+        inline unsigned subdivide(
+            Coord<3> *octantOrigins,
+            Coord<3> *octantDimensions,
+            unsigned *octantForms) const
+        {
+            unsigned entry = form & 7;
+            int exitDim = form >> 3;
+            int maxDim = dimensions.maxElement();
+
+            // the exit dimension needs to be split last, so the
+            // traversal ends in the octant next to the one it started
+            // in (Gray code order). Longer dimensions go first.
+            int splitDims[3];
+            int numSplitDims = 0;
+            for (int d = 0; d < 3; ++d) {
+                int longest = -1;
+                for (int i = 0; i < 3; ++i) {
+                    if ((i == exitDim) || (dimensions[i] < 2) || ((2 * dimensions[i]) <= maxDim)) {
+                        continue;
+                    }
+                    if (std::find(splitDims, splitDims + numSplitDims, i) != (splitDims + numSplitDims)) {
+                        continue;
+                    }
+                    if ((longest == -1) || (dimensions[i] > dimensions[longest])) {
+                        longest = i;
+                    }
+                }
+                if (longest != -1) {
+                    splitDims[numSplitDims++] = longest;
+                }
+            }
+            if (dimensions[exitDim] >= 2) {
+                splitDims[numSplitDims++] = exitDim;
+            }
+
+            Coord<3> lower = dimensions;
+            unsigned startPosition = 0;
+            for (int i = 0; i < numSplitDims; ++i) {
+                int d = splitDims[i];
+                lower[d] = dimensions[d] / 2;
+                startPosition |= entry & (1 << d);
+            }
+
+            unsigned numOctants = 1 << numSplitDims;
+            unsigned positions[MAX_OCTANTS];
+            int crossingDims[MAX_OCTANTS];
+
+            for (unsigned k = 0; k < numOctants; ++k) {
+                unsigned gray = k ^ (k >> 1);
+                positions[k] = startPosition;
+                for (int i = 0; i < numSplitDims; ++i) {
+                    if (gray & (1 << i)) {
+                        positions[k] ^= 1 << splitDims[i];
+                    }
+                }
+
+                for (int d = 0; d < 3; ++d) {
+                    if (positions[k] & (1 << d)) {
+                        octantOrigins[k][d] = origin[d] + lower[d];
+                        octantDimensions[k][d] = dimensions[d] - lower[d];
+                    } else {
+                        octantOrigins[k][d] = origin[d];
+                        octantDimensions[k][d] = lower[d];
+                    }
+                }
+
+                if ((k + 1) < numOctants) {
+                    unsigned nextGray = (k + 1) ^ ((k + 1) >> 1);
+                    int i = 0;
+                    while (!((gray ^ nextGray) & (1 << i))) {
+                        ++i;
+                    }
+                    crossingDims[k] = splitDims[i];
+                }
+            }
+
+            unsigned exitCorner = entry ^ (1 << exitDim);
+            if (!chooseExits(0, numOctants, entry, exitCorner, positions, crossingDims, octantDimensions, true,  octantForms)) {
+                chooseExits(0, numOctants, entry, exitCorner, positions, crossingDims, octantDimensions, false, octantForms);
+            }
+
+            return numOctants;
+        }
+
+    private:
+        /**
+         * Depth-first search for the octants' exit dimensions: each
+         * octant has to end next to its successor and the last one in
+         * the parent's exit corner. Longer dimensions are tried first
+         * to keep octants compact. In strict mode no octant may exit
+         * along a dimension of extent 1 as that would force a jump
+         * within the octant. Returns false if no assignment is found.
+         */
+        static inline bool chooseExits(
+            unsigned k,
+            unsigned numOctants,
+            unsigned octantEntry,
+            unsigned exitCorner,
+            const unsigned *positions,
+            const int *crossingDims,
+            const Coord<3> *octantDimensions,
+            bool strict,
+            unsigned *octantForms)
+        {
+            const Coord<3>& dim = octantDimensions[k];
+            unsigned nonTrivial = 0;
+            for (int d = 0; d < 3; ++d) {
+                if (dim[d] > 1) {
+                    nonTrivial |= 1 << d;
+                }
+            }
+
+            if ((k + 1) == numOctants) {
+                unsigned delta = (octantEntry ^ exitCorner) & nonTrivial;
+                int exitDim = -1;
+                for (int d = 0; d < 3; ++d) {
+                    if (delta == unsigned(1 << d)) {
+                        exitDim = d;
+                    }
+                }
+                if (exitDim == -1) {
+                    // only single cells may start and end in the same corner:
+                    if (strict && (nonTrivial != 0)) {
+                        return false;
+                    }
+                    exitDim = longestDimension(dim, -1);
+                }
+
+                octantForms[k] = octantEntry | (exitDim << 3);
+                return true;
+            }
+
+            int crossingDim = crossingDims[k];
+            unsigned crossingBit = 1 << crossingDim;
+            int candidates[3];
+            int numCandidates = 0;
+
+            if ((nonTrivial & crossingBit) && !((octantEntry ^ positions[k]) & crossingBit)) {
+                // entry lies on the face opposite of the next octant:
+                candidates[numCandidates++] = crossingDim;
+            } else {
+                int first = longestDimension(dim, crossingDim);
+                candidates[numCandidates++] = first;
+                candidates[numCandidates++] = 3 - crossingDim - first;
+                if (!strict) {
+                    candidates[numCandidates++] = crossingDim;
+                }
+            }
+
+            for (int i = 0; i < numCandidates; ++i) {
+                int exitDim = candidates[i];
+                if (strict && !(nonTrivial & (1 << exitDim)) && (nonTrivial != 0)) {
+                    continue;
+                }
+
+                octantForms[k] = octantEntry | (exitDim << 3);
+                unsigned nextEntry = ((octantEntry ^ (1 << exitDim)) & ~crossingBit) | (positions[k] & crossingBit);
+                if (chooseExits(k + 1, numOctants, nextEntry, exitCorner, positions, crossingDims,
+                                octantDimensions, strict, octantForms) || !strict) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    public:
+
+        Coord<3> origin;
+        Coord<3> dimensions;
+        unsigned octant;
+        unsigned form;
+    };
+
+    class Iterator : public SpaceFillingCurve<3>::Iterator
+    {
+    public:
+        friend class Hilbert3DPartitionTest;
+
+        using SpaceFillingCurve<3>::Iterator::cursor;
+        using SpaceFillingCurve<3>::Iterator::endReached;
+        using SpaceFillingCurve<3>::Iterator::hasTrivialDimensions;
+        using SpaceFillingCurve<3>::Iterator::origin;
+        using SpaceFillingCurve<3>::Iterator::sublevelState;
+
+        inline Iterator(
+            const Coord<3>& origin,
+            const Coord<3>& dimensions,
+            unsigned pos = 0,
+            unsigned form = 0) :
+            SpaceFillingCurve<3>::Iterator(origin, false)
+        {
+            cubeStack.push_back(Cube(origin, dimensions, 0, form));
+            digDown(pos);
+        }
+
+        inline explicit Iterator(const Coord<3>& origin) :
+            SpaceFillingCurve<3>::Iterator(origin, true)
+        {}
+
+        inline Iterator& operator++()
+        {
+            if (endReached) {
+                return *this;
+            }
+
+            if (sublevelState == TRIVIAL) {
+                operatorIncTrivial();
+            } else {
+                operatorIncCached();
+            }
+            return *this;
+        }
+
+    private:
+        std::vector<Cube> cubeStack;
+        unsigned trivialCubeDirDim;
+        unsigned trivialCubeCounter;
+        int trivialCubeStep;
+        Coord<3> cachedCubeOrigin;
+        const Coord<3> *cachedCubeCoordsIterator;
+        const Coord<3> *cachedCubeCoordsEnd;
+
+        inline void operatorIncTrivial()
+        {
+            if (--trivialCubeCounter > 0) {
+                cursor[trivialCubeDirDim] += trivialCubeStep;
+            } else {
+                digUpDown();
+            }
+        }
+
+        inline void operatorIncCached()
+        {
+            cachedCubeCoordsIterator++;
+            if (cachedCubeCoordsIterator != cachedCubeCoordsEnd) {
+                cursor = cachedCubeOrigin + *cachedCubeCoordsIterator;
+            } else {
+                digUpDown();
+            }
+        }
+
+        inline void digUpDown()
+        {
+            digUp();
+            if (endReached) {
+                return;
+            }
+            digDown(0);
+        }
+
+        inline void digDown(unsigned offset)
+        {
+            if (cubeStack.empty()) {
+                throw std::logic_error("cannot descend from empty cube stack");
+            }
+
+            Cube currentCube = pop(cubeStack);
+            const Coord<3>& origin = currentCube.origin;
+            const Coord<3>& dimensions = currentCube.dimensions;
+
+            if (offset >= unsigned(dimensions.prod())) {
+                endReached = true;
+                cursor = origin;
+                return;
+            }
+            if (hasTrivialDimensions(dimensions)) {
+                digDownTrivial(origin, dimensions, offset, currentCube.form);
+            } else if (isCached(dimensions)) {
+                digDownCached(origin, dimensions, offset, currentCube.form);
+            } else {
+                digDownRecursion(offset, currentCube);
+            }
+        }
+
+        inline void digDownTrivial(
+            const Coord<3>& origin,
+            const Coord<3>& dimensions,
+            unsigned offset,
+            unsigned form)
+        {
+            sublevelState = TRIVIAL;
+            cursor = origin;
+
+            trivialCubeDirDim = 0;
+            for (int i = 1; i < 3; ++i) {
+                if (dimensions[i] > 1) {
+                    trivialCubeDirDim = i;
+                }
+            }
+
+            trivialCubeCounter = dimensions[trivialCubeDirDim] - offset;
+
+            // lines need to be traversed backwards if the curve
+            // enters at the upper end:
+            if (form & (1 << trivialCubeDirDim)) {
+                trivialCubeStep = -1;
+                cursor[trivialCubeDirDim] += dimensions[trivialCubeDirDim] - 1 - offset;
+            } else {
+                trivialCubeStep = 1;
+                cursor[trivialCubeDirDim] += offset;
+            }
+        }
+
+        inline void digDownCached(
+            const Coord<3>& origin,
+            const Coord<3>& dimensions,
+            unsigned offset,
+            unsigned form)
+        {
+            sublevelState = CACHED;
+            const CoordVector& coords = (*cubeCoordsCache)[dimensions][form];
+            cachedCubeOrigin = origin;
+            cachedCubeCoordsIterator = &coords[offset];
+            cachedCubeCoordsEnd      = &coords[0] + coords.size();
+            cursor = cachedCubeOrigin + *cachedCubeCoordsIterator;
+        }
+
+        inline void digDownRecursion(unsigned offset, Cube currentCube)
+        {
+            Coord<3> octantOrigins[MAX_OCTANTS];
+            Coord<3> octantDimensions[MAX_OCTANTS];
+            unsigned octantForms[MAX_OCTANTS];
+            unsigned numOctants = currentCube.subdivide(octantOrigins, octantDimensions, octantForms);
+
+            // accumulated octant sizes, e.g. accuSizes[3] is the sum
+            // of the sizes of the first three octants along the curve.
+            unsigned accuSizes[MAX_OCTANTS + 1];
+            accuSizes[0] = 0;
+            for (unsigned i = 0; i < numOctants; ++i) {
+                accuSizes[i + 1] = accuSizes[i] + octantDimensions[i].prod();
+            }
+
+            unsigned pos = offset + accuSizes[currentCube.octant];
+            unsigned index = std::upper_bound(
+                accuSizes,
+                accuSizes + numOctants + 1,
+                pos) - accuSizes - 1;
+
+            if (index >= numOctants) {
+                throw std::logic_error("offset too large?");
+            }
+
+            currentCube.octant = index;
+            cubeStack.push_back(currentCube);
+            cubeStack.push_back(Cube(octantOrigins[index], octantDimensions[index], 0, octantForms[index]));
+
+            digDown(pos - accuSizes[index]);
+        }
+
+        inline void digUp()
+        {
+            while (!cubeStack.empty()) {
+                Cube& cube = cubeStack.back();
+                Coord<3> octantOrigins[MAX_OCTANTS];
+                Coord<3> octantDimensions[MAX_OCTANTS];
+                unsigned octantForms[MAX_OCTANTS];
+                unsigned numOctants = cube.subdivide(octantOrigins, octantDimensions, octantForms);
+
+                if (++cube.octant < numOctants) {
+                    return;
+                }
+                cubeStack.pop_back();
+            }
+
+            endReached = true;
+            cursor = origin;
+        }
+
+        inline bool isCached(const Coord<3>& dimensions) const
+        {
+            return
+                (dimensions.x() < maxCachedDimensions.x()) &&
+                (dimensions.y() < maxCachedDimensions.y()) &&
+                (dimensions.z() < maxCachedDimensions.z());
+        }
+    };
+
+    inline explicit Hilbert3DPartition(
+        const Coord<3>& origin = Coord<3>(),
+        const Coord<3>& dimensions = Coord<3>(),
+        const long& offset = 0,
+        const std::vector<std::size_t>& weights = std::vector<std::size_t>(2),
+        const AdjacencyPtr& /* unused: adjacency */ = AdjacencyPtr()) :
+        SpaceFillingCurve<3>(offset, weights),
+        origin(origin),
+        dimensions(dimensions),
+        // run along the longest dimension so elongated domains are
+        // cut into cubes first:
+        form(longestDimension(dimensions, -1) << 3)
+    {}
+
+    inline Iterator operator[](unsigned i) const
+    {
+        return Iterator(origin, dimensions, i, form);
+    }
+
+    inline Iterator begin() const
+    {
+        return (*this)[0];
+    }
+
+    inline Iterator end() const
+    {
+        return Iterator(origin);
+    }
+
+    inline Region<3> getRegion(const std::size_t node) const
+    {
+        return Region<3>(
+            (*this)[startOffsets[node + 0]],
+            (*this)[startOffsets[node + 1]]);
+    }
+
+private:
+    using SpaceFillingCurve<3>::startOffsets;
+
+    Coord<3> origin;
+    Coord<3> dimensions;
+    unsigned form;
+
+    /**
+     * returns the longest dimension other than skip.
+     */
+    static inline int longestDimension(const Coord<3>& dimensions, int skip)
+    {
+        int ret = -1;
+        for (int d = 0; d < 3; ++d) {
+            if ((d != skip) && ((ret == -1) || (dimensions[d] > dimensions[ret]))) {
+                ret = d;
+            }
+        }
+        return ret;
+    }
+
+    static inline bool fillCaches()
+    {
+        Coord<3> maxDim = Coord<3>::diagonal(7);
+        cubeCoordsCache.reset(new CacheType(maxDim));
+
+        // coords are generated without the cache, recursion is
+        // cheap for these small boxes anyway:
+        maxCachedDimensions = Coord<3>();
+
+        CoordBox<3> box(Coord<3>(), maxDim);
+        for (CoordBox<3>::Iterator iter = box.begin(); iter != box.end(); ++iter) {
+            Coord<3> dim = *iter;
+            if (hasTrivialDimensions(dim)) {
+                continue;
+            }
+
+            std::vector<CoordVector> forms(NUM_FORMS);
+            for (unsigned f = 0; f < NUM_FORMS; ++f) {
+                Iterator end((Coord<3>()));
+                for (Iterator i(Coord<3>(), dim, 0, f); i != end; ++i) {
+                    forms[f].push_back(*i);
+                }
+            }
+            (*cubeCoordsCache)[dim] = forms;
+        }
+
+        maxCachedDimensions = maxDim;
+        return true;
+    }
+
+    static inline bool hasTrivialDimensions(const Coord<3>& dimensions)
+    {
+        return SpaceFillingCurve<3>::Iterator::hasTrivialDimensions(dimensions);
+    }
+};
+
+template<typename _CharT, typename _Traits>
+std::basic_ostream<_CharT, _Traits>&
+operator<<(std::basic_ostream<_CharT, _Traits>& __os,
+           const typename Hilbert3DPartition::Cube& cube)
+{
+    __os << cube.toString();
+    return __os;
+}
+
+}
+
+#endif
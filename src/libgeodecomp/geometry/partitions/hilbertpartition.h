@@ -23,6 +23,8 @@ private:
     enum Form {LL_TO_LR=0, LL_TO_UL=1, UR_TO_LR=2, UR_TO_UL=3};
 
 public:
+    const static int DIM = 2;
+
     typedef Grid<std::vector<Coord<2> >, Topologies::Cube<3>::Topology> CacheType;
 
     using Partition<2>::AdjacencyPtr;
@@ -68,6 +68,8 @@ class HIndexingPartition : public SpaceFillingCurve<2>
     friend class HIndexingPartitionTest;
 
 public:
+    const static int DIM = 2;
+
     typedef std::vector<Coord<2> > CoordVector;
 
     class Triangle
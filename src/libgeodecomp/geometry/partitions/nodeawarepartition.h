@@ -0,0 +1,206 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_NODEAWAREPARTITION_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_NODEAWAREPARTITION_H
+
+#include <libgeodecomp/geometry/partitions/costawarepartition.h>
+#include <libgeodecomp/geometry/partitions/partition.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace LibGeoDecomp {
+
+/**
+ * Places subdomains onto the node hierarchy: PARTITION (e.g. a
+ * ZCurvePartition or a Hilbert3DPartition) is fed with the ranks
+ * grouped by node, so the domain is first cut into one coarse
+ * subdomain per node, each of which is then cut into fine subdomains
+ * for the node's ranks. Without this, ranks are placed in order of
+ * their IDs, which is bad news if the job launcher distributes ranks
+ * round-robin across nodes: neighboring subdomains end up on
+ * different nodes, while distant ones share memory.
+ *
+ * As consecutive ranks within a node also receive consecutive
+ * subdomains, most neighbor pairs are intra-node and only the
+ * boundaries of the coarse subdomains generate inter-node traffic.
+ *
+ * The node of each rank needs to be given explicitly, e.g. from a
+ * NodeTopology of the simulator's communicator (HiParSimulator does
+ * this automatically). Construction is never a collective operation,
+ * so partitions may be built on a subset of the ranks. If no node IDs
+ * are given, each rank is considered a node of its own.
+ */
+template<typename PARTITION>
+class NodeAwarePartition : public Partition<PARTITION::DIM>
+{
+public:
+    typedef void SupportsNodeMap;
+    const static int DIM = PARTITION::DIM;
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+    typedef std::vector<std::size_t> SizeTVec;
+
+    inline explicit NodeAwarePartition(
+        const Coord<DIM>& origin = Coord<DIM>(),
+        const Coord<DIM>& dimensions = Coord<DIM>(),
+        const long& offset = 0,
+        const SizeTVec& weights = SizeTVec(2),
+        const AdjacencyPtr& adjacency = AdjacencyPtr()) :
+        Partition<DIM>(offset, weights),
+        nodes(separateNodes(weights.size())),
+        order(placement(nodes)),
+        slots(invert(order)),
+        partition(origin, dimensions, offset, permute(weights, order), adjacency)
+    {}
+
+    inline NodeAwarePartition(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const SizeTVec& weights,
+        const std::vector<int>& nodes,
+        const AdjacencyPtr& adjacency = AdjacencyPtr()) :
+        Partition<DIM>(offset, weights),
+        nodes(checkNodes(nodes, weights)),
+        order(placement(this->nodes)),
+        slots(invert(order)),
+        partition(origin, dimensions, offset, permute(weights, order), adjacency)
+    {}
+
+    inline Region<DIM> getRegion(const std::size_t rank) const
+    {
+        return partition.getRegion(slots[rank]);
+    }
+
+    /**
+     * Returns the node ID for each rank.
+     */
+    inline const std::vector<int>& getNodes() const
+    {
+        return nodes;
+    }
+
+    /**
+     * Returns the ranks in the order in which they were handed to
+     * PARTITION.
+     */
+    inline const SizeTVec& getPlacement() const
+    {
+        return order;
+    }
+
+    /**
+     * Orders ranks by node, ranks within a node by ID.
+     */
+    static SizeTVec placement(const std::vector<int>& nodes)
+    {
+        std::vector<std::pair<int, std::size_t> > keys;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            keys << std::make_pair(nodes[i], i);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        SizeTVec ret;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            ret << keys[i].second;
+        }
+        return ret;
+    }
+
+private:
+    std::vector<int> nodes;
+    SizeTVec order;
+    SizeTVec slots;
+    PARTITION partition;
+
+    static std::vector<int> separateNodes(std::size_t numRanks)
+    {
+        std::vector<int> ret;
+        for (std::size_t i = 0; i < numRanks; ++i) {
+            ret << int(i);
+        }
+        return ret;
+    }
+
+    /**
+     * Validates the node IDs before they're used to set up the
+     * placement, so mismatching sizes don't lead to out-of-bounds
+     * accesses in permute().
+     */
+    static const std::vector<int>& checkNodes(const std::vector<int>& nodes, const SizeTVec& weights)
+    {
+        if (nodes.size() != weights.size()) {
+            throw std::invalid_argument("need exactly one node ID per rank");
+        }
+
+        return nodes;
+    }
+
+    static SizeTVec invert(const SizeTVec& order)
+    {
+        SizeTVec ret(order.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            ret[order[i]] = i;
+        }
+        return ret;
+    }
+
+    static SizeTVec permute(const SizeTVec& weights, const SizeTVec& order)
+    {
+        SizeTVec ret;
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            ret << weights[order[i]];
+        }
+        return ret;
+    }
+};
+
+namespace NodeAwarePartitionHelpers {
+
+/**
+ * Extends CostAwarePartitionHelpers::PartitionBuilder: a
+ * NodeAwarePartition is handed the node ID of each rank, all other
+ * partitions are built as usual.
+ */
+template<typename PARTITION, int DIM, typename SUPPORTS_NODE_MAP = void>
+class PartitionBuilder
+{
+public:
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+
+    static PARTITION *build(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const std::vector<std::size_t>& weights,
+        const AdjacencyPtr& adjacency,
+        const CellCostMap<DIM> *costs,
+        const std::vector<int>& /* unused: nodes */)
+    {
+        return CostAwarePartitionHelpers::PartitionBuilder<PARTITION, DIM>::build(
+            origin, dimensions, offset, weights, adjacency, costs);
+    }
+};
+
+template<typename PARTITION, int DIM>
+class PartitionBuilder<PARTITION, DIM, typename PARTITION::SupportsNodeMap>
+{
+public:
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+
+    static PARTITION *build(
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long& offset,
+        const std::vector<std::size_t>& weights,
+        const AdjacencyPtr& adjacency,
+        const CellCostMap<DIM> * /* unused: costs */,
+        const std::vector<int>& nodes)
+    {
+        return new PARTITION(origin, dimensions, offset, weights, nodes, adjacency);
+    }
+};
+
+}
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define LIBGEODECOMP_GEOMETRY_PARTITIONS_RECURSIVEBISECTIONPARTITION_H
 
 #include <libgeodecomp/geometry/floatcoord.h>
+#include <libgeodecomp/geometry/partitions/cellcostmap.h>
 #include <libgeodecomp/geometry/partitions/partition.h>
 #include <libgeodecomp/misc/math.h>
 
@@ -12,14 +13,22 @@ namespace LibGeoDecomp {
  * yields perfectly rectangular domains which can be acutely tuned to
  * match load profiles, but small changes in the load vector may lead
  * to huge communication volumes for rebalanciation.
+ *
+ * If a CellCostMap is supplied, the weights are interpreted as shares
+ * of the total cost and the cutting planes are placed so that the
+ * accumulated cost on either side matches these shares (see
+ * CostAwarePartition).
  */
-template<int DIM>
-class RecursiveBisectionPartition : public Partition<DIM>
+template<int DIMENSIONS>
+class RecursiveBisectionPartition : public Partition<DIMENSIONS>
 {
 public:
     friend class RecursiveBisectionPartitionTest;
+    const static int DIM = DIMENSIONS;
+
     typedef std::vector<std::size_t> SizeTVec;
     typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+    typedef typename SharedPtr<CellCostMap<DIM> >::Type CostMapPtr;
 
     inline explicit RecursiveBisectionPartition(
         const Coord<DIM>& origin = Coord<DIM>(),
@@ -27,11 +36,13 @@ public:
         const long& offset = 0,
         const SizeTVec weights = SizeTVec(),
         const AdjacencyPtr& adjacency = AdjacencyPtr(),
-        const Coord<DIM>& dimWeights = Coord<DIM>::diagonal(1)) :
+        const Coord<DIM>& dimWeights = Coord<DIM>::diagonal(1),
+        const CostMapPtr& costs = CostMapPtr()) :
         Partition<DIM>(0, weights),
         origin(origin),
         dimensions(dimensions),
-        dimWeights(dimWeights)
+        dimWeights(dimWeights),
+        costs(costs)
     {
         if (dimensions.prod() == 0) {
             throw std::invalid_argument("size of simulation space may not be zero");
@@ -57,6 +68,7 @@ private:
     Coord<DIM> origin;
     Coord<DIM> dimensions;
     Coord<DIM> dimWeights;
+    CostMapPtr costs;
 
     /**
      * returns the CoordBox which belongs to the node whose weight is
@@ -116,12 +128,64 @@ private:
             }
         }
 
-        int offset = round(ratio * dim[longestDim]);
+        int offset = costs ?
+            costAwareOffset(oldBox, longestDim, ratio) :
+            round(ratio * dim[longestDim]);
         int remainder = dim[longestDim] - offset;
         newBoxes[0].dimensions[longestDim] = offset;
         newBoxes[1].dimensions[longestDim] = remainder;
         newBoxes[1].origin[longestDim] += offset;
     }
+
+    /**
+     * returns the position of the cutting plane along dimension
+     * splitDim for which the accumulated cost of the lower part of box
+     * best matches the given ratio of its total cost.
+     */
+    inline int costAwareOffset(
+        const CoordBox<DIM>& box,
+        const int splitDim,
+        const double ratio) const
+    {
+        std::vector<double> slabCosts(box.dimensions[splitDim], 0.0);
+        double totalCost = 0;
+
+        for (typename CoordBox<DIM>::StreakIterator i = box.beginStreak(); i != box.endStreak(); ++i) {
+            Streak<DIM> streak = *i;
+
+            if (splitDim == 0) {
+                for (Coord<DIM> c = streak.origin; c.x() < streak.endX; ++c.x()) {
+                    double cost = (*costs)[c];
+                    slabCosts[c.x() - box.origin.x()] += cost;
+                    totalCost += cost;
+                }
+            } else {
+                double cost = costs->totalCost(streak);
+                slabCosts[streak.origin[splitDim] - box.origin[splitDim]] += cost;
+                totalCost += cost;
+            }
+        }
+
+        if (totalCost <= 0) {
+            return round(ratio * box.dimensions[splitDim]);
+        }
+
+        double target = ratio * totalCost;
+        double accumulatedCost = 0;
+        int offset = 0;
+        for (; offset < box.dimensions[splitDim]; ++offset) {
+            double next = accumulatedCost + slabCosts[offset];
+            if (next > target) {
+                if ((next - target) < (target - accumulatedCost)) {
+                    ++offset;
+                }
+                break;
+            }
+            accumulatedCost = next;
+        }
+
+        return offset;
+    }
 };
 
 template<typename _CharT, typename _Traits, int _Dim>
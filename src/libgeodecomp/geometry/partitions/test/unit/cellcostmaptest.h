@@ -0,0 +1,140 @@
+#include <libgeodecomp/geometry/partitions/cellcostmap.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class CellCostMapTestCell
+{
+public:
+    class API : public APITraits::HasCellCost
+    {};
+
+    static double cellCost(const Coord<2>& pos)
+    {
+        return pos.x() + 1;
+    }
+};
+
+class CellCostMapTest : public CxxTest::TestSuite
+{
+public:
+    void testDefault()
+    {
+        CoordBox<3> box(Coord<3>(10, 20, 30), Coord<3>(7, 5, 3));
+        CellCostMap<3> costs(box);
+
+        TS_ASSERT_EQUALS(1.0, costs[Coord<3>(10, 20, 30)]);
+        TS_ASSERT_EQUALS(1.0, costs[Coord<3>(16, 24, 32)]);
+        TS_ASSERT_EQUALS(105.0, costs.totalCost());
+        TS_ASSERT_EQUALS(box, costs.boundingBox());
+    }
+
+    void testBlocks()
+    {
+        CoordBox<2> box(Coord<2>(-5, 2), Coord<2>(10, 9));
+        CellCostMap<2> costs(box, Coord<2>(4, 4));
+
+        costs.setCost(Coord<2>(-4, 3), 3.0);
+        TS_ASSERT_EQUALS(3.0, costs[Coord<2>(-5, 2)]);
+        TS_ASSERT_EQUALS(3.0, costs[Coord<2>(-2, 5)]);
+        TS_ASSERT_EQUALS(1.0, costs[Coord<2>(-1, 5)]);
+        TS_ASSERT_EQUALS(1.0, costs[Coord<2>(-2, 6)]);
+
+        // blocks at the upper boundary are cut off:
+        costs.setCost(Coord<2>(4, 10), 5.0);
+        TS_ASSERT_EQUALS(5.0, costs[Coord<2>(3, 10)]);
+
+        TS_ASSERT_EQUALS(4 * 3.0 + 6 * 1.0, costs.totalCost(Streak<2>(Coord<2>(-5, 3), 5)));
+        TS_ASSERT_EQUALS(2 * 3.0 + 1 * 1.0, costs.totalCost(Streak<2>(Coord<2>(-3, 3), 0)));
+        TS_ASSERT_EQUALS(2 * 5.0, costs.totalCost(Streak<2>(Coord<2>(3, 10), 5)));
+
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(-5, 2), Coord<2>(4, 4))
+               << CoordBox<2>(Coord<2>(3, 10), Coord<2>(2, 1));
+        TS_ASSERT_EQUALS(16 * 3.0 + 2 * 5.0, costs.totalCost(region));
+        TS_ASSERT_EQUALS(16 * 3.0 + 2 * 5.0 + 72.0, costs.totalCost());
+    }
+
+    void testFromCellTraits()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(5, 4));
+        CellCostMap<2> costs = CellCostMap<2>::fromCellTraits<CellCostMapTestCell>(box, Coord<2>(2, 2));
+
+        TS_ASSERT_EQUALS(1.5, costs[Coord<2>(0, 0)]);
+        TS_ASSERT_EQUALS(1.5, costs[Coord<2>(1, 3)]);
+        TS_ASSERT_EQUALS(3.5, costs[Coord<2>(2, 1)]);
+        TS_ASSERT_EQUALS(5.0, costs[Coord<2>(4, 2)]);
+        TS_ASSERT_EQUALS(4 * 15.0, costs.totalCost());
+
+        CellCostMap<2> uniform = CellCostMap<2>::fromCellTraits<int>(box, Coord<2>(2, 2));
+        TS_ASSERT_EQUALS(20.0, uniform.totalCost());
+    }
+
+    void testDefaultBlockDim()
+    {
+        TS_ASSERT_EQUALS(Coord<3>(1, 1, 1), CellCostMap<3>::defaultBlockDim(Coord<3>(100, 100, 100)));
+        TS_ASSERT_EQUALS(Coord<2>(1, 1),    CellCostMap<2>::defaultBlockDim(Coord<2>(1024, 1024)));
+        TS_ASSERT_EQUALS(Coord<2>(2, 1),    CellCostMap<2>::defaultBlockDim(Coord<2>(2048, 1024)));
+
+        Coord<3> dim(2000, 1000, 500);
+        Coord<3> blockDim = CellCostMap<3>::defaultBlockDim(dim);
+        long numBlocks = 1;
+        for (int d = 0; d < 3; ++d) {
+            numBlocks *= (dim[d] + blockDim[d] - 1) / blockDim[d];
+        }
+        TS_ASSERT(numBlocks <= CellCostMap<3>::MAX_BLOCKS);
+        TS_ASSERT(numBlocks > CellCostMap<3>::MAX_BLOCKS / 8);
+    }
+
+    void testAddSample()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(8, 8));
+        CellCostMap<2> costs(box, Coord<2>(4, 1), 1.0, 0.5);
+
+        costs.addSample(Streak<2>(Coord<2>(2, 3), 6), 12.0);
+        TS_ASSERT_EQUALS(1.0, costs[Coord<2>(2, 2)]);
+        TS_ASSERT_EQUALS(2.0, costs[Coord<2>(0, 3)]);
+        TS_ASSERT_EQUALS(2.0, costs[Coord<2>(7, 3)]);
+
+        costs.addSample(Streak<2>(Coord<2>(5, 3), 7), 0.0);
+        TS_ASSERT_EQUALS(2.0, costs[Coord<2>(0, 3)]);
+        TS_ASSERT_EQUALS(1.0, costs[Coord<2>(7, 3)]);
+    }
+
+    void testAddSampleOutsideOfBox()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(8, 8));
+        CellCostMap<2> costs(box, Coord<2>(4, 1), 1.0, 1.0);
+
+        costs.addSample(Streak<2>(Coord<2>(0, 8), 8), 100.0);
+        costs.addSample(Streak<2>(Coord<2>(0, -1), 8), 100.0);
+        TS_ASSERT_EQUALS(64.0, costs.totalCost());
+
+        // the time is spread over all cells, even those outside:
+        costs.addSample(Streak<2>(Coord<2>(-4, 2), 4), 24.0);
+        TS_ASSERT_EQUALS(3.0, costs[Coord<2>(0, 2)]);
+        TS_ASSERT_EQUALS(1.0, costs[Coord<2>(4, 2)]);
+    }
+
+    void testCalibrate()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(10, 10));
+        CellCostMap<2> costs(box);
+        costs.setCost(Coord<2>(1, 1), 4.0);
+
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(0, 0), Coord<2>(3, 3));
+        costs.calibrate(region, 24.0);
+
+        TS_ASSERT_EQUALS(24.0, costs.totalCost(region));
+        TS_ASSERT_EQUALS(8.0, costs[Coord<2>(1, 1)]);
+        TS_ASSERT_EQUALS(2.0, costs[Coord<2>(2, 0)]);
+        TS_ASSERT_EQUALS(1.0, costs[Coord<2>(3, 0)]);
+        TS_ASSERT_EQUALS(24.0 + 91.0, costs.totalCost());
+    }
+};
+
+}
@@ -0,0 +1,262 @@
+#include <libgeodecomp/geometry/partitions/costawarepartition.h>
+#include <libgeodecomp/geometry/partitions/hilbertpartition.h>
+#include <libgeodecomp/geometry/partitions/hindexingpartition.h>
+#include <libgeodecomp/geometry/partitions/recursivebisectionpartition.h>
+#include <libgeodecomp/geometry/partitions/stripingpartition.h>
+#include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+/**
+ * Models a domain with an expensive boundary layer.
+ */
+class CostAwarePartitionTestCell
+{
+public:
+    class API : public APITraits::HasCellCost
+    {};
+
+    static double cellCost(const Coord<2>& pos)
+    {
+        return (pos.y() < 8) ? 5.0 : 1.0;
+    }
+};
+
+class CostAwarePartitionTest : public CxxTest::TestSuite
+{
+public:
+    typedef std::vector<std::size_t> SizeTVec;
+
+    void testStriping()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(10, 10));
+        CellCostMap<2> costs(box);
+        for (int x = 0; x < 10; ++x) {
+            for (int y = 0; y < 5; ++y) {
+                costs.setCost(Coord<2>(x, y), 3.0);
+            }
+        }
+
+        SizeTVec weights;
+        weights << 50 << 50;
+        CostAwarePartition<StripingPartition<2> > partition(
+            box.origin, box.dimensions, 0, weights, costs);
+
+        // total cost is 200, so the first node gets 100 units worth
+        // of cells, which is 33 or 34 of the expensive ones:
+        SizeTVec expected;
+        expected << 33 << 67;
+        TS_ASSERT_EQUALS(expected, partition.getWeights());
+        TS_ASSERT_EQUALS(weights, partition.getCostShares());
+        TS_ASSERT_EQUALS(33, partition.getRegion(0).size());
+        TS_ASSERT_EQUALS(67, partition.getRegion(1).size());
+
+        checkPartition(partition, costs, weights, 3.0);
+    }
+
+    void testUniformCostsMatchPlainPartition()
+    {
+        SizeTVec weights;
+        weights << 100 << 300 << 50 << 62;
+        Coord<2> dim(32, 16);
+
+        checkUniform<StripingPartition<2> >(dim, weights);
+        checkUniform<ZCurvePartition<2> >(dim, weights);
+        checkUniform<HilbertPartition>(dim, weights);
+        checkUniform<HIndexingPartition>(dim, weights);
+    }
+
+    void testZCurve3D()
+    {
+        CoordBox<3> box(Coord<3>(0, 0, 0), Coord<3>(20, 16, 12));
+        CellCostMap<3> costs(box);
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            costs.setCost(*i, 1.0 + (i->x() * i->y() % 7) + ((i->z() < 3) ? 10 : 0));
+        }
+
+        SizeTVec weights(7, 0);
+        for (int i = 0; i < 7; ++i) {
+            weights[i] = box.dimensions.prod() / 7;
+        }
+        weights.back() += box.dimensions.prod() - sum(weights);
+
+        CostAwarePartition<ZCurvePartition<3> > partition(
+            box.origin, box.dimensions, 0, weights, costs);
+        checkPartition(partition, costs, weights, 17.0);
+
+        // compare against plain count-based splitting:
+        ZCurvePartition<3> plain(box.origin, box.dimensions, 0, weights);
+        TS_ASSERT(imbalance(plain, costs, 7) > 1.3);
+        TS_ASSERT(imbalance(partition, costs, 7) < 1.01);
+    }
+
+    void testCellTraits()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(64, 32));
+        CellCostMap<2> costs =
+            CellCostMap<2>::fromCellTraits<CostAwarePartitionTestCell>(box, Coord<2>(1, 1));
+
+        SizeTVec weights(4, 64 * 8);
+
+        CostAwarePartition<HilbertPartition, CostAwarePartitionTestCell> hilbert(
+            box.origin, box.dimensions, 0, weights);
+        checkPartition(hilbert, costs, weights, 5.0);
+        TS_ASSERT(imbalance(hilbert, costs, 4) < 1.01);
+
+        CostAwarePartition<ZCurvePartition<2>, CostAwarePartitionTestCell> zCurve(
+            box.origin, box.dimensions, 0, weights);
+        checkPartition(zCurve, costs, weights, 5.0);
+        TS_ASSERT(imbalance(zCurve, costs, 4) < 1.01);
+
+        // a cell without cost declaration yields the count-based result:
+        CostAwarePartition<ZCurvePartition<2>, int> uniform(
+            box.origin, box.dimensions, 0, weights);
+        ZCurvePartition<2> plain(box.origin, box.dimensions, 0, weights);
+        TS_ASSERT_EQUALS(weights, uniform.getWeights());
+        for (int i = 0; i < 4; ++i) {
+            TS_ASSERT_EQUALS(plain.getRegion(i), uniform.getRegion(i));
+        }
+    }
+
+    void testRecursiveBisection()
+    {
+        CoordBox<3> box(Coord<3>(10, 0, -5), Coord<3>(40, 30, 20));
+        CellCostMap<3> costs(box);
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            if ((i->x() < 20) && (i->y() < 10)) {
+                costs.setCost(*i, 8.0);
+            }
+        }
+
+        SizeTVec weights(8, box.dimensions.prod() / 8);
+        CostAwarePartition<RecursiveBisectionPartition<3> > partition(
+            box.origin, box.dimensions, 0, weights, costs);
+        RecursiveBisectionPartition<3> plain(
+            box.origin, box.dimensions, 0, weights);
+
+        Region<3> all;
+        double totalCost = 0;
+        for (int i = 0; i < 8; ++i) {
+            Region<3> r = partition.getRegion(i);
+            TS_ASSERT_EQUALS(r.boundingBox().dimensions.prod(), r.size());
+            TS_ASSERT((all & r).empty());
+            all += r;
+            totalCost += costs.totalCost(r);
+        }
+        TS_ASSERT_EQUALS(all.size(), box.dimensions.prod());
+        TS_ASSERT_EQUALS(costs.totalCost(), totalCost);
+
+        TS_ASSERT(imbalance(plain, costs, 8) > 2.0);
+        TS_ASSERT(imbalance(partition, costs, 8) < 1.2);
+    }
+
+    void testRecursiveBisectionCellTraits()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(32, 64));
+        CellCostMap<2> costs =
+            CellCostMap<2>::fromCellTraits<CostAwarePartitionTestCell>(box, Coord<2>(1, 1));
+
+        SizeTVec weights(2, 32 * 32);
+        CostAwarePartition<RecursiveBisectionPartition<2>, CostAwarePartitionTestCell> partition(
+            box.origin, box.dimensions, 0, weights);
+
+        // the total cost is 8 * 32 * 5 + 56 * 32 = 3072, half of it is
+        // reached after the expensive rows plus another 8 cheap ones:
+        Region<2> expected;
+        expected << CoordBox<2>(Coord<2>(0, 0), Coord<2>(32, 16));
+        TS_ASSERT_EQUALS(expected, partition.getRegion(0));
+        TS_ASSERT_EQUALS(1536.0, costs.totalCost(partition.getRegion(1)));
+    }
+
+    void testPartitionBuilder()
+    {
+        CoordBox<2> box(Coord<2>(0, 0), Coord<2>(10, 10));
+        CellCostMap<2> costs(box);
+        for (int y = 0; y < 5; ++y) {
+            for (int x = 0; x < 10; ++x) {
+                costs.setCost(Coord<2>(x, y), 3.0);
+            }
+        }
+        SizeTVec weights;
+        weights << 50 << 50;
+        SizeTVec expected;
+        expected << 33 << 67;
+
+        typedef CostAwarePartition<StripingPartition<2> > CostAwareType;
+        SharedPtr<CostAwareType>::Type costAware(
+            CostAwarePartitionHelpers::PartitionBuilder<CostAwareType, 2>::build(
+                box.origin, box.dimensions, 0, weights, Partition<2>::AdjacencyPtr(), &costs));
+        TS_ASSERT_EQUALS(expected, costAware->getWeights());
+
+        SharedPtr<CostAwareType>::Type noCosts(
+            CostAwarePartitionHelpers::PartitionBuilder<CostAwareType, 2>::build(
+                box.origin, box.dimensions, 0, weights, Partition<2>::AdjacencyPtr(), 0));
+        TS_ASSERT_EQUALS(weights, noCosts->getWeights());
+
+        // plain partitions ignore the costs:
+        SharedPtr<StripingPartition<2> >::Type plain(
+            CostAwarePartitionHelpers::PartitionBuilder<StripingPartition<2>, 2>::build(
+                box.origin, box.dimensions, 0, weights, Partition<2>::AdjacencyPtr(), &costs));
+        TS_ASSERT_EQUALS(weights, plain->getWeights());
+    }
+
+private:
+    template<typename PARTITION>
+    void checkUniform(const Coord<2>& dim, const SizeTVec& weights)
+    {
+        CellCostMap<2> costs(CoordBox<2>(Coord<2>(), dim));
+        PARTITION plain(Coord<2>(), dim, 0, weights);
+        CostAwarePartition<PARTITION> partition(Coord<2>(), dim, 0, weights, costs);
+
+        TS_ASSERT_EQUALS(weights, partition.getWeights());
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            TS_ASSERT_EQUALS(plain.getRegion(i), partition.getRegion(i));
+        }
+    }
+
+    /**
+     * checks that the regions form a disjoint cover and that the
+     * cost of each deviates from its target by at most maxCellCost.
+     */
+    template<typename PARTITION, int DIM>
+    void checkPartition(
+        const PARTITION& partition,
+        const CellCostMap<DIM>& costs,
+        const SizeTVec& shares,
+        const double maxCellCost)
+    {
+        double totalCost = costs.totalCost();
+        std::size_t totalShares = sum(shares);
+        Region<DIM> all;
+
+        for (std::size_t i = 0; i < shares.size(); ++i) {
+            Region<DIM> r = partition.getRegion(i);
+            TS_ASSERT((all & r).empty());
+            all += r;
+
+            double target = totalCost * shares[i] / totalShares;
+            TS_ASSERT_LESS_THAN_EQUALS(std::abs(costs.totalCost(r) - target), maxCellCost);
+        }
+
+        Region<DIM> expected;
+        expected << costs.boundingBox();
+        TS_ASSERT_EQUALS(expected, all);
+    }
+
+    template<typename PARTITION, int DIM>
+    double imbalance(const PARTITION& partition, const CellCostMap<DIM>& costs, int numNodes)
+    {
+        double maxCost = 0;
+        for (int i = 0; i < numNodes; ++i) {
+            maxCost = (std::max)(maxCost, costs.totalCost(partition.getRegion(i)));
+        }
+
+        return maxCost / (costs.totalCost() / numNodes);
+    }
+};
+
+}
@@ -0,0 +1,161 @@
+#include <libgeodecomp/geometry/partitions/hilbert3dpartition.h>
+#include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class Hilbert3DPartitionTest : public CxxTest::TestSuite
+{
+public:
+    typedef std::vector<Coord<3> > CoordVector;
+
+    void testSimple()
+    {
+        CoordVector expected;
+        expected << Coord<3>(10, 20, 30)
+                 << Coord<3>(10, 21, 30)
+                 << Coord<3>(10, 21, 31)
+                 << Coord<3>(10, 20, 31)
+                 << Coord<3>(11, 20, 31)
+                 << Coord<3>(11, 21, 31)
+                 << Coord<3>(11, 21, 30)
+                 << Coord<3>(11, 20, 30);
+
+        Hilbert3DPartition partition(Coord<3>(10, 20, 30), Coord<3>(2, 2, 2));
+        TS_ASSERT_EQUALS(expected, traverse(partition));
+    }
+
+    void testContinuityForPowersOfTwo()
+    {
+        for (int dim = 2; dim <= 32; dim *= 2) {
+            Hilbert3DPartition partition(Coord<3>(-5, 3, 1), Coord<3>::diagonal(dim));
+            CoordVector coords = traverse(partition);
+
+            checkCoverage(coords, CoordBox<3>(Coord<3>(-5, 3, 1), Coord<3>::diagonal(dim)));
+            TS_ASSERT_EQUALS(0, countJumps(coords));
+        }
+    }
+
+    void testArbitraryDimensions()
+    {
+        std::vector<Coord<3> > dims;
+        dims << Coord<3>(5, 3, 7)
+             << Coord<3>(13, 9, 2)
+             << Coord<3>(40, 6, 6)
+             << Coord<3>(1, 5, 9)
+             << Coord<3>(100, 3, 1)
+             << Coord<3>(17, 31, 23)
+             << Coord<3>(64, 16, 8);
+
+        for (std::size_t i = 0; i < dims.size(); ++i) {
+            CoordBox<3> box(Coord<3>(1, 2, 3), dims[i]);
+            Hilbert3DPartition partition(box.origin, box.dimensions);
+            CoordVector coords = traverse(partition);
+            checkCoverage(coords, box);
+
+            // odd dimensions make some jumps unavoidable, but
+            // there should be fewer than with the Z-curve:
+            ZCurvePartition<3> zCurve(box.origin, box.dimensions);
+            CoordVector zCoords;
+            for (ZCurvePartition<3>::Iterator j = zCurve.begin(); j != zCurve.end(); ++j) {
+                zCoords << *j;
+            }
+            TS_ASSERT_LESS_THAN(countJumps(coords), countJumps(zCoords));
+        }
+    }
+
+    void testSquareBracketsOperatorVersusIteration()
+    {
+        Hilbert3DPartition partition(Coord<3>(10, 20, 30), Coord<3>(11, 7, 19));
+        CoordVector coords = traverse(partition);
+
+        for (unsigned i = 0; i < coords.size(); ++i) {
+            TS_ASSERT_EQUALS(coords[i], *partition[i]);
+        }
+        TS_ASSERT(partition[coords.size()] == partition.end());
+    }
+
+    void testCacheMatchesRecursion()
+    {
+        Hilbert3DPartition partition(Coord<3>(0, 1, 2), Coord<3>(26, 19, 30));
+        CoordVector cached = traverse(partition);
+
+        Coord<3> maxCachedDimensions = Hilbert3DPartition::maxCachedDimensions;
+        Hilbert3DPartition::maxCachedDimensions = Coord<3>();
+        CoordVector recursive = traverse(partition);
+        Hilbert3DPartition::maxCachedDimensions = maxCachedDimensions;
+
+        TS_ASSERT_EQUALS(cached, recursive);
+    }
+
+    void testGetRegion()
+    {
+        CoordBox<3> box(Coord<3>(10, 10, 10), Coord<3>(48, 40, 32));
+        std::vector<std::size_t> weights;
+        weights << 10000 << 15000 << 5000 << 11440 << 20000;
+
+        Hilbert3DPartition hilbert(box.origin, box.dimensions, 0, weights);
+        ZCurvePartition<3> zCurve(box.origin, box.dimensions, 0, weights);
+
+        Region<3> all;
+        std::size_t hilbertSurface = 0;
+        std::size_t zCurveSurface = 0;
+
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            Region<3> region = hilbert.getRegion(i);
+            TS_ASSERT_EQUALS(weights[i], region.size());
+            TS_ASSERT((all & region).empty());
+            all += region;
+
+            hilbertSurface += (region.expand(1) - region).size();
+            Region<3> zRegion = zCurve.getRegion(i);
+            zCurveSurface += (zRegion.expand(1) - zRegion).size();
+        }
+
+        Region<3> expected;
+        expected << box;
+        TS_ASSERT_EQUALS(expected, all);
+        TS_ASSERT_LESS_THAN(hilbertSurface, zCurveSurface);
+    }
+
+private:
+    CoordVector traverse(const Hilbert3DPartition& partition)
+    {
+        CoordVector ret;
+        Hilbert3DPartition::Iterator end = partition.end();
+        for (Hilbert3DPartition::Iterator i = partition.begin(); i != end; ++i) {
+            ret << *i;
+        }
+        return ret;
+    }
+
+    void checkCoverage(const CoordVector& coords, const CoordBox<3>& box)
+    {
+        TS_ASSERT_EQUALS(coords.size(), std::size_t(box.dimensions.prod()));
+
+        Region<3> region;
+        for (CoordVector::const_iterator i = coords.begin(); i != coords.end(); ++i) {
+            region << *i;
+        }
+        Region<3> expected;
+        expected << box;
+        TS_ASSERT_EQUALS(expected, region);
+    }
+
+    std::size_t countJumps(const CoordVector& coords)
+    {
+        std::size_t jumps = 0;
+        for (std::size_t i = 1; i < coords.size(); ++i) {
+            Coord<3> delta = coords[i] - coords[i - 1];
+            if ((std::abs(delta.x()) + std::abs(delta.y()) + std::abs(delta.z())) != 1) {
+                ++jumps;
+            }
+        }
+        return jumps;
+    }
+};
+
+}
@@ -0,0 +1,154 @@
+#include <libgeodecomp/geometry/partitions/nodeawarepartition.h>
+#include <libgeodecomp/geometry/partitions/recursivebisectionpartition.h>
+#include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class NodeAwarePartitionTest : public CxxTest::TestSuite
+{
+public:
+    typedef std::vector<std::size_t> SizeTVec;
+
+    void setUp()
+    {
+        box = CoordBox<2>(Coord<2>(10, 20), Coord<2>(64, 64));
+        weights = SizeTVec(16, 256);
+
+        // 4 nodes, ranks are distributed round-robin:
+        roundRobin.clear();
+        for (int i = 0; i < 16; ++i) {
+            roundRobin << (i % 4);
+        }
+    }
+
+    void testPlacement()
+    {
+        std::vector<int> nodes;
+        nodes << 0 << 1 << 0 << 1 << 2 << 2;
+
+        SizeTVec expected;
+        expected << 0 << 2 << 1 << 3 << 4 << 5;
+        TS_ASSERT_EQUALS(expected, NodeAwarePartition<ZCurvePartition<2> >::placement(nodes));
+    }
+
+    void testRoundRobinZCurve()
+    {
+        checkRoundRobin<ZCurvePartition<2> >();
+    }
+
+    void testRoundRobinRecursiveBisection()
+    {
+        checkRoundRobin<RecursiveBisectionPartition<2> >();
+    }
+
+    void testWithoutNodeInformation()
+    {
+        // without node IDs each rank is considered a separate node,
+        // hence ranks are placed in order of their IDs:
+        NodeAwarePartition<ZCurvePartition<2> > partition(box.origin, box.dimensions, 0, weights);
+        ZCurvePartition<2> plain(box.origin, box.dimensions, 0, weights);
+
+        for (int i = 0; i < 16; ++i) {
+            TS_ASSERT_EQUALS(plain.getRegion(i), partition.getRegion(i));
+        }
+    }
+
+    void testPartitionBuilder()
+    {
+        typedef NodeAwarePartition<ZCurvePartition<2> > PartitionType;
+        SharedPtr<PartitionType>::Type partition(
+            NodeAwarePartitionHelpers::PartitionBuilder<PartitionType, 2>::build(
+                box.origin, box.dimensions, 0, weights, PartitionType::AdjacencyPtr(), 0, roundRobin));
+        NodeAwarePartition<ZCurvePartition<2> > expected(box.origin, box.dimensions, 0, weights, roundRobin);
+
+        TS_ASSERT_EQUALS(roundRobin, partition->getNodes());
+        for (int i = 0; i < 16; ++i) {
+            TS_ASSERT_EQUALS(expected.getRegion(i), partition->getRegion(i));
+        }
+
+        // other partitions don't care about nodes:
+        SharedPtr<ZCurvePartition<2> >::Type plain(
+            NodeAwarePartitionHelpers::PartitionBuilder<ZCurvePartition<2>, 2>::build(
+                box.origin, box.dimensions, 0, weights, PartitionType::AdjacencyPtr(), 0, roundRobin));
+        TS_ASSERT_EQUALS(weights, plain->getWeights());
+    }
+
+    void testMismatchedNodes()
+    {
+        std::vector<int> nodes(3, 0);
+        TS_ASSERT_THROWS(
+            NodeAwarePartition<ZCurvePartition<2> >(box.origin, box.dimensions, 0, weights, nodes),
+            std::invalid_argument&);
+
+        // more node IDs than ranks must be caught before they're used for the placement:
+        nodes = std::vector<int>(weights.size() + 5, 0);
+        TS_ASSERT_THROWS(
+            NodeAwarePartition<ZCurvePartition<2> >(box.origin, box.dimensions, 0, weights, nodes),
+            std::invalid_argument&);
+    }
+
+private:
+    CoordBox<2> box;
+    SizeTVec weights;
+    std::vector<int> roundRobin;
+
+    template<typename PARTITION>
+    void checkRoundRobin()
+    {
+        NodeAwarePartition<PARTITION> partition(box.origin, box.dimensions, 0, weights, roundRobin);
+        PARTITION plain(box.origin, box.dimensions, 0, weights);
+
+        TS_ASSERT_EQUALS(weights, partition.getWeights());
+        TS_ASSERT_EQUALS(roundRobin, partition.getNodes());
+
+        Region<2> all;
+        for (int i = 0; i < 16; ++i) {
+            Region<2> region = partition.getRegion(i);
+            TS_ASSERT_EQUALS(weights[i], region.size());
+            TS_ASSERT((all & region).empty());
+            all += region;
+        }
+        Region<2> expected;
+        expected << box;
+        TS_ASSERT_EQUALS(expected, all);
+
+        // inter-node traffic is limited to the boundaries of the
+        // coarse (per node) subdomains:
+        PARTITION coarse(box.origin, box.dimensions, 0, SizeTVec(4, 1024));
+        std::vector<int> coarseNodes;
+        coarseNodes << 0 << 1 << 2 << 3;
+
+        std::size_t interNodeHalo = interNodeHaloVolume(partition, roundRobin);
+        TS_ASSERT_EQUALS(interNodeHaloVolume(coarse, coarseNodes), interNodeHalo);
+        TS_ASSERT_LESS_THAN(2 * interNodeHalo, interNodeHaloVolume(plain, roundRobin));
+    }
+
+    /**
+     * Sums up the number of cells each node needs to receive from
+     * other nodes.
+     */
+    template<typename PARTITION>
+    std::size_t interNodeHaloVolume(const PARTITION& partition, const std::vector<int>& nodes)
+    {
+        std::map<int, Region<2> > nodeRegions;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            nodeRegions[nodes[i]] += partition.getRegion(i);
+        }
+
+        Region<2> domain;
+        domain << box;
+        std::size_t ret = 0;
+
+        for (std::map<int, Region<2> >::iterator i = nodeRegions.begin(); i != nodeRegions.end(); ++i) {
+            ret += ((i->second.expand(1) & domain) - i->second).size();
+        }
+
+        return ret;
+    }
+};
+
+}
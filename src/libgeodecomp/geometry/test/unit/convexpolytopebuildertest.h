@@ -0,0 +1,122 @@
+#include <libgeodecomp/geometry/convexpolytopebuilder.h>
+#include <libgeodecomp/misc/random.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class ConvexPolytopeBuilderTest : public CxxTest::TestSuite
+{
+public:
+    typedef ConvexPolytope<FloatCoord<2> > PolytopeType;
+    typedef std::pair<FloatCoord<2>, int> PointType;
+
+    void testMatchesSequentialInsertion()
+    {
+        Random::seed(4711);
+        FloatCoord<2> simSpaceDim(1000, 800);
+        ConvexPolytopeBuilder<FloatCoord<2> > builder;
+
+        for (int round = 0; round < 20; ++round) {
+            std::vector<PointType> points;
+            for (int i = 0; i < 500; ++i) {
+                points << std::make_pair(
+                    FloatCoord<2>(Random::genDouble(simSpaceDim[0]), Random::genDouble(simSpaceDim[1])),
+                    i);
+            }
+            FloatCoord<2> center = points.back().first;
+
+            PolytopeType expected(center, simSpaceDim);
+            for (std::vector<PointType>::iterator i = points.begin(); i != points.end(); ++i) {
+                if (i->first != center) {
+                    expected << *i;
+                }
+            }
+            expected.updateGeometryData();
+
+            PolytopeType actual(center, simSpaceDim);
+            builder(&actual, points.begin(), points.end());
+            actual.updateGeometryData();
+
+            // only the few points forming the polytope's limits
+            // should have been handed to the polytope:
+            TS_ASSERT(builder.numCuttingPoints() < 40);
+            checkEqual(expected, actual);
+        }
+    }
+
+    void testPresetLimitsAreRespected()
+    {
+        FloatCoord<2> simSpaceDim(100, 100);
+        FloatCoord<2> center(50, 50);
+
+        std::vector<PointType> points;
+        points << std::make_pair(FloatCoord<2>(60, 50), 1)
+               << std::make_pair(FloatCoord<2>(50, 60), 2);
+
+        PolytopeType expected(center, simSpaceDim);
+        expected << std::make_pair(FloatCoord<2>(40, 50), 3);
+        expected << points[0] << points[1];
+        expected.updateGeometryData();
+
+        PolytopeType actual(center, simSpaceDim);
+        actual << std::make_pair(FloatCoord<2>(40, 50), 3);
+        ConvexPolytopeBuilder<FloatCoord<2> > builder;
+        builder(&actual, points.begin(), points.end());
+        actual.updateGeometryData();
+
+        checkEqual(expected, actual);
+        TS_ASSERT_EQUALS(std::size_t(4), actual.getLimits().size());
+        TS_ASSERT_DELTA(10 * 55, actual.getVolume(), 10);
+    }
+
+    void testReuseAfterReset()
+    {
+        FloatCoord<2> simSpaceDim(100, 100);
+        std::vector<PointType> points;
+        points << std::make_pair(FloatCoord<2>(20, 20), 1)
+               << std::make_pair(FloatCoord<2>(80, 20), 2)
+               << std::make_pair(FloatCoord<2>(20, 80), 3)
+               << std::make_pair(FloatCoord<2>(80, 80), 4);
+
+        ConvexPolytopeBuilder<FloatCoord<2> > builder;
+        PolytopeType polytope;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            polytope.reset(points[i].first, simSpaceDim);
+            builder(&polytope, points.begin(), points.end());
+            polytope.updateGeometryData();
+
+            TS_ASSERT_EQUALS(std::size_t(4), polytope.getShape().size());
+            TS_ASSERT_DELTA(2500, polytope.getVolume(), 100);
+        }
+    }
+
+private:
+    void checkEqual(const PolytopeType& expected, const PolytopeType& actual)
+    {
+        std::set<int> expectedNeighbors;
+        for (std::size_t i = 0; i < expected.getLimits().size(); ++i) {
+            expectedNeighbors << expected.getLimits()[i].neighborID;
+        }
+        std::set<int> actualNeighbors;
+        for (std::size_t i = 0; i < actual.getLimits().size(); ++i) {
+            actualNeighbors << actual.getLimits()[i].neighborID;
+        }
+        TS_ASSERT_EQUALS(expectedNeighbors, actualNeighbors);
+
+        // cut order may differ, hence the tolerance:
+        std::vector<FloatCoord<2> > expectedShape = expected.getShape();
+        std::vector<FloatCoord<2> > actualShape = actual.getShape();
+        TS_ASSERT_EQUALS(expectedShape.size(), actualShape.size());
+        for (std::size_t i = 0; i < (std::min)(expectedShape.size(), actualShape.size()); ++i) {
+            TS_ASSERT_DELTA(expectedShape[i][0], actualShape[i][0], 1e-9);
+            TS_ASSERT_DELTA(expectedShape[i][1], actualShape[i][1], 1e-9);
+        }
+
+        TS_ASSERT_DELTA(expected.getDiameter(), actual.getDiameter(), 1e-9);
+    }
+};
+
+}
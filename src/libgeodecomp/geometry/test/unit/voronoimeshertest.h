@@ -62,7 +62,8 @@ public:
 
     virtual void addCell(ContainerCellType *container, const FloatCoord<DIM>& center)
     {
-        container->insert(cellCounter++, DummyCell(center));
+        container->insert(cellCounter, DummyCell(center, cellCounter));
+        ++cellCounter;
     }
 
     int cellCounter;
@@ -128,6 +129,68 @@ public:
         }
     }
 
+    void testFillGeometryDataOnEmptyGrid()
+    {
+        Coord<2> dim(3, 2);
+        Grid<ContainerCellType> grid(dim);
+        MockMesher mesher(dim, FloatCoord<2>(100, 100), 20);
+
+        mesher.fillGeometryData(&grid);
+
+        CoordBox<2> box(Coord<2>(), dim);
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(grid[*i].size(), std::size_t(0));
+        }
+    }
+
+    void testFillGeometryDataMatchesBruteForce()
+    {
+        Coord<2> dim(4, 3);
+        CoordBox<2> box(Coord<2>(), dim);
+        FloatCoord<2> quadrantSize(100, 100);
+        FloatCoord<2> simSpaceDim = quadrantSize.scale(dim);
+        Grid<ContainerCellType> grid(dim);
+        MockMesher mesher(dim, quadrantSize, 4.0);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            mesher.addRandomCells(&grid, *i, 20);
+        }
+        mesher.fillGeometryData(&grid);
+
+        std::vector<DummyCell> allCells;
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            allCells.insert(allCells.end(), grid[*i].begin(), grid[*i].end());
+        }
+
+        // reference: cut each element with all other elements,
+        // regardless of their distance:
+        for (std::vector<DummyCell>::iterator i = allCells.begin(); i != allCells.end(); ++i) {
+            ConvexPolytope<FloatCoord<2> > element(i->center, simSpaceDim);
+            for (std::vector<DummyCell>::iterator j = allCells.begin(); j != allCells.end(); ++j) {
+                if (i != j) {
+                    element << std::make_pair(j->center, j->id);
+                }
+            }
+            element.updateGeometryData();
+
+            std::set<int> expectedNeighbors;
+            for (std::size_t l = 0; l < element.getLimits().size(); ++l) {
+                expectedNeighbors << element.getLimits()[l].neighborID;
+            }
+            std::set<int> actualNeighbors(i->neighborIDs.begin(), i->neighborIDs.end());
+
+            // cut order may differ, hence the tolerance:
+            std::vector<FloatCoord<2> > expectedShape = element.getShape();
+            TS_ASSERT_EQUALS(expectedShape.size(), i->shape.size());
+            for (std::size_t k = 0; k < (std::min)(expectedShape.size(), i->shape.size()); ++k) {
+                TS_ASSERT_DELTA(expectedShape[k][0], i->shape[k][0], 1e-9);
+                TS_ASSERT_DELTA(expectedShape[k][1], i->shape[k][1], 1e-9);
+            }
+            TS_ASSERT_EQUALS(expectedNeighbors, actualNeighbors);
+            TS_ASSERT_EQUALS(0, int(actualNeighbors.count(i->id)));
+        }
+    }
+
     void testAddRandomCells()
     {
         Coord<2> dim(7, 3);
@@ -2,14 +2,17 @@
 #define LIBGEODECOMP_GEOMETRY_VORONOIMESHER_H
 
 #include <libgeodecomp/geometry/convexpolytope.h>
+#include <libgeodecomp/geometry/convexpolytopebuilder.h>
 #include <libgeodecomp/geometry/floatcoord.h>
 #include <libgeodecomp/geometry/plane.h>
 #include <libgeodecomp/io/logger.h>
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/misc/random.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
 #include <libgeodecomp/storage/gridbase.h>
 #include <algorithm>
 #include <set>
+#include <string>
 
 namespace LibGeoDecomp {
 
@@ -77,40 +80,229 @@ public:
         }
     };
 
+    /**
+     * Computes shape, area and neighbors of all elements. Containers
+     * are processed in parallel (if OpenMP is available) and are
+     * updated in place.
+     */
     void fillGeometryData(GridType *grid)
     {
         CoordBox<DIM> box = grid->boundingBox();
-        FloatCoord<DIM> simSpaceDim = quadrantSize.scale(box.dimensions);
-        // statistics:
-        std::size_t maxShape = 0;
-        std::size_t maxNeighbors = 0;
-        std::size_t maxCells = 0;
-        double maxDiameter = 0;
-
-        for (typename CoordBox<DIM>::Iterator iter = box.begin(); iter != box.end(); ++iter) {
-            Coord<2> containerCoord = *iter;
-            ContainerCellType container = grid->get(containerCoord);
-            maxCells = (std::max)(maxCells, container.size());
-
-            for (typename ContainerCellType::Iterator i = container.begin(); i != container.end(); ++i) {
-                Cargo& cell = *i;
-                ElementType e(cell.center, simSpaceDim);
-                for (int y = -1; y < 2; ++y) {
-                    for (int x = -1; x < 2; ++x) {
-                        ContainerCellType container2 =
-                            grid->get(containerCoord + Coord<2>(x, y));
-                        for (typename ContainerCellType::Iterator j = container2.begin();
-                             j != container2.end();
-                             ++j) {
-                            if (cell.center != j->center) {
-                                e << std::make_pair(j->center, i->id);
-                            }
-                        }
+        Region<DIM> region;
+        region << box;
+
+        // each container is read by all elements in its
+        // neighborhood, so we collect the elements' centers just
+        // once, rather than copying whole containers:
+        ElementIndex index(box, grid->getEdge());
+        const GridType *constGrid = grid;
+        constGrid->visit(region, &index);
+
+        GeometryFiller filler(this, &index, quadrantSize.scale(box.dimensions));
+        grid->visit(region, &filler);
+
+        LOG(DBG,
+            "VoronoiMesher::fillGeometryData(maxShape: " << filler.maxShape
+            << ", maxNeighbors: " << filler.maxNeighbors
+            << ", maxDiameter: " << filler.maxDiameter
+            << ", maxCells: " << filler.maxCells << ")");
+    }
+
+    virtual void addCell(ContainerCellType *container, const FloatCoord<DIM>& center) = 0;
+
+protected:
+    typedef typename APITraits::SelectCoordType<CONTAINER_CELL>::Value CoordType;
+    typedef typename APITraits::SelectIDType<CONTAINER_CELL>::Value IDType;
+
+    /**
+     * Spatial hash of all elements' centers and IDs, bucketed by
+     * their container's coordinate.
+     */
+    class ElementIndex : public ConstGridVisitor<ContainerCellType, DIM>
+    {
+    public:
+        typedef std::pair<CoordType, IDType> Element;
+
+        ElementIndex(const CoordBox<DIM>& box, const ContainerCellType& edgeContainer) :
+            box(box),
+            offsets(box.dimensions.prod() + 1, std::make_pair(0, 0))
+        {
+            // the edge container is stored behind all others:
+            append(box.dimensions.prod(), &edgeContainer);
+        }
+
+        virtual void visit(const Streak<DIM>& streak, const ContainerCellType *containers)
+        {
+            for (Coord<DIM> c = streak.origin; c.x() < streak.endX; ++c.x()) {
+                append(indexOf(c), containers++);
+            }
+        }
+
+        inline const Element *begin(const Coord<DIM>& containerCoord) const
+        {
+            return base() + offsets[indexOf(containerCoord)].first;
+        }
+
+        inline const Element *end(const Coord<DIM>& containerCoord) const
+        {
+            return base() + offsets[indexOf(containerCoord)].second;
+        }
+
+    private:
+        CoordBox<DIM> box;
+        std::vector<std::pair<std::size_t, std::size_t> > offsets;
+        std::vector<Element> elements;
+
+        inline const Element *base() const
+        {
+            // empty containers yield empty ranges, but &elements[0]
+            // would be undefined for an empty vector:
+            if (elements.empty()) {
+                return 0;
+            }
+
+            return &elements[0];
+        }
+
+        inline std::size_t indexOf(const Coord<DIM>& containerCoord) const
+        {
+            Coord<DIM> relativeCoord = containerCoord - box.origin;
+            if (Topology::isOutOfBounds(relativeCoord, box.dimensions)) {
+                return offsets.size() - 1;
+            }
+
+            relativeCoord = Topology::normalize(relativeCoord, box.dimensions);
+            return relativeCoord.toIndex(box.dimensions);
+        }
+
+        void append(std::size_t index, const ContainerCellType *container)
+        {
+            offsets[index].first = elements.size();
+            for (typename ContainerCellType::const_iterator i = container->begin(); i != container->end(); ++i) {
+                elements << std::make_pair(i->center, i->id);
+            }
+            offsets[index].second = elements.size();
+        }
+    };
+
+    /**
+     * Computes shape, area and neighbors of all elements in the
+     * visited containers. All elements in the neighborhood are cut
+     * into an element's polytope in one batch by a
+     * ConvexPolytopeBuilder.
+     */
+    class GeometryFiller : public GridVisitor<ContainerCellType, DIM>
+    {
+    public:
+        GeometryFiller(
+            const VoronoiMesher *mesher,
+            const ElementIndex *index,
+            const FloatCoord<DIM>& simSpaceDim) :
+            maxShape(0),
+            maxNeighbors(0),
+            maxCells(0),
+            maxDiameter(0),
+            mesher(mesher),
+            index(index),
+            simSpaceDim(simSpaceDim)
+        {}
+
+        virtual void visit(const Streak<DIM>& streak, ContainerCellType *containers)
+        {
+            std::string error;
+
+#pragma omp parallel
+            {
+                // scratch storage is reused for all containers a
+                // thread processes:
+                Scratch scratch;
+
+#pragma omp for schedule(dynamic)
+                for (int x = 0; x < streak.length(); ++x) {
+                    Coord<DIM> containerCoord = streak.origin;
+                    containerCoord.x() += x;
+
+                    // exceptions must not escape the parallel region:
+                    try {
+                        fill(containerCoord, containers + x, &scratch);
+                    } catch (const std::logic_error& e) {
+#pragma omp critical
+                        error = e.what();
+                    }
+                }
+
+#pragma omp critical
+                {
+                    maxShape     = (std::max)(maxShape,     scratch.maxShape);
+                    maxNeighbors = (std::max)(maxNeighbors, scratch.maxNeighbors);
+                    maxCells     = (std::max)(maxCells,     scratch.maxCells);
+                    maxDiameter  = (std::max)(maxDiameter,  scratch.maxDiameter);
+                }
+            }
+
+            if (!error.empty()) {
+                throw std::logic_error(error);
+            }
+        }
+
+        std::size_t maxShape;
+        std::size_t maxNeighbors;
+        std::size_t maxCells;
+        double maxDiameter;
+
+    private:
+        typedef typename ElementIndex::Element Element;
+
+        /**
+         * Per-thread buffers and statistics
+         */
+        class Scratch
+        {
+        public:
+            Scratch() :
+                maxShape(0),
+                maxNeighbors(0),
+                maxCells(0),
+                maxDiameter(0)
+            {}
+
+            ElementType element;
+            ConvexPolytopeBuilder<CoordType, IDType> builder;
+            std::vector<Element> candidates;
+            std::size_t maxShape;
+            std::size_t maxNeighbors;
+            std::size_t maxCells;
+            double maxDiameter;
+        };
+
+        const VoronoiMesher *mesher;
+        const ElementIndex *index;
+        FloatCoord<DIM> simSpaceDim;
+
+        void fill(const Coord<DIM>& containerCoord, ContainerCellType *container, Scratch *scratch)
+        {
+            scratch->maxCells = (std::max)(scratch->maxCells, container->size());
+
+            scratch->candidates.clear();
+            for (int y = -1; y < 2; ++y) {
+                for (int x = -1; x < 2; ++x) {
+                    Coord<DIM> neighborCoord = containerCoord + Coord<2>(x, y);
+                    const Element *end = index->end(neighborCoord);
+                    for (const Element *j = index->begin(neighborCoord); j != end; ++j) {
+                        scratch->candidates << *j;
                     }
                 }
+            }
+
+            ElementType& e = scratch->element;
+            for (typename ContainerCellType::Iterator i = container->begin(); i != container->end(); ++i) {
+                Cargo& cell = *i;
+
+                e.reset(cell.center, simSpaceDim);
+                scratch->builder(&e, scratch->candidates.begin(), scratch->candidates.end());
 
                 e.updateGeometryData();
-                if (e.getDiameter() > quadrantSize.minElement()) {
+                if (e.getDiameter() > mesher->quadrantSize.minElement()) {
                     throw std::logic_error("element geometry too large for container cell");
                 }
 
@@ -123,24 +315,13 @@ public:
                     cell.pushNeighbor(l->neighborID, l->length, l->dir);
                 }
 
-                maxShape     = (std::max)(maxShape,     cell.shape.size());
-                maxNeighbors = (std::max)(maxNeighbors, cell.numberOfNeighbors());
-                maxDiameter  = (std::max)(maxDiameter,  e.getDiameter());
+                scratch->maxShape     = (std::max)(scratch->maxShape,     cell.shape.size());
+                scratch->maxNeighbors = (std::max)(scratch->maxNeighbors, cell.numberOfNeighbors());
+                scratch->maxDiameter  = (std::max)(scratch->maxDiameter,  e.getDiameter());
             }
-
-            grid->set(containerCoord, container);
         }
+    };
 
-        LOG(DBG,
-            "VoronoiMesher::fillGeometryData(maxShape: " << maxShape
-            << ", maxNeighbors: " << maxNeighbors
-            << ", maxDiameter: " << maxDiameter
-            << ", maxCells: " << maxCells << ")");
-    }
-
-    virtual void addCell(ContainerCellType *container, const FloatCoord<DIM>& center) = 0;
-
-protected:
     Coord<DIM> gridDim;
     FloatCoord<DIM> quadrantSize;
     double minCellDistance;
@@ -0,0 +1,141 @@
+#ifndef LIBGEODECOMP_IO_CHROMETRACEWRITER_H
+#define LIBGEODECOMP_IO_CHROMETRACEWRITER_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/io/ioexception.h>
+#include <libgeodecomp/io/parallelwriter.h>
+#include <libgeodecomp/io/writer.h>
+#include <libgeodecomp/misc/clonable.h>
+#include <libgeodecomp/misc/eventtracer.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace LibGeoDecomp {
+
+#ifdef _MSC_BUILD
+#pragma warning( push )
+#pragma warning( disable : 4626 )
+#endif
+
+/**
+ * Enables the EventTracer and writes the recorded timeline of all
+ * Chronometer events (compute, ghost zone communication, IO...) to
+ * filename once the simulation is done. The result can be loaded
+ * into chrome://tracing or https://ui.perfetto.dev. When used as a
+ * ParallelWriter, the clocks of all ranks are aligned upon
+ * initialization and the traces of all ranks are merged into one
+ * file by rank 0. Both are collective operations on the
+ * communicator given to the constructor, which therefore has to
+ * match the one of the simulator.
+ *
+ * Events are tagged with the time step during which they occurred,
+ * so the period should be 1 unless coarser tags suffice. Requires
+ * LibGeoDecomp to be built with WITH_EVENT_TRACING, otherwise the
+ * trace will be empty.
+ */
+template<typename CELL_TYPE>
+class ChromeTraceWriter :
+        public Clonable<Writer<CELL_TYPE>, ChromeTraceWriter<CELL_TYPE> >,
+        public Clonable<ParallelWriter<CELL_TYPE>, ChromeTraceWriter<CELL_TYPE> >
+{
+public:
+    typedef typename Writer<CELL_TYPE>::GridType WriterGridType;
+    typedef typename ParallelWriter<CELL_TYPE>::GridType ParallelWriterGridType;
+    typedef typename ParallelWriter<CELL_TYPE>::Topology Topology;
+
+    static const int DIM = Topology::DIM;
+
+    explicit ChromeTraceWriter(
+        const std::string& filename,
+        const unsigned period = 1,
+        const std::size_t bufferSize = EventTracer::DEFAULT_BUFFER_SIZE
+#ifdef LIBGEODECOMP_WITH_MPI
+        , const MPI_Comm& communicator = MPI_COMM_WORLD
+#endif
+        ) :
+        Clonable<Writer<CELL_TYPE>, ChromeTraceWriter<CELL_TYPE> >(filename, period),
+        Clonable<ParallelWriter<CELL_TYPE>, ChromeTraceWriter<CELL_TYPE> >(filename, period)
+#ifdef LIBGEODECOMP_WITH_MPI
+        , comm(communicator)
+#endif
+    {
+        EventTracer::enable(bufferSize);
+    }
+
+    virtual void stepFinished(const WriterGridType& /* grid */, unsigned step, WriterEvent event)
+    {
+        EventTracer::setStep(step);
+
+        if (event == WRITER_ALL_DONE) {
+            std::ofstream file(filename().c_str());
+            if (!file.good()) {
+                throw FileOpenException(filename());
+            }
+            EventTracer::writeChromeTrace(file);
+        }
+    }
+
+    virtual void stepFinished(
+        const ParallelWriterGridType& /* grid */,
+        const Region<DIM>& /* validRegion */,
+        const Coord<DIM>& /* globalDimensions */,
+        unsigned step,
+        WriterEvent event,
+        std::size_t rank,
+        bool lastCall)
+    {
+        if (!lastCall) {
+            return;
+        }
+
+        EventTracer::setStep(step);
+
+#ifdef LIBGEODECOMP_WITH_MPI
+        if (event == WRITER_INITIALIZED) {
+            EventTracer::synchronizeClocks(comm);
+        }
+
+        if (event == WRITER_ALL_DONE) {
+            if (rank != 0) {
+                std::stringstream dummy;
+                EventTracer::gatherChromeTrace(dummy, comm);
+                return;
+            }
+
+            std::ofstream file(filename().c_str());
+            EventTracer::gatherChromeTrace(file, comm);
+            if (!file.good()) {
+                throw FileWriteException(filename());
+            }
+        }
+#else
+        if (event == WRITER_ALL_DONE) {
+            EventTracer::setRank(rank);
+            std::ofstream file(filename().c_str());
+            if (!file.good()) {
+                throw FileOpenException(filename());
+            }
+            EventTracer::writeChromeTrace(file);
+        }
+#endif
+    }
+
+private:
+#ifdef LIBGEODECOMP_WITH_MPI
+    MPI_Comm comm;
+#endif
+
+    const std::string& filename() const
+    {
+        return Writer<CELL_TYPE>::prefix;
+    }
+};
+
+#ifdef _MSC_BUILD
+#pragma warning( pop )
+#endif
+
+}
+
+#endif
@@ -125,6 +125,21 @@ public:
         delegate.grid(target);
     }
 
+    virtual bool supportsStreakInit() const
+    {
+        return delegate.supportsStreakInit();
+    }
+
+    virtual void initStreak(const Streak<DIM>& streak, Cell *target)
+    {
+        delegate.initStreak(streak, target);
+    }
+
+    virtual Cell edgeCell() const
+    {
+        return delegate.edgeCell();
+    }
+
     virtual CoordBox<DIM> gridBox()
     {
         return delegate.gridBox();
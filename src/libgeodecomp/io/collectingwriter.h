@@ -75,6 +75,9 @@ public:
                 Region<DIM> region;
                 region << CoordBox<DIM>(Coord<DIM>(), globalDimensions);
                 globalGrid = StorageGridType(region);
+                // no sender's region can exceed the whole grid, so
+                // resizing the buffer per sender won't allocate:
+                buffer.reserve(SerializationBuffer<CELL_TYPE>::storageSize(region));
             }
 
             globalGrid.loadRegion(buffer, validRegion);
@@ -3,11 +3,13 @@
 
 #include <libgeodecomp/config.h>
 #include <libgeodecomp/geometry/adjacencymanufacturer.h>
+#include <libgeodecomp/geometry/streak.h>
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/misc/random.h>
 #include <libgeodecomp/storage/gridbase.h>
 #include <libgeodecomp/geometry/regionbasedadjacency.h>
 #include <stdexcept>
+#include <vector>
 
 namespace LibGeoDecomp {
 
@@ -37,6 +39,91 @@ public:
      */
     virtual void grid(GridBase<CELL, DIM> *target) = 0;
 
+    /**
+     * Initializers which can set up cells independently of each
+     * other should return true here and implement initStreak() and
+     * edgeCell(). Simulators will then initialize their grids in
+     * parallel (see initGrids()), otherwise they'll fall back to
+     * grid().
+     */
+    virtual bool supportsStreakInit() const
+    {
+        return false;
+    }
+
+    /**
+     * Initializes the cells of one streak, target points to
+     * streak.length() cells. This function will be called
+     * concurrently from multiple threads (for disjoint streaks), so
+     * it needs to be thread-safe -- which e.g. seedRNG() isn't.
+     * Coordinates may lie outside of gridBox() for periodic
+     * topologies, use normalize() if in doubt.
+     */
+    virtual void initStreak(const Streak<DIM>& /* streak */, CELL * /* target */)
+    {
+        throw std::logic_error("initStreak() not implemented, supportsStreakInit() should return false");
+    }
+
+    /**
+     * Cell which simulators should use for the grid's edge when
+     * initializing via initStreak().
+     */
+    virtual CELL edgeCell() const
+    {
+        return CELL();
+    }
+
+    /**
+     * Initializes one or two grids (which need to have the same
+     * bounding region) via initStreak(). Streaks are distributed
+     * among threads with the same static schedule which
+     * UpdateFunctor uses. Grids which store their cells
+     * consecutively (e.g. Grid) are initialized in place, the second
+     * grid is then copied from the first one streak by streak. Falls
+     * back to grid() if streak-wise initialization isn't supported.
+     *
+     * Pages are placed on the NUMA node of the thread which touches
+     * them first. Grid already does so with a matching schedule upon
+     * construction, SoAGrid doesn't as LibFlatArray constructs all
+     * members on the allocating thread.
+     */
+    void initGrids(GridBase<CELL, DIM> *target1, GridBase<CELL, DIM> *target2 = 0)
+    {
+        if (!supportsStreakInit()) {
+            grid(target1);
+            if (target2) {
+                grid(target2);
+            }
+            return;
+        }
+
+        const Region<DIM>& region = target1->boundingRegion();
+        std::vector<Streak<DIM> > streaks;
+        streaks.reserve(region.numStreaks());
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            streaks.push_back(*i);
+        }
+
+#pragma omp parallel
+        {
+            Region<DIM> threadRegion;
+
+#pragma omp for schedule(static)
+            for (long i = 0; i < long(streaks.size()); ++i) {
+                threadRegion << streaks[std::size_t(i)];
+            }
+
+            StreakInitVisitor visitor(this, target2);
+            target1->visit(threadRegion, &visitor);
+        }
+
+        CELL edge = edgeCell();
+        target1->setEdge(edge);
+        if (target2) {
+            target2->setEdge(edge);
+        }
+    }
+
     /**
      * Allows a Simulator to discover the extent of the whole
      * simulation. Usually Simulations will use 0 as the origin, but
@@ -109,6 +196,33 @@ public:
         return AdjacencyPtr();
     }
 
+protected:
+    /**
+     * Lets initStreak() write directly into a grid and copies the
+     * result into an optional second grid. Initializers may use it
+     * to implement grid() via GridBase::visit().
+     */
+    class StreakInitVisitor : public GridVisitor<CELL, DIM>
+    {
+    public:
+        StreakInitVisitor(Initializer *initializer, GridBase<CELL, DIM> *secondTarget) :
+            initializer(initializer),
+            secondTarget(secondTarget)
+        {}
+
+        virtual void visit(const Streak<DIM>& streak, CELL *cells)
+        {
+            initializer->initStreak(streak, cells);
+            if (secondTarget) {
+                secondTarget->set(streak, cells);
+            }
+        }
+
+    private:
+        Initializer *initializer;
+        GridBase<CELL, DIM> *secondTarget;
+    };
+
 private:
     template<typename TOPOLOGY>
     void checkTopologyIfAdjacencyIsNeeded(const TOPOLOGY /* unused */) const
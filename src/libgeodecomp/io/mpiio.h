@@ -12,6 +12,84 @@
 
 namespace LibGeoDecomp {
 
+namespace MPIIOHelpers {
+
+/**
+ * Reads each visited Streak from the file directly into the grid.
+ */
+template<typename CELL_TYPE, typename TOPOLOGY, int DIM>
+class StreakReader : public GridVisitor<CELL_TYPE, DIM>
+{
+public:
+    StreakReader(
+        MPI_File file,
+        const MPI_Offset& headerLength,
+        const MPI_Aint& cellLength,
+        const Coord<DIM>& dimensions,
+        const MPI_Datatype& mpiDatatype) :
+        file(file),
+        headerLength(headerLength),
+        cellLength(cellLength),
+        dimensions(dimensions),
+        mpiDatatype(mpiDatatype)
+    {}
+
+    virtual void visit(const Streak<DIM>& streak, CELL_TYPE *cells)
+    {
+        // the coords need to be normalized because on torus
+        // topologies the coordnates may exceed the bounding box
+        // (especially negative coordnates may occurr).
+        Coord<DIM> coord = TOPOLOGY::normalize(streak.origin, dimensions);
+        MPI_File_seek(file, headerLength + coord.toIndex(dimensions) * cellLength, MPI_SEEK_SET);
+        MPI_File_read(file, cells, streak.length(), mpiDatatype, MPI_STATUS_IGNORE);
+    }
+
+private:
+    MPI_File file;
+    MPI_Offset headerLength;
+    MPI_Aint cellLength;
+    Coord<DIM> dimensions;
+    MPI_Datatype mpiDatatype;
+};
+
+/**
+ * Writes each visited Streak to the file, without an intermediate
+ * copy for grids which grant direct access to their cells.
+ */
+template<typename CELL_TYPE, typename TOPOLOGY, int DIM>
+class StreakWriter : public ConstGridVisitor<CELL_TYPE, DIM>
+{
+public:
+    StreakWriter(
+        MPI_File file,
+        const MPI_Offset& headerLength,
+        const MPI_Aint& cellLength,
+        const Coord<DIM>& dimensions,
+        const MPI_Datatype& mpiDatatype) :
+        file(file),
+        headerLength(headerLength),
+        cellLength(cellLength),
+        dimensions(dimensions),
+        mpiDatatype(mpiDatatype)
+    {}
+
+    virtual void visit(const Streak<DIM>& streak, const CELL_TYPE *cells)
+    {
+        Coord<DIM> coord = TOPOLOGY::normalize(streak.origin, dimensions);
+        MPI_File_seek(file, headerLength + coord.toIndex(dimensions) * cellLength, MPI_SEEK_SET);
+        MPI_File_write(file, const_cast<CELL_TYPE*>(cells), streak.length(), mpiDatatype, MPI_STATUS_IGNORE);
+    }
+
+private:
+    MPI_File file;
+    MPI_Offset headerLength;
+    MPI_Aint cellLength;
+    Coord<DIM> dimensions;
+    MPI_Datatype mpiDatatype;
+};
+
+}
+
 /**
  * Utility class which bundles common MPI-based input/output code.
  */
@@ -42,23 +120,9 @@ public:
         MPI_File_read(file, &cell, 1, mpiDatatype, MPI_STATUS_IGNORE);
         grid->setEdge(cell);
 
-        for (typename Region<DIM>::StreakIterator i = region.beginStreak();
-             i != region.endStreak();
-             ++i) {
-            // the coords need to be normalized because on torus
-            // topologies the coordnates may exceed the bounding box
-            // (especially negative coordnates may occurr).
-            Coord<DIM> coord = TOPOLOGY::normalize(i->origin, dimensions);
-            MPI_File_seek(
-                file,
-                offset(headerLength, coord, dimensions, cellLength),
-                MPI_SEEK_SET);
-            int length = i->endX - i->origin.x();
-            std::vector<CELL_TYPE> vec(length);
-
-            MPI_File_read(file, &vec[0], length, mpiDatatype, MPI_STATUS_IGNORE);
-            grid->set(*i, &vec[0]);
-        }
+        MPIIOHelpers::StreakReader<CELL_TYPE, TOPOLOGY, DIM> reader(
+            file, headerLength, cellLength, dimensions, mpiDatatype);
+        grid->visit(region, &reader);
 
         MPI_File_close(&file);
     }
@@ -111,24 +175,9 @@ public:
                            1, mpiDatatype,  MPI_STATUS_IGNORE);
         }
 
-        for (typename Region<DIM>::StreakIterator i = region.beginStreak();
-             i != region.endStreak();
-             ++i) {
-            // the coords need to be normalized because on torus
-            // topologies the coordnates may exceed the bounding box
-            // (especially negative coordnates may occurr).
-            Coord<DIM> coord = TOPOLOGY::normalize(i->origin, dimensions);
-            MPI_File_seek(
-                file,
-                offset(headerLength, coord, dimensions, cellLength),
-                MPI_SEEK_SET);
-
-            int length = i->endX - i->origin.x();
-            std::vector<CELL_TYPE> vec(length);
-            grid.get(*i, &vec[0]);
-
-            MPI_File_write(file, &vec[0], length, mpiDatatype, MPI_STATUS_IGNORE);
-        }
+        MPIIOHelpers::StreakWriter<CELL_TYPE, TOPOLOGY, DIM> writer(
+            file, headerLength, cellLength, dimensions, mpiDatatype);
+        grid.visit(region, &writer);
 
         MPI_File_close(&file);
     }
@@ -172,16 +221,6 @@ private:
     // fixme: use MPILayer for MPI-IO
     MPILayer mpiLayer;
 
-    template<int DIM>
-    MPI_Offset offset(
-        const MPI_Offset& headerLength,
-        const Coord<DIM>& c,
-        const Coord<DIM>& dimensions,
-        const MPI_Aint& cellLength)
-    {
-        return headerLength + c.toIndex(dimensions) * cellLength;
-    }
-
     template<int DIM>
     void getLengths(
         MPI_Aint *headerLength,
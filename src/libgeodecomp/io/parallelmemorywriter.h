@@ -50,12 +50,8 @@ public:
             grids[step].resize(CoordBox<DIM>(Coord<DIM>(), globalDimensions));
         }
 
-        std::vector<CELL_TYPE> buf;
-        for (typename Region<DIM>::StreakIterator i = validRegion.beginStreak(); i != validRegion.endStreak(); ++i) {
-            buf.resize(i->length());
-            grid.get(*i, buf.data());
-            grids[step].set(*i, buf.data());
-        }
+        CopyingGridVisitor<CELL_TYPE, DIM, GridType> copier(&grids[step]);
+        grid.visit(validRegion, &copier);
         grids[step].setEdge(grid.getEdge());
 
         for (int sender = 0; sender < mpiLayer.size(); ++sender) {
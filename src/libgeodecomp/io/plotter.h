@@ -58,25 +58,22 @@ public:
         PAINTER& painter,
         const CoordBox<2>& viewport) const
     {
-        int sx = viewport.origin.x() / cellDim.x();
-        int sy = viewport.origin.y() / cellDim.y();
+        int sx = (std::max)(0, viewport.origin.x() / cellDim.x());
+        int sy = (std::max)(0, viewport.origin.y() / cellDim.y());
         int ex = int(ceil((double(viewport.origin.x()) + viewport.dimensions.x()) / cellDim.x()));
         int ey = int(ceil((double(viewport.origin.y()) + viewport.dimensions.y()) / cellDim.y()));
         ex = (std::min)(ex, grid.dimensions().x());
         ey = (std::min)(ey, grid.dimensions().y());
 
-        for (int y = sy; y < ey; ++y) {
-            for (int x = sx; x < ex; ++x) {
-                Coord<2> relativeUpperLeft =
-                    Coord<2>(x * cellDim.x(),
-                             y * cellDim.y()) - viewport.origin;
-                painter.moveTo(relativeUpperLeft);
-                cellPlotter(
-                    grid.get(Coord<2>(x, y)),
-                    painter,
-                    cellDim);
+        Region<2> region;
+        if (sx < ex) {
+            for (int y = sy; y < ey; ++y) {
+                region << Streak<2>(Coord<2>(sx, y), ex);
             }
         }
+
+        PlotVisitor<PAINTER> visitor(cellPlotter, painter, cellDim, viewport.origin);
+        grid.visit(region, &visitor);
     }
 
     const Coord<2>& getCellDim()
@@ -90,6 +87,40 @@ public:
     }
 
 private:
+    /**
+     * Hands the cells to the CELL_PLOTTER, streak by streak.
+     */
+    template<typename PAINTER>
+    class PlotVisitor : public ConstGridVisitor<CELL, 2>
+    {
+    public:
+        PlotVisitor(
+            const CELL_PLOTTER& cellPlotter,
+            PAINTER& painter,
+            const Coord<2>& cellDim,
+            const Coord<2>& viewportOrigin) :
+            cellPlotter(cellPlotter),
+            painter(painter),
+            cellDim(cellDim),
+            viewportOrigin(viewportOrigin)
+        {}
+
+        virtual void visit(const Streak<2>& streak, const CELL *cells)
+        {
+            for (Coord<2> c = streak.origin; c.x() < streak.endX; ++c.x()) {
+                painter.moveTo(cellDim.scale(c) - viewportOrigin);
+                cellPlotter(*cells, painter, cellDim);
+                ++cells;
+            }
+        }
+
+    private:
+        const CELL_PLOTTER& cellPlotter;
+        PAINTER& painter;
+        Coord<2> cellDim;
+        Coord<2> viewportOrigin;
+    };
+
     Coord<2> cellDim;
     CELL_PLOTTER cellPlotter;
 };
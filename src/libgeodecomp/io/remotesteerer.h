@@ -2,7 +2,7 @@
 #define LIBGEODECOMP_IO_REMOTESTEERER_H
 
 #include <libgeodecomp/config.h>
-#ifdef LIBGEODECOMP_WITH_BOOST_ASIO
+#ifdef LIBGEODECOMP_WITH_REMOTE_STEERER
 #ifdef LIBGEODECOMP_WITH_THREADS
 #ifdef LIBGEODECOMP_WITH_MPI
 
@@ -34,7 +34,10 @@ using namespace RemoteSteererHelpers;
  *   via a asynchronous message buffer.
  *
  * Keep in mind that the connection node will generally double as an
- * execution node.
+ * execution node. Only the connection node does any networking, and
+ * it does so in a separate thread, so the simulation is never held
+ * up by clients. All nodes exchange requests and feedback in batches
+ * every period time steps.
  */
 template<typename CELL_TYPE>
 class RemoteSteerer : public Steerer<CELL_TYPE>
@@ -99,9 +102,17 @@ public:
         pipe->sync();
     }
 
+    /**
+     * Actions only live on the connection node, elsewhere they'll
+     * simply be discarded.
+     */
     void addAction(Action<CELL_TYPE> *action)
     {
-        commandServer->addAction(action);
+        if (commandServer) {
+            commandServer->addAction(action);
+        } else {
+            delete action;
+        }
     }
 
     void addHandler(Handler<CELL_TYPE> *handler)
@@ -2,6 +2,8 @@
 #define LIBGEODECOMP_IO_REMOTESTEERER_COMMANDSERVER_H
 
 #include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_REMOTE_STEERER
+
 #include <libgeodecomp/io/logger.h>
 #include <libgeodecomp/io/remotesteerer/action.h>
 #include <libgeodecomp/io/remotesteerer/getaction.h>
@@ -9,11 +11,22 @@
 #include <libgeodecomp/io/remotesteerer/waitaction.h>
 #include <libgeodecomp/misc/stringops.h>
 
+#include <atomic>
 #include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <stdexcept>
 #include <map>
+#include <mutex>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 namespace LibGeoDecomp {
 
@@ -25,6 +38,16 @@ namespace RemoteSteererHelpers {
  * Action objects can be bound to certain commands and will be
  * invoked. This allows a flexible extension of the CommandServer's
  * functionality by composition, without having to resort to inheritance.
+ *
+ * All networking is done by a dedicated thread which runs a poll()
+ * loop over non-blocking sockets, so any number of clients may be
+ * connected and none of them can stall the others or the Simulator.
+ * The thread is woken up via a self-pipe when feedback arrives in the
+ * Pipe. Feedback is sent to the client which issued the most recent
+ * command. As long as no client is connected, it remains in the Pipe.
+ *
+ * By default the server only listens on the loopback interface, use
+ * e.g. an SSH tunnel to steer from a remote machine.
  */
 template<typename CELL_TYPE>
 class CommandServer
@@ -33,9 +56,8 @@ public:
     typedef std::map<std::string, typename SharedPtr<Action<CELL_TYPE> >::Type > ActionMap;
 
     /**
-     * This helper class lets us and the user safely close the
-     * CommandServer's network service, which is nice as it is using
-     * blocking IO and it's a major PITA to cancel that.
+     * This helper class lets the user close the CommandServer's
+     * network service.
      */
     // fixme: move to dedicated file
     class QuitAction : public Action<CELL_TYPE>
@@ -58,9 +80,7 @@ public:
 
     /**
      * This class is just a NOP, which may be used by the client to
-     * retrieve new steering feedback. This can't happen automatically
-     * as the CommandServer's listener thread blocks for input from
-     * the client.
+     * check whether the CommandServer is still alive.
      */
     // fixme: move to dedicated file
     class PingAction : public Action<CELL_TYPE>
@@ -69,74 +89,73 @@ public:
         using Action<CELL_TYPE>::key;
 
         PingAction() :
-            Action<CELL_TYPE>("ping", "wake the CommandServer, useful to retrieve a new batch of feedback"),
+            Action<CELL_TYPE>("ping", "replies with \"pong N\", useful to check whether the CommandServer is alive"),
             c(0)
         {}
 
         void operator()(const StringVec& parameters, Pipe& pipe)
         {
-            // // Do only reply if there is no feedback already waiting.
-            // // This is useful if the client is using ping to keep us
-            // // alive, but can only savely read back one line in
-            // // return. In that case this stragety avoids a memory leak
-            // // in our write buffer.
-            // if (pipe.copySteeringFeedback().size() == 0) {
-                pipe.addSteeringFeedback("pong " + StringOps::itoa(++c));
-            // }
+            pipe.addSteeringFeedback("pong " + StringOps::itoa(++c));
         }
 
     private:
         int c;
     };
 
+    /**
+     * The socket is bound before the constructor returns, so clients
+     * may connect right away. Throws if that fails (e.g. because the
+     * port is already taken).
+     */
     CommandServer(
         int port,
-        SharedPtr<Pipe>::Type pipe) :
+        SharedPtr<Pipe>::Type pipe,
+        const std::string& bindAddress = "127.0.0.1") :
         port(port),
-        pipe(pipe)
-        // serverThread(&CommandServer::runServer, this)
+        pipe(pipe),
+        listenFD(-1),
+        activeSessionFD(-1),
+        linesToWaitFor(0),
+        continueFlag(true),
+        shutdownRequested(false)
     {
         addAction(new QuitAction(&continueFlag));
         addAction(new PingAction);
-        addAction(new WaitAction<CELL_TYPE>);
+        addAction(new WaitAction<CELL_TYPE>(&linesToWaitFor));
 
-        // The thread may take a while to start up. We need to wait
-        // here so we don't try to clean up in the d-tor before the
-        // thread has created anything.
+        listenFD = openListener(port, bindAddress);
 
-        // fixme
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // while(!acceptor) {
-        //     threadCreationVar.wait(lock);
-        // }
+        if (::pipe(wakeupFDs) != 0) {
+            close(listenFD);
+            throw std::runtime_error("CommandServer could not create wakeup pipe");
+        }
+        setNonBlocking(wakeupFDs[0]);
+        setNonBlocking(wakeupFDs[1]);
+        this->pipe->setNotificationFD(wakeupFDs[1]);
+
+        serverThread = std::thread(&CommandServer::runServer, this);
     }
 
     ~CommandServer()
     {
-        // fixme
-        // signalClose();
-        // LOG(DBG, "CommandServer waiting for network thread");
-        // serverThread.join();
+        signalClose();
+        LOG(DBG, "CommandServer waiting for network thread");
+        serverThread.join();
+
+        pipe->setNotificationFD(-1);
+        close(wakeupFDs[0]);
+        close(wakeupFDs[1]);
+        close(listenFD);
     }
 
     /**
      * Sends a message back to the end user. This is the primary way
-     * for (user-defined) Actions to give feedback.
+     * for (user-defined) Actions to give feedback. Thread-safe.
      */
     void sendMessage(const std::string& message)
     {
         LOG(DBG, "CommandServer::sendMessage(" << message << ")");
-        // fixme
-        // boost::system::error_code errorCode;
-        // boost::asio::write(
-        //     *socket,
-        //     boost::asio::buffer(message),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // if (errorCode) {
-        //     LOG(WARN, "CommandServer::sendMessage encountered " << errorCode.message());
-        // }
+        pipe->addSteeringFeedback(message);
     }
 
     /**
@@ -154,113 +173,328 @@ public:
         Interactor interactor(command, feedbackLines, false, port, host);
         interactor();
         return interactor.feedback();
-        // fixme
-        // boost::asio::io_service ioService;
-        // tcp::resolver resolver(ioService);
-        // tcp::resolver::query query(host, StringOps::itoa(port));
-        // tcp::resolver::iterator endpointIterator = resolver.resolve(query);
-        // tcp::socket socket(ioService);
-        // boost::asio::connect(socket, endpointIterator);
-        // boost::system::error_code errorCode;
-
-        // boost::asio::write(
-        //     socket,
-        //     boost::asio::buffer(command),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // if (errorCode) {
-        //     LOG(WARN, "error while writing to socket: " << errorCode.message());
-        // }
-
-        StringVec ret;
-
-        for (int i = 0; i < feedbackLines; ++i) {
-            // fixme
-            // boost::asio::streambuf buf;
-            // boost::system::error_code errorCode;
-
-            LOG(DBG, "CommandServer::sendCommandWithFeedback() reading line");
-
-            // fixme
-            // std::size_t length = boost::asio::read_until(socket, buf, '\n', errorCode);
-            // if (errorCode) {
-            //     LOG(WARN, "error while writing to socket: " << errorCode.message());
-            // }
-
-            // // purge \n at end of line
-            // if (length) {
-            //     length -= 1;
-            // }
-
-            // std::istream lineBuf(&buf);
-            // std::string line(length, 'X');
-            // lineBuf.read(&line[0], length);
-            // ret << line;
-        }
-
-        return ret;
     }
 
     /**
      * Register a server-side callback for handling user input. The
      * CommandServer will assume ownership of the action and free its
-     * memory upon destruction.
+     * memory upon destruction. Thread-safe.
      */
     void addAction(Action<CELL_TYPE> *action)
     {
+        std::lock_guard<std::mutex> lock(actionsMutex);
         actions[action->key()] = typename SharedPtr<Action<CELL_TYPE> >::Type(action);
     }
 
 private:
+    /**
+     * Connection state of a single client. Input is buffered until
+     * complete lines are available, output until the socket becomes
+     * writable.
+     */
+    class Session
+    {
+    public:
+        explicit Session(int fd = -1) :
+            fd(fd),
+            linesToWaitFor(0),
+            deliveredLines(0),
+            endOfInput(false),
+            failed(false)
+        {}
+
+        bool finished() const
+        {
+            return failed || (endOfInput && input.empty() && output.empty() && (linesToWaitFor == 0));
+        }
+
+        int fd;
+        std::string input;
+        std::string output;
+        std::size_t linesToWaitFor;
+        std::size_t deliveredLines;
+        bool endOfInput;
+        bool failed;
+    };
+
+    typedef std::map<int, Session> SessionMap;
+
     int port;
     SharedPtr<Pipe>::Type pipe;
-    // fixme
-    // boost::asio::io_service ioService;
-    // SharedPtr<tcp::acceptor>::Type acceptor;
-    // SharedPtr<tcp::socket>::Type socket;
-    // boost::thread serverThread;
-    // boost::condition_variable threadCreationVar;
-    // boost::mutex mutex;
+    int listenFD;
+    int wakeupFDs[2];
+    int activeSessionFD;
+    std::size_t linesToWaitFor;
+    SessionMap sessions;
+    std::thread serverThread;
+    std::mutex actionsMutex;
     ActionMap actions;
     bool continueFlag;
+    std::atomic<bool> shutdownRequested;
+
+    static void setNonBlocking(int fd)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    static int openListener(int port, const std::string& bindAddress)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd == -1) {
+            throw std::runtime_error("CommandServer could not create socket: " + std::string(std::strerror(errno)));
+        }
+
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (inet_pton(AF_INET, bindAddress.c_str(), &address.sin_addr) != 1) {
+            close(fd);
+            throw std::invalid_argument("CommandServer can't parse bind address " + bindAddress);
+        }
+
+        if ((bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) ||
+            (listen(fd, SOMAXCONN) != 0)) {
+            std::string message = std::strerror(errno);
+            close(fd);
+            throw std::runtime_error(
+                "CommandServer could not listen on port " + StringOps::itoa(port) + ": " + message);
+        }
+
+        setNonBlocking(fd);
+        return fd;
+    }
+
+    void runServer()
+    {
+        while (continueFlag && !shutdownRequested) {
+            std::vector<pollfd> fds(2);
+            fds[0].fd = wakeupFDs[0];
+            fds[0].events = POLLIN;
+            fds[1].fd = listenFD;
+            fds[1].events = POLLIN;
+
+            for (typename SessionMap::iterator i = sessions.begin(); i != sessions.end(); ++i) {
+                pollfd entry;
+                entry.fd = i->first;
+                entry.events = 0;
+                if (!i->second.endOfInput) {
+                    entry.events |= POLLIN;
+                }
+                if (!i->second.output.empty()) {
+                    entry.events |= POLLOUT;
+                }
+                fds.push_back(entry);
+            }
+
+            for (std::size_t i = 0; i < fds.size(); ++i) {
+                fds[i].revents = 0;
+            }
+
+            if (poll(&fds[0], fds.size(), -1) == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                LOG(FATAL, "CommandServer::runServer() listening on port " << port
+                    << " failed to poll: " << std::strerror(errno) << ", exiting");
+                break;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                drainWakeupPipe();
+            }
+            if (fds[1].revents & POLLIN) {
+                acceptClients();
+            }
+            for (std::size_t i = 2; i < fds.size(); ++i) {
+                Session *session = &sessions[fds[i].fd];
+                if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                    continue;
+                }
+
+                if (session->endOfInput) {
+                    // client is gone for good, no use in waiting for feedback:
+                    session->failed = true;
+                } else {
+                    readFrom(session);
+                }
+            }
+
+            handleSessions();
+        }
+
+        for (typename SessionMap::iterator i = sessions.begin(); i != sessions.end(); ++i) {
+            close(i->first);
+        }
+        sessions.clear();
+        LOG(INFO, "CommandServer on port " << port << " shut down");
+    }
+
+    void drainWakeupPipe()
+    {
+        char buf[256];
+        while (read(wakeupFDs[0], buf, sizeof(buf)) > 0) {}
+    }
+
+    void acceptClients()
+    {
+        for (;;) {
+            int fd = accept(listenFD, 0, 0);
+            if (fd == -1) {
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+                    LOG(WARN, "CommandServer::acceptClients() encountered " << std::strerror(errno));
+                }
+                return;
+            }
+
+            LOG(INFO, "CommandServer: client connected");
+            setNonBlocking(fd);
+            sessions[fd] = Session(fd);
+        }
+    }
 
-    void runSession()
+    void readFrom(Session *session)
     {
-        // fixme
-        // for (;;) {
-        //     boost::array<char, 1024> buf;
-        //     boost::system::error_code errorCode;
-        //     LOG(DBG, "CommandServer::runSession(): reading");
-        //     std::size_t length = socket->read_some(boost::asio::buffer(buf), errorCode);
-        //     LOG(DBG, "CommandServer::runSession(): read " << length << " bytes");
-
-        //     if (length > 0) {
-        //         std::string input(buf.data(), length);
-        //         handleInput(input);
-        //     }
-
-        //     if (errorCode == boost::asio::error::eof) {
-        //         LOG(INFO, "CommandServer::runSession(): client closed connection");
-        //         return;
-        //     }
-
-        //     if (errorCode) {
-        //         LOG(WARN, "CommandServer::runSession encountered " << errorCode.message());
-        //     }
-
-        //     if (!socket->is_open()) {
-        //         return;
-        //     }
-
-        //     StringVec feedback = pipe->retrieveSteeringFeedback();
-        //     for (StringVec::iterator i = feedback.begin();
-        //          i != feedback.end();
-        //          ++i) {
-        //         LOG(DBG, "CommandServer::runSession sending »" << *i << "«");
-        //         sendMessage(*i + "\n");
-        //     }
-        // }
+        for (;;) {
+            char buf[1024];
+            ssize_t length = recv(session->fd, buf, sizeof(buf), 0);
+            LOG(DBG, "CommandServer::readFrom(): read " << length << " bytes");
+
+            if (length > 0) {
+                session->input.append(buf, length);
+                continue;
+            }
+            if (length == 0) {
+                LOG(INFO, "CommandServer: client closed connection");
+                session->endOfInput = true;
+                return;
+            }
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+
+            LOG(WARN, "CommandServer::readFrom() encountered " << std::strerror(errno));
+            session->failed = true;
+            return;
+        }
+    }
+
+    /**
+     * Executes all commands which are not deferred by a pending
+     * "wait", forwards feedback and then drops all sessions which are
+     * done.
+     */
+    void handleSessions()
+    {
+        do {
+            for (typename SessionMap::iterator i = sessions.begin(); i != sessions.end(); ++i) {
+                processInput(&i->second);
+            }
+        } while (deliverFeedback());
+
+        for (typename SessionMap::iterator i = sessions.begin(); i != sessions.end();) {
+            writeTo(&i->second);
+
+            if (i->second.finished()) {
+                LOG(INFO, "CommandServer: client disconnected");
+                close(i->first);
+                if (activeSessionFD == i->first) {
+                    activeSessionFD = -1;
+                }
+                sessions.erase(i++);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    void processInput(Session *session)
+    {
+        while (!session->failed && (session->linesToWaitFor == 0)) {
+            std::string line;
+            std::size_t newline = session->input.find('\n');
+
+            if (newline != std::string::npos) {
+                line = session->input.substr(0, newline);
+                session->input.erase(0, newline + 1);
+            } else {
+                // a client may send its last command without newline:
+                if (!session->endOfInput || session->input.empty()) {
+                    return;
+                }
+                std::swap(line, session->input);
+            }
+
+            activeSessionFD = session->fd;
+            linesToWaitFor = 0;
+            handleInput(line);
+
+            if (linesToWaitFor > 0) {
+                if (session->deliveredLines >= linesToWaitFor) {
+                    session->deliveredLines = 0;
+                } else {
+                    session->linesToWaitFor = linesToWaitFor;
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns true if this ended the wait of the receiving session.
+     */
+    bool deliverFeedback()
+    {
+        if (activeSessionFD == -1) {
+            return false;
+        }
+
+        Session& session = sessions[activeSessionFD];
+        StringVec feedback = pipe->retrieveSteeringFeedback();
+        for (StringVec::iterator i = feedback.begin(); i != feedback.end(); ++i) {
+            LOG(DBG, "CommandServer::deliverFeedback() sending »" << *i << "«");
+            session.output += *i + "\n";
+        }
+
+        session.deliveredLines += feedback.size();
+        if ((session.linesToWaitFor > 0) && (session.deliveredLines >= session.linesToWaitFor)) {
+            session.linesToWaitFor = 0;
+            session.deliveredLines = 0;
+            return true;
+        }
+
+        return false;
+    }
+
+    void writeTo(Session *session)
+    {
+        int flags = 0;
+#ifdef MSG_NOSIGNAL
+        flags = MSG_NOSIGNAL;
+#endif
+
+        while (!session->failed && !session->output.empty()) {
+            ssize_t length = send(session->fd, session->output.data(), session->output.size(), flags);
+            if (length > 0) {
+                session->output.erase(0, length);
+                continue;
+            }
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+
+            LOG(WARN, "CommandServer::writeTo() encountered " << std::strerror(errno));
+            session->failed = true;
+        }
     }
 
     void handleInput(const std::string& input)
@@ -286,63 +520,39 @@ private:
             }
 
             std::string command = pop_front(parameters);
-            if (actions.count(command) == 0) {
+            typename SharedPtr<Action<CELL_TYPE> >::Type action;
+            {
+                std::lock_guard<std::mutex> lock(actionsMutex);
+                typename ActionMap::iterator i = actions.find(command);
+                if (i != actions.end()) {
+                    action = i->second;
+                }
+            }
+
+            if (!action) {
                 std::string message = "command not found: " + command;
                 LOG(WARN, message);
                 pipe->addSteeringFeedback(message);
                 pipe->addSteeringFeedback("try \"help\"");
             } else {
-                (*actions[command])(parameters, *pipe);
+                (*action)(parameters, *pipe);
             }
         }
     }
 
-    int runServer()
-    {
-        // fixme
-        // try {
-        //     // Thread-aware initialization, allows c-tor to exit safely.
-        //     {
-        //         boost::unique_lock<boost::mutex> lock(mutex);
-        //         acceptor.reset(new tcp::acceptor(ioService, tcp::endpoint(tcp::v4(), port)));
-        //     }
-        //     threadCreationVar.notify_one();
-
-        //     boost::system::error_code errorCode;
-        //     continueFlag = true;
-
-        //     while (continueFlag) {
-        //         LOG(DBG, "CommandServer: waiting for new connection");
-        //         socket.reset(new tcp::socket(ioService));
-        //         acceptor->accept(*socket, errorCode);
-
-        //         if (errorCode) {
-        //             LOG(WARN, "CommandServer::runServer() encountered " << errorCode.message());
-        //         } else {
-        //             LOG(INFO, "CommandServer: client connected");
-        //             runSession();
-        //             LOG(INFO, "CommandServer: client disconnected");
-        //         }
-        //     }
-        // }
-        // catch (std::exception& e) {
-        //     LOG(FATAL, "CommandServer::runServer() listening on port " << port
-        //         << " caught exception " << e.what() << ", exiting");
-        //     return 1;
-        // }
-
-        return 0;
-    }
-
     void signalClose()
     {
-        sendCommand("quit", port);
+        shutdownRequested = true;
+        char c = 0;
+        // a full pipe implies that the thread will wake up anyway:
+        while ((write(wakeupFDs[1], &c, 1) == -1) && (errno == EINTR)) {}
     }
 };
 
-
 }
 
 }
 
 #endif
+
+#endif
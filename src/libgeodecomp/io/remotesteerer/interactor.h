@@ -1,10 +1,24 @@
 #ifndef LIBGEODECOMP_IO_REMOTESTEERER_INTERACTOR_H
 #define LIBGEODECOMP_IO_REMOTESTEERER_INTERACTOR_H
 
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_REMOTE_STEERER
+
 #include <libgeodecomp/io/logger.h>
 #include <libgeodecomp/misc/stringops.h>
 #include <libgeodecomp/misc/stringvec.h>
 
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
 namespace LibGeoDecomp {
 
 namespace RemoteSteererHelpers {
@@ -14,6 +28,10 @@ namespace RemoteSteererHelpers {
  * communication with a RemoteSteerer's CommandServer. This is useful
  * for instance for writing unit tests where manually creating sockets
  * and syncing a thread is tedious.
+ *
+ * The Interactor sends its command, followed by a "wait" for the
+ * expected number of feedback lines, and then reads until it has
+ * received these.
  */
 class Interactor
 {
@@ -37,132 +55,200 @@ public:
         // are set in advance. But this is crucial as otherwise the
         // results of the thread might be overwritten.
         if (threaded) {
-            // fixme
-            // thread = boost::thread(ThreadWrapper<Interactor>(this));
+            thread = std::thread(ThreadWrapper<Interactor>(this));
             waitForStartup();
         }
     }
 
     ~Interactor()
     {
-        // fixme
-        // if (thread.joinable()) {
-        //     thread.join();
-        // }
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
 
     void waitForCompletion()
     {
-        // fixme
-
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // while(!completed) {
-        //     signal.wait(lock);
-        // }
+        std::unique_lock<std::mutex> lock(mutex);
+        while(!completed) {
+            signal.wait(lock);
+        }
     }
 
     StringVec feedback()
     {
+        std::lock_guard<std::mutex> lock(mutex);
         return feedbackBuffer;
     }
 
     int operator()()
     {
         LOG(DBG, "Interactor::operator(" << command << ")");
-        // fixme
-        // boost::asio::io_service ioService;
-        // tcp::resolver resolver(ioService);
-        // tcp::resolver::query query(host, StringOps::itoa(port));
-        // tcp::resolver::iterator endpointIterator = resolver.resolve(query);
-        // tcp::socket socket(ioService);
-        // boost::asio::connect(socket, endpointIterator);
-        // boost::system::error_code errorCode;
-
-        // std::string commandSuffix = "\nwait " + StringOps::itoa(feedbackLines) + "\n";
-        // boost::asio::write(
-        //     socket,
-        //     boost::asio::buffer(command + commandSuffix),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // if (errorCode) {
-        //     LOG(Logger::WARN, "error while writing to socket: " << errorCode.message());
-        // }
-
-        // notifyStartup();
-
-        // for (;;) {
-        //     LOG(DBG, "Interactor::operator() reading... [" << feedbackBuffer.size() << "/" << feedbackLines << "]");
-        //     if (feedbackBuffer.size() >= feedbackLines) {
-        //         break;
-        //     }
-
-        //     boost::array<char, 1024> buf;
-        //     boost::system::error_code errorCode;
-        //     std::size_t length = socket.read_some(boost::asio::buffer(buf), errorCode);
-        //     std::string input(buf.data(), length);
-        //     StringVec lines = StringOps::tokenize(input, "\n");
-        //     handleInput(lines);
-        // }
-
-        // notifyCompletion();
-
-        // LOG(DBG, "Interactor::operator() done");
+        int socketFD = connectToServer();
+        if (socketFD == -1) {
+            notifyStartup();
+            notifyCompletion();
+            return 1;
+        }
+
+        std::string commandSuffix = "\nwait " + StringOps::itoa(feedbackLines) + "\n";
+        if (!writeAll(socketFD, command + commandSuffix)) {
+            LOG(Logger::WARN, "error while writing to socket: " << std::strerror(errno));
+        }
+
+        notifyStartup();
+
+        std::string incompleteLine;
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                LOG(DBG, "Interactor::operator() reading... [" << feedbackBuffer.size() << "/" << feedbackLines << "]");
+                if (feedbackBuffer.size() >= feedbackLines) {
+                    break;
+                }
+            }
+
+            char buf[1024];
+            ssize_t length = recv(socketFD, buf, sizeof(buf), 0);
+            if (length <= 0) {
+                if ((length == -1) && (errno == EINTR)) {
+                    continue;
+                }
+
+                LOG(Logger::WARN, "Interactor: connection closed before all feedback was received");
+                break;
+            }
+
+            // lines may be split across reads:
+            std::string input = incompleteLine + std::string(buf, length);
+            std::size_t lastNewline = input.rfind('\n');
+            if (lastNewline == std::string::npos) {
+                incompleteLine = input;
+                continue;
+            }
+            incompleteLine = input.substr(lastNewline + 1);
+            handleInput(StringOps::tokenize(input.substr(0, lastNewline), "\n"));
+        }
+
+        close(socketFD);
+        notifyCompletion();
+
+        LOG(DBG, "Interactor::operator() done");
         return 0;
     }
 
 private:
     StringVec feedbackBuffer;
-    // boost::condition_variable signal;
-    // boost::mutex mutex;
+    std::condition_variable signal;
+    std::mutex mutex;
     std::string command;
     std::size_t feedbackLines;
     int port;
     std::string host;
     bool started;
     bool completed;
-    // boost::thread thread;
+    std::thread thread;
+
+    int connectToServer()
+    {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *addresses = 0;
+        int res = getaddrinfo(host.c_str(), StringOps::itoa(port).c_str(), &hints, &addresses);
+        if (res != 0) {
+            LOG(Logger::WARN, "Interactor could not resolve " << host << ": " << gai_strerror(res));
+            return -1;
+        }
+
+        int socketFD = -1;
+        for (addrinfo *i = addresses; i != 0; i = i->ai_next) {
+            socketFD = socket(i->ai_family, i->ai_socktype, i->ai_protocol);
+            if (socketFD == -1) {
+                continue;
+            }
+            if (connect(socketFD, i->ai_addr, i->ai_addrlen) == 0) {
+                break;
+            }
+
+            close(socketFD);
+            socketFD = -1;
+        }
+        freeaddrinfo(addresses);
+
+        if (socketFD == -1) {
+            LOG(Logger::WARN, "Interactor could not connect to " << host << ":" << port);
+        }
+
+        return socketFD;
+    }
+
+    static bool writeAll(int socketFD, const std::string& message)
+    {
+        std::size_t cursor = 0;
+        while (cursor < message.size()) {
+            ssize_t length = send(socketFD, message.data() + cursor, message.size() - cursor, 0);
+            if (length == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+
+            cursor += length;
+        }
+
+        return true;
+    }
 
     void waitForStartup()
     {
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // while(!started) {
-        //     signal.wait(lock);
-        // }
+        std::unique_lock<std::mutex> lock(mutex);
+        while(!started) {
+            signal.wait(lock);
+        }
     }
 
     void notifyStartup()
     {
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // started = true;
-        // signal.notify_one();
+        std::lock_guard<std::mutex> lock(mutex);
+        started = true;
+        signal.notify_all();
     }
 
     void notifyCompletion()
     {
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // completed = true;
-        // signal.notify_one();
+        std::lock_guard<std::mutex> lock(mutex);
+        completed = true;
+        signal.notify_all();
     }
 
     void handleInput(const StringVec& lines)
     {
         LOG(DBG, "Interactor::handleInput(" << lines << ")");
-        // // only add lines which are not equal to "\0"
-        // for (std::size_t i = 0; i < lines.size(); ++i) {
-        //     const std::string& line = lines[i];
-        //     if (line == "") {
-        //         LOG(WARN, "Interactor rejects empty line as feedback");
-        //         continue;
-        //     }
-        //     if ((line.size() == 1) || (line[0] == 0)) {
-        //         LOG(WARN, "Interactor rejects null line as feedback");
-        //         continue;
-        //     }
-
-        //     LOG(DBG, "Interactor accepted line »" << line << "«");
-        //     feedbackBuffer << line;
-        // }
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // only add lines which are not equal to "\0"
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            std::string line = lines[i];
+            if (!line.empty() && (line[line.size() - 1] == '\r')) {
+                line.resize(line.size() - 1);
+            }
+
+            if (line == "") {
+                LOG(WARN, "Interactor rejects empty line as feedback");
+                continue;
+            }
+            if ((line.size() == 1) && (line[0] == 0)) {
+                LOG(WARN, "Interactor rejects null line as feedback");
+                continue;
+            }
+
+            LOG(DBG, "Interactor accepted line »" << line << "«");
+            feedbackBuffer << line;
+        }
     }
 
     template<typename DELEGATE>
@@ -188,3 +274,5 @@ private:
 }
 
 #endif
+
+#endif
@@ -4,11 +4,12 @@
 #include <libgeodecomp/config.h>
 #include <libgeodecomp/communication/mpilayer.h>
 #include <libgeodecomp/io/logger.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
 #include <libgeodecomp/misc/stringops.h>
 
-// #include <boost/thread/condition_variable.hpp>
-// #include <boost/thread/mutex.hpp>
-// #include <boost/thread/locks.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <unistd.h>
 
 namespace LibGeoDecomp {
 
@@ -22,6 +23,10 @@ namespace RemoteSteererHelpers {
  * in turn is triggered by the Simulator. The Pipe also manages
  * scattering/gathering of the data via MPI, which is essentially a
  * 1-n operation. The external interface is thread-safe.
+ *
+ * The mutex is only held while strings are being moved in or out of
+ * the queues, never during MPI calls or network IO, so neither the
+ * Simulator nor the CommandServer may stall the other.
  */
 class Pipe
 {
@@ -31,194 +36,249 @@ public:
 #ifdef LIBGEODECOMP_WITH_MPI
     explicit Pipe(
         int root = 0,
-        MPI_Comm communicator = MPI_COMM_WORLD)
-        // mpiLayer(communicator),
-        // root(root)
+        MPI_Comm communicator = MPI_COMM_WORLD) :
+        mpiLayer(communicator),
+        root(root),
+        notificationFD(-1)
+    {}
+#else
+    Pipe() :
+        notificationFD(-1)
     {}
 #endif
 
     void addSteeringRequest(const std::string& request)
     {
-        // fixme
-        // LOG(DBG, "Pipe::addSteeringRequest(" << request << ")");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // steeringRequestsQueue << request;
+        LOG(DBG, "Pipe::addSteeringRequest(" << request << ")");
+        std::lock_guard<std::mutex> lock(mutex);
+        steeringRequestsQueue << request;
     }
 
     void addSteeringFeedback(const std::string& feedback)
     {
-        // fixme
-        // LOG(DBG, "Pipe::addSteeringFeedback(" << feedback << ")");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // steeringFeedback << feedback;
-        // signal.notify_one();
+        LOG(DBG, "Pipe::addSteeringFeedback(" << feedback << ")");
+        std::lock_guard<std::mutex> lock(mutex);
+        steeringFeedback << feedback;
+        notify();
     }
 
     StringVec retrieveSteeringRequests()
     {
-        // fixme
-        // using std::swap;
-        // LOG(DBG, "Pipe::retrieveSteeringRequests()");
+        using std::swap;
+        LOG(DBG, "Pipe::retrieveSteeringRequests()");
         StringVec requests;
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // swap(requests, steeringRequests);
-        // LOG(DBG, "  retrieveSteeringRequests yields " << requests.size());
-        // if (requests.size() > 0) {
-        //     LOG(DBG, "  steeringRequests: " << requests);
-        // }
+        std::lock_guard<std::mutex> lock(mutex);
+        swap(requests, steeringRequests);
+        LOG(DBG, "  retrieveSteeringRequests yields " << requests.size());
         return requests;
     }
 
     StringVec copySteeringRequestsQueue()
     {
-        // fixme
-        // LOG(DBG, "Pipe::copySteeringRequestsQueue()");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // StringVec requests = steeringRequestsQueue;
-        StringVec requests;
+        LOG(DBG, "Pipe::copySteeringRequestsQueue()");
+        std::lock_guard<std::mutex> lock(mutex);
+        StringVec requests = steeringRequestsQueue;
         return requests;
     }
 
     StringVec retrieveSteeringFeedback()
     {
-        // fixme
-        // using std::swap;
-        // LOG(DBG, "Pipe::retrieveSteeringFeedback()");
+        using std::swap;
+        LOG(DBG, "Pipe::retrieveSteeringFeedback()");
         StringVec feedback;
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // swap(feedback, steeringFeedback);
-        // LOG(DBG, "  retrieveSteeringFeedback yields " << feedback.size());
-        // LOG(DBG, "  retrieveSteeringFeedback is " << feedback);
+        std::lock_guard<std::mutex> lock(mutex);
+        swap(feedback, steeringFeedback);
+        LOG(DBG, "  retrieveSteeringFeedback yields " << feedback.size());
         return feedback;
     }
 
     StringVec copySteeringFeedback()
     {
-        // fixme
-        // LOG(DBG, "Pipe::copySteeringFeedback()");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // StringVec feedback = steeringFeedback;
-
-        StringVec feedback;
+        LOG(DBG, "Pipe::copySteeringFeedback()");
+        std::lock_guard<std::mutex> lock(mutex);
+        StringVec feedback = steeringFeedback;
         return feedback;
     }
 
+    /**
+     * Broadcasts all steering requests queued on the root to all
+     * nodes and moves the feedback of all nodes to the root.
+     * Collective operation. Each direction is batched into a fixed
+     * number of collectives, independently of the number of strings.
+     * If no requests are queued, that direction costs a single
+     * broadcast.
+     */
     void sync()
     {
-//         LOG(DBG, "Pipe::sync()");
-//         std::lock_guard<boost::mutex> lock(mutex);
-// #ifdef LIBGEODECOMP_WITH_MPI
-//         broadcastSteeringRequests();
-//         moveSteeringFeedbackToRoot();
-// #endif
+        LOG(DBG, "Pipe::sync()");
+#ifdef LIBGEODECOMP_WITH_MPI
+        broadcastSteeringRequests();
+        moveSteeringFeedbackToRoot();
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        append(steeringRequests, steeringRequestsQueue);
+        steeringRequestsQueue.clear();
+#endif
     }
 
+    /**
+     * Blocks until at least the given number of lines of feedback is
+     * available. Don't call this from the CommandServer's thread.
+     */
     void waitForFeedback(std::size_t lines = 1)
     {
-        // LOG(DBG, "Pipe::waitForFeedback(" << lines << ")");
-        // boost::unique_lock<boost::mutex> lock(mutex);
-
-        // while (steeringFeedback.size() < lines) {
-        //     LOG(DBG, "  still waiting for feedback (" << steeringFeedback.size() << "/" << lines << ")\n");
-        //     signal.wait(lock);
-        // }
-        // LOG(DBG, "  feedback acquired");
+        LOG(DBG, "Pipe::waitForFeedback(" << lines << ")");
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (steeringFeedback.size() < lines) {
+            LOG(DBG, "  still waiting for feedback (" << steeringFeedback.size() << "/" << lines << ")\n");
+            signal.wait(lock);
+        }
+        LOG(DBG, "  feedback acquired");
+    }
+
+    /**
+     * Whenever feedback arrives, a single byte will be written to the
+     * given file descriptor (e.g. the write end of a pipe(2)), which
+     * lets an event loop poll() for feedback. The descriptor should
+     * be non-blocking. Pass -1 to switch notifications off.
+     */
+    void setNotificationFD(int fd)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        notificationFD = fd;
     }
 
 private:
-    // fixme
-//     boost::mutex mutex;
-//     boost::condition_variable signal;
+    std::mutex mutex;
+    std::condition_variable signal;
     StringVec steeringRequestsQueue;
     StringVec steeringRequests;
     StringVec steeringFeedback;
+#ifdef LIBGEODECOMP_WITH_MPI
+    MPILayer mpiLayer;
+    int root;
+#endif
+    int notificationFD;
+
+    /**
+     * Expects the mutex to be held by the caller.
+     */
+    void notify()
+    {
+        signal.notify_all();
+
+        if (notificationFD != -1) {
+            char c = 0;
+            // a full pipe already implies a pending notification,
+            // so the result can be ignored:
+            ssize_t res = write(notificationFD, &c, 1);
+            (void)res;
+        }
+    }
+
+#ifdef LIBGEODECOMP_WITH_MPI
+    void broadcastSteeringRequests()
+    {
+        using std::swap;
+        LOG(DBG, "Pipe::broadcastSteeringRequests()");
+
+        StringVec requests;
+        std::vector<int> requestSizes;
+        std::vector<char> buffer;
+
+        if (mpiLayer.rank() == root) {
+            std::lock_guard<std::mutex> lock(mutex);
+            swap(requests, steeringRequestsQueue);
+        }
+
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            requestSizes << int(requests[i].size());
+            buffer.insert(buffer.end(), requests[i].begin(), requests[i].end());
+        }
+
+        mpiLayer.broadcastVector(&requestSizes, root);
+        if (!requestSizes.empty()) {
+            mpiLayer.broadcastVector(&buffer, root);
+        }
+
+        requests.clear();
+        std::size_t cursor = 0;
+        for (std::size_t i = 0; i < requestSizes.size(); ++i) {
+            std::size_t nextCursor = cursor + requestSizes[i];
+            requests << std::string(buffer.begin() + cursor, buffer.begin() + nextCursor);
+            cursor = nextCursor;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        // requests requeued by non-root nodes are superseded by those
+        // requeued on the root:
+        if (mpiLayer.rank() != root) {
+            steeringRequestsQueue.clear();
+        }
+        append(steeringRequests, requests);
+        LOG(DBG, "  steeringRequests: " << steeringRequests);
+    }
 
-// #ifdef LIBGEODECOMP_WITH_MPI
-//     MPILayer mpiLayer;
-//     int root;
-
-//     void broadcastSteeringRequests()
-//     {
-//         LOG(DBG, "Pipe::broadcastSteeringRequests()");
-
-//         int numRequests = mpiLayer.broadcast(steeringRequestsQueue.size(), root);
-//         if (mpiLayer.rank() != root) {
-//             steeringRequestsQueue.resize(numRequests);
-//         } else {
-//             LOG(DBG, "  steeringRequestsQueue: " << steeringRequestsQueue);
-//         }
-
-//         std::vector<int> requestSizes(numRequests);
-
-//         if (mpiLayer.rank() == root) {
-//             for (int i = 0; i < numRequests; ++i) {
-//                 requestSizes[i] = steeringRequestsQueue[i].size();
-//             }
-//         }
-
-//         mpiLayer.broadcastVector(&requestSizes, root);
-//         if (mpiLayer.rank() != root) {
-//             for (int i = 0; i < numRequests; ++i) {
-//                 steeringRequestsQueue[i].resize(requestSizes[i]);
-//             }
-//         }
-
-//         for (int i = 0; i < numRequests; ++i) {
-//             mpiLayer.broadcast(&steeringRequestsQueue[i][0], requestSizes[i], root);
-//         }
-
-//         append(steeringRequests, steeringRequestsQueue);
-//         steeringRequestsQueue.clear();
-//         LOG(DBG, "  steeringRequests: " << steeringRequests);
-//     }
-
-//     /**
-//      * Will move steering requests from the compute nodes to the root
-//      * where it can then be forwarded to the user.
-//      */
-//     void moveSteeringFeedbackToRoot()
-//     {
-//         // marshall all feedback in order to use scalable gather afterwards
-//         std::vector<char> localBuffer;
-//         std::vector<int> localLengths;
-//         for (StringVec::iterator i = steeringFeedback.begin();
-//              i != steeringFeedback.end();
-//              ++i) {
-//             localBuffer.insert(localBuffer.end(), i->begin(), i->end());
-//             localLengths << i->size();
-//         }
-//         LOG(DBG, "moveSteeringFeedbackToRoot: " << localBuffer << " " << localLengths);
-
-//         // how many strings are sent per node?
-//         std::vector<int> numFeedback = mpiLayer.gather((int)localLengths.size(), root);
-
-//         // all lengths of all strings:
-//         std::vector<int> allFeedbackLengths(sum(numFeedback));
-//         mpiLayer.gatherV(localLengths, numFeedback, root, allFeedbackLengths);
-
-//         // gather all messages in a single, giant buffer:
-//         std::vector<int> charsPerNode = mpiLayer.gather((int)localBuffer.size(), root);
-//         std::vector<char> globalBuffer(sum(charsPerNode));
-
-//         mpiLayer.gatherV(localBuffer, charsPerNode, root, globalBuffer);
-
-//         // reconstruct strings:
-//         std::size_t cursor = 0;
-//         steeringFeedback.resize(0);
-
-//         for (std::vector<int>::iterator i = allFeedbackLengths.begin();
-//              i != allFeedbackLengths.end();
-//              ++i) {
-//             std::size_t nextCursor = cursor + *i;
-//             steeringFeedback << std::string(globalBuffer.begin() + cursor,
-//                                             globalBuffer.begin() + nextCursor);
-//             cursor = nextCursor;
-//         }
-
-//         LOG(DBG, "  notifying... steeringFeedback(" << mpiLayer.rank() << ") == " << steeringFeedback);
-//         signal.notify_one();
-//     }
-// #endif
+    /**
+     * Will move steering feedback from the compute nodes to the root
+     * where it can then be forwarded to the user.
+     */
+    void moveSteeringFeedbackToRoot()
+    {
+        using std::swap;
+        StringVec feedback;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            swap(feedback, steeringFeedback);
+        }
+
+        // marshall all feedback in order to use scalable gather afterwards
+        std::vector<char> localBuffer;
+        std::vector<int> localLengths;
+        for (StringVec::iterator i = feedback.begin(); i != feedback.end(); ++i) {
+            localBuffer.insert(localBuffer.end(), i->begin(), i->end());
+            localLengths << int(i->size());
+        }
+
+        // how many strings are sent per node?
+        std::vector<int> numFeedback = mpiLayer.gather(int(localLengths.size()), root);
+
+        // all lengths of all strings:
+        std::vector<int> allFeedbackLengths(sum(numFeedback));
+        mpiLayer.gatherV(localLengths, numFeedback, root, allFeedbackLengths);
+
+        // gather all messages in a single, giant buffer:
+        std::vector<int> charsPerNode = mpiLayer.gather(int(localBuffer.size()), root);
+        std::vector<char> globalBuffer(sum(charsPerNode));
+        mpiLayer.gatherV(localBuffer, charsPerNode, root, globalBuffer);
+
+        if (mpiLayer.rank() != root) {
+            return;
+        }
+
+        // reconstruct strings:
+        std::size_t cursor = 0;
+        feedback.clear();
+        for (std::vector<int>::iterator i = allFeedbackLengths.begin();
+             i != allFeedbackLengths.end();
+             ++i) {
+            std::size_t nextCursor = cursor + *i;
+            feedback << std::string(globalBuffer.begin() + cursor,
+                                    globalBuffer.begin() + nextCursor);
+            cursor = nextCursor;
+        }
+
+        // feedback added during the gather is younger and thus goes last:
+        std::lock_guard<std::mutex> lock(mutex);
+        append(feedback, steeringFeedback);
+        swap(feedback, steeringFeedback);
+        if (!steeringFeedback.empty()) {
+            notify();
+        }
+        LOG(DBG, "  steeringFeedback(" << mpiLayer.rank() << ") == " << steeringFeedback);
+    }
+#endif
 };
 
 }
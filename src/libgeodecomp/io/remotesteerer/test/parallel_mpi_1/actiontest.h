@@ -27,19 +27,18 @@ public:
 
     void testBasic()
     {
-        // fixme
-        // Pipe pipe;
-        // MockAction action;
-
-        // TS_ASSERT_EQUALS("this is but a dummy action", action.helpMessage());
-        // TS_ASSERT_EQUALS("mock", action.key());
-        // StringVec parameters;
-        // parameters << "arrrr"
-        //            << "matey";
-        // action(parameters, pipe);
-        // StringVec feedback = pipe.retrieveSteeringFeedback();
-        // TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
-        // TS_ASSERT_EQUALS(feedback[0], "MockAction mocks you! arrrr");
+        Pipe pipe;
+        MockAction action;
+
+        TS_ASSERT_EQUALS("this is but a dummy action", action.helpMessage());
+        TS_ASSERT_EQUALS("mock", action.key());
+        StringVec parameters;
+        parameters << "arrrr"
+                   << "matey";
+        action(parameters, pipe);
+        StringVec feedback = pipe.retrieveSteeringFeedback();
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
+        TS_ASSERT_EQUALS(feedback[0], "MockAction mocks you! arrrr");
     }
 };
 
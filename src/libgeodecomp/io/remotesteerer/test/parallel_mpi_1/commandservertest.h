@@ -3,6 +3,12 @@
 
 #include <cxxtest/TestSuite.h>
 
+#include <algorithm>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 using namespace LibGeoDecomp;
 using namespace LibGeoDecomp::RemoteSteererHelpers;
 
@@ -38,25 +44,82 @@ public:
 
     void testActionInvocationAndFeedback()
     {
-        // fixme
-        // int port = 47110;
-        // CommandServer<int> server(port, pipe);
-        // server.addAction(new MockAction());
-        // StringVec feedback = CommandServer<int>::sendCommandWithFeedback("mock 1 2 3", 1, port);
-        // TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
-        // TS_ASSERT_EQUALS(feedback[0], "MockAction mocks you!");
+        int port = 47110;
+        CommandServer<int> server(port, pipe);
+        server.addAction(new MockAction());
+        StringVec feedback = CommandServer<int>::sendCommandWithFeedback("mock 1 2 3", 1, port);
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
+        TS_ASSERT_EQUALS(feedback[0], "MockAction mocks you!");
     }
 
     void testInvalidCommand()
     {
-        // fixme
-        // int port = 47114;
-        // CommandServer<int> server(port, pipe);
-        // StringVec feedback = CommandServer<int>::sendCommandWithFeedback("blah", 2, port);
-
-        // TS_ASSERT_EQUALS(feedback.size(), std::size_t(2));
-        // TS_ASSERT_EQUALS(feedback[0], "command not found: blah");
-        // TS_ASSERT_EQUALS(feedback[1], "try \"help\"");
+        int port = 47114;
+        CommandServer<int> server(port, pipe);
+        StringVec feedback = CommandServer<int>::sendCommandWithFeedback("blah", 2, port);
+
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(2));
+        TS_ASSERT_EQUALS(feedback[0], "command not found: blah");
+        TS_ASSERT_EQUALS(feedback[1], "try \"help\"");
+    }
+
+    void testIdleClientDoesntBlockOthers()
+    {
+        int port = 47115;
+        CommandServer<int> server(port, pipe);
+
+        // connects, but never sends anything:
+        int idleFD = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        TS_ASSERT_EQUALS(0, connect(idleFD, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+
+        StringVec feedback = CommandServer<int>::sendCommandWithFeedback("ping\nping", 2, port);
+        StringVec expected;
+        expected << "pong 1"
+                 << "pong 2";
+        TS_ASSERT_EQUALS(feedback, expected);
+
+        close(idleFD);
+    }
+
+    void testFeedbackFromSimulationThread()
+    {
+        int port = 47116;
+        CommandServer<int> server(port, pipe);
+
+        // the client will wait for feedback which is only added
+        // later on, as a Handler would do:
+        Interactor interactor("ping", 2, true, port);
+        usleep(10000);
+        server.sendMessage("steered");
+        interactor.waitForCompletion();
+
+        // order depends on whether the ping was handled before the
+        // message was sent:
+        StringVec feedback = interactor.feedback();
+        std::sort(feedback.begin(), feedback.end());
+        StringVec expected;
+        expected << "pong 1"
+                 << "steered";
+        TS_ASSERT_EQUALS(feedback, expected);
+    }
+
+    void testQuit()
+    {
+        int port = 47117;
+        SharedPtr<CommandServer<int> >::Type server(new CommandServer<int>(port, pipe));
+        CommandServer<int>::sendCommand("quit", port);
+        // shutting down must not block, even though the thread has exited already:
+        server.reset();
+
+        // port must be available again:
+        server.reset(new CommandServer<int>(port, pipe));
+        StringVec feedback = CommandServer<int>::sendCommandWithFeedback("ping", 1, port);
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
     }
 
 private:
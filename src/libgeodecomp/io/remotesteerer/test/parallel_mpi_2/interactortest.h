@@ -2,6 +2,12 @@
 #include <libgeodecomp/communication/mpilayer.h>
 #include <libgeodecomp/io/remotesteerer/interactor.h>
 
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 using namespace LibGeoDecomp;
 using namespace LibGeoDecomp::RemoteSteererHelpers;
 
@@ -14,56 +20,68 @@ class InteractorTest : public CxxTest::TestSuite
 public:
     void testSerial()
     {
-        // fixme
-
-        // MPILayer mpiLayer;
-        // int port = 47113;
-        // StringVec expectedFeedback;
-        // expectedFeedback << "bingo bongo";
+        MPILayer mpiLayer;
+        int port = 47113;
+        StringVec expectedFeedback;
+        expectedFeedback << "bingo bongo";
 
-        // if (mpiLayer.rank() == 0) {
-        //     // listen on port "port"
-        //     boost::asio::io_service ioService;
-        //     tcp::acceptor acceptor(ioService, tcp::endpoint(tcp::v4(), port));
-        //     tcp::socket socket(ioService);
+        if (mpiLayer.rank() == 0) {
+            // listen on port "port"
+            int acceptor = socket(AF_INET, SOCK_STREAM, 0);
+            int reuse = 1;
+            setsockopt(acceptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            sockaddr_in address;
+            std::memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+            TS_ASSERT_EQUALS(0, bind(acceptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+            TS_ASSERT_EQUALS(0, listen(acceptor, 1));
 
-        //     mpiLayer.barrier();
+            mpiLayer.barrier();
 
-        //     // grab the data from the interactor:
-        //     boost::system::error_code errorCode;
-        //     acceptor.accept(socket, errorCode);
-        //     boost::asio::streambuf buf;
-        //     std::size_t length = boost::asio::read_until(socket, buf, '\n', errorCode);
-        //     // gah, converting streambuf to string couldn't be any easier...
-        //     std::istream lineBuf(&buf);
-        //     std::string line(length, 'X');
-        //     lineBuf.read(&line[0], length);
+            // grab the data from the interactor:
+            int socketFD = accept(acceptor, 0, 0);
+            std::string input;
+            while (input.find("wait 1\n") == std::string::npos) {
+                char buf[1024];
+                ssize_t length = recv(socketFD, buf, sizeof(buf), 0);
+                TS_ASSERT(length > 0);
+                if (length <= 0) {
+                    break;
+                }
+                input.append(buf, length);
+            }
 
-        //     // write back some feedback
-        //     boost::asio::write(
-        //         socket,
-        //         boost::asio::buffer("bingo bongo\n"),
-        //         boost::asio::transfer_all(),
-        //         errorCode);
+            // write back some feedback
+            std::string feedback = "bingo bongo\n";
+            TS_ASSERT_EQUALS(ssize_t(feedback.size()), send(socketFD, feedback.data(), feedback.size(), 0));
 
-        //     // check the results
-        //     StringVec tokens = StringOps::tokenize(line, " \r\n");
-        //     StringVec expected;
-        //     expected << "command"
-        //              << "blah";
-        //     TS_ASSERT_EQUALS(tokens, expected);
-        // } else {
-        //     mpiLayer.barrier();
+            // check the results
+            StringVec tokens = StringOps::tokenize(input, " \r\n");
+            StringVec expected;
+            expected << "command"
+                     << "blah"
+                     << "wait"
+                     << "1";
+            TS_ASSERT_EQUALS(tokens, expected);
 
-        //     // start the interactor and wait until it has sent its commands
-        //     Interactor interactor("command blah\n", 1, true, port);
+            mpiLayer.barrier();
+            close(socketFD);
+            close(acceptor);
+        } else {
+            mpiLayer.barrier();
 
-        //     // check the results
-        //     interactor.waitForCompletion();
+            // run the interactor synchronously, it'll return once it
+            // has received all feedback
+            Interactor interactor("command blah\n", 1, false, port);
+            TS_ASSERT_EQUALS(0, interactor());
 
-        //     StringVec actualFeedback = interactor.feedback();
-        //     TS_ASSERT_EQUALS(actualFeedback, expectedFeedback);
-        // }
+            // check the results
+            StringVec actualFeedback = interactor.feedback();
+            TS_ASSERT_EQUALS(actualFeedback, expectedFeedback);
+            mpiLayer.barrier();
+        }
     }
 };
 
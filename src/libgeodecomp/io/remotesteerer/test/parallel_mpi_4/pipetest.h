@@ -3,6 +3,7 @@
 #include <hpx/config.hpp>
 #endif
 
+#include <thread>
 #include <unistd.h>
 #include <libgeodecomp/communication/mpilayer.h>
 #include <libgeodecomp/io/remotesteerer/pipe.h>
@@ -24,22 +25,44 @@ public:
         MPILayer mpiLayer;
         Pipe pipe;
 
-        // fixme
-        // if (mpiLayer.rank() == 0) {
-        //     pipe.addSteeringRequest("set heat 0.1 100 120 110");
-        //     pipe.addSteeringRequest("set flow 6.9 100 120 110");
-        // }
+        if (mpiLayer.rank() == 0) {
+            pipe.addSteeringRequest("set heat 0.1 100 120 110");
+            pipe.addSteeringRequest("set flow 6.9 100 120 110");
+        }
+
+        pipe.sync();
 
-        // pipe.sync();
+        TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(2));
+        TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
 
-        // TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(2));
-        // TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
+        TS_ASSERT_EQUALS(pipe.steeringRequests[0], "set heat 0.1 100 120 110");
+        TS_ASSERT_EQUALS(pipe.steeringRequests[1], "set flow 6.9 100 120 110");
+
+        TS_ASSERT_EQUALS(pipe.retrieveSteeringRequests().size(), unsigned(2));
+        TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(0));
+    }
 
-        // TS_ASSERT_EQUALS(pipe.steeringRequests[0], "set heat 0.1 100 120 110");
-        // TS_ASSERT_EQUALS(pipe.steeringRequests[1], "set flow 6.9 100 120 110");
+    void testRequeuedRequestsAreNotDuplicated()
+    {
+        MPILayer mpiLayer;
+        Pipe pipe;
 
-        // TS_ASSERT_EQUALS(pipe.retrieveSteeringRequests().size(), unsigned(2));
-        // TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(0));
+        if (mpiLayer.rank() == 0) {
+            pipe.addSteeringRequest("get_heat 10 1 2");
+        }
+        pipe.sync();
+
+        // all nodes requeue the request they couldn't handle yet...
+        StringVec requests = pipe.retrieveSteeringRequests();
+        TS_ASSERT_EQUALS(requests.size(), std::size_t(1));
+        pipe.addSteeringRequest(requests[0]);
+        pipe.sync();
+
+        // ...but only the root's copy gets redistributed:
+        requests = pipe.retrieveSteeringRequests();
+        TS_ASSERT_EQUALS(requests.size(), std::size_t(1));
+        TS_ASSERT_EQUALS(requests[0], "get_heat 10 1 2");
+        TS_ASSERT_EQUALS(pipe.copySteeringRequestsQueue().size(), std::size_t(0));
     }
 
     void testSyncSteeringFeedback()
@@ -47,20 +70,42 @@ public:
         MPILayer mpiLayer;
         Pipe pipe;
 
-        // fixme
-        // pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " starting");
-        // if (mpiLayer.rank() == 2) {
-        //     pipe.addSteeringFeedback("node 2 encountered error");
-        // }
-        // pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " shutting down");
-
-        // pipe.sync();
-        // // 4 ranks with 2x feedback each ("starting" + "shutting down"), plus rank 2 with an error message
-        // unsigned expectedSize = (mpiLayer.rank() == 0)? 9 : 0;
-        // TS_ASSERT_EQUALS(pipe.steeringFeedback.size(),           expectedSize);
-        // TS_ASSERT_EQUALS(pipe.copySteeringFeedback().size(),     expectedSize);
-        // TS_ASSERT_EQUALS(pipe.retrieveSteeringFeedback().size(), expectedSize);
-        // TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
+        pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " starting");
+        if (mpiLayer.rank() == 2) {
+            pipe.addSteeringFeedback("node 2 encountered error");
+        }
+        pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " shutting down");
+
+        pipe.sync();
+        // 4 ranks with 2x feedback each ("starting" + "shutting down"), plus rank 2 with an error message
+        unsigned expectedSize = (mpiLayer.rank() == 0)? 9 : 0;
+        TS_ASSERT_EQUALS(pipe.steeringFeedback.size(),           expectedSize);
+        TS_ASSERT_EQUALS(pipe.copySteeringFeedback().size(),     expectedSize);
+        TS_ASSERT_EQUALS(pipe.retrieveSteeringFeedback().size(), expectedSize);
+        TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
+    }
+
+    void testNotificationFD()
+    {
+        MPILayer mpiLayer;
+        Pipe pipe;
+        int fds[2];
+        TS_ASSERT_EQUALS(0, ::pipe(fds));
+        pipe.setNotificationFD(fds[1]);
+
+        pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " says hello");
+        pipe.sync();
+
+        // one notification for the local feedback, one more on the
+        // root for the gathered feedback:
+        char buf[16];
+        int expected = (mpiLayer.rank() == 0) ? 2 : 1;
+        TS_ASSERT_EQUALS(expected, read(fds[0], buf, sizeof(buf)));
+        TS_ASSERT_EQUALS(pipe.copySteeringFeedback().size(), std::size_t((mpiLayer.rank() == 0) ? 4 : 0));
+
+        pipe.setNotificationFD(-1);
+        close(fds[0]);
+        close(fds[1]);
     }
 
     class Runner
@@ -85,17 +130,16 @@ public:
         MPILayer mpiLayer;
         Pipe pipe;
 
-        // fixme
-        // if (mpiLayer.rank() == 0) {
-        //     boost::thread myThread((Runner(&pipe)));
-        //     pipe.waitForFeedback();
-        //     StringVec actual = pipe.retrieveSteeringFeedback();
-        //     StringVec expected;
-        //     expected << "bingobongo\n";
-        //     TS_ASSERT_EQUALS(actual, expected);
-
-        //     myThread.join();
-        // }
+        if (mpiLayer.rank() == 0) {
+            std::thread myThread((Runner(&pipe)));
+            pipe.waitForFeedback();
+            StringVec actual = pipe.retrieveSteeringFeedback();
+            StringVec expected;
+            expected << "bingobongo\n";
+            TS_ASSERT_EQUALS(actual, expected);
+
+            myThread.join();
+        }
     }
 };
 
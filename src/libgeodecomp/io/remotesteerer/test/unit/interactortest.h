@@ -2,6 +2,12 @@
 
 #include <cxxtest/TestSuite.h>
 
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 using namespace LibGeoDecomp;
 using namespace LibGeoDecomp::RemoteSteererHelpers;
 
@@ -14,44 +20,66 @@ class InteractorTest : public CxxTest::TestSuite
 public:
     void testThreaded()
     {
-        // fixme
-        // int port = 47111;
-        // StringVec expectedFeedback;
-        // expectedFeedback << "bingo bongo";
-
-        // // listen on port "port"
-        // boost::asio::io_service ioService;
-        // tcp::acceptor acceptor(ioService, tcp::endpoint(tcp::v4(), port));
-        // tcp::socket socket(ioService);
-
-        // // start the interactor and wait until it has sent its commands
-        // Interactor interactor("command blah\n", 1, true, port);
-
-        // // grab the data from the interactor:
-        // boost::system::error_code errorCode;
-        // acceptor.accept(socket, errorCode);
-        // boost::asio::streambuf buf;
-        // std::size_t length = boost::asio::read_until(socket, buf, '\n', errorCode);
-        // // gah, converting streambuf to string couldn't be any easier...
-        // std::istream lineBuf(&buf);
-        // std::string line(length, 'X');
-        // lineBuf.read(&line[0], length);
-
-        // // write back some feedback
-        // boost::asio::write(
-        //     socket,
-        //     boost::asio::buffer("bingo bongo\n"),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // // check the results
-        // StringVec tokens = StringOps::tokenize(line, " \r\n");
-        // StringVec expected;
-        // expected << "command"
-        //          << "blah";
-        // TS_ASSERT_EQUALS(tokens, expected);
-        // interactor.waitForCompletion();
-        // TS_ASSERT_EQUALS(interactor.feedback(), expectedFeedback);
+        int port = 47111;
+        StringVec expectedFeedback;
+        expectedFeedback << "bingo bongo";
+
+        // listen on port "port"
+        int acceptor = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(acceptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        TS_ASSERT_EQUALS(0, bind(acceptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+        TS_ASSERT_EQUALS(0, listen(acceptor, 1));
+
+        // start the interactor and wait until it has sent its commands
+        Interactor interactor("command blah\n", 1, true, port);
+
+        // grab the data from the interactor:
+        int socketFD = accept(acceptor, 0, 0);
+        std::string input;
+        while (input.find("wait 1\n") == std::string::npos) {
+            char buf[1024];
+            ssize_t length = recv(socketFD, buf, sizeof(buf), 0);
+            TS_ASSERT(length > 0);
+            if (length <= 0) {
+                break;
+            }
+            input.append(buf, length);
+        }
+
+        // write back some feedback, split across two writes
+        std::string feedback = "bingo bongo\n";
+        TS_ASSERT_EQUALS(ssize_t(5), send(socketFD, feedback.data(), 5, 0));
+        usleep(1000);
+        TS_ASSERT_EQUALS(ssize_t(feedback.size() - 5), send(socketFD, feedback.data() + 5, feedback.size() - 5, 0));
+
+        // check the results
+        StringVec lines = StringOps::tokenize(input, "\n");
+        TS_ASSERT_EQUALS(lines.size(), std::size_t(2));
+        StringVec tokens = StringOps::tokenize(lines[0], " \r\n");
+        StringVec expected;
+        expected << "command"
+                 << "blah";
+        TS_ASSERT_EQUALS(tokens, expected);
+        TS_ASSERT_EQUALS(lines[1], "wait 1");
+        interactor.waitForCompletion();
+        TS_ASSERT_EQUALS(interactor.feedback(), expectedFeedback);
+
+        close(socketFD);
+        close(acceptor);
+    }
+
+    void testConnectionRefused()
+    {
+        // nobody is listening on this port:
+        Interactor interactor("ping", 1, false, 47118);
+        TS_ASSERT_EQUALS(1, interactor());
+        TS_ASSERT_EQUALS(interactor.feedback().size(), std::size_t(0));
     }
 };
 
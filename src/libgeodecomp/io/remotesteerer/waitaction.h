@@ -8,16 +8,21 @@ namespace LibGeoDecomp {
 namespace RemoteSteererHelpers {
 
 /**
- * Suspends the command server until feedback is available.
+ * Suspends the client's session until feedback is available. The
+ * CommandServer won't block on this: it merely defers further
+ * commands of this client until the requested number of lines has
+ * been sent to it, which it learns via linesToWaitFor. Without that
+ * counter this will block on the Pipe instead.
  */
 template<typename CELL_TYPE>
 class WaitAction : public Action<CELL_TYPE>
 {
 public:
-    WaitAction() :
+    explicit WaitAction(std::size_t *linesToWaitFor = 0) :
         Action<CELL_TYPE>(
             "wait",
-            "usage: \"wait [n]\", will wait until n lines of feedback from the simulation have been received. If n is omitted, it will wait for 1 line.")
+            "usage: \"wait [n]\", will wait until n lines of feedback from the simulation have been received. If n is omitted, it will wait for 1 line."),
+        linesToWaitFor(linesToWaitFor)
     {}
 
     void operator()(const StringVec& parameters, Pipe& pipe)
@@ -26,9 +31,19 @@ public:
         if (parameters.size() > 0) {
             lines = StringOps::atoi(parameters[0]);
         }
+        if (lines < 0) {
+            lines = 0;
+        }
 
-        pipe.waitForFeedback(lines);
+        if (linesToWaitFor) {
+            *linesToWaitFor = lines;
+        } else {
+            pipe.waitForFeedback(lines);
+        }
     }
+
+private:
+    std::size_t *linesToWaitFor;
 };
 
 }
@@ -393,6 +393,78 @@ private:
     std::string unstructuredMeshLabel;
     std::string pointMeshLabel;
 
+    /**
+     * Hands all cells to the point mesh selectors.
+     */
+    class AddPointsVisitor : public ConstGridVisitor<Cell, DIM>
+    {
+    public:
+        explicit AddPointsVisitor(SiloWriter *writer) :
+            writer(writer)
+        {}
+
+        virtual void visit(const Streak<DIM>& streak, const Cell *cells)
+        {
+            for (int i = 0; i < streak.length(); ++i) {
+                writer->pointMeshSelectors->callbackAddPoints(writer, cells[i]);
+            }
+        }
+
+    private:
+        SiloWriter *writer;
+    };
+
+    /**
+     * Hands all cells to the unstructured grid selectors.
+     */
+    class AddShapesVisitor : public ConstGridVisitor<Cell, DIM>
+    {
+    public:
+        explicit AddShapesVisitor(SiloWriter *writer) :
+            writer(writer)
+        {}
+
+        virtual void visit(const Streak<DIM>& streak, const Cell *cells)
+        {
+            for (int i = 0; i < streak.length(); ++i) {
+                writer->unstructuredGridSelectors->callbackAddShapes(writer, cells[i]);
+            }
+        }
+
+    private:
+        SiloWriter *writer;
+    };
+
+    /**
+     * Appends the selected member of all items held by the cells to
+     * the writer's variableData.
+     */
+    template<typename CARGO, typename COLLECTION_INTERFACE>
+    class AddVariableVisitor : public ConstGridVisitor<Cell, DIM>
+    {
+    public:
+        AddVariableVisitor(
+            SiloWriter *writer,
+            const Selector<CARGO>& selector,
+            const COLLECTION_INTERFACE& collectionInterface) :
+            writer(writer),
+            selector(selector),
+            collectionInterface(collectionInterface)
+        {}
+
+        virtual void visit(const Streak<DIM>& streak, const Cell *cells)
+        {
+            for (int i = 0; i < streak.length(); ++i) {
+                writer->collectVariable(cells[i], selector, collectionInterface);
+            }
+        }
+
+    private:
+        SiloWriter *writer;
+        const Selector<CARGO>& selector;
+        const COLLECTION_INTERFACE& collectionInterface;
+    };
+
     void addSelector(const Selector<Cell>& selector)
     {
         cellSelectors << selector;
@@ -501,26 +573,14 @@ private:
 
     void collectPoints(const GridType& grid)
     {
-        CoordBox<DIM> box = grid.boundingBox();
-        for (typename CoordBox<DIM>::Iterator i = box.begin();
-             i != box.end();
-             ++i) {
-
-            Cell cell = grid.get(*i);
-            pointMeshSelectors->callbackAddPoints(this, cell);
-        }
+        AddPointsVisitor visitor(this);
+        visitBoundingBox(grid, &visitor);
     }
 
     void collectShapes(const GridType& grid)
     {
-        CoordBox<DIM> box = grid.boundingBox();
-        for (typename CoordBox<DIM>::Iterator i = box.begin();
-             i != box.end();
-             ++i) {
-
-            Cell cell = grid.get(*i);
-            unstructuredGridSelectors->callbackAddShapes(this, cell);
-        }
+        AddShapesVisitor visitor(this);
+        visitBoundingBox(grid, &visitor);
     }
 
     void collectVariable(const GridType& grid, const Selector<Cell>& selector)
@@ -538,17 +598,27 @@ private:
     template<typename CARGO, typename COLLECTION_INTERFACE>
     void collectVariable(const GridType& grid, const Selector<CARGO>& selector, const COLLECTION_INTERFACE& collectionInterface)
     {
-        CoordBox<DIM> box = grid.boundingBox();
-        for (typename CoordBox<DIM>::Iterator i = box.begin();
-             i != box.end();
-             ++i) {
+        AddVariableVisitor<CARGO, COLLECTION_INTERFACE> visitor(this, selector, collectionInterface);
+        visitBoundingBox(grid, &visitor);
+    }
 
-            Cell cell = grid.get(*i);
-            std::size_t oldSize = variableData.size();
-            std::size_t newSize = oldSize + collectionInterface.size(cell) * selector.sizeOfExternal();
-            variableData.resize(newSize);
-            addVariable(collectionInterface.begin(cell), collectionInterface.end(cell), &variableData[0] + oldSize, selector);
+    template<typename CARGO, typename COLLECTION_INTERFACE>
+    void collectVariable(const Cell& cell, const Selector<CARGO>& selector, const COLLECTION_INTERFACE& collectionInterface)
+    {
+        std::size_t oldSize = variableData.size();
+        std::size_t newSize = oldSize + collectionInterface.size(cell) * selector.sizeOfExternal();
+        variableData.resize(newSize);
+        addVariable(collectionInterface.begin(cell), collectionInterface.end(cell), &variableData[0] + oldSize, selector);
+    }
+
+    void visitBoundingBox(const GridType& grid, ConstGridVisitor<Cell, DIM> *visitor)
+    {
+        if (region.boundingBox() != grid.boundingBox()) {
+            region.clear();
+            region << grid.boundingBox();
         }
+
+        grid.visit(region, visitor);
     }
 
     void collectRegularGridGeometry(const GridType& grid)
@@ -8,6 +8,32 @@
 
 namespace LibGeoDecomp {
 
+namespace SteererHelpers {
+
+/**
+ * Assigns the static data block of CELL, if CELL has any.
+ */
+template<typename CELL, typename HAS_STATIC_DATA = void>
+class AssignStaticData
+{
+public:
+    template<typename STATIC_DATA>
+    void operator()(const STATIC_DATA& /* unused: data */)
+    {}
+};
+
+template<typename CELL>
+class AssignStaticData<CELL, typename CELL::API::SupportsStaticData>
+{
+public:
+    void operator()(const typename CELL::API::StaticData& data)
+    {
+        CELL::staticData = data;
+    }
+};
+
+}
+
 enum SteererEvent {
     STEERER_INITIALIZED,
     STEERER_NEXT_STEP,
@@ -39,7 +65,9 @@ public:
     {
     public:
         SteererFeedback() :
-            simulationEnd(false)
+            simulationEnd(false),
+            staticDataUpdate(false),
+            staticData()
         {}
 
         void endSimulation()
@@ -56,18 +84,53 @@ public:
          */
         void setStaticData(const StaticData& data)
         {
-            // immediate assignent is good enough for now. we might
-            // want to hook into here for more complex NUMA scenarios.
-            CELL_TYPE::staticData = data;
+            staticData = data;
+            staticDataUpdate = true;
         }
 
-        bool simulationEnded()
+        bool simulationEnded() const
         {
             return simulationEnd;
         }
 
+        bool hasStaticData() const
+        {
+            return staticDataUpdate;
+        }
+
+        const StaticData& getStaticData() const
+        {
+            return staticData;
+        }
+
+        /**
+         * Carries out a pending static data update. To be called by
+         * Simulators once it's safe to do so.
+         */
+        void applyStaticData()
+        {
+            if (staticDataUpdate) {
+                SteererHelpers::AssignStaticData<CELL_TYPE>()(staticData);
+                staticDataUpdate = false;
+            }
+        }
+
+        /**
+         * Adds the requests of other to this feedback. If both carry
+         * static data, then other's takes precedence.
+         */
+        void merge(const SteererFeedback& other)
+        {
+            simulationEnd |= other.simulationEnd;
+            if (other.staticDataUpdate) {
+                setStaticData(other.staticData);
+            }
+        }
+
     private:
         bool simulationEnd;
+        bool staticDataUpdate;
+        StaticData staticData;
     };
 
     explicit Steerer(const unsigned period) :
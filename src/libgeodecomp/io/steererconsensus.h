@@ -0,0 +1,207 @@
+#ifndef LIBGEODECOMP_IO_STEERERCONSENSUS_H
+#define LIBGEODECOMP_IO_STEERERCONSENSUS_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <libgeodecomp/io/steerer.h>
+
+#include <mpi.h>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+#include <type_traits>
+#endif
+
+namespace LibGeoDecomp {
+
+/**
+ * Lets all ranks agree on the SteererFeedback collected by their
+ * Steerers, so that DistributedSimulators end a simulation at the
+ * same time step everywhere and switch to new static data in lockstep.
+ *
+ * Agreement is reached via a single non-blocking MPI_Iallreduce per
+ * round: the end flags are OR'ed, and of all static data updates the
+ * one from the lowest rank wins. A round started at time step t is
+ * completed at step t + lag, which gives the reduction lag steps
+ * worth of computation to hide behind. Typically it'll be finished
+ * by then, so the feedback check doesn't introduce a global
+ * synchronization point.
+ *
+ * All ranks need to call start() and poll() at the same time steps.
+ * The static data is transferred as raw bytes, so it needs to be
+ * trivially copyable.
+ */
+template<typename CELL_TYPE>
+class SteererConsensus
+{
+public:
+    typedef typename Steerer<CELL_TYPE>::SteererFeedback SteererFeedback;
+    typedef typename Steerer<CELL_TYPE>::StaticData StaticData;
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+    static_assert(
+        std::is_trivially_copyable<StaticData>::value,
+        "SteererConsensus can only transfer trivially copyable static data");
+#endif
+
+    explicit SteererConsensus(
+        unsigned lag = 1,
+        MPI_Comm communicator = MPI_COMM_WORLD) :
+        lag(lag),
+        communicator(communicator),
+        request(MPI_REQUEST_NULL),
+        dueStep(0),
+        pending(false),
+        simulationEnd(false)
+    {
+        if (lag == 0) {
+            throw std::invalid_argument("SteererConsensus needs a lag of at least one time step");
+        }
+
+        MPI_Comm_rank(communicator, &rank);
+        MPI_Type_contiguous(sizeof(Vote), MPI_BYTE, &voteType);
+        MPI_Type_commit(&voteType);
+        MPI_Op_create(&SteererConsensus::reduce, 1, &voteOp);
+    }
+
+    ~SteererConsensus()
+    {
+        if (pending) {
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+        }
+
+        MPI_Op_free(&voteOp);
+        MPI_Type_free(&voteType);
+    }
+
+    /**
+     * Starts a new round based on the feedback gathered locally
+     * during time step step and resets feedback. Will complete a
+     * pending round first, which blocks if that one isn't due yet.
+     * Collective operation.
+     */
+    void start(unsigned step, SteererFeedback *feedback)
+    {
+        if (pending) {
+            complete();
+        }
+
+        // clear padding, too:
+        std::memset(&localVote, 0, sizeof(Vote));
+        localVote.simulationEnd = feedback->simulationEnded() ? 1 : 0;
+        localVote.source = (std::numeric_limits<int>::max)();
+        if (feedback->hasStaticData()) {
+            localVote.source = rank;
+            localVote.staticData = feedback->getStaticData();
+        }
+        *feedback = SteererFeedback();
+
+        MPI_Iallreduce(&localVote, &globalVote, 1, voteType, voteOp, communicator, &request);
+        dueStep = step + lag;
+        pending = true;
+    }
+
+    /**
+     * Completes the pending round if it's due at the given time step
+     * and applies its outcome. Returns true if it did.
+     */
+    bool poll(unsigned step)
+    {
+        if (!pending || (step < dueStep)) {
+            return false;
+        }
+
+        complete();
+        return true;
+    }
+
+    /**
+     * Returns true once any rank's Steerer has requested the end of
+     * the simulation and the consensus on that has been reached.
+     */
+    bool simulationEnded() const
+    {
+        return simulationEnd;
+    }
+
+    bool hasPendingRound() const
+    {
+        return pending;
+    }
+
+    /**
+     * Time step at which the pending round will be completed by poll().
+     */
+    unsigned getDueStep() const
+    {
+        return dueStep;
+    }
+
+private:
+    class Vote
+    {
+    public:
+        int simulationEnd;
+        int source;
+        StaticData staticData;
+    };
+
+    unsigned lag;
+    MPI_Comm communicator;
+    MPI_Datatype voteType;
+    MPI_Op voteOp;
+    MPI_Request request;
+    int rank;
+    Vote localVote;
+    Vote globalVote;
+    unsigned dueStep;
+    bool pending;
+    bool simulationEnd;
+
+    void complete()
+    {
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+        pending = false;
+
+        if (globalVote.simulationEnd) {
+            simulationEnd = true;
+        }
+
+        if (globalVote.source != (std::numeric_limits<int>::max)()) {
+            SteererFeedback feedback;
+            feedback.setStaticData(globalVote.staticData);
+            feedback.applyStaticData();
+        }
+    }
+
+    static void reduce(void *inBuffer, void *inOutBuffer, int *length, MPI_Datatype * /* unused: datatype */)
+    {
+        char *in = static_cast<char*>(inBuffer);
+        char *inOut = static_cast<char*>(inOutBuffer);
+
+        // buffers may be unaligned, hence the copies:
+        for (int i = 0; i < *length; ++i) {
+            Vote a;
+            Vote b;
+            std::memcpy(&a, in    + i * sizeof(Vote), sizeof(Vote));
+            std::memcpy(&b, inOut + i * sizeof(Vote), sizeof(Vote));
+
+            b.simulationEnd |= a.simulationEnd;
+            if (a.source < b.source) {
+                b.source = a.source;
+                b.staticData = a.staticData;
+            }
+
+            std::memcpy(inOut + i * sizeof(Vote), &b, sizeof(Vote));
+        }
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -1,5 +1,6 @@
 #include <sstream>
 #include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/perfcounters.h>
 #include <libgeodecomp/misc/testcell.h>
 #include <libgeodecomp/parallelization/serialsimulator.h>
 #include <libgeodecomp/io/testinitializer.h>
@@ -56,6 +57,20 @@ public:
         }
     }
 
+    void testPerfCountersAreOptIn()
+    {
+        std::ostringstream output;
+        PerfCounters::disable();
+
+        TracingWriter<TestCell<2> > plainWriter(1, 1, 0, output);
+        TS_ASSERT(!PerfCounters::enabled());
+
+        TracingWriter<TestCell<2> > countingWriter(1, 1, 0, output, true);
+        TS_ASSERT_EQUALS(PerfCounters::compiledIn(), PerfCounters::enabled());
+
+        PerfCounters::disable();
+    }
+
 private:
     MonolithicSimulator<TestCell<2> > *simulator;
 };
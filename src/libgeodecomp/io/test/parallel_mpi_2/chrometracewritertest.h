@@ -0,0 +1,99 @@
+#include <libgeodecomp/io/chrometracewriter.h>
+#include <libgeodecomp/io/testinitializer.h>
+#include <libgeodecomp/loadbalancer/noopbalancer.h>
+#include <libgeodecomp/misc/eventtracer.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/parallelization/stripingsimulator.h>
+#include <libgeodecomp/storage/grid.h>
+
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class ChromeTraceWriterTest : public CxxTest::TestSuite
+{
+public:
+
+    void setUp()
+    {
+        filename = "chrometracewritertest.json";
+        EventTracer::reset();
+    }
+
+    void tearDown()
+    {
+        EventTracer::disable();
+        EventTracer::reset();
+        if (MPILayer().rank() == 0) {
+            unlink(filename.c_str());
+        }
+    }
+
+    void testMergedTrace()
+    {
+        StripingSimulator<TestCell<2> > simulator(
+            new TestInitializer<TestCell<2> >(),
+            MPILayer().rank() ? 0 : new NoOpBalancer());
+        simulator.addWriter(new ChromeTraceWriter<TestCell<2> >(filename));
+        simulator.run();
+
+        MPILayer().barrier();
+        if (MPILayer().rank() != 0) {
+            return;
+        }
+
+        std::ifstream file(filename.c_str());
+        TS_ASSERT(file.good());
+        std::stringstream buf;
+        buf << file.rdbuf();
+        std::string trace = buf.str();
+
+        TS_ASSERT_EQUALS(0, trace.find("{\"traceEvents\":["));
+        TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"displayTimeUnit\":\"ms\"}"));
+
+        if (EventTracer::compiledIn()) {
+            TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"args\":{\"name\":\"rank 0\"}"));
+            TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"args\":{\"name\":\"rank 1\"}"));
+            TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"ph\":\"X\""));
+        }
+    }
+
+    void testCustomCommunicator()
+    {
+        // each rank forms a communicator of its own, so gathering the
+        // traces via MPI_COMM_WORLD would mix up the two runs:
+        MPI_Comm comm;
+        MPI_Comm_split(MPI_COMM_WORLD, MPILayer().rank(), 0, &comm);
+
+        std::stringstream buf;
+        buf << "chrometracewritertest_" << MPILayer().rank() << ".json";
+        std::string soloFilename = buf.str();
+
+        ChromeTraceWriter<TestCell<2> > writer(soloFilename, 1, EventTracer::DEFAULT_BUFFER_SIZE, comm);
+        Grid<TestCell<2> > grid(Coord<2>(10, 5));
+        Region<2> region;
+        region << grid.boundingBox();
+
+        writer.stepFinished(grid, region, grid.getDimensions(), 0, WRITER_INITIALIZED, 0, true);
+        writer.stepFinished(grid, region, grid.getDimensions(), 1, WRITER_ALL_DONE,    0, true);
+
+        std::ifstream file(soloFilename.c_str());
+        TS_ASSERT(file.good());
+        std::stringstream trace;
+        trace << file.rdbuf();
+        TS_ASSERT_EQUALS(0, trace.str().find("{\"traceEvents\":["));
+
+        unlink(soloFilename.c_str());
+        MPI_Comm_free(&comm);
+    }
+
+private:
+    std::string filename;
+};
+
+}
@@ -8,7 +8,7 @@
 #include <libgeodecomp/loadbalancer/noopbalancer.h>
 #include <libgeodecomp/parallelization/stripingsimulator.h>
 
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
 
 #include <libgeodecomp/io/remotesteerer.h>
 #include <libgeodecomp/io/remotesteerer/interactor.h>
@@ -24,7 +24,7 @@ DEFINE_DATAACCESSOR(TestValueAccessor, TestCell<2>, double, testValue);
 class RemoteSteererTest : public CxxTest::TestSuite
 {
 public:
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
     class FlushAction : public Action<TestCell<2> >
     {
     public:
@@ -95,7 +95,7 @@ public:
 
     void setUp()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         mpiLayer.reset(new MPILayer());
         unsigned steererPeriod = 3;
         unsigned writerPeriod = 2;
@@ -118,7 +118,7 @@ public:
 
     void tearDown()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         sim.reset();
         mpiLayer.reset();
 #endif
@@ -126,7 +126,7 @@ public:
 
     void testBasic()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new FlushAction);
             StringVec feedback = steerer->sendCommandWithFeedback("flush 1234 9", 1);
@@ -159,7 +159,7 @@ public:
 
     void testNonExistentAction()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             StringVec res;
             res = steerer->sendCommandWithFeedback("nonExistentAction  1 2 3", 2);
@@ -174,7 +174,7 @@ public:
 
     void testInvalidHandler()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         SharedPtr<Interactor>::Type interactor;
 
         if (mpiLayer->rank() == 0) {
@@ -205,7 +205,7 @@ public:
 
     void testHandlerNotFound1()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new PassThroughAction<TestCell<2> >("echo", "blah"));
         }
@@ -238,7 +238,7 @@ public:
 
     void testHandlerNotFound2()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new PassThroughAction<TestCell<2> >("echo", "blah"));
         }
@@ -271,7 +271,7 @@ public:
 
     void testHandlerNotFound3()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new PassThroughAction<TestCell<2> >("echo", "blah"));
         }
@@ -303,7 +303,7 @@ public:
 
     void testGetSet()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         steerer->addDataAccessor(new TestValueAccessor());
         SharedPtr<Interactor>::Type interactor;
         mpiLayer->barrier();
@@ -330,7 +330,7 @@ public:
     }
 
 private:
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
     SharedPtr<MPILayer>::Type mpiLayer;
     SharedPtr<StripingSimulator<TestCell<2> > >::Type sim;
     RemoteSteerer<TestCell<2> > *steerer;
@@ -0,0 +1,106 @@
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/io/steererconsensus.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class ConsensusTestCell
+{
+public:
+    class API : public APITraits::HasStaticData<double>
+    {};
+
+    static double staticData;
+};
+
+double ConsensusTestCell::staticData = 0;
+
+class SteererConsensusTest : public CxxTest::TestSuite
+{
+public:
+    typedef SteererConsensus<ConsensusTestCell> ConsensusType;
+    typedef ConsensusType::SteererFeedback SteererFeedback;
+
+    void setUp()
+    {
+        ConsensusTestCell::staticData = 0;
+    }
+
+    void testEndSimulation()
+    {
+        MPILayer mpiLayer;
+        ConsensusType consensus;
+        SteererFeedback feedback;
+        if (mpiLayer.rank() == 1) {
+            feedback.endSimulation();
+        }
+
+        consensus.start(10, &feedback);
+        TS_ASSERT(!feedback.simulationEnded());
+        TS_ASSERT(consensus.hasPendingRound());
+
+        TS_ASSERT(!consensus.poll(10));
+        TS_ASSERT(!consensus.simulationEnded());
+        TS_ASSERT(consensus.poll(11));
+        TS_ASSERT(consensus.simulationEnded());
+        TS_ASSERT(!consensus.hasPendingRound());
+        TS_ASSERT_EQUALS(0, ConsensusTestCell::staticData);
+    }
+
+    void testStaticDataOfLowestRankWins()
+    {
+        MPILayer mpiLayer;
+        ConsensusType consensus(3);
+        SteererFeedback feedback;
+        if (mpiLayer.rank() > 0) {
+            feedback.setStaticData(10.0 * mpiLayer.rank());
+        }
+
+        consensus.start(20, &feedback);
+        TS_ASSERT(!feedback.hasStaticData());
+        TS_ASSERT(!consensus.poll(21));
+        TS_ASSERT(!consensus.poll(22));
+        // updates must not be applied before consensus was reached:
+        TS_ASSERT_EQUALS(0, ConsensusTestCell::staticData);
+
+        TS_ASSERT(consensus.poll(23));
+        TS_ASSERT_EQUALS(10.0, ConsensusTestCell::staticData);
+        TS_ASSERT(!consensus.simulationEnded());
+    }
+
+    void testNoFeedback()
+    {
+        ConsensusType consensus;
+        SteererFeedback feedback;
+
+        for (unsigned step = 0; step < 10; ++step) {
+            consensus.poll(step);
+            consensus.start(step, &feedback);
+        }
+        consensus.poll(10);
+
+        TS_ASSERT(!consensus.simulationEnded());
+        TS_ASSERT_EQUALS(0, ConsensusTestCell::staticData);
+    }
+
+    void testStartCompletesPendingRound()
+    {
+        MPILayer mpiLayer;
+        ConsensusType consensus(5);
+        SteererFeedback feedback;
+        if (mpiLayer.rank() == 0) {
+            feedback.setStaticData(47.11);
+        }
+
+        consensus.start(0, &feedback);
+        consensus.start(1, &feedback);
+        TS_ASSERT_EQUALS(47.11, ConsensusTestCell::staticData);
+        TS_ASSERT(!consensus.poll(5));
+        TS_ASSERT(consensus.poll(6));
+    }
+};
+
+}
@@ -1,5 +1,8 @@
 #include <libgeodecomp/io/initializer.h>
 #include <libgeodecomp/io/simpleinitializer.h>
+#include <libgeodecomp/io/testinitializer.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/storage/displacedgrid.h>
 
 using namespace LibGeoDecomp;
 
@@ -21,7 +24,11 @@ public:
     {}
 
     void grid(GridBase<DummyCell, 3> *grid)
-    {}
+    {
+        ++gridCalls;
+    }
+
+    int gridCalls = 0;
 };
 
 class InitializerTest : public CxxTest::TestSuite
@@ -30,6 +37,40 @@ public:
 
     std::vector<std::string> files;
 
+    void testInitGridsFallback()
+    {
+        DummyInitializer init;
+        Grid<DummyCell, Topologies::Torus<3>::Topology> gridA(Coord<3>(4, 3, 2));
+        Grid<DummyCell, Topologies::Torus<3>::Topology> gridB(Coord<3>(4, 3, 2));
+
+        TS_ASSERT(!init.supportsStreakInit());
+        init.initGrids(&gridA, &gridB);
+        TS_ASSERT_EQUALS(2, init.gridCalls);
+
+        init.initGrids(&gridA);
+        TS_ASSERT_EQUALS(3, init.gridCalls);
+    }
+
+    void testInitGridsStreakWise()
+    {
+        typedef DisplacedGrid<TestCell<3>, Topologies::Torus<3>::Topology> GridType;
+        TestInitializer<TestCell<3> > init(Coord<3>(20, 10, 5));
+        CoordBox<3> box(Coord<3>(-1, 2, -1), Coord<3>(22, 5, 4));
+
+        GridType expected(box);
+        GridType actualA(box);
+        GridType actualB(box);
+        init.grid(&expected);
+
+        TS_ASSERT(init.supportsStreakInit());
+        init.initGrids(&actualA, &actualB);
+
+        TS_ASSERT_EQUALS(expected, actualA);
+        TS_ASSERT_EQUALS(expected, actualB);
+        TS_ASSERT_EQUALS(expected.getEdge(), actualA.getEdge());
+        TS_ASSERT_EQUALS(expected.getEdge(), actualB.getEdge());
+    }
+
     void testSeedRNG()
     {
         DummyInitializer init;
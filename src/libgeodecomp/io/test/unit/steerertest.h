@@ -92,6 +92,39 @@ public:
         TS_ASSERT_EQUALS(666 + 34 + 1, MyTestCell::staticData);
     }
 
+    void testFeedbackDefersStaticData()
+    {
+        MyTestCell::staticData = 0;
+        SteererType::SteererFeedback feedback;
+        feedback.setStaticData(4711);
+        TS_ASSERT(feedback.hasStaticData());
+        TS_ASSERT_EQUALS(0, MyTestCell::staticData);
+
+        feedback.applyStaticData();
+        TS_ASSERT(!feedback.hasStaticData());
+        TS_ASSERT_EQUALS(4711, MyTestCell::staticData);
+        MyTestCell::staticData = 0;
+    }
+
+    void testFeedbackMerge()
+    {
+        SteererType::SteererFeedback a;
+        SteererType::SteererFeedback b;
+        SteererType::SteererFeedback c;
+        a.setStaticData(1);
+        b.endSimulation();
+        c.setStaticData(2);
+
+        a.merge(b);
+        TS_ASSERT(a.simulationEnded());
+        TS_ASSERT_EQUALS(1, a.getStaticData());
+
+        b.merge(c);
+        TS_ASSERT(b.simulationEnded());
+        TS_ASSERT(b.hasStaticData());
+        TS_ASSERT_EQUALS(2, b.getStaticData());
+    }
+
 private:
     SharedPtr<SerialSimulator<MyTestCell> >::Type simulator;
 };
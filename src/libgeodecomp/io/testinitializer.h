@@ -29,18 +29,33 @@ public:
 
     virtual void grid(GridBase<TEST_CELL, DIM> *ret)
     {
-        CoordBox<DIM> rect = ret->boundingBox();
-        unsigned cycle = startStep() * NANO_STEPS;
+        Region<DIM> region;
+        region << ret->boundingBox();
+        typename Initializer<TEST_CELL>::StreakInitVisitor visitor(this, 0);
+        ret->visit(region, &visitor);
+
+        ret->setEdge(edgeCell());
+    }
 
-        for (typename CoordBox<DIM>::Iterator i = rect.begin(); i != rect.end(); ++i) {
-            Coord<DIM> coord = Topology::normalize(*i, dimensions);
-            double index = 1 + coord.toIndex(dimensions);
-            ret->set(*i, TEST_CELL(coord, dimensions, cycle, index));
+    virtual bool supportsStreakInit() const
+    {
+        return true;
+    }
+
+    virtual void initStreak(const Streak<DIM>& streak, TEST_CELL *target)
+    {
+        unsigned cycle = startStep() * NANO_STEPS;
+        for (Coord<DIM> c = streak.origin; c.x() < streak.endX; ++c.x()) {
+            *target = cell(c, cycle);
+            ++target;
         }
+    }
 
-        TEST_CELL edgeCell(Coord<DIM>::diagonal(-1), dimensions);
-        edgeCell.isEdgeCell = true;
-        ret->setEdge(edgeCell);
+    virtual TEST_CELL edgeCell() const
+    {
+        TEST_CELL ret(Coord<DIM>::diagonal(-1), dimensions);
+        ret.isEdgeCell = true;
+        return ret;
     }
 
     Coord<DIM> gridDimensions() const
@@ -63,6 +78,13 @@ private:
     unsigned maximumSteps;
     unsigned step1;
 
+    TEST_CELL cell(const Coord<DIM>& rawCoord, unsigned cycle) const
+    {
+        Coord<DIM> coord = Topology::normalize(rawCoord, dimensions);
+        double index = 1 + coord.toIndex(dimensions);
+        return TEST_CELL(coord, dimensions, cycle, index);
+    }
+
     static Coord<2> defaultDimensions(const Coord<2>&)
     {
         return Coord<2>(17, 12);
@@ -80,17 +80,33 @@ public:
             return;
         }
 
-        for (typename Region<DIM>::Iterator i = validRegion.begin();
-             i != validRegion.end();
-             ++i) {
-            TestCell<DIM> cell = grid->get(*i);
-            cell.cycleCounter += cycleOffset;
-            grid->set(*i, cell);
-        }
+        CycleOffsetVisitor visitor(cycleOffset);
+        grid->visit(validRegion, &visitor);
     }
 
 
 private:
+    /**
+     * Advances the cycleCounter of all visited cells.
+     */
+    class CycleOffsetVisitor : public GridVisitor<TestCell<DIM>, DIM>
+    {
+    public:
+        explicit CycleOffsetVisitor(unsigned cycleOffset) :
+            cycleOffset(cycleOffset)
+        {}
+
+        virtual void visit(const Streak<DIM>& streak, TestCell<DIM> *cells)
+        {
+            for (int i = 0; i < streak.length(); ++i) {
+                cells[i].cycleCounter += cycleOffset;
+            }
+        }
+
+    private:
+        unsigned cycleOffset;
+    };
+
     unsigned eventStep;
     unsigned cycleOffset;
     unsigned terminalStep;
@@ -1,13 +1,16 @@
 #ifndef LIBGEODECOMP_IO_TRACINGWRITER_H
 #define LIBGEODECOMP_IO_TRACINGWRITER_H
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
 #include <libgeodecomp/io/parallelwriter.h>
 #include <libgeodecomp/io/timestringconversion.h>
 #include <libgeodecomp/io/writer.h>
+#include <libgeodecomp/misc/chronometer.h>
 #include <libgeodecomp/misc/clonable.h>
+#include <libgeodecomp/misc/perfcounters.h>
 #include <libgeodecomp/misc/scopedtimer.h>
 
 namespace LibGeoDecomp {
@@ -22,6 +25,14 @@ namespace LibGeoDecomp {
  * which allows the user to gauge execution time (current, remaining,
  * estimated time of arrival (ETA)) and performance (GLUPS, memory
  * bandwidth).
+ *
+ * If LibGeoDecomp was built with WITH_PERF_COUNTERS and
+ * perfCounters is set, then the TracingWriter will enable the
+ * PerfCounters (for the whole process) and additionally report the
+ * counts of all TimeCompute phases of this process since the
+ * last output (instructions per cycle, LLC misses per update and the
+ * resulting memory bandwidth), which tells whether the stepper is
+ * compute or memory bound.
  */
 template<typename CELL_TYPE>
 class TracingWriter :
@@ -44,14 +55,19 @@ public:
         const unsigned period = 1,
         const unsigned maxSteps = 1,
         int outputRank = OUTPUT_ON_ALL_RANKS,
-        std::ostream& stream = std::cerr) :
+        std::ostream& stream = std::cerr,
+        bool perfCounters = false) :
         Clonable<Writer<CELL_TYPE>, TracingWriter<CELL_TYPE> >("", period),
         Clonable<ParallelWriter<CELL_TYPE>, TracingWriter<CELL_TYPE> >("", period),
         outputRank(outputRank),
         stream(stream),
         lastStep(0),
         maxSteps(maxSteps)
-    {}
+    {
+        if (perfCounters) {
+            PerfCounters::enable();
+        }
+    }
 
 #ifdef LIBGEODECOMP_WITH_CPP14
     inline TracingWriter(const TracingWriter& other) = default;
@@ -83,6 +99,9 @@ private:
     TimeType startTime;
     unsigned lastStep;
     unsigned maxSteps;
+    TimeType lastTime;
+    double lastUpdates;
+    double lastCounters[PerfCounters::NUM_COUNTERS];
 
     void stepFinished(unsigned step, const Coord<DIM>& globalDimensions, WriterEvent event)
     {
@@ -91,6 +110,9 @@ private:
         switch (event) {
         case WRITER_INITIALIZED:
             startTime = currentTime();
+            lastTime = startTime;
+            lastUpdates = 0;
+            sampleCounters(lastCounters);
             stream << "TracingWriter::initialized()\n";
             printTime();
             lastStep = step;
@@ -133,9 +155,41 @@ private:
                << TimeStringConversion::renderDuration(eta) << "\n"
                << "  speed: " << glups << " GLUPS\n"
                << "  effective memory bandwidth " << bandwidth << " GB/s\n";
+        printCounters(now, updates);
         printTime();
     }
 
+    void printCounters(TimeType now, double updates)
+    {
+        if (!PerfCounters::enabled()) {
+            return;
+        }
+
+        double counters[PerfCounters::NUM_COUNTERS];
+        sampleCounters(counters);
+        for (std::size_t i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {
+            std::swap(counters[i], lastCounters[i]);
+            counters[i] = lastCounters[i] - counters[i];
+        }
+
+        double deltaUpdates = updates - lastUpdates;
+        stream << "  compute: " << PerfCounters::describe(now - lastTime, counters) << "\n";
+        if ((counters[PerfCounters::CYCLES] > 0) && (deltaUpdates > 0)) {
+            stream << "  LLC misses per update: "
+                   << (counters[PerfCounters::LLC_MISSES] / deltaUpdates) << "\n";
+        }
+
+        lastTime = now;
+        lastUpdates = updates;
+    }
+
+    void sampleCounters(double *counters) const
+    {
+        for (std::size_t i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {
+            counters[i] = PerfCounters::phaseCounter<TimeCompute>(i);
+        }
+    }
+
     void printTime() const
     {
         stream << "  time: " << TimeStringConversion::renderDuration(currentTime()) << "\n";
@@ -30,34 +30,9 @@ public:
 
     virtual void grid(GridBase<TEST_CELL, 1> *ret)
     {
-        int cycle = NANO_STEPS * firstStep;
-        Region<1> boundingRegion = ret->boundingRegion();
         typename GridBase<TEST_CELL, 1>::SparseMatrix weights;
-
-        for (Region<1>::Iterator i = boundingRegion.begin(); i != boundingRegion.end(); ++i) {
-            TEST_CELL cell(i->x(), cycle, true);
-
-            int startNeighbors = i->x() + 1;
-            int numNeighbors   = i->x() % maxNeighbors + 1;
-            int endNeighbors   = startNeighbors + numNeighbors;
-
-            // we need to insert ID/weight pairs here so can retrieve them sorted by ID below:
-            std::map<int, double> weightsReorderBuffer;
-
-            for (int j = startNeighbors; j != endNeighbors; ++j) {
-                int actualNeighbor = j % dim;
-                double edgeWeight = actualNeighbor + 0.1;
-
-                weightsReorderBuffer[actualNeighbor] = edgeWeight;
-                weights << std::make_pair(Coord<2>(i->x(), actualNeighbor), edgeWeight);
-            }
-
-            for (std::map<int, double>::iterator j = weightsReorderBuffer.begin(); j != weightsReorderBuffer.end(); ++j) {
-                cell.expectedNeighborWeights << j->second;
-            }
-
-            ret->set(*i, cell);
-        }
+        InitVisitor visitor(this, &weights);
+        ret->visit(ret->boundingRegion(), &visitor);
 
         ret->setWeights(0, weights);
 
@@ -119,10 +94,63 @@ public:
     }
 
 private:
+    typedef typename GridBase<TEST_CELL, 1>::SparseMatrix SparseMatrix;
+
+    /**
+     * Sets up cells in place and records their edge weights.
+     */
+    class InitVisitor : public GridVisitor<TEST_CELL, 1>
+    {
+    public:
+        InitVisitor(const UnstructuredTestInitializer *initializer, SparseMatrix *weights) :
+            initializer(initializer),
+            weights(weights)
+        {}
+
+        virtual void visit(const Streak<1>& streak, TEST_CELL *cells)
+        {
+            for (int i = streak.origin.x(); i < streak.endX; ++i) {
+                *cells = initializer->cell(i, weights);
+                ++cells;
+            }
+        }
+
+    private:
+        const UnstructuredTestInitializer *initializer;
+        SparseMatrix *weights;
+    };
+
     int dim;
     unsigned lastStep;
     unsigned firstStep;
     unsigned maxNeighbors;
+
+    TEST_CELL cell(int id, SparseMatrix *weights) const
+    {
+        int cycle = NANO_STEPS * firstStep;
+        TEST_CELL cell(id, cycle, true);
+
+        int startNeighbors = id + 1;
+        int numNeighbors   = id % maxNeighbors + 1;
+        int endNeighbors   = startNeighbors + numNeighbors;
+
+        // we need to insert ID/weight pairs here so can retrieve them sorted by ID below:
+        std::map<int, double> weightsReorderBuffer;
+
+        for (int j = startNeighbors; j != endNeighbors; ++j) {
+            int actualNeighbor = j % dim;
+            double edgeWeight = actualNeighbor + 0.1;
+
+            weightsReorderBuffer[actualNeighbor] = edgeWeight;
+            *weights << std::make_pair(Coord<2>(id, actualNeighbor), edgeWeight);
+        }
+
+        for (std::map<int, double>::iterator j = weightsReorderBuffer.begin(); j != weightsReorderBuffer.end(); ++j) {
+            cell.expectedNeighborWeights << j->second;
+        }
+
+        return cell;
+    }
 };
 
 }
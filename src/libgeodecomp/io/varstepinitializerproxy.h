@@ -56,6 +56,21 @@ public:
         proxyObj->grid(target);
     }
 
+    virtual bool supportsStreakInit() const override
+    {
+        return proxyObj->supportsStreakInit();
+    }
+
+    virtual void initStreak(const Streak<DIM>& streak, CELL *target) override
+    {
+        proxyObj->initStreak(streak, target);
+    }
+
+    virtual CELL edgeCell() const override
+    {
+        return proxyObj->edgeCell();
+    }
+
     virtual Coord<DIM> gridDimensions() const override
     {
         return proxyObj->gridDimensions();
@@ -0,0 +1,72 @@
+#ifndef LIBGEODECOMP_LOADBALANCER_COSTBALANCER_H
+#define LIBGEODECOMP_LOADBALANCER_COSTBALANCER_H
+
+#include <libgeodecomp/geometry/partitions/costawarepartition.h>
+#include <libgeodecomp/loadbalancer/loadbalancer.h>
+#include <libgeodecomp/misc/sharedptr.h>
+
+namespace LibGeoDecomp {
+
+/**
+ * Feeds measured loads back into a CellCostMap and derives the new
+ * weights from it: each node's relative load is taken as the cost of
+ * the region it currently owns (see CellCostMap::calibrate()). As the
+ * weights are shares of the total cost, they are then simply
+ * distributed according to the ranks' speeds. Use this together with
+ * a CostAwarePartition<PARTITION> built from the same cost map.
+ *
+ * The weights passed to balance() need to be the partition's cost
+ * shares (CostAwarePartition::getCostShares()), not its cell counts
+ * (getWeights()): the owned regions are reconstructed from them.
+ * This only matches the partition in use if the map hasn't been
+ * modified otherwise (e.g. by a Stepper's cost sampling) since the
+ * partition was built.
+ *
+ * Unlike the other balancers, CostBalancer learns where the load
+ * lives, not just on which node, so it converges even if the cost
+ * per cell varies strongly within a node's region.
+ */
+template<typename PARTITION>
+class CostBalancer : public LoadBalancer
+{
+public:
+    const static int DIM = CostAwarePartition<PARTITION>::DIM;
+    typedef typename SharedPtr<CellCostMap<DIM> >::Type CostMapPtr;
+
+    inline explicit CostBalancer(
+        const CostMapPtr& costs,
+        const std::vector<double>& rankSpeeds = std::vector<double>()) :
+        costs(costs),
+        rankSpeeds(rankSpeeds)
+    {}
+
+    virtual WeightVec balance(const WeightVec& weights, const LoadVec& relativeLoads)
+    {
+        const CoordBox<DIM>& box = costs->boundingBox();
+        CostAwarePartition<PARTITION> partition(box.origin, box.dimensions, 0, weights, *costs);
+
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            costs->calibrate(partition.getRegion(i), relativeLoads[i]);
+        }
+
+        std::vector<double> speeds = rankSpeeds;
+        if (speeds.size() != weights.size()) {
+            speeds = std::vector<double>(weights.size(), 1.0);
+        }
+
+        return initialWeights(sum(weights), speeds);
+    }
+
+    inline const CellCostMap<DIM>& getCosts() const
+    {
+        return *costs;
+    }
+
+private:
+    CostMapPtr costs;
+    std::vector<double> rankSpeeds;
+};
+
+}
+
+#endif
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <libgeodecomp/io/logger.h>
@@ -5,8 +6,9 @@
 
 namespace LibGeoDecomp {
 
-OozeBalancer::OozeBalancer(double newLoadWeight) :
-    newLoadWeight(newLoadWeight)
+OozeBalancer::OozeBalancer(double newLoadWeight, std::size_t ranksPerNode) :
+    newLoadWeight(newLoadWeight),
+    ranksPerNode(ranksPerNode)
 {
     if (newLoadWeight < 0 || newLoadWeight > 1) {
         throw std::invalid_argument("bad loadWeight in OozeBalancer constructor");
@@ -18,7 +20,7 @@ OozeBalancer::LoadVec OozeBalancer::expectedOptimalDistribution(
     const OozeBalancer::WeightVec& weights,
     const OozeBalancer::LoadVec& relativeLoads) const
 {
-    unsigned n = weights.size();
+    std::size_t n = weights.size();
     // calculate approximate load share we want on each node
     double targetLoadPerNode = sum(relativeLoads) / n;
 
@@ -26,39 +28,37 @@ OozeBalancer::LoadVec OozeBalancer::expectedOptimalDistribution(
         return LoadVec(n, sum(weights)/ (double)n);
     }
 
+    // All items of one node have the same cost, so we don't need to
+    // keep track of them individually. Instead we consume each
+    // node's items as one segment. remItems stores the remaining
+    // number of items, which are still to be assigned, of the
+    // current segment.
     LoadVec ret(n, 0);
-    LoadVec loadPerItem;
-    for (unsigned i = 0; i < n; i++) {
-        if (weights[i]) {
-            LoadVec add(weights[i], relativeLoads[i] / weights[i]);
-            append(loadPerItem, add);
-        }
-    }
-    // stores the remaining fraction, which is still to be assigned,
-    // of each item.
-    LoadVec remFractPerItem(sum(weights), 1.0);
+    std::size_t segment = 0;
+    double remItems = weights.empty() ? 0 : weights[0];
 
     // now fill up one node after another so that each gets his
     // targeted share...
-    for (unsigned nodeC = 0; nodeC < n - 1; nodeC++) {
+    for (std::size_t nodeC = 0; nodeC < n - 1; nodeC++) {
         double remLoad = targetLoadPerNode;
 
-        for (unsigned itemC = 0; itemC < loadPerItem.size(); itemC++) {
-            // skip already assigned items
-            if (remFractPerItem[itemC] == 0) {
+        for (; segment < n; ++segment, remItems = (segment < n) ? weights[segment] : 0) {
+            // skip already assigned segments
+            if (remItems == 0) {
                 continue;
             }
 
             // can we assign the whole remainder?
-            double l = remFractPerItem[itemC] * loadPerItem[itemC];
+            double loadPerItem = relativeLoads[segment] / weights[segment];
+            double l = remItems * loadPerItem;
             if (l <= remLoad) {
-                ret[nodeC] += remFractPerItem[itemC];
-                remFractPerItem[itemC] = 0;
+                ret[nodeC] += remItems;
+                remItems = 0;
                 remLoad -= l;
             } else {
-                double consumedFract = remLoad / loadPerItem[itemC];
-                ret[nodeC] += consumedFract;
-                remFractPerItem[itemC] -= consumedFract;
+                double consumedItems = remLoad / loadPerItem;
+                ret[nodeC] += consumedItems;
+                remItems -= consumedItems;
                 remLoad = 0;
             }
 
@@ -70,7 +70,56 @@ OozeBalancer::LoadVec OozeBalancer::expectedOptimalDistribution(
     }
 
     // add remainder to last node
-    ret.back() += sum(remFractPerItem);
+    for (; segment < n; ++segment, remItems = (segment < n) ? weights[segment] : 0) {
+        ret.back() += remItems;
+    }
+
+    return ret;
+}
+
+
+OozeBalancer::LoadVec OozeBalancer::expectedHierarchicalDistribution(
+    const OozeBalancer::WeightVec& weights,
+    const OozeBalancer::LoadVec& relativeLoads) const
+{
+    std::size_t n = weights.size();
+    std::size_t numNodes = (n + ranksPerNode - 1) / ranksPerNode;
+    WeightVec nodeWeights(numNodes, 0);
+    LoadVec nodeLoads(numNodes, 0);
+    LoadVec ret(n);
+
+    // balance within each node...
+    for (std::size_t node = 0; node < numNodes; ++node) {
+        std::size_t begin = node * ranksPerNode;
+        std::size_t end = (std::min)(begin + ranksPerNode, n);
+
+        WeightVec localWeights(weights.begin() + begin, weights.begin() + end);
+        LoadVec localLoads(relativeLoads.begin() + begin, relativeLoads.begin() + end);
+        LoadVec localOptimum = expectedOptimalDistribution(localWeights, localLoads);
+        std::copy(localOptimum.begin(), localOptimum.end(), ret.begin() + begin);
+
+        // The last node may host fewer ranks, so we use the
+        // average load per rank to compare nodes. That is what
+        // we're trying to even out after all:
+        nodeWeights[node] = sum(localWeights);
+        nodeLoads[node] = sum(localLoads) / (end - begin);
+    }
+
+    // ...then across nodes and scale each node's ranks' shares
+    // accordingly:
+    LoadVec nodeOptimum = expectedOptimalDistribution(nodeWeights, nodeLoads);
+    for (std::size_t node = 0; node < numNodes; ++node) {
+        std::size_t begin = node * ranksPerNode;
+        std::size_t end = (std::min)(begin + ranksPerNode, n);
+
+        for (std::size_t i = begin; i < end; ++i) {
+            if (nodeWeights[node] == 0) {
+                ret[i] = nodeOptimum[node] / (end - begin);
+            } else {
+                ret[i] *= nodeOptimum[node] / nodeWeights[node];
+            }
+        }
+    }
 
     return ret;
 }
@@ -80,7 +129,9 @@ OozeBalancer::WeightVec OozeBalancer::balance(
     const OozeBalancer::WeightVec& weights,
     const OozeBalancer::LoadVec& relativeLoads)
 {
-    LoadVec expectedOptimal = expectedOptimalDistribution(weights, relativeLoads);
+    LoadVec expectedOptimal = ranksPerNode ?
+        expectedHierarchicalDistribution(weights, relativeLoads) :
+        expectedOptimalDistribution(weights, relativeLoads);
     LoadVec newLoads = linearCombo(weights, expectedOptimal);
 
     WeightVec ret = equalize(newLoads);
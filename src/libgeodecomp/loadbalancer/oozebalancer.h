@@ -24,6 +24,10 @@ namespace LibGeoDecomp {
  * distribution is derived but, to keep errors at bounds, the
  * OozeBalancer will return a weighted linear combination of the old
  * distribution (weights) and the new one is returned.
+ *
+ * Memory and time requirements only depend on the number of nodes,
+ * not on the number of items. Optionally the OozeBalancer can work
+ * hierarchically (see expectedHierarchicalDistribution()).
  */
 class HPX_COMPONENT_EXPORT OozeBalancer : public LoadBalancer
 {
@@ -39,8 +43,14 @@ public:
      * unfulfilled preconditions, see above) and vice versa. A
      * quotient of the Golden Ratio and Eulers Number is believed to
      * be optimal for most applications.
+     *
+     * If ranksPerNode is non-zero, then the balancer will assume
+     * that each group of ranksPerNode consecutive ranks shares a
+     * (physical) node and will balance hierarchically.
      */
-    explicit OozeBalancer(double newLoadWeight = GOLDEN_RATIO / EULERS_NUMBER);
+    explicit OozeBalancer(
+        double newLoadWeight = GOLDEN_RATIO / EULERS_NUMBER,
+        std::size_t ranksPerNode = 0);
 
     virtual WeightVec balance(const WeightVec& weights, const LoadVec& relativeLoads);
 
@@ -70,13 +80,30 @@ private:
      * \f]
      *
      * (\f$t\f$ is currently computed on node \f$a\f$.)
+     *
+     * As \f$f(t)\f$ is constant for all items of one node, we can
+     * process them in one go, which yields O(n) time and memory.
      */
     LoadVec expectedOptimalDistribution(
         const WeightVec& weights,
         const LoadVec& relativeLoads) const;
 
+    /**
+     * Same as expectedOptimalDistribution(), but first balances
+     * the ranks within each node, then the nodes. Each step only
+     * requires the loads of ranks of one node or the aggregated
+     * loads of all nodes, respectively. This keeps the number of
+     * ranks taking part in each decision low. Inter-node
+     * balancing scales the shares of all ranks within a node
+     * uniformly.
+     */
+    LoadVec expectedHierarchicalDistribution(
+        const WeightVec& weights,
+        const LoadVec& relativeLoads) const;
+
 private:
     double newLoadWeight;
+    std::size_t ranksPerNode;
 
     WeightVec equalize(const LoadVec& loads);
     LoadVec linearCombo(const WeightVec& oldLoads, const LoadVec& newLoads);
@@ -0,0 +1,155 @@
+#include <libgeodecomp/geometry/partitions/recursivebisectionpartition.h>
+#include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+#include <libgeodecomp/loadbalancer/costbalancer.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class CostBalancerTest : public CxxTest::TestSuite
+{
+public:
+    typedef LoadBalancer::WeightVec WeightVec;
+    typedef LoadBalancer::LoadVec LoadVec;
+
+    void setUp()
+    {
+        box = CoordBox<2>(Coord<2>(0, 0), Coord<2>(128, 64));
+
+        // the "real" costs are unknown to the balancer, there's a
+        // hotspot in the lower left corner:
+        actualCosts = CellCostMap<2>(box);
+        for (int y = 0; y < 20; ++y) {
+            for (int x = 0; x < 30; ++x) {
+                actualCosts.setCost(Coord<2>(x, y), 10.0);
+            }
+        }
+    }
+
+    void testConvergenceZCurve()
+    {
+        checkConvergence<ZCurvePartition<2> >(1.02);
+    }
+
+    void testConvergenceRecursiveBisection()
+    {
+        checkConvergence<RecursiveBisectionPartition<2> >(1.1);
+    }
+
+    void testRankSpeeds()
+    {
+        CostBalancer<ZCurvePartition<2> >::CostMapPtr costs(new CellCostMap<2>(box));
+        std::vector<double> speeds;
+        speeds << 1.0 << 3.0;
+        CostBalancer<ZCurvePartition<2> > balancer(costs, speeds);
+
+        WeightVec weights;
+        weights << 4096 << 4096;
+        LoadVec loads;
+        loads << 1.0 << 1.0;
+
+        WeightVec expected;
+        expected << 2048 << 6144;
+        TS_ASSERT_EQUALS(expected, balancer.balance(weights, loads));
+        TS_ASSERT_EQUALS(2.0, costs->totalCost());
+    }
+
+    void testCalibratesRegionsOfPartitionInUse()
+    {
+        const int numNodes = 4;
+        typedef ZCurvePartition<2> PartitionType;
+
+        // the balancer's map knows the hotspot, but underestimates it:
+        CostBalancer<PartitionType>::CostMapPtr costs(new CellCostMap<2>(box));
+        for (int y = 0; y < 20; ++y) {
+            for (int x = 0; x < 30; ++x) {
+                costs->setCost(Coord<2>(x, y), 4.0);
+            }
+        }
+        CostBalancer<PartitionType> balancer(costs);
+
+        WeightVec shares = LoadBalancer::initialWeights(
+            box.dimensions.prod(),
+            std::vector<double>(numNodes, 1.0));
+        CostAwarePartition<PartitionType> partition(
+            box.origin, box.dimensions, 0, shares, *costs);
+        TS_ASSERT_DIFFERS(shares, partition.getWeights());
+
+        LoadVec loads = relativeLoads(partition, numNodes);
+        double imbalanceBefore = max(loads) / (sum(loads) / numNodes);
+
+        shares = balancer.balance(partition.getCostShares(), loads);
+
+        // the measured loads need to end up in the regions which
+        // were actually measured:
+        for (int i = 0; i < numNodes; ++i) {
+            TS_ASSERT_DELTA(loads[i], costs->totalCost(partition.getRegion(i)), 1e-9);
+        }
+
+        CostAwarePartition<PartitionType> newPartition(
+            box.origin, box.dimensions, 0, shares, *costs);
+        loads = relativeLoads(newPartition, numNodes);
+        double imbalanceAfter = max(loads) / (sum(loads) / numNodes);
+        TS_ASSERT(imbalanceAfter < imbalanceBefore);
+    }
+
+private:
+    CoordBox<2> box;
+    CellCostMap<2> actualCosts;
+
+    template<typename PARTITION>
+    void checkConvergence(double maxImbalance)
+    {
+        const int numNodes = 6;
+        typename CostBalancer<PARTITION>::CostMapPtr costs(new CellCostMap<2>(box));
+        CostBalancer<PARTITION> balancer(costs);
+
+        WeightVec weights = LoadBalancer::initialWeights(
+            box.dimensions.prod(),
+            std::vector<double>(numNodes, 1.0));
+
+        double initialImbalance = 0;
+        double lastImbalance = 0;
+
+        for (int i = 0; i < 20; ++i) {
+            CostAwarePartition<PARTITION> partition(
+                box.origin, box.dimensions, 0, weights, balancer.getCosts());
+            LoadVec loads = relativeLoads(partition, numNodes);
+            lastImbalance = max(loads) / (sum(loads) / numNodes);
+            if (i == 0) {
+                initialImbalance = lastImbalance;
+            }
+
+            weights = balancer.balance(weights, loads);
+            TS_ASSERT_EQUALS(box.dimensions.prod(), sum(weights));
+        }
+
+        TS_ASSERT(initialImbalance > 2.0);
+        TS_ASSERT(lastImbalance < maxImbalance);
+    }
+
+    /**
+     * assumes that all nodes are equally fast and synchronize after
+     * each step, so each node's ratio of work to wall clock time is
+     * its load divided by the maximum load.
+     */
+    template<typename PARTITION>
+    LoadVec relativeLoads(const PARTITION& partition, int numNodes)
+    {
+        LoadVec loads;
+        for (int i = 0; i < numNodes; ++i) {
+            loads << actualCosts.totalCost(partition.getRegion(i));
+        }
+
+        double maxLoad = max(loads);
+        for (int i = 0; i < numNodes; ++i) {
+            loads[i] /= maxLoad;
+        }
+
+        return loads;
+    }
+};
+
+}
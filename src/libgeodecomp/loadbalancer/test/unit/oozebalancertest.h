@@ -3,6 +3,7 @@
 #include <libgeodecomp/misc/testhelper.h>
 #include <libgeodecomp/loadbalancer/mockbalancer.h>
 #include <libgeodecomp/loadbalancer/oozebalancer.h>
+#include <libgeodecomp/misc/random.h>
 
 using namespace LibGeoDecomp;
 
@@ -110,6 +111,176 @@ public:
 
         checkExpectedOptimalDistribution(expected, loads, relLoads);
     }
+
+    void testMatchesItemwiseDistribution()
+    {
+        Random::seed(1234);
+        OozeBalancer b;
+
+        for (int round = 0; round < 100; ++round) {
+            std::size_t n = 1 + Random::genUnsigned(12);
+            OozeBalancer::WeightVec loads(n);
+            OozeBalancer::LoadVec relLoads(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                // some nodes shall be empty or idle:
+                loads[i] = (Random::genUnsigned(4) == 0) ? 0 : Random::genUnsigned(200);
+                relLoads[i] = (Random::genUnsigned(4) == 0) ? 0 : Random::genDouble(5.0);
+                if (loads[i] == 0) {
+                    relLoads[i] = 0;
+                }
+            }
+
+            OozeBalancer::LoadVec expected = itemwiseDistribution(loads, relLoads);
+            OozeBalancer::LoadVec actual = b.expectedOptimalDistribution(loads, relLoads);
+
+            TS_ASSERT_EQUALS(expected.size(), actual.size());
+            for (std::size_t i = 0; i < (std::min)(expected.size(), actual.size()); ++i) {
+                TS_ASSERT_DELTA(expected[i], actual[i], 1e-6);
+            }
+        }
+    }
+
+    void testHugeDomain()
+    {
+        // 10^13 items would have required 160 TB for the itemwise
+        // algorithm:
+        OozeBalancer::WeightVec loads(4, 2500000000000ULL);
+        OozeBalancer::LoadVec relLoads(4);
+        relLoads[0] = 1.0;
+        relLoads[1] = 1.0;
+        relLoads[2] = 3.0;
+        relLoads[3] = 3.0;
+
+        OozeBalancer b(0.5);
+        OozeBalancer::LoadVec actual = b.expectedOptimalDistribution(loads, relLoads);
+        TS_ASSERT_DELTA(5e12,        actual[0], 1);
+        TS_ASSERT_DELTA(5e12 / 3,    actual[1], 1);
+        TS_ASSERT_DELTA(5e12 / 3,    actual[2], 1);
+        TS_ASSERT_DELTA(5e12 / 3,    actual[3], 1);
+
+        OozeBalancer::WeightVec newLoads = b.balance(loads, relLoads);
+        TS_ASSERT_EQUALS(sum(loads), sum(newLoads));
+    }
+
+    void testHierarchicalDegeneratesToFlat()
+    {
+        OozeBalancer::WeightVec loads(4);
+        loads[0] = 2;
+        loads[1] = 2;
+        loads[2] = 3;
+        loads[3] = 2;
+
+        OozeBalancer::LoadVec relLoads(4);
+        relLoads[0] = 0.13;
+        relLoads[1] = 5.0;
+        relLoads[2] = 0.21;
+        relLoads[3] = 0.1;
+
+        OozeBalancer::LoadVec expected = OozeBalancer().expectedOptimalDistribution(loads, relLoads);
+
+        // one rank per node or all ranks on one node are just flat
+        // balancing on different levels:
+        TS_ASSERT_EQUALS_DOUBLE_VEC(
+            expected,
+            OozeBalancer(0.5, 1).expectedHierarchicalDistribution(loads, relLoads));
+        TS_ASSERT_EQUALS_DOUBLE_VEC(
+            expected,
+            OozeBalancer(0.5, 4).expectedHierarchicalDistribution(loads, relLoads));
+    }
+
+    void testHierarchical()
+    {
+        OozeBalancer::WeightVec loads(5);
+        loads[0] = 10;
+        loads[1] = 30;
+        loads[2] = 20;
+        loads[3] = 20;
+        loads[4] = 40;
+
+        OozeBalancer::LoadVec relLoads(5);
+        relLoads[0] = 1.0;
+        relLoads[1] = 1.0;
+        relLoads[2] = 2.0;
+        relLoads[3] = 4.0;
+        relLoads[4] = 2.0;
+
+        // nodes {0, 1}, {2, 3} and {4} carry average loads of 1, 3
+        // and 2, so each should end up with 2. Hence node 0 receives
+        // a third of node 1's items, which then has exactly the
+        // right load:
+        double node0 = 40 + 40.0 / 3;
+        double node1 = 80.0 / 3;
+        double node2 = 40;
+
+        // within node 0 the load is already balanced, within node 1
+        // rank 2 should get 5 items from rank 3. These shares are then
+        // scaled to the node's new number of items:
+        OozeBalancer::LoadVec expected(5);
+        expected[0] = 10 * node0 / 40;
+        expected[1] = 30 * node0 / 40;
+        expected[2] = 25 * node1 / 40;
+        expected[3] = 15 * node1 / 40;
+        expected[4] = node2;
+
+        OozeBalancer b(0.5, 2);
+        OozeBalancer::LoadVec actual = b.expectedHierarchicalDistribution(loads, relLoads);
+        TS_ASSERT_EQUALS_DOUBLE_VEC(expected, actual);
+        TS_ASSERT_DELTA(120, sum(actual), 1e-9);
+    }
+
+private:
+    /**
+     * The original algorithm, which assigns items one by one.
+     */
+    OozeBalancer::LoadVec itemwiseDistribution(
+        const OozeBalancer::WeightVec& weights,
+        const OozeBalancer::LoadVec& relativeLoads)
+    {
+        unsigned n = weights.size();
+        double targetLoadPerNode = sum(relativeLoads) / n;
+        if (targetLoadPerNode == 0) {
+            return OozeBalancer::LoadVec(n, sum(weights)/ (double)n);
+        }
+
+        OozeBalancer::LoadVec ret(n, 0);
+        OozeBalancer::LoadVec loadPerItem;
+        for (unsigned i = 0; i < n; i++) {
+            if (weights[i]) {
+                OozeBalancer::LoadVec add(weights[i], relativeLoads[i] / weights[i]);
+                append(loadPerItem, add);
+            }
+        }
+        OozeBalancer::LoadVec remFractPerItem(sum(weights), 1.0);
+
+        for (unsigned nodeC = 0; nodeC < n - 1; nodeC++) {
+            double remLoad = targetLoadPerNode;
+
+            for (unsigned itemC = 0; itemC < loadPerItem.size(); itemC++) {
+                if (remFractPerItem[itemC] == 0) {
+                    continue;
+                }
+
+                double l = remFractPerItem[itemC] * loadPerItem[itemC];
+                if (l <= remLoad) {
+                    ret[nodeC] += remFractPerItem[itemC];
+                    remFractPerItem[itemC] = 0;
+                    remLoad -= l;
+                } else {
+                    double consumedFract = remLoad / loadPerItem[itemC];
+                    ret[nodeC] += consumedFract;
+                    remFractPerItem[itemC] -= consumedFract;
+                    remLoad = 0;
+                }
+
+                if (remLoad == 0) {
+                    break;
+                }
+            }
+        }
+
+        ret.back() += sum(remFractPerItem);
+        return ret;
+    }
 };
 
 
@@ -272,6 +443,31 @@ public:
         OozeBalancer::WeightVec loads(5, 100);
         TS_ASSERT_EQUALS(loads, OozeBalancer().balance(loads, OozeBalancer::LoadVec(5, 0)));
     }
+
+    void testHierarchicalConvergence()
+    {
+        OozeBalancer::WeightVec startLoads(5, 0);
+        startLoads[0] = 1500;
+
+        OozeBalancer b(GOLDEN_RATIO / EULERS_NUMBER, 2);
+        OozeBalancer::WeightVec oldLoads = startLoads;
+        OozeBalancer::WeightVec newLoads;
+        OozeBalancer::LoadVec itemLoads = itemLoads1();
+        OozeBalancer::LoadVec nodeSpeeds = nodeSpeeds1();
+
+        for (int i = 0; i < 64; i++) {
+            OozeBalancer::LoadVec relLoads = calcRelLoads(oldLoads, itemLoads, nodeSpeeds);
+            newLoads = b.balance(oldLoads, relLoads);
+            checkBoundaryConditions(newLoads, oldLoads);
+            oldLoads = newLoads;
+        }
+
+        double targetLoadPerNode = sum(itemLoads) / sum(nodeSpeeds);
+        OozeBalancer::LoadVec relLoads = calcRelLoads(newLoads, itemLoads, nodeSpeeds);
+        for (unsigned i = 0; i < relLoads.size(); i++) {
+            TS_ASSERT_DELTA(targetLoadPerNode, relLoads[i], targetLoadPerNode * 0.05);
+        }
+    }
 };
 
 }
@@ -0,0 +1,71 @@
+#include <libgeodecomp/misc/allocationcounter.h>
+
+#ifdef LIBGEODECOMP_WITH_ALLOCATION_TRACKING
+
+#include <atomic>
+
+namespace LibGeoDecomp {
+
+namespace AllocationCounterHelpers {
+
+std::atomic<std::size_t> totalAllocations(0);
+std::atomic<std::size_t> phaseAllocations[AllocationCounter::MAX_PHASES];
+
+}
+
+std::size_t AllocationCounter::allocations()
+{
+    return AllocationCounterHelpers::totalAllocations;
+}
+
+std::size_t AllocationCounter::phaseAllocations(std::size_t id)
+{
+    return AllocationCounterHelpers::phaseAllocations[id];
+}
+
+void AllocationCounter::addPhaseAllocations(std::size_t id, std::size_t allocations)
+{
+    AllocationCounterHelpers::phaseAllocations[id] += allocations;
+}
+
+void AllocationCounter::countAllocation()
+{
+    ++AllocationCounterHelpers::totalAllocations;
+}
+
+void AllocationCounter::reset()
+{
+    AllocationCounterHelpers::totalAllocations = 0;
+    for (std::size_t i = 0; i < MAX_PHASES; ++i) {
+        AllocationCounterHelpers::phaseAllocations[i] = 0;
+    }
+}
+
+}
+
+#else
+
+namespace LibGeoDecomp {
+
+std::size_t AllocationCounter::allocations()
+{
+    return 0;
+}
+
+std::size_t AllocationCounter::phaseAllocations(std::size_t /* id */)
+{
+    return 0;
+}
+
+void AllocationCounter::addPhaseAllocations(std::size_t /* id */, std::size_t /* allocations */)
+{}
+
+void AllocationCounter::countAllocation()
+{}
+
+void AllocationCounter::reset()
+{}
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef LIBGEODECOMP_MISC_ALLOCATIONCOUNTER_H
+#define LIBGEODECOMP_MISC_ALLOCATIONCOUNTER_H
+
+#include <libgeodecomp/config.h>
+
+#include <cstddef>
+
+namespace LibGeoDecomp {
+
+/**
+ * Debugging aid for hunting down heap allocations in the time loop:
+ * if LibGeoDecomp was configured with WITH_ALLOCATION_TRACKING, then
+ * executables linked against the static library
+ * geodecomp_allocationtracking (e.g. the unit tests) get a global
+ * operator new which counts all allocations. libgeodecomp itself
+ * leaves operator new alone. Chronometer will then attribute these
+ * to the phases (e.g. TimeCompute or TimeCommunication) in which
+ * they occurred, so that tests can assert that no allocations happen
+ * after the warmup of a simulation.
+ *
+ * Counts are process-wide: allocations from other threads will be
+ * attributed to any phase which is currently being timed. Without
+ * allocation tracking all counts remain 0.
+ */
+class AllocationCounter
+{
+public:
+    /**
+     * Upper limit for the number of events supported by Chronometer.
+     */
+    static const std::size_t MAX_PHASES = 20;
+
+    static bool enabled()
+    {
+#ifdef LIBGEODECOMP_WITH_ALLOCATION_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Total number of allocations since program start or the last
+     * call to reset().
+     */
+    static std::size_t allocations();
+
+    /**
+     * Number of allocations which occurred while the Chronometer
+     * event with the given ID was being timed.
+     */
+    static std::size_t phaseAllocations(std::size_t id);
+
+    template<typename EVENT>
+    static std::size_t phaseAllocations()
+    {
+        return phaseAllocations(EVENT::ID);
+    }
+
+    static void addPhaseAllocations(std::size_t id, std::size_t allocations);
+
+    static void countAllocation();
+
+    /**
+     * Resets all counters to 0. Not thread-safe with regard to
+     * running Chronometer timers.
+     */
+    static void reset();
+};
+
+}
+
+#endif
@@ -0,0 +1,220 @@
+#include <libgeodecomp/misc/allocationcounter.h>
+
+#ifdef LIBGEODECOMP_WITH_ALLOCATION_TRACKING
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Replacements of the global operator new/delete which feed
+// AllocationCounter. This file is deliberately not part of
+// libgeodecomp, but of the static library
+// geodecomp_allocationtracking, which only the unit tests link
+// against.
+
+namespace LibGeoDecomp {
+
+namespace AllocationTrackingHelpers {
+
+inline void *allocate(std::size_t size)
+{
+    AllocationCounter::countAllocation();
+
+    if (size == 0) {
+        size = 1;
+    }
+
+    for (;;) {
+        void *ret = std::malloc(size);
+        if (ret) {
+            return ret;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+#ifdef __cpp_aligned_new
+
+inline void *tryAllocateAligned(std::size_t size, std::size_t alignment)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    if (alignment < sizeof(void*)) {
+        alignment = sizeof(void*);
+    }
+
+    void *ret = 0;
+    if (posix_memalign(&ret, alignment, size) != 0) {
+        return 0;
+    }
+    return ret;
+#endif
+}
+
+inline void *allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    AllocationCounter::countAllocation();
+
+    if (size == 0) {
+        size = 1;
+    }
+
+    for (;;) {
+        void *ret = tryAllocateAligned(size, static_cast<std::size_t>(alignment));
+        if (ret) {
+            return ret;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+inline void freeAligned(void *pointer)
+{
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+#endif
+
+}
+
+}
+
+void *operator new(std::size_t size)
+{
+    return LibGeoDecomp::AllocationTrackingHelpers::allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return LibGeoDecomp::AllocationTrackingHelpers::allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return LibGeoDecomp::AllocationTrackingHelpers::allocate(size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return LibGeoDecomp::AllocationTrackingHelpers::allocate(size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+#ifdef __cpp_aligned_new
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return LibGeoDecomp::AllocationTrackingHelpers::allocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return LibGeoDecomp::AllocationTrackingHelpers::allocateAligned(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try {
+        return LibGeoDecomp::AllocationTrackingHelpers::allocateAligned(size, alignment);
+    } catch (...) {
+        return 0;
+    }
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try {
+        return LibGeoDecomp::AllocationTrackingHelpers::allocateAligned(size, alignment);
+    } catch (...) {
+        return 0;
+    }
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    LibGeoDecomp::AllocationTrackingHelpers::freeAligned(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+    LibGeoDecomp::AllocationTrackingHelpers::freeAligned(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    LibGeoDecomp::AllocationTrackingHelpers::freeAligned(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    LibGeoDecomp::AllocationTrackingHelpers::freeAligned(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    LibGeoDecomp::AllocationTrackingHelpers::freeAligned(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    LibGeoDecomp::AllocationTrackingHelpers::freeAligned(pointer);
+}
+
+#endif
+
+#endif
@@ -22,6 +22,9 @@ namespace LibGeoDecomp {
 class Typemaps;
 #endif
 
+template<typename VALUETYPE, int C, int SIGMA>
+class SellCSigmaSparseMatrixContainer;
+
 namespace APITraitsHelpers {
 
 #ifdef LIBGEODECOMP_WITH_MPI
@@ -489,6 +492,75 @@ public:
 
     // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+    template<typename CELL, typename HAS_SELL_CONTAINER = void>
+    class SelectSellContainer
+    {
+    public:
+        typedef SellCSigmaSparseMatrixContainer<
+            typename SelectSellType<CELL>::Value,
+            SelectSellC<CELL>::VALUE,
+            SelectSellSigma<CELL>::VALUE> Value;
+    };
+
+    template<typename CELL>
+    class SelectSellContainer<CELL, typename CELL::API::SupportsSellContainer>
+    {
+    public:
+        typedef typename CELL::API::SellContainer Value;
+    };
+
+    /**
+     * For unstructured grids with SoA layout, this selects the
+     * storage backend for the edge weights, e.g. a
+     * SellCSigmaDeltaColumnContainer or SellCSigmaDictionaryContainer
+     * for reduced memory traffic, or a SellCSigmaMatrixFreeContainer
+     * to compute weights on the fly. Its VALUETYPE, C and SIGMA need
+     * to match those specified via HasSellType, HasSellC and
+     * HasSellSigma. Default is the SellCSigmaSparseMatrixContainer.
+     */
+    template<typename SELL_CONTAINER>
+    class HasSellContainer
+    {
+    public:
+        typedef void SupportsSellContainer;
+
+        typedef SELL_CONTAINER SellContainer;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+    template<typename CELL, typename HAS_SELL_BLOCK_SIZE = void>
+    class SelectSellBlockSize
+    {
+    public:
+        static const int VALUE = 1;
+    };
+
+    template<typename CELL>
+    class SelectSellBlockSize<CELL, typename CELL::API::SupportsSellBlockSize>
+    {
+    public:
+        static const int VALUE = CELL::API::SELL_BLOCK_SIZE;
+    };
+
+    /**
+     * For unstructured grids with SoA layout, this specifies how
+     * many vectors (i.e. SoA members, e.g. multiple right-hand sides
+     * or coupled scalar fields) are multiplied with the adjacency
+     * matrix during a single traversal, see
+     * unstructuredBlockMultiply(). Default: 1.
+     */
+    template<int BLOCK_SIZE>
+    class HasSellBlockSize
+    {
+    public:
+        typedef void SupportsSellBlockSize;
+
+        static const int SELL_BLOCK_SIZE = BLOCK_SIZE;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
     /**
      * determine whether a cell has an architecture-specific speed indicator defined
      */
@@ -527,6 +599,55 @@ public:
 
     // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+    /**
+     * determine whether a cell can estimate its own update cost
+     */
+    template<typename CELL, typename HAS_CELL_COST = void>
+    class SelectCellCost
+    {
+    public:
+        typedef FalseType Value;
+
+        template<typename COORD>
+        static double value(const COORD& /* pos */)
+        {
+            return 1.0;
+        }
+    };
+
+    template<typename CELL>
+    class SelectCellCost<CELL, typename CELL::API::SupportsCellCost>
+    {
+    public:
+        typedef TrueType Value;
+
+        template<typename COORD>
+        static double value(const COORD& pos)
+        {
+            return CELL::cellCost(pos);
+        }
+    };
+
+    /**
+     * Models whose update cost varies strongly between cells (e.g.
+     * boundary cells, refined regions, particle-dense areas) may
+     * declare a relative cost per cell via a static function
+     *
+     *   static double cellCost(const Coord<DIM>& pos);
+     *
+     * The cost has to be a function of the position only as the
+     * domain decomposition is computed before any cell exists. It is
+     * picked up by CostAwarePartition. A cost of 1.0 corresponds to an
+     * average cell.
+     */
+    class HasCellCost
+    {
+    public:
+        typedef void SupportsCellCost;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
     template<typename CELL,
              typename HAS_MPI_DATA_TYPE = void,
              typename MPI_DATA_TYPE_RETRIEVAL = void>
@@ -684,6 +805,26 @@ public:
         typedef void SupportsBoostSerialization;
     };
 
+    /**
+     * Flags cells which know how to (de-)serialize themselves into a
+     * compact byte stream, which pays off if cells carry a varying
+     * amount of data (e.g. particle containers which are mostly
+     * empty). Such cells need to provide:
+     *
+     *   std::size_t packedSize() const;
+     *   void pack(char *target) const;
+     *   std::size_t unpack(const char *source); // returns bytes read
+     *   static std::size_t maxPackedSize();
+     *
+     * Grids then use these to save/load Regions to/from char
+     * buffers, and PatchLinks transmit only the bytes in use.
+     */
+    class HasPacking
+    {
+    public:
+        typedef void SupportsPacking;
+    };
+
     // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
     template<typename CELL, typename HAS_SPEED = void>
@@ -1138,6 +1279,90 @@ public:
 
     // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+    template<typename CELL, typename HAS_VERLET_LIST = void>
+    class SelectVerletList
+    {
+    public:
+        typedef FalseType Value;
+    };
+
+    template<typename CELL>
+    class SelectVerletList<CELL, typename CELL::API::SupportsVerletList>
+    {
+    public:
+        typedef TrueType Value;
+    };
+
+    /**
+     * Particles with short-range interactions can use this trait to
+     * make containers such as BoxCell cache a Verlet list per
+     * particle: only neighbors within cutoff + skin are visited
+     * during update(), and the lists are only rebuilt once particles
+     * have moved by more than half of the skin. Boxes need to be at
+     * least as wide as cutoff + skin.
+     *
+     * The particle's API is expected to provide
+     *
+     *   static double verletCutoff();
+     *   static double verletSkin();
+     *
+     * and the particle itself
+     *
+     *   const FloatCoord<DIM>& getPos() const;
+     *
+     * The lists are stored in the containers, which are thus no
+     * longer trivially copyable and can't be combined with
+     * HasOpaqueMPIDataType.
+     */
+    class HasVerletList
+    {
+    public:
+        typedef void SupportsVerletList;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+    template<typename CELL, typename HAS_ACTIVE_REGION = void>
+    class SelectActiveRegion
+    {
+    public:
+        typedef FalseType Value;
+    };
+
+    template<typename CELL>
+    class SelectActiveRegion<CELL, typename CELL::API::SupportsActiveRegion>
+    {
+    public:
+        typedef TrueType Value;
+    };
+
+    /**
+     * Models where most cells are idle most of the time (e.g. Game
+     * of Life) may use this trait to have Simulators update only
+     * those cells whose neighborhood has changed during the previous
+     * time step. Cells outside of this active region are assumed to
+     * be at a fixed point, which requires update() to be a pure
+     * function of the neighborhood: it may not depend on the time
+     * step or global state. Models with nano steps are not supported.
+     *
+     * So far only SerialSimulator and OpenMPSimulator honor this
+     * trait, all other Simulators ignore it and update all cells.
+     *
+     * Cells are expected to provide
+     *
+     *   bool reachedFixedPoint(const CELL& previousState) const;
+     *
+     * which is called on the updated cell and returns true if it
+     * equals its previous state (possibly within some tolerance).
+     */
+    class HasActiveRegion
+    {
+    public:
+        typedef void SupportsActiveRegion;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
     template<typename CELL, typename HAS_TEMPLATE_NAME = void>
     class SelectMessageType
     {
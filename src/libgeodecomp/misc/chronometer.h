@@ -1,12 +1,56 @@
 #ifndef LIBGEODECOMP_MISC_CHRONOMETER_H
 #define LIBGEODECOMP_MISC_CHRONOMETER_H
 
+#include <libgeodecomp/misc/allocationcounter.h>
+#include <libgeodecomp/misc/eventtracer.h>
+#include <libgeodecomp/misc/perfcounters.h>
 #include <libgeodecomp/misc/scopedtimer.h>
 #include <libgeodecomp/storage/fixedarray.h>
 
 #include <iomanip>
 #include <sstream>
 
+#ifdef LIBGEODECOMP_WITH_ALLOCATION_TRACKING
+#define LGD_CHRONOMETER_ALLOCATIONS_START(VALUE) , allocations(VALUE)
+#define LGD_CHRONOMETER_ALLOCATIONS_STOP                                \
+    allocations = AllocationCounter::allocations() - allocations;
+#define LGD_CHRONOMETER_ALLOCATIONS_ADD                                 \
+    AllocationCounter::addPhaseAllocations(ID, allocations);
+#else
+#define LGD_CHRONOMETER_ALLOCATIONS_START(VALUE)
+#define LGD_CHRONOMETER_ALLOCATIONS_STOP
+#define LGD_CHRONOMETER_ALLOCATIONS_ADD
+#endif
+
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+#define LGD_CHRONOMETER_COUNTERS_START(CHRONO, VALUE)                   \
+    , totalCounters(CHRONO->rawTotalCounters()), sampled(VALUE)
+#define LGD_CHRONOMETER_COUNTERS_STOP                                   \
+    if (sampled) {                                                      \
+        PerfCounters::stop(counters);                                   \
+    }
+#define LGD_CHRONOMETER_COUNTERS_ADD                                    \
+    if (sampled) {                                                      \
+        for (std::size_t i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {  \
+            totalCounters[ID * PerfCounters::NUM_COUNTERS + i] += counters[i]; \
+        }                                                               \
+        PerfCounters::addPhaseCounters(ID, counters);                   \
+    }
+#else
+#define LGD_CHRONOMETER_COUNTERS_START(CHRONO, VALUE)
+#define LGD_CHRONOMETER_COUNTERS_STOP
+#define LGD_CHRONOMETER_COUNTERS_ADD
+#endif
+
+#ifdef LIBGEODECOMP_WITH_EVENT_TRACING
+#define LGD_CHRONOMETER_TRACE                                           \
+    if (EventTracer::enabled()) {                                       \
+        EventTracer::record(ID, t, ScopedTimer::time());                \
+    }
+#else
+#define LGD_CHRONOMETER_TRACE
+#endif
+
 namespace LibGeoDecomp {
 
 namespace ChronometerHelpers {
@@ -35,6 +79,8 @@ public:
     BasicTimerImplementation(CHRONOMETER *chrono) :
         totalTimes(chrono->rawTotalTimes()),
         t(ScopedTimer::time())
+        LGD_CHRONOMETER_ALLOCATIONS_START(AllocationCounter::allocations())
+        LGD_CHRONOMETER_COUNTERS_START(chrono, PerfCounters::sample(counters))
     {}
 
     template<typename CHRONOMETER>
@@ -42,11 +88,21 @@ public:
     BasicTimerImplementation(CHRONOMETER *chrono, double t) :
         totalTimes(chrono->rawTotalTimes()),
         t(t)
+        LGD_CHRONOMETER_ALLOCATIONS_START(0)
+        LGD_CHRONOMETER_COUNTERS_START(chrono, false)
     {}
 
 protected:
     double *totalTimes;
     double t;
+#ifdef LIBGEODECOMP_WITH_ALLOCATION_TRACKING
+    std::size_t allocations;
+#endif
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+    double *totalCounters;
+    double counters[PerfCounters::NUM_COUNTERS];
+    bool sampled;
+#endif
 
     double elapsed() const
     {
@@ -117,6 +173,8 @@ public:
         ~CLASS_NAME ## Implementation()                             \
         {                                                           \
             totalTimes[ID] += t;                                    \
+            LGD_CHRONOMETER_ALLOCATIONS_ADD                         \
+            LGD_CHRONOMETER_COUNTERS_ADD                            \
         }                                                           \
     };                                                              \
                                                                     \
@@ -134,7 +192,10 @@ public:
                                                                     \
         ~CLASS_NAME()                                               \
         {                                                           \
+            LGD_CHRONOMETER_TRACE                                   \
             t = elapsed();                                          \
+            LGD_CHRONOMETER_ALLOCATIONS_STOP                        \
+            LGD_CHRONOMETER_COUNTERS_STOP                           \
         }                                                           \
     };
 }
@@ -148,6 +209,7 @@ DEFINE_EVENT(TimePatchProviders, ChronometerHelpers::BasicTimer,   "patch_provid
 DEFINE_EVENT(TimeCommunication,  ChronometerHelpers::BasicTimer,   "communication_time",   6)
 DEFINE_EVENT(TimeInput,          ChronometerHelpers::BasicTimer,   "input_time",           7)
 DEFINE_EVENT(TimeOutput,         ChronometerHelpers::BasicTimer,   "output_time",          8)
+DEFINE_EVENT(TimeInterNodeComm,  ChronometerHelpers::BasicTimer,   "inter_node_comm_time", 9)
 
 namespace ChronometerHelpers {
 
@@ -224,6 +286,14 @@ public:
 
     // measure one time interval per class of events
     static const std::size_t NUM_INTERVALS = ChronometerHelpers::EventUtil<100>::NUM_EVENTS;
+    // one set of performance counters per class of events
+    static const std::size_t NUM_COUNTER_VALUES = NUM_INTERVALS * PerfCounters::NUM_COUNTERS;
+#ifdef LIBGEODECOMP_WITH_ALLOCATION_TRACKING
+    static_assert(NUM_INTERVALS <= AllocationCounter::MAX_PHASES, "AllocationCounter can't track that many events");
+#endif
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+    static_assert(NUM_INTERVALS <= PerfCounters::MAX_PHASES, "PerfCounters can't track that many events");
+#endif
 
     Chronometer() :
         totalTimes(NUM_INTERVALS, 0)
@@ -250,6 +320,11 @@ public:
         for (std::size_t i = 0; i < NUM_INTERVALS; ++i) {
             totalTimes[i] += other.totalTimes[i];
         }
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        for (std::size_t i = 0; i < NUM_COUNTER_VALUES; ++i) {
+            totalCounters[i] += other.totalCounters[i];
+        }
+#endif
 
         return *this;
     }
@@ -262,11 +337,14 @@ public:
     }
 
     /**
-     * Flushes all time totals to 0.
+     * Flushes all time and counter totals to 0.
      */
     void reset()
     {
         std::fill(totalTimes.begin(), totalTimes.end(), 0);
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        std::fill(totalCounters, totalCounters + NUM_COUNTER_VALUES, 0);
+#endif
     }
 
     void cycle()
@@ -305,11 +383,38 @@ public:
         return totalTimes[i1] / totalTimes[i2];
     }
 
+    /**
+     * Returns the given PerfCounters::Counter accumulated over all
+     * timers of the given interval. Remains 0 unless performance
+     * counters are compiled in and enabled.
+     */
+    double counter(std::size_t intervalID, std::size_t counter) const
+    {
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        return totalCounters[intervalID * PerfCounters::NUM_COUNTERS + counter];
+#else
+        return 0;
+#endif
+    }
+
+    template<typename INTERVAL>
+    double counter(std::size_t counter) const
+    {
+        return this->counter(INTERVAL::ID, counter);
+    }
+
     double *rawTotalTimes()
     {
         return totalTimes.begin();
     }
 
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+    double *rawTotalCounters()
+    {
+        return totalCounters;
+    }
+#endif
+
     template<typename EVENT>
     void addTime(double elapsedTime)
     {
@@ -328,7 +433,15 @@ public:
 
         for (std::size_t i = 0; i < NUM_INTERVALS; ++i) {
             buf << std::left << std::setw(20) << ChronometerHelpers::EventToString()(i)
-                << ": " << totalTimes[i] << "s\n";
+                << ": " << totalTimes[i] << "s";
+            if (AllocationCounter::enabled()) {
+                buf << ", " << AllocationCounter::phaseAllocations(i) << " allocations";
+            }
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+            buf << ", " << PerfCounters::describe(
+                totalTimes[i], totalCounters + i * PerfCounters::NUM_COUNTERS);
+#endif
+            buf << "\n";
         }
 
         return buf.str();
@@ -336,6 +449,9 @@ public:
 
 private:
     FixedArray<double, Chronometer::NUM_INTERVALS> totalTimes;
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+    double totalCounters[Chronometer::NUM_COUNTER_VALUES];
+#endif
 };
 
 }
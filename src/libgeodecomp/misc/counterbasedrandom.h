@@ -0,0 +1,244 @@
+#ifndef LIBGEODECOMP_MISC_COUNTERBASEDRANDOM_H
+#define LIBGEODECOMP_MISC_COUNTERBASEDRANDOM_H
+
+#include <libgeodecomp/geometry/coord.h>
+
+#include <cstddef>
+
+namespace LibGeoDecomp {
+
+/**
+ * Philox4x32-10 is a counter-based pseudo random number generator:
+ * it maps a 128 bit counter and a 64 bit key to 128 random bits
+ * without any internal state. See J. K. Salmon et al.: "Parallel
+ * Random Numbers: As Easy as 1, 2, 3" (SC'11).
+ *
+ * We assume unsigned to be 32 bits wide.
+ */
+class Philox4x32
+{
+public:
+    static const unsigned ROUNDS = 10;
+
+    static inline void bijection(unsigned counter[4], const unsigned key[2])
+    {
+        bijection(&counter[0], &counter[1], &counter[2], &counter[3], 1, key);
+    }
+
+    /**
+     * Encrypts n counters at once, word-wise stored in c0 to c3.
+     * Rounds are applied to all lanes in turn so that the compiler
+     * can vectorize the multiplications.
+     */
+    static inline void bijection(
+        unsigned *c0,
+        unsigned *c1,
+        unsigned *c2,
+        unsigned *c3,
+        const std::size_t n,
+        const unsigned key[2])
+    {
+        unsigned k0 = key[0];
+        unsigned k1 = key[1];
+
+        for (unsigned round = 0; round < ROUNDS; ++round) {
+            for (std::size_t i = 0; i < n; ++i) {
+                unsigned long long product0 = (unsigned long long)(0xD2511F53U) * c0[i];
+                unsigned long long product1 = (unsigned long long)(0xCD9E8D57U) * c2[i];
+
+                unsigned newC0 = unsigned(product1 >> 32) ^ c1[i] ^ k0;
+                unsigned newC2 = unsigned(product0 >> 32) ^ c3[i] ^ k1;
+                c1[i] = unsigned(product1);
+                c3[i] = unsigned(product0);
+                c0[i] = newC0;
+                c2[i] = newC2;
+            }
+
+            k0 += 0x9E3779B9U;
+            k1 += 0xBB67AE85U;
+        }
+    }
+};
+
+/**
+ * Thread-safe source of random numbers for use within cell updates.
+ * Unlike Random, it doesn't depend on any global state: the numbers
+ * are a pure function of (seed, coordinate, step, nano step, stream)
+ * and the number of values drawn so far. Hence stochastic models
+ * yield identical results regardless of the number of threads or
+ * ranks and the domain decomposition. Typical use:
+ *
+ *   CounterBasedRandom random(seed, coord, step, nanoStep);
+ *   double p = random.genDouble();
+ *
+ * Agents which travel between cells may instead carry an ID and
+ * pass it in place of the coordinate. Different streams can be
+ * used to decorrelate multiple independent decisions at the same
+ * location and time. Successive values should be drawn from the
+ * same generator: its internal counter keeps them apart, whereas
+ * misusing the step as a draw index would let different time steps
+ * share the same numbers.
+ */
+class CounterBasedRandom
+{
+public:
+    static const std::size_t BLOCK_SIZE = 4;
+
+    template<int DIM>
+    inline CounterBasedRandom(
+        const unsigned seed,
+        const Coord<DIM>& coord,
+        const unsigned step,
+        const unsigned nanoStep = 0,
+        const unsigned stream = 0)
+    {
+        unsigned location[3] = {0, 0, 0};
+        for (int i = 0; i < DIM; ++i) {
+            location[i] = static_cast<unsigned>(coord[i]);
+        }
+
+        init(seed, location, step, nanoStep, stream);
+    }
+
+    inline CounterBasedRandom(
+        const unsigned seed,
+        const unsigned id,
+        const unsigned step,
+        const unsigned nanoStep = 0,
+        const unsigned stream = 0)
+    {
+        unsigned location[3] = {id, 0, 0};
+        init(seed, location, step, nanoStep, stream);
+    }
+
+    inline unsigned genUnsigned()
+    {
+        if (index == BLOCK_SIZE) {
+            refill();
+        }
+
+        return buffer[index++];
+    }
+
+    inline unsigned genUnsigned(const unsigned max)
+    {
+        return genUnsigned() % max;
+    }
+
+    /**
+     * Returns a value in [0, max).
+     */
+    inline double genDouble(const double max = 1.0)
+    {
+        return toDouble(genUnsigned()) * max;
+    }
+
+    /**
+     * Fills target with n values in [0, max). Values are generated
+     * in bulk, so this is considerably faster than repeated calls to
+     * genDouble(), while yielding the same sequence.
+     */
+    inline void genDouble(double *target, std::size_t n, const double max = 1.0)
+    {
+        while ((n > 0) && (index < BLOCK_SIZE)) {
+            *target++ = genDouble(max);
+            --n;
+        }
+
+        const std::size_t LANES = 64;
+        unsigned c0[LANES];
+        unsigned c1[LANES];
+        unsigned c2[LANES];
+        unsigned c3[LANES];
+
+        while (n >= BLOCK_SIZE) {
+            std::size_t lanes = n / BLOCK_SIZE;
+            if (lanes > LANES) {
+                lanes = LANES;
+            }
+
+            for (std::size_t i = 0; i < lanes; ++i) {
+                c0[i] = location[0];
+                c1[i] = location[1];
+                c2[i] = location[2];
+                c3[i] = block + static_cast<unsigned>(i);
+            }
+            block += static_cast<unsigned>(lanes);
+
+            Philox4x32::bijection(c0, c1, c2, c3, lanes, key);
+
+            for (std::size_t i = 0; i < lanes; ++i) {
+                target[0] = toDouble(c0[i]) * max;
+                target[1] = toDouble(c1[i]) * max;
+                target[2] = toDouble(c2[i]) * max;
+                target[3] = toDouble(c3[i]) * max;
+                target += BLOCK_SIZE;
+            }
+            n -= lanes * BLOCK_SIZE;
+        }
+
+        for (; n > 0; --n) {
+            *target++ = genDouble(max);
+        }
+    }
+
+    /**
+     * Loads SHORT_VEC::ARITY values in [0, max) into a
+     * LibFlatArray::short_vec.
+     */
+    template<typename SHORT_VEC>
+    inline void genDouble(SHORT_VEC *target, const double max = 1.0)
+    {
+        double buf[SHORT_VEC::ARITY];
+        genDouble(buf, SHORT_VEC::ARITY, max);
+        *target = SHORT_VEC(buf);
+    }
+
+private:
+    unsigned key[2];
+    unsigned location[3];
+    unsigned block;
+    unsigned buffer[BLOCK_SIZE];
+    std::size_t index;
+
+    inline void init(
+        const unsigned seed,
+        const unsigned newLocation[3],
+        const unsigned step,
+        const unsigned nanoStep,
+        const unsigned stream)
+    {
+        // 64 bits of key can't hold all parameters, so we derive the
+        // key by encrypting (step, nanoStep, stream) with the seed:
+        unsigned seedKey[2] = {seed, 0};
+        unsigned derived[4] = {step, nanoStep, stream, 0};
+        Philox4x32::bijection(derived, seedKey);
+        key[0] = derived[0];
+        key[1] = derived[1];
+
+        location[0] = newLocation[0];
+        location[1] = newLocation[1];
+        location[2] = newLocation[2];
+        block = 0;
+        index = BLOCK_SIZE;
+    }
+
+    inline void refill()
+    {
+        buffer[0] = location[0];
+        buffer[1] = location[1];
+        buffer[2] = location[2];
+        buffer[3] = block++;
+        Philox4x32::bijection(buffer, key);
+        index = 0;
+    }
+
+    static inline double toDouble(const unsigned value)
+    {
+        return value * (1.0 / 4294967296.0);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,339 @@
+#include <libgeodecomp/misc/eventtracer.h>
+
+#ifdef LIBGEODECOMP_WITH_EVENT_TRACING
+
+#include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/misc/scopedtimer.h>
+#include <libgeodecomp/misc/sharedptr.h>
+
+#ifdef LIBGEODECOMP_WITH_MPI
+#include <libgeodecomp/communication/mpilayer.h>
+#endif
+
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace EventTracerHelpers {
+
+std::atomic<bool> tracingEnabled(false);
+
+class Event
+{
+public:
+    double begin;
+    double end;
+    unsigned step;
+    int id;
+};
+
+/**
+ * Written to by exactly one thread, hence a plain ring buffer will
+ * do. The release store of counter ensures that readers which see
+ * the new count also see the event.
+ */
+class ThreadBuffer
+{
+public:
+    ThreadBuffer(std::size_t size, int thread) :
+        events(size),
+        counter(0),
+        thread(thread)
+    {}
+
+    inline void push(const Event& event)
+    {
+        std::size_t index = counter.load(std::memory_order_relaxed);
+        events[index % events.size()] = event;
+        counter.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<Event> events;
+    std::atomic<std::size_t> counter;
+    int thread;
+};
+
+std::mutex registryMutex;
+std::vector<SharedPtr<ThreadBuffer>::Type> buffers;
+// bumped by reset() so threads know that their buffer is gone:
+std::atomic<std::size_t> generation(1);
+std::size_t bufferSize = EventTracer::DEFAULT_BUFFER_SIZE;
+std::atomic<unsigned> currentStep(0);
+int rank = 0;
+// local time which corresponds to timestamp 0 in the trace:
+double origin = 0;
+bool originInitialized = false;
+
+thread_local ThreadBuffer *localBuffer = 0;
+thread_local std::size_t localGeneration = 0;
+
+inline ThreadBuffer *threadBuffer()
+{
+    std::size_t currentGeneration = generation.load(std::memory_order_acquire);
+    if (localGeneration != currentGeneration) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(SharedPtr<ThreadBuffer>::Type(new ThreadBuffer(bufferSize, buffers.size())));
+        localBuffer = buffers.back().get();
+        localGeneration = currentGeneration;
+    }
+
+    return localBuffer;
+}
+
+/**
+ * Appends the events as a comma-separated list of JSON objects,
+ * preceded by metadata which names the process.
+ */
+inline void writeEvents(std::ostream& stream)
+{
+    ChronometerHelpers::EventToString eventToString;
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < Chronometer::NUM_INTERVALS; ++i) {
+        names.push_back(eventToString(i));
+    }
+
+    stream << std::fixed << std::setprecision(3)
+           << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+           << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        const ThreadBuffer& buffer = *buffers[i];
+        std::size_t end = buffer.counter.load(std::memory_order_acquire);
+        std::size_t begin = (end > buffer.events.size()) ? (end - buffer.events.size()) : 0;
+
+        for (std::size_t j = begin; j < end; ++j) {
+            const Event& event = buffer.events[j % buffer.events.size()];
+            stream << ",{\"name\":\"" << names[event.id]
+                   << "\",\"cat\":\"libgeodecomp\",\"ph\":\"X\""
+                   << ",\"ts\":" << ((event.begin - origin) * 1e6)
+                   << ",\"dur\":" << ((event.end - event.begin) * 1e6)
+                   << ",\"pid\":" << rank
+                   << ",\"tid\":" << buffer.thread
+                   << ",\"args\":{\"step\":" << event.step << "}}";
+        }
+    }
+}
+
+}
+
+void EventTracer::enable(std::size_t bufferSize)
+{
+    {
+        std::lock_guard<std::mutex> lock(EventTracerHelpers::registryMutex);
+        EventTracerHelpers::bufferSize = bufferSize;
+        if (!EventTracerHelpers::originInitialized) {
+            EventTracerHelpers::origin = ScopedTimer::time();
+            EventTracerHelpers::originInitialized = true;
+        }
+    }
+
+    EventTracerHelpers::tracingEnabled = true;
+}
+
+void EventTracer::disable()
+{
+    EventTracerHelpers::tracingEnabled = false;
+}
+
+void EventTracer::reset()
+{
+    std::lock_guard<std::mutex> lock(EventTracerHelpers::registryMutex);
+    EventTracerHelpers::buffers.clear();
+    ++EventTracerHelpers::generation;
+}
+
+void EventTracer::record(int id, double begin, double end)
+{
+    EventTracerHelpers::Event event;
+    event.begin = begin;
+    event.end = end;
+    event.step = EventTracerHelpers::currentStep.load(std::memory_order_relaxed);
+    event.id = id;
+
+    EventTracerHelpers::threadBuffer()->push(event);
+}
+
+void EventTracer::setStep(unsigned step)
+{
+    EventTracerHelpers::currentStep.store(step, std::memory_order_relaxed);
+}
+
+void EventTracer::setRank(int rank)
+{
+    EventTracerHelpers::rank = rank;
+}
+
+std::size_t EventTracer::size()
+{
+    std::lock_guard<std::mutex> lock(EventTracerHelpers::registryMutex);
+    std::size_t ret = 0;
+
+    for (std::size_t i = 0; i < EventTracerHelpers::buffers.size(); ++i) {
+        const EventTracerHelpers::ThreadBuffer& buffer = *EventTracerHelpers::buffers[i];
+        ret += (std::min)(buffer.counter.load(), buffer.events.size());
+    }
+
+    return ret;
+}
+
+void EventTracer::writeChromeTrace(std::ostream& stream)
+{
+    stream << "{\"traceEvents\":[";
+    EventTracerHelpers::writeEvents(stream);
+    stream << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+#ifdef LIBGEODECOMP_WITH_MPI
+
+void EventTracer::synchronizeClocks(MPI_Comm communicator)
+{
+    const int rounds = 10;
+    MPILayer mpiLayer(communicator);
+    int rank = mpiLayer.rank();
+    int size = mpiLayer.size();
+    setRank(rank);
+
+    // offset of rank 0's clock relative to ours:
+    double offset = 0;
+
+    for (int peer = 1; peer < size; ++peer) {
+        if (rank == 0) {
+            for (int i = 0; i < rounds; ++i) {
+                char ping;
+                MPI_Recv(&ping, 1, MPI_CHAR, peer, MPILayer::EVENT_TRACER, communicator, MPI_STATUS_IGNORE);
+                double now = ScopedTimer::time();
+                MPI_Send(&now, 1, MPI_DOUBLE, peer, MPILayer::EVENT_TRACER, communicator);
+            }
+        }
+
+        if (rank == peer) {
+            double minRoundTrip = (std::numeric_limits<double>::max)();
+            for (int i = 0; i < rounds; ++i) {
+                char ping = 0;
+                double remoteTime;
+                double t0 = ScopedTimer::time();
+                MPI_Send(&ping, 1, MPI_CHAR, 0, MPILayer::EVENT_TRACER, communicator);
+                MPI_Recv(&remoteTime, 1, MPI_DOUBLE, 0, MPILayer::EVENT_TRACER, communicator, MPI_STATUS_IGNORE);
+                double t1 = ScopedTimer::time();
+
+                // assume that the reply was sent half way through the
+                // round trip:
+                if ((t1 - t0) < minRoundTrip) {
+                    minRoundTrip = t1 - t0;
+                    offset = remoteTime - 0.5 * (t0 + t1);
+                }
+            }
+        }
+    }
+
+    double epoch = ScopedTimer::time();
+    MPI_Bcast(&epoch, 1, MPI_DOUBLE, 0, communicator);
+
+    std::lock_guard<std::mutex> lock(EventTracerHelpers::registryMutex);
+    EventTracerHelpers::origin = epoch - offset;
+    EventTracerHelpers::originInitialized = true;
+}
+
+void EventTracer::gatherChromeTrace(std::ostream& stream, MPI_Comm communicator)
+{
+    MPILayer mpiLayer(communicator);
+    std::stringstream buf;
+    EventTracerHelpers::writeEvents(buf);
+    std::string events = buf.str();
+
+    int length = events.size();
+    std::vector<int> lengths(mpiLayer.size());
+    MPI_Gather(&length, 1, MPI_INT, &lengths[0], 1, MPI_INT, 0, communicator);
+
+    std::vector<int> displacements(mpiLayer.size(), 0);
+    for (std::size_t i = 1; i < displacements.size(); ++i) {
+        displacements[i] = displacements[i - 1] + lengths[i - 1];
+    }
+
+    std::vector<char> allEvents(displacements.back() + lengths.back() + 1);
+    MPI_Gatherv(
+        &events[0],
+        length,
+        MPI_CHAR,
+        &allEvents[0],
+        &lengths[0],
+        &displacements[0],
+        MPI_CHAR,
+        0,
+        communicator);
+
+    if (mpiLayer.rank() != 0) {
+        return;
+    }
+
+    stream << "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < lengths.size(); ++i) {
+        if (i > 0) {
+            stream << ",";
+        }
+        stream << std::string(&allEvents[displacements[i]], lengths[i]);
+    }
+    stream << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+#endif
+
+}
+
+#else
+
+namespace LibGeoDecomp {
+
+void EventTracer::enable(std::size_t /* unused: bufferSize */)
+{}
+
+void EventTracer::disable()
+{}
+
+void EventTracer::reset()
+{}
+
+void EventTracer::record(int /* unused: id */, double /* unused: begin */, double /* unused: end */)
+{}
+
+void EventTracer::setStep(unsigned /* unused: step */)
+{}
+
+void EventTracer::setRank(int /* unused: rank */)
+{}
+
+std::size_t EventTracer::size()
+{
+    return 0;
+}
+
+void EventTracer::writeChromeTrace(std::ostream& stream)
+{
+    stream << "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+#ifdef LIBGEODECOMP_WITH_MPI
+
+void EventTracer::synchronizeClocks(MPI_Comm /* unused: communicator */)
+{}
+
+void EventTracer::gatherChromeTrace(std::ostream& stream, MPI_Comm communicator)
+{
+    int rank;
+    MPI_Comm_rank(communicator, &rank);
+    if (rank == 0) {
+        writeChromeTrace(stream);
+    }
+}
+
+#endif
+
+}
+
+#endif
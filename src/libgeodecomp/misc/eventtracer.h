@@ -0,0 +1,133 @@
+#ifndef LIBGEODECOMP_MISC_EVENTTRACER_H
+#define LIBGEODECOMP_MISC_EVENTTRACER_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_MPI
+#include <mpi.h>
+#endif
+
+#ifdef LIBGEODECOMP_WITH_EVENT_TRACING
+#include <atomic>
+#endif
+
+#include <cstddef>
+#include <ostream>
+
+namespace LibGeoDecomp {
+
+#ifdef LIBGEODECOMP_WITH_EVENT_TRACING
+namespace EventTracerHelpers {
+
+extern std::atomic<bool> tracingEnabled;
+
+}
+#endif
+
+/**
+ * Debugging aid for finding out which step, rank or phase stalled a
+ * run: if LibGeoDecomp was configured with WITH_EVENT_TRACING, then
+ * all Chronometer timers (TimeComputeInner, TimePatchProviders...)
+ * will report their begin and end time here, once tracing has been
+ * enabled at runtime. Each thread records into its own ring buffer,
+ * so recording doesn't need any locks; if a buffer overflows, the
+ * oldest events get overwritten.
+ *
+ * The trace can be exported in Chrome's trace event format, which
+ * can be viewed with chrome://tracing or https://ui.perfetto.dev.
+ * Each rank is shown as a process, each thread as a thread.
+ * Typically you'll want to use a ChromeTraceWriter instead of
+ * calling these functions manually.
+ *
+ * Without WITH_EVENT_TRACING all functions are no-ops and the timers
+ * don't call into this class at all.
+ */
+class EventTracer
+{
+public:
+    /**
+     * Number of events each thread keeps before overwriting old
+     * ones.
+     */
+    static const std::size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+    static inline bool compiledIn()
+    {
+#ifdef LIBGEODECOMP_WITH_EVENT_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static inline bool enabled()
+    {
+#ifdef LIBGEODECOMP_WITH_EVENT_TRACING
+        return EventTracerHelpers::tracingEnabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Starts recording events. bufferSize only affects threads which
+     * haven't recorded any events since the last reset().
+     */
+    static void enable(std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    static void disable();
+
+    /**
+     * Discards all recorded events. Not thread-safe with regard to
+     * running Chronometer timers.
+     */
+    static void reset();
+
+    /**
+     * Records the interval [begin, end] (in seconds, as returned by
+     * ScopedTimer::time()) for the Chronometer event with the given
+     * ID.
+     */
+    static void record(int id, double begin, double end);
+
+    /**
+     * Subsequent events will be tagged with this time step.
+     */
+    static void setStep(unsigned step);
+
+    /**
+     * Sets the process ID used in the trace. Done automatically by
+     * synchronizeClocks().
+     */
+    static void setRank(int rank);
+
+    /**
+     * Number of events currently stored in all buffers.
+     */
+    static std::size_t size();
+
+    /**
+     * Writes all events of this process as a Chrome trace (JSON).
+     * Should only be called while no timers are running.
+     */
+    static void writeChromeTrace(std::ostream& stream);
+
+#ifdef LIBGEODECOMP_WITH_MPI
+    /**
+     * Estimates the offset of the local clock to that of rank 0
+     * (based on the round trip with the lowest latency), so that
+     * traces of different ranks line up. Collective operation.
+     */
+    static void synchronizeClocks(MPI_Comm communicator = MPI_COMM_WORLD);
+
+    /**
+     * Collects the events of all ranks and writes them as one Chrome
+     * trace to stream on rank 0. Collective operation.
+     */
+    static void gatherChromeTrace(std::ostream& stream, MPI_Comm communicator = MPI_COMM_WORLD);
+#endif
+};
+
+}
+
+#endif
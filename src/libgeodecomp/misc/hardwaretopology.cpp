@@ -0,0 +1,250 @@
+#include <libgeodecomp/misc/hardwaretopology.h>
+#include <libgeodecomp/misc/stringops.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace LibGeoDecomp {
+
+namespace HardwareTopologyHelpers {
+
+/**
+ * Returns the first line of the given file or an empty string if
+ * the file can't be read.
+ */
+inline std::string readLine(const std::string& filename)
+{
+    std::ifstream file(filename.c_str());
+    std::string ret;
+    if (file) {
+        std::getline(file, ret);
+    }
+    return ret;
+}
+
+/**
+ * Parses sizes like "32K", "8M" or "1024".
+ */
+inline std::size_t parseSize(const std::string& string)
+{
+    if (string.empty()) {
+        return 0;
+    }
+
+    std::size_t factor = 1;
+    char suffix = string[string.size() - 1];
+    if ((suffix == 'K') || (suffix == 'k')) {
+        factor = 1 << 10;
+    }
+    if ((suffix == 'M') || (suffix == 'm')) {
+        factor = 1 << 20;
+    }
+    if ((suffix == 'G') || (suffix == 'g')) {
+        factor = 1 << 30;
+    }
+
+    std::stringstream buf(string);
+    std::size_t ret = 0;
+    buf >> ret;
+    return ret * factor;
+}
+
+/**
+ * Parses CPU/node lists as used by sysfs, e.g. "0-3,8,10-11".
+ */
+inline std::vector<int> parseList(const std::string& string)
+{
+    std::vector<int> ret;
+    StringVec ranges = StringOps::tokenize(string, ",");
+
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        StringVec bounds = StringOps::tokenize(ranges[i], "-");
+        if (bounds.empty()) {
+            continue;
+        }
+
+        int start = StringOps::atoi(bounds[0]);
+        int end = StringOps::atoi(bounds.back());
+        for (int j = start; j <= end; ++j) {
+            ret.push_back(j);
+        }
+    }
+
+    return ret;
+}
+
+inline bool lowerLevel(const HardwareTopology::Cache& a, const HardwareTopology::Cache& b)
+{
+    return a.level < b.level;
+}
+
+}
+
+const std::size_t HardwareTopology::DEFAULT_LAST_LEVEL_CACHE_SIZE = 1 << 25;
+const std::size_t HardwareTopology::DEFAULT_CACHE_LINE_SIZE = 64;
+
+HardwareTopology::HardwareTopology(const std::string& sysfsRoot) :
+    lastLevelCacheSizeOverride(0),
+    cpus(0),
+    cores(0),
+    numaNodes(0)
+{
+    probeCaches(sysfsRoot);
+    probeCores(sysfsRoot);
+    probeNUMANodes(sysfsRoot);
+    probeFallback();
+
+    const char *override = std::getenv("LIBGEODECOMP_LAST_LEVEL_CACHE_SIZE");
+    if (override) {
+        lastLevelCacheSizeOverride = HardwareTopologyHelpers::parseSize(override);
+    }
+}
+
+const HardwareTopology& HardwareTopology::local()
+{
+    static HardwareTopology topology("/sys/devices/system");
+    return topology;
+}
+
+std::size_t HardwareTopology::cacheSize(int level) const
+{
+    for (std::vector<Cache>::const_iterator i = cacheVec.begin(); i != cacheVec.end(); ++i) {
+        if (i->level == level) {
+            return i->size;
+        }
+    }
+
+    return 0;
+}
+
+std::size_t HardwareTopology::lastLevelCacheSize() const
+{
+    if (lastLevelCacheSizeOverride) {
+        return lastLevelCacheSizeOverride;
+    }
+
+    if (cacheVec.empty()) {
+        return DEFAULT_LAST_LEVEL_CACHE_SIZE;
+    }
+
+    return cacheVec.back().size;
+}
+
+std::size_t HardwareTopology::lastLevelCacheSizePerCPU() const
+{
+    int sharingCPUs = cacheVec.empty() ? cpus : cacheVec.back().sharingCPUs;
+    return lastLevelCacheSize() / (std::max)(1, sharingCPUs);
+}
+
+std::size_t HardwareTopology::cacheLineSize() const
+{
+    if (cacheVec.empty() || (cacheVec.front().lineSize == 0)) {
+        return DEFAULT_CACHE_LINE_SIZE;
+    }
+
+    return cacheVec.front().lineSize;
+}
+
+void HardwareTopology::probeCaches(const std::string& sysfsRoot)
+{
+    using namespace HardwareTopologyHelpers;
+
+    for (int index = 0;; ++index) {
+        std::string prefix = sysfsRoot + "/cpu/cpu0/cache/index" + StringOps::itoa(index) + "/";
+        std::string level = readLine(prefix + "level");
+        if (level.empty()) {
+            break;
+        }
+
+        if (readLine(prefix + "type") == "Instruction") {
+            continue;
+        }
+
+        std::size_t sharingCPUs = parseList(readLine(prefix + "shared_cpu_list")).size();
+        cacheVec.push_back(
+            Cache(
+                StringOps::atoi(level),
+                parseSize(readLine(prefix + "size")),
+                parseSize(readLine(prefix + "coherency_line_size")),
+                (std::max)(std::size_t(1), sharingCPUs)));
+    }
+
+    // the last level cache is expected at the back:
+    std::stable_sort(cacheVec.begin(), cacheVec.end(), lowerLevel);
+}
+
+void HardwareTopology::probeCores(const std::string& sysfsRoot)
+{
+    using namespace HardwareTopologyHelpers;
+
+    std::vector<int> cpuIDs = parseList(readLine(sysfsRoot + "/cpu/online"));
+    cpus = cpuIDs.size();
+
+    // hyperthreads share the same core ID within a package:
+    std::set<std::pair<std::string, std::string> > coreIDs;
+    for (std::vector<int>::iterator i = cpuIDs.begin(); i != cpuIDs.end(); ++i) {
+        std::string prefix = sysfsRoot + "/cpu/cpu" + StringOps::itoa(*i) + "/topology/";
+        coreIDs.insert(std::make_pair(
+                           readLine(prefix + "physical_package_id"),
+                           readLine(prefix + "core_id")));
+    }
+    cores = coreIDs.size();
+}
+
+void HardwareTopology::probeNUMANodes(const std::string& sysfsRoot)
+{
+    numaNodes = HardwareTopologyHelpers::parseList(
+        HardwareTopologyHelpers::readLine(sysfsRoot + "/node/online")).size();
+}
+
+void HardwareTopology::probeFallback()
+{
+#if defined(_SC_NPROCESSORS_ONLN)
+    if (cpus == 0) {
+        cpus = (std::max)(0L, sysconf(_SC_NPROCESSORS_ONLN));
+    }
+#endif
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL1_DCACHE_LINESIZE)
+    if (cacheVec.empty()) {
+        long lineSize = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+        long sizes[] = {
+            sysconf(_SC_LEVEL1_DCACHE_SIZE),
+            sysconf(_SC_LEVEL2_CACHE_SIZE),
+            sysconf(_SC_LEVEL3_CACHE_SIZE),
+            sysconf(_SC_LEVEL4_CACHE_SIZE) };
+
+        for (int i = 0; i < 4; ++i) {
+            if (sizes[i] > 0) {
+                // sysconf() doesn't tell us how caches are shared, so
+                // we assume the last level is shared by all CPUs:
+                cacheVec.push_back(Cache(i + 1, sizes[i], (std::max)(0L, lineSize), 1));
+            }
+        }
+
+        if (!cacheVec.empty()) {
+            cacheVec.back().sharingCPUs = (std::max)(1, cpus);
+        }
+    }
+#endif
+
+    if (cpus == 0) {
+        cpus = 1;
+    }
+    if (cores == 0) {
+        cores = cpus;
+    }
+    if (numaNodes == 0) {
+        numaNodes = 1;
+    }
+}
+
+}
@@ -0,0 +1,152 @@
+#ifndef LIBGEODECOMP_MISC_HARDWARETOPOLOGY_H
+#define LIBGEODECOMP_MISC_HARDWARETOPOLOGY_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Describes the cache hierarchy and core/NUMA layout of the machine
+ * we're running on. On Linux this information is read from sysfs,
+ * elsewhere we fall back to sysconf() (which glibc implements via
+ * CPUID) and, as a last resort, to conservative defaults.
+ *
+ * Kernels can use this information to make decisions at runtime
+ * which would otherwise need to be hard-coded, e.g. whether to use
+ * non-temporal stores (see shortVecSwitch()) or how to size tiles so
+ * they fit into the cache (see CacheBlockingSimulator).
+ *
+ * The detected last level cache size can be overridden via the
+ * environment variable LIBGEODECOMP_LAST_LEVEL_CACHE_SIZE (in bytes).
+ */
+class HardwareTopology
+{
+public:
+    /**
+     * One level of the cache hierarchy as seen from CPU 0.
+     * Instruction caches are skipped.
+     */
+    class Cache
+    {
+    public:
+        inline Cache(
+            int level = 0,
+            std::size_t size = 0,
+            std::size_t lineSize = 0,
+            int sharingCPUs = 1) :
+            level(level),
+            size(size),
+            lineSize(lineSize),
+            sharingCPUs(sharingCPUs)
+        {}
+
+        inline bool operator==(const Cache& other) const
+        {
+            return
+                (level       == other.level) &&
+                (size        == other.size) &&
+                (lineSize    == other.lineSize) &&
+                (sharingCPUs == other.sharingCPUs);
+        }
+
+        int level;
+        std::size_t size;
+        std::size_t lineSize;
+        // number of logical CPUs which share this cache
+        int sharingCPUs;
+    };
+
+    static const std::size_t DEFAULT_LAST_LEVEL_CACHE_SIZE;
+    static const std::size_t DEFAULT_CACHE_LINE_SIZE;
+
+    /**
+     * Probes the given sysfs tree (usually "/sys/devices/system").
+     * Mostly useful for testing, user code should call local().
+     */
+    explicit HardwareTopology(const std::string& sysfsRoot);
+
+    /**
+     * Returns the topology of the local machine. It's probed once
+     * upon first use.
+     */
+    static const HardwareTopology& local();
+
+    inline const std::vector<Cache>& caches() const
+    {
+        return cacheVec;
+    }
+
+    /**
+     * Size of the data or unified cache on the given level, 0 if
+     * there is no such cache.
+     */
+    std::size_t cacheSize(int level) const;
+
+    std::size_t lastLevelCacheSize() const;
+
+    /**
+     * The share of the last level cache a single logical CPU can
+     * expect to get if all CPUs are busy.
+     */
+    std::size_t lastLevelCacheSizePerCPU() const;
+
+    std::size_t cacheLineSize() const;
+
+    inline int numCPUs() const
+    {
+        return cpus;
+    }
+
+    inline int numCores() const
+    {
+        return cores;
+    }
+
+    inline int numNUMANodes() const
+    {
+        return numaNodes;
+    }
+
+    /**
+     * Non-temporal stores only pay off if the working set (in bytes)
+     * won't fit into the last level cache. Using them for smaller
+     * sets is much more expensive than the converse, hence we'll
+     * only stream if we're certain the cache is too small.
+     */
+    inline bool useStreamingStores(std::size_t workingSetSize) const
+    {
+        return workingSetSize > lastLevelCacheSize();
+    }
+
+private:
+    std::vector<Cache> cacheVec;
+    std::size_t lastLevelCacheSizeOverride;
+    int cpus;
+    int cores;
+    int numaNodes;
+
+    void probeCaches(const std::string& sysfsRoot);
+    void probeCores(const std::string& sysfsRoot);
+    void probeNUMANodes(const std::string& sysfsRoot);
+    void probeFallback();
+};
+
+template<typename _CharT, typename _Traits>
+std::basic_ostream<_CharT, _Traits>&
+operator<<(std::basic_ostream<_CharT, _Traits>& os,
+           const HardwareTopology::Cache& cache)
+{
+    os << "Cache(level: " << cache.level
+       << ", size: " << cache.size
+       << ", lineSize: " << cache.lineSize
+       << ", sharingCPUs: " << cache.sharingCPUs
+       << ")";
+    return os;
+}
+
+}
+
+#endif
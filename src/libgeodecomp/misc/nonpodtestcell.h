@@ -46,12 +46,31 @@ public:
 
         virtual void grid(GridBase<NonPoDTestCell, 2> *target)
         {
-            CoordBox<2> simSpace(Coord<2>(), gridDimensions());
-            CoordBox<2> box(target->boundingBox());
-            for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
-                target->set(*i, NonPoDTestCell(*i, simSpace));
-            }
+            Region<2> region;
+            region << target->boundingBox();
+            InitVisitor visitor(CoordBox<2>(Coord<2>(), gridDimensions()));
+            target->visit(region, &visitor);
         }
+
+    private:
+        class InitVisitor : public GridVisitor<NonPoDTestCell, 2>
+        {
+        public:
+            explicit InitVisitor(const CoordBox<2>& simSpace) :
+                simSpace(simSpace)
+            {}
+
+            virtual void visit(const Streak<2>& streak, NonPoDTestCell *cells)
+            {
+                for (Coord<2> c = streak.origin; c.x() < streak.endX; ++c.x()) {
+                    *cells = NonPoDTestCell(c, simSpace);
+                    ++cells;
+                }
+            }
+
+        private:
+            CoordBox<2> simSpace;
+        };
     };
 
     explicit NonPoDTestCell(
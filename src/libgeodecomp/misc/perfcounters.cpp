@@ -0,0 +1,297 @@
+#include <libgeodecomp/misc/perfcounters.h>
+
+#include <sstream>
+#include <stdexcept>
+
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace PerfCountersHelpers {
+
+std::atomic<bool> countersEnabled(false);
+std::atomic<double> phaseCounters[PerfCounters::MAX_PHASES][PerfCounters::NUM_COUNTERS];
+
+inline void atomicAdd(std::atomic<double> *target, double delta)
+{
+    double old = target->load(std::memory_order_relaxed);
+    while (!target->compare_exchange_weak(old, old + delta, std::memory_order_relaxed)) {}
+}
+
+inline int openCounter(unsigned type, unsigned long long config, int groupFD)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    if (groupFD == -1) {
+        attr.read_format =
+            PERF_FORMAT_GROUP |
+            PERF_FORMAT_TOTAL_TIME_ENABLED |
+            PERF_FORMAT_TOTAL_TIME_RUNNING;
+    }
+
+    // counts only the calling thread, on any CPU:
+    return syscall(SYS_perf_event_open, &attr, 0, -1, groupFD, 0);
+}
+
+/**
+ * The counters of one thread: the hardware counters form a group so
+ * that they are scheduled together and can be read with one system
+ * call. CPU time is taken from a separate software counter.
+ */
+class ThreadCounters
+{
+public:
+    ThreadCounters() :
+        groupFD(-1),
+        taskClockFD(-1)
+    {
+        groupFD = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (groupFD != -1) {
+            groupCounters.push_back(PerfCounters::CYCLES);
+            addToGroup(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, PerfCounters::INSTRUCTIONS);
+
+            unsigned long long llcReadMisses =
+                PERF_COUNT_HW_CACHE_LL |
+                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            if (!addToGroup(PERF_TYPE_HW_CACHE, llcReadMisses, PerfCounters::LLC_MISSES)) {
+                addToGroup(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, PerfCounters::LLC_MISSES);
+            }
+        }
+
+        taskClockFD = openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, -1);
+    }
+
+    ~ThreadCounters()
+    {
+        if (groupFD != -1) {
+            close(groupFD);
+        }
+        for (std::size_t i = 0; i < memberFDs.size(); ++i) {
+            close(memberFDs[i]);
+        }
+        if (taskClockFD != -1) {
+            close(taskClockFD);
+        }
+    }
+
+    bool hardwareAvailable() const
+    {
+        return groupFD != -1;
+    }
+
+    void read(double *values)
+    {
+        for (std::size_t i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {
+            values[i] = 0;
+        }
+
+        if (groupFD != -1) {
+            // layout: nr, time_enabled, time_running, values[nr]
+            unsigned long long buffer[3 + PerfCounters::NUM_COUNTERS];
+            if (::read(groupFD, buffer, sizeof(buffer)) > 0) {
+                // extrapolate if the PMU had to be multiplexed:
+                double scale = 1.0;
+                if ((buffer[2] > 0) && (buffer[2] < buffer[1])) {
+                    scale = double(buffer[1]) / buffer[2];
+                }
+
+                for (std::size_t i = 0; i < groupCounters.size(); ++i) {
+                    values[groupCounters[i]] = scale * buffer[3 + i];
+                }
+            }
+        }
+
+        values[PerfCounters::CPU_TIME] = cpuTime();
+    }
+
+private:
+    int groupFD;
+    int taskClockFD;
+    std::vector<int> memberFDs;
+    std::vector<int> groupCounters;
+
+    bool addToGroup(unsigned type, unsigned long long config, PerfCounters::Counter counter)
+    {
+        int fd = openCounter(type, config, groupFD);
+        if (fd == -1) {
+            return false;
+        }
+
+        memberFDs.push_back(fd);
+        groupCounters.push_back(counter);
+        return true;
+    }
+
+    double cpuTime()
+    {
+        if (taskClockFD != -1) {
+            unsigned long long buffer[3];
+            if (::read(taskClockFD, buffer, sizeof(buffer)) > 0) {
+                return buffer[0] * 1e-9;
+            }
+        }
+
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return time.tv_sec + time.tv_nsec * 1e-9;
+    }
+};
+
+inline ThreadCounters& threadCounters()
+{
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+}
+
+void PerfCounters::enable()
+{
+    PerfCountersHelpers::countersEnabled = true;
+}
+
+void PerfCounters::disable()
+{
+    PerfCountersHelpers::countersEnabled = false;
+}
+
+bool PerfCounters::hardwareAvailable()
+{
+    return PerfCountersHelpers::threadCounters().hardwareAvailable();
+}
+
+bool PerfCounters::sample(double *values)
+{
+    if (!enabled()) {
+        return false;
+    }
+
+    PerfCountersHelpers::threadCounters().read(values);
+    return true;
+}
+
+void PerfCounters::stop(double *values)
+{
+    double now[NUM_COUNTERS];
+    PerfCountersHelpers::threadCounters().read(now);
+
+    for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+        values[i] = now[i] - values[i];
+    }
+}
+
+double PerfCounters::phaseCounter(std::size_t id, std::size_t counter)
+{
+    return PerfCountersHelpers::phaseCounters[id][counter];
+}
+
+void PerfCounters::addPhaseCounters(std::size_t id, const double *values)
+{
+    for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+        PerfCountersHelpers::atomicAdd(&PerfCountersHelpers::phaseCounters[id][i], values[i]);
+    }
+}
+
+void PerfCounters::reset()
+{
+    for (std::size_t i = 0; i < MAX_PHASES; ++i) {
+        for (std::size_t j = 0; j < NUM_COUNTERS; ++j) {
+            PerfCountersHelpers::phaseCounters[i][j] = 0;
+        }
+    }
+}
+
+}
+
+#else
+
+namespace LibGeoDecomp {
+
+void PerfCounters::enable()
+{}
+
+void PerfCounters::disable()
+{}
+
+bool PerfCounters::hardwareAvailable()
+{
+    return false;
+}
+
+bool PerfCounters::sample(double * /* unused: values */)
+{
+    return false;
+}
+
+void PerfCounters::stop(double * /* unused: values */)
+{}
+
+double PerfCounters::phaseCounter(std::size_t /* unused: id */, std::size_t /* unused: counter */)
+{
+    return 0;
+}
+
+void PerfCounters::addPhaseCounters(std::size_t /* unused: id */, const double * /* unused: values */)
+{}
+
+void PerfCounters::reset()
+{}
+
+}
+
+#endif
+
+namespace LibGeoDecomp {
+
+std::string PerfCounters::counterName(std::size_t counter)
+{
+    switch (counter) {
+    case CYCLES:
+        return "cycles";
+    case INSTRUCTIONS:
+        return "instructions";
+    case LLC_MISSES:
+        return "llc_misses";
+    case CPU_TIME:
+        return "cpu_time";
+    default:
+        throw std::invalid_argument("unknown performance counter");
+    }
+}
+
+std::string PerfCounters::describe(double seconds, const double *values)
+{
+    std::stringstream buf;
+    buf << values[CPU_TIME] << "s CPU time";
+
+    if (values[CYCLES] == 0) {
+        buf << ", hardware counters n/a";
+        return buf.str();
+    }
+
+    buf << ", " << values[CYCLES] << " cycles"
+        << ", " << values[INSTRUCTIONS] << " instructions"
+        << " (IPC " << (values[INSTRUCTIONS] / values[CYCLES]) << ")"
+        << ", " << values[LLC_MISSES] << " LLC misses";
+    if (seconds > 0) {
+        buf << " (>= " << (values[LLC_MISSES] * CACHE_LINE_SIZE / seconds * 1e-9) << " GB/s)";
+    }
+
+    return buf.str();
+}
+
+}
@@ -0,0 +1,137 @@
+#ifndef LIBGEODECOMP_MISC_PERFCOUNTERS_H
+#define LIBGEODECOMP_MISC_PERFCOUNTERS_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+#include <atomic>
+#endif
+
+#include <cstddef>
+#include <string>
+
+namespace LibGeoDecomp {
+
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+namespace PerfCountersHelpers {
+
+extern std::atomic<bool> countersEnabled;
+
+}
+#endif
+
+/**
+ * Tuning aid which tells whether a kernel is compute or memory
+ * bound: if LibGeoDecomp was configured with WITH_PERF_COUNTERS and
+ * counting has been enabled at runtime, then all Chronometer timers
+ * will sample the calling thread's hardware performance counters via
+ * Linux' perf_event_open() upon construction and destruction. The
+ * differences are accumulated per phase in the Chronometer (and thus
+ * reported via Simulator::gatherStatistics()) as well as process-wide
+ * in this class (used by TracingWriter).
+ *
+ * Counters are opened per thread when it first starts a timer. Each
+ * thread's counts are only attributed to the timers it runs itself,
+ * so work delegated to e.g. an OpenMP team is only partially
+ * covered. If the PMU is inaccessible (virtual machines,
+ * perf_event_paranoid > 2...), then all hardware counters remain 0
+ * and only the CPU time is measured, falling back to the software
+ * task clock or clock_gettime(). The memory bandwidth is estimated
+ * from last level cache read misses and is thus a lower bound.
+ *
+ * Without WITH_PERF_COUNTERS all functions are no-ops and the timers
+ * don't call into this class at all.
+ */
+class PerfCounters
+{
+public:
+    enum Counter {
+        CYCLES = 0,
+        INSTRUCTIONS = 1,
+        LLC_MISSES = 2,
+        CPU_TIME = 3
+    };
+
+    static const std::size_t NUM_COUNTERS = 4;
+
+    /**
+     * Upper limit for the number of events supported by Chronometer.
+     */
+    static const std::size_t MAX_PHASES = 20;
+
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    static inline bool compiledIn()
+    {
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static inline bool enabled()
+    {
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        return PerfCountersHelpers::countersEnabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    static void enable();
+
+    static void disable();
+
+    /**
+     * Returns true if the calling thread could open its hardware
+     * counters. Opens them if necessary.
+     */
+    static bool hardwareAvailable();
+
+    static std::string counterName(std::size_t counter);
+
+    /**
+     * Stores the current values of the calling thread's counters in
+     * values (NUM_COUNTERS elements, CPU_TIME in seconds) if
+     * counting is enabled. Returns whether it did.
+     */
+    static bool sample(double *values);
+
+    /**
+     * Replaces values (obtained from sample()) by the counts which
+     * accrued since then.
+     */
+    static void stop(double *values);
+
+    /**
+     * Sum of the given counter over all timers with the given
+     * Chronometer event ID in this process.
+     */
+    static double phaseCounter(std::size_t id, std::size_t counter);
+
+    template<typename EVENT>
+    static double phaseCounter(std::size_t counter)
+    {
+        return phaseCounter(EVENT::ID, counter);
+    }
+
+    static void addPhaseCounters(std::size_t id, const double *values);
+
+    /**
+     * Resets all phase counters to 0. Not thread-safe with regard to
+     * running Chronometer timers.
+     */
+    static void reset();
+
+    /**
+     * Renders counts (and derived metrics such as instructions per
+     * cycle and memory bandwidth) measured over the given wall clock
+     * time in a human readable format.
+     */
+    static std::string describe(double seconds, const double *values);
+};
+
+}
+
+#endif
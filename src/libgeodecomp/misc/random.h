@@ -10,7 +10,8 @@ unsigned randomMT();
 
 /**
  * LibGeoDecomp's internal wrapper for generating pseudo random
- * numbers.
+ * numbers. It relies on a single, global generator and is thus not
+ * thread-safe. Cell updates should use CounterBasedRandom instead.
  */
 class Random
 {
@@ -65,13 +65,33 @@ public:
 
     virtual void grid(GridBase<SimFabTestCell, 3> *target)
     {
-        int counter = 0;
-        CoordBox<3> box = target->boundingBox();
+        Region<3> region;
+        region << target->boundingBox();
+        InitVisitor visitor;
+        target->visit(region, &visitor);
+    }
+
+private:
+    /**
+     * Numbers cells consecutively in the order they're visited.
+     */
+    class InitVisitor : public GridVisitor<SimFabTestCell, 3>
+    {
+    public:
+        InitVisitor() :
+            counter(0)
+        {}
 
-        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
-            target->set(*i, SimFabTestCell(++counter));
+        virtual void visit(const Streak<3>& streak, SimFabTestCell *cells)
+        {
+            for (int i = 0; i < streak.length(); ++i) {
+                cells[i] = SimFabTestCell(++counter);
+            }
         }
-    }
+
+    private:
+        int counter;
+    };
 };
 
 }
@@ -0,0 +1,77 @@
+#include <libgeodecomp/misc/allocationcounter.h>
+#include <libgeodecomp/misc/chronometer.h>
+
+#include <cxxtest/TestSuite.h>
+#include <vector>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class AllocationCounterTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        AllocationCounter::reset();
+    }
+
+    void testPhases()
+    {
+        Chronometer chrono;
+        std::vector<int> *buffers[3];
+
+        {
+            TimeTotal t(&chrono);
+            {
+                TimeComputeInner t(&chrono);
+                buffers[0] = new std::vector<int>();
+                buffers[1] = new std::vector<int>(100);
+            }
+            {
+                TimeCommunication t(&chrono);
+                buffers[2] = new std::vector<int>();
+            }
+            {
+                TimeOutput t(&chrono);
+                buffers[1]->clear();
+                buffers[1]->push_back(4711);
+            }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            delete buffers[i];
+        }
+
+        if (AllocationCounter::enabled()) {
+            TS_ASSERT_EQUALS(std::size_t(4), AllocationCounter::phaseAllocations<TimeTotal>());
+            TS_ASSERT_EQUALS(std::size_t(3), AllocationCounter::phaseAllocations<TimeCompute>());
+            TS_ASSERT_EQUALS(std::size_t(3), AllocationCounter::phaseAllocations<TimeComputeInner>());
+            TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::phaseAllocations<TimeComputeGhost>());
+            TS_ASSERT_EQUALS(std::size_t(1), AllocationCounter::phaseAllocations<TimeCommunication>());
+            TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::phaseAllocations<TimeOutput>());
+            TS_ASSERT_LESS_THAN_EQUALS(std::size_t(4), AllocationCounter::allocations());
+        } else {
+            TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::phaseAllocations<TimeTotal>());
+            TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::allocations());
+        }
+    }
+
+    void testAddTime()
+    {
+        Chronometer chrono;
+        chrono.addTime<TimeCompute>(1.0);
+        TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::phaseAllocations<TimeCompute>());
+    }
+
+    void testReset()
+    {
+        AllocationCounter::addPhaseAllocations(TimeInput::ID, 5);
+        AllocationCounter::reset();
+
+        TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::phaseAllocations<TimeInput>());
+        TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::allocations());
+    }
+};
+
+}
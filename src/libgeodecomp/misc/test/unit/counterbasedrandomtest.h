@@ -0,0 +1,147 @@
+#include <libgeodecomp/misc/counterbasedrandom.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+
+#include <libflatarray/short_vec.hpp>
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class CounterBasedRandomTest : public CxxTest::TestSuite
+{
+public:
+    void testPhiloxKnownAnswers()
+    {
+        // test vectors taken from the Random123 distribution
+        unsigned counter1[4] = {0, 0, 0, 0};
+        unsigned key1[2] = {0, 0};
+        Philox4x32::bijection(counter1, key1);
+        TS_ASSERT_EQUALS(0x6627e8d5U, counter1[0]);
+        TS_ASSERT_EQUALS(0xe169c58dU, counter1[1]);
+        TS_ASSERT_EQUALS(0xbc57ac4cU, counter1[2]);
+        TS_ASSERT_EQUALS(0x9b00dbd8U, counter1[3]);
+
+        unsigned counter2[4] = {0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU};
+        unsigned key2[2] = {0xffffffffU, 0xffffffffU};
+        Philox4x32::bijection(counter2, key2);
+        TS_ASSERT_EQUALS(0x408f276dU, counter2[0]);
+        TS_ASSERT_EQUALS(0x41c83b0eU, counter2[1]);
+        TS_ASSERT_EQUALS(0xa20bc7c6U, counter2[2]);
+        TS_ASSERT_EQUALS(0x6d5451fdU, counter2[3]);
+
+        unsigned counter3[4] = {0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U};
+        unsigned key3[2] = {0xa4093822U, 0x299f31d0U};
+        Philox4x32::bijection(counter3, key3);
+        TS_ASSERT_EQUALS(0xd16cfe09U, counter3[0]);
+        TS_ASSERT_EQUALS(0x94fdccebU, counter3[1]);
+        TS_ASSERT_EQUALS(0x5001e420U, counter3[2]);
+        TS_ASSERT_EQUALS(0x24126ea1U, counter3[3]);
+    }
+
+    void testReproducibility()
+    {
+        std::vector<unsigned> vec1;
+        std::vector<unsigned> vec2;
+
+        CounterBasedRandom random1(47, Coord<2>(10, 20), 11, 1);
+        for (int i = 0; i < 10; ++i) {
+            vec1 << random1.genUnsigned();
+        }
+
+        // other generators in between don't interfere:
+        CounterBasedRandom other(47, Coord<2>(10, 21), 11, 1);
+        other.genUnsigned();
+
+        CounterBasedRandom random2(47, Coord<2>(10, 20), 11, 1);
+        for (int i = 0; i < 10; ++i) {
+            vec2 << random2.genUnsigned();
+        }
+
+        TS_ASSERT_EQUALS(vec1, vec2);
+    }
+
+    void testParametersYieldDistinctStreams()
+    {
+        std::vector<unsigned> firsts;
+        firsts << CounterBasedRandom(47, Coord<3>(1, 2, 3), 5, 0, 0).genUnsigned()
+               << CounterBasedRandom(48, Coord<3>(1, 2, 3), 5, 0, 0).genUnsigned()
+               << CounterBasedRandom(47, Coord<3>(2, 2, 3), 5, 0, 0).genUnsigned()
+               << CounterBasedRandom(47, Coord<3>(1, 3, 3), 5, 0, 0).genUnsigned()
+               << CounterBasedRandom(47, Coord<3>(1, 2, 4), 5, 0, 0).genUnsigned()
+               << CounterBasedRandom(47, Coord<3>(1, 2, 3), 6, 0, 0).genUnsigned()
+               << CounterBasedRandom(47, Coord<3>(1, 2, 3), 5, 1, 0).genUnsigned()
+               << CounterBasedRandom(47, Coord<3>(1, 2, 3), 5, 0, 1).genUnsigned();
+
+        for (std::size_t i = 0; i < firsts.size(); ++i) {
+            for (std::size_t j = i + 1; j < firsts.size(); ++j) {
+                TS_ASSERT_DIFFERS(firsts[i], firsts[j]);
+            }
+        }
+
+        // IDs and 1D coordinates are interchangeable:
+        TS_ASSERT_EQUALS(
+            CounterBasedRandom(47, 11u, 5).genUnsigned(),
+            CounterBasedRandom(47, Coord<1>(11), 5).genUnsigned());
+    }
+
+    void testDistribution()
+    {
+        CounterBasedRandom random(4711, Coord<2>(), 0);
+        double sum = 0;
+        int histogram[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+        for (int i = 0; i < 10000; ++i) {
+            double value = random.genDouble(2.0);
+            TS_ASSERT(value >= 0.0);
+            TS_ASSERT(value < 2.0);
+            sum += value;
+            ++histogram[random.genUnsigned(10)];
+        }
+
+        TS_ASSERT(9800 < sum);
+        TS_ASSERT(10200 > sum);
+        for (int i = 0; i < 10; ++i) {
+            TS_ASSERT(900 < histogram[i]);
+            TS_ASSERT(1100 > histogram[i]);
+        }
+    }
+
+    void testBulkMatchesSequential()
+    {
+        CounterBasedRandom random1(1, Coord<2>(3, 4), 5, 6, 7);
+        CounterBasedRandom random2(1, Coord<2>(3, 4), 5, 6, 7);
+
+        std::vector<double> expected;
+        for (int i = 0; i < 1003; ++i) {
+            expected << random1.genDouble(3.0);
+        }
+
+        // the odd offset ensures that the bulk generation starts in
+        // the middle of a block:
+        std::vector<double> actual(1003);
+        actual[0] = random2.genDouble(3.0);
+        random2.genDouble(&actual[1], 1002, 3.0);
+
+        TS_ASSERT_EQUALS(expected, actual);
+        TS_ASSERT_EQUALS(random1.genUnsigned(), random2.genUnsigned());
+    }
+
+    void testShortVec()
+    {
+        typedef LibFlatArray::short_vec<double, 8> ShortVec;
+        CounterBasedRandom random1(1, Coord<2>(3, 4), 5);
+        CounterBasedRandom random2(1, Coord<2>(3, 4), 5);
+
+        ShortVec vec;
+        random1.genDouble(&vec, 2.0);
+
+        double actual[8];
+        vec.store(actual);
+        for (int i = 0; i < 8; ++i) {
+            TS_ASSERT_EQUALS(random2.genDouble(2.0), actual[i]);
+        }
+    }
+};
+
+}
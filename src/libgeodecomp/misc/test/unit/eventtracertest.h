@@ -0,0 +1,134 @@
+#include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/misc/eventtracer.h>
+
+#include <cxxtest/TestSuite.h>
+#include <sstream>
+#include <vector>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+#include <thread>
+#endif
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class EventTracerTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        EventTracer::reset();
+        EventTracer::setStep(0);
+    }
+
+    void tearDown()
+    {
+        EventTracer::disable();
+        EventTracer::reset();
+    }
+
+    void testTimers()
+    {
+        Chronometer chrono;
+        {
+            TimeComputeInner t(&chrono);
+        }
+        TS_ASSERT_EQUALS(std::size_t(0), EventTracer::size());
+
+        EventTracer::enable();
+        EventTracer::setStep(5);
+        {
+            TimeTotal t(&chrono);
+            {
+                TimeComputeInner t(&chrono);
+            }
+            {
+                TimePatchProviders t(&chrono);
+            }
+        }
+        EventTracer::disable();
+        {
+            TimeComputeGhost t(&chrono);
+        }
+
+        std::stringstream buf;
+        EventTracer::writeChromeTrace(buf);
+        std::string trace = buf.str();
+        TS_ASSERT_EQUALS(0, trace.find("{\"traceEvents\":["));
+
+        if (EventTracer::compiledIn()) {
+            TS_ASSERT_EQUALS(std::size_t(3), EventTracer::size());
+            TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"name\":\"total_time\""));
+            TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"name\":\"compute_time_inner\""));
+            TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"name\":\"patch_providers_time\""));
+            TS_ASSERT_EQUALS(std::string::npos, trace.find("\"name\":\"compute_time_ghost\""));
+            TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"args\":{\"step\":5}"));
+        } else {
+            TS_ASSERT(!EventTracer::enabled());
+            TS_ASSERT_EQUALS(std::size_t(0), EventTracer::size());
+            TS_ASSERT_EQUALS(std::string::npos, trace.find("\"ph\":\"X\""));
+        }
+    }
+
+    void testRingBuffer()
+    {
+        EventTracer::enable(4);
+        for (int i = 0; i < 10; ++i) {
+            EventTracer::setStep(i);
+            EventTracer::record(TimeInput::ID, i, i + 0.5);
+        }
+
+        std::stringstream buf;
+        EventTracer::writeChromeTrace(buf);
+
+        if (EventTracer::compiledIn()) {
+            // only the last 4 events are retained:
+            TS_ASSERT_EQUALS(std::size_t(4), EventTracer::size());
+            TS_ASSERT_EQUALS(std::string::npos, buf.str().find("\"step\":5}"));
+            TS_ASSERT_DIFFERS(std::string::npos, buf.str().find("\"step\":6}"));
+            TS_ASSERT_DIFFERS(std::string::npos, buf.str().find("\"step\":9}"));
+        } else {
+            TS_ASSERT_EQUALS(std::size_t(0), EventTracer::size());
+        }
+    }
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+    void testThreads()
+    {
+        EventTracer::enable();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.push_back(std::thread(&EventTracerTest::recordEvents));
+        }
+        for (int i = 0; i < 4; ++i) {
+            threads[i].join();
+        }
+
+        std::stringstream buf;
+        EventTracer::writeChromeTrace(buf);
+
+        if (EventTracer::compiledIn()) {
+            TS_ASSERT_EQUALS(std::size_t(400), EventTracer::size());
+            for (int i = 0; i < 4; ++i) {
+                std::stringstream tid;
+                tid << "\"tid\":" << i << ",";
+                TS_ASSERT_DIFFERS(std::string::npos, buf.str().find(tid.str()));
+            }
+        } else {
+            TS_ASSERT_EQUALS(std::size_t(0), EventTracer::size());
+        }
+    }
+
+private:
+    static void recordEvents()
+    {
+        Chronometer chrono;
+        for (int i = 0; i < 100; ++i) {
+            TimeCompute t(&chrono);
+        }
+    }
+#endif
+};
+
+}
@@ -0,0 +1,145 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/hardwaretopology.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/misc/stringops.h>
+#include <libgeodecomp/misc/tempfile.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class HardwareTopologyTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        root = TempFile::serial("hardwaretopologytest");
+#ifndef _WIN32
+        mkdir(root.c_str(), 0700);
+        paths << root;
+        unsetenv("LIBGEODECOMP_LAST_LEVEL_CACHE_SIZE");
+#endif
+    }
+
+    void tearDown()
+    {
+        for (std::vector<std::string>::reverse_iterator i = paths.rbegin(); i != paths.rend(); ++i) {
+            remove(i->c_str());
+        }
+        paths.clear();
+    }
+
+    void testSysfs()
+    {
+#ifndef _WIN32
+        // 2 packages with 2 cores and 2 hyperthreads each:
+        write("cpu/online", "0-7");
+        for (int i = 0; i < 8; ++i) {
+            std::string prefix = "cpu/cpu" + StringOps::itoa(i) + "/topology/";
+            write(prefix + "physical_package_id", StringOps::itoa(i / 4));
+            write(prefix + "core_id",             StringOps::itoa(i % 2));
+        }
+
+        writeCache(0, 1, "Data",        "32K",  "0,4");
+        writeCache(1, 1, "Instruction", "32K",  "0,4");
+        writeCache(2, 3, "Unified",     "8M",   "0-3");
+        writeCache(3, 2, "Unified",     "256K", "0,4");
+        write("node/online", "0-1");
+
+        HardwareTopology topology(root);
+
+        std::vector<HardwareTopology::Cache> expected;
+        expected << HardwareTopology::Cache(1,      32 << 10, 64, 2)
+                 << HardwareTopology::Cache(2,     256 << 10, 64, 2)
+                 << HardwareTopology::Cache(3, std::size_t(8) << 20, 64, 4);
+        TS_ASSERT_EQUALS(expected, topology.caches());
+
+        TS_ASSERT_EQUALS(std::size_t(256 << 10), topology.cacheSize(2));
+        TS_ASSERT_EQUALS(std::size_t(0),         topology.cacheSize(4));
+        TS_ASSERT_EQUALS(std::size_t(8 << 20),   topology.lastLevelCacheSize());
+        TS_ASSERT_EQUALS(std::size_t(2 << 20),   topology.lastLevelCacheSizePerCPU());
+        TS_ASSERT_EQUALS(std::size_t(64),        topology.cacheLineSize());
+
+        TS_ASSERT_EQUALS(8, topology.numCPUs());
+        TS_ASSERT_EQUALS(4, topology.numCores());
+        TS_ASSERT_EQUALS(2, topology.numNUMANodes());
+
+        TS_ASSERT(!topology.useStreamingStores(8 << 20));
+        TS_ASSERT( topology.useStreamingStores((8 << 20) + 1));
+#endif
+    }
+
+    void testOverride()
+    {
+#ifndef _WIN32
+        writeCache(0, 3, "Unified", "8M", "0-3");
+        setenv("LIBGEODECOMP_LAST_LEVEL_CACHE_SIZE", "256M", 1);
+
+        HardwareTopology topology(root);
+        TS_ASSERT_EQUALS(std::size_t(256) << 20, topology.lastLevelCacheSize());
+        TS_ASSERT_EQUALS(std::size_t(64) << 20,  topology.lastLevelCacheSizePerCPU());
+        TS_ASSERT(!topology.useStreamingStores(std::size_t(100) << 20));
+
+        unsetenv("LIBGEODECOMP_LAST_LEVEL_CACHE_SIZE");
+#endif
+    }
+
+    void testLocal()
+    {
+        // we can't know what to expect, but results should be sane:
+        const HardwareTopology& topology = HardwareTopology::local();
+        TS_ASSERT_LESS_THAN_EQUALS(1, topology.numCPUs());
+        TS_ASSERT_LESS_THAN_EQUALS(1, topology.numCores());
+        TS_ASSERT_LESS_THAN_EQUALS(topology.numCores(), topology.numCPUs());
+        TS_ASSERT_LESS_THAN_EQUALS(1, topology.numNUMANodes());
+        TS_ASSERT_LESS_THAN(std::size_t(0), topology.lastLevelCacheSize());
+        TS_ASSERT_LESS_THAN(std::size_t(0), topology.cacheLineSize());
+        TS_ASSERT_EQUALS(&topology, &HardwareTopology::local());
+    }
+
+private:
+    std::string root;
+    std::vector<std::string> paths;
+
+    void writeCache(int index, int level, const std::string& type, const std::string& size, const std::string& sharedCPUs)
+    {
+        std::string prefix = "cpu/cpu0/cache/index" + StringOps::itoa(index) + "/";
+        write(prefix + "level",               StringOps::itoa(level));
+        write(prefix + "type",                type);
+        write(prefix + "size",                size);
+        write(prefix + "coherency_line_size", "64");
+        write(prefix + "shared_cpu_list",     sharedCPUs);
+    }
+
+    void write(const std::string& path, const std::string& content)
+    {
+#ifndef _WIN32
+        StringVec components = StringOps::tokenize(path, "/");
+        std::string current = root;
+
+        for (std::size_t i = 0; i < (components.size() - 1); ++i) {
+            current += "/" + components[i];
+            if (access(current.c_str(), F_OK) != 0) {
+                mkdir(current.c_str(), 0700);
+                paths << current;
+            }
+        }
+
+        current += "/" + components.back();
+        std::ofstream file(current.c_str());
+        file << content << "\n";
+        paths << current;
+#endif
+    }
+};
+
+}
@@ -0,0 +1,131 @@
+#include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/misc/perfcounters.h>
+
+#include <cxxtest/TestSuite.h>
+#include <vector>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class PerfCountersTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        PerfCounters::reset();
+        PerfCounters::enable();
+    }
+
+    void tearDown()
+    {
+        PerfCounters::disable();
+        PerfCounters::reset();
+    }
+
+    void testPhases()
+    {
+        Chronometer chrono;
+        {
+            TimeComputeInner t(&chrono);
+            busyWork();
+        }
+        chrono.addTime<TimeComputeGhost>(1.0);
+
+        for (std::size_t i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {
+            TS_ASSERT_EQUALS(0, chrono.counter<TimeComputeGhost>(i));
+            TS_ASSERT_EQUALS(0, chrono.counter<TimeTotal>(i));
+            TS_ASSERT_EQUALS(chrono.counter<TimeCompute>(i), chrono.counter<TimeComputeInner>(i));
+            TS_ASSERT_EQUALS(
+                PerfCounters::phaseCounter<TimeComputeInner>(i),
+                chrono.counter<TimeComputeInner>(i));
+        }
+
+        if (!PerfCounters::compiledIn()) {
+            TS_ASSERT(!PerfCounters::enabled());
+            TS_ASSERT_EQUALS(0, chrono.counter<TimeComputeInner>(PerfCounters::CPU_TIME));
+            return;
+        }
+
+        double cpuTime = chrono.counter<TimeComputeInner>(PerfCounters::CPU_TIME);
+        TS_ASSERT(cpuTime > 0);
+        TS_ASSERT(cpuTime < 2 * chrono.interval<TimeComputeInner>() + 0.01);
+
+        if (PerfCounters::hardwareAvailable()) {
+            TS_ASSERT(chrono.counter<TimeComputeInner>(PerfCounters::CYCLES) > 0);
+            TS_ASSERT(chrono.counter<TimeComputeInner>(PerfCounters::INSTRUCTIONS) > 1e6);
+        }
+
+        TS_ASSERT_DIFFERS(std::string::npos, chrono.report().find("CPU time"));
+    }
+
+    void testDisabled()
+    {
+        PerfCounters::disable();
+
+        Chronometer chrono;
+        {
+            TimeCompute t(&chrono);
+            busyWork();
+        }
+
+        double values[PerfCounters::NUM_COUNTERS];
+        TS_ASSERT(!PerfCounters::sample(values));
+        for (std::size_t i = 0; i < PerfCounters::NUM_COUNTERS; ++i) {
+            TS_ASSERT_EQUALS(0, chrono.counter<TimeCompute>(i));
+            TS_ASSERT_EQUALS(0, PerfCounters::phaseCounter<TimeCompute>(i));
+        }
+    }
+
+    void testAggregation()
+    {
+#ifdef LIBGEODECOMP_WITH_PERF_COUNTERS
+        Chronometer a;
+        Chronometer b;
+        a.rawTotalCounters()[TimeInput::ID * PerfCounters::NUM_COUNTERS + PerfCounters::CYCLES] = 10;
+        b.rawTotalCounters()[TimeInput::ID * PerfCounters::NUM_COUNTERS + PerfCounters::CYCLES] = 5;
+
+        Chronometer c = a + b;
+        TS_ASSERT_EQUALS(15, c.counter<TimeInput>(PerfCounters::CYCLES));
+        TS_ASSERT_EQUALS(0,  c.counter<TimeInput>(PerfCounters::INSTRUCTIONS));
+
+        c.reset();
+        TS_ASSERT_EQUALS(0, c.counter<TimeInput>(PerfCounters::CYCLES));
+#endif
+    }
+
+    void testDescribe()
+    {
+        double values[PerfCounters::NUM_COUNTERS];
+        values[PerfCounters::CYCLES] = 2e9;
+        values[PerfCounters::INSTRUCTIONS] = 3e9;
+        values[PerfCounters::LLC_MISSES] = 1e8;
+        values[PerfCounters::CPU_TIME] = 1;
+
+        std::string description = PerfCounters::describe(2.0, values);
+        TS_ASSERT_DIFFERS(std::string::npos, description.find("IPC 1.5"));
+        TS_ASSERT_DIFFERS(std::string::npos, description.find("3.2 GB/s"));
+
+        values[PerfCounters::CYCLES] = 0;
+        description = PerfCounters::describe(2.0, values);
+        TS_ASSERT_DIFFERS(std::string::npos, description.find("hardware counters n/a"));
+
+        TS_ASSERT_EQUALS("llc_misses", PerfCounters::counterName(PerfCounters::LLC_MISSES));
+    }
+
+private:
+    void busyWork()
+    {
+        std::vector<double> buf(1 << 16, 1.0);
+        for (int i = 0; i < 100; ++i) {
+            for (std::size_t j = 1; j < buf.size(); ++j) {
+                buf[j] += 0.5 * buf[j - 1];
+            }
+        }
+        sum = buf.back();
+    }
+
+    double sum;
+};
+
+}
@@ -0,0 +1,153 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/workstealingpool.h>
+
+#include <stdexcept>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class WorkStealingPoolTest : public CxxTest::TestSuite
+{
+public:
+#ifdef LIBGEODECOMP_WITH_THREADS
+    /**
+     * Recursively splits the range [begin, end) and sums up the
+     * squares of its elements, waiting for its children from within
+     * a task.
+     */
+    static void sumSquares(WorkStealingPool *pool, int begin, int end, std::atomic<long> *sum)
+    {
+        if ((end - begin) <= 16) {
+            long local = 0;
+            for (int i = begin; i < end; ++i) {
+                local += long(i) * i;
+            }
+            *sum += local;
+            return;
+        }
+
+        int middle = begin + (end - begin) / 2;
+        WorkStealingPool::TaskGroup group;
+        pool->submit(&group, [pool, begin, middle, sum]() {
+                sumSquares(pool, begin, middle, sum);
+            });
+        pool->submit(&group, [pool, middle, end, sum]() {
+                sumSquares(pool, middle, end, sum);
+            });
+        pool->wait(&group);
+    }
+#endif
+
+    void testBasic()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        WorkStealingPool pool(3);
+        TS_ASSERT_EQUALS(std::size_t(3), pool.numThreads());
+        TS_ASSERT(!pool.isWorker());
+
+        std::vector<int> results(1000, 0);
+        WorkStealingPool::TaskGroup group;
+        TS_ASSERT(group.done());
+
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit(&group, [&results, i]() {
+                    results[i] = i * 2;
+                });
+        }
+        pool.wait(&group);
+        TS_ASSERT(group.done());
+
+        for (int i = 0; i < 1000; ++i) {
+            TS_ASSERT_EQUALS(i * 2, results[i]);
+        }
+#endif
+    }
+
+    void testDefaultNumberOfThreads()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        WorkStealingPool pool;
+        TS_ASSERT(pool.numThreads() >= 1);
+#endif
+    }
+
+    void testNestedTasksOnSingleWorker()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        // nested waits must not deadlock, even if only one worker is
+        // available:
+        for (std::size_t threads = 1; threads <= 4; ++threads) {
+            WorkStealingPool pool(threads);
+            std::atomic<long> sum(0);
+
+            WorkStealingPool::TaskGroup group;
+            pool.submit(&group, [&pool, &sum]() {
+                    sumSquares(&pool, 0, 1000, &sum);
+                });
+            pool.wait(&group);
+
+            TS_ASSERT_EQUALS(999L * 1000 * 1999 / 6, sum.load());
+        }
+#endif
+    }
+
+    void testTasksSpawningTasks()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        // tasks may add successors to their own group without waiting
+        // for them, just like dataflow continuations:
+        WorkStealingPool pool(2);
+        WorkStealingPool::TaskGroup group;
+        std::atomic<int> counter(0);
+
+        std::function<void(int)> chain = [&pool, &group, &counter, &chain](int remaining) {
+            ++counter;
+            if (remaining > 0) {
+                pool.submit(&group, [&chain, remaining]() {
+                        chain(remaining - 1);
+                    });
+            }
+        };
+
+        for (int i = 0; i < 10; ++i) {
+            pool.submit(&group, [&chain]() {
+                    chain(99);
+                });
+        }
+        pool.wait(&group);
+
+        TS_ASSERT_EQUALS(1000, counter.load());
+#endif
+    }
+
+    void testExceptionsAreRethrownByWait()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        WorkStealingPool pool(2);
+        WorkStealingPool::TaskGroup group;
+        std::atomic<int> counter(0);
+
+        for (int i = 0; i < 10; ++i) {
+            pool.submit(&group, [&counter, i]() {
+                    ++counter;
+                    if (i == 5) {
+                        throw std::logic_error("boom");
+                    }
+                });
+        }
+
+        TS_ASSERT_THROWS(pool.wait(&group), std::logic_error&);
+        TS_ASSERT_EQUALS(10, counter.load());
+
+        // the pool remains usable:
+        pool.submit(&group, [&counter]() {
+                ++counter;
+            });
+        pool.wait(&group);
+        TS_ASSERT_EQUALS(11, counter.load());
+#endif
+    }
+};
+
+}
@@ -0,0 +1,330 @@
+#ifndef LIBGEODECOMP_MISC_WORKSTEALINGPOOL_H
+#define LIBGEODECOMP_MISC_WORKSTEALINGPOOL_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_THREADS
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * A persistent set of worker threads which execute std::function
+ * tasks. Each worker owns a deque: it pushes and pops its own tasks
+ * at the back (LIFO, which keeps recently touched data in cache),
+ * while idle workers steal from the front of their peers' deques.
+ * Tasks submitted by threads outside of the pool end up in a shared
+ * queue.
+ *
+ * Tasks are tracked via TaskGroups. Waiting for a TaskGroup doesn't
+ * block the calling thread: it will execute pending tasks until the
+ * group is done. Hence tasks may spawn and wait for further tasks
+ * without risking a deadlock, even on a pool with a single worker.
+ * Exceptions thrown by tasks are rethrown by wait().
+ */
+class WorkStealingPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     * Counts the tasks which have been submitted for it but have not
+     * yet finished. Tasks may add more tasks to their own group.
+     */
+    class TaskGroup
+    {
+    public:
+        friend class WorkStealingPool;
+
+        TaskGroup() :
+            pending(0)
+        {}
+
+        bool done() const
+        {
+            return pending.load() == 0;
+        }
+
+    private:
+        std::atomic<std::size_t> pending;
+        std::mutex exceptionMutex;
+        std::exception_ptr exception;
+
+        TaskGroup(const TaskGroup&);
+        TaskGroup& operator=(const TaskGroup&);
+    };
+
+    /**
+     * Spawns numThreads workers. 0 selects one worker per hardware
+     * thread.
+     */
+    explicit WorkStealingPool(std::size_t numThreads = 0) :
+        queued(0),
+        sleepers(0),
+        shutdown(false)
+    {
+        if (numThreads == 0) {
+            numThreads = std::thread::hardware_concurrency();
+        }
+        if (numThreads == 0) {
+            numThreads = 1;
+        }
+
+        // one deque per worker plus the shared one for outsiders:
+        queues.reserve(numThreads + 1);
+        for (std::size_t i = 0; i <= numThreads; ++i) {
+            queues.push_back(new Queue);
+        }
+
+        threads.reserve(numThreads);
+        for (std::size_t i = 0; i < numThreads; ++i) {
+            threads.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+        }
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            shutdown = true;
+        }
+        wakeup.notify_all();
+
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+        for (std::size_t i = 0; i < queues.size(); ++i) {
+            delete queues[i];
+        }
+    }
+
+    /**
+     * A process-wide pool with one worker per hardware thread. It's
+     * created upon first use.
+     */
+    static WorkStealingPool& global()
+    {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    std::size_t numThreads() const
+    {
+        return threads.size();
+    }
+
+    /**
+     * Returns true iff the calling thread is one of this pool's
+     * workers.
+     */
+    bool isWorker() const
+    {
+        return identity().pool == this;
+    }
+
+    void submit(TaskGroup *group, const Task& task)
+    {
+        ++group->pending;
+        Queue *queue = queues[ownQueueIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->items.push_back(Item(task, group));
+        }
+
+        ++queued;
+        if (sleepers.load() > 0) {
+            // locking prevents the notification from slipping in
+            // between a sleeper's check and its wait:
+            { std::lock_guard<std::mutex> lock(sleepMutex); }
+            wakeup.notify_one();
+        }
+    }
+
+    /**
+     * Executes tasks until all tasks of the given group are done.
+     * Rethrows the first exception any of the group's tasks threw.
+     */
+    void wait(TaskGroup *group)
+    {
+        std::size_t self = ownQueueIndex();
+
+        while (!group->done()) {
+            if (runOneTask(self)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            ++sleepers;
+            while (!group->done() && (queued.load() == 0)) {
+                wakeup.wait(lock);
+            }
+            --sleepers;
+        }
+
+        std::exception_ptr exception;
+        {
+            std::lock_guard<std::mutex> lock(group->exceptionMutex);
+            std::swap(exception, group->exception);
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+private:
+    class Item
+    {
+    public:
+        Item(const Task& task = Task(), TaskGroup *group = 0) :
+            task(task),
+            group(group)
+        {}
+
+        Task task;
+        TaskGroup *group;
+    };
+
+    class Queue
+    {
+    public:
+        std::mutex mutex;
+        std::deque<Item> items;
+    };
+
+    class Identity
+    {
+    public:
+        const WorkStealingPool *pool;
+        std::size_t index;
+    };
+
+    std::vector<Queue*> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> queued;
+    std::atomic<std::size_t> sleepers;
+    std::mutex sleepMutex;
+    std::condition_variable wakeup;
+    bool shutdown;
+
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator=(const WorkStealingPool&);
+
+    static Identity& identity()
+    {
+        static thread_local Identity id = { 0, 0 };
+        return id;
+    }
+
+    std::size_t ownQueueIndex() const
+    {
+        const Identity& id = identity();
+        if (id.pool == this) {
+            return id.index;
+        }
+
+        return threads.size();
+    }
+
+    void workerLoop(std::size_t index)
+    {
+        Identity& id = identity();
+        id.pool = this;
+        id.index = index;
+
+        for (;;) {
+            if (runOneTask(index)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            ++sleepers;
+            while (!shutdown && (queued.load() == 0)) {
+                wakeup.wait(lock);
+            }
+            --sleepers;
+            if (shutdown) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Pops the youngest task off our own deque, otherwise steals the
+     * oldest one from the shared queue or one of the other workers.
+     */
+    bool runOneTask(std::size_t self)
+    {
+        Item item;
+        if (!popBack(self, &item)) {
+            std::size_t n = queues.size();
+            bool found = false;
+            for (std::size_t i = 1; i < n; ++i) {
+                if (popFront((self + n - i) % n, &item)) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+
+        --queued;
+        TaskGroup *group = item.group;
+        try {
+            item.task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(group->exceptionMutex);
+            if (!group->exception) {
+                group->exception = std::current_exception();
+            }
+        }
+
+        if (--group->pending == 0) {
+            // waiters might be asleep:
+            { std::lock_guard<std::mutex> lock(sleepMutex); }
+            wakeup.notify_all();
+        }
+
+        return true;
+    }
+
+    bool popBack(std::size_t index, Item *item)
+    {
+        Queue *queue = queues[index];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (queue->items.empty()) {
+            return false;
+        }
+
+        *item = queue->items.back();
+        queue->items.pop_back();
+        return true;
+    }
+
+    bool popFront(std::size_t index, Item *item)
+    {
+        Queue *queue = queues[index];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (queue->items.empty()) {
+            return false;
+        }
+
+        *item = queue->items.front();
+        queue->items.pop_front();
+        return true;
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -5,7 +5,9 @@
 #ifdef LIBGEODECOMP_WITH_THREADS
 
 #include <omp.h>
+#include <cmath>
 #include <libgeodecomp/io/logger.h>
+#include <libgeodecomp/misc/hardwaretopology.h>
 #include <libgeodecomp/parallelization/monolithicsimulator.h>
 #include <libgeodecomp/storage/displacedgrid.h>
 #include <libgeodecomp/storage/updatefunctor.h>
@@ -33,25 +35,36 @@ public:
     using MonolithicSimulator<CELL>::NANO_STEPS;
     using MonolithicSimulator<CELL>::chronometer;
 
+    /**
+     * If no wavefrontDim is given, it'll be chosen so that each
+     * thread's buffer fits into its share of the last level cache
+     * (see estimateWavefrontDim()).
+     */
     CacheBlockingSimulator(
         Initializer<CELL> *initializer,
         int pipelineLength,
-        const Coord<DIM - 1>& wavefrontDim) :
+        const Coord<DIM - 1>& wavefrontDim = Coord<DIM - 1>()) :
         MonolithicSimulator<CELL>(initializer),
         buffers(omp_get_max_threads()),
         pipelineLength(pipelineLength),
         wavefrontDim(wavefrontDim)
     {
         Coord<DIM> dim = initializer->gridBox().dimensions;
+        if (wavefrontDim == Coord<DIM - 1>()) {
+            this->wavefrontDim = estimateWavefrontDim(
+                dim,
+                pipelineLength,
+                HardwareTopology::local().lastLevelCacheSizePerCPU());
+            LOG(DBG, "selected wavefrontDim " << this->wavefrontDim);
+        }
         curGrid = new GridType(dim);
         newGrid = new GridType(dim);
-        initializer->grid(curGrid);
-        initializer->grid(newGrid);
+        initializer->initGrids(curGrid, newGrid);
 
         Coord<DIM> bufferDim;
 
         for (int i = 0; i < DIM - 1; ++i) {
-            bufferDim[i] = wavefrontDim[i] + 2 * pipelineLength - 2;
+            bufferDim[i] = this->wavefrontDim[i] + 2 * pipelineLength - 2;
         }
         bufferDim[DIM - 1] = pipelineLength * 4 - 4;
 
@@ -77,7 +90,7 @@ public:
 
     virtual void run()
     {
-        initializer->grid(curGrid);
+        initializer->initGrids(curGrid);
         stepNum = initializer->startStep();
         nanoStep = 0;
 
@@ -106,7 +119,60 @@ public:
         return curGrid;
     }
 
+    /**
+     * Returns the largest wavefront with equal sides (a square in
+     * 3D, a line in 2D) for which a single buffer (including the
+     * halo required by the pipeline) will fit into cacheSize bytes.
+     * The result is clamped to the grid's dimensions.
+     */
+    static Coord<DIM - 1> estimateWavefrontDim(
+        const Coord<DIM>& gridDim,
+        int pipelineLength,
+        std::size_t cacheSize)
+    {
+        std::size_t halo = 2 * pipelineLength - 2;
+        std::size_t depth = (std::max)(1, pipelineLength * 4 - 4);
+        std::size_t maxCells = cacheSize / sizeof(CELL) / depth;
+        std::size_t side = maxSide(maxCells);
+
+        Coord<DIM - 1> ret;
+        for (int i = 0; i < (DIM - 1); ++i) {
+            std::size_t length = (side > halo) ? (side - halo) : 1;
+            ret[i] = (std::min)(std::size_t(gridDim[i]), length);
+            ret[i] = (std::max)(1, ret[i]);
+        }
+
+        return ret;
+    }
+
 private:
+    /**
+     * Largest side length of a (DIM - 1)-dimensional cube with at
+     * most maxCells cells. pow() may be off by one, hence the
+     * correction.
+     */
+    static std::size_t maxSide(std::size_t maxCells)
+    {
+        std::size_t side = std::pow(double(maxCells), 1.0 / (DIM - 1));
+        while ((side > 0) && (volume(side) > maxCells)) {
+            --side;
+        }
+        while (volume(side + 1) <= maxCells) {
+            ++side;
+        }
+
+        return side;
+    }
+
+    static std::size_t volume(std::size_t side)
+    {
+        std::size_t ret = 1;
+        for (int i = 0; i < (DIM - 1); ++i) {
+            ret *= side;
+        }
+        return ret;
+    }
+
     using MonolithicSimulator<CELL>::initializer;
     using MonolithicSimulator<CELL>::steerers;
     using MonolithicSimulator<CELL>::stepNum;
@@ -463,6 +463,7 @@ public:
                     feedback);
             }
         }
+        feedback->applyStaticData();
 
         for (unsigned i = 0; i < APITraits::SelectNanoSteps<CELL_TYPE>::VALUE; ++i) {
             nanoStep(i);
@@ -0,0 +1,450 @@
+#ifndef LIBGEODECOMP_PARALLELIZATION_DATAFLOWSIMULATOR_H
+#define LIBGEODECOMP_PARALLELIZATION_DATAFLOWSIMULATOR_H
+
+// include this file first to avoid clashes of Intel MPI with stdio.h.
+#include <libgeodecomp/misc/apitraits.h>
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_THREADS
+
+#include <libgeodecomp/misc/workstealingpool.h>
+#include <libgeodecomp/parallelization/serialsimulator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * DataflowSimulator runs a model on a shared memory machine without
+ * global synchronization per time step. The grid is cut into chunks
+ * (tiles for structured grids, ranges of IDs for unstructured ones)
+ * and each chunk's update for a given nano step is a task on a
+ * WorkStealingPool. A task becomes ready once the same chunk and all
+ * of its neighbors have completed the preceding nano step, so fast
+ * regions may run ahead of slow ones, by at most maxLag time steps
+ * (counted from the slowest chunk). Only the steps at which Writers
+ * or Steerers are due act as global barriers.
+ *
+ * This is a shared memory variant of HPXDataflowSimulator which
+ * requires nothing beyond the C++ standard library. Models with
+ * APITraits::HasActiveRegion are supported, but always updated
+ * completely.
+ */
+template<typename CELL_TYPE>
+class DataflowSimulator : public SerialSimulator<CELL_TYPE>
+{
+public:
+    friend class DataflowSimulatorTest;
+    typedef typename SerialSimulator<CELL_TYPE>::GridType GridType;
+    typedef typename SerialSimulator<CELL_TYPE>::Topology Topology;
+    typedef typename SerialSimulator<CELL_TYPE>::SteererFeedback SteererFeedback;
+    typedef typename APITraits::SelectStencil<CELL_TYPE>::Value Stencil;
+
+    static const int DIM = Topology::DIM;
+
+    using SerialSimulator<CELL_TYPE>::NANO_STEPS;
+    using SerialSimulator<CELL_TYPE>::chronometer;
+    using SerialSimulator<CELL_TYPE>::curGrid;
+    using SerialSimulator<CELL_TYPE>::gridDim;
+    using SerialSimulator<CELL_TYPE>::handleInput;
+    using SerialSimulator<CELL_TYPE>::handleOutput;
+    using SerialSimulator<CELL_TYPE>::initializer;
+    using SerialSimulator<CELL_TYPE>::newGrid;
+    using SerialSimulator<CELL_TYPE>::setIORegions;
+    using SerialSimulator<CELL_TYPE>::simArea;
+    using SerialSimulator<CELL_TYPE>::steerers;
+    using SerialSimulator<CELL_TYPE>::stepNum;
+    using SerialSimulator<CELL_TYPE>::writers;
+
+    /**
+     * Components of chunkDimensions which are 0 will be chosen
+     * automatically, as will the number of threads. For unstructured
+     * grids the chunk size is rounded up to a multiple of the
+     * SELL-C-SIGMA block size, as cells may be reordered within
+     * those blocks.
+     */
+    explicit DataflowSimulator(
+        Initializer<CELL_TYPE> *initializer,
+        const Coord<DIM>& chunkDimensions = Coord<DIM>(),
+        unsigned maxLag = 2,
+        std::size_t numThreads = 0) :
+        SerialSimulator<CELL_TYPE>(initializer),
+        maxLag(maxLag),
+        pool(numThreads),
+        tasks(0)
+    {
+        decompose(chunkDimensions, Topology());
+
+        dependencyCounters = std::vector<std::atomic<int> >(2 * chunkRegions.size());
+        ringSize = (maxLag + 2) * NANO_STEPS;
+        stageCounters = std::vector<std::atomic<std::size_t> >(ringSize);
+        stageDone = std::vector<char>(ringSize, false);
+    }
+
+    virtual void step()
+    {
+        SteererFeedback feedback;
+        step(&feedback);
+    }
+
+    virtual void step(SteererFeedback *feedback)
+    {
+        handleInput(STEERER_NEXT_STEP, feedback);
+        runSteps(1);
+    }
+
+    virtual void run()
+    {
+        initializer->initGrids(curGrid);
+        stepNum = initializer->startStep();
+        setIORegions();
+
+        SteererFeedback feedback;
+        handleInput(STEERER_INITIALIZED, &feedback);
+        handleOutput(WRITER_INITIALIZED);
+
+        while (stepNum < initializer->maxSteps()) {
+            if (feedback.simulationEnded()) {
+                break;
+            }
+
+            handleInput(STEERER_NEXT_STEP, &feedback);
+            unsigned steps = nextBarrier() - stepNum;
+            if (feedback.simulationEnded()) {
+                // SerialSimulator would still complete this step:
+                steps = 1;
+            }
+            runSteps(steps);
+        }
+
+        handleInput(STEERER_ALL_DONE, &feedback);
+    }
+
+    std::size_t numChunks() const
+    {
+        return chunkRegions.size();
+    }
+
+protected:
+    std::vector<Region<DIM> > chunkRegions;
+    std::vector<std::vector<std::size_t> > chunkNeighbors;
+    unsigned maxLag;
+    WorkStealingPool pool;
+
+    // state of the current epoch, i.e. the steps between two barriers:
+    WorkStealingPool::TaskGroup *tasks;
+    GridType *grids[2];
+    std::size_t numStages;
+    std::size_t ringSize;
+    std::vector<std::atomic<int> > dependencyCounters;
+    std::vector<std::atomic<std::size_t> > stageCounters;
+    std::vector<char> stageDone;
+    std::atomic<std::size_t> lowestPendingStage;
+    std::vector<std::pair<std::size_t, std::size_t> > deferredTasks;
+    std::mutex lagMutex;
+
+    /**
+     * Returns the next step at which any Writer or Steerer needs to
+     * see the grid.
+     */
+    unsigned nextBarrier() const
+    {
+        unsigned ret = initializer->maxSteps();
+
+        for (std::size_t i = 0; i < writers.size(); ++i) {
+            unsigned period = writers[i]->getPeriod();
+            ret = (std::min)(ret, (stepNum / period + 1) * period);
+        }
+        for (std::size_t i = 0; i < steerers.size(); ++i) {
+            unsigned period = steerers[i]->getPeriod();
+            ret = (std::min)(ret, (stepNum / period + 1) * period);
+        }
+
+        return ret;
+    }
+
+    void runSteps(unsigned steps)
+    {
+        using std::swap;
+
+        {
+            TimeTotal t(&chronometer);
+            TimeCompute c(&chronometer);
+
+            runEpoch(std::size_t(steps) * NANO_STEPS);
+            if (numStages % 2) {
+                swap(curGrid, newGrid);
+            }
+        }
+
+        stepNum += steps;
+
+        WriterEvent event = WRITER_STEP_FINISHED;
+        if (stepNum == initializer->maxSteps()) {
+            event = WRITER_ALL_DONE;
+        }
+        handleOutput(event);
+    }
+
+    void runEpoch(std::size_t stages)
+    {
+        WorkStealingPool::TaskGroup group;
+        tasks = &group;
+        grids[0] = curGrid;
+        grids[1] = newGrid;
+        numStages = stages;
+        lowestPendingStage = 0;
+
+        for (std::size_t i = 0; i < ringSize; ++i) {
+            stageCounters[i] = 0;
+            stageDone[i] = false;
+        }
+        for (std::size_t c = 0; c < chunkRegions.size(); ++c) {
+            dependencyCounters[2 * c + 1] = numDependencies(c);
+        }
+        for (std::size_t c = 0; c < chunkRegions.size(); ++c) {
+            trigger(c, 0);
+        }
+
+        pool.wait(&group);
+        tasks = 0;
+    }
+
+    int numDependencies(std::size_t chunk) const
+    {
+        return chunkNeighbors[chunk].size() + 1;
+    }
+
+    /**
+     * Stage s reads from grids[s % 2] and writes to grids[(s + 1) %
+     * 2]. It depends on stage s - 1 of the chunk itself and of its
+     * neighbors: these wrote its input (read after write) and read
+     * the cells which stage s will overwrite (write after read). As
+     * neighborhood is symmetric, both boil down to the same set.
+     */
+    void trigger(std::size_t chunk, std::size_t stage)
+    {
+        // no decrements for stage + 2 can occur before this chunk
+        // and its neighbors have completed stage + 1:
+        dependencyCounters[2 * chunk + stage % 2] = numDependencies(chunk);
+
+        if (!admissible(stage, lowestPendingStage.load())) {
+            std::lock_guard<std::mutex> lock(lagMutex);
+            if (!admissible(stage, lowestPendingStage.load())) {
+                deferredTasks.push_back(std::make_pair(chunk, stage));
+                return;
+            }
+        }
+
+        spawn(chunk, stage);
+    }
+
+    bool admissible(std::size_t stage, std::size_t lowestStage) const
+    {
+        return (stage / NANO_STEPS) <= (lowestStage / NANO_STEPS + maxLag);
+    }
+
+    void spawn(std::size_t chunk, std::size_t stage)
+    {
+        pool.submit(tasks, [this, chunk, stage]() {
+                update(chunk, stage);
+            });
+    }
+
+    void update(std::size_t chunk, std::size_t stage)
+    {
+        UpdateFunctor<CELL_TYPE>()(
+            chunkRegions[chunk],
+            Coord<DIM>(),
+            Coord<DIM>(),
+            *grids[stage % 2],
+            grids[(stage + 1) % 2],
+            stage % NANO_STEPS);
+
+        std::size_t nextStage = stage + 1;
+        if (nextStage < numStages) {
+            release(chunk, nextStage);
+            for (std::size_t i = 0; i < chunkNeighbors[chunk].size(); ++i) {
+                release(chunkNeighbors[chunk][i], nextStage);
+            }
+        }
+
+        if (++stageCounters[stage % ringSize] == chunkRegions.size()) {
+            stageFinished(stage);
+        }
+    }
+
+    void release(std::size_t chunk, std::size_t stage)
+    {
+        if (--dependencyCounters[2 * chunk + stage % 2] == 0) {
+            trigger(chunk, stage);
+        }
+    }
+
+    /**
+     * Advances the lowest pending stage and hands out tasks which had
+     * been held back to limit the lag. Stages may finish out of
+     * order, hence the bookkeeping via stageDone. A slot in the ring
+     * can't be reused before its stage has finished as at most
+     * (maxLag + 1) * NANO_STEPS stages may be in flight.
+     */
+    void stageFinished(std::size_t stage)
+    {
+        std::vector<std::pair<std::size_t, std::size_t> > ready;
+        {
+            std::lock_guard<std::mutex> lock(lagMutex);
+            stageDone[stage % ringSize] = true;
+
+            std::size_t lowest = lowestPendingStage.load();
+            while ((lowest < numStages) && stageDone[lowest % ringSize]) {
+                stageDone[lowest % ringSize] = false;
+                stageCounters[lowest % ringSize] = 0;
+                ++lowest;
+            }
+            lowestPendingStage = lowest;
+
+            std::vector<std::pair<std::size_t, std::size_t> > stillDeferred;
+            for (std::size_t i = 0; i < deferredTasks.size(); ++i) {
+                if (admissible(deferredTasks[i].second, lowest)) {
+                    ready.push_back(deferredTasks[i]);
+                } else {
+                    stillDeferred.push_back(deferredTasks[i]);
+                }
+            }
+            swap(deferredTasks, stillDeferred);
+        }
+
+        for (std::size_t i = 0; i < ready.size(); ++i) {
+            spawn(ready[i].first, ready[i].second);
+        }
+    }
+
+    /**
+     * Cuts a structured grid into tiles. Neighbors are all tiles
+     * intersecting the tile's box, expanded by the stencil's radius
+     * (wrapped around on periodic axes). Tiles at the upper end of
+     * an axis may be thinner than the rest, hence we can't derive
+     * neighbors from the nominal tile size alone.
+     */
+    template<typename TOPOLOGY>
+    void decompose(const Coord<DIM>& requestedChunkDim, TOPOLOGY /* unused */)
+    {
+        Coord<DIM> chunkDim = requestedChunkDim;
+        std::size_t volume = 1;
+        for (int d = 0; d < DIM; ++d) {
+            if (chunkDim[d] <= 0) {
+                // long streaks for the UpdateFunctor, ~16k cells per chunk:
+                chunkDim[d] = (d == 0) ? gridDim[0] :
+                    (std::max)(1, (std::min)(gridDim[d], int(16384 / volume)));
+            }
+            chunkDim[d] = (std::min)(chunkDim[d], gridDim[d]);
+            volume *= chunkDim[d];
+        }
+
+        Coord<DIM> tiles;
+        for (int d = 0; d < DIM; ++d) {
+            tiles[d] = (gridDim[d] + chunkDim[d] - 1) / chunkDim[d];
+        }
+
+        CoordBox<DIM> tileBox(Coord<DIM>(), tiles);
+        Region<DIM> gridRegion;
+        gridRegion << CoordBox<DIM>(Coord<DIM>(), gridDim);
+        chunkRegions.resize(tileBox.size());
+        chunkNeighbors.resize(tileBox.size());
+
+        for (typename CoordBox<DIM>::Iterator i = tileBox.begin(); i != tileBox.end(); ++i) {
+            std::size_t index = i->toIndex(tiles);
+            Coord<DIM> origin;
+            for (int d = 0; d < DIM; ++d) {
+                origin[d] = (*i)[d] * chunkDim[d];
+            }
+            Region<DIM> chunk;
+            chunk << CoordBox<DIM>(origin, chunkDim);
+            chunk &= gridRegion;
+            chunkRegions[index] = curGrid->remapRegion(chunk & simArea);
+
+            Region<DIM> halo = chunk.expandWithTopology(Stencil::RADIUS, gridDim, Topology());
+            halo &= gridRegion;
+            halo -= chunk;
+
+            std::vector<std::size_t>& neighbors = chunkNeighbors[index];
+            for (typename Region<DIM>::StreakIterator s = halo.beginStreak(); s != halo.endStreak(); ++s) {
+                Coord<DIM> neighbor;
+                for (int d = 1; d < DIM; ++d) {
+                    neighbor[d] = s->origin[d] / chunkDim[d];
+                }
+                int first = s->origin.x() / chunkDim.x();
+                int last = (s->endX - 1) / chunkDim.x();
+                for (neighbor.x() = first; neighbor.x() <= last; ++neighbor.x()) {
+                    if (neighbor != *i) {
+                        neighbors.push_back(neighbor.toIndex(tiles));
+                    }
+                }
+            }
+
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        }
+    }
+
+    /**
+     * Cuts an unstructured grid into ranges of IDs. Neighbors are
+     * derived from the adjacency and made symmetric.
+     */
+    void decompose(const Coord<DIM>& requestedChunkDim, Topologies::Unstructured::Topology /* unused */)
+    {
+        const int c = APITraits::SelectSellC<CELL_TYPE>::VALUE;
+        const int sigma = APITraits::SelectSellSigma<CELL_TYPE>::VALUE;
+        int alignment = c;
+        while (alignment % sigma) {
+            alignment += c;
+        }
+
+        int numCells = gridDim.x();
+        int width = requestedChunkDim.x();
+        if (width <= 0) {
+            int threads = pool.numThreads();
+            width = (std::max)(1024, (std::min)(16384, numCells / (8 * threads)));
+        }
+        width = (width + alignment - 1) / alignment * alignment;
+
+        std::size_t numChunks = (numCells + width - 1) / width;
+        chunkRegions.resize(numChunks);
+        chunkNeighbors.resize(numChunks);
+
+        typename Initializer<CELL_TYPE>::AdjacencyPtr adjacency = initializer->getAdjacency(simArea);
+
+        for (std::size_t i = 0; i < numChunks; ++i) {
+            Region<1> chunk;
+            chunk << Streak<1>(Coord<1>(i * width), (std::min)(numCells, int((i + 1) * width)));
+            chunkRegions[i] = curGrid->remapRegion(chunk);
+
+            Region<1> halo = chunk.expandWithAdjacency(Stencil::RADIUS, *adjacency) - chunk;
+            for (Region<1>::StreakIterator s = halo.beginStreak(); s != halo.endStreak(); ++s) {
+                std::size_t first = s->origin.x() / width;
+                std::size_t last = (s->endX - 1) / width;
+                for (std::size_t neighbor = first; neighbor <= last; ++neighbor) {
+                    chunkNeighbors[i].push_back(neighbor);
+                    chunkNeighbors[neighbor].push_back(i);
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < numChunks; ++i) {
+            std::vector<std::size_t>& neighbors = chunkNeighbors[i];
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), i), neighbors.end());
+        }
+    }
+};
+
+}
+
+#endif
+
+#endif
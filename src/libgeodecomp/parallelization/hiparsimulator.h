@@ -5,10 +5,13 @@
 #ifdef LIBGEODECOMP_WITH_MPI
 
 #include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/nodetopology.h>
+#include <libgeodecomp/geometry/partitions/nodeawarepartition.h>
 #include <libgeodecomp/geometry/partitions/stripingpartition.h>
 #include <libgeodecomp/geometry/partitions/ptscotchunstructuredpartition.h>
 #include <libgeodecomp/geometry/partitions/unstructuredstripingpartition.h>
 #include <libgeodecomp/geometry/partitions/distributedptscotchunstructuredpartition.h>
+#include <libgeodecomp/io/steererconsensus.h>
 #include <libgeodecomp/loadbalancer/loadbalancer.h>
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/parallelization/hierarchicalsimulator.h>
@@ -16,6 +19,7 @@
 #include <libgeodecomp/parallelization/nesting/steereradapter.h>
 #include <libgeodecomp/parallelization/nesting/mpiupdategroup.h>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 
 namespace LibGeoDecomp {
@@ -29,6 +33,29 @@ namespace LibGeoDecomp {
  * inter-node or inter-NUMA-domain communication and OpenMP and/or
  * CUDA for local paralelism.
  *
+ * Wrapping PARTITION in a NodeAwarePartition places neighboring
+ * subdomains on ranks which share a node. The ranks' nodes are
+ * discovered once via a NodeTopology of the simulator's communicator
+ * and shared with the MPIUpdateGroup. Time spent waiting for
+ * ghost zones from other nodes is reported as TimeInterNodeComm by
+ * gatherStatistics().
+ *
+ * SteererFeedback (end of simulation, new static data) is agreed on
+ * via a SteererConsensus at the end of each time step during which
+ * Steerers were called and takes effect one time step later on all
+ * ranks. While Steerers are present, the UpdateGroup is advanced up
+ * to the next time step at which a Steerer is called or a round is
+ * due. If a Steerer ends the simulation early, Writers receive
+ * WRITER_ALL_DONE for the final step with the region which is valid
+ * at that time.
+ *
+ * Measured costs: setCostMap() attaches a CellCostMap. If PARTITION
+ * is a CostAwarePartition, the initial decomposition is cut by the
+ * map's costs, and the Stepper samples streak update times into it.
+ * Each rank only samples the cells it owns. The balancer is handed
+ * the weights the partition was built from, i.e. the cost shares of a
+ * CostAwarePartition rather than its cell counts.
+ *
  * fixme: check if code runs with a communicator which is merely a subset of MPI_COMM_WORLD
  */
 template<
@@ -54,8 +81,11 @@ public:
     typedef typename ParentType::GridType GridType;
     typedef ParallelWriterAdapter<typename UpdateGroupType::GridType, CELL_TYPE> ParallelWriterAdapterType;
     typedef SteererAdapter<typename UpdateGroupType::GridType, CELL_TYPE> SteererAdapterType;
+    typedef typename SteererAdapterType::SteererFeedback SteererFeedback;
+    typedef typename SteererAdapterType::SteererFeedbackPtr SteererFeedbackPtr;
 
     static const int DIM = Topology::DIM;
+    typedef typename SharedPtr<CellCostMap<DIM> >::Type CostMapPtr;
 
     inline explicit HiParSimulator(
         Initializer<CELL_TYPE> *initializer,
@@ -70,7 +100,10 @@ public:
             enableFineGrainedParallelism),
         balancer(balancer),
         ghostZoneWidth(ghostZoneWidth),
-        mpiLayer(communicator)
+        mpiLayer(communicator),
+        steererFeedback(new SteererFeedback),
+        steererConsensus(1, communicator),
+        costSamplingPeriod(0)
     {}
 
     inline void run()
@@ -78,6 +111,10 @@ public:
         initSimulation();
 
         nanoStep(timeToLastEvent());
+
+        if (steererConsensus.simulationEnded() && (getStep() < initializer->maxSteps())) {
+            notifyWritersAllDone();
+        }
     }
 
     inline void step()
@@ -106,14 +143,16 @@ public:
                 steerers.back(),
                 initializer->startStep(),
                 initializer->maxSteps(),
-                false));
+                false,
+                steererFeedback));
 
         typename UpdateGroupType::PatchProviderPtr adapterInnerSet(
             new SteererAdapterType(
                 steerers.back(),
                 initializer->startStep(),
                 initializer->maxSteps(),
-                true));
+                true,
+                steererFeedback));
 
         steererAdaptersGhost.push_back(adapterGhost);
         steererAdaptersInner.push_back(adapterInnerSet);
@@ -143,6 +182,17 @@ public:
         writerAdaptersInner.push_back(adapterInnerSet);
     }
 
+    /**
+     * Needs to be called before the simulation starts. A
+     * samplingPeriod of 0 disables sampling, so the map only
+     * determines the initial decomposition.
+     */
+    inline void setCostMap(const CostMapPtr& costs, unsigned samplingPeriod = 10)
+    {
+        costMap = costs;
+        costSamplingPeriod = samplingPeriod;
+    }
+
     std::vector<Chronometer> gatherStatistics()
     {
         Chronometer stats = chronometer + updateGroup->statistics();
@@ -158,6 +208,11 @@ private:
     unsigned ghostZoneWidth;
     MPILayer mpiLayer;
     typename SharedPtr<UpdateGroupType>::Type updateGroup;
+    SteererFeedbackPtr steererFeedback;
+    SteererConsensus<CELL_TYPE> steererConsensus;
+    CostMapPtr costMap;
+    unsigned costSamplingPeriod;
+    std::vector<std::size_t> partitionWeights;
 
     typename UpdateGroupType::PatchProviderVec steererAdaptersGhost;
     typename UpdateGroupType::PatchProviderVec steererAdaptersInner;
@@ -169,9 +224,76 @@ private:
         long remainingNanoSteps = s;
         while (remainingNanoSteps > 0) {
             long hop = (std::min)(remainingNanoSteps, timeToNextEvent());
+            if (!steerers.empty()) {
+                // stop when steerer feedback needs to be checked:
+                hop = (std::min)(hop, timeToSteererFeedback());
+            }
+
             updateGroup->update(hop);
             handleEvents();
             remainingNanoSteps -= hop;
+
+            if (!steerers.empty() && (currentNanoStep() % NANO_STEPS == 0)) {
+                handleSteererFeedback();
+                if (steererConsensus.simulationEnded()) {
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * Nano steps until the next time step at which a Steerer will be
+     * called or the pending consensus round is due.
+     */
+    inline long timeToSteererFeedback() const
+    {
+        unsigned step = getStep();
+        unsigned nextStep = (std::numeric_limits<unsigned>::max)();
+        if (steererConsensus.hasPendingRound()) {
+            nextStep = (std::max)(step + 1, steererConsensus.getDueStep());
+        }
+
+        for (std::size_t i = 0; i < steerers.size(); ++i) {
+            unsigned period = steerers[i]->getPeriod();
+            nextStep = (std::min)(nextStep, (step / period + 1) * period);
+        }
+
+        return long(nextStep) * NANO_STEPS - currentNanoStep();
+    }
+
+    /**
+     * Writers expect a final WRITER_ALL_DONE, even if a Steerer ended
+     * the simulation before maxSteps() was reached.
+     */
+    inline void notifyWritersAllDone()
+    {
+        for (std::size_t i = 0; i < writers.size(); ++i) {
+            writers[i]->stepFinished(
+                updateGroup->grid(),
+                updateGroup->validRegion(),
+                initializer->gridDimensions(),
+                getStep(),
+                WRITER_ALL_DONE,
+                mpiLayer.rank(),
+                true);
+        }
+    }
+
+    /**
+     * Applies the consensus which is due now and starts a new round
+     * if any Steerer was called during this time step.
+     */
+    inline void handleSteererFeedback()
+    {
+        unsigned step = getStep();
+        steererConsensus.poll(step);
+
+        for (std::size_t i = 0; i < steerers.size(); ++i) {
+            if (step % steerers[i]->getPeriod() == 0) {
+                steererConsensus.start(step, steererFeedback.get());
+                return;
+            }
         }
     }
 
@@ -197,17 +319,21 @@ private:
 
         double mySpeed = APITraits::SelectSpeedGuide<CELL_TYPE>::value();
         std::vector<double> rankSpeeds = mpiLayer.allGather(mySpeed);
-        std::vector<std::size_t> weights = LoadBalancer::initialWeights(
+        partitionWeights = LoadBalancer::initialWeights(
             box.dimensions.prod(),
             rankSpeeds);
 
+        NodeTopology nodeTopology(mpiLayer.communicator());
+
         typename SharedPtr<PARTITION>::Type partition(
-            new PARTITION(
+            NodeAwarePartitionHelpers::PartitionBuilder<PARTITION, DIM>::build(
                 box.origin,
                 box.dimensions,
                 0,
-                weights,
-                initializer->getAdjacency(globalRegion)));
+                partitionWeights,
+                initializer->getAdjacency(globalRegion),
+                costMap.get(),
+                nodeTopology.getNodes()));
 
         updateGroup.reset(
             new UpdateGroupType(
@@ -221,7 +347,12 @@ private:
                 steererAdaptersGhost,
                 steererAdaptersInner,
                 enableFineGrainedParallelism,
-                mpiLayer.communicator()));
+                mpiLayer.communicator(),
+                &nodeTopology));
+
+        if (costMap) {
+            updateGroup->setCostMap(costMap, costSamplingPeriod);
+        }
 
         writerAdaptersGhost.clear();
         writerAdaptersInner.clear();
@@ -246,7 +377,7 @@ private:
 
             LoadBalancer::LoadVec loads(mpiLayer.size(), 1.0);
             LoadBalancer::WeightVec newWeights =
-                balancer->balance(updateGroup->getWeights(), loads);
+                balancer->balance(partitionWeights, loads);
             // fixme: actually balance the load!
         }
     }
@@ -92,6 +92,19 @@ public:
         return *oldGrid;
     }
 
+    /**
+     * Right after the ghost zone has been updated the whole own
+     * region is valid, in between only the inner set.
+     */
+    inline const Region<DIM>& validRegion() const
+    {
+        if (validGhostZoneWidth == ghostZoneWidth()) {
+            return partitionManager->ownRegion();
+        }
+
+        return innerSet(ghostZoneWidth());
+    }
+
     /**
      * Proceed the simulation exactly one nano step
      */
@@ -169,8 +182,12 @@ protected:
         oldGrid.reset(makeGrid(partitionManager->ownExpandedRegion(), gridBox, topoDim, Topology()));
         newGrid.reset(makeGrid(partitionManager->ownExpandedRegion(), gridBox, topoDim, Topology()));
 
-        initializer->grid(&*oldGrid);
-        *newGrid = *oldGrid;
+        if (initializer->supportsStreakInit()) {
+            initializer->initGrids(&*oldGrid, &*newGrid);
+        } else {
+            initializer->grid(&*oldGrid);
+            *newGrid = *oldGrid;
+        }
 
         remapRegions(*oldGrid);
 
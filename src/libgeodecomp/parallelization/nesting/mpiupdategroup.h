@@ -5,7 +5,9 @@
 #ifdef LIBGEODECOMP_WITH_MPI
 
 #include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/nodetopology.h>
 #include <libgeodecomp/communication/patchlink.h>
+#include <libgeodecomp/communication/unstructuredpatchlink.h>
 #include <libgeodecomp/parallelization/nesting/updategroup.h>
 
 namespace LibGeoDecomp {
@@ -15,6 +17,11 @@ class HiParSimulatorTest;
 /**
  * This is an implementation of the UpdateGroup for MPI-based
  * hiearchical Simulators, e.g. the HiParSimulator.
+ *
+ * The NodeTopology is used to tell inter-node from intra-node
+ * ghost zone links. Simulators which already know it (e.g. to build
+ * a NodeAwarePartition) may pass it in, otherwise it is discovered
+ * upon construction (a collective operation on communicator).
  */
 template<class CELL_TYPE>
 class MPIUpdateGroup : public UpdateGroup<CELL_TYPE, PatchLink>
@@ -32,9 +39,15 @@ public:
     typedef typename UpdateGroup<CELL_TYPE, PatchLink>::PartitionPtr PartitionPtr;
     typedef typename UpdateGroup<CELL_TYPE, PatchLink>::PatchLinkAccepterPtr PatchLinkAccepterPtr;
     typedef typename UpdateGroup<CELL_TYPE, PatchLink>::PatchLinkProviderPtr PatchLinkProviderPtr;
+    typedef typename UpdateGroup<CELL_TYPE, PatchLink>::GridType GridType;
+    typedef typename UpdateGroup<CELL_TYPE, PatchLink>::Topology Topology;
+    typedef typename UpdateGroup<CELL_TYPE, PatchLink>::RegionVecMap RegionVecMap;
 
     using UpdateGroup<CELL_TYPE, PatchLink>::init;
+    using UpdateGroup<CELL_TYPE, PatchLink>::ghostZoneWidth;
+    using UpdateGroup<CELL_TYPE, PatchLink>::partitionManager;
     using UpdateGroup<CELL_TYPE, PatchLink>::rank;
+    using UpdateGroup<CELL_TYPE, PatchLink>::patchLinks;
 
     const static int DIM = UpdateGroup<CELL_TYPE, PatchLink>::DIM;
 
@@ -50,9 +63,11 @@ public:
         PatchProviderVec patchProvidersGhost = PatchProviderVec(),
         PatchProviderVec patchProvidersInner = PatchProviderVec(),
         bool enableFineGrainedParallelism = false,
-        MPI_Comm communicator = MPI_COMM_WORLD) :
+        MPI_Comm communicator = MPI_COMM_WORLD,
+        const NodeTopology *nodeTopology = 0) :
         UpdateGroup<CELL_TYPE, PatchLink>(ghostZoneWidth, initializer, MPILayer(communicator).rank()),
-        mpiLayer(communicator)
+        mpiLayer(communicator),
+        nodeTopology(nodeTopology ? *nodeTopology : NodeTopology(communicator))
     {
         init(
             partition,
@@ -67,8 +82,54 @@ public:
             enableFineGrainedParallelism);
     }
 
+    /**
+     * Adds the time spent waiting for ghost zones from other nodes
+     * (TimeInterNodeComm) to the Stepper's measurements.
+     */
+    Chronometer statistics() const
+    {
+        return UpdateGroup<CELL_TYPE, PatchLink>::statistics() + interNodeChronometer;
+    }
+
 private:
+    /**
+     * Ghost zones from ranks on other nodes are received via this
+     * PatchLink, which keeps track of the receive time so the cost of
+     * inter-node communication shows up in the statistics.
+     */
+    class InterNodePatchLinkProvider : public PatchLinkProvider
+    {
+    public:
+        InterNodePatchLinkProvider(
+            const Region<DIM>& region,
+            int source,
+            int tag,
+            const MPI_Datatype& cellMPIDatatype,
+            MPI_Comm communicator,
+            Chronometer *chronometer) :
+            PatchLinkProvider(region, source, tag, cellMPIDatatype, communicator),
+            chronometer(chronometer)
+        {}
+
+        virtual void get(
+            GridType *grid,
+            const Region<DIM>& patchableRegion,
+            const Coord<DIM>& globalGridDimensions,
+            const std::size_t nanoStep,
+            const std::size_t rank,
+            const bool remove = true)
+        {
+            TimeInterNodeComm t(chronometer);
+            PatchLinkProvider::get(grid, patchableRegion, globalGridDimensions, nanoStep, rank, remove);
+        }
+
+    private:
+        Chronometer *chronometer;
+    };
+
     MPILayer mpiLayer;
+    NodeTopology nodeTopology;
+    Chronometer interNodeChronometer;
 
     std::vector<CoordBox<DIM> > gatherBoundingBoxes(
         const CoordBox<DIM>& ownBoundingBox,
@@ -80,6 +141,81 @@ private:
         return boundingBoxes;
     }
 
+    virtual void initGhostZoneLinks(
+        long firstSyncPoint,
+        PatchProviderVec *patchLinkProviders,
+        PatchAccepterVec *ghostZoneAccepterLinks)
+    {
+        initGhostZoneLinks(firstSyncPoint, patchLinkProviders, ghostZoneAccepterLinks, Topology());
+    }
+
+    template<typename TOPOLOGY>
+    void initGhostZoneLinks(
+        long firstSyncPoint,
+        PatchProviderVec *patchLinkProviders,
+        PatchAccepterVec *ghostZoneAccepterLinks,
+        TOPOLOGY /* unused */)
+    {
+        UpdateGroup<CELL_TYPE, PatchLink>::initGhostZoneLinks(
+            firstSyncPoint, patchLinkProviders, ghostZoneAccepterLinks);
+    }
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+#ifdef LIBGEODECOMP_WITH_MPI_NEIGHBOR_COLLECTIVES
+    /**
+     * Ghost zones of unstructured grids are exchanged via a single
+     * neighborhood collective instead of one PatchLink per neighbor.
+     * Link setup is collective, so all ranks create their links,
+     * even those without neighbors.
+     */
+    void initGhostZoneLinks(
+        long firstSyncPoint,
+        PatchProviderVec *patchLinkProviders,
+        PatchAccepterVec *ghostZoneAccepterLinks,
+        Topologies::Unstructured::Topology /* unused */)
+    {
+        typedef UnstructuredPatchLink<GridType> LinkType;
+        typedef typename LinkType::RegionMap RegionMap;
+
+        RegionMap sendRegions = toRegionMap(partitionManager->getInnerGhostZoneFragments());
+        RegionMap recvRegions = toRegionMap(partitionManager->getOuterGhostZoneFragments());
+
+        typename LinkType::ExchangePtr exchange(
+            new typename LinkType::Exchange(
+                sendRegions,
+                recvRegions,
+                mpiLayer.communicator()));
+
+        typename SharedPtr<typename LinkType::Provider>::Type provider(
+            new typename LinkType::Provider(exchange));
+        typename SharedPtr<typename LinkType::Accepter>::Type accepter(
+            new typename LinkType::Accepter(exchange));
+
+        provider->charge(firstSyncPoint, PatchProvider<GridType>::infinity(), ghostZoneWidth);
+        accepter->charge(firstSyncPoint, PatchAccepter<GridType>::infinity(), ghostZoneWidth);
+
+        *patchLinkProviders << provider;
+        *ghostZoneAccepterLinks << accepter;
+        patchLinks << provider;
+        patchLinks << accepter;
+    }
+
+    static std::map<int, Region<1> > toRegionMap(const RegionVecMap& fragments)
+    {
+        std::map<int, Region<1> > ret;
+
+        for (typename RegionVecMap::const_iterator i = fragments.begin(); i != fragments.end(); ++i) {
+            // the outgroup isn't a process, but all cells outside of this group:
+            if ((i->first >= 0) && !i->second.back().empty()) {
+                ret[i->first] = i->second.back();
+            }
+        }
+
+        return ret;
+    }
+#endif
+#endif
+
     virtual PatchLinkAccepterPtr makePatchLinkAccepter(int target, const Region<DIM>& region)
     {
         return PatchLinkAccepterPtr(
@@ -94,6 +230,17 @@ private:
 
     virtual PatchLinkProviderPtr makePatchLinkProvider(int source, const Region<DIM>& region)
     {
+        if (!nodeTopology.sameNode(source, rank)) {
+            return PatchLinkProviderPtr(
+                new InterNodePatchLinkProvider(
+                    region,
+                    source,
+                    MPILayer::PATCH_LINK,
+                    SerializationBuffer<CELL_TYPE>::cellMPIDataType(),
+                    mpiLayer.communicator(),
+                    &interNodeChronometer));
+        }
+
         return PatchLinkProviderPtr(
             new PatchLinkProvider(
                 region,
@@ -11,6 +11,10 @@ namespace LibGeoDecomp {
  * Stepper this class appears like a PatchProvider. This allows us to
  * do computational steering with hierarchical Simulators (e.g.
  * HPXSimulator and HiParSimulator).
+ *
+ * The SteererFeedback is merged into feedbackSink, so the Simulator
+ * can act upon it. Without a sink only static data updates will be
+ * carried out, immediately and locally.
  */
 template<typename GRID_TYPE, typename CELL_TYPE>
 class SteererAdapter : public PatchProvider<GRID_TYPE>
@@ -18,6 +22,8 @@ class SteererAdapter : public PatchProvider<GRID_TYPE>
 public:
     typedef typename APITraits::SelectTopology<CELL_TYPE>::Value Topology;
     typedef typename SharedPtr<Steerer<CELL_TYPE> >::Type SteererPtr;
+    typedef typename Steerer<CELL_TYPE>::SteererFeedback SteererFeedback;
+    typedef typename SharedPtr<SteererFeedback>::Type SteererFeedbackPtr;
 
     static const unsigned NANO_STEPS = APITraits::SelectNanoSteps<CELL_TYPE>::VALUE;
     static const int DIM = Topology::DIM;
@@ -29,8 +35,10 @@ public:
         SteererPtr steerer,
         const std::size_t firstStep,
         const std::size_t lastStep,
-        bool lastCall) :
+        bool lastCall,
+        const SteererFeedbackPtr& feedbackSink = SteererFeedbackPtr()) :
         steerer(steerer),
+        feedbackSink(feedbackSink),
         firstNanoStep(firstStep * NANO_STEPS),
         lastNanoStep(lastStep   * NANO_STEPS),
         lastCall(lastCall)
@@ -82,7 +90,7 @@ public:
                                    " but expected multiple of " + StringOps::itoa(steerer->getPeriod()));
         }
 
-        typename Steerer<CELL_TYPE>::SteererFeedback feedback;
+        SteererFeedback feedback;
 
         steerer->nextStep(
             destinationGrid,
@@ -99,11 +107,16 @@ public:
             storedNanoSteps << globalNanoStep + NANO_STEPS * steerer->getPeriod();
         }
 
-        // fixme: apply SteererFeedback!
+        if (feedbackSink) {
+            feedbackSink->merge(feedback);
+        } else {
+            feedback.applyStaticData();
+        }
     }
 
 private:
     SteererPtr steerer;
+    SteererFeedbackPtr feedbackSink;
     std::size_t firstNanoStep;
     std::size_t lastNanoStep;
     bool lastCall;
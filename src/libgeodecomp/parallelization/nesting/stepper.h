@@ -4,6 +4,7 @@
 #include <deque>
 
 #include <libgeodecomp/geometry/partitionmanager.h>
+#include <libgeodecomp/geometry/partitions/cellcostmap.h>
 #include <libgeodecomp/io/initializer.h>
 #include <libgeodecomp/misc/chronometer.h>
 #include <libgeodecomp/misc/sharedptr.h>
@@ -18,6 +19,11 @@ namespace LibGeoDecomp {
  * Abstract interface class. Steppers contain some arbitrary region of
  * the grid which they can update. IO and ghostzone communication are
  * handled via PatchAccepter and PatchProvider objects.
+ *
+ * If a CellCostMap is attached via setCostMap(), Steppers which
+ * support it (currently the VanillaStepper) feed back measured update
+ * times per Streak, so a CostAwarePartition built from the same map
+ * follows the actual load.
  */
 template<typename CELL_TYPE>
 class Stepper
@@ -37,6 +43,7 @@ public:
     typedef typename SharedPtr<PatchAccepter<GridType> >::Type PatchAccepterPtr;
     typedef typename SharedPtr<PartitionManager<Topology> >::Type PartitionManagerPtr;
     typedef typename SharedPtr<Initializer<CELL_TYPE> >::Type InitPtr;
+    typedef typename SharedPtr<CellCostMap<DIM> >::Type CostMapPtr;
     typedef std::deque<PatchProviderPtr> PatchProviderList;
     typedef std::deque<PatchAccepterPtr> PatchAccepterList;
     typedef std::vector<PatchAccepterPtr> PatchAccepterVec;
@@ -46,7 +53,8 @@ public:
         PartitionManagerPtr partitionManager,
         InitPtr initializer) :
         partitionManager(partitionManager),
-        initializer(initializer)
+        initializer(initializer),
+        costSamplingPeriod(0)
     {}
 
     virtual ~Stepper()
@@ -61,6 +69,16 @@ public:
      */
     virtual std::pair<std::size_t, std::size_t> currentStep() const = 0;
 
+    /**
+     * Returns the part of grid() which is up to date with
+     * currentStep(). The inner set is handed to INNER_SET
+     * PatchAccepters after each nano step, so it's always valid.
+     */
+    virtual const Region<DIM>& validRegion() const
+    {
+        return partitionManager->innerSet(partitionManager->getGhostZoneWidth());
+    }
+
     void addPatchProvider(
         const PatchProviderPtr& patchProvider,
         const PatchType& patchType)
@@ -80,12 +98,25 @@ public:
         return chronometer;
     }
 
+    /**
+     * Every samplingPeriod'th nano step the inner set will be updated
+     * Streak by Streak and the measured times are passed to
+     * CellCostMap::addSample(). A period of 0 disables sampling.
+     */
+    void setCostMap(const CostMapPtr& newCostMap, unsigned samplingPeriod = 10)
+    {
+        costMap = newCostMap;
+        costSamplingPeriod = samplingPeriod;
+    }
+
 protected:
     PartitionManagerPtr partitionManager;
     InitPtr initializer;
     PatchProviderList patchProviders[3];
     PatchAccepterList patchAccepters[3];
     Chronometer chronometer;
+    CostMapPtr costMap;
+    unsigned costSamplingPeriod;
 
     /**
      * calculates a (mostly) suitable offset which (in conjuction with
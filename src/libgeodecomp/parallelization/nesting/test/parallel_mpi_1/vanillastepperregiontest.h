@@ -97,6 +97,17 @@ public:
         checkInnerSet(2, 2);
     }
 
+    void testValidRegion()
+    {
+        // the whole own region is valid right after initialization...
+        TS_ASSERT_EQUALS(partitionManager->ownRegion(), stepper->validRegion());
+
+        // ...but only the inner set until the ghost zone gets updated:
+        stepper->update1();
+        TS_ASSERT_EQUALS(partitionManager->innerSet(ghostZoneWidth), stepper->validRegion());
+        checkInnerSet(ghostZoneWidth, 1);
+    }
+
 private:
     int ghostZoneWidth;
     SharedPtr<TestInitializer<TestCell<2> > >::Type init;
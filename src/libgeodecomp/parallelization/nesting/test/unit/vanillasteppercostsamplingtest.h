@@ -0,0 +1,94 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/geometry/partitionmanager.h>
+#include <libgeodecomp/geometry/partitions/costawarepartition.h>
+#include <libgeodecomp/geometry/partitions/stripingpartition.h>
+#include <libgeodecomp/io/simpleinitializer.h>
+#include <libgeodecomp/misc/scopedtimer.h>
+#include <libgeodecomp/parallelization/nesting/vanillastepper.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+/**
+ * Cells in the top rows are much more expensive than the rest,
+ * although that's not declared anywhere.
+ */
+class CostSamplingTestCell
+{
+public:
+    class API : public APITraits::HasStencil<Stencils::VonNeumann<2, 1> >
+    {};
+
+    explicit CostSamplingTestCell(bool expensive = false) :
+        expensive(expensive)
+    {}
+
+    template<typename HOOD>
+    void update(const HOOD& hood, unsigned /* nanoStep */)
+    {
+        *this = hood[Coord<2>()];
+        if (expensive) {
+            ScopedTimer::busyWait(50);
+        }
+    }
+
+    bool expensive;
+};
+
+class CostSamplingTestInitializer : public SimpleInitializer<CostSamplingTestCell>
+{
+public:
+    CostSamplingTestInitializer() :
+        SimpleInitializer<CostSamplingTestCell>(Coord<2>(16, 16), 10)
+    {}
+
+    virtual void grid(GridBase<CostSamplingTestCell, 2> *target)
+    {
+        CoordBox<2> box = target->boundingBox();
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            target->set(*i, CostSamplingTestCell(i->y() < 4));
+        }
+    }
+};
+
+class VanillaStepperCostSamplingTest : public CxxTest::TestSuite
+{
+public:
+    typedef VanillaStepper<CostSamplingTestCell, UpdateFunctorHelpers::ConcurrencyNoP> StepperType;
+    typedef PartitionManager<Topologies::Cube<2>::Topology> PartitionManagerType;
+    typedef CostAwarePartition<StripingPartition<2> > PartitionType;
+
+    void testSampledCostsMovePartitionBoundaries()
+    {
+        SharedPtr<Initializer<CostSamplingTestCell> >::Type init(new CostSamplingTestInitializer);
+        CoordBox<2> box = init->gridBox();
+        SharedPtr<PartitionManagerType>::Type partitionManager(new PartitionManagerType(box));
+        StepperType stepper(partitionManager, init);
+
+        // no smoothing, so the initial costs are discarded with the first sample:
+        StepperType::CostMapPtr costs(new CellCostMap<2>(box, Coord<2>(1, 1), 1.0, 1.0));
+        std::vector<std::size_t> weights(2, 128);
+
+        PartitionType before(box.origin, box.dimensions, 0, weights, *costs);
+        TS_ASSERT_EQUALS(weights, before.getWeights());
+
+        stepper.setCostMap(costs, 2);
+        stepper.update(4);
+
+        // the expensive rows 0-3 are equal to 64 cells, so if costs
+        // were sampled correctly, the first node will be assigned
+        // only a fraction of those:
+        PartitionType after(box.origin, box.dimensions, 0, weights, *costs);
+        TS_ASSERT(after.getWeights()[0] > 0);
+        TS_ASSERT(after.getWeights()[0] < 64);
+        TS_ASSERT_EQUALS(std::size_t(256), after.getWeights()[0] + after.getWeights()[1]);
+        TS_ASSERT(costs->totalCost(after.getRegion(0)) > costs->totalCost(after.getRegion(1)) * 0.8);
+
+        Region<2> cheapRows;
+        cheapRows << CoordBox<2>(Coord<2>(0, 4), Coord<2>(16, 12));
+        TS_ASSERT(costs->totalCost(cheapRows) < 192.0);
+    }
+};
+
+}
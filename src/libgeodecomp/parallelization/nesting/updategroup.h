@@ -103,6 +103,15 @@ public:
         stepper->update(nanoSteps);
     }
 
+    /**
+     * Lets the Stepper feed measured update times back into costs,
+     * see Stepper::setCostMap().
+     */
+    inline void setCostMap(const typename StepperType::CostMapPtr& costs, unsigned samplingPeriod)
+    {
+        stepper->setCostMap(costs, samplingPeriod);
+    }
+
     const GridType& grid() const
     {
         return stepper->grid();
@@ -113,6 +122,11 @@ public:
         return stepper->currentStep();
     }
 
+    inline const Region<DIM>& validRegion() const
+    {
+        return stepper->validRegion();
+    }
+
     inline const std::vector<std::size_t>& getWeights() const
     {
         return partitionManager->getWeights();
@@ -183,15 +197,61 @@ protected:
             initializer->startStep() * APITraits::SelectNanoSteps<CELL_TYPE>::VALUE +
             ghostZoneWidth;
 
+        PatchProviderVec patchLinkProviders;
+        PatchAccepterVec ghostZoneAccepterLinks;
+        initGhostZoneLinks(firstSyncPoint, &patchLinkProviders, &ghostZoneAccepterLinks);
+
+        // notify all PatchAccepters of the process' region:
+        for (std::size_t i = 0; i < patchAcceptersGhost.size(); ++i) {
+            patchAcceptersGhost[i]->setRegion(partitionManager->ownRegion());
+        }
+        for (std::size_t i = 0; i < patchAcceptersInner.size(); ++i) {
+            patchAcceptersInner[i]->setRegion(partitionManager->ownRegion());
+        }
+
+        // notify all PatchProviders of the process' region:
+        for (std::size_t i = 0; i < patchProvidersGhost.size(); ++i) {
+            patchProvidersGhost[i]->setRegion(partitionManager->ownRegion());
+        }
+        for (std::size_t i = 0; i < patchProvidersInner.size(); ++i) {
+            patchProvidersInner[i]->setRegion(partitionManager->ownRegion());
+        }
+
+        stepper.reset(
+            new STEPPER(
+                partitionManager,
+                this->initializer,
+                patchAcceptersGhost + ghostZoneAccepterLinks,
+                patchAcceptersInner,
+                // add external PatchProviders last to allow them to override
+                // the local ghost zone providers (a.k.a. PatchLink::Source).
+                patchLinkProviders,
+                patchProvidersGhost,
+                patchProvidersInner,
+                enableFineGrainedParallelism));
+    }
+
+    /**
+     * Sets up the links which exchange the ghost zones with our
+     * neighbors: Providers are to be added to patchLinkProviders,
+     * Accepters (which will also receive the initial ghost zone
+     * update of the Stepper) to ghostZoneAccepterLinks. The default
+     * implementation creates one PatchLink per neighbor and
+     * direction.
+     */
+    virtual void initGhostZoneLinks(
+        long firstSyncPoint,
+        PatchProviderVec *patchLinkProviders,
+        PatchAccepterVec *ghostZoneAccepterLinks)
+    {
         // We need to create the patch providers first, as the HPX patch
         // accepters will look up their IDs upon creation:
-        PatchProviderVec patchLinkProviders;
         const RegionVecMap& map1 = partitionManager->getOuterGhostZoneFragments();
         for (typename RegionVecMap::const_iterator i = map1.begin(); i != map1.end(); ++i) {
             if (!i->second.back().empty()) {
                 PatchLinkProviderPtr link(
                     makePatchLinkProvider(i->first, i->second.back()));
-                patchLinkProviders << link;
+                *patchLinkProviders << link;
                 patchLinks << link;
 
                 link->charge(
@@ -206,13 +266,12 @@ protected:
         // we have to hand over a list of all ghostzone senders as the
         // stepper will perform an initial update of the ghostzones
         // upon creation and we have to send those over to our neighbors.
-        PatchAccepterVec ghostZoneAccepterLinks;
         const RegionVecMap& map2 = partitionManager->getInnerGhostZoneFragments();
         for (typename RegionVecMap::const_iterator i = map2.begin(); i != map2.end(); ++i) {
             if (!i->second.back().empty()) {
                 PatchLinkAccepterPtr link(
                     makePatchLinkAccepter(i->first, i->second.back()));
-                ghostZoneAccepterLinks << link;
+                *ghostZoneAccepterLinks << link;
                 patchLinks << link;
 
                 link->charge(
@@ -223,35 +282,6 @@ protected:
                 link->setRegion(partitionManager->ownRegion());
             }
         }
-
-        // notify all PatchAccepters of the process' region:
-        for (std::size_t i = 0; i < patchAcceptersGhost.size(); ++i) {
-            patchAcceptersGhost[i]->setRegion(partitionManager->ownRegion());
-        }
-        for (std::size_t i = 0; i < patchAcceptersInner.size(); ++i) {
-            patchAcceptersInner[i]->setRegion(partitionManager->ownRegion());
-        }
-
-        // notify all PatchProviders of the process' region:
-        for (std::size_t i = 0; i < patchProvidersGhost.size(); ++i) {
-            patchProvidersGhost[i]->setRegion(partitionManager->ownRegion());
-        }
-        for (std::size_t i = 0; i < patchProvidersInner.size(); ++i) {
-            patchProvidersInner[i]->setRegion(partitionManager->ownRegion());
-        }
-
-        stepper.reset(
-            new STEPPER(
-                partitionManager,
-                this->initializer,
-                patchAcceptersGhost + ghostZoneAccepterLinks,
-                patchAcceptersInner,
-                // add external PatchProviders last to allow them to override
-                // the local ghost zone providers (a.k.a. PatchLink::Source).
-                patchLinkProviders,
-                patchProvidersGhost,
-                patchProvidersInner,
-                enableFineGrainedParallelism));
     }
 
     virtual std::vector<CoordBox<DIM> > gatherBoundingBoxes(
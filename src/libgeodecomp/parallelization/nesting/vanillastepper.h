@@ -1,6 +1,7 @@
 #ifndef LIBGEODECOMP_PARALLELIZATION_NESTING_VANILLASTEPPER_H
 #define LIBGEODECOMP_PARALLELIZATION_NESTING_VANILLASTEPPER_H
 
+#include <libgeodecomp/misc/scopedtimer.h>
 #include <libgeodecomp/parallelization/nesting/commonstepper.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 
@@ -66,6 +67,8 @@ public:
     using ParentType::kernelBuffer;
     using ParentType::kernelFraction;
     using ParentType::enableFineGrainedParallelism;
+    using ParentType::costMap;
+    using ParentType::costSamplingPeriod;
 
     inline VanillaStepper(
         PartitionManagerPtr partitionManager,
@@ -99,14 +102,18 @@ private:
         {
             TimeComputeInner t(&chronometer);
 
-            UpdateFunctor<CELL_TYPE, CONCURRENCY_SPEC>()(
-                region,
-                Coord<DIM>(),
-                Coord<DIM>(),
-                *oldGrid,
-                &*newGrid,
-                curNanoStep,
-                CONCURRENCY_SPEC(false, enableFineGrainedParallelism));
+            if (costMap && costSamplingPeriod && (globalNanoStep() % costSamplingPeriod == 0)) {
+                updateAndSampleCosts(innerSet(index));
+            } else {
+                UpdateFunctor<CELL_TYPE, CONCURRENCY_SPEC>()(
+                    region,
+                    Coord<DIM>(),
+                    Coord<DIM>(),
+                    *oldGrid,
+                    &*newGrid,
+                    curNanoStep,
+                    CONCURRENCY_SPEC(false, enableFineGrainedParallelism));
+            }
             swap(oldGrid, newGrid);
 
             ++curNanoStep;
@@ -128,6 +135,33 @@ private:
         this->notifyPatchProviders(nextRegion, ParentType::INNER_SET, globalNanoStep());
     }
 
+    /**
+     * Updates the region Streak by Streak (instead of in one go) so
+     * that the time spent on each can be fed back into the costMap.
+     */
+    inline void updateAndSampleCosts(const Region<DIM>& region)
+    {
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            Region<DIM> streakRegion;
+            streakRegion << *i;
+            double time = 0;
+
+            {
+                ScopedTimer timer(&time);
+                UpdateFunctor<CELL_TYPE, CONCURRENCY_SPEC>()(
+                    oldGrid->remapRegion(streakRegion),
+                    Coord<DIM>(),
+                    Coord<DIM>(),
+                    *oldGrid,
+                    &*newGrid,
+                    curNanoStep,
+                    CONCURRENCY_SPEC(false, enableFineGrainedParallelism));
+            }
+
+            costMap->addSample(*i, time);
+        }
+    }
+
     inline void initGrids()
     {
         initGridsCommon();
@@ -31,6 +31,7 @@ public:
     static const int DIM = Topology::DIM;
 
     using SerialSimulator<CELL_TYPE>::NANO_STEPS;
+    using SerialSimulator<CELL_TYPE>::activeRegionTracker;
     using SerialSimulator<CELL_TYPE>::chronometer;
     using SerialSimulator<CELL_TYPE>::curGrid;
     using SerialSimulator<CELL_TYPE>::initializer;
@@ -61,7 +62,7 @@ protected:
         TimeCompute t(&chronometer);
 
         UpdateFunctor<CELL_TYPE, UpdateFunctorHelpers::ConcurrencyEnableOpenMP>()(
-            simArea,
+            activeRegionTracker.activeRegion(),
             Coord<DIM>(),
             Coord<DIM>(),
             *curGrid,
@@ -104,6 +105,8 @@ protected:
                 steerers[i]->nextStep(curGrid, simArea, gridDim, getStep(), event, 0, true, feedback);
             }
         }
+
+        feedback->applyStaticData();
     }
 };
 
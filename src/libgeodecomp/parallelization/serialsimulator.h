@@ -7,6 +7,7 @@
 #include <libgeodecomp/communication/hpxserializationwrapper.h>
 #include <libgeodecomp/io/writer.h>
 #include <libgeodecomp/parallelization/monolithicsimulator.h>
+#include <libgeodecomp/storage/activeregiontracker.h>
 #include <libgeodecomp/storage/gridtypeselector.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 
@@ -18,6 +19,9 @@ namespace LibGeoDecomp {
  * purpose is to make fostering new applications easier. The absence
  * of concurrency simplifies debugging. As its name implies, it
  * doesn't do any threading, but vectorization (SIMD) is supported.
+ *
+ * Models using APITraits::HasActiveRegion will only have those cells
+ * updated which may change in the current time step.
  */
 template<typename CELL_TYPE>
 class SerialSimulator : public MonolithicSimulator<CELL_TYPE>
@@ -53,9 +57,9 @@ public:
         simArea << CoordBox<DIM>(Coord<DIM>(), dim);
         curGrid = new GridType(simArea);
         newGrid = new GridType(simArea);
-        initializer->grid(curGrid);
-        initializer->grid(newGrid);
+        initializer->initGrids(curGrid, newGrid);
         simArea = curGrid->remapRegion(simArea);
+        activeRegionTracker.reset(simArea, dim);
     }
 
     virtual ~SerialSimulator()
@@ -78,10 +82,14 @@ public:
         TimeTotal t(&chronometer);
 
         handleInput(STEERER_NEXT_STEP, feedback);
+        if (steerersDue(STEERER_NEXT_STEP)) {
+            activeRegionTracker.invalidate();
+        }
 
         for (unsigned i = 0; i < NANO_STEPS; ++i) {
             nanoStep(i);
         }
+        activeRegionTracker.update(*newGrid, *curGrid);
 
         ++stepNum;
 
@@ -97,8 +105,9 @@ public:
      */
     virtual void run()
     {
-        initializer->grid(curGrid);
+        initializer->initGrids(curGrid);
         stepNum = initializer->startStep();
+        activeRegionTracker.invalidate();
         setIORegions();
 
         SteererFeedback feedback;
@@ -128,13 +137,20 @@ protected:
     GridType *curGrid;
     GridType *newGrid;
     Region<DIM> simArea;
+    ActiveRegionTracker<CELL_TYPE> activeRegionTracker;
 
     virtual void nanoStep(unsigned nanoStep)
     {
         using std::swap;
         TimeCompute t(&chronometer);
 
-        UpdateFunctor<CELL_TYPE>()(simArea, Coord<DIM>(), Coord<DIM>(), *curGrid, newGrid, nanoStep);
+        UpdateFunctor<CELL_TYPE>()(
+            activeRegionTracker.activeRegion(),
+            Coord<DIM>(),
+            Coord<DIM>(),
+            *curGrid,
+            newGrid,
+            nanoStep);
         swap(curGrid, newGrid);
     }
 
@@ -177,6 +193,24 @@ protected:
                     feedback);
             }
         }
+
+        feedback->applyStaticData();
+    }
+
+    /**
+     * Checks whether any Steerer will be called for the given event
+     * (and might thus modify the grid).
+     */
+    bool steerersDue(SteererEvent event) const
+    {
+        for (unsigned i = 0; i < steerers.size(); ++i) {
+            if ((event != STEERER_NEXT_STEP) ||
+                (stepNum % steerers[i]->getPeriod() == 0)) {
+                return true;
+            }
+        }
+
+        return false;
     }
 
     void setIORegions()
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/io/steererconsensus.h>
 #include <libgeodecomp/loadbalancer/loadbalancer.h>
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/misc/stringops.h>
@@ -20,6 +21,11 @@ namespace LibGeoDecomp {
  * This class aims at providing a very simple, but working parallel
  * simulation facility. It's not very modular, it's not fast, but it's
  * simple and it actually works.
+ *
+ * SteererFeedback is agreed on among all ranks via a
+ * SteererConsensus, so it takes effect one time step after the
+ * Steerers were called. All ranks need to add Steerers with the
+ * same periods.
  */
 template<typename CELL_TYPE>
 class StripingSimulator : public DistributedSimulator<CELL_TYPE>
@@ -120,10 +126,14 @@ public:
             event = WRITER_ALL_DONE;
         }
         handleOutput(event);
+
+        steererConsensus.poll(stepNum);
     }
 
     /**
-     * performs step() until the maximum number of steps is reached.
+     * performs step() until the maximum number of steps is reached
+     * or the Steerers agreed on ending the simulation. In the latter
+     * case Writers still receive WRITER_ALL_DONE.
      */
     virtual void run()
     {
@@ -132,8 +142,16 @@ public:
         handleOutput(WRITER_INITIALIZED);
 
         while (stepNum < initializer->maxSteps()) {
+            if (steererConsensus.simulationEnded()) {
+                break;
+            }
+
             step();
         }
+
+        if (stepNum < initializer->maxSteps()) {
+            handleOutput(WRITER_ALL_DONE);
+        }
     }
 
     inline unsigned getLoadBalancingPeriod() const
@@ -149,6 +167,8 @@ public:
 private:
     MPILayer mpilayer;
     typename SharedPtr<LoadBalancer>::Type balancer;
+    SteererFeedback steererFeedback;
+    SteererConsensus<CELL_TYPE> steererConsensus;
     /**
      * we need to distinguish four types of rims:
      *   - the inner rim is sent to neighboring nodes (and lies whithin our own stripe)
@@ -314,9 +334,9 @@ private:
 
     void handleInput(SteererEvent event)
     {
-        SteererFeedback feedback;
         // notify all registered Steerers
         waitForGhostRegions(curStripe);
+        bool steerersCalled = false;
 
         for(unsigned i = 0; i < steerers.size(); ++i) {
             if (stepNum % steerers[i]->getPeriod() == 0) {
@@ -327,11 +347,14 @@ private:
                     event,
                     mpilayer.rank(),
                     true,
-                    &feedback);
+                    &steererFeedback);
+                steerersCalled = true;
             }
         }
 
-        // fixme: apply SteererFeedback!
+        if (steerersCalled) {
+            steererConsensus.start(stepNum, &steererFeedback);
+        }
     }
 
     void handleOutput(WriterEvent event)
@@ -63,6 +63,38 @@ private:
     std::size_t cellsSeen;
 };
 
+/**
+ * Asks for the end of the simulation, but only on one rank.
+ */
+class SimulationEndingSteerer : public Steerer<TestCell<2> >
+{
+public:
+    SimulationEndingSteerer(unsigned period, unsigned endStep, std::size_t endRank) :
+        Steerer<TestCell<2> >(period),
+        endStep(endStep),
+        endRank(endRank)
+    {}
+
+    virtual void nextStep(
+        GridType *grid,
+        const Region<Topology::DIM>& validRegion,
+        const CoordType& globalDimensions,
+        unsigned step,
+        SteererEvent event,
+        std::size_t rank,
+        bool lastCall,
+        SteererFeedback *feedback)
+    {
+        if ((step >= endStep) && (rank == endRank)) {
+            feedback->endSimulation();
+        }
+    }
+
+private:
+    unsigned endStep;
+    std::size_t endRank;
+};
+
 class HiParSimulatorTest : public CxxTest::TestSuite
 {
 public:
@@ -172,6 +204,102 @@ public:
         }
     }
 
+    void testCostMap()
+    {
+        typedef CostAwarePartition<ZCurvePartition<2> > PartitionType;
+        typedef HiParSimulator<TestCell<2>, PartitionType> CostAwareSimulatorType;
+
+        CoordBox<2> box(Coord<2>(), dim);
+        CostAwareSimulatorType::CostMapPtr costs(new CellCostMap<2>(box, Coord<2>(1, 1), 1.0, 1.0));
+        for (int y = 0; y < 20; ++y) {
+            for (int x = 0; x < dim.x(); ++x) {
+                costs->setCost(Coord<2>(x, y), 10.0);
+            }
+        }
+        std::vector<std::size_t> uniformWeights;
+        uniformWeights << 1415 << 1415 << 1415 << 1416;
+        PartitionType expected(box.origin, box.dimensions, 0, uniformWeights, *costs);
+        TS_ASSERT_DIFFERS(uniformWeights, expected.getWeights());
+
+        CostAwareSimulatorType staticSim(
+            new TestInitializer<TestCell<2> >(dim, maxSteps, firstStep),
+            0,
+            1,
+            2);
+        staticSim.setCostMap(costs, 0);
+        staticSim.step();
+        TS_ASSERT_EQUALS(expected.getWeights(), staticSim.updateGroup->getWeights());
+        TS_ASSERT_EQUALS(10.0, (*costs)[Coord<2>(0, 0)]);
+
+        // the balancer needs to see the cost shares, not the cell counts:
+        CostAwareSimulatorType balancedSim(
+            new TestInitializer<TestCell<2> >(dim, maxSteps, firstStep),
+            rank ? 0 : new MockBalancer(),
+            1,
+            2);
+        balancedSim.setCostMap(costs, 0);
+        balancedSim.step();
+        if (rank == 0) {
+            TS_ASSERT_EQUALS("balance() [1415, 1415, 1415, 1416] [1, 1, 1, 1]\n", MockBalancer::events);
+        }
+
+        // now let the stepper measure the actual costs:
+        CostAwareSimulatorType sampledSim(
+            new TestInitializer<TestCell<2> >(dim, maxSteps, firstStep),
+            0,
+            1,
+            2);
+        MemoryWriterType *writer = new MemoryWriterType(1);
+        sampledSim.addWriter(writer);
+        sampledSim.setCostMap(costs, 1);
+        sampledSim.step();
+        sampledSim.step();
+
+        TS_ASSERT_TEST_GRID(
+            MemoryWriterType::GridType,
+            writer->getGrids()[firstStep + 2],
+            (firstStep + 2) * NANO_STEPS);
+
+        Region<2> ownRegion = expected.getRegion(rank);
+        std::size_t changed = 0;
+        for (Region<2>::Iterator i = ownRegion.begin(); i != ownRegion.end(); ++i) {
+            double expectedCost = (i->y() < 20) ? 10.0 : 1.0;
+            if ((*costs)[*i] != expectedCost) {
+                ++changed;
+            }
+        }
+        TS_ASSERT(changed > 0);
+    }
+
+    void testNodeAwarePartition()
+    {
+        typedef HiParSimulator<TestCell<2>, NodeAwarePartition<ZCurvePartition<2> > > NodeAwareSimulatorType;
+
+        NodeAwareSimulatorType nodeAwareSim(
+            new TestInitializer<TestCell<2> >(dim, maxSteps, firstStep),
+            0,
+            1,
+            3);
+        MemoryWriterType *writer = new MemoryWriterType(1);
+        nodeAwareSim.addWriter(writer);
+        nodeAwareSim.step();
+        nodeAwareSim.step();
+
+        TS_ASSERT_TEST_GRID(
+            MemoryWriterType::GridType,
+            writer->getGrids()[firstStep + 2],
+            (firstStep + 2) * NANO_STEPS);
+
+        NodeTopology topology;
+        std::vector<std::size_t> weights;
+        weights << 1415 << 1415 << 1415 << 1416;
+        NodeAwarePartition<ZCurvePartition<2> > expected(
+            Coord<2>(), dim, 0, weights, topology.getNodes());
+        TS_ASSERT_EQUALS(
+            expected.getRegion(rank),
+            nodeAwareSim.updateGroup->partitionManager->ownRegion());
+    }
+
     void testSteererCallback()
     {
         SharedPtr<MockSteererType::EventsStore>::Type events(new MockSteererType::EventsStore);
@@ -195,6 +323,20 @@ public:
         TS_ASSERT_EQUALS(*events, expected);
     }
 
+    void testSteererEndsSimulation()
+    {
+        sim->addSteerer(new SimulationEndingSteerer(5, 40, 2));
+        sim->run();
+
+        // consensus is reached one step after the request:
+        TS_ASSERT_EQUALS(unsigned(41), sim->getStep());
+        // writers are notified of the early end:
+        TS_ASSERT(!events->empty());
+        TS_ASSERT_EQUALS(
+            MockWriter<>::Event(41, WRITER_ALL_DONE, rank, true),
+            events->back());
+    }
+
     void testSteererFunctionalityBasic()
     {
         sim->addSteerer(new TestSteererType(5, 25, 4711 * 27));
@@ -37,6 +37,36 @@ public:
 };
 
 
+/**
+ * Requests the end of the simulation, but only on the last rank.
+ */
+class LastRankEndingSteerer : public Steerer<TestCell<2> >
+{
+public:
+    LastRankEndingSteerer(unsigned period, unsigned endStep) :
+        Steerer<TestCell<2> >(period),
+        endStep(endStep)
+    {}
+
+    virtual void nextStep(
+        GridType *grid,
+        const Region<Topology::DIM>& validRegion,
+        const CoordType& globalDimensions,
+        unsigned step,
+        SteererEvent event,
+        std::size_t rank,
+        bool lastCall,
+        SteererFeedback *feedback)
+    {
+        if ((step >= endStep) && (int(rank) == (MPILayer().size() - 1))) {
+            feedback->endSimulation();
+        }
+    }
+
+private:
+    unsigned endStep;
+};
+
 class StripingSimulatorTest : public CxxTest::TestSuite
 {
 public:
@@ -462,6 +492,21 @@ public:
             cycle);
     }
 
+    void testSteererEndsSimulation()
+    {
+        testSim->addSteerer(new LastRankEndingSteerer(3, 30));
+        testSim->addWriter(new MockWriter<>(events, 7));
+        testSim->run();
+
+        // consensus is reached one step after the request:
+        TS_ASSERT_EQUALS(unsigned(31), testSim->getStep());
+        // writers are notified of the early end:
+        TS_ASSERT(!events->empty());
+        TS_ASSERT_EQUALS(
+            MockWriter<>::Event(31, WRITER_ALL_DONE, rank, true),
+            events->back());
+    }
+
     void testSoA()
     {
         int startStep = 0;
@@ -27,6 +27,47 @@ public:
         // sim.reset();
     }
 
+    void testEstimateWavefrontDim()
+    {
+        typedef CacheBlockingSimulator<TestCellType> SimType;
+        Coord<3> gridDim(1000, 500, 100);
+        std::size_t cellSize = sizeof(TestCellType);
+
+        // buffer for pipelineLength 5 is (x + 8) * (y + 8) * 16 cells:
+        Coord<2> actual = SimType::estimateWavefrontDim(gridDim, 5, 16 * 40 * 40 * cellSize);
+        TS_ASSERT_EQUALS(Coord<2>(32, 32), actual);
+
+        actual = SimType::estimateWavefrontDim(gridDim, 5, 16 * 40 * 40 * cellSize - 1);
+        TS_ASSERT_EQUALS(Coord<2>(31, 31), actual);
+
+        // clamp to grid dimensions...
+        actual = SimType::estimateWavefrontDim(gridDim, 5, std::size_t(1) << 40);
+        TS_ASSERT_EQUALS(Coord<2>(1000, 500), actual);
+
+        // ...and never return empty wavefronts:
+        actual = SimType::estimateWavefrontDim(gridDim, 5, 0);
+        TS_ASSERT_EQUALS(Coord<2>(1, 1), actual);
+    }
+
+    void testEstimateWavefrontDim2D()
+    {
+        typedef TestCell<2> TestCell2D;
+        typedef CacheBlockingSimulator<TestCell2D> SimType;
+        Coord<2> gridDim(100000, 500);
+        std::size_t cellSize = sizeof(TestCell2D);
+
+        // in 2D wavefronts are lines, so the buffer for
+        // pipelineLength 5 is (x + 8) * 16 cells:
+        Coord<1> actual = SimType::estimateWavefrontDim(gridDim, 5, 16 * 1600 * cellSize);
+        TS_ASSERT_EQUALS(Coord<1>(1592), actual);
+
+        actual = SimType::estimateWavefrontDim(gridDim, 5, 16 * 1600 * cellSize - 1);
+        TS_ASSERT_EQUALS(Coord<1>(1591), actual);
+
+        actual = SimType::estimateWavefrontDim(gridDim, 5, std::size_t(1) << 40);
+        TS_ASSERT_EQUALS(Coord<1>(100000), actual);
+    }
+
     void testPipelinedUpdate()
     {
 //         init(Coord<3>(40, 1, 20));
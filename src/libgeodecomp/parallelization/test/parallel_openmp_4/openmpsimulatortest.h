@@ -5,6 +5,7 @@
 #include <libgeodecomp/io/mockinitializer.h>
 #include <libgeodecomp/io/mockwriter.h>
 #include <libgeodecomp/io/mocksteerer.h>
+#include <libgeodecomp/io/simpleinitializer.h>
 #include <libgeodecomp/io/testinitializer.h>
 #include <libgeodecomp/io/teststeerer.h>
 #include <libgeodecomp/io/testwriter.h>
@@ -14,6 +15,75 @@ using namespace LibGeoDecomp;
 
 namespace LibGeoDecomp {
 
+/**
+ * Game of Life, optionally restricted to the active region
+ */
+template<typename API_TYPE>
+class OpenMPLifeCell
+{
+public:
+    typedef API_TYPE API;
+
+    explicit OpenMPLifeCell(bool alive = false) :
+        alive(alive)
+    {}
+
+    template<typename HOOD>
+    void update(const HOOD& hood, unsigned)
+    {
+        int livingNeighbors = 0;
+        for (int y = -1; y < 2; ++y) {
+            for (int x = -1; x < 2; ++x) {
+                livingNeighbors += hood[Coord<2>(x, y)].alive;
+            }
+        }
+        livingNeighbors -= hood[Coord<2>(0, 0)].alive;
+
+        alive = hood[Coord<2>(0, 0)].alive ?
+            ((livingNeighbors == 2) || (livingNeighbors == 3)) :
+            (livingNeighbors == 3);
+    }
+
+    bool reachedFixedPoint(const OpenMPLifeCell& previousState) const
+    {
+        return alive == previousState.alive;
+    }
+
+    bool alive;
+};
+
+class OpenMPLifeAPI : public APITraits::HasTorusTopology<2>
+{};
+
+class OpenMPActiveLifeAPI :
+        public APITraits::HasTorusTopology<2>,
+        public APITraits::HasActiveRegion
+{};
+
+/**
+ * A blinker next to a block, which is at a fixed point
+ */
+template<typename CELL>
+class OpenMPLifeInitializer : public SimpleInitializer<CELL>
+{
+public:
+    OpenMPLifeInitializer() :
+        SimpleInitializer<CELL>(Coord<2>(64, 48), 20)
+    {}
+
+    virtual void grid(GridBase<CELL, 2> *target)
+    {
+        std::vector<Coord<2> > living;
+        living << Coord<2>(10, 10) << Coord<2>(11, 10) << Coord<2>(12, 10)
+               << Coord<2>(40, 30) << Coord<2>(41, 30)
+               << Coord<2>(40, 31) << Coord<2>(41, 31);
+
+        for (std::size_t i = 0; i < living.size(); ++i) {
+            target->set(living[i], CELL(true));
+        }
+    }
+};
+
 class OpenMPSimulatorTest : public CxxTest::TestSuite
 {
 public:
@@ -213,6 +283,29 @@ public:
         TS_ASSERT_TEST_GRID(GridBaseType, *sim.getGrid(), 21 * NANO_STEPS_3D);
     }
 
+    void testActiveRegion()
+    {
+        typedef OpenMPLifeCell<OpenMPLifeAPI> PlainCell;
+        typedef OpenMPLifeCell<OpenMPActiveLifeAPI> ActiveCell;
+
+        OpenMPSimulator<PlainCell> referenceSim(new OpenMPLifeInitializer<PlainCell>());
+        OpenMPSimulator<ActiveCell> sim(new OpenMPLifeInitializer<ActiveCell>());
+        CoordBox<2> box = sim.getGrid()->boundingBox();
+        TS_ASSERT_EQUALS(std::size_t(64 * 48), sim.activeRegionTracker.activeRegion().size());
+
+        for (int t = 0; t < 20; ++t) {
+            referenceSim.step();
+            sim.step();
+
+            for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+                TS_ASSERT_EQUALS(referenceSim.getGrid()->get(*i).alive, sim.getGrid()->get(*i).alive);
+            }
+
+            // only the blinker's surroundings need to be updated:
+            TS_ASSERT(sim.activeRegionTracker.activeRegion().size() <= std::size_t(5 * 5));
+        }
+    }
+
 private:
     SharedPtr<MockWriter<>::EventsStore>::Type events;
     SharedPtr<OpenMPSimulator<TestCell<2> > >::Type simulator;
@@ -0,0 +1,340 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/io/mocksteerer.h>
+#include <libgeodecomp/io/mockwriter.h>
+#include <libgeodecomp/io/testinitializer.h>
+#include <libgeodecomp/io/teststeerer.h>
+#include <libgeodecomp/io/testwriter.h>
+#include <libgeodecomp/io/unstructuredtestinitializer.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/misc/testhelper.h>
+#include <libgeodecomp/misc/unstructuredtestcell.h>
+#include <libgeodecomp/parallelization/dataflowsimulator.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class DataflowSimulatorTest : public CxxTest::TestSuite
+{
+public:
+#ifdef LIBGEODECOMP_WITH_THREADS
+    static const int NANO_STEPS_2D = APITraits::SelectNanoSteps<TestCell<2> >::VALUE;
+    static const int NANO_STEPS_3D = APITraits::SelectNanoSteps<TestCell<3> >::VALUE;
+    typedef MockSteerer<TestCell<2> > MockSteererType;
+    typedef GridBase<TestCell<2>, 2> GridBaseType;
+    typedef GridBase<TestCell<3>, 3> GridBase3D;
+    typedef DataflowSimulator<TestCell<2> > SimulatorType;
+#endif
+
+    void setUp()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        dim = Coord<2>(17, 12);
+        maxSteps = 21;
+        startStep = 13;
+
+        simulator.reset(new SimulatorType(createInitializer(), Coord<2>(4, 3), 1, 3));
+        events.reset(new MockWriter<>::EventsStore);
+#endif
+    }
+
+    void tearDown()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        simulator.reset();
+#endif
+    }
+
+    void testDecomposition()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        TS_ASSERT_EQUALS(std::size_t(5 * 4), simulator->numChunks());
+
+        Region<2> expected;
+        expected << CoordBox<2>(Coord<2>(16, 9), Coord<2>(1, 3));
+        TS_ASSERT_EQUALS(expected, simulator->chunkRegions[19]);
+
+        // corners of a cube only touch 3 other tiles:
+        std::vector<std::size_t> neighbors;
+        neighbors << 1 << 5 << 6;
+        TS_ASSERT_EQUALS(neighbors, simulator->chunkNeighbors[0]);
+        TS_ASSERT_EQUALS(std::size_t(8), simulator->chunkNeighbors[6].size());
+
+        // the 3D TestCell wraps around, so with only 2 tiles along
+        // the y-axis both neighbors are the same:
+        DataflowSimulator<TestCell<3> > sim(
+            new TestInitializer<TestCell<3> >(Coord<3>(20, 10, 12)),
+            Coord<3>(5, 5, 4), 1, 1);
+        TS_ASSERT_EQUALS(std::size_t(4 * 2 * 3), sim.numChunks());
+        TS_ASSERT_EQUALS(std::size_t(3 * 2 * 3 - 1), sim.chunkNeighbors[0].size());
+#endif
+    }
+
+    void testStep()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        TS_ASSERT_EQUALS(startStep, simulator->getStep());
+
+        simulator->step();
+        TS_ASSERT_TEST_GRID(GridBaseType, *simulator->getGrid(), (startStep + 1) * NANO_STEPS_2D);
+        TS_ASSERT_EQUALS(startStep + 1, simulator->getStep());
+
+        simulator->step();
+        TS_ASSERT_TEST_GRID(GridBaseType, *simulator->getGrid(), (startStep + 2) * NANO_STEPS_2D);
+        TS_ASSERT_EQUALS(startStep + 2, simulator->getStep());
+#endif
+    }
+
+    void testRun()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        simulator->run();
+        TS_ASSERT_EQUALS(maxSteps, simulator->getStep());
+        TS_ASSERT_TEST_GRID(GridBaseType, *simulator->getGrid(), maxSteps * NANO_STEPS_2D);
+
+        // once more to check that run() resets the grid:
+        simulator->run();
+        TS_ASSERT_TEST_GRID(GridBaseType, *simulator->getGrid(), maxSteps * NANO_STEPS_2D);
+#endif
+    }
+
+    void testRunWithoutLag()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        for (unsigned lag = 0; lag < 4; ++lag) {
+            SimulatorType sim(createInitializer(), Coord<2>(3, 2), lag, 2);
+            sim.run();
+            TS_ASSERT_TEST_GRID(GridBaseType, *sim.getGrid(), maxSteps * NANO_STEPS_2D);
+        }
+#endif
+    }
+
+    void testWriterInvocation()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        unsigned period = 4;
+        TestWriter<> *writer = new TestWriter<>(period, startStep, maxSteps);
+        simulator->addWriter(writer);
+        simulator->run();
+        TS_ASSERT(writer->allEventsDone());
+#endif
+    }
+
+    void testWriterEvents()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        simulator->addWriter(new MockWriter<>(events, 3));
+        simulator->run();
+
+        MockWriter<>::EventsStore expectedEvents;
+        expectedEvents << MockWriter<>::Event(startStep, WRITER_INITIALIZED, 0, true);
+        for (unsigned i = startStep + 2; i < maxSteps; i += 3) {
+            expectedEvents << MockWriter<>::Event(i, WRITER_STEP_FINISHED, 0, true);
+        }
+        expectedEvents << MockWriter<>::Event(maxSteps, WRITER_ALL_DONE, 0, true);
+
+        TS_ASSERT_EQUALS(expectedEvents, *events);
+#endif
+    }
+
+    void testSteererCallback()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        SharedPtr<MockSteererType::EventsStore>::Type events(new MockSteererType::EventsStore);
+        simulator->addSteerer(new MockSteererType(5, events));
+
+        MockSteererType::EventsStore expectedEvents;
+        expectedEvents << MockSteererType::Event(13, STEERER_INITIALIZED, 0, true)
+                       << MockSteererType::Event(15, STEERER_NEXT_STEP, 0, true)
+                       << MockSteererType::Event(20, STEERER_NEXT_STEP, 0, true)
+                       << MockSteererType::Event(21, STEERER_ALL_DONE,  0, true)
+                       << MockSteererType::Event(-1, STEERER_ALL_DONE, -1, true);
+
+        simulator->run();
+        simulator.reset();
+
+        TS_ASSERT_EQUALS(*events, expectedEvents);
+#endif
+    }
+
+    void testSteererCanTerminateSimulation()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        unsigned eventStep = 15;
+        unsigned endStep = 19;
+        unsigned jumpSteps = 2;
+        simulator->addSteerer(new TestSteerer<2>(1, eventStep, NANO_STEPS_2D * jumpSteps, endStep));
+        simulator->run();
+
+        TS_ASSERT_TEST_GRID(
+            GridBaseType,
+            *simulator->getGrid(),
+            (endStep + 1 + jumpSteps) * NANO_STEPS_2D);
+#endif
+    }
+
+    void test3D()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        DataflowSimulator<TestCell<3> > sim(new TestInitializer<TestCell<3> >(), Coord<3>(4, 3, 5), 2, 4);
+        TS_ASSERT_TEST_GRID(GridBase3D, *sim.getGrid(), 0);
+
+        sim.step();
+        TS_ASSERT_TEST_GRID(GridBase3D, *sim.getGrid(), NANO_STEPS_3D);
+
+        sim.run();
+        TS_ASSERT_TEST_GRID(GridBase3D, *sim.getGrid(), 21 * NANO_STEPS_3D);
+#endif
+    }
+
+    void test1dTorus()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        typedef TestCell<1, Stencils::Moore<1, 1>, Topologies::Torus<1>::Topology,
+                 TestCellHelpers::EmptyAPI, TestCellHelpers::NoOutput> TestCell1dTorus;
+        typedef TestInitializer<TestCell1dTorus> TestInitializer1dTorus;
+
+        Coord<1> dim(666);
+        int startStep = 40;
+        int endStep = 70;
+        DataflowSimulator<TestCell1dTorus> sim(
+            new TestInitializer1dTorus(dim, endStep, startStep), Coord<1>(37), 3, 3);
+
+        TestWriter<TestCell1dTorus> *writer = new TestWriter<TestCell1dTorus>(7, startStep, endStep);
+        sim.addWriter(writer);
+
+        sim.run();
+        TS_ASSERT(writer->allEventsDone());
+#endif
+    }
+
+    void testWideStencilOnNonDivisibleTorus()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        typedef TestCell<2, Stencils::Moore<2, 2>, Topologies::Torus<2>::Topology,
+                 TestCellHelpers::EmptyAPI, TestCellHelpers::NoOutput> TestCellWide;
+        typedef GridBase<TestCellWide, 2> GridBaseType;
+        static const int NANO_STEPS = APITraits::SelectNanoSteps<TestCellWide>::VALUE;
+
+        // the last row of tiles is only 1 cell high, so the stencil
+        // reaches across it into the next row of tiles:
+        DataflowSimulator<TestCellWide> sim(
+            new TestInitializer<TestCellWide>(Coord<2>(4, 13), 30, 0), Coord<2>(4, 4), 3, 3);
+        TS_ASSERT_EQUALS(std::size_t(4), sim.numChunks());
+
+        std::vector<std::size_t> neighbors;
+        neighbors << 1 << 2 << 3;
+        TS_ASSERT_EQUALS(neighbors, sim.chunkNeighbors[0]);
+        neighbors.clear();
+        neighbors << 0 << 1 << 3;
+        TS_ASSERT_EQUALS(neighbors, sim.chunkNeighbors[2]);
+        neighbors.clear();
+        neighbors << 0 << 2;
+        TS_ASSERT_EQUALS(neighbors, sim.chunkNeighbors[3]);
+
+        sim.run();
+        TS_ASSERT_TEST_GRID(GridBaseType, *sim.getGrid(), 30 * NANO_STEPS);
+#endif
+    }
+
+    void testSoA()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        typedef GridBase<TestCellSoA, 3> GridBaseType;
+        DataflowSimulator<TestCellSoA> sim(new TestInitializer<TestCellSoA>(), Coord<3>(8, 4, 3), 1, 2);
+        TS_ASSERT_TEST_GRID(GridBaseType, *sim.getGrid(), 0);
+
+        sim.run();
+        TS_ASSERT_TEST_GRID(GridBaseType, *sim.getGrid(), 21 * NANO_STEPS_3D);
+#endif
+    }
+
+    void testUnstructured()
+    {
+#if defined(LIBGEODECOMP_WITH_THREADS) && defined(LIBGEODECOMP_WITH_CPP14)
+        typedef UnstructuredTestCell<> TestCellType;
+        int startStep = 7;
+        int endStep = 20;
+
+        DataflowSimulator<TestCellType> sim(
+            new UnstructuredTestInitializer<TestCellType>(614, endStep, startStep), Coord<1>(50), 2, 3);
+        // chunks are aligned to the default C == 4:
+        TS_ASSERT_EQUALS(std::size_t(12), sim.numChunks());
+        TestWriter<TestCellType> *writer = new TestWriter<TestCellType>(3, startStep, endStep);
+        sim.addWriter(writer);
+        sim.run();
+        TS_ASSERT(writer->allEventsDone());
+#endif
+    }
+
+    void testUnstructuredSoA1()
+    {
+#if defined(LIBGEODECOMP_WITH_THREADS) && defined(LIBGEODECOMP_WITH_CPP14)
+        typedef UnstructuredTestCellSoA1 TestCellType;
+        int startStep = 7;
+        int endStep = 20;
+
+        DataflowSimulator<TestCellType> sim(
+            new UnstructuredTestInitializer<TestCellType>(614, endStep, startStep), Coord<1>(50), 2, 3);
+        // chunks are aligned to C == 32:
+        TS_ASSERT_EQUALS(std::size_t(10), sim.numChunks());
+        TestWriter<TestCellType> *writer = new TestWriter<TestCellType>(3, startStep, endStep);
+        sim.addWriter(writer);
+        sim.run();
+        TS_ASSERT(writer->allEventsDone());
+#endif
+    }
+
+    void testUnstructuredSoA2()
+    {
+#if defined(LIBGEODECOMP_WITH_THREADS) && defined(LIBGEODECOMP_WITH_CPP14)
+        typedef UnstructuredTestCellSoA2 TestCellType;
+        int startStep = 7;
+        int endStep = 15;
+
+        DataflowSimulator<TestCellType> sim(
+            new UnstructuredTestInitializer<TestCellType>(632, endStep, startStep), Coord<1>(50), 1, 3);
+        // chunks are aligned to C == 8:
+        TS_ASSERT_EQUALS(std::size_t(12), sim.numChunks());
+        TestWriter<TestCellType> *writer = new TestWriter<TestCellType>(3, startStep, endStep);
+        sim.addWriter(writer);
+        sim.run();
+        TS_ASSERT(writer->allEventsDone());
+#endif
+    }
+
+    void testUnstructuredSoA3()
+    {
+#if defined(LIBGEODECOMP_WITH_THREADS) && defined(LIBGEODECOMP_WITH_CPP14)
+        typedef UnstructuredTestCellSoA3 TestCellType;
+        int startStep = 7;
+        int endStep = 19;
+
+        DataflowSimulator<TestCellType> sim(
+            new UnstructuredTestInitializer<TestCellType>(655, endStep, startStep), Coord<1>(40), 0, 3);
+        // chunks are aligned to SIGMA == 64 as cells get sorted
+        // within those blocks:
+        TS_ASSERT_EQUALS(std::size_t(11), sim.numChunks());
+        TestWriter<TestCellType> *writer = new TestWriter<TestCellType>(3, startStep, endStep);
+        sim.addWriter(writer);
+        sim.run();
+        TS_ASSERT(writer->allEventsDone());
+#endif
+    }
+
+private:
+#ifdef LIBGEODECOMP_WITH_THREADS
+    SharedPtr<MockWriter<>::EventsStore>::Type events;
+    SharedPtr<SimulatorType>::Type simulator;
+    unsigned maxSteps;
+    unsigned startStep;
+    Coord<2> dim;
+
+    Initializer<TestCell<2> > *createInitializer()
+    {
+        return new TestInitializer<TestCell<2> >(dim, maxSteps, startStep);
+    }
+#endif
+};
+
+}
@@ -4,6 +4,7 @@
 #include <libgeodecomp/io/memorywriter.h>
 #include <libgeodecomp/io/mockinitializer.h>
 #include <libgeodecomp/io/mockwriter.h>
+#include <libgeodecomp/io/simpleinitializer.h>
 #include <libgeodecomp/io/mocksteerer.h>
 #include <libgeodecomp/io/testinitializer.h>
 #include <libgeodecomp/io/teststeerer.h>
@@ -19,6 +20,77 @@ using namespace LibGeoDecomp;
 
 namespace LibGeoDecomp {
 
+/**
+ * Game of Life on a torus
+ */
+class LifeCell
+{
+public:
+    class API : public APITraits::HasTorusTopology<2>
+    {};
+
+    explicit LifeCell(bool alive = false) :
+        alive(alive)
+    {}
+
+    template<typename HOOD>
+    void update(const HOOD& hood, unsigned)
+    {
+        int livingNeighbors =
+            hood[Coord<2>(-1, -1)].alive + hood[Coord<2>(0, -1)].alive + hood[Coord<2>(1, -1)].alive +
+            hood[Coord<2>(-1,  0)].alive +                                hood[Coord<2>(1,  0)].alive +
+            hood[Coord<2>(-1,  1)].alive + hood[Coord<2>(0,  1)].alive + hood[Coord<2>(1,  1)].alive;
+
+        alive = hood[Coord<2>(0, 0)].alive ?
+            ((livingNeighbors == 2) || (livingNeighbors == 3)) :
+            (livingNeighbors == 3);
+    }
+
+    bool alive;
+};
+
+class ActiveLifeCell : public LifeCell
+{
+public:
+    class API :
+        public APITraits::HasTorusTopology<2>,
+        public APITraits::HasActiveRegion
+    {};
+
+    bool reachedFixedPoint(const ActiveLifeCell& previousState) const
+    {
+        return alive == previousState.alive;
+    }
+};
+
+/**
+ * A glider passing by a block, which is at a fixed point
+ */
+template<typename CELL>
+class LifeInitializer : public SimpleInitializer<CELL>
+{
+public:
+    LifeInitializer() :
+        SimpleInitializer<CELL>(Coord<2>(40, 30), 100)
+    {}
+
+    virtual void grid(GridBase<CELL, 2> *target)
+    {
+        std::vector<Coord<2> > living;
+        living << Coord<2>(2, 1)
+               << Coord<2>(3, 2)
+               << Coord<2>(1, 3) << Coord<2>(2, 3) << Coord<2>(3, 3)
+               << Coord<2>(30, 5) << Coord<2>(31, 5)
+               << Coord<2>(30, 6) << Coord<2>(31, 6);
+
+        CELL cell;
+        cell.alive = true;
+        for (std::size_t i = 0; i < living.size(); ++i) {
+            target->set(living[i], cell);
+        }
+    }
+};
+
 class SerialSimulatorTest : public CxxTest::TestSuite
 {
 public:
@@ -301,6 +373,27 @@ public:
 #endif
     }
 
+    void testActiveRegion()
+    {
+        SerialSimulator<LifeCell> referenceSim(new LifeInitializer<LifeCell>());
+        SerialSimulator<ActiveLifeCell> sim(new LifeInitializer<ActiveLifeCell>());
+        CoordBox<2> box = sim.getGrid()->boundingBox();
+        TS_ASSERT_EQUALS(std::size_t(40 * 30), sim.activeRegionTracker.activeRegion().size());
+
+        for (int t = 0; t < 100; ++t) {
+            referenceSim.step();
+            sim.step();
+
+            for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+                TS_ASSERT_EQUALS(referenceSim.getGrid()->get(*i).alive, sim.getGrid()->get(*i).alive);
+            }
+
+            // only the glider's surroundings remain active, the block
+            // is at a fixed point:
+            TS_ASSERT(sim.activeRegionTracker.activeRegion().size() <= std::size_t(7 * 7));
+        }
+    }
+
 private:
     SharedPtr<MockWriter<>::EventsStore>::Type events;
     SharedPtr<SerialSimulator<TestCell<2> > >::Type simulator;
@@ -0,0 +1,158 @@
+#ifndef LIBGEODECOMP_STORAGE_ACTIVEREGIONTRACKER_H
+#define LIBGEODECOMP_STORAGE_ACTIVEREGIONTRACKER_H
+
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/storage/gridbase.h>
+#include <libgeodecomp/storage/gridvisitor.h>
+
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Keeps track of the cells which need to be updated in the next time
+ * step for models which are using APITraits::HasActiveRegion. These
+ * are all cells within the stencil's radius of a cell which has
+ * changed during the previous step. All other cells are at a fixed
+ * point. For these no copying is required either: the grid written
+ * in the next step holds the same state from two steps ago.
+ *
+ * So far only the monolithic SerialSimulator and OpenMPSimulator
+ * make use of this, the distributed simulators always update all
+ * cells.
+ *
+ * The default implementation is a no-op, which always reports the
+ * whole simulation area as active.
+ */
+template<typename CELL, typename HAS_ACTIVE_REGION = typename APITraits::SelectActiveRegion<CELL>::Value>
+class ActiveRegionTracker
+{
+public:
+    typedef typename APITraits::SelectTopology<CELL>::Value Topology;
+    static const int DIM = Topology::DIM;
+
+    void reset(const Region<DIM>& newSimArea, const Coord<DIM>& /* newGridDim */)
+    {
+        simArea = newSimArea;
+    }
+
+    void invalidate()
+    {}
+
+    void update(const GridBase<CELL, DIM>& /* oldGrid */, const GridBase<CELL, DIM>& /* newGrid */)
+    {}
+
+    const Region<DIM>& activeRegion() const
+    {
+        return simArea;
+    }
+
+private:
+    Region<DIM> simArea;
+};
+
+/**
+ * see above
+ */
+template<typename CELL>
+class ActiveRegionTracker<CELL, APITraits::TrueType>
+{
+public:
+    typedef typename APITraits::SelectTopology<CELL>::Value Topology;
+    typedef typename APITraits::SelectStencil<CELL>::Value Stencil;
+    static const int DIM = Topology::DIM;
+
+    static_assert(
+        APITraits::SelectNanoSteps<CELL>::VALUE == 1,
+        "active regions can't be tracked for models with nano steps");
+
+    /**
+     * Marks all of the (new) simulation area as active, e.g. after
+     * (re-)initialization. newGridDim is required for wrapping
+     * around periodic boundaries.
+     */
+    void reset(const Region<DIM>& newSimArea, const Coord<DIM>& newGridDim)
+    {
+        simArea = newSimArea;
+        gridDim = newGridDim;
+        active = simArea;
+    }
+
+    /**
+     * Marks all cells as active. Needs to be called whenever cells
+     * have been modified outside of update(), e.g. by a Steerer.
+     */
+    void invalidate()
+    {
+        active = simArea;
+    }
+
+    /**
+     * Compares all cells of the active region after an update with
+     * their previous state and determines the active region for the
+     * next time step.
+     */
+    void update(const GridBase<CELL, DIM>& oldGrid, const GridBase<CELL, DIM>& newGrid)
+    {
+        ChangeDetector detector(&oldGrid);
+        newGrid.visit(active, &detector);
+        active = detector.changed.expandWithTopology(Stencil::RADIUS, gridDim, Topology()) & simArea;
+    }
+
+    const Region<DIM>& activeRegion() const
+    {
+        return active;
+    }
+
+private:
+    Region<DIM> simArea;
+    Region<DIM> active;
+    Coord<DIM> gridDim;
+
+    /**
+     * Collects all cells which differ from their previous state.
+     */
+    class ChangeDetector : public ConstGridVisitor<CELL, DIM>
+    {
+    public:
+        explicit ChangeDetector(const GridBase<CELL, DIM> *oldGrid) :
+            oldGrid(oldGrid)
+        {}
+
+        virtual void visit(const Streak<DIM>& streak, const CELL *cells)
+        {
+            buffer.resize(streak.length());
+            oldGrid->get(streak, &buffer[0]);
+
+            Streak<DIM> run(streak.origin, streak.origin.x());
+            for (int i = 0; i < streak.length(); ++i) {
+                if (cells[i].reachedFixedPoint(buffer[i])) {
+                    flush(&run, streak.origin.x() + i + 1);
+                } else {
+                    run.endX = streak.origin.x() + i + 1;
+                }
+            }
+            flush(&run, streak.endX);
+        }
+
+        Region<DIM> changed;
+
+    private:
+        const GridBase<CELL, DIM> *oldGrid;
+        std::vector<CELL> buffer;
+
+        inline void flush(Streak<DIM> *run, int nextX)
+        {
+            if (run->length() > 0) {
+                changed << *run;
+            }
+            run->origin.x() = nextX;
+            run->endX = nextX;
+        }
+    };
+};
+
+}
+
+#endif
@@ -7,9 +7,45 @@
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
 #include <libgeodecomp/storage/neighborhooditerator.h>
 #include <libgeodecomp/storage/fixedarray.h>
+#include <libgeodecomp/storage/verletlist.h>
+
+#include <type_traits>
 
 namespace LibGeoDecomp {
 
+namespace BoxCellHelpers {
+
+/**
+ * Holds the VerletList of a BoxCell, but only if the particles
+ * request one via APITraits::HasVerletList (and is empty otherwise).
+ */
+template<int DIM, typename SUPPORTS_VERLET_LIST>
+class VerletListStorage
+{};
+
+template<int DIM>
+class VerletListStorage<DIM, APITraits::TrueType>
+{
+protected:
+    VerletList<DIM> verletList;
+};
+
+template<typename API, typename SUPPORTS_MPI_DATA_TYPE = void>
+class DeclaresMPIDataType
+{
+public:
+    static const bool VALUE = false;
+};
+
+template<typename API>
+class DeclaresMPIDataType<API, typename API::SupportsMPIDataType>
+{
+public:
+    static const bool VALUE = true;
+};
+
+}
+
 /**
  * This class is an adapter for implementing n-body codes and
  * molecular dynamics (MD) applications with LibGeoDecomp. A BoxCell
@@ -17,9 +53,19 @@ namespace LibGeoDecomp {
  * particles (of type Cargo) which reside in its area in the given
  * CONTAINER type (e.g. LibGeoDecomp::FixedArray or std::vector). Particles can
  * access neighboring particles in a given distance during update().
+ *
+ * If the particles' API includes APITraits::HasVerletList, then
+ * update() will only pass those neighbors to each particle which
+ * are listed in its cached Verlet list (see VerletList). As the list
+ * lives in the BoxCell, the cell is then no longer trivially
+ * copyable and must not be sent via MPI as an opaque blob (e.g.
+ * APITraits::HasOpaqueMPIDataType), which is asserted at compile
+ * time.
  */
 template<typename CONTAINER>
-class BoxCell
+class BoxCell : public BoxCellHelpers::VerletListStorage<
+    APITraits::SelectTopology<typename CONTAINER::value_type>::Value::DIM,
+    typename APITraits::SelectVerletList<typename CONTAINER::value_type>::Value>
 {
 public:
     friend class BoxCellTest;
@@ -30,6 +76,7 @@ public:
     typedef typename Container::const_iterator const_iterator;
     typedef typename Container::iterator iterator;
     typedef typename APITraits::SelectTopology<Cargo>::Value Topology;
+    typedef typename APITraits::SelectVerletList<Cargo>::Value SupportsVerletList;
 
     class API :
         public APITraits::SelectAPI<Cargo>::Value,
@@ -38,6 +85,11 @@ public:
 
     const static int DIM = Topology::DIM;
 
+    static_assert(
+        !(std::is_same<SupportsVerletList, APITraits::TrueType>::value &&
+          BoxCellHelpers::DeclaresMPIDataType<typename APITraits::SelectAPI<Cargo>::Value>::VALUE),
+        "BoxCells with Verlet lists aren't trivially copyable and can't be sent as MPI data types");
+
     template<
         typename WRITE_CONTAINER,
         typename NEIGHBORHOOD,
@@ -79,11 +131,13 @@ public:
     inline void insert(const Cargo& particle)
     {
         particles << particle;
+        markChanged(SupportsVerletList());
     }
 
     inline void remove(const std::size_t i)
     {
         particles.remove(i);
+        markChanged(SupportsVerletList());
     }
 
     inline std::size_t size() const
@@ -107,6 +161,7 @@ public:
     BoxCell& operator<<(const Cargo& cargo)
     {
         particles << cargo;
+        markChanged(SupportsVerletList());
         return *this;
     }
 
@@ -118,7 +173,7 @@ public:
         NeighborhoodAdapterType adapter(this, &hood);
 
         copyOver(hood[Coord<DIM>()], adapter, nanoStep);
-        updateCargo(adapter, nanoStep);
+        updateCargo(hood, adapter, nanoStep, SupportsVerletList());
     }
 
     template<class NEIGHBORHOOD_ADAPTER_SELF>
@@ -136,6 +191,8 @@ public:
         } else {
             particles = oldSelf.particles;
         }
+
+        copyOverVerletList(oldSelf, nanoStep, SupportsVerletList());
     }
 
     template<class NEIGHBORHOOD_ADAPTER_ALL>
@@ -162,6 +219,105 @@ protected:
     FloatCoord<DIM> dimension;
     Container particles;
 
+    template<class HOOD, class NEIGHBORHOOD_ADAPTER_ALL>
+    inline void updateCargo(
+        HOOD& /* hood */,
+        NEIGHBORHOOD_ADAPTER_ALL& allNeighbors,
+        int nanoStep,
+        APITraits::FalseType)
+    {
+        updateCargo(allNeighbors, nanoStep);
+    }
+
+    template<class HOOD, class NEIGHBORHOOD_ADAPTER_ALL>
+    inline void updateCargo(
+        HOOD& hood,
+        NEIGHBORHOOD_ADAPTER_ALL& /* allNeighbors */,
+        int nanoStep,
+        APITraits::TrueType)
+    {
+        typedef VerletList<DIM> VerletListType;
+        typedef typename VerletListType::template Neighborhood<BoxCell, Container> VerletNeighborhood;
+
+        const Container *containers[VerletListType::NUM_BOXES];
+        const VerletListType *lists[VerletListType::NUM_BOXES];
+        CoordBox<DIM> box(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3));
+        int index = 0;
+
+        for (typename CoordBox<DIM>::Iterator i = box.begin(); i != box.end(); ++i) {
+            const BoxCell& neighbor = hood[*i];
+            containers[index] = &neighbor.particles;
+            lists[index] = &neighbor.verletList;
+            ++index;
+        }
+
+        double skin = Cargo::API::verletSkin();
+        if (this->verletList.needsRebuild(lists, 0.5 * skin)) {
+            this->verletList.build(
+                particles,
+                containers,
+                lists,
+                Cargo::API::verletCutoff() + skin);
+        }
+
+        // we need to fix end here so particles inserted by update()
+        // won't be immediately updated, too:
+        std::size_t end = particles.size();
+
+        for (std::size_t i = 0; i < end; ++i) {
+            VerletNeighborhood neighbors(
+                this,
+                containers,
+                this->verletList.begin(i),
+                this->verletList.end(i));
+            particles[i].update(neighbors, nanoStep);
+        }
+
+        this->verletList.track(particles, *containers[VerletListType::CENTER], end);
+    }
+
+    inline void markChanged(APITraits::FalseType)
+    {}
+
+    inline void markChanged(APITraits::TrueType)
+    {
+        this->verletList.markChanged();
+    }
+
+    inline void copyOverVerletList(const BoxCell& /* oldSelf */, int /* nanoStep */, APITraits::FalseType)
+    {}
+
+    /**
+     * The Verlet list remains usable only if the box' particles
+     * retain their order, i.e. if no particle has left or entered
+     * the box during copyOver(). The old grid is read-only during
+     * the update, so the list is copied. The assignment reuses the
+     * capacity of the list this cell held two steps ago, so it
+     * doesn't allocate once the lists have stopped growing.
+     */
+    inline void copyOverVerletList(const BoxCell& oldSelf, int nanoStep, APITraits::TrueType)
+    {
+        this->verletList = oldSelf.verletList;
+        this->verletList.clearChanged();
+
+        if (nanoStep != 0) {
+            return;
+        }
+
+        FloatCoord<DIM> oppositeCorner = origin + dimension;
+        std::size_t retained = 0;
+
+        for (typename Container::const_iterator i = oldSelf.particles.begin(); i != oldSelf.particles.end(); ++i) {
+            if (APITraits::SelectPositionChecker<Cargo>::value(*i, origin, oppositeCorner)) {
+                ++retained;
+            }
+        }
+
+        if ((retained != oldSelf.particles.size()) || (retained != particles.size())) {
+            this->verletList.markChanged();
+        }
+    }
+
     template<typename ITERATOR>
     void addContainedParticles(const ITERATOR& begin, const ITERATOR& end)
     {
@@ -147,6 +147,34 @@ public:
                      cells);
     }
 
+    virtual void visit(const Region<DIM>& region, GridVisitor<CELL_TYPE, DIM> *visitor)
+    {
+        std::vector<CELL_TYPE> buffer;
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            CELL_TYPE *cells = delegate.streakPointer(relativeStreak(*i));
+            if (cells) {
+                visitor->visit(*i, cells);
+            } else {
+                this->visitCopy(*i, visitor, &buffer);
+            }
+        }
+    }
+
+    virtual void visit(const Region<DIM>& region, ConstGridVisitor<CELL_TYPE, DIM> *visitor) const
+    {
+        std::vector<CELL_TYPE> buffer;
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            const CELL_TYPE *cells = delegate.streakPointer(relativeStreak(*i));
+            if (cells) {
+                visitor->visit(*i, cells);
+            } else {
+                this->visitCopy(*i, visitor, &buffer);
+            }
+        }
+    }
+
     virtual void setEdge(const CELL_TYPE& cell)
     {
         getEdgeCell() = cell;
@@ -270,6 +298,16 @@ protected:
 private:
     Delegate delegate;
     Coord<DIM> origin;
+
+    inline Streak<DIM> relativeStreak(const Streak<DIM>& streak) const
+    {
+        Coord<DIM> relativeOrigin = streak.origin - origin;
+        if (TOPOLOGICALLY_CORRECT) {
+            relativeOrigin = Topology::normalize(relativeOrigin, topoDimensions);
+        }
+
+        return Streak<DIM>(relativeOrigin, relativeOrigin.x() + streak.length());
+    }
 };
 
 #ifdef _MSC_BUILD
@@ -11,18 +11,65 @@
 #include <libgeodecomp/storage/gridbase.h>
 #include <libgeodecomp/storage/selector.h>
 
+#include <algorithm>
+
 namespace LibGeoDecomp {
 
 template<typename CELL_TYPE, typename GRID_TYPE>
 class CoordMap;
 
+namespace GridHelpers {
+
+/**
+ * Default-initializes elements which are constructed without a
+ * value. For trivial types this leaves the memory untouched, so
+ * Grid can decide which thread touches its pages first.
+ */
+template<typename T>
+class DefaultInitAllocator : public LibFlatArray::aligned_allocator<T, 64>
+{
+public:
+    typedef T* pointer;
+
+    template<typename OTHER>
+    struct rebind
+    {
+        typedef DefaultInitAllocator<OTHER> other;
+    };
+
+    inline DefaultInitAllocator()
+    {}
+
+    template<typename OTHER>
+    inline explicit DefaultInitAllocator(const DefaultInitAllocator<OTHER>& /* other */)
+    {}
+
+    void construct(pointer p)
+    {
+        ::new(static_cast<void*>(p)) T;
+    }
+
+    void construct(pointer p, const T& val)
+    {
+        ::new(static_cast<void*>(p)) T(val);
+    }
+};
+
+}
+
 #ifdef _MSC_BUILD
 #pragma warning( push )
 #pragma warning( disable : 4820 )
 #endif
 
 /**
- * A multi-dimensional regular grid
+ * A multi-dimensional regular grid.
+ *
+ * Large grids are filled by all OpenMP threads, row by row with the
+ * static schedule which UpdateFunctor and Initializer::initGrids()
+ * use for the Streaks of a grid. With first-touch page placement
+ * the rows thus end up on the NUMA node of the thread which will
+ * update them.
  */
 template<typename CELL_TYPE, typename TOPOLOGY=Topologies::Cube<2>::Topology>
 class Grid : public GridBase<CELL_TYPE, TOPOLOGY::DIM>
@@ -37,7 +84,13 @@ public:
     using GridBase<CELL_TYPE, TOPOLOGY::DIM>::saveRegion;
 
     // always align on cache line boundaries
-    typedef typename std::vector<CELL_TYPE, LibFlatArray::aligned_allocator<CELL_TYPE, 64> > CellVector;
+    typedef typename std::vector<CELL_TYPE, GridHelpers::DefaultInitAllocator<CELL_TYPE> > CellVector;
+
+    /**
+     * Grids smaller than this (in bytes) are filled by the
+     * constructing thread alone.
+     */
+    static const std::size_t PARALLEL_FILL_THRESHOLD = 1 << 20;
     typedef TOPOLOGY Topology;
     typedef CELL_TYPE Cell;
     typedef CoordMap<CELL_TYPE, Grid<CELL_TYPE, TOPOLOGY> > CoordMapType;
@@ -47,9 +100,11 @@ public:
         const CELL_TYPE& defaultCell = CELL_TYPE(),
         const CELL_TYPE& edgeCell = CELL_TYPE()) :
         dimensions(dim),
-        cellVector(std::size_t(dim.prod()), defaultCell),
+        cellVector(std::size_t(dim.prod())),
         edgeCell(edgeCell)
-    {}
+    {
+        fill(defaultCell);
+    }
 
     explicit Grid(const GridBase<CELL_TYPE, DIM>& base) :
         dimensions(base.dimensions()),
@@ -83,7 +138,7 @@ public:
     inline void resize(const Coord<DIM>& newDim)
     {
         dimensions = newDim;
-        cellVector.resize(std::size_t(newDim.prod()));
+        cellVector.resize(std::size_t(newDim.prod()), CELL_TYPE());
     }
 
     /**
@@ -124,6 +179,25 @@ public:
         return cellVector.data();
     }
 
+    /**
+     * Returns a pointer to the first cell of the Streak if all of
+     * its cells are stored consecutively, and 0 otherwise (e.g. if
+     * the Streak leaves the grid).
+     */
+    inline CELL_TYPE *streakPointer(const Streak<DIM>& streak)
+    {
+        if (!boundingBox().inBounds(streak.origin) || (streak.endX > dimensions.x())) {
+            return 0;
+        }
+
+        return &cellVector[std::size_t(streak.origin.toIndex(dimensions))];
+    }
+
+    inline const CELL_TYPE *streakPointer(const Streak<DIM>& streak) const
+    {
+        return const_cast<Grid&>(*this).streakPointer(streak);
+    }
+
     inline CELL_TYPE& operator[](const Coord<DIM>& coord)
     {
         return Topology::locate(cellVector, coord, dimensions, edgeCell);
@@ -241,6 +315,34 @@ public:
         return CoordBox<DIM>(Coord<DIM>(), dimensions);
     }
 
+    virtual void visit(const Region<DIM>& region, GridVisitor<CELL_TYPE, DIM> *visitor)
+    {
+        std::vector<CELL_TYPE> buffer;
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            CELL_TYPE *cells = streakPointer(*i);
+            if (cells) {
+                visitor->visit(*i, cells);
+            } else {
+                this->visitCopy(*i, visitor, &buffer);
+            }
+        }
+    }
+
+    virtual void visit(const Region<DIM>& region, ConstGridVisitor<CELL_TYPE, DIM> *visitor) const
+    {
+        std::vector<CELL_TYPE> buffer;
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            const CELL_TYPE *cells = streakPointer(*i);
+            if (cells) {
+                visitor->visit(*i, cells);
+            } else {
+                this->visitCopy(*i, visitor, &buffer);
+            }
+        }
+    }
+
     void saveRegion(std::vector<CELL_TYPE> *buffer, const Region<DIM>& region, const Coord<DIM>& offset = Coord<DIM>()) const
     {
         CELL_TYPE *target = buffer->data();
@@ -302,6 +404,21 @@ private:
     Coord<DIM> dimensions;
     CellVector cellVector;
     CELL_TYPE edgeCell;
+
+    inline void fill(const CELL_TYPE& cell)
+    {
+        long rowLength = dimensions.x();
+        long numRows = (rowLength > 0) ? long(cellVector.size()) / rowLength : 0;
+        bool parallel = (cellVector.size() * sizeof(CELL_TYPE)) >= PARALLEL_FILL_THRESHOLD;
+
+#pragma omp parallel for schedule(static) if (parallel)
+        for (long row = 0; row < numRows; ++row) {
+            std::fill(
+                cellVector.begin() + row * rowLength,
+                cellVector.begin() + (row + 1) * rowLength,
+                cell);
+        }
+    }
 };
 
 #ifdef _MSC_BUILD
@@ -5,6 +5,8 @@
 #include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/streak.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/storage/gridvisitor.h>
 #include <libgeodecomp/storage/memorylocation.h>
 #include <libgeodecomp/storage/selector.h>
 
@@ -18,7 +20,7 @@ namespace GridBaseHelpers {
  * if CELL == char. We could disallow char as a template parameter to
  * GridBase and friends, but that seems unnatural.
  */
-template<int DIM>
+template<int DIM, typename CELL = void, typename SUPPORTS_PACKING = void>
 class LoadSaveRegionCharInterface
 {
 public:
@@ -50,6 +52,113 @@ public:
     }
 };
 
+/**
+ * Cells flagged with APITraits::HasPacking are serialized into char
+ * buffers via their pack()/unpack() members, so the buffer only
+ * holds as many bytes as each cell actually needs. The cells are
+ * accessed via GridBase::visit(), which is why this works for all
+ * grids alike.
+ */
+template<int DIM, typename CELL>
+class LoadSaveRegionCharInterface<DIM, CELL, typename CELL::API::SupportsPacking>
+{
+public:
+    virtual ~LoadSaveRegionCharInterface()
+    {}
+
+    // implemented by GridBase:
+    virtual void visit(const Region<DIM>& region, GridVisitor<CELL, DIM> *visitor) = 0;
+    virtual void visit(const Region<DIM>& region, ConstGridVisitor<CELL, DIM> *visitor) const = 0;
+
+    /**
+     * Resizes buffer to the total packed size of the cells in region.
+     */
+    virtual void saveRegion(
+        std::vector<char> *buffer,
+        const Region<DIM>& region,
+        const Coord<DIM>& offset = Coord<DIM>()) const
+    {
+        // clear() retains the capacity, so buffers which are reused
+        // for every ghost zone update are rarely reallocated:
+        buffer->clear();
+        PackVisitor visitor(buffer);
+
+        if (offset == Coord<DIM>()) {
+            visit(region, &visitor);
+        } else {
+            visit(translate(region, offset), &visitor);
+        }
+    }
+
+    virtual void loadRegion(
+        const std::vector<char>& buffer,
+        const Region<DIM>& region,
+        const Coord<DIM>& offset = Coord<DIM>())
+    {
+        UnpackVisitor visitor(buffer);
+
+        if (offset == Coord<DIM>()) {
+            visit(region, &visitor);
+        } else {
+            visit(translate(region, offset), &visitor);
+        }
+    }
+
+private:
+    class PackVisitor : public ConstGridVisitor<CELL, DIM>
+    {
+    public:
+        explicit PackVisitor(std::vector<char> *buffer) :
+            buffer(buffer)
+        {}
+
+        void visit(const Streak<DIM>& streak, const CELL *cells)
+        {
+            for (int i = 0; i < streak.length(); ++i) {
+                std::size_t offset = buffer->size();
+                buffer->resize(offset + cells[i].packedSize());
+                cells[i].pack(&(*buffer)[offset]);
+            }
+        }
+
+    private:
+        std::vector<char> *buffer;
+    };
+
+    class UnpackVisitor : public GridVisitor<CELL, DIM>
+    {
+    public:
+        explicit UnpackVisitor(const std::vector<char>& buffer) :
+            cursor(buffer.data()),
+            end(buffer.data() + buffer.size())
+        {}
+
+        void visit(const Streak<DIM>& streak, CELL *cells)
+        {
+            for (int i = 0; i < streak.length(); ++i) {
+                if (cursor >= end) {
+                    throw std::logic_error("buffer exhausted before all cells of the region were unpacked");
+                }
+                cursor += cells[i].unpack(cursor);
+            }
+        }
+
+    private:
+        const char *cursor;
+        const char *end;
+    };
+
+    static Region<DIM> translate(const Region<DIM>& region, const Coord<DIM>& offset)
+    {
+        Region<DIM> ret;
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(offset); i != region.endStreak(offset); ++i) {
+            ret << *i;
+        }
+
+        return ret;
+    }
+};
+
 }
 
 template<typename CELL, int DIM, typename WEIGHT_TYPE>
@@ -68,15 +177,15 @@ class ProxyGrid;
  * stored with the adjacency.
  */
 template<typename CELL, int DIMENSIONS, typename WEIGHT_TYPE = double>
-class GridBase : GridBaseHelpers::LoadSaveRegionCharInterface<DIMENSIONS>
+class GridBase : GridBaseHelpers::LoadSaveRegionCharInterface<DIMENSIONS, CELL>
 {
 public:
     friend class ProxyGrid<CELL, DIMENSIONS, WEIGHT_TYPE>;
     typedef CELL CellType;
     typedef std::vector<std::pair<Coord<2>, WEIGHT_TYPE> > SparseMatrix;
 
-    using GridBaseHelpers::LoadSaveRegionCharInterface<DIMENSIONS>::saveRegion;
-    using GridBaseHelpers::LoadSaveRegionCharInterface<DIMENSIONS>::loadRegion;
+    using GridBaseHelpers::LoadSaveRegionCharInterface<DIMENSIONS, CELL>::saveRegion;
+    using GridBaseHelpers::LoadSaveRegionCharInterface<DIMENSIONS, CELL>::loadRegion;
 
     const static int DIM = DIMENSIONS;
 
@@ -179,6 +288,33 @@ public:
         throw std::logic_error("loadRegion not implemented for buffers of type CELL, not an AoS grid?");
     }
 
+    /**
+     * Hands all cells within region to the visitor, Streak by
+     * Streak. This generic implementation copies each Streak via
+     * get()/set(), but grids will generally grant direct access to
+     * their storage. Either way the virtual dispatch happens per
+     * Streak, not per cell, which makes this the preferred way for
+     * Writers, Steerers etc. to access larger parts of a grid.
+     */
+    virtual void visit(const Region<DIM>& region, GridVisitor<CELL, DIM> *visitor)
+    {
+        std::vector<CELL> buffer;
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            visitCopy(*i, visitor, &buffer);
+        }
+    }
+
+    /**
+     * Read-only counterpart to visit()
+     */
+    virtual void visit(const Region<DIM>& region, ConstGridVisitor<CELL, DIM> *visitor) const
+    {
+        std::vector<CELL> buffer;
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            visitCopy(*i, visitor, &buffer);
+        }
+    }
+
     Coord<DIM> dimensions() const
     {
         return boundingBox().dimensions;
@@ -293,6 +429,21 @@ protected:
     Coord<DIM> topoDimensions;
     Region<DIM> myBoundingRegion;
 
+    inline void visitCopy(const Streak<DIM>& streak, GridVisitor<CELL, DIM> *visitor, std::vector<CELL> *buffer)
+    {
+        buffer->resize(streak.length());
+        get(streak, &(*buffer)[0]);
+        visitor->visit(streak, &(*buffer)[0]);
+        set(streak, &(*buffer)[0]);
+    }
+
+    inline void visitCopy(const Streak<DIM>& streak, ConstGridVisitor<CELL, DIM> *visitor, std::vector<CELL> *buffer) const
+    {
+        buffer->resize(streak.length());
+        get(streak, &(*buffer)[0]);
+        visitor->visit(streak, &(*buffer)[0]);
+    }
+
     virtual void saveMemberImplementation(
         char *target,
         MemoryLocation::Location targetLocation,
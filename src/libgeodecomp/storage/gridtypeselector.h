@@ -68,8 +68,9 @@ private:
     static const std::size_t MATRICES = APITraits::SelectSellMatrices<CELL_TYPE>::VALUE;
     static const int C = APITraits::SelectSellC<CELL_TYPE>::VALUE;
     static const int SIGMA = APITraits::SelectSellSigma<CELL_TYPE>::VALUE;
+    typedef typename APITraits::SelectSellContainer<CELL_TYPE>::Value MatrixType;
 public:
-    typedef ReorderingUnstructuredGrid<UnstructuredSoAGrid<CELL_TYPE, MATRICES, ValueType, C, SIGMA> > Value;
+    typedef ReorderingUnstructuredGrid<UnstructuredSoAGrid<CELL_TYPE, MATRICES, ValueType, C, SIGMA, MatrixType> > Value;
 };
 #endif
 
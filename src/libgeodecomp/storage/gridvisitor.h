@@ -0,0 +1,132 @@
+#ifndef LIBGEODECOMP_STORAGE_GRIDVISITOR_H
+#define LIBGEODECOMP_STORAGE_GRIDVISITOR_H
+
+#include <libgeodecomp/geometry/streak.h>
+
+#include <libflatarray/member_ptr_to_offset.hpp>
+#include <stdexcept>
+
+namespace LibGeoDecomp {
+
+/**
+ * Type-erased view of a Streak within a grid that uses LibFlatArray's
+ * Struct of Arrays (SoA) layout. member() yields a pointer to the
+ * member's values for all cells of the Streak, which are stored
+ * consecutively. CELL may be a non-class type, hence the member
+ * pointer's class is deduced rather than spelled out.
+ */
+template<typename CELL, typename CHAR = char>
+class SoAStreak
+{
+public:
+    inline SoAStreak(CHAR *data, const long volume, const long index) :
+        data(data),
+        volume(volume),
+        index(index)
+    {}
+
+    template<typename MEMBER, typename OWNER>
+    inline MEMBER *member(MEMBER OWNER:: *memberPointer) const
+    {
+        long offset = LibFlatArray::member_ptr_to_offset()(memberPointer);
+        return reinterpret_cast<MEMBER*>(data + volume * offset + index * long(sizeof(MEMBER)));
+    }
+
+    template<typename MEMBER, typename OWNER>
+    inline const MEMBER *constMember(MEMBER OWNER:: *memberPointer) const
+    {
+        long offset = LibFlatArray::member_ptr_to_offset()(memberPointer);
+        return reinterpret_cast<const MEMBER*>(data + volume * offset + index * long(sizeof(MEMBER)));
+    }
+
+private:
+    CHAR *data;
+    long volume;
+    long index;
+};
+
+/**
+ * A GridVisitor is handed all cells of a Region, Streak by Streak,
+ * via GridBase::visit(). Grids which store cells in Array of Structs
+ * (AoS) layout pass a pointer to the cells in place, so neither
+ * copies nor per-cell virtual calls are required. Other grids (or
+ * Streaks which aren't stored consecutively, e.g. on periodic
+ * boundaries) fall back to copying the cells through a buffer, so
+ * modifications are written back in any case.
+ *
+ * Visitors may opt into direct access to SoA grids by overriding
+ * supportsSoA() and the corresponding visit() overload.
+ */
+template<typename CELL, int DIM>
+class GridVisitor
+{
+public:
+    virtual ~GridVisitor()
+    {}
+
+    /**
+     * cells points to streak.length() consecutive cells.
+     */
+    virtual void visit(const Streak<DIM>& streak, CELL *cells) = 0;
+
+    virtual bool supportsSoA() const
+    {
+        return false;
+    }
+
+    virtual void visit(const Streak<DIM>& /* streak */, const SoAStreak<CELL>& /* cells */)
+    {
+        throw std::logic_error("SoA access not implemented by this visitor");
+    }
+};
+
+/**
+ * Read-only counterpart to GridVisitor, e.g. for Writers.
+ */
+template<typename CELL, int DIM>
+class ConstGridVisitor
+{
+public:
+    virtual ~ConstGridVisitor()
+    {}
+
+    /**
+     * cells points to streak.length() consecutive cells.
+     */
+    virtual void visit(const Streak<DIM>& streak, const CELL *cells) = 0;
+
+    virtual bool supportsSoA() const
+    {
+        return false;
+    }
+
+    virtual void visit(const Streak<DIM>& /* streak */, const SoAStreak<CELL, const char>& /* cells */)
+    {
+        throw std::logic_error("SoA access not implemented by this visitor");
+    }
+};
+
+/**
+ * Copies all visited cells into another grid, e.g. to extract a
+ * Region from a grid with a single Streak-wise copy.
+ */
+template<typename CELL, int DIM, typename GRID>
+class CopyingGridVisitor : public ConstGridVisitor<CELL, DIM>
+{
+public:
+    explicit CopyingGridVisitor(GRID *target) :
+        target(target)
+    {}
+
+    virtual void visit(const Streak<DIM>& streak, const CELL *cells)
+    {
+        target->set(streak, cells);
+    }
+
+private:
+    GRID *target;
+};
+
+}
+
+#endif
@@ -0,0 +1,421 @@
+#ifndef LIBGEODECOMP_STORAGE_LINEARSTENCIL_H
+#define LIBGEODECOMP_STORAGE_LINEARSTENCIL_H
+
+#include <libflatarray/loop_peeler.hpp>
+#include <libflatarray/member_ptr_to_offset.hpp>
+#include <libflatarray/short_vec.hpp>
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/fixedcoord.h>
+#include <libgeodecomp/storage/shortvecswitch.h>
+
+namespace LibGeoDecomp {
+
+/**
+ * A single coefficient of a LinearStencil: the neighbor at the
+ * relative coordinate (X, Y, Z) is weighted with NUMERATOR /
+ * DENOMINATOR. Coefficients are given as fractions since floating
+ * point values can't be passed as template parameters. As a bonus
+ * this allows us to compare coefficients at compile time.
+ */
+template<int X, int Y, int Z, int NUMERATOR, int DENOMINATOR = 1>
+class StencilWeight : public FixedCoord<X, Y, Z>
+{
+public:
+    static_assert(DENOMINATOR != 0, "denominator of stencil weight must not be zero");
+
+    static const int NUM = NUMERATOR;
+    static const int DENOM = DENOMINATOR;
+    static const bool IS_ONE = (NUMERATOR == DENOMINATOR);
+
+    template<typename OTHER>
+    class Equals
+    {
+    public:
+        static const bool VALUE = (long(NUM) * OTHER::DENOM == long(OTHER::NUM) * DENOM);
+    };
+
+    static const int RADIUS =
+        ((X < 0 ? -X : X) > (Y < 0 ? -Y : Y)) ?
+        (((X < 0 ? -X : X) > (Z < 0 ? -Z : Z)) ? (X < 0 ? -X : X) : (Z < 0 ? -Z : Z)) :
+        (((Y < 0 ? -Y : Y) > (Z < 0 ? -Z : Z)) ? (Y < 0 ? -Y : Y) : (Z < 0 ? -Z : Z));
+
+    template<typename CARGO>
+    static inline CARGO value()
+    {
+        return CARGO(NUMERATOR) / CARGO(DENOMINATOR);
+    }
+};
+
+/**
+ * Describes a constant-coefficient linear stencil, e.g. Jacobi or
+ * Laplace, as a list of StencilWeights and generates the
+ * corresponding update kernels. This saves users from hand-writing
+ * the weighted sum and the vectorization boilerplate:
+ *
+ *   class Cell
+ *   {
+ *   public:
+ *       typedef LinearStencil<
+ *           StencilWeight< 0,  0, -1, 1, 6>,
+ *           StencilWeight< 0, -1,  0, 1, 6>,
+ *           ...
+ *           StencilWeight< 0,  0,  1, 1, 6> > Jacobi;
+ *
+ *       template<typename HOOD_OLD, typename HOOD_NEW>
+ *       static void updateLineX(HOOD_OLD& hoodOld, int indexEnd, HOOD_NEW& hoodNew, int nanoStep)
+ *       {
+ *           Jacobi::updateLineX<LibFlatArray::short_vec<double, 8> >(
+ *               hoodOld, indexEnd, hoodNew, &Cell::temp);
+ *       }
+ *
+ *       double temp;
+ *   };
+ *
+ * The kernels accept any number of members (all of the same type),
+ * to which the stencil is applied in a single sweep. Streaming
+ * stores can be selected by passing a
+ * LibFlatArray::streaming_short_vec, or at runtime by calling
+ * updateLineXSwitch<CARGO, ARITY>() (C++14 only), which streams only
+ * if the grids exceed the actual last level cache (see
+ * shortVecSwitch()). Stores are aligned by peeling
+ * the loop with respect to the new grid, which suffices for SoA
+ * grids. For AoS grids streaming stores are only safe if lines are
+ * aligned, too.
+ *
+ * If all coefficients are equal (as for Jacobi), neighbors are
+ * summed up and scaled only once, saving one multiplication per
+ * neighbor.
+ */
+template<typename... WEIGHTS>
+class LinearStencil
+{
+private:
+    template<typename... W>
+    class Helper;
+
+    template<typename HEAD, typename... TAIL>
+    class Helper<HEAD, TAIL...>
+    {
+    public:
+        static const int RADIUS =
+            HEAD::RADIUS > Helper<TAIL...>::RADIUS ? HEAD::RADIUS : Helper<TAIL...>::RADIUS;
+        static const bool UNIFORM =
+            Helper<TAIL...>::template AllEqual<HEAD>::VALUE;
+
+        template<typename REFERENCE>
+        class AllEqual
+        {
+        public:
+            static const bool VALUE =
+                HEAD::template Equals<REFERENCE>::VALUE &&
+                Helper<TAIL...>::template AllEqual<REFERENCE>::VALUE;
+        };
+
+        template<typename VALUE, typename LOADER>
+        static inline void sum(VALUE *accumulator, const LOADER& loader)
+        {
+            *accumulator += loader(HEAD());
+            Helper<TAIL...>::sum(accumulator, loader);
+        }
+
+        template<typename CARGO, typename VALUE, typename LOADER>
+        static inline void weightedSum(VALUE *accumulator, const LOADER& loader)
+        {
+            if (HEAD::IS_ONE) {
+                *accumulator += loader(HEAD());
+            } else {
+                *accumulator += VALUE(loader(HEAD())) * VALUE(HEAD::template value<CARGO>());
+            }
+            Helper<TAIL...>::template weightedSum<CARGO>(accumulator, loader);
+        }
+    };
+
+    template<typename LAST>
+    class Helper<LAST>
+    {
+    public:
+        static const int RADIUS = LAST::RADIUS;
+        static const bool UNIFORM = true;
+
+        template<typename REFERENCE>
+        class AllEqual
+        {
+        public:
+            static const bool VALUE = LAST::template Equals<REFERENCE>::VALUE;
+        };
+
+        template<typename VALUE, typename LOADER>
+        static inline void sum(VALUE *accumulator, const LOADER& loader)
+        {
+            *accumulator += loader(LAST());
+        }
+
+        template<typename CARGO, typename VALUE, typename LOADER>
+        static inline void weightedSum(VALUE *accumulator, const LOADER& loader)
+        {
+            if (LAST::IS_ONE) {
+                *accumulator += loader(LAST());
+            } else {
+                *accumulator += VALUE(loader(LAST())) * VALUE(LAST::template value<CARGO>());
+            }
+        }
+    };
+
+    typedef Helper<WEIGHTS...> Weights;
+
+    template<typename HEAD, typename... TAIL>
+    class First
+    {
+    public:
+        typedef HEAD Value;
+    };
+
+    typedef typename First<WEIGHTS...>::Value FirstWeight;
+
+public:
+    static const int VOLUME = sizeof...(WEIGHTS);
+    static const int RADIUS = Weights::RADIUS;
+    static const bool UNIFORM = Weights::UNIFORM;
+
+    /**
+     * Evaluates the stencil for a single cell. This is suitable for
+     * update() of AoS cells, or any neighborhood whose operator[]
+     * returns cells when being passed FixedCoords.
+     */
+    template<typename NEIGHBORHOOD, typename CARGO, typename CELL>
+    static inline CARGO apply(const NEIGHBORHOOD& hood, CARGO CELL:: *member)
+    {
+        return evaluate<CARGO, CARGO>(ScalarLoader<NEIGHBORHOOD, CARGO, CELL>(hood, member));
+    }
+
+    /**
+     * Updates a streak of SoA cells, using the signature of
+     * updateLineX() for models with APITraits::HasSoA. All MEMBERS
+     * need to be of the same type as SHORT_VEC's cargo.
+     */
+    template<typename SHORT_VEC, typename HOOD_OLD, typename HOOD_NEW, typename... MEMBERS>
+    static void updateLineX(HOOD_OLD& hoodOld, long indexEnd, HOOD_NEW& hoodNew, MEMBERS... members)
+    {
+        static_assert(sizeof...(MEMBERS) > 0, "at least one member needs to be updated");
+
+        int offsets[] = { LibFlatArray::member_ptr_to_offset()(members)... };
+        int numMembers = sizeof...(MEMBERS);
+
+        // we peel with respect to the new grid as (streaming) stores
+        // need to be aligned, but keep the old grid's index in sync:
+        long indexEndNew = hoodNew.index() + indexEnd - hoodOld.index();
+        LIBFLATARRAY_LOOP_PEELER_TEMPLATE(
+            SHORT_VEC, long, hoodNew.index(), indexEndNew, updateLineSoA,
+            hoodOld, hoodNew, offsets, numMembers);
+    }
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+    /**
+     * Same as above, but chooses between streaming and cached stores
+     * at runtime. Old and new grid are both considered part of the
+     * working set.
+     */
+    template<typename CARGO, std::size_t ARITY, typename HOOD_OLD, typename HOOD_NEW, typename... MEMBERS>
+    static void updateLineXSwitch(HOOD_OLD& hoodOld, long indexEnd, HOOD_NEW& hoodNew, MEMBERS... members)
+    {
+        std::size_t workingSetSize = 2 * HOOD_NEW::DIM_PROD * sizeof(typename HOOD_NEW::element_type);
+
+        shortVecSwitch<CARGO, ARITY>(workingSetSize, [&](auto vec) {
+                updateLineX<decltype(vec)>(hoodOld, indexEnd, hoodNew, members...);
+            });
+    }
+#endif
+
+    /**
+     * Updates a streak of AoS cells, using the signature of
+     * updateLineX() for models without SoA. If the cell consists
+     * of just the one member, then it gets loaded and stored as
+     * SHORT_VEC. Otherwise we fall back to scalar code as neighbors
+     * are then non-contiguous in memory.
+     */
+    template<typename SHORT_VEC, typename CELL, typename NEIGHBORHOOD, typename CARGO, typename... MEMBERS>
+    static void updateLineX(
+        CELL *target,
+        long *x,
+        long endX,
+        const NEIGHBORHOOD& hood,
+        CARGO CELL:: *member,
+        MEMBERS... members)
+    {
+        if ((sizeof...(MEMBERS) == 0) && (sizeof(CELL) == sizeof(CARGO))) {
+            LIBFLATARRAY_LOOP_PEELER_TEMPLATE(
+                SHORT_VEC, long, *x, endX, updateLineAoS,
+                target, hood, member);
+            return;
+        }
+
+        for (; *x < endX; ++*x) {
+            updateCellAoS(target + *x, hood, member, members...);
+        }
+    }
+
+private:
+    template<typename SHORT_VEC>
+    class ShortVecCargo;
+
+    template<
+        template<typename CARGO_PARAM, std::size_t ARITY_PARAM> class SHORT_VEC_TEMPLATE,
+        typename CARGO,
+        std::size_t ARITY>
+    class ShortVecCargo<SHORT_VEC_TEMPLATE<CARGO, ARITY> >
+    {
+    public:
+        typedef CARGO Value;
+    };
+
+    /**
+     * Loads individual values from a neighborhood which yields
+     * cells, via the given member pointer.
+     */
+    template<typename NEIGHBORHOOD, typename CARGO, typename CELL>
+    class ScalarLoader
+    {
+    public:
+        inline ScalarLoader(const NEIGHBORHOOD& hood, CARGO CELL:: *member) :
+            hood(hood),
+            member(member)
+        {}
+
+        template<typename WEIGHT>
+        inline CARGO operator()(WEIGHT weight) const
+        {
+            return hood[weight].*member;
+        }
+
+    private:
+        const NEIGHBORHOOD& hood;
+        CARGO CELL:: *member;
+    };
+
+    /**
+     * Loads short vectors of consecutive AoS cells, which only
+     * works if the cells contain nothing but the given member.
+     */
+    template<typename SHORT_VEC, typename NEIGHBORHOOD, typename CARGO, typename CELL>
+    class AoSLoader
+    {
+    public:
+        inline AoSLoader(const NEIGHBORHOOD& hood, CARGO CELL:: *member) :
+            hood(hood),
+            member(member)
+        {}
+
+        template<typename WEIGHT>
+        inline SHORT_VEC operator()(WEIGHT weight) const
+        {
+            return SHORT_VEC(&(hood[weight].*member));
+        }
+
+    private:
+        const NEIGHBORHOOD& hood;
+        CARGO CELL:: *member;
+    };
+
+    /**
+     * Loads short vectors from a FixedNeighborhood, the member is
+     * identified by its offset within the SoA layout.
+     */
+    template<typename SHORT_VEC, typename CARGO, typename HOOD>
+    class SoALoader
+    {
+    public:
+        inline SoALoader(const HOOD& hood, int offset) :
+            hood(hood),
+            offset(offset)
+        {}
+
+        template<typename WEIGHT>
+        inline SHORT_VEC operator()(WEIGHT weight) const
+        {
+            // the accessor returned by operator[] is const, but
+            // access_member() isn't:
+            auto accessor = hood[weight];
+            return SHORT_VEC(reinterpret_cast<const CARGO*>(accessor.access_member(sizeof(CARGO), offset)));
+        }
+
+    private:
+        const HOOD& hood;
+        int offset;
+    };
+
+    template<typename CARGO, typename VALUE, typename LOADER>
+    static inline VALUE evaluate(const LOADER& loader)
+    {
+        VALUE accumulator(CARGO(0));
+
+        if (UNIFORM) {
+            Weights::sum(&accumulator, loader);
+            if (!FirstWeight::IS_ONE) {
+                accumulator *= VALUE(FirstWeight::template value<CARGO>());
+            }
+        } else {
+            Weights::template weightedSum<CARGO>(&accumulator, loader);
+        }
+
+        return accumulator;
+    }
+
+    template<typename SHORT_VEC, typename HOOD_OLD, typename HOOD_NEW>
+    static inline void updateLineSoA(
+        long& indexNew,
+        long indexEndNew,
+        HOOD_OLD& hoodOld,
+        HOOD_NEW& hoodNew,
+        const int *offsets,
+        int numMembers)
+    {
+        for (; indexNew < indexEndNew; indexNew += SHORT_VEC::ARITY, hoodOld.index() += SHORT_VEC::ARITY) {
+            for (int i = 0; i < numMembers; ++i) {
+                updateMemberSoA<SHORT_VEC>(hoodOld, hoodNew, offsets[i]);
+            }
+        }
+    }
+
+    template<typename SHORT_VEC, typename HOOD_OLD, typename HOOD_NEW>
+    static inline void updateMemberSoA(HOOD_OLD& hoodOld, HOOD_NEW& hoodNew, int offset)
+    {
+        typedef typename ShortVecCargo<SHORT_VEC>::Value CARGO;
+
+        SHORT_VEC result = evaluate<CARGO, SHORT_VEC>(SoALoader<SHORT_VEC, CARGO, HOOD_OLD>(hoodOld, offset));
+        result.store(reinterpret_cast<CARGO*>(hoodNew.access_member(sizeof(CARGO), offset)));
+    }
+
+    template<typename SHORT_VEC, typename CELL, typename NEIGHBORHOOD, typename CARGO>
+    static inline void updateLineAoS(
+        long& x,
+        long endX,
+        CELL *target,
+        const NEIGHBORHOOD& hood,
+        CARGO CELL:: *member)
+    {
+        for (; x < endX; x += SHORT_VEC::ARITY) {
+            SHORT_VEC result = evaluate<CARGO, SHORT_VEC>(
+                AoSLoader<SHORT_VEC, NEIGHBORHOOD, CARGO, CELL>(hood, member));
+            result.store(&(target[x].*member));
+        }
+    }
+
+    template<typename CELL, typename NEIGHBORHOOD>
+    static inline void updateCellAoS(CELL * /* cell */, const NEIGHBORHOOD& /* hood */)
+    {}
+
+    template<typename CELL, typename NEIGHBORHOOD, typename CARGO, typename... MEMBERS>
+    static inline void updateCellAoS(
+        CELL *cell,
+        const NEIGHBORHOOD& hood,
+        CARGO CELL:: *member,
+        MEMBERS... members)
+    {
+        cell->*member = apply(hood, member);
+        updateCellAoS(cell, hood, members...);
+    }
+};
+
+}
+
+#endif
@@ -1,10 +1,12 @@
 #ifndef LIBGEODECOMP_STORAGE_PATCHBUFFER_H
 #define LIBGEODECOMP_STORAGE_PATCHBUFFER_H
 
-#include <deque>
 #include <libgeodecomp/storage/patchaccepter.h>
 #include <libgeodecomp/storage/patchprovider.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace LibGeoDecomp {
 
 /**
@@ -13,6 +15,9 @@ namespace LibGeoDecomp {
  * implement overlapping communication and calculation (and hence need
  * to buffer certain parts of the grid which will be temporarily
  * overwritten).
+ *
+ * Buffers are recycled in a ring, so once the queue has reached its
+ * maximum length, put() and get() won't allocate any memory.
  */
 template<class GRID_TYPE1, class GRID_TYPE2>
 class PatchBuffer :
@@ -31,7 +36,9 @@ public:
     using PatchProvider<GRID_TYPE2>::storedNanoSteps;
 
     explicit PatchBuffer(const Region<DIM>& region = Region<DIM>()) :
-        region(region)
+        region(region),
+        indexRead(0),
+        numStored(0)
     {}
 
     virtual void put(
@@ -48,11 +55,17 @@ public:
             return;
         }
 
-        storedRegions.push_back(BufferType());
-        BufferType& buffer = storedRegions.back();
-        buffer = SerializationBuffer<CellType>::create(region);
+        if (numStored == buffers.size()) {
+            // the next slot needs to go behind the last stored buffer:
+            std::rotate(buffers.begin(), buffers.begin() + indexRead, buffers.end());
+            indexRead = 0;
+            buffers.push_back(SerializationBuffer<CellType>::create(region));
+        }
 
+        BufferType& buffer = buffers[(indexRead + numStored) % buffers.size()];
+        SerializationBuffer<CellType>::resize(&buffer, region);
         grid.saveRegion(&buffer, region);
+        ++numStored;
         storedNanoSteps << (min)(requestedNanoSteps);
         erase_min(requestedNanoSteps);
     }
@@ -66,14 +79,15 @@ public:
         const bool remove=true)
     {
         checkNanoStepGet(nanoStep);
-        if (storedRegions.empty()) {
+        if (numStored == 0) {
             throw std::logic_error("no region available");
         }
 
-        destinationGrid->loadRegion(storedRegions.front(), region);
+        destinationGrid->loadRegion(buffers[indexRead], region);
 
         if (remove) {
-            storedRegions.pop_front();
+            indexRead = (indexRead + 1) % buffers.size();
+            --numStored;
             erase_min(storedNanoSteps);
         }
 
@@ -81,7 +95,9 @@ public:
 
 private:
     Region<DIM> region;
-    std::deque<BufferType> storedRegions;
+    std::vector<BufferType> buffers;
+    std::size_t indexRead;
+    std::size_t numStored;
 };
 
 }
@@ -59,6 +59,17 @@ public:
         return viewBox;
     }
 
+    virtual void visit(const Region<DIM>& region, GridVisitor<CELL, DIM> *visitor)
+    {
+        delegate->visit(region, visitor);
+    }
+
+    virtual void visit(const Region<DIM>& region, ConstGridVisitor<CELL, DIM> *visitor) const
+    {
+        const GridBase<CELL, DIM> *constDelegate = delegate;
+        constDelegate->visit(region, visitor);
+    }
+
     void saveMemberImplementation(
         char *target,
         MemoryLocation::Location targetLocation,
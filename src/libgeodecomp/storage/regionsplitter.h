@@ -0,0 +1,270 @@
+#ifndef LIBGEODECOMP_STORAGE_REGIONSPLITTER_H
+#define LIBGEODECOMP_STORAGE_REGIONSPLITTER_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_THREADS
+
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/misc/workstealingpool.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Prepares a Region for being updated in parallel on a
+ * WorkStealingPool: its Streaks are flattened into an array (long
+ * Streaks are cut into pieces) so that tasks can recursively bisect
+ * index ranges -- preferably at plane boundaries -- without walking
+ * the Region again. Splitting continues until a range holds less
+ * than roughly a quarter thread's worth of cells.
+ *
+ * Setting up the array takes time linear in the number of Streaks,
+ * but Regions tend to recur in every time step, so get() caches a
+ * few instances per thread. Each entry holds a copy of its Region
+ * and the Streak array, hence the cache is kept small. Lookups
+ * compare a cheap fingerprint (bounding box, size, number of
+ * Streaks) first; only candidates which match it are compared
+ * Streak by Streak, which is still linear in the Region's size.
+ */
+template<int DIM>
+class RegionSplitter
+{
+public:
+    friend class RegionSplitterTest;
+
+    typedef typename SharedPtr<const RegionSplitter>::Type Ptr;
+
+    static const std::size_t CACHE_SIZE = 8;
+
+    /**
+     * Streaks longer than maxStreakLength will be cut into pieces,
+     * aligned to multiples of maxStreakLength. 0 lets us pick a
+     * length based on the workload per thread.
+     */
+    RegionSplitter(
+        const Region<DIM>& region,
+        std::size_t maxStreakLength,
+        std::size_t numThreads) :
+        region(region),
+        box(region.boundingBox()),
+        regionSize(region.size()),
+        maxStreakLength(maxStreakLength),
+        numThreads(numThreads)
+    {
+        std::size_t totalCells = region.size();
+        grain = (std::max)(std::size_t(1), totalCells / (4 * (std::max)(std::size_t(1), numThreads)));
+
+        // keep pieces SIMD-friendly:
+        std::size_t pieceLength = maxStreakLength;
+        if (pieceLength == 0) {
+            pieceLength = (grain + 63) / 64 * 64;
+        }
+
+        streaks.reserve(region.numStreaks());
+        cellsBefore.reserve(region.numStreaks() + 1);
+        cellsBefore.push_back(0);
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            Streak<DIM> s = *i;
+            if ((streaks.size() == 0) || (plane(s) != plane(streaks.back()))) {
+                planeStarts.push_back(streaks.size());
+            }
+
+            while (std::size_t(s.length()) > pieceLength) {
+                Streak<DIM> piece = s;
+                int offset = s.origin.x() % int(pieceLength);
+                if (offset < 0) {
+                    offset += pieceLength;
+                }
+                piece.endX = s.origin.x() + pieceLength - offset;
+                append(piece);
+                s.origin.x() = piece.endX;
+            }
+            append(s);
+        }
+        planeStarts.push_back(streaks.size());
+    }
+
+    /**
+     * Returns a cached instance if one matches, otherwise creates and
+     * caches a new one. The returned pointer stays valid even if the
+     * entry gets evicted by a nested call.
+     */
+    static Ptr get(
+        const Region<DIM>& region,
+        std::size_t maxStreakLength,
+        std::size_t numThreads)
+    {
+        static thread_local std::vector<Ptr> cache;
+
+        for (std::size_t i = 0; i < cache.size(); ++i) {
+            if (cache[i]->matches(region, maxStreakLength, numThreads)) {
+                Ptr ret = cache[i];
+                // most recently used entries go first:
+                std::rotate(cache.begin(), cache.begin() + i, cache.begin() + i + 1);
+                return ret;
+            }
+        }
+
+        Ptr ret(new RegionSplitter(region, maxStreakLength, numThreads));
+        cache.insert(cache.begin(), ret);
+        if (cache.size() > CACHE_SIZE) {
+            cache.pop_back();
+        }
+
+        return ret;
+    }
+
+    /**
+     * Calls functor(begin, end) with pointers to disjunct ranges of
+     * Streaks. Ranges are run as tasks on the pool, the calling
+     * thread takes part in their execution.
+     */
+    template<typename FUNCTOR>
+    void forEach(WorkStealingPool *pool, const FUNCTOR& functor) const
+    {
+        if (streaks.empty()) {
+            return;
+        }
+
+        forEachRange(pool, 0, streaks.size(), functor);
+    }
+
+    const std::vector<Streak<DIM> >& getStreaks() const
+    {
+        return streaks;
+    }
+
+    std::size_t grainSize() const
+    {
+        return grain;
+    }
+
+private:
+    Region<DIM> region;
+    CoordBox<DIM> box;
+    std::size_t regionSize;
+    std::size_t maxStreakLength;
+    std::size_t numThreads;
+    std::size_t grain;
+    std::vector<Streak<DIM> > streaks;
+    std::vector<std::size_t> cellsBefore;
+    std::vector<std::size_t> planeStarts;
+
+    static int plane(const Streak<DIM>& streak)
+    {
+        return (DIM > 1) ? streak.origin[DIM - 1] : 0;
+    }
+
+    void append(const Streak<DIM>& streak)
+    {
+        streaks.push_back(streak);
+        cellsBefore.push_back(cellsBefore.back() + streak.length());
+    }
+
+    bool matches(
+        const Region<DIM>& otherRegion,
+        std::size_t otherMaxStreakLength,
+        std::size_t otherNumThreads) const
+    {
+        return
+            (maxStreakLength == otherMaxStreakLength) &&
+            (numThreads == otherNumThreads) &&
+            (region.numStreaks() == otherRegion.numStreaks()) &&
+            (regionSize == otherRegion.size()) &&
+            (box == otherRegion.boundingBox()) &&
+            (region == otherRegion);
+    }
+
+    std::size_t cells(std::size_t begin, std::size_t end) const
+    {
+        return cellsBefore[end] - cellsBefore[begin];
+    }
+
+    /**
+     * Picks an index in (begin, end) which halves the workload. A
+     * nearby plane boundary is preferred if it doesn't skew the
+     * split by more than a quarter of the workload.
+     */
+    std::size_t splitPoint(std::size_t begin, std::size_t end) const
+    {
+        std::size_t target = (cellsBefore[begin] + cellsBefore[end]) / 2;
+        std::size_t middle = std::lower_bound(
+            cellsBefore.begin() + begin + 1,
+            cellsBefore.begin() + end,
+            target) - cellsBefore.begin();
+        if (middle == end) {
+            --middle;
+        }
+
+        std::size_t tolerance = cells(begin, end) / 4;
+        std::size_t bestPlane = middle;
+        std::size_t bestDelta = tolerance + 1;
+        std::vector<std::size_t>::const_iterator p =
+            std::lower_bound(planeStarts.begin(), planeStarts.end(), middle);
+
+        std::size_t candidates[2];
+        std::size_t numCandidates = 0;
+        if (p != planeStarts.end()) {
+            candidates[numCandidates++] = *p;
+        }
+        if (p != planeStarts.begin()) {
+            candidates[numCandidates++] = *(p - 1);
+        }
+
+        for (std::size_t i = 0; i < numCandidates; ++i) {
+            std::size_t candidate = candidates[i];
+            if ((candidate <= begin) || (candidate >= end)) {
+                continue;
+            }
+
+            std::size_t c = cellsBefore[candidate];
+            std::size_t delta = (c > target) ? (c - target) : (target - c);
+            if (delta < bestDelta) {
+                bestDelta = delta;
+                bestPlane = candidate;
+            }
+        }
+
+        return bestPlane;
+    }
+
+    template<typename FUNCTOR>
+    void forEachRange(
+        WorkStealingPool *pool,
+        std::size_t begin,
+        std::size_t end,
+        const FUNCTOR& functor) const
+    {
+        WorkStealingPool::TaskGroup group;
+
+        // lazy binary splitting: hand off the upper half, keep
+        // bisecting the lower one:
+        while (((end - begin) > 1) && (cells(begin, end) > grain)) {
+            std::size_t middle = splitPoint(begin, end);
+            pool->submit(&group, [this, pool, middle, end, &functor]() {
+                    forEachRange(pool, middle, end, functor);
+                });
+            end = middle;
+        }
+
+        try {
+            functor(&streaks[begin], &streaks[0] + end);
+        } catch (...) {
+            // tasks still reference our stack frame:
+            pool->wait(&group);
+            throw;
+        }
+
+        pool->wait(&group);
+    }
+};
+
+}
+
+#endif
+
+#endif
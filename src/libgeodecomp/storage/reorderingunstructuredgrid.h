@@ -5,6 +5,7 @@
 #ifdef LIBGEODECOMP_WITH_CPP14
 
 #include <algorithm>
+#include <atomic>
 #include <libgeodecomp/storage/serializationbuffer.h>
 #include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
 
@@ -108,6 +109,7 @@ class Selector<APITraits::TrueType>
 {
 public:
     typedef ReorderingRegionIterator<3> Value;
+    typedef Streak<3> StreakType;
 };
 
 /**
@@ -118,6 +120,7 @@ class Selector<APITraits::FalseType>
 {
 public:
     typedef ReorderingRegionIterator<1> Value;
+    typedef Streak<1> StreakType;
 };
 
 }
@@ -153,9 +156,13 @@ public:
     typedef typename DELEGATE_GRID::SparseMatrix SparseMatrix;
     typedef typename DELEGATE_GRID::StorageType StorageType;
     typedef typename DELEGATE_GRID::WeightType WeightType;
+    typedef typename DELEGATE_GRID::MatrixType MatrixType;
     typedef typename APITraits::SelectSoA<CellType>::Value SoAFlag;
     typedef typename SerializationBuffer<CellType>::BufferType BufferType;
+    typedef typename SerializationBuffer<CellType>::ElementType BufferElementType;
     typedef typename ReorderingUnstructuredGridHelpers::Selector<SoAFlag>::Value ReorderingRegionIterator;
+    typedef typename ReorderingUnstructuredGridHelpers::Selector<SoAFlag>::StreakType PhysicalStreak;
+    typedef std::vector<PhysicalStreak> PhysicalStreakVec;
 
     typedef std::pair<int, int> IntPair;
 
@@ -172,7 +179,8 @@ public:
         const CellType& defaultElement = CellType(),
         const CellType& edgeElement = CellType(),
         const Coord<1>& topologicalDimensions = Coord<1>()) :
-        nodeSet(nodeSet)
+        nodeSet(nodeSet),
+        layout(newLayoutID())
     {
         int physicalID = 0;
         physicalToLogicalIDs.reserve(nodeSet.size());
@@ -305,6 +313,35 @@ public:
         delegate.setWeights(matrixID, std::move(newMatrix));
     }
 
+    /**
+     * Installs a readily set up weights container on the delegate
+     * grid (see UnstructuredSoAGrid::setWeights()). Its rows and
+     * columns are physical IDs, i.e. positions within the node set,
+     * so no reordering takes place. Cells are moved back into node
+     * set order if a previous setWeights() had reordered them.
+     */
+    inline
+    void setWeights(std::size_t matrixID, const MatrixType& matrix)
+    {
+        if (!std::is_sorted(physicalToLogicalIDs.begin(), physicalToLogicalIDs.end())) {
+            std::vector<IntPair> newLogicalToPhysicalIDs;
+            std::vector<int> newPhysicalToLogicalIDs;
+            int physicalID = 0;
+
+            for (Region<1>::StreakIterator i = nodeSet.beginStreak(); i != nodeSet.endStreak(); ++i) {
+                for (int j = i->origin.x(); j != i->endX; ++j) {
+                    newLogicalToPhysicalIDs << std::make_pair(j, physicalID);
+                    newPhysicalToLogicalIDs << j;
+                    ++physicalID;
+                }
+            }
+
+            reorderDelegateGrid(std::move(newLogicalToPhysicalIDs), std::move(newPhysicalToLogicalIDs));
+        }
+
+        delegate.setWeights(matrixID, matrix);
+    }
+
     /**
      * The extent of this grid class is defined by its node set (given
      * in the c-tor) and the edge weights. Resize doesn't make sense
@@ -381,6 +418,70 @@ public:
             region.size());
     }
 
+    /**
+     * Translates a Region into Streaks of physical IDs, merging
+     * consecutive IDs. The result can be reused with saveStreaks()
+     * and loadStreaks() to save/load the Region repeatedly without
+     * having to look up each ID again. The order of the cells in the
+     * buffer is the same as with saveRegion()/loadRegion(). Remains
+     * valid as long as layoutID() doesn't change.
+     */
+    PhysicalStreakVec compileRegion(const Region<DIM>& region) const
+    {
+        PhysicalStreakVec ret;
+
+        for (Region<1>::Iterator i = region.begin(); i != region.end(); ++i) {
+            using ReorderingUnstructuredGridHelpers::mapLogicalToPhysicalID;
+            std::vector<IntPair>::const_iterator iter = mapLogicalToPhysicalID(i->x(), logicalToPhysicalIDs);
+
+            if (iter == logicalToPhysicalIDs.end()) {
+                throw std::logic_error("cannot compile Region -- Region needs to be a subset of nodeSet");
+            }
+
+            int physicalID = iter->second;
+            if (!ret.empty() && (ret.back().endX == physicalID)) {
+                ++ret.back().endX;
+                continue;
+            }
+
+            PhysicalStreak streak;
+            streak.origin.x() = physicalID;
+            streak.endX = physicalID + 1;
+            ret << streak;
+        }
+
+        return ret;
+    }
+
+    /**
+     * Identifies the mapping of logical to physical IDs: grids with
+     * equal layout IDs map all IDs identically (e.g. copies of each
+     * other), so results of compileRegion() may be shared among them.
+     * The ID changes whenever setWeights() reorders the grid.
+     */
+    std::size_t layoutID() const
+    {
+        return layout;
+    }
+
+    /**
+     * Equivalent to saveRegion(), but works on a precompiled Region
+     * (see compileRegion()) and writes to raw memory. This allows
+     * multiple Regions to be packed into a single buffer.
+     */
+    void saveStreaks(BufferElementType *target, const PhysicalStreakVec& streaks, std::size_t size) const
+    {
+        delegate.saveRegion(target, streaks.begin(), streaks.end(), size);
+    }
+
+    /**
+     * Counterpart to saveStreaks().
+     */
+    void loadStreaks(const BufferElementType *source, const PhysicalStreakVec& streaks, std::size_t size)
+    {
+        delegate.loadRegion(source, streaks.begin(), streaks.end(), size);
+    }
+
     /**
      * Convert coordinates from Region to the internal reordering of
      * the grid so they can be used directly by an UpdateFunctor.
@@ -436,13 +537,13 @@ public:
     }
 
     inline
-    const SellCSigmaSparseMatrixContainer<WeightType, C, SIGMA>& getWeights(const std::size_t matrixID) const
+    const MatrixType& getWeights(const std::size_t matrixID) const
     {
         return delegate.getWeights(matrixID);
     }
 
     inline
-    SellCSigmaSparseMatrixContainer<WeightType, C, SIGMA>& getWeights(const std::size_t matrixID)
+    MatrixType& getWeights(const std::size_t matrixID)
     {
         return delegate.getWeights(matrixID);
     }
@@ -452,6 +553,13 @@ private:
     Region<1> nodeSet;
     std::vector<IntPair> logicalToPhysicalIDs;
     std::vector<int> physicalToLogicalIDs;
+    std::size_t layout;
+
+    static std::size_t newLayoutID()
+    {
+        static std::atomic<std::size_t> counter(0);
+        return ++counter;
+    }
 
     /**
      * This operator is private as it gives access access to the
@@ -533,6 +641,7 @@ private:
 
         logicalToPhysicalIDs = std::move(newLogicalToPhysicalIDs);
         physicalToLogicalIDs = std::move(newPhysicalToLogicalIDs);
+        layout = newLayoutID();
     }
 
     inline
@@ -0,0 +1,246 @@
+#ifndef LIBGEODECOMP_STORAGE_SELLCSIGMADELTACOLUMNCONTAINER_H
+#define LIBGEODECOMP_STORAGE_SELLCSIGMADELTACOLUMNCONTAINER_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Variant of the SellCSigmaSparseMatrixContainer which stores column
+ * indices as 16 bit offsets relative to a per-chunk base column.
+ * This halves the index bandwidth of SpMV-like kernels on matrices
+ * with good locality (e.g. stencil-like unstructured meshes, or any
+ * mesh which has been reordered by a bandwidth reducing
+ * permutation). Columns are decoded chunk row by chunk row into the
+ * iterator's ScratchSpace, so kernels written against
+ * UnstructuredSoANeighborhood work unmodified.
+ *
+ * initFromMatrix() will throw if the column range within a single
+ * chunk exceeds 2^16.
+ */
+template<typename VALUETYPE, int C = 1, int SIGMA = 1>
+class SellCSigmaDeltaColumnContainer
+{
+public:
+    typedef std::vector<std::pair<Coord<2>, VALUETYPE> > SparseMatrix;
+    typedef std::uint16_t DeltaType;
+    using AlignedValueVector = std::vector<VALUETYPE, LibFlatArray::aligned_allocator<VALUETYPE, 64> >;
+    using AlignedDeltaVector = std::vector<DeltaType, LibFlatArray::aligned_allocator<DeltaType, 64> >;
+
+    /**
+     * Decoding buffer for one chunk row of column indices.
+     */
+    class ScratchSpace
+    {
+    public:
+        alignas(64) int columns[C];
+    };
+
+    explicit
+    SellCSigmaDeltaColumnContainer(const int N = 0) :
+        rowLength(N, 0),
+        chunkLength((N - 1) / C + 1, 0),
+        chunkOffset((N - 1) / C + 2, 0),
+        chunkBase((N - 1) / C + 1, 0),
+        dimension(N)
+    {}
+
+    /**
+     * Same semantics as SellCSigmaSparseMatrixContainer::getRow().
+     */
+    std::vector<std::pair<int, VALUETYPE> > getRow(int const row) const
+    {
+        std::vector<std::pair<int, VALUETYPE> > vec;
+        int const chunk(row / C);
+        int const offset(row % C);
+        int index = chunkOffset[chunk] + offset;
+
+        for (int element = 0; element < rowLength[row]; ++element, index += C) {
+            vec.push_back(std::make_pair(chunkBase[chunk] + int(columnDelta[index]), values[index]));
+        }
+
+        return vec;
+    }
+
+    void initFromMatrix(const SparseMatrix& matrix)
+    {
+        SellCSigmaSparseMatrixContainer<VALUETYPE, C, SIGMA> plain(dimension);
+        plain.initFromMatrix(matrix);
+
+        rowLength       = plain.rowLengthVec();
+        chunkLength     = plain.chunkLengthVec();
+        chunkOffset     = plain.chunkOffsetVec();
+        realRowToSorted = plain.realRowToSortedVec();
+        chunkRowToReal  = plain.chunkRowToRealVec();
+        values          = plain.valuesVec();
+
+        const std::size_t numberOfChunks = chunkLength.size();
+        const auto& column = plain.columnVec();
+        chunkBase.resize(numberOfChunks);
+        columnDelta.resize(column.size());
+
+        for (std::size_t chunk = 0; chunk < numberOfChunks; ++chunk) {
+            int minColumn = (std::numeric_limits<int>::max)();
+            int maxColumn = (std::numeric_limits<int>::min)();
+
+            forEachEntry(chunk, [&](int index, bool isPadding) {
+                    if (!isPadding) {
+                        minColumn = (std::min)(minColumn, column[index]);
+                        maxColumn = (std::max)(maxColumn, column[index]);
+                    }
+                });
+
+            if (minColumn > maxColumn) {
+                // chunk consists of empty rows only
+                minColumn = 0;
+                maxColumn = 0;
+            }
+
+            if ((long(maxColumn) - minColumn) > (std::numeric_limits<DeltaType>::max)()) {
+                throw std::logic_error("column range within chunk exceeds 16 bit offsets");
+            }
+
+            chunkBase[chunk] = minColumn;
+            forEachEntry(chunk, [&](int index, bool isPadding) {
+                    // padding entries carry a weight of 0, so we let
+                    // them point to the chunk's base column:
+                    columnDelta[index] = isPadding ? 0 : DeltaType(column[index] - minColumn);
+                });
+        }
+    }
+
+    /**
+     * Decodes the C column indices stored at the given offset of
+     * chunk into scratch.
+     */
+    inline
+    const int *columnChunk(int chunk, int offset, ScratchSpace *scratch) const
+    {
+        const int base = chunkBase[chunk];
+        const DeltaType *delta = &columnDelta[offset];
+        int *columns = scratch->columns;
+
+        for (int i = 0; i < C; ++i) {
+            columns[i] = base + delta[i];
+        }
+
+        return columns;
+    }
+
+    inline
+    const VALUETYPE *valueChunk(int /* chunk */, int offset, ScratchSpace * /* scratch */) const
+    {
+        return &values[offset];
+    }
+
+    inline
+    const int *columnEntry(int chunk, int offset, int lane, ScratchSpace *scratch) const
+    {
+        scratch->columns[lane] = chunkBase[chunk] + columnDelta[offset + lane];
+        return scratch->columns + lane;
+    }
+
+    inline
+    const VALUETYPE *valueEntry(int /* chunk */, int offset, int lane, ScratchSpace * /* scratch */) const
+    {
+        return &values[offset + lane];
+    }
+
+    inline bool operator==(const SellCSigmaDeltaColumnContainer& other) const
+    {
+        return ((dimension   == other.dimension)   &&
+                (values      == other.values)      &&
+                (columnDelta == other.columnDelta) &&
+                (chunkBase   == other.chunkBase)   &&
+                (chunkLength == other.chunkLength));
+    }
+
+    inline bool operator!=(const SellCSigmaDeltaColumnContainer& other) const
+    {
+        return !(*this == other);
+    }
+
+    inline const AlignedValueVector& valuesVec() const
+    {
+        return values;
+    }
+
+    inline const AlignedDeltaVector& columnDeltaVec() const
+    {
+        return columnDelta;
+    }
+
+    inline const std::vector<int>& chunkBaseVec() const
+    {
+        return chunkBase;
+    }
+
+    inline const std::vector<int>& rowLengthVec() const
+    {
+        return rowLength;
+    }
+
+    inline const std::vector<int>& chunkLengthVec() const
+    {
+        return chunkLength;
+    }
+
+    inline const std::vector<int>& chunkOffsetVec() const
+    {
+        return chunkOffset;
+    }
+
+    inline const std::vector<std::pair<int, int> >& realRowToSortedVec() const
+    {
+        return realRowToSorted;
+    }
+
+    inline const std::vector<int>& chunkRowToRealVec() const
+    {
+        return chunkRowToReal;
+    }
+
+    inline std::size_t dim() const
+    {
+        return dimension;
+    }
+
+private:
+    AlignedValueVector values;
+    AlignedDeltaVector columnDelta;
+    std::vector<int> rowLength;
+    std::vector<int> chunkLength;
+    std::vector<int> chunkOffset;
+    std::vector<int> chunkBase;       // minimum column referenced from within a chunk
+    std::vector<std::pair<int, int> > realRowToSorted;
+    std::vector<int> chunkRowToReal;
+    std::size_t dimension;
+
+    template<typename FUNCTOR>
+    void forEachEntry(std::size_t chunk, const FUNCTOR& functor) const
+    {
+        for (int element = 0; element < chunkLength[chunk]; ++element) {
+            for (int i = 0; i < C; ++i) {
+                int index = chunkOffset[chunk] + element * C + i;
+                bool isPadding = element >= rowLength[chunk * C + i];
+                functor(index, isPadding);
+            }
+        }
+    }
+};
+
+}
+
+#endif
+#endif
@@ -0,0 +1,223 @@
+#ifndef LIBGEODECOMP_STORAGE_SELLCSIGMADICTIONARYCONTAINER_H
+#define LIBGEODECOMP_STORAGE_SELLCSIGMADICTIONARYCONTAINER_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Variant of the SellCSigmaSparseMatrixContainer for matrices which
+ * contain only few distinct weights (e.g. discretizations of
+ * operators with constant coefficients or graph Laplacians). Each
+ * non-zero entry only stores a 16 bit index into a dictionary of
+ * values, which cuts the value bandwidth of SpMV-like kernels by 4x
+ * for doubles. Values are decoded chunk row by chunk row into the
+ * iterator's ScratchSpace, so kernels written against
+ * UnstructuredSoANeighborhood work unmodified.
+ *
+ * initFromMatrix() will throw if the matrix holds more than 2^16
+ * distinct values.
+ */
+template<typename VALUETYPE, int C = 1, int SIGMA = 1>
+class SellCSigmaDictionaryContainer
+{
+public:
+    typedef std::vector<std::pair<Coord<2>, VALUETYPE> > SparseMatrix;
+    typedef std::uint16_t KeyType;
+    using AlignedValueVector = std::vector<VALUETYPE, LibFlatArray::aligned_allocator<VALUETYPE, 64> >;
+    using AlignedIntVector   = std::vector<int, LibFlatArray::aligned_allocator<int, 64> >;
+    using AlignedKeyVector   = std::vector<KeyType, LibFlatArray::aligned_allocator<KeyType, 64> >;
+
+    /**
+     * Decoding buffer for one chunk row of weights.
+     */
+    class ScratchSpace
+    {
+    public:
+        alignas(64) VALUETYPE values[C];
+    };
+
+    explicit
+    SellCSigmaDictionaryContainer(const int N = 0) :
+        rowLength(N, 0),
+        chunkLength((N - 1) / C + 1, 0),
+        chunkOffset((N - 1) / C + 2, 0),
+        dimension(N)
+    {}
+
+    /**
+     * Same semantics as SellCSigmaSparseMatrixContainer::getRow().
+     */
+    std::vector<std::pair<int, VALUETYPE> > getRow(int const row) const
+    {
+        std::vector<std::pair<int, VALUETYPE> > vec;
+        int const chunk(row / C);
+        int const offset(row % C);
+        int index = chunkOffset[chunk] + offset;
+
+        for (int element = 0; element < rowLength[row]; ++element, index += C) {
+            vec.push_back(std::make_pair(column[index], dictionary[keys[index]]));
+        }
+
+        return vec;
+    }
+
+    void initFromMatrix(const SparseMatrix& matrix)
+    {
+        SellCSigmaSparseMatrixContainer<VALUETYPE, C, SIGMA> plain(dimension);
+        plain.initFromMatrix(matrix);
+
+        rowLength       = plain.rowLengthVec();
+        chunkLength     = plain.chunkLengthVec();
+        chunkOffset     = plain.chunkOffsetVec();
+        realRowToSorted = plain.realRowToSortedVec();
+        chunkRowToReal  = plain.chunkRowToRealVec();
+        column          = plain.columnVec();
+
+        const auto& values = plain.valuesVec();
+        std::map<VALUETYPE, KeyType> lookup;
+        dictionary.clear();
+        keys.resize(values.size());
+
+        // padding entries are 0, so make sure it's always the first key:
+        lookup[VALUETYPE()] = 0;
+        dictionary.push_back(VALUETYPE());
+
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            typename std::map<VALUETYPE, KeyType>::iterator iter = lookup.find(values[i]);
+            if (iter == lookup.end()) {
+                if (dictionary.size() > (std::numeric_limits<KeyType>::max)()) {
+                    throw std::logic_error("too many distinct values for dictionary compression");
+                }
+
+                iter = lookup.insert(std::make_pair(values[i], KeyType(dictionary.size()))).first;
+                dictionary.push_back(values[i]);
+            }
+
+            keys[i] = iter->second;
+        }
+    }
+
+    inline
+    const int *columnChunk(int /* chunk */, int offset, ScratchSpace * /* scratch */) const
+    {
+        return &column[offset];
+    }
+
+    /**
+     * Looks up the C weights stored at the given offset in the
+     * dictionary and stores them in scratch.
+     */
+    inline
+    const VALUETYPE *valueChunk(int /* chunk */, int offset, ScratchSpace *scratch) const
+    {
+        const KeyType *key = &keys[offset];
+        const VALUETYPE *dict = dictionary.data();
+        VALUETYPE *values = scratch->values;
+
+        for (int i = 0; i < C; ++i) {
+            values[i] = dict[key[i]];
+        }
+
+        return values;
+    }
+
+    inline
+    const int *columnEntry(int /* chunk */, int offset, int lane, ScratchSpace * /* scratch */) const
+    {
+        return &column[offset + lane];
+    }
+
+    inline
+    const VALUETYPE *valueEntry(int /* chunk */, int offset, int lane, ScratchSpace *scratch) const
+    {
+        scratch->values[lane] = dictionary[keys[offset + lane]];
+        return scratch->values + lane;
+    }
+
+    inline bool operator==(const SellCSigmaDictionaryContainer& other) const
+    {
+        return ((dimension   == other.dimension)  &&
+                (dictionary  == other.dictionary) &&
+                (keys        == other.keys)       &&
+                (column      == other.column)     &&
+                (chunkLength == other.chunkLength));
+    }
+
+    inline bool operator!=(const SellCSigmaDictionaryContainer& other) const
+    {
+        return !(*this == other);
+    }
+
+    inline const AlignedValueVector& dictionaryVec() const
+    {
+        return dictionary;
+    }
+
+    inline const AlignedKeyVector& keysVec() const
+    {
+        return keys;
+    }
+
+    inline const AlignedIntVector& columnVec() const
+    {
+        return column;
+    }
+
+    inline const std::vector<int>& rowLengthVec() const
+    {
+        return rowLength;
+    }
+
+    inline const std::vector<int>& chunkLengthVec() const
+    {
+        return chunkLength;
+    }
+
+    inline const std::vector<int>& chunkOffsetVec() const
+    {
+        return chunkOffset;
+    }
+
+    inline const std::vector<std::pair<int, int> >& realRowToSortedVec() const
+    {
+        return realRowToSorted;
+    }
+
+    inline const std::vector<int>& chunkRowToRealVec() const
+    {
+        return chunkRowToReal;
+    }
+
+    inline std::size_t dim() const
+    {
+        return dimension;
+    }
+
+private:
+    AlignedValueVector dictionary;
+    AlignedKeyVector keys;
+    AlignedIntVector column;
+    std::vector<int> rowLength;
+    std::vector<int> chunkLength;
+    std::vector<int> chunkOffset;
+    std::vector<std::pair<int, int> > realRowToSorted;
+    std::vector<int> chunkRowToReal;
+    std::size_t dimension;
+};
+
+}
+
+#endif
+#endif
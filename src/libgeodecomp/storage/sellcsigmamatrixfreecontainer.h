@@ -0,0 +1,267 @@
+#ifndef LIBGEODECOMP_STORAGE_SELLCSIGMAMATRIXFREECONTAINER_H
+#define LIBGEODECOMP_STORAGE_SELLCSIGMAMATRIXFREECONTAINER_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libgeodecomp/geometry/coord.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Stand-in for the SellCSigmaSparseMatrixContainer which doesn't
+ * store any weights at all. Instead columns and weights are computed
+ * on the fly by a user supplied FUNCTOR, which needs to provide the
+ * following interface:
+ *
+ *   int rowLength(int row) const;
+ *   void operator()(int row, int element, int *column, VALUETYPE *weight) const;
+ *
+ * rowLength() returns the number of non-zero entries in a row, the
+ * call operator yields the element-th of these. This is useful for
+ * stencil-like meshes where the matrix can be recomputed cheaper
+ * than it could be loaded from memory. Only the row lengths are
+ * cached. As rows are never reordered SIGMA is fixed at 1.
+ *
+ * Rows and columns are physical IDs. Within a
+ * ReorderingUnstructuredGrid these match the logical IDs iff its
+ * node set starts at 0 and is contiguous.
+ */
+template<typename VALUETYPE, int C, typename FUNCTOR>
+class SellCSigmaMatrixFreeContainer
+{
+public:
+    typedef std::vector<std::pair<Coord<2>, VALUETYPE> > SparseMatrix;
+
+    /**
+     * Decoding buffer for one chunk row of columns and weights. It
+     * remembers which entries it holds so that columnChunk() and
+     * valueChunk() for the same chunk row call the FUNCTOR only
+     * once.
+     */
+    class ScratchSpace
+    {
+    public:
+        ScratchSpace() :
+            offset(-1),
+            lane(-1)
+        {}
+
+        alignas(64) int columns[C];
+        alignas(64) VALUETYPE values[C];
+
+        int offset;
+        // C if the whole chunk row has been decoded:
+        int lane;
+    };
+
+    explicit
+    SellCSigmaMatrixFreeContainer(const int N = 0, const FUNCTOR& functor = FUNCTOR()) :
+        functor(functor),
+        rowLength(((N - 1) / C + 1) * C, 0),
+        chunkLength((N - 1) / C + 1, 0),
+        chunkOffset((N - 1) / C + 2, 0),
+        dimension(N)
+    {
+        for (int row = 0; row < N; ++row) {
+            rowLength[row] = functor.rowLength(row);
+        }
+
+        initChunks();
+    }
+
+    std::vector<std::pair<int, VALUETYPE> > getRow(int const row) const
+    {
+        std::vector<std::pair<int, VALUETYPE> > vec;
+
+        for (int element = 0; element < rowLength[row]; ++element) {
+            int column;
+            VALUETYPE weight;
+            functor(row, element, &column, &weight);
+            vec.push_back(std::make_pair(column, weight));
+        }
+
+        return vec;
+    }
+
+    /**
+     * The FUNCTOR defines the weights, so only the matrix' structure
+     * is taken into account: rows without entries are treated as
+     * empty (ReorderingUnstructuredGrid prunes rows with neighbors
+     * outside of its node set this way), all others need to have as
+     * many entries as the FUNCTOR yields. This allows Initializers
+     * to set up grids via setWeights() just like for any other
+     * container.
+     */
+    void initFromMatrix(const SparseMatrix& matrix)
+    {
+        std::vector<int> entries(rowLength.size(), 0);
+        for (typename SparseMatrix::const_iterator i = matrix.begin(); i != matrix.end(); ++i) {
+            int row = i->first.x();
+            if ((row < 0) || (row >= int(dimension))) {
+                throw std::invalid_argument("row ID in matrix is out of bounds");
+            }
+            ++entries[row];
+        }
+
+        for (std::size_t row = 0; row < dimension; ++row) {
+            if ((entries[row] != 0) && (entries[row] != functor.rowLength(row))) {
+                throw std::invalid_argument("matrix doesn't match the sparsity pattern of the functor");
+            }
+        }
+
+        rowLength = entries;
+        initChunks();
+    }
+
+    /**
+     * Returns the C column indices at the given offset of chunk.
+     * Calls the FUNCTOR only if the chunk row isn't already present
+     * in scratch, so a subsequent valueChunk() is cheap.
+     */
+    inline
+    const int *columnChunk(int chunk, int offset, ScratchSpace *scratch) const
+    {
+        fillChunk(chunk, offset, scratch);
+        return scratch->columns;
+    }
+
+    inline
+    const VALUETYPE *valueChunk(int chunk, int offset, ScratchSpace *scratch) const
+    {
+        fillChunk(chunk, offset, scratch);
+        return scratch->values;
+    }
+
+    /**
+     * Same as columnChunk(), but only the entry for lane is
+     * computed. Used for scalar iteration during loop peeling.
+     */
+    inline
+    const int *columnEntry(int chunk, int offset, int lane, ScratchSpace *scratch) const
+    {
+        fillEntry(chunk, offset, lane, scratch);
+        return scratch->columns + lane;
+    }
+
+    inline
+    const VALUETYPE *valueEntry(int chunk, int offset, int lane, ScratchSpace *scratch) const
+    {
+        fillEntry(chunk, offset, lane, scratch);
+        return scratch->values + lane;
+    }
+
+    inline bool operator==(const SellCSigmaMatrixFreeContainer& other) const
+    {
+        if (dimension != other.dimension) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < dimension; ++i) {
+            if (getRow(i) != other.getRow(i)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline bool operator!=(const SellCSigmaMatrixFreeContainer& other) const
+    {
+        return !(*this == other);
+    }
+
+    inline const std::vector<int>& rowLengthVec() const
+    {
+        return rowLength;
+    }
+
+    inline const std::vector<int>& chunkLengthVec() const
+    {
+        return chunkLength;
+    }
+
+    inline const std::vector<int>& chunkOffsetVec() const
+    {
+        return chunkOffset;
+    }
+
+    inline const FUNCTOR& getFunctor() const
+    {
+        return functor;
+    }
+
+    inline std::size_t dim() const
+    {
+        return dimension;
+    }
+
+private:
+    FUNCTOR functor;
+    std::vector<int> rowLength;
+    std::vector<int> chunkLength;
+    std::vector<int> chunkOffset;
+    std::size_t dimension;
+
+    void initChunks()
+    {
+        for (std::size_t chunk = 0; chunk < chunkLength.size(); ++chunk) {
+            chunkLength[chunk] = *std::max_element(
+                rowLength.begin() + chunk * C,
+                rowLength.begin() + (chunk + 1) * C);
+            chunkOffset[chunk + 1] = chunkOffset[chunk] + chunkLength[chunk] * C;
+        }
+    }
+
+    inline
+    void fillChunk(int chunk, int offset, ScratchSpace *scratch) const
+    {
+        if ((scratch->offset == offset) && (scratch->lane == C)) {
+            return;
+        }
+
+        for (int i = 0; i < C; ++i) {
+            decode(chunk, offset, i, scratch);
+        }
+
+        scratch->offset = offset;
+        scratch->lane = C;
+    }
+
+    inline
+    void fillEntry(int chunk, int offset, int lane, ScratchSpace *scratch) const
+    {
+        if ((scratch->offset == offset) && ((scratch->lane == lane) || (scratch->lane == C))) {
+            return;
+        }
+
+        decode(chunk, offset, lane, scratch);
+        scratch->offset = offset;
+        scratch->lane = lane;
+    }
+
+    inline
+    void decode(int chunk, int offset, int lane, ScratchSpace *scratch) const
+    {
+        const int element = (offset - chunkOffset[chunk]) / C;
+        const int row = chunk * C + lane;
+
+        if (element < rowLength[row]) {
+            functor(row, element, scratch->columns + lane, scratch->values + lane);
+        } else {
+            scratch->columns[lane] = 0;
+            scratch->values[lane] = VALUETYPE();
+        }
+    }
+};
+
+}
+
+#endif
+#endif
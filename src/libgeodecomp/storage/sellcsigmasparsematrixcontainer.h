@@ -180,6 +180,15 @@ public:
     friend SellHelpers::InitFromMatrix<VALUETYPE, C, SIGMA>;
     friend class ReorderingUnstructuredGridTest;
 
+    /**
+     * Compressed containers (e.g. SellCSigmaDeltaColumnContainer)
+     * decode chunk rows into a buffer which iterators provide via
+     * this type. We hand out pointers into our arrays directly and
+     * hence don't need one.
+     */
+    class ScratchSpace
+    {};
+
     explicit
     SellCSigmaSparseMatrixContainer(const int N = 0) :
         values(),
@@ -227,6 +236,47 @@ public:
         SellHelpers::InitFromMatrix<VALUETYPE, C, SIGMA>()(this, sortedMatrix);
     }
 
+    /**
+     * Returns a pointer to the C column indices of the chunk row
+     * starting at offset (see chunkOffsetVec()). This, along with
+     * valueChunk(), is the interface through which neighborhoods
+     * access the different storage backends.
+     */
+    inline
+    const int *columnChunk(int /* chunk */, int offset, ScratchSpace * /* scratch */) const
+    {
+        return &column[offset];
+    }
+
+    /**
+     * Same as columnChunk(), but for the matrix' values.
+     */
+    inline
+    const VALUETYPE *valueChunk(int /* chunk */, int offset, ScratchSpace * /* scratch */) const
+    {
+        return &values[offset];
+    }
+
+    /**
+     * Returns a pointer to a single entry (lane) of the chunk row
+     * starting at offset. Scalar iteration uses this to avoid
+     * decoding whole chunk rows in compressed containers.
+     */
+    inline
+    const int *columnEntry(int /* chunk */, int offset, int lane, ScratchSpace * /* scratch */) const
+    {
+        return &column[offset + lane];
+    }
+
+    /**
+     * Same as columnEntry(), but for the matrix' values.
+     */
+    inline
+    const VALUETYPE *valueEntry(int /* chunk */, int offset, int lane, ScratchSpace * /* scratch */) const
+    {
+        return &values[offset + lane];
+    }
+
     inline bool operator==(const SellCSigmaSparseMatrixContainer& other) const
     {
         return ((dimension   == other.dimension)  &&
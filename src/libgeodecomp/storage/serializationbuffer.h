@@ -13,7 +13,11 @@ namespace SerializationBufferHelpers {
  * appropriate type to buffer regions of a grid; for use with
  * GridBase::loadRegion() and saveRegion().
  */
-template<typename CELL, typename SUPPORTS_SOA = void, typename SUPPORTS_BOOST_SERIALIZATION = void>
+template<
+    typename CELL,
+    typename SUPPORTS_SOA = void,
+    typename SUPPORTS_BOOST_SERIALIZATION = void,
+    typename SUPPORTS_PACKING = void>
 class Implementation
 {
 public:
@@ -56,7 +60,7 @@ public:
  * see above
  */
 template<typename CELL>
-class Implementation<CELL, typename CELL::API::SupportsSoA, void>
+class Implementation<CELL, typename CELL::API::SupportsSoA, void, void>
 {
 public:
     typedef std::vector<char> BufferType;
@@ -94,6 +98,50 @@ public:
 #endif
 };
 
+/**
+ * Cells which pack themselves (see APITraits::HasPacking) vary in
+ * their serialized size, so buffers are sized for the worst case
+ * and saveRegion() shrinks them to the bytes actually used.
+ */
+template<typename CELL>
+class Implementation<CELL, void, void, typename CELL::API::SupportsPacking>
+{
+public:
+    typedef std::vector<char> BufferType;
+    typedef char ElementType;
+    typedef typename APITraits::FalseType FixedSize;
+
+    template<typename REGION>
+    static BufferType create(const REGION& region)
+    {
+        return BufferType(storageSize(region));
+    }
+
+    template<typename REGION>
+    static std::size_t storageSize(const REGION& region)
+    {
+        return CELL::maxPackedSize() * region.size();
+    }
+
+    template<typename REGION>
+    static void resize(BufferType *buffer, const REGION& region)
+    {
+        return buffer->resize(storageSize(region));
+    }
+
+    static ElementType *getData(BufferType& buffer)
+    {
+        return &buffer.front();
+    }
+
+#ifdef LIBGEODECOMP_WITH_MPI
+    static inline MPI_Datatype cellMPIDataType()
+    {
+        return MPI_CHAR;
+    }
+#endif
+};
+
 /**
  * see above
  */
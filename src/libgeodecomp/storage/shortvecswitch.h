@@ -0,0 +1,47 @@
+#ifndef LIBGEODECOMP_STORAGE_SHORTVECSWITCH_H
+#define LIBGEODECOMP_STORAGE_SHORTVECSWITCH_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libgeodecomp/misc/hardwaretopology.h>
+
+#include <libflatarray/short_vec.hpp>
+#include <libflatarray/streaming_short_vec.hpp>
+
+#include <cstddef>
+
+namespace LibGeoDecomp {
+
+/**
+ * Runtime counterpart to LibFlatArray::estimate_optimum_short_vec_type:
+ * calls lambda with either a streaming_short_vec (non-temporal
+ * stores) or a plain short_vec, depending on whether the working set
+ * (in bytes) exceeds the last level cache of the machine we're
+ * running on (see HardwareTopology). Both variants of the kernel are
+ * instantiated at compile time, so we don't need to guess the cache
+ * size of the target machine, e.g.:
+ *
+ *   shortVecSwitch<double, 8>(workingSetSize, [&](auto vec) {
+ *       typedef decltype(vec) ShortVec;
+ *       // ...
+ *   });
+ *
+ * Remember that streaming stores need to be aligned.
+ */
+template<typename CARGO, std::size_t ARITY, typename LAMBDA>
+inline
+void shortVecSwitch(std::size_t workingSetSize, const LAMBDA& lambda)
+{
+    if (HardwareTopology::local().useStreamingStores(workingSetSize)) {
+        lambda(LibFlatArray::streaming_short_vec<CARGO, ARITY>());
+    } else {
+        lambda(LibFlatArray::short_vec<CARGO, ARITY>());
+    }
+}
+
+}
+
+#endif
+
+#endif
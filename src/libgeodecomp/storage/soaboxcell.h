@@ -0,0 +1,377 @@
+#ifndef LIBGEODECOMP_STORAGE_SOABOXCELL_H
+#define LIBGEODECOMP_STORAGE_SOABOXCELL_H
+
+#include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/geometry/coordbox.h>
+#include <libgeodecomp/geometry/floatcoord.h>
+#include <libgeodecomp/geometry/stencils.h>
+#include <libgeodecomp/misc/apitraits.h>
+
+#include <libflatarray/soa_array.hpp>
+#include <cstring>
+
+namespace LibGeoDecomp {
+
+namespace SoABoxCellHelpers {
+
+/**
+ * Extracts the position of a particle from an SoA accessor. Particles
+ * are expected to store their coordinates in separate members posX,
+ * posY (and posZ in 3D), so that kernels can scan positions in
+ * contiguous arrays.
+ */
+template<int DIM>
+class Position;
+
+template<>
+class Position<1>
+{
+public:
+    template<typename ACCESSOR>
+    static inline FloatCoord<1> value(const ACCESSOR& particle)
+    {
+        return FloatCoord<1>(particle.posX());
+    }
+};
+
+template<>
+class Position<2>
+{
+public:
+    template<typename ACCESSOR>
+    static inline FloatCoord<2> value(const ACCESSOR& particle)
+    {
+        return FloatCoord<2>(particle.posX(), particle.posY());
+    }
+};
+
+template<>
+class Position<3>
+{
+public:
+    template<typename ACCESSOR>
+    static inline FloatCoord<3> value(const ACCESSOR& particle)
+    {
+        return FloatCoord<3>(particle.posX(), particle.posY(), particle.posZ());
+    }
+};
+
+}
+
+/**
+ * SoABoxCell is a structure-of-arrays (SoA) counterpart to BoxCell:
+ * it represents a fixed volume of the simulation space and stores the
+ * particles within in a LibFlatArray::soa_array, i.e. each member of
+ * the particles is held in a separate, contiguous array. This allows
+ * n-body and molecular dynamics (MD) kernels to vectorize over
+ * particles using LibFlatArray::short_vec.
+ *
+ * PARTICLE needs to be registered with LIBFLATARRAY_REGISTER_SOA()
+ * and must store its position in the members posX, posY (and posZ in
+ * 3D). Its API must not request an SoA grid (the cells themselves are
+ * stored in a regular grid). Instead of an update() per particle, it
+ * has to provide a static function which updates all particles of a
+ * box at once:
+ *
+ *   template<typename CONTAINER, typename NEIGHBORS>
+ *   static void updateBox(CONTAINER& particles, const NEIGHBORS& neighbors, int nanoStep);
+ *
+ * Here particles is the box' soa_array and neighbors yields the
+ * (read-only) containers of all boxes in the Moore neighborhood,
+ * including the box itself. Each container's members may be loaded
+ * into short_vecs directly, e.g. &neighbors[i][0].posX().
+ *
+ * SIZE is the maximum number of particles per box. The cell flags
+ * APITraits::HasPacking: grids serialize it via pack() and unpack(),
+ * so ghost zone updates (e.g. via PatchLink) only transmit the
+ * particles actually present instead of all SIZE slots.
+ */
+template<typename PARTICLE, int SIZE>
+class SoABoxCell
+{
+public:
+    friend class SoABoxCellTest;
+
+    typedef PARTICLE Cargo;
+    typedef PARTICLE value_type;
+    typedef LibFlatArray::soa_array<Cargo, SIZE> Container;
+    typedef typename APITraits::SelectTopology<Cargo>::Value Topology;
+
+    const static int DIM = Topology::DIM;
+    const static int NUM_NEIGHBORS = Stencils::Moore<DIM, 1>::VOLUME;
+
+    class API :
+        public APITraits::SelectAPI<Cargo>::Value,
+        public APITraits::HasStencil<Stencils::Moore<Topology::DIM, 1> >,
+        public APITraits::HasPacking
+    {};
+
+    /**
+     * Read-only view of the particle containers of all boxes
+     * surrounding a SoABoxCell, ordered like the coordinates in
+     * CoordBox<DIM>(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3)).
+     */
+    class Neighbors
+    {
+    public:
+        template<class HOOD>
+        explicit Neighbors(const HOOD& hood)
+        {
+            CoordBox<DIM> box(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3));
+            int index = 0;
+
+            for (typename CoordBox<DIM>::Iterator i = box.begin(); i != box.end(); ++i) {
+                containers[index++] = &hood[*i].particles;
+            }
+        }
+
+        inline std::size_t size() const
+        {
+            return NUM_NEIGHBORS;
+        }
+
+        inline const Container& operator[](const std::size_t i) const
+        {
+            return *containers[i];
+        }
+
+        /**
+         * The container of the box being updated, as of the previous
+         * time step.
+         */
+        inline const Container& self() const
+        {
+            return *containers[NUM_NEIGHBORS / 2];
+        }
+
+        /**
+         * Total number of particles in the neighborhood.
+         */
+        inline std::size_t numParticles() const
+        {
+            std::size_t ret = 0;
+            for (int i = 0; i < NUM_NEIGHBORS; ++i) {
+                ret += containers[i]->size();
+            }
+
+            return ret;
+        }
+
+    private:
+        const Container *containers[NUM_NEIGHBORS];
+    };
+
+    inline explicit SoABoxCell(
+        const FloatCoord<DIM>& origin = Coord<DIM>(),
+        const FloatCoord<DIM>& dimension = Coord<DIM>()) :
+        origin(origin),
+        dimension(dimension)
+    {}
+
+    inline void insert(const Cargo& particle)
+    {
+        particles << particle;
+    }
+
+    /**
+     * Removes the i-th particle in O(1) by moving the last particle
+     * into its slot. Hence particle order is not preserved.
+     */
+    inline void remove(const std::size_t i)
+    {
+        std::size_t last = particles.size() - 1;
+        if (i != last) {
+            particles[static_cast<int>(i)].copy_members(particles[static_cast<int>(last)], 1);
+        }
+
+        particles.pop_back();
+    }
+
+    inline std::size_t size() const
+    {
+        return particles.size();
+    }
+
+    inline
+    Cargo operator[](const std::size_t i) const
+    {
+        return particles[static_cast<int>(i)];
+    }
+
+    inline
+    SoABoxCell& operator<<(const Cargo& cargo)
+    {
+        particles << cargo;
+        return *this;
+    }
+
+    inline const Container& getParticles() const
+    {
+        return particles;
+    }
+
+    inline Container& getParticles()
+    {
+        return particles;
+    }
+
+    template<class HOOD>
+    inline void update(HOOD& hood, const int nanoStep)
+    {
+        Neighbors neighbors(hood);
+
+        copyOver(hood[Coord<DIM>()], neighbors, nanoStep);
+        updateCargo(neighbors, nanoStep);
+    }
+
+    /**
+     * On the first nano step particles are migrated: each box
+     * collects those particles from its neighbors which now reside
+     * within its bounds. Consecutive runs of such particles are
+     * copied per member in one go, which usually makes the box' own
+     * particles a single block copy.
+     */
+    inline void copyOver(
+        const SoABoxCell& oldSelf,
+        const Neighbors& neighbors,
+        int nanoStep)
+    {
+        origin    = oldSelf.origin;
+        dimension = oldSelf.dimension;
+
+        if (nanoStep == 0) {
+            particles.clear();
+            for (std::size_t i = 0; i < neighbors.size(); ++i) {
+                addContainedParticles(neighbors[i]);
+            }
+        } else {
+            particles = oldSelf.particles;
+        }
+    }
+
+    inline void updateCargo(
+        const Neighbors& neighbors,
+        int nanoStep)
+    {
+        Cargo::updateBox(particles, neighbors, nanoStep);
+    }
+
+    const FloatCoord<DIM>& getOrigin() const
+    {
+        return origin;
+    }
+
+    const FloatCoord<DIM>& getDimensions() const
+    {
+        return dimension;
+    }
+
+    /**
+     * Number of bytes required by pack().
+     */
+    inline std::size_t packedSize() const
+    {
+        return headerSize() + particles.byte_size();
+    }
+
+    /**
+     * Upper bound for packedSize(), i.e. for a full box.
+     */
+    static inline std::size_t maxPackedSize()
+    {
+        return headerSize() + Container::BYTE_SIZE;
+    }
+
+    /**
+     * Serializes the cell into target, which needs to hold at least
+     * packedSize() bytes. Unlike a plain copy of the cell, the
+     * encoding doesn't include unused particle slots.
+     */
+    inline void pack(char *target) const
+    {
+        std::size_t num = particles.size();
+
+        std::memcpy(target, &origin,    sizeof(origin));
+        target += sizeof(origin);
+        std::memcpy(target, &dimension, sizeof(dimension));
+        target += sizeof(dimension);
+        std::memcpy(target, &num,       sizeof(num));
+        target += sizeof(num);
+
+        if (num > 0) {
+            particles[0].save(target, num);
+        }
+    }
+
+    /**
+     * Restores a cell from a buffer previously filled by pack().
+     * Returns the number of bytes read.
+     */
+    inline std::size_t unpack(const char *source)
+    {
+        std::size_t num;
+
+        std::memcpy(&origin,    source, sizeof(origin));
+        source += sizeof(origin);
+        std::memcpy(&dimension, source, sizeof(dimension));
+        source += sizeof(dimension);
+        std::memcpy(&num,       source, sizeof(num));
+        source += sizeof(num);
+
+        particles.resize(num);
+        if (num > 0) {
+            particles[0].load(source, num);
+        }
+
+        return packedSize();
+    }
+
+protected:
+    FloatCoord<DIM> origin;
+    FloatCoord<DIM> dimension;
+    Container particles;
+
+    static inline std::size_t headerSize()
+    {
+        return sizeof(FloatCoord<DIM>) * 2 + sizeof(std::size_t);
+    }
+
+    inline void addContainedParticles(const Container& source)
+    {
+        FloatCoord<DIM> oppositeCorner = origin + dimension;
+        std::size_t runStart = 0;
+        std::size_t runLength = 0;
+
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            FloatCoord<DIM> pos = SoABoxCellHelpers::Position<DIM>::value(source[static_cast<int>(i)]);
+
+            if (origin.dominates(pos) && pos.strictlyDominates(oppositeCorner)) {
+                if (runLength == 0) {
+                    runStart = i;
+                }
+                ++runLength;
+                continue;
+            }
+
+            append(source, runStart, runLength);
+            runLength = 0;
+        }
+
+        append(source, runStart, runLength);
+    }
+
+    inline void append(const Container& source, std::size_t offset, std::size_t num)
+    {
+        if (num == 0) {
+            return;
+        }
+
+        std::size_t index = particles.size();
+        particles.resize(index + num);
+        particles[static_cast<int>(index)].load(source[0].data(), num, offset, SIZE);
+    }
+};
+
+}
+
+#endif
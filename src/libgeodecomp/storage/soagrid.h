@@ -149,6 +149,40 @@ public:
     }
 };
 
+/**
+ * Hands out SoAStreaks to a (Const)GridVisitor, see SoAGrid::visit().
+ */
+template<typename CELL, int DIM, typename VISITOR, typename CHAR>
+class VisitStreaks
+{
+public:
+    VisitStreaks(
+        VISITOR *visitor,
+        const Region<DIM>& region,
+        const Coord<DIM>& origin,
+        const Coord<3>& edgeRadii) :
+        visitor(visitor),
+        region(region),
+        origin(origin),
+        edgeRadii(edgeRadii)
+    {}
+
+    template<long DIM_X, long DIM_Y, long DIM_Z, long INDEX>
+    void operator()(LibFlatArray::soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX> accessor) const
+    {
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            long index = GenIndex<DIM_X, DIM_Y, DIM_Z>()(i->origin - origin, edgeRadii);
+            visitor->visit(*i, SoAStreak<CELL, CHAR>(accessor.data(), DIM_X * DIM_Y * DIM_Z, index));
+        }
+    }
+
+private:
+    VISITOR *visitor;
+    const Region<DIM>& region;
+    const Coord<DIM>& origin;
+    const Coord<3>& edgeRadii;
+};
+
 /**
  * Extract a single member variable from a SoA grid
  */
@@ -477,6 +511,40 @@ public:
         delegateGet(relativeCoord, cells, streak.length());
     }
 
+    /**
+     * Visitors which support SoA access are handed SoAStreaks which
+     * point directly into the grid. All other visitors receive
+     * copies of the cells. Either way all streaks need to lie within
+     * the grid's bounding box, extended by the edge radii
+     * (coordinates are not normalized as with
+     * TOPOLOGICALLY_CORRECT), or a std::logic_error is thrown.
+     */
+    virtual void visit(const Region<DIM>& region, GridVisitor<CELL, DIM> *visitor)
+    {
+        checkVisitBounds(region);
+        if (!visitor->supportsSoA()) {
+            GridBase<CELL, DIM>::visit(region, visitor);
+            return;
+        }
+
+        delegate.callback(
+            SoAGridHelpers::VisitStreaks<CELL, DIM, GridVisitor<CELL, DIM>, char>(
+                visitor, region, box.origin, edgeRadii));
+    }
+
+    virtual void visit(const Region<DIM>& region, ConstGridVisitor<CELL, DIM> *visitor) const
+    {
+        checkVisitBounds(region);
+        if (!visitor->supportsSoA()) {
+            GridBase<CELL, DIM>::visit(region, visitor);
+            return;
+        }
+
+        delegate.callback(
+            SoAGridHelpers::VisitStreaks<CELL, DIM, ConstGridVisitor<CELL, DIM>, const char>(
+                visitor, region, box.origin, edgeRadii));
+    }
+
     virtual void setEdge(const CELL& cell)
     {
         edgeCell = cell;
@@ -600,6 +668,26 @@ private:
     CELL edgeCell;
     CoordBox<DIM> box;
 
+    void checkVisitBounds(const Region<DIM>& region) const
+    {
+        if (region.empty()) {
+            return;
+        }
+
+        CoordBox<DIM> boundingBox = region.boundingBox();
+        for (int i = 0; i < DIM; ++i) {
+            int lower = box.origin[i] - edgeRadii[i];
+            int upper = box.origin[i] + box.dimensions[i] + edgeRadii[i];
+            if ((boundingBox.origin[i] < lower) ||
+                ((boundingBox.origin[i] + boundingBox.dimensions[i]) > upper)) {
+                throw std::logic_error(
+                    "region to visit " + boundingBox.toString() +
+                    " exceeds grid bounds " + box.toString() +
+                    " plus edge radii " + edgeRadii.toString());
+            }
+        }
+    }
+
     CELL delegateGet(const Coord<1>& coord) const
     {
         return delegate.get(
@@ -0,0 +1,115 @@
+#include <libgeodecomp/storage/activeregiontracker.h>
+#include <libgeodecomp/storage/grid.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+template<typename TOPOLOGY>
+class ActiveRegionTestCell
+{
+public:
+    class API :
+        public APITraits::HasActiveRegion,
+        public APITraits::HasTopology<TOPOLOGY>
+    {};
+
+    explicit ActiveRegionTestCell(int value = 0) :
+        value(value)
+    {}
+
+    bool reachedFixedPoint(const ActiveRegionTestCell& previousState) const
+    {
+        return value == previousState.value;
+    }
+
+    int value;
+};
+
+class ActiveRegionTrackerTest : public CxxTest::TestSuite
+{
+public:
+    typedef ActiveRegionTestCell<Topologies::Cube<2>::Topology> CubeCell;
+    typedef ActiveRegionTestCell<Topologies::Torus<2>::Topology> TorusCell;
+
+    void testInactiveTrackerReportsWholeSimArea()
+    {
+        Region<2> simArea;
+        simArea << CoordBox<2>(Coord<2>(), Coord<2>(20, 10));
+
+        ActiveRegionTracker<TestCellHelper> tracker;
+        tracker.reset(simArea, Coord<2>(20, 10));
+        TS_ASSERT_EQUALS(simArea, tracker.activeRegion());
+    }
+
+    void testUpdate()
+    {
+        Coord<2> dim(20, 10);
+        Region<2> simArea;
+        simArea << CoordBox<2>(Coord<2>(), dim);
+
+        ActiveRegionTracker<CubeCell> tracker;
+        tracker.reset(simArea, dim);
+        TS_ASSERT_EQUALS(simArea, tracker.activeRegion());
+
+        Grid<CubeCell, Topologies::Cube<2>::Topology> oldGrid(dim);
+        Grid<CubeCell, Topologies::Cube<2>::Topology> newGrid(dim);
+        newGrid[Coord<2>(5, 5)].value = 1;
+        newGrid[Coord<2>(6, 5)].value = 1;
+        newGrid[Coord<2>(0, 0)].value = 1;
+
+        tracker.update(oldGrid, newGrid);
+        Region<2> expected;
+        expected << CoordBox<2>(Coord<2>(4, 4), Coord<2>(4, 3))
+                 << CoordBox<2>(Coord<2>(0, 0), Coord<2>(2, 2));
+        TS_ASSERT_EQUALS(expected, tracker.activeRegion());
+
+        // only cells within the active region are being checked:
+        newGrid[Coord<2>(15, 5)].value = 1;
+        oldGrid = newGrid;
+        oldGrid[Coord<2>(5, 4)].value = 1;
+        tracker.update(oldGrid, newGrid);
+        expected.clear();
+        expected << CoordBox<2>(Coord<2>(4, 3), Coord<2>(3, 3));
+        TS_ASSERT_EQUALS(expected, tracker.activeRegion());
+
+        tracker.invalidate();
+        TS_ASSERT_EQUALS(simArea, tracker.activeRegion());
+
+        oldGrid = newGrid;
+        tracker.update(oldGrid, newGrid);
+        TS_ASSERT(tracker.activeRegion().empty());
+    }
+
+    void testUpdateWrapsAroundTorus()
+    {
+        Coord<2> dim(20, 10);
+        Region<2> simArea;
+        simArea << CoordBox<2>(Coord<2>(), dim);
+
+        ActiveRegionTracker<TorusCell> tracker;
+        tracker.reset(simArea, dim);
+
+        Grid<TorusCell, Topologies::Torus<2>::Topology> oldGrid(dim);
+        Grid<TorusCell, Topologies::Torus<2>::Topology> newGrid(dim);
+        newGrid[Coord<2>(0, 0)].value = 1;
+
+        tracker.update(oldGrid, newGrid);
+        TS_ASSERT_EQUALS(9, int(tracker.activeRegion().size()));
+        TS_ASSERT(tracker.activeRegion().count(Coord<2>(19, 9)));
+        TS_ASSERT(tracker.activeRegion().count(Coord<2>( 1, 9)));
+        TS_ASSERT(tracker.activeRegion().count(Coord<2>(19, 1)));
+    }
+
+private:
+    class TestCellHelper
+    {
+    public:
+        class API : public APITraits::HasCubeTopology<2>
+        {};
+    };
+};
+
+}
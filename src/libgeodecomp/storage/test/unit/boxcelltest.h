@@ -3,6 +3,7 @@
 #include <libgeodecomp/storage/grid.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 #include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/misc/random.h>
 #include <cxxtest/TestSuite.h>
 
 using namespace LibGeoDecomp;
@@ -103,6 +104,75 @@ private:
     int numParticlesToBeSpawned;
 };
 
+template<bool VERLET>
+class MovingParticleAPI : public APITraits::HasCubeTopology<2>
+{};
+
+template<>
+class MovingParticleAPI<true> :
+        public APITraits::HasCubeTopology<2>,
+        public APITraits::HasVerletList
+{
+public:
+    static double verletCutoff()
+    {
+        return 2.0;
+    }
+
+    static double verletSkin()
+    {
+        return 0.5;
+    }
+};
+
+/**
+ * Drifts with a constant velocity and counts its neighbors within
+ * the Verlet cutoff. VERLET toggles the use of Verlet lists, so
+ * both variants should yield identical results.
+ */
+template<bool VERLET>
+class MovingParticle
+{
+public:
+    typedef MovingParticleAPI<VERLET> API;
+
+    explicit MovingParticle(
+        const FloatCoord<2>& pos = FloatCoord<2>(),
+        const FloatCoord<2>& vel = FloatCoord<2>(),
+        const int id = 0) :
+        pos(pos),
+        vel(vel),
+        id(id),
+        neighbors(0)
+    {}
+
+    template<typename HOOD>
+    inline void update(const HOOD& hood, const int /* nanoStep */)
+    {
+        double cutoff2 = MovingParticleAPI<true>::verletCutoff() * MovingParticleAPI<true>::verletCutoff();
+        neighbors = 0;
+
+        for (typename HOOD::Iterator i = hood.begin(); i != hood.end(); ++i) {
+            FloatCoord<2> delta = i->pos - pos;
+            if ((delta * delta) < cutoff2) {
+                ++neighbors;
+            }
+        }
+
+        pos += vel;
+    }
+
+    inline const FloatCoord<2>& getPos() const
+    {
+        return pos;
+    }
+
+    FloatCoord<2> pos;
+    FloatCoord<2> vel;
+    int id;
+    int neighbors;
+};
+
 class BoxCellTest : public CxxTest::TestSuite
 {
 public:
@@ -409,6 +479,73 @@ public:
         TS_ASSERT_EQUALS(cell.size(), 0);
     }
 
+    void testVerletListMatchesLinkedCells()
+    {
+        typedef BoxCell<FixedArray<MovingParticle<false>, 40> > PlainCell;
+        typedef BoxCell<FixedArray<MovingParticle<true>,  40> > VerletCell;
+
+        Coord<2> gridDim(8, 8);
+        FloatCoord<2> cellDim(3.0, 3.0);
+        CoordBox<2> box(Coord<2>(), gridDim);
+        Region<2> region;
+        region << box;
+
+        Grid<PlainCell>  plainGrids[2]  = {Grid<PlainCell>(gridDim),  Grid<PlainCell>(gridDim)};
+        Grid<VerletCell> verletGrids[2] = {Grid<VerletCell>(gridDim), Grid<VerletCell>(gridDim)};
+
+        Random::seed(4711);
+        int id = 0;
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            FloatCoord<2> origin = cellDim.scale(*i);
+            PlainCell plainCell(origin, cellDim);
+            VerletCell verletCell(origin, cellDim);
+
+            for (int j = 0; j < 8; ++j) {
+                FloatCoord<2> pos = origin + FloatCoord<2>(Random::genDouble(3.0), Random::genDouble(3.0));
+                FloatCoord<2> vel(Random::genDouble(0.04) - 0.02, Random::genDouble(0.04) - 0.02);
+                plainCell.insert(MovingParticle<false>(pos, vel, id));
+                verletCell.insert(MovingParticle<true>(pos, vel, id));
+                ++id;
+            }
+
+            plainGrids[0][*i] = plainCell;
+            verletGrids[0][*i] = verletCell;
+        }
+
+        for (int t = 0; t < 30; ++t) {
+            int source = t % 2;
+            int target = 1 - source;
+
+            UpdateFunctor<PlainCell>()(region, Coord<2>(), Coord<2>(), plainGrids[source], &plainGrids[target], 0);
+            UpdateFunctor<VerletCell>()(region, Coord<2>(), Coord<2>(), verletGrids[source], &verletGrids[target], 0);
+
+            for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+                const PlainCell& plainCell = plainGrids[target][*i];
+                const VerletCell& verletCell = verletGrids[target][*i];
+                TS_ASSERT_EQUALS(plainCell.size(), verletCell.size());
+
+                for (std::size_t j = 0; j < plainCell.size(); ++j) {
+                    TS_ASSERT_EQUALS(plainCell[j].id,        verletCell[j].id);
+                    TS_ASSERT_EQUALS(plainCell[j].neighbors, verletCell[j].neighbors);
+                }
+            }
+        }
+
+        // the Verlet list has to be shorter than the Moore neighborhood:
+        const VerletCell& cell = verletGrids[0][Coord<2>(4, 4)];
+        TS_ASSERT(cell.verletList.isValid());
+        TS_ASSERT(cell.verletList.size() < (cell.size() * 9 * 8));
+
+        // updates must leave the source grid untouched, so updating
+        // from it again yields the same result:
+        std::size_t oldSize = verletGrids[1][Coord<2>(4, 4)].verletList.size();
+        std::size_t newSize = cell.verletList.size();
+        UpdateFunctor<VerletCell>()(region, Coord<2>(), Coord<2>(), verletGrids[1], &verletGrids[0], 0);
+        TS_ASSERT_EQUALS(oldSize, verletGrids[1][Coord<2>(4, 4)].verletList.size());
+        TS_ASSERT(verletGrids[1][Coord<2>(4, 4)].verletList.isValid());
+        TS_ASSERT_EQUALS(newSize, cell.verletList.size());
+    }
+
 private:
     Coord<2> gridDim;
     FloatCoord<2> cellDim;
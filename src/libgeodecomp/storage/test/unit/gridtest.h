@@ -202,6 +202,26 @@ public:
         TS_ASSERT_EQUALS(Coord<2>(64, 20), g.getDimensions());
         g.resize(Coord<2>(12, 34));
         TS_ASSERT_EQUALS(Coord<2>(12, 34), g.getDimensions());
+
+        // new cells are still value-initialized:
+        g.resize(Coord<2>(100, 40));
+        TS_ASSERT_EQUALS(Grid<int>(Coord<2>(100, 40), 0), g);
+    }
+
+    void testParallelFill()
+    {
+        // large enough to be filled by all threads:
+        Coord<3> dim(128, 64, 40);
+        Grid<double, Topologies::Cube<3>::Topology> grid(dim, 4.5, -1);
+        TS_ASSERT(dim.prod() * sizeof(double) >= Grid<double>::PARALLEL_FILL_THRESHOLD);
+
+        CoordBox<3> box = grid.boundingBox();
+        std::size_t mismatches = 0;
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            mismatches += (grid.get(*i) != 4.5);
+        }
+        TS_ASSERT_EQUALS(std::size_t(0), mismatches);
+        TS_ASSERT_EQUALS(-1, grid.getEdge());
     }
 
     void testGetNeighborhood()
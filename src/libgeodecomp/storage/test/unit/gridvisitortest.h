@@ -0,0 +1,303 @@
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+#include <libgeodecomp/storage/grid.h>
+#include <libgeodecomp/storage/gridvisitor.h>
+#include <libgeodecomp/storage/proxygrid.h>
+#include <libgeodecomp/storage/soagrid.h>
+#include <libgeodecomp/storage/unstructuredgrid.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+/**
+ * Records all streaks and the location of the cells it has been
+ * handed and scales each cell's testValue.
+ */
+template<typename CELL, int DIM>
+class ScalingVisitor : public GridVisitor<CELL, DIM>
+{
+public:
+    ScalingVisitor() :
+        soaStreaks(0)
+    {}
+
+    virtual void visit(const Streak<DIM>& streak, CELL *cells)
+    {
+        streaks << streak;
+        pointers << cells;
+
+        for (int i = 0; i < streak.length(); ++i) {
+            cells[i].testValue *= 2;
+        }
+    }
+
+    std::vector<Streak<DIM> > streaks;
+    std::vector<CELL*> pointers;
+    int soaStreaks;
+};
+
+template<typename CELL, int DIM>
+class SoAScalingVisitor : public ScalingVisitor<CELL, DIM>
+{
+public:
+    using ScalingVisitor<CELL, DIM>::visit;
+
+    virtual bool supportsSoA() const
+    {
+        return true;
+    }
+
+    virtual void visit(const Streak<DIM>& streak, const SoAStreak<CELL>& cells)
+    {
+        ++this->soaStreaks;
+        double *testValues = cells.member(&CELL::testValue);
+
+        for (int i = 0; i < streak.length(); ++i) {
+            testValues[i] *= 2;
+        }
+    }
+};
+
+template<typename CELL, int DIM>
+class SummingVisitor : public ConstGridVisitor<CELL, DIM>
+{
+public:
+    SummingVisitor() :
+        sum(0),
+        cells(0)
+    {}
+
+    virtual void visit(const Streak<DIM>& streak, const CELL *cells)
+    {
+        for (int i = 0; i < streak.length(); ++i) {
+            sum += cells[i].testValue;
+        }
+        this->cells += streak.length();
+    }
+
+    double sum;
+    int cells;
+};
+
+class GridVisitorTest : public CxxTest::TestSuite
+{
+public:
+    typedef TestCell<2> TestCellType;
+
+    void setUp()
+    {
+        region.clear();
+        region << Streak<2>(Coord<2>(12, 21), 20)
+               << Streak<2>(Coord<2>(15, 22), 18)
+               << Streak<2>(Coord<2>(10, 23), 30);
+    }
+
+    void testGrid()
+    {
+        Grid<TestCellType> grid(Coord<2>(30, 40));
+        initGrid(&grid, CoordBox<2>(Coord<2>(), Coord<2>(30, 40)));
+
+        ScalingVisitor<TestCellType, 2> visitor;
+        grid.visit(region, &visitor);
+
+        // cells are handed out in place:
+        TS_ASSERT_EQUALS(std::size_t(3), visitor.pointers.size());
+        TS_ASSERT_EQUALS(&grid[Coord<2>(12, 21)], visitor.pointers[0]);
+        TS_ASSERT_EQUALS(&grid[Coord<2>(15, 22)], visitor.pointers[1]);
+        TS_ASSERT_EQUALS(&grid[Coord<2>(10, 23)], visitor.pointers[2]);
+        checkScaled(grid, CoordBox<2>(Coord<2>(), Coord<2>(30, 40)));
+
+        SummingVisitor<TestCellType, 2> summer;
+        const Grid<TestCellType>& constGrid = grid;
+        constGrid.visit(region, &summer);
+        TS_ASSERT_EQUALS(31, summer.cells);
+    }
+
+    void testDisplacedGrid()
+    {
+        CoordBox<2> box(Coord<2>(10, 20), Coord<2>(25, 10));
+        DisplacedGrid<TestCellType> grid(box);
+        initGrid(&grid, box);
+
+        ScalingVisitor<TestCellType, 2> visitor;
+        grid.visit(region, &visitor);
+
+        TS_ASSERT_EQUALS(&grid[Coord<2>(12, 21)], visitor.pointers[0]);
+        TS_ASSERT_EQUALS(&grid[Coord<2>(15, 22)], visitor.pointers[1]);
+        TS_ASSERT_EQUALS(&grid[Coord<2>(10, 23)], visitor.pointers[2]);
+        checkScaled(grid, box);
+    }
+
+    void testDisplacedGridWrapsAround()
+    {
+        typedef DisplacedGrid<TestCellType, Topologies::Torus<2>::Topology, true> GridType;
+        CoordBox<2> box(Coord<2>(), Coord<2>(20, 10));
+        GridType grid(box, TestCellType(), TestCellType(), box.dimensions);
+        initGrid(&grid, box);
+
+        Region<2> wrapping;
+        wrapping << Streak<2>(Coord<2>(15, 3), 25)
+                 << Streak<2>(Coord<2>(7, 13), 12);
+
+        ScalingVisitor<TestCellType, 2> visitor;
+        grid.visit(wrapping, &visitor);
+
+        // the first Streak wraps around and hence needs to be copied,
+        // the second one is stored consecutively (albeit shifted by
+        // the torus):
+        TS_ASSERT_DIFFERS(&grid[Coord<2>(15, 3)], visitor.pointers[0]);
+        TS_ASSERT_EQUALS(Streak<2>(Coord<2>(15, 3), 25), visitor.streaks[0]);
+        TS_ASSERT_EQUALS(&grid[Coord<2>(7, 3)], visitor.pointers[1]);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            double expected = i->x() + 100 * i->y();
+            if ((i->y() == 3) && ((i->x() < 5) || ((i->x() >= 7) && (i->x() < 12)) || (i->x() >= 15))) {
+                expected *= 2;
+            }
+            TS_ASSERT_EQUALS(expected, grid[*i].testValue);
+        }
+    }
+
+    void testProxyGrid()
+    {
+        CoordBox<2> box(Coord<2>(10, 20), Coord<2>(25, 10));
+        DisplacedGrid<TestCellType> grid(box);
+        initGrid(&grid, box);
+        ProxyGrid<TestCellType, 2> proxy(&grid, box);
+
+        ScalingVisitor<TestCellType, 2> visitor;
+        proxy.visit(region, &visitor);
+
+        TS_ASSERT_EQUALS(&grid[Coord<2>(12, 21)], visitor.pointers[0]);
+        checkScaled(grid, box);
+    }
+
+    void testSoAGrid()
+    {
+        CoordBox<3> box(Coord<3>(10, 20, 30), Coord<3>(25, 10, 5));
+        SoAGrid<TestCellSoA, Topologies::Cube<3>::Topology> grid(box);
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TestCellSoA cell = grid.get(*i);
+            cell.testValue = i->x() + 100 * i->y();
+            grid.set(*i, cell);
+        }
+
+        Region<3> region3;
+        region3 << Streak<3>(Coord<3>(12, 21, 31), 20)
+                << Streak<3>(Coord<3>(15, 22, 33), 35);
+
+        // AoS visitors receive copies...
+        ScalingVisitor<TestCellSoA, 3> aosVisitor;
+        grid.visit(region3, &aosVisitor);
+        TS_ASSERT_EQUALS(2, int(aosVisitor.streaks.size()));
+        TS_ASSERT_EQUALS(0, aosVisitor.soaStreaks);
+
+        // ...while others access the SoA layout directly:
+        SoAScalingVisitor<TestCellSoA, 3> soaVisitor;
+        grid.visit(region3, &soaVisitor);
+        TS_ASSERT_EQUALS(0, int(soaVisitor.streaks.size()));
+        TS_ASSERT_EQUALS(2, soaVisitor.soaStreaks);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            double expected = i->x() + 100 * i->y();
+            if (region3.count(*i)) {
+                expected *= 4;
+            }
+            TS_ASSERT_EQUALS(expected, grid.get(*i).testValue);
+        }
+    }
+
+    void testSoAGridRejectsRegionsOutOfBounds()
+    {
+        CoordBox<3> box(Coord<3>(10, 20, 30), Coord<3>(25, 10, 5));
+        SoAGrid<TestCellSoA, Topologies::Cube<3>::Topology> grid(box);
+
+        Region<3> region3;
+        region3 << Streak<3>(Coord<3>(0, 21, 31), 20);
+        SoAScalingVisitor<TestCellSoA, 3> visitor;
+        TS_ASSERT_THROWS(grid.visit(region3, &visitor), std::logic_error&);
+        TS_ASSERT_EQUALS(0, visitor.soaStreaks);
+
+        region3.clear();
+        region3 << Streak<3>(Coord<3>(12, 21, 60), 20);
+        SummingVisitor<TestCellSoA, 3> constVisitor;
+        const SoAGrid<TestCellSoA, Topologies::Cube<3>::Topology>& constGrid = grid;
+        TS_ASSERT_THROWS(constGrid.visit(region3, &constVisitor), std::logic_error&);
+    }
+
+    void testUnstructuredGrid()
+    {
+        typedef TestCell<1> TestCellType1D;
+        UnstructuredGrid<TestCellType1D> grid(CoordBox<1>(Coord<1>(10), Coord<1>(20)));
+        for (int i = 10; i < 30; ++i) {
+            TestCellType1D cell;
+            cell.testValue = i;
+            grid.set(Coord<1>(i), cell);
+        }
+
+        Region<1> region1;
+        region1 << Streak<1>(Coord<1>(12), 20)
+                << Streak<1>(Coord<1>(25), 35);
+
+        ScalingVisitor<TestCellType1D, 1> visitor;
+        grid.visit(region1, &visitor);
+        TS_ASSERT_EQUALS(&grid[12], visitor.pointers[0]);
+
+        for (int i = 10; i < 30; ++i) {
+            double expected = i;
+            if (region1.count(Coord<1>(i))) {
+                expected *= 2;
+            }
+            TS_ASSERT_EQUALS(expected, grid.get(Coord<1>(i)).testValue);
+        }
+    }
+
+    void testCopyingGridVisitor()
+    {
+        CoordBox<2> box(Coord<2>(10, 20), Coord<2>(25, 10));
+        DisplacedGrid<TestCellType> source(box);
+        initGrid(&source, box);
+        DisplacedGrid<TestCellType> target(box);
+
+        Region<2> copyRegion;
+        copyRegion << Streak<2>(Coord<2>(12, 21), 20)
+                   << Streak<2>(Coord<2>(15, 22), 18);
+
+        CopyingGridVisitor<TestCellType, 2, DisplacedGrid<TestCellType> > copier(&target);
+        const DisplacedGrid<TestCellType>& constSource = source;
+        constSource.visit(copyRegion, &copier);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            double expected = copyRegion.count(*i) ? source[*i].testValue : TestCellType().testValue;
+            TS_ASSERT_EQUALS(expected, target[*i].testValue);
+        }
+    }
+
+private:
+    Region<2> region;
+
+    template<typename GRID>
+    void initGrid(GRID *grid, const CoordBox<2>& box)
+    {
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            (*grid)[*i].testValue = i->x() + 100 * i->y();
+        }
+    }
+
+    template<typename GRID>
+    void checkScaled(const GRID& grid, const CoordBox<2>& box)
+    {
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            double expected = i->x() + 100 * i->y();
+            if (region.count(*i)) {
+                expected *= 2;
+            }
+            TS_ASSERT_EQUALS(expected, grid[*i].testValue);
+        }
+    }
+};
+
+}
@@ -0,0 +1,395 @@
+#include <libgeodecomp/io/simpleinitializer.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/parallelization/serialsimulator.h>
+#include <libgeodecomp/storage/linearstencil.h>
+
+#include <libflatarray/streaming_short_vec.hpp>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+typedef LinearStencil<
+    StencilWeight< 0,  0, -1, 1, 16>,
+    StencilWeight< 0, -1,  0, 1, 16>,
+    StencilWeight<-1,  0,  0, 1,  8>,
+    StencilWeight< 0,  0,  0, 1,  2>,
+    StencilWeight< 1,  0,  0, 1,  8>,
+    StencilWeight< 0,  1,  0, 1, 16>,
+    StencilWeight< 0,  0,  1, 1, 16> > WeightedStencil;
+
+typedef LinearStencil<
+    StencilWeight< 0,  0, -1, 1, 7>,
+    StencilWeight< 0, -1,  0, 1, 7>,
+    StencilWeight<-1,  0,  0, 1, 7>,
+    StencilWeight< 0,  0,  0, 1, 7>,
+    StencilWeight< 1,  0,  0, 1, 7>,
+    StencilWeight< 0,  1,  0, 1, 7>,
+    StencilWeight< 0,  0,  1, 1, 7> > JacobiStencil;
+
+/**
+ * Hand-written counterpart to the kernels generated by LinearStencil.
+ */
+class LinearStencilReferenceCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasTorusTopology<3>
+    {};
+
+    explicit LinearStencilReferenceCell(double u = 0, double v = 0) :
+        u(u),
+        v(v)
+    {}
+
+    template<typename NEIGHBORHOOD>
+    void update(const NEIGHBORHOOD& hood, int /* nanoStep */)
+    {
+        u =
+            hood[FixedCoord< 0,  0, -1>()].u * (1.0 / 16) +
+            hood[FixedCoord< 0, -1,  0>()].u * (1.0 / 16) +
+            hood[FixedCoord<-1,  0,  0>()].u * (1.0 /  8) +
+            hood[FixedCoord< 0,  0,  0>()].u * (1.0 /  2) +
+            hood[FixedCoord< 1,  0,  0>()].u * (1.0 /  8) +
+            hood[FixedCoord< 0,  1,  0>()].u * (1.0 / 16) +
+            hood[FixedCoord< 0,  0,  1>()].u * (1.0 / 16);
+
+        v = (hood[FixedCoord< 0,  0, -1>()].v +
+             hood[FixedCoord< 0, -1,  0>()].v +
+             hood[FixedCoord<-1,  0,  0>()].v +
+             hood[FixedCoord< 0,  0,  0>()].v +
+             hood[FixedCoord< 1,  0,  0>()].v +
+             hood[FixedCoord< 0,  1,  0>()].v +
+             hood[FixedCoord< 0,  0,  1>()].v) * (1.0 / 7);
+    }
+
+    double u;
+    double v;
+};
+
+/**
+ * Applies the weighted stencil to both members in a single sweep.
+ */
+class LinearStencilSoACell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasTorusTopology<3>,
+        public APITraits::HasSoA
+    {};
+
+    explicit LinearStencilSoACell(double u = 0, double v = 0) :
+        u(u),
+        v(v)
+    {}
+
+    template<typename HOOD_OLD, typename HOOD_NEW>
+    static void updateLineX(HOOD_OLD& hoodOld, long indexEnd, HOOD_NEW& hoodNew, int /* nanoStep */)
+    {
+        WeightedStencil::updateLineX<LibFlatArray::short_vec<double, 8> >(
+            hoodOld, indexEnd, hoodNew, &LinearStencilSoACell::u, &LinearStencilSoACell::v);
+    }
+
+    double u;
+    double v;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    LinearStencilSoACell,
+    ((double)(u))
+    ((double)(v)))
+
+/**
+ * Applies different stencils to its members, using streaming stores.
+ */
+class LinearStencilStreamingCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasTorusTopology<3>,
+        public APITraits::HasSoA
+    {};
+
+    explicit LinearStencilStreamingCell(double u = 0, double v = 0) :
+        u(u),
+        v(v)
+    {}
+
+    template<typename HOOD_OLD, typename HOOD_NEW>
+    static void updateLineX(HOOD_OLD& hoodOld, long indexEnd, HOOD_NEW& hoodNew, int /* nanoStep */)
+    {
+        typedef LibFlatArray::streaming_short_vec<double, 8> ShortVec;
+
+        long indexOld = hoodOld.index();
+        long indexNew = hoodNew.index();
+        WeightedStencil::updateLineX<ShortVec>(hoodOld, indexEnd, hoodNew, &LinearStencilStreamingCell::u);
+
+        hoodOld.index() = indexOld;
+        hoodNew.index() = indexNew;
+        JacobiStencil::updateLineX<ShortVec>(hoodOld, indexEnd, hoodNew, &LinearStencilStreamingCell::v);
+    }
+
+    double u;
+    double v;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    LinearStencilStreamingCell,
+    ((double)(u))
+    ((double)(v)))
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+/**
+ * Lets LinearStencil decide at runtime whether to use streaming
+ * stores.
+ */
+class LinearStencilSwitchCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasTorusTopology<3>,
+        public APITraits::HasSoA
+    {};
+
+    explicit LinearStencilSwitchCell(double u = 0, double v = 0) :
+        u(u),
+        v(v)
+    {}
+
+    template<typename HOOD_OLD, typename HOOD_NEW>
+    static void updateLineX(HOOD_OLD& hoodOld, long indexEnd, HOOD_NEW& hoodNew, int /* nanoStep */)
+    {
+        WeightedStencil::updateLineXSwitch<double, 8>(
+            hoodOld, indexEnd, hoodNew, &LinearStencilSwitchCell::u, &LinearStencilSwitchCell::v);
+    }
+
+    double u;
+    double v;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    LinearStencilSwitchCell,
+    ((double)(u))
+    ((double)(v)))
+#endif
+
+/**
+ * AoS cell which consists of a single member, hence neighbors are
+ * contiguous and can be loaded as short vectors.
+ */
+class LinearStencilAoSCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasTorusTopology<3>
+    {};
+
+    explicit LinearStencilAoSCell(double u = 0, double /* v */ = 0) :
+        u(u)
+    {}
+
+    template<typename NEIGHBORHOOD>
+    static void updateLineX(
+        LinearStencilAoSCell *target,
+        long *x,
+        long endX,
+        const NEIGHBORHOOD& hood,
+        int /* nanoStep */)
+    {
+        WeightedStencil::updateLineX<LibFlatArray::short_vec<double, 4> >(
+            target, x, endX, hood, &LinearStencilAoSCell::u);
+    }
+
+    double u;
+};
+
+/**
+ * AoS cell with multiple members, for which we fall back to scalar
+ * code in updateLineX() and to apply() in update().
+ */
+class LinearStencilMultiMemberAoSCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasTorusTopology<3>
+    {};
+
+    explicit LinearStencilMultiMemberAoSCell(double u = 0, double v = 0) :
+        u(u),
+        v(v)
+    {}
+
+    template<typename NEIGHBORHOOD>
+    void update(const NEIGHBORHOOD& hood, int /* nanoStep */)
+    {
+        u = WeightedStencil::apply(hood, &LinearStencilMultiMemberAoSCell::u);
+        v = JacobiStencil::apply(hood, &LinearStencilMultiMemberAoSCell::v);
+    }
+
+    double u;
+    double v;
+};
+
+namespace LibGeoDecomp {
+
+template<typename CELL>
+class LinearStencilTestInitializer : public SimpleInitializer<CELL>
+{
+public:
+    LinearStencilTestInitializer() :
+        SimpleInitializer<CELL>(Coord<3>(37, 13, 9), 5)
+    {}
+
+    virtual void grid(GridBase<CELL, 3> *ret)
+    {
+        CoordBox<3> box = ret->boundingBox();
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            double u = (i->x() * 7 + i->y() * 13 + i->z() * 31) % 17;
+            double v = (i->x() * 3 + i->y() * 5 + i->z() * 11) % 19;
+            ret->set(*i, CELL(u, v));
+        }
+    }
+};
+
+/**
+ * Swaps u and v, so the reference cell applies the weighted stencil
+ * to the initial values of v.
+ */
+class LinearStencilSwappingInitializer : public LinearStencilTestInitializer<LinearStencilReferenceCell>
+{
+public:
+    virtual void grid(GridBase<LinearStencilReferenceCell, 3> *ret)
+    {
+        LinearStencilTestInitializer<LinearStencilReferenceCell>::grid(ret);
+        CoordBox<3> box = ret->boundingBox();
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            LinearStencilReferenceCell cell = ret->get(*i);
+            ret->set(*i, LinearStencilReferenceCell(cell.v, cell.u));
+        }
+    }
+};
+
+class LinearStencilTest : public CxxTest::TestSuite
+{
+public:
+    typedef LinearStencilReferenceCell RefCell;
+    typedef SerialSimulator<RefCell> ReferenceSimulator;
+
+    void setUp()
+    {
+        reference.reset(new ReferenceSimulator(new LinearStencilTestInitializer<RefCell>()));
+        reference->run();
+        swapped.reset(new ReferenceSimulator(new LinearStencilSwappingInitializer()));
+        swapped->run();
+    }
+
+    void tearDown()
+    {
+        reference.reset();
+        swapped.reset();
+    }
+
+    void testTraits()
+    {
+        TS_ASSERT_EQUALS(7, WeightedStencil::VOLUME);
+        TS_ASSERT_EQUALS(1, WeightedStencil::RADIUS);
+        TS_ASSERT(!WeightedStencil::UNIFORM);
+        TS_ASSERT(JacobiStencil::UNIFORM);
+
+        typedef LinearStencil<
+            StencilWeight<-2, 0, 0, 2, 4>,
+            StencilWeight< 0, 0, 0, 1, 2>,
+            StencilWeight< 0, 1, 0, 3, 6> > Uniform;
+        TS_ASSERT_EQUALS(2, Uniform::RADIUS);
+        TS_ASSERT(Uniform::UNIFORM);
+    }
+
+    void testSoAMultipleMembers()
+    {
+        typedef LinearStencilSoACell Cell;
+        SerialSimulator<Cell> sim(new LinearStencilTestInitializer<Cell>());
+        sim.run();
+
+        // both members are being updated with the weighted stencil:
+        checkMember(*sim.getGrid(), &Cell::u, *reference->getGrid(), &RefCell::u);
+        checkMember(*sim.getGrid(), &Cell::v, *swapped->getGrid(), &RefCell::u);
+    }
+
+    void testSoAStreamingStores()
+    {
+        typedef LinearStencilStreamingCell Cell;
+        SerialSimulator<Cell> sim(new LinearStencilTestInitializer<Cell>());
+        sim.run();
+
+        checkMember(*sim.getGrid(), &Cell::u, *reference->getGrid(), &RefCell::u);
+        checkMember(*sim.getGrid(), &Cell::v, *reference->getGrid(), &RefCell::v);
+    }
+
+    void testSoAShortVecSwitch()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef LinearStencilSwitchCell Cell;
+        SerialSimulator<Cell> sim(new LinearStencilTestInitializer<Cell>());
+        sim.run();
+
+        checkMember(*sim.getGrid(), &Cell::u, *reference->getGrid(), &RefCell::u);
+        checkMember(*sim.getGrid(), &Cell::v, *swapped->getGrid(), &RefCell::u);
+#endif
+    }
+
+    void testAoSVectorized()
+    {
+        typedef LinearStencilAoSCell Cell;
+        SerialSimulator<Cell> sim(new LinearStencilTestInitializer<Cell>());
+        sim.run();
+
+        checkMember(*sim.getGrid(), &Cell::u, *reference->getGrid(), &RefCell::u);
+    }
+
+    void testAoSScalar()
+    {
+        typedef LinearStencilMultiMemberAoSCell Cell;
+        SerialSimulator<Cell> sim(new LinearStencilTestInitializer<Cell>());
+        sim.run();
+
+        checkMember(*sim.getGrid(), &Cell::u, *reference->getGrid(), &RefCell::u);
+        checkMember(*sim.getGrid(), &Cell::v, *reference->getGrid(), &RefCell::v);
+    }
+
+private:
+    SharedPtr<ReferenceSimulator>::Type reference;
+    SharedPtr<ReferenceSimulator>::Type swapped;
+
+    template<typename CELL>
+    void checkMember(
+        const GridBase<CELL, 3>& actual,
+        double CELL:: *member,
+        const GridBase<RefCell, 3>& expected,
+        double RefCell:: *expectedMember)
+    {
+        CoordBox<3> box = actual.boundingBox();
+        TS_ASSERT_EQUALS(expected.boundingBox(), box);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_DELTA(expected.get(*i).*expectedMember, actual.get(*i).*member, 1e-12);
+        }
+    }
+};
+
+}
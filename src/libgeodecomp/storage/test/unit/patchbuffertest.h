@@ -4,6 +4,8 @@
 #include <libgeodecomp/storage/displacedgrid.h>
 #include <libgeodecomp/storage/patchbuffer.h>
 
+#include <set>
+
 using namespace LibGeoDecomp;
 
 namespace LibGeoDecomp {
@@ -105,6 +107,46 @@ public:
         TS_ASSERT_EQUALS(testGrid2, compGrid);
     }
 
+    void testBuffersAreRecycled()
+    {
+        PatchBufferType patchBuffer(region1);
+        patchBuffer.pushRequest(0);
+        patchBuffer.pushRequest(1);
+        patchBuffer.put(baseGrid, validRegion, dimensions.dimensions, 0, 0);
+        patchBuffer.put(baseGrid, validRegion, dimensions.dimensions, 1, 0);
+        TS_ASSERT_EQUALS(std::size_t(2), patchBuffer.buffers.size());
+
+        std::set<const int*> storage;
+        storage.insert(&patchBuffer.buffers[0][0]);
+        storage.insert(&patchBuffer.buffers[1][0]);
+
+        // a queue which doesn't grow beyond two elements should keep
+        // using the same two buffers:
+        for (std::size_t nanoStep = 2; nanoStep < 20; ++nanoStep) {
+            compGrid = zeroGrid;
+            patchBuffer.get(&compGrid, validRegion, dimensions.dimensions, nanoStep - 2, 0);
+            TS_ASSERT_EQUALS(testGrid1, compGrid);
+
+            patchBuffer.pushRequest(nanoStep);
+            patchBuffer.put(baseGrid, validRegion, dimensions.dimensions, nanoStep, 0);
+
+            TS_ASSERT_EQUALS(std::size_t(2), patchBuffer.buffers.size());
+            TS_ASSERT_EQUALS(std::size_t(1), storage.count(&patchBuffer.buffers[0][0]));
+            TS_ASSERT_EQUALS(std::size_t(1), storage.count(&patchBuffer.buffers[1][0]));
+        }
+
+        // growing the queue must retain the order of the stored patches:
+        patchBuffer.pushRequest(20);
+        patchBuffer.put(testGrid1, validRegion, dimensions.dimensions, 20, 0);
+        TS_ASSERT_EQUALS(std::size_t(3), patchBuffer.buffers.size());
+
+        for (std::size_t nanoStep = 18; nanoStep < 21; ++nanoStep) {
+            compGrid = zeroGrid;
+            patchBuffer.get(&compGrid, validRegion, dimensions.dimensions, nanoStep, 0);
+            TS_ASSERT_EQUALS(testGrid1, compGrid);
+        }
+    }
+
 private:
     CoordBox<2> dimensions;
     GridType baseGrid;
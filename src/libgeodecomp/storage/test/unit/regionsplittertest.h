@@ -0,0 +1,172 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/regionsplitter.h>
+
+#include <mutex>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class RegionSplitterTest : public CxxTest::TestSuite
+{
+public:
+    void testStreaksCoverRegion()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        Region<3> region;
+        region << CoordBox<3>(Coord<3>(-5, 0, 0), Coord<3>(300, 7, 4));
+        region << Streak<3>(Coord<3>(-100, 20, 9), 1000);
+
+        RegionSplitter<3> splitter(region, 0, 4);
+
+        Region<3> actual;
+        std::size_t cells = 0;
+        for (std::size_t i = 0; i < splitter.getStreaks().size(); ++i) {
+            Streak<3> s = splitter.getStreaks()[i];
+            cells += s.length();
+            actual << s;
+        }
+
+        TS_ASSERT_EQUALS(region, actual);
+        TS_ASSERT_EQUALS(region.size(), cells);
+        TS_ASSERT_EQUALS(region.size() / 16, splitter.grainSize());
+#endif
+    }
+
+    void testMaxStreakLength()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        Region<2> region;
+        region << Streak<2>(Coord<2>(-7, 0), 50);
+        region << Streak<2>(Coord<2>(3, 1), 5);
+
+        RegionSplitter<2> splitter(region, 16, 2);
+        const std::vector<Streak<2> >& streaks = splitter.getStreaks();
+
+        std::vector<Streak<2> > expected;
+        expected << Streak<2>(Coord<2>(-7, 0), 0)
+                 << Streak<2>(Coord<2>( 0, 0), 16)
+                 << Streak<2>(Coord<2>(16, 0), 32)
+                 << Streak<2>(Coord<2>(32, 0), 48)
+                 << Streak<2>(Coord<2>(48, 0), 50)
+                 << Streak<2>(Coord<2>( 3, 1), 5);
+        TS_ASSERT_EQUALS(expected, streaks);
+#endif
+    }
+
+    void testCache()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        Region<2> region1;
+        region1 << CoordBox<2>(Coord<2>(0, 0), Coord<2>(100, 20));
+        Region<2> region2 = region1;
+        Region<2> region3 = region1;
+        region3 >> Coord<2>(10, 10);
+
+        RegionSplitter<2>::Ptr splitter1 = RegionSplitter<2>::get(region1, 0, 4);
+        RegionSplitter<2>::Ptr splitter2 = RegionSplitter<2>::get(region2, 0, 4);
+        RegionSplitter<2>::Ptr splitter3 = RegionSplitter<2>::get(region3, 0, 4);
+        RegionSplitter<2>::Ptr splitter4 = RegionSplitter<2>::get(region1, 0, 2);
+        RegionSplitter<2>::Ptr splitter5 = RegionSplitter<2>::get(region1, 32, 4);
+
+        TS_ASSERT_EQUALS(splitter1.get(), splitter2.get());
+        TS_ASSERT_DIFFERS(splitter1.get(), splitter3.get());
+        TS_ASSERT_DIFFERS(splitter1.get(), splitter4.get());
+        TS_ASSERT_DIFFERS(splitter1.get(), splitter5.get());
+
+        // same bounding box, size and number of Streaks, but
+        // different Regions:
+        Region<2> region6;
+        region6 << Streak<2>(Coord<2>(0, 0), 5);
+        region6 << Streak<2>(Coord<2>(5, 1), 10);
+        Region<2> region7;
+        region7 << Streak<2>(Coord<2>(5, 0), 10);
+        region7 << Streak<2>(Coord<2>(0, 1), 5);
+        RegionSplitter<2>::Ptr splitter6 = RegionSplitter<2>::get(region6, 0, 4);
+        RegionSplitter<2>::Ptr splitter7 = RegionSplitter<2>::get(region7, 0, 4);
+        TS_ASSERT_EQUALS(region6.boundingBox(), region7.boundingBox());
+        TS_ASSERT_DIFFERS(splitter6.get(), splitter7.get());
+        TS_ASSERT_EQUALS(splitter6.get(), RegionSplitter<2>::get(region6, 0, 4).get());
+
+        // evicted entries remain valid:
+        for (int i = 0; i < 20; ++i) {
+            Region<2> region;
+            region << Streak<2>(Coord<2>(0, i), 10);
+            RegionSplitter<2>::get(region, 0, 4);
+        }
+        TS_ASSERT_EQUALS(std::size_t(20), splitter1->getStreaks().size());
+        TS_ASSERT_DIFFERS(splitter1.get(), RegionSplitter<2>::get(region1, 0, 4).get());
+#endif
+    }
+
+    void testForEachVisitsAllStreaksOnce()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        WorkStealingPool pool(3);
+        Region<3> region;
+        region << CoordBox<3>(Coord<3>(0, 0, 0), Coord<3>(200, 30, 3));
+        region << CoordBox<3>(Coord<3>(0, 0, 10), Coord<3>(20, 5, 50));
+
+        RegionSplitter<3> splitter(region, 0, pool.numThreads());
+        std::vector<int> visits(splitter.getStreaks().size(), 0);
+        const Streak<3> *base = &splitter.getStreaks()[0];
+        std::mutex mutex;
+        Region<3> visited;
+        std::size_t numRanges = 0;
+
+        splitter.forEach(&pool, [&](const Streak<3> *begin, const Streak<3> *end) {
+                TS_ASSERT(begin < end);
+                std::lock_guard<std::mutex> lock(mutex);
+                ++numRanges;
+                for (const Streak<3> *i = begin; i != end; ++i) {
+                    ++visits[i - base];
+                    visited << *i;
+                }
+            });
+
+        TS_ASSERT_EQUALS(std::vector<int>(visits.size(), 1), visits);
+        TS_ASSERT_EQUALS(region, visited);
+        TS_ASSERT(numRanges > 1);
+#endif
+    }
+
+    void testForEachOnEmptyRegion()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        WorkStealingPool pool(2);
+        RegionSplitter<2> splitter(Region<2>(), 0, 2);
+        int calls = 0;
+        splitter.forEach(&pool, [&calls](const Streak<2> *begin, const Streak<2> *end) {
+                ++calls;
+            });
+        TS_ASSERT_EQUALS(0, calls);
+#endif
+    }
+
+    void testSplitPointPrefersPlanes()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        // 3 planes, 10 rows of 100 cells each:
+        Region<3> region;
+        region << CoordBox<3>(Coord<3>(0, 0, 0), Coord<3>(100, 10, 3));
+        RegionSplitter<3> splitter(region, 0, 1);
+        TS_ASSERT_EQUALS(std::size_t(30), splitter.getStreaks().size());
+
+        // the exact middle (row 15) lies within a plane, plane
+        // boundaries at rows 10 and 20 are within tolerance:
+        std::size_t middle = splitter.splitPoint(0, 30);
+        TS_ASSERT((middle == 10) || (middle == 20));
+
+        // within a single plane there's nothing to snap to:
+        TS_ASSERT_EQUALS(std::size_t(5), splitter.splitPoint(0, 10));
+
+        TS_ASSERT_EQUALS(std::size_t(20), splitter.splitPoint(12, 30));
+
+        // a far away plane boundary is ignored:
+        TS_ASSERT_EQUALS(std::size_t(24), splitter.splitPoint(17, 30));
+#endif
+    }
+};
+
+}
@@ -787,6 +787,110 @@ public:
         TS_ASSERT_EQUALS(expected, actual);
 #endif
     }
+
+    void testCompileRegionAoS()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        checkCompileRegion<UnstructuredTestCell<> >();
+#endif
+    }
+
+    void testCompileRegionSoA()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        checkCompileRegion<UnstructuredTestCellSoA3>();
+#endif
+    }
+
+    void testLayoutID()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef UnstructuredTestCell<> TestCellType;
+        typedef ReorderingUnstructuredGrid<UnstructuredGrid<TestCellType, 1, double, 4, 4> > GridType;
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>(10), 30);
+        GridType grid1(region);
+        GridType grid2(region);
+        TS_ASSERT_DIFFERS(grid1.layoutID(), grid2.layoutID());
+
+        GridType copy(grid1);
+        TS_ASSERT_EQUALS(grid1.layoutID(), copy.layoutID());
+
+        GridType::SparseMatrix matrix;
+        for (int id = 10; id < 30; ++id) {
+            for (int neighbor = 10; neighbor < (10 + id % 4); ++neighbor) {
+                matrix << std::make_pair(Coord<2>(id, neighbor), 1.0);
+            }
+        }
+        grid1.setWeights(0, matrix);
+        TS_ASSERT_DIFFERS(grid1.layoutID(), copy.layoutID());
+        TS_ASSERT_DIFFERS(grid1.layoutID(), grid2.layoutID());
+#endif
+    }
+
+private:
+#ifdef LIBGEODECOMP_WITH_CPP14
+    template<typename TEST_CELL>
+    void checkCompileRegion()
+    {
+        typedef typename APITraits::SelectSoA<TEST_CELL>::Value SoAFlag;
+        typedef typename GridTypeSelector<TEST_CELL, Topology, false, SoAFlag>::Value GridType;
+        typedef typename SerializationBuffer<TEST_CELL>::BufferType BufferType;
+
+        UnstructuredTestInitializer<TEST_CELL> init(1234, 66);
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>( 11),  44)
+               << Streak<1>(Coord<1>(100), 140)
+               << Streak<1>(Coord<1>(211), 214)
+               << Streak<1>(Coord<1>(355), 450);
+
+        // setWeights() reorders the cells (for SIGMA > 1):
+        GridType grid1(region);
+        GridType grid2(region);
+        init.grid(&grid1);
+        init.grid(&grid2);
+
+        Region<1> fragment;
+        fragment << Streak<1>(Coord<1>( 20),  30)
+                 << Coord<1>(105)
+                 << Streak<1>(Coord<1>(212), 214)
+                 << Streak<1>(Coord<1>(400), 449);
+
+        typename GridType::PhysicalStreakVec streaks = grid1.compileRegion(fragment);
+        std::size_t cells = 0;
+        for (std::size_t i = 0; i < streaks.size(); ++i) {
+            cells += streaks[i].length();
+        }
+        TS_ASSERT_EQUALS(fragment.size(), cells);
+        TS_ASSERT_LESS_THAN_EQUALS(fragment.numStreaks(), streaks.size());
+
+        BufferType expected = SerializationBuffer<TEST_CELL>::create(fragment);
+        BufferType actual   = SerializationBuffer<TEST_CELL>::create(fragment);
+        grid1.saveRegion(&expected, fragment);
+        grid1.saveStreaks(&actual[0], streaks, fragment.size());
+        TS_ASSERT(expected == actual);
+
+        for (Region<1>::Iterator i = fragment.begin(); i != fragment.end(); ++i) {
+            TEST_CELL cell = grid1.get(*i);
+            cell.cycleCounter = 4711;
+            grid1.set(*i, cell);
+        }
+        grid1.saveStreaks(&actual[0], streaks, fragment.size());
+        grid2.loadStreaks(&actual[0], grid2.compileRegion(fragment), fragment.size());
+
+        for (Region<1>::Iterator i = region.begin(); i != region.end(); ++i) {
+            unsigned expectedCycle = fragment.count(*i) ? 4711 : 0;
+            TS_ASSERT_EQUALS(i->x(),        grid2.get(*i).id);
+            TS_ASSERT_EQUALS(expectedCycle, grid2.get(*i).cycleCounter);
+        }
+
+        Region<1> outside;
+        outside << Coord<1>(50);
+        TS_ASSERT_THROWS(grid1.compileRegion(outside), std::logic_error&);
+    }
+#endif
 };
 
 }
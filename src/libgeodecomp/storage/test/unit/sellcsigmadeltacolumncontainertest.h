@@ -0,0 +1,129 @@
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/sellcsigmadeltacolumncontainer.h>
+#include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
+
+#include <cxxtest/TestSuite.h>
+
+#include <stdexcept>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class SellCSigmaDeltaColumnContainerTest : public CxxTest::TestSuite
+{
+public:
+#ifdef LIBGEODECOMP_WITH_CPP14
+    using DMatrix = std::vector<std::pair<Coord<2>, double> >;
+
+    DMatrix bandMatrix(int dim, int offset)
+    {
+        DMatrix matrix;
+
+        for (int i = 0; i < dim; ++i) {
+            // rows of varying length to exercise padding
+            for (int j = -1 - (i % 3); j <= 1; ++j) {
+                int column = i + j * offset;
+                if ((column >= 0) && (column < dim)) {
+                    matrix << std::make_pair(Coord<2>(i, column), i + 0.1 * j);
+                }
+            }
+        }
+
+        return matrix;
+    }
+#endif
+
+    void testGetRowMatchesPlainContainer()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 200;
+        DMatrix matrix = bandMatrix(DIM, 17);
+
+        SellCSigmaSparseMatrixContainer<double, 4, 16> plain(DIM);
+        SellCSigmaDeltaColumnContainer<double, 4, 16> delta(DIM);
+        plain.initFromMatrix(matrix);
+        delta.initFromMatrix(matrix);
+
+        TS_ASSERT_EQUALS(plain.chunkOffsetVec(), delta.chunkOffsetVec());
+        TS_ASSERT_EQUALS(plain.chunkLengthVec(), delta.chunkLengthVec());
+        TS_ASSERT_EQUALS(plain.chunkRowToRealVec(), delta.chunkRowToRealVec());
+
+        for (int i = 0; i < DIM; ++i) {
+            TS_ASSERT_EQUALS(plain.getRow(i), delta.getRow(i));
+        }
+#endif
+    }
+
+    void testColumnChunkDecoding()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int C = 8;
+        const int DIM = 100;
+        DMatrix matrix = bandMatrix(DIM, 5);
+
+        SellCSigmaSparseMatrixContainer<double, C, 1> plain(DIM);
+        SellCSigmaDeltaColumnContainer<double, C, 1> delta(DIM);
+        plain.initFromMatrix(matrix);
+        delta.initFromMatrix(matrix);
+
+        SellCSigmaSparseMatrixContainer<double, C, 1>::ScratchSpace plainScratch;
+        SellCSigmaDeltaColumnContainer<double, C, 1>::ScratchSpace deltaScratch;
+
+        for (std::size_t chunk = 0; chunk < delta.chunkLengthVec().size(); ++chunk) {
+            for (int offset = delta.chunkOffsetVec()[chunk];
+                 offset < delta.chunkOffsetVec()[chunk + 1];
+                 offset += C) {
+                const int *expectedColumns = plain.columnChunk(chunk, offset, &plainScratch);
+                const double *expectedValues = plain.valueChunk(chunk, offset, &plainScratch);
+                const int *actualColumns = delta.columnChunk(chunk, offset, &deltaScratch);
+                const double *actualValues = delta.valueChunk(chunk, offset, &deltaScratch);
+
+                for (int i = 0; i < C; ++i) {
+                    TS_ASSERT_EQUALS(expectedValues[i], actualValues[i]);
+                    // padding may point elsewhere, but its weight is 0
+                    if (expectedValues[i] != 0) {
+                        TS_ASSERT_EQUALS(expectedColumns[i], actualColumns[i]);
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+    void testCompression()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 1000;
+        DMatrix matrix = bandMatrix(DIM, 31);
+
+        SellCSigmaSparseMatrixContainer<double, 4, 1> plain(DIM);
+        SellCSigmaDeltaColumnContainer<double, 4, 1> delta(DIM);
+        plain.initFromMatrix(matrix);
+        delta.initFromMatrix(matrix);
+
+        std::size_t plainBytes = plain.columnVec().size() * sizeof(int);
+        std::size_t deltaBytes =
+            delta.columnDeltaVec().size() * sizeof(SellCSigmaDeltaColumnContainer<double, 4, 1>::DeltaType) +
+            delta.chunkBaseVec().size() * sizeof(int);
+        TS_ASSERT(deltaBytes < 0.6 * plainBytes);
+#endif
+    }
+
+    void testOverflowThrows()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 70000;
+        DMatrix matrix;
+        matrix << std::make_pair(Coord<2>(0, 0), 1.0);
+        matrix << std::make_pair(Coord<2>(1, DIM - 1), 2.0);
+
+        SellCSigmaDeltaColumnContainer<double, 4, 1> delta(DIM);
+        TS_ASSERT_THROWS(delta.initFromMatrix(matrix), std::logic_error&);
+#endif
+    }
+};
+
+}
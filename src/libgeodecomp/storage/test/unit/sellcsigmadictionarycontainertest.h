@@ -0,0 +1,111 @@
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/sellcsigmadictionarycontainer.h>
+#include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
+
+#include <cxxtest/TestSuite.h>
+
+#include <stdexcept>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class SellCSigmaDictionaryContainerTest : public CxxTest::TestSuite
+{
+public:
+#ifdef LIBGEODECOMP_WITH_CPP14
+    using DMatrix = std::vector<std::pair<Coord<2>, double> >;
+
+    /**
+     * 1D Laplacian with irregular row lengths on the first rows
+     */
+    DMatrix laplacian(int dim)
+    {
+        DMatrix matrix;
+
+        for (int i = 0; i < dim; ++i) {
+            if (i > 0) {
+                matrix << std::make_pair(Coord<2>(i, i - 1), -1.0);
+            }
+            matrix << std::make_pair(Coord<2>(i, i), 2.0);
+            if (i < (dim - 1)) {
+                matrix << std::make_pair(Coord<2>(i, i + 1), -1.0);
+            }
+        }
+
+        return matrix;
+    }
+#endif
+
+    void testGetRowMatchesPlainContainer()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 123;
+        DMatrix matrix = laplacian(DIM);
+
+        SellCSigmaSparseMatrixContainer<double, 4, 8> plain(DIM);
+        SellCSigmaDictionaryContainer<double, 4, 8> dict(DIM);
+        plain.initFromMatrix(matrix);
+        dict.initFromMatrix(matrix);
+
+        for (int i = 0; i < DIM; ++i) {
+            TS_ASSERT_EQUALS(plain.getRow(i), dict.getRow(i));
+        }
+
+        // padding (0), 2 and -1:
+        TS_ASSERT_EQUALS(std::size_t(3), dict.dictionaryVec().size());
+        TS_ASSERT_EQUALS(0.0, dict.dictionaryVec()[0]);
+#endif
+    }
+
+    void testValueChunkDecoding()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int C = 4;
+        const int DIM = 66;
+        DMatrix matrix = laplacian(DIM);
+
+        SellCSigmaSparseMatrixContainer<double, C, 1> plain(DIM);
+        SellCSigmaDictionaryContainer<double, C, 1> dict(DIM);
+        plain.initFromMatrix(matrix);
+        dict.initFromMatrix(matrix);
+
+        SellCSigmaSparseMatrixContainer<double, C, 1>::ScratchSpace plainScratch;
+        SellCSigmaDictionaryContainer<double, C, 1>::ScratchSpace dictScratch;
+
+        for (std::size_t chunk = 0; chunk < dict.chunkLengthVec().size(); ++chunk) {
+            for (int offset = dict.chunkOffsetVec()[chunk];
+                 offset < dict.chunkOffsetVec()[chunk + 1];
+                 offset += C) {
+                const int *expectedColumns = plain.columnChunk(chunk, offset, &plainScratch);
+                const double *expectedValues = plain.valueChunk(chunk, offset, &plainScratch);
+                const int *actualColumns = dict.columnChunk(chunk, offset, &dictScratch);
+                const double *actualValues = dict.valueChunk(chunk, offset, &dictScratch);
+
+                for (int i = 0; i < C; ++i) {
+                    TS_ASSERT_EQUALS(expectedColumns[i], actualColumns[i]);
+                    TS_ASSERT_EQUALS(expectedValues[i], actualValues[i]);
+                }
+            }
+        }
+#endif
+    }
+
+    void testTooManyValuesThrows()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 70000;
+        DMatrix matrix;
+        for (int i = 0; i < DIM; ++i) {
+            matrix << std::make_pair(Coord<2>(i, i), 1.0 + i);
+        }
+
+        SellCSigmaDictionaryContainer<double, 4, 1> dict(DIM);
+        TS_ASSERT_THROWS(dict.initFromMatrix(matrix), std::logic_error&);
+#endif
+    }
+};
+
+}
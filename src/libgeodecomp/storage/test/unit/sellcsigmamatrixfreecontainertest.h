@@ -0,0 +1,186 @@
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/sellcsigmamatrixfreecontainer.h>
+#include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
+
+#include <cxxtest/TestSuite.h>
+
+#include <stdexcept>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+/**
+ * Yields the weights of a 1D Laplacian on dim nodes
+ */
+class LaplacianWeights
+{
+public:
+    explicit LaplacianWeights(int dim = 0) :
+        dim(dim)
+    {}
+
+    int rowLength(int row) const
+    {
+        return 3 - (row == 0) - (row == (dim - 1));
+    }
+
+    void operator()(int row, int element, int *column, double *weight) const
+    {
+        int first = (row == 0) ? row : row - 1;
+        *column = first + element;
+        *weight = (*column == row) ? 2.0 : -1.0;
+    }
+
+private:
+    int dim;
+};
+
+/**
+ * Same as LaplacianWeights, but counts its invocations
+ */
+class CountingLaplacianWeights : public LaplacianWeights
+{
+public:
+    explicit CountingLaplacianWeights(int dim = 0, int *counter = 0) :
+        LaplacianWeights(dim),
+        counter(counter)
+    {}
+
+    void operator()(int row, int element, int *column, double *weight) const
+    {
+        ++*counter;
+        LaplacianWeights::operator()(row, element, column, weight);
+    }
+
+private:
+    int *counter;
+};
+
+#endif
+
+class SellCSigmaMatrixFreeContainerTest : public CxxTest::TestSuite
+{
+public:
+    void testMatchesStoredMatrix()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int C = 4;
+        const int DIM = 37;
+        std::vector<std::pair<Coord<2>, double> > matrix;
+        for (int i = 0; i < DIM; ++i) {
+            if (i > 0) {
+                matrix << std::make_pair(Coord<2>(i, i - 1), -1.0);
+            }
+            matrix << std::make_pair(Coord<2>(i, i), 2.0);
+            if (i < (DIM - 1)) {
+                matrix << std::make_pair(Coord<2>(i, i + 1), -1.0);
+            }
+        }
+
+        SellCSigmaSparseMatrixContainer<double, C, 1> plain(DIM);
+        plain.initFromMatrix(matrix);
+        typedef SellCSigmaMatrixFreeContainer<double, C, LaplacianWeights> MatrixFree;
+        MatrixFree matrixFree(DIM, LaplacianWeights(DIM));
+
+        TS_ASSERT_EQUALS(plain.chunkOffsetVec(), matrixFree.chunkOffsetVec());
+        TS_ASSERT_EQUALS(plain.chunkLengthVec(), matrixFree.chunkLengthVec());
+
+        for (int i = 0; i < DIM; ++i) {
+            TS_ASSERT_EQUALS(plain.getRow(i), matrixFree.getRow(i));
+        }
+
+        SellCSigmaSparseMatrixContainer<double, C, 1>::ScratchSpace plainScratch;
+        MatrixFree::ScratchSpace freeScratch;
+
+        for (std::size_t chunk = 0; chunk < plain.chunkLengthVec().size(); ++chunk) {
+            for (int offset = plain.chunkOffsetVec()[chunk];
+                 offset < plain.chunkOffsetVec()[chunk + 1];
+                 offset += C) {
+                const int *expectedColumns = plain.columnChunk(chunk, offset, &plainScratch);
+                const double *expectedValues = plain.valueChunk(chunk, offset, &plainScratch);
+                const int *actualColumns = matrixFree.columnChunk(chunk, offset, &freeScratch);
+                const double *actualValues = matrixFree.valueChunk(chunk, offset, &freeScratch);
+
+                for (int i = 0; i < C; ++i) {
+                    TS_ASSERT_EQUALS(expectedColumns[i], actualColumns[i]);
+                    TS_ASSERT_EQUALS(expectedValues[i], actualValues[i]);
+                }
+            }
+        }
+#endif
+    }
+
+    void testChunkRowsAreDecodedOnce()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int C = 4;
+        int counter = 0;
+        typedef SellCSigmaMatrixFreeContainer<double, C, CountingLaplacianWeights> MatrixFree;
+        MatrixFree matrixFree(10, CountingLaplacianWeights(10, &counter));
+        MatrixFree::ScratchSpace scratch;
+
+        int offset = matrixFree.chunkOffsetVec()[1] + C;
+        const int *columns = matrixFree.columnChunk(1, offset, &scratch);
+        const double *values = matrixFree.valueChunk(1, offset, &scratch);
+        TS_ASSERT_EQUALS(C, counter);
+        TS_ASSERT_EQUALS(4, columns[0]);
+        TS_ASSERT_EQUALS(2.0, values[0]);
+
+        // single entries are decoded separately:
+        counter = 0;
+        offset += C;
+        TS_ASSERT_EQUALS(6, *matrixFree.columnEntry(1, offset, 1, &scratch));
+        TS_ASSERT_EQUALS(-1.0, *matrixFree.valueEntry(1, offset, 1, &scratch));
+        TS_ASSERT_EQUALS(1, counter);
+
+        TS_ASSERT_EQUALS(7, *matrixFree.columnEntry(1, offset, 2, &scratch));
+        TS_ASSERT_EQUALS(2, counter);
+
+        // entries of a decoded chunk row are available right away:
+        matrixFree.columnChunk(1, offset, &scratch);
+        TS_ASSERT_EQUALS(2 + C, counter);
+        TS_ASSERT_EQUALS(8, *matrixFree.columnEntry(1, offset, 3, &scratch));
+        TS_ASSERT_EQUALS(2 + C, counter);
+#endif
+    }
+
+    void testInitFromMatrix()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 10;
+        SellCSigmaMatrixFreeContainer<double, 4, LaplacianWeights> matrixFree(DIM, LaplacianWeights(DIM));
+
+        // rows missing in the matrix are treated as empty, just like
+        // ReorderingUnstructuredGrid prunes them:
+        std::vector<std::pair<Coord<2>, double> > matrix;
+        for (int i = 1; i < DIM; ++i) {
+            matrix << std::make_pair(Coord<2>(i, i - 1), -1.0);
+            matrix << std::make_pair(Coord<2>(i, i), 2.0);
+            if (i < (DIM - 1)) {
+                matrix << std::make_pair(Coord<2>(i, i + 1), -1.0);
+            }
+        }
+        matrixFree.initFromMatrix(matrix);
+
+        TS_ASSERT_EQUALS(0, matrixFree.rowLengthVec()[0]);
+        TS_ASSERT_EQUALS(3, matrixFree.rowLengthVec()[1]);
+        TS_ASSERT_EQUALS(2, matrixFree.rowLengthVec()[9]);
+        TS_ASSERT_EQUALS(std::size_t(0), matrixFree.getRow(0).size());
+
+        std::vector<int> expectedChunkOffsets;
+        expectedChunkOffsets << 0 << 12 << 24 << 36;
+        TS_ASSERT_EQUALS(expectedChunkOffsets, matrixFree.chunkOffsetVec());
+
+        // the matrix needs to match the functor's sparsity pattern:
+        matrix << std::make_pair(Coord<2>(5, 9), 1.0);
+        TS_ASSERT_THROWS(matrixFree.initFromMatrix(matrix), std::invalid_argument&);
+#endif
+    }
+};
+
+}
@@ -0,0 +1,75 @@
+#include <cxxtest/TestSuite.h>
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/misc/hardwaretopology.h>
+#include <libgeodecomp/storage/shortvecswitch.h>
+
+#include <libflatarray/aligned_allocator.hpp>
+
+#include <limits>
+#include <typeinfo>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class ShortVecSwitchTest : public CxxTest::TestSuite
+{
+public:
+    void testSelection()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef LibFlatArray::short_vec<double, 8> Cached;
+        typedef LibFlatArray::streaming_short_vec<double, 8> Streaming;
+        std::size_t cacheSize = HardwareTopology::local().lastLevelCacheSize();
+
+        bool streaming = true;
+        shortVecSwitch<double, 8>(cacheSize, [&streaming](auto vec) {
+                streaming = (typeid(vec) == typeid(Streaming));
+            });
+        TS_ASSERT(!streaming);
+
+        shortVecSwitch<double, 8>(std::numeric_limits<std::size_t>::max(), [&streaming](auto vec) {
+                streaming = (typeid(vec) == typeid(Streaming));
+            });
+        TS_ASSERT(streaming);
+
+        bool cached = false;
+        shortVecSwitch<double, 8>(1, [&cached](auto vec) {
+                cached = (typeid(vec) == typeid(Cached));
+            });
+        TS_ASSERT(cached);
+#endif
+    }
+
+    void testStores()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        // both variants need to produce the same results:
+        std::size_t sizes[] = { 1, std::numeric_limits<std::size_t>::max() };
+
+        for (int i = 0; i < 2; ++i) {
+            std::vector<double, LibFlatArray::aligned_allocator<double, 64> > source(64);
+            std::vector<double, LibFlatArray::aligned_allocator<double, 64> > target(64, -1);
+            for (int j = 0; j < 64; ++j) {
+                source[j] = j;
+            }
+
+            shortVecSwitch<double, 8>(sizes[i], [&source, &target](auto vec) {
+                    typedef decltype(vec) ShortVec;
+                    for (int j = 0; j < 64; j += 8) {
+                        ShortVec buf = &source[j];
+                        buf *= 2.0;
+                        buf.store(&target[j]);
+                    }
+                });
+
+            for (int j = 0; j < 64; ++j) {
+                TS_ASSERT_EQUALS(2.0 * j, target[j]);
+            }
+        }
+#endif
+    }
+};
+
+}
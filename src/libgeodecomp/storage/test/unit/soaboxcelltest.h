@@ -0,0 +1,318 @@
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/storage/grid.h>
+#include <libgeodecomp/storage/serializationbuffer.h>
+#include <libgeodecomp/storage/soaboxcell.h>
+#include <libgeodecomp/storage/updatefunctor.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+/**
+ * Counts all particles within a certain distance, just like
+ * SimpleParticle in boxcelltest.h, but updates all particles of a
+ * box at once.
+ */
+class SoAParticle
+{
+public:
+    class API : public APITraits::HasCubeTopology<2>
+    {};
+
+    explicit SoAParticle(
+        const FloatCoord<2>& pos = FloatCoord<2>(),
+        const double positionFactor = 1.0,
+        const double maxDistance = 0,
+        const int id = 0) :
+        posX(pos[0]),
+        posY(pos[1]),
+        positionFactor(positionFactor),
+        maxDistance2(maxDistance * maxDistance),
+        neighbors(0),
+        id(id)
+    {}
+
+    template<typename CONTAINER, typename NEIGHBORS>
+    static void updateBox(CONTAINER& particles, const NEIGHBORS& hood, int /* nanoStep */)
+    {
+        int size = particles.size();
+        double *posX = &particles[0].posX();
+        double *posY = &particles[0].posY();
+        const double *positionFactor = &particles[0].positionFactor();
+        const double *maxDistance2 = &particles[0].maxDistance2();
+        int *neighbors = &particles[0].neighbors();
+
+        for (int i = 0; i < size; ++i) {
+            neighbors[i] = 0;
+        }
+
+        for (std::size_t n = 0; n < hood.size(); ++n) {
+            int otherSize = hood[n].size();
+            if (otherSize == 0) {
+                continue;
+            }
+
+            const double *otherPosX = &hood[n][0].posX();
+            const double *otherPosY = &hood[n][0].posY();
+
+            for (int i = 0; i < size; ++i) {
+                for (int j = 0; j < otherSize; ++j) {
+                    double deltaX = otherPosX[j] - posX[i];
+                    double deltaY = otherPosY[j] - posY[i];
+                    neighbors[i] += ((deltaX * deltaX + deltaY * deltaY) < maxDistance2[i]);
+                }
+            }
+        }
+
+        for (int i = 0; i < size; ++i) {
+            posX[i] *= positionFactor[i];
+            posY[i] *= positionFactor[i];
+        }
+    }
+
+    double posX;
+    double posY;
+    double positionFactor;
+    double maxDistance2;
+    int neighbors;
+    int id;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    SoAParticle,
+    ((double)(posX))
+    ((double)(posY))
+    ((double)(positionFactor))
+    ((double)(maxDistance2))
+    ((int)(neighbors))
+    ((int)(id)))
+
+namespace LibGeoDecomp {
+
+class SoABoxCellTest : public CxxTest::TestSuite
+{
+public:
+    typedef SoABoxCell<SoAParticle, 30> CellType;
+
+    void setUp()
+    {
+        gridDim = Coord<2>(10, 5);
+        cellDim = FloatCoord<2>(2.0, 3.0);
+        box = CoordBox<2>(Coord<2>(0, 0), gridDim);
+        region.clear();
+        region << box;
+
+        grid1 = Grid<CellType>(gridDim);
+        grid2 = Grid<CellType>(gridDim);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            FloatCoord<2> origin00 = cellDim.scale(*i);
+            FloatCoord<2> origin01 = cellDim.scale(*i) + cellDim.scale(FloatCoord<2>(0.0, 0.5));
+            FloatCoord<2> origin10 = cellDim.scale(*i) + cellDim.scale(FloatCoord<2>(0.5, 0.0));
+            FloatCoord<2> origin11 = cellDim.scale(*i) + cellDim.scale(FloatCoord<2>(0.5, 0.5));
+
+            double posFactor = 0.95;
+            double maxDistance = 2.9;
+
+            grid1[*i] = CellType(origin00, cellDim);
+            grid1[*i].insert(SoAParticle(origin00, posFactor, maxDistance));
+            grid1[*i].insert(SoAParticle(origin01, posFactor, maxDistance));
+            grid1[*i].insert(SoAParticle(origin10, posFactor, maxDistance));
+            grid1[*i].insert(SoAParticle(origin11, posFactor, maxDistance));
+        }
+    }
+
+    void testInsertAndRemove()
+    {
+        CellType cell;
+        for (int i = 0; i < 5; ++i) {
+            cell << SoAParticle(FloatCoord<2>(i, i), 1.0, 0.0, i);
+        }
+        TS_ASSERT_EQUALS(std::size_t(5), cell.size());
+
+        // removal moves the last particle into the gap:
+        cell.remove(1);
+        TS_ASSERT_EQUALS(std::size_t(4), cell.size());
+        TS_ASSERT_EQUALS(0, cell[0].id);
+        TS_ASSERT_EQUALS(4, cell[1].id);
+        TS_ASSERT_EQUALS(2, cell[2].id);
+        TS_ASSERT_EQUALS(3, cell[3].id);
+        TS_ASSERT_EQUALS(4.0, cell[1].posX);
+
+        cell.remove(3);
+        TS_ASSERT_EQUALS(std::size_t(3), cell.size());
+        TS_ASSERT_EQUALS(0, cell[0].id);
+        TS_ASSERT_EQUALS(4, cell[1].id);
+        TS_ASSERT_EQUALS(2, cell[2].id);
+    }
+
+    void testBasic2D()
+    {
+        UpdateFunctor<CellType>()(
+            region,
+            Coord<2>(),
+            Coord<2>(),
+            grid1,
+            &grid2,
+            0);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(grid2[*i].size(), std::size_t(4));
+        }
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            for (int j = 0; j < 4; ++j) {
+                // see BoxCellTest::testBasic2D() for the expected
+                // visibility of particles along the boundaries
+                int fieldDimX = 5;
+                int fieldDimY = 3;
+
+                if (i->x() == 0) {
+                    fieldDimX = ((j == 0) || (j == 1)) ? 3 : 4;
+                }
+
+                if (i->x() == (box.dimensions.x() - 1)) {
+                    fieldDimX = ((j == 0) || (j == 1)) ? 4 : 3;
+                }
+
+                if ((i->y() == 0) && ((j == 0) || (j == 2))) {
+                    fieldDimY = 2;
+                }
+
+                if ((i->y() == (box.dimensions.y() - 1)) && ((j == 1) || (j == 3))) {
+                    fieldDimY = 2;
+                }
+
+                int expected = fieldDimX * fieldDimY;
+                TS_ASSERT_EQUALS(grid2[*i][j].neighbors, expected);
+            }
+        }
+    }
+
+    void test2DCellTransport()
+    {
+        Coord<2> dim = box.dimensions;
+
+        UpdateFunctor<CellType>()(
+            region,
+            Coord<2>(),
+            Coord<2>(),
+            grid1,
+            &grid2,
+            0);
+
+        for (int y = 0; y < dim.y(); ++y) {
+            for (int x = 0; x < dim.x(); ++x) {
+                TS_ASSERT_EQUALS(grid2[Coord<2>(x, y)].size(), std::size_t(4));
+            }
+        }
+
+        UpdateFunctor<CellType>()(
+            region,
+            Coord<2>(),
+            Coord<2>(),
+            grid2,
+            &grid1,
+            0);
+
+        // particles on the left and upper cell boundaries have
+        // migrated to the corresponding neighbor cells:
+        std::size_t total = 0;
+        for (int y = 0; y < dim.y(); ++y) {
+            int fieldDimY = 2;
+            if (y == 0) {
+                fieldDimY = 3;
+            }
+            if (y == (dim.y() - 1)) {
+                fieldDimY = 1;
+            }
+
+            for (int x = 0; x < dim.x(); ++x) {
+                int fieldDimX = 2;
+                if (x == 0) {
+                    fieldDimX = 3;
+                }
+                if (x == (dim.x() - 1)) {
+                    fieldDimX = 1;
+                }
+
+                std::size_t expected = fieldDimX * fieldDimY;
+                TS_ASSERT_EQUALS(grid1[Coord<2>(x, y)].size(), expected);
+                total += grid1[Coord<2>(x, y)].size();
+            }
+        }
+
+        TS_ASSERT_EQUALS(std::size_t(4 * dim.prod()), total);
+    }
+
+    void testPackUnpack()
+    {
+        CellType source = grid1[Coord<2>(3, 2)];
+        source.remove(0);
+
+        std::vector<char> buffer(source.packedSize());
+        source.pack(&buffer[0]);
+        TS_ASSERT(buffer.size() < sizeof(CellType));
+
+        CellType target(FloatCoord<2>(-1, -1), FloatCoord<2>(-1, -1));
+        for (int i = 0; i < 10; ++i) {
+            target << SoAParticle(FloatCoord<2>(47, 11), 1.0, 1.0, 4711);
+        }
+
+        TS_ASSERT_EQUALS(buffer.size(), target.unpack(&buffer[0]));
+        TS_ASSERT_EQUALS(source.getOrigin(),     target.getOrigin());
+        TS_ASSERT_EQUALS(source.getDimensions(), target.getDimensions());
+        TS_ASSERT_EQUALS(std::size_t(3),         target.size());
+
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            TS_ASSERT_EQUALS(source[i].posX,           target[i].posX);
+            TS_ASSERT_EQUALS(source[i].posY,           target[i].posY);
+            TS_ASSERT_EQUALS(source[i].positionFactor, target[i].positionFactor);
+            TS_ASSERT_EQUALS(source[i].maxDistance2,   target[i].maxDistance2);
+        }
+    }
+
+    void testSaveLoadRegion()
+    {
+        grid1[Coord<2>(2, 1)].remove(0);
+        grid1[Coord<2>(3, 1)] = CellType(FloatCoord<2>(6, 3), cellDim);
+
+        Region<2> fragment;
+        fragment << Streak<2>(Coord<2>(1, 1), 5)
+                 << Streak<2>(Coord<2>(7, 3), 9);
+
+        std::vector<char> buffer;
+        grid1.saveRegion(&buffer, fragment);
+        TS_ASSERT_LESS_THAN(buffer.size(), SerializationBuffer<CellType>::storageSize(fragment));
+
+        // cells are restored at a translated location:
+        Coord<2> offset(1, 1);
+        grid2.loadRegion(buffer, fragment, offset);
+
+        for (Region<2>::Iterator i = fragment.begin(); i != fragment.end(); ++i) {
+            const CellType& expected = grid1[*i];
+            const CellType& actual   = grid2[*i + offset];
+
+            TS_ASSERT_EQUALS(expected.getOrigin(), actual.getOrigin());
+            TS_ASSERT_EQUALS(expected.size(),      actual.size());
+            for (std::size_t j = 0; j < expected.size(); ++j) {
+                TS_ASSERT_EQUALS(expected[j].posX, actual[j].posX);
+                TS_ASSERT_EQUALS(expected[j].posY, actual[j].posY);
+            }
+        }
+        TS_ASSERT_EQUALS(std::size_t(0), grid2[Coord<2>(4, 2)].size());
+
+        std::vector<char> emptyBuffer;
+        TS_ASSERT_THROWS(grid2.loadRegion(emptyBuffer, fragment), std::logic_error&);
+    }
+
+private:
+    Coord<2> gridDim;
+    FloatCoord<2> cellDim;
+    CoordBox<2> box;
+    Region<2> region;
+    Grid<CellType> grid1;
+    Grid<CellType> grid2;
+};
+
+}
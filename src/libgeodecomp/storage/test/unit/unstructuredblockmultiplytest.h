@@ -0,0 +1,217 @@
+#include <cxxtest/TestSuite.h>
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/storage/unstructuredblockmultiply.h>
+#include <libgeodecomp/storage/unstructuredlooppeeler.h>
+#include <libgeodecomp/storage/unstructuredsoagrid.h>
+#include <libgeodecomp/storage/unstructuredupdatefunctor.h>
+#include <libgeodecomp/storage/updatefunctor.h>
+
+#include <libflatarray/api_traits.hpp>
+#include <libflatarray/macros.hpp>
+#include <libflatarray/short_vec.hpp>
+
+using namespace LibGeoDecomp;
+using namespace LibFlatArray;
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+/**
+ * Computes BLOCK_SIZE independent SpMVs (one per array element of
+ * value/sum) with a single traversal of the weights.
+ */
+template<int BLOCK_SIZE, int SIGMA>
+class BlockUnstructuredSoATestCell
+{
+public:
+    typedef short_vec<double, 4> ShortVec;
+
+    class API :
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasSoA,
+        public APITraits::HasUnstructuredTopology,
+        public APITraits::HasPredefinedMPIDataType<double>,
+        public APITraits::HasSellType<double>,
+        public APITraits::HasSellMatrices<1>,
+        public APITraits::HasSellC<4>,
+        public APITraits::HasSellSigma<SIGMA>,
+        public APITraits::HasSellBlockSize<BLOCK_SIZE>,
+        public LibFlatArray::api_traits::has_default_1d_sizes
+    {};
+
+    inline
+    explicit BlockUnstructuredSoATestCell(double v = 0)
+    {
+        for (int k = 0; k < BLOCK_SIZE; ++k) {
+            value[k] = v * (k + 1);
+            sum[k] = 0;
+        }
+    }
+
+    template<typename HOOD_NEW, typename HOOD_OLD>
+    static void updateLineX(HOOD_NEW& hoodNew, int indexEnd, HOOD_OLD& hoodOld, unsigned /* nanoStep */)
+    {
+        const long strideOld = HOOD_OLD::SoAAccessor::DIM_PROD;
+        const long strideNew = HOOD_NEW::SoAAccessor::DIM_PROD;
+
+        const double *sources[BLOCK_SIZE];
+        for (int k = 0; k < BLOCK_SIZE; ++k) {
+            sources[k] = &hoodOld->template value<0>() + k * strideOld;
+        }
+
+        unstructuredLoopPeeler<ShortVec>(
+            &hoodNew.index(),
+            indexEnd,
+            hoodOld,
+            [&hoodNew, &sources, strideNew](auto REAL, auto *counter, const auto& end, auto& hoodOld) {
+                typedef decltype(REAL) ShortVec;
+                for (; hoodNew.index() < end; hoodNew += ShortVec::ARITY) {
+                    ShortVec accumulators[BLOCK_SIZE];
+                    for (int k = 0; k < BLOCK_SIZE; ++k) {
+                        accumulators[k] = 0.0;
+                    }
+
+                    unstructuredBlockMultiply(hoodOld, sources, accumulators);
+
+                    for (int k = 0; k < BLOCK_SIZE; ++k) {
+                        (&hoodNew->template sum<0>() + k * strideNew) << accumulators[k];
+                    }
+                    ++hoodOld;
+                }
+            });
+    }
+
+    inline bool operator==(const BlockUnstructuredSoATestCell& cell) const
+    {
+        for (int k = 0; k < BLOCK_SIZE; ++k) {
+            if (cell.sum[k] != sum[k]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline bool operator!=(const BlockUnstructuredSoATestCell& cell) const
+    {
+        return !(*this == cell);
+    }
+
+    double value[BLOCK_SIZE];
+    double sum[BLOCK_SIZE];
+};
+
+// the macro can't handle commas in the cell type:
+typedef BlockUnstructuredSoATestCell<1,  1> BlockUnstructuredSoATestCell1;
+typedef BlockUnstructuredSoATestCell<3,  1> BlockUnstructuredSoATestCell3;
+typedef BlockUnstructuredSoATestCell<4, 60> BlockUnstructuredSoATestCell4;
+
+LIBFLATARRAY_REGISTER_SOA(BlockUnstructuredSoATestCell1, ((double)(sum)(1))((double)(value)(1)))
+LIBFLATARRAY_REGISTER_SOA(BlockUnstructuredSoATestCell3, ((double)(sum)(3))((double)(value)(3)))
+LIBFLATARRAY_REGISTER_SOA(BlockUnstructuredSoATestCell4, ((double)(sum)(4))((double)(value)(4)))
+
+#endif
+
+namespace LibGeoDecomp {
+
+class UnstructuredBlockMultiplyTest : public CxxTest::TestSuite
+{
+public:
+    void testBlockSizeSelection()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        TS_ASSERT_EQUALS(1, APITraits::SelectSellBlockSize<TestCell<1> >::VALUE);
+        TS_ASSERT_EQUALS(3, (APITraits::SelectSellBlockSize<BlockUnstructuredSoATestCell<3, 1> >::VALUE));
+        TS_ASSERT_EQUALS(4, (APITraits::SelectSellBlockSize<BlockUnstructuredSoATestCell<4, 60> >::VALUE));
+#endif
+    }
+
+    void testBlockSizeOne()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        checkBlock<1, 1>();
+#endif
+    }
+
+    void testBlockSizeThree()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        checkBlock<3, 1>();
+#endif
+    }
+
+    void testBlockSizeFourWithSIGMA()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        checkBlock<4, 60>();
+#endif
+    }
+
+private:
+#ifdef LIBGEODECOMP_WITH_CPP14
+    template<int BLOCK_SIZE, int SIGMA>
+    void checkBlock()
+    {
+        typedef BlockUnstructuredSoATestCell<BLOCK_SIZE, SIGMA> TestCellType;
+        const int DIM = 150;
+        CoordBox<1> dim(Coord<1>(0), Coord<1>(DIM));
+        Region<1> boundingRegion;
+        boundingRegion << dim;
+
+        TestCellType defaultCell(200);
+        TestCellType edgeCell(-1);
+
+        typedef ReorderingUnstructuredGrid<UnstructuredSoAGrid<TestCellType, 1, double, 4, SIGMA> > GridType;
+        GridType gridOld(boundingRegion, defaultCell, edgeCell);
+        GridType gridNew(boundingRegion, defaultCell, edgeCell);
+
+        for (int i = 0; i < DIM; ++i) {
+            gridOld.set(Coord<1>(i), TestCellType(2000 + i));
+        }
+
+        // lower triangular matrix with weights row + col * 10:
+        typename GridType::SparseMatrix matrix;
+        for (int row = 0; row < DIM; ++row) {
+            for (int col = 0; col < row; ++col) {
+                matrix << std::make_pair(Coord<2>(row, col), row + col * 10);
+            }
+        }
+        gridOld.setWeights(0, matrix);
+        gridNew.setWeights(0, matrix);
+
+        // mix of Streaks which do/don't start/end on chunk boundaries:
+        Region<1> region;
+        region << Streak<1>(Coord<1>(10),   30);
+        region << Streak<1>(Coord<1>(37),   60);
+        region << Streak<1>(Coord<1>(64),   80);
+        region << Streak<1>(Coord<1>(100), 149);
+        Region<1> updateRegion = gridOld.remapRegion(region);
+
+        UnstructuredUpdateFunctor<TestCellType> functor;
+        UpdateFunctorHelpers::ConcurrencyNoP concurrencySpec;
+        typename APITraits::SelectThreadedUpdate<TestCellType>::Value modelThreadingSpec;
+
+        functor(updateRegion, gridOld, &gridNew, 0, concurrencySpec, modelThreadingSpec);
+
+        for (Coord<1> coord(0); coord < Coord<1>(DIM); ++coord.x()) {
+            TestCellType cell = gridNew.get(coord);
+
+            for (int k = 0; k < BLOCK_SIZE; ++k) {
+                double expected = 0;
+                if (region.count(coord)) {
+                    for (int i = 0; i < coord.x(); ++i) {
+                        double weight = coord.x() + i * 10;
+                        expected += weight * (2000 + i) * (k + 1);
+                    }
+                }
+
+                TS_ASSERT_EQUALS(expected, cell.sum[k]);
+            }
+        }
+    }
+#endif
+};
+
+}
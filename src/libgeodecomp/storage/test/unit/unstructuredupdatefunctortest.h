@@ -2,6 +2,9 @@
 
 #include <libgeodecomp/config.h>
 #include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/storage/sellcsigmadeltacolumncontainer.h>
+#include <libgeodecomp/storage/sellcsigmadictionarycontainer.h>
+#include <libgeodecomp/storage/sellcsigmamatrixfreecontainer.h>
 #include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 #include <libgeodecomp/storage/unstructuredgrid.h>
@@ -156,6 +159,25 @@ public:
 
 LIBFLATARRAY_REGISTER_SOA(SimpleUnstructuredSoATestCell<1 >, ((double)(sum))((double)(value)))
 LIBFLATARRAY_REGISTER_SOA(SimpleUnstructuredSoATestCell<60>, ((double)(sum))((double)(value)))
+
+/**
+ * Matrix-free equivalent of the lower triangular matrix used in
+ * testSoA() below.
+ */
+class TriangularTestWeights
+{
+public:
+    int rowLength(int row) const
+    {
+        return row;
+    }
+
+    void operator()(int row, int element, int *column, double *weight) const
+    {
+        *column = element;
+        *weight = row + element * 10;
+    }
+};
 #endif
 
 namespace LibGeoDecomp {
@@ -443,6 +465,31 @@ public:
 #endif
     }
 
+    void testSoAWithDeltaColumnContainer()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef SellCSigmaDeltaColumnContainer<double, 4, 1> MatrixType;
+        checkSoAWithMatrixType<MatrixType>(true);
+#endif
+    }
+
+    void testSoAWithDictionaryContainer()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef SellCSigmaDictionaryContainer<double, 4, 1> MatrixType;
+        checkSoAWithMatrixType<MatrixType>(true);
+#endif
+    }
+
+    void testSoAWithMatrixFreeContainer()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef SellCSigmaMatrixFreeContainer<double, 4, TriangularTestWeights> MatrixType;
+        checkSoAWithMatrixType<MatrixType>(true);
+        checkSoAWithMatrixType<MatrixType>(false);
+#endif
+    }
+
     void testSoAWithSIGMA()
     {
 #ifdef LIBGEODECOMP_WITH_CPP14
@@ -508,6 +555,76 @@ public:
         }
 #endif
     }
+
+private:
+#ifdef LIBGEODECOMP_WITH_CPP14
+    /**
+     * Same as testSoA(), but with the weights stored in (or computed
+     * by) the given container. The container is either set up from a
+     * SparseMatrix (like Initializers do) or installed directly.
+     */
+    template<typename MATRIX_TYPE>
+    void checkSoAWithMatrixType(bool fromSparseMatrix)
+    {
+        const int DIM = 150;
+        CoordBox<1> dim(Coord<1>(0), Coord<1>(DIM));
+        Region<1> boundingRegion;
+        boundingRegion << dim;
+
+        typedef SimpleUnstructuredSoATestCell<1> TestCellType;
+        TestCellType defaultCell(200);
+        TestCellType edgeCell(-1);
+
+        typedef ReorderingUnstructuredGrid<UnstructuredSoAGrid<TestCellType, 1, double, 4, 1, MATRIX_TYPE> > GridType;
+        GridType gridOld(boundingRegion, defaultCell, edgeCell);
+        GridType gridNew(boundingRegion, defaultCell, edgeCell);
+
+        for (int i = 0; i < DIM; ++i) {
+            gridOld.set(Coord<1>(i), TestCellType(2000 + i));
+        }
+
+        if (fromSparseMatrix) {
+            typename GridType::SparseMatrix matrix;
+            for (int row = 0; row < DIM; ++row) {
+                for (int col = 0; col < row; ++col) {
+                    matrix << std::make_pair(Coord<2>(row, col), row + col * 10);
+                }
+            }
+            gridOld.setWeights(0, matrix);
+            gridNew.setWeights(0, matrix);
+        } else {
+            MATRIX_TYPE container(DIM);
+            gridOld.setWeights(0, container);
+            gridNew.setWeights(0, container);
+        }
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>(10),   30);
+        region << Streak<1>(Coord<1>(37),   60);
+        region << Streak<1>(Coord<1>(64),   80);
+        region << Streak<1>(Coord<1>(100), 149);
+        region = gridOld.remapRegion(region);
+
+        UnstructuredUpdateFunctor<TestCellType> functor;
+        UpdateFunctorHelpers::ConcurrencyNoP concurrencySpec;
+        typename APITraits::SelectThreadedUpdate<TestCellType>::Value modelThreadingSpec;
+
+        functor(region, gridOld, &gridNew, 0, concurrencySpec, modelThreadingSpec);
+
+        for (Coord<1> coord(0); coord < Coord<1>(150); ++coord.x()) {
+            if (region.count(coord)) {
+                double sum = 0;
+                for (int i = 0; i < coord.x(); ++i) {
+                    double weight = coord.x() + i * 10;
+                    sum += weight * (2000 + i);
+                }
+                TS_ASSERT_EQUALS(sum, gridNew.get(coord).sum);
+            } else {
+                TS_ASSERT_EQUALS(0.0, gridNew.get(coord).sum);
+            }
+        }
+    }
+#endif
 };
 
 }
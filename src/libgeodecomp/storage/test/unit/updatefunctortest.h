@@ -1,7 +1,11 @@
+#include <atomic>
 #include <sstream>
+#include <thread>
 #include <vector>
 #include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/allocationcounter.h>
 #include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/misc/chronometer.h>
 #include <libgeodecomp/misc/testhelper.h>
 #include <libgeodecomp/storage/grid.h>
 #include <libgeodecomp/storage/soagrid.h>
@@ -123,6 +127,60 @@ public:
     bool alive;
 };
 
+class FineGrainedCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasThreadedUpdate<4>,
+        public APITraits::HasCubeTopology<2>
+    {};
+
+    explicit FineGrainedCell(int counter = 0) :
+        counter(counter)
+    {}
+
+    template<typename NEIGHBORHOOD>
+    void update(const NEIGHBORHOOD& hood, int nanoStep)
+    {
+        counter = hood[FixedCoord<0, 0>()].counter + 1;
+    }
+
+    int counter;
+};
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+class SelfThreadingCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasThreadedUpdate<4, APITraits::TrueType>,
+        public APITraits::HasCubeTopology<2>
+    {};
+
+    explicit SelfThreadingCell(int counter = 0) :
+        counter(counter)
+    {}
+
+    template<typename NEIGHBORHOOD>
+    void update(const NEIGHBORHOOD& hood, int nanoStep)
+    {
+        counter = hood[FixedCoord<0, 0>()].counter + 1;
+        if (std::this_thread::get_id() != mainThread) {
+            ++foreignUpdates;
+        }
+    }
+
+    int counter;
+    static std::thread::id mainThread;
+    static std::atomic<int> foreignUpdates;
+};
+
+std::thread::id SelfThreadingCell::mainThread;
+std::atomic<int> SelfThreadingCell::foreignUpdates(0);
+#endif
+
 LIBFLATARRAY_REGISTER_SOA(MySoATestCellWithDoubleAndBool, ((double)(temp))((bool)(alive)))
 
 namespace LibGeoDecomp {
@@ -147,6 +205,38 @@ public:
     }
 };
 
+#ifdef LIBGEODECOMP_WITH_THREADS
+template<class STENCIL>
+class UpdateFunctorThreadPoolTestHelper : public UpdateFunctorTestBase<STENCIL>
+{
+public:
+    using UpdateFunctorTestBase<STENCIL>::DIM;
+    typedef typename UpdateFunctorTestBase<STENCIL>::TestCellType TestCellType;
+    typedef typename UpdateFunctorTestBase<STENCIL>::GridType GridType;
+    typedef UpdateFunctorHelpers::ConcurrencyEnableThreadPool ConcurrencySpec;
+
+    UpdateFunctorThreadPoolTestHelper(WorkStealingPool *pool, bool fineGrained) :
+        pool(pool),
+        fineGrained(fineGrained)
+    {}
+
+    virtual void callFunctor(
+        const Region<DIM>& region,
+        const GridType& gridOld,
+        GridType *gridNew,
+        unsigned nanoStep)
+    {
+        UpdateFunctor<TestCellType, ConcurrencySpec>()(
+            region, Coord<DIM>(), Coord<DIM>(), gridOld, gridNew, nanoStep,
+            ConcurrencySpec(false, fineGrained, pool));
+    }
+
+private:
+    WorkStealingPool *pool;
+    bool fineGrained;
+};
+#endif
+
 
 class UpdateFunctorTest : public CxxTest::TestSuite
 {
@@ -256,6 +346,161 @@ public:
         }
     }
 
+    void testSteadyStateIsAllocationFree()
+    {
+        // without tracking no allocations would be counted and the
+        // test would pass vacuously:
+#if defined(LIBGEODECOMP_WITH_THREADS) && defined(LIBGEODECOMP_WITH_ALLOCATION_TRACKING)
+        using std::swap;
+        typedef Grid<FineGrainedCell, Topologies::Cube<2>::Topology> GridType;
+        typedef UpdateFunctorHelpers::ConcurrencyEnableOpenMP ConcurrencySpec;
+
+        Coord<2> dim(64, 32);
+        GridType gridA(dim);
+        GridType gridB(dim);
+        GridType *gridOld = &gridA;
+        GridType *gridNew = &gridB;
+
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(1, 1), Coord<2>(62, 30));
+        Chronometer chrono;
+
+        for (int t = 0; t < 10; ++t) {
+            if (t == 2) {
+                // warmup complete, scratch buffers should be sized:
+                AllocationCounter::reset();
+            }
+
+            TimeCompute timer(&chrono);
+            UpdateFunctor<FineGrainedCell, ConcurrencySpec>()(
+                region, Coord<2>(), Coord<2>(), *gridOld, gridNew, 0, ConcurrencySpec(true, true));
+            swap(gridOld, gridNew);
+        }
+
+        TS_ASSERT_EQUALS(10, gridOld->get(Coord<2>(10, 10)).counter);
+        TS_ASSERT_EQUALS(std::size_t(0), AllocationCounter::phaseAllocations<TimeCompute>());
+#endif
+    }
+
+    void testThreadPool()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        WorkStealingPool pool(3);
+        for (int fineGrained = 0; fineGrained < 2; ++fineGrained) {
+            UpdateFunctorThreadPoolTestHelper<Stencils::Moore<2, 1> >(&pool, fineGrained).testSimple(3);
+            UpdateFunctorThreadPoolTestHelper<Stencils::Moore<2, 1> >(&pool, fineGrained).testSplittedTraversal(3);
+            UpdateFunctorThreadPoolTestHelper<Stencils::VonNeumann<3, 1> >(&pool, fineGrained).testSimple(3);
+            UpdateFunctorThreadPoolTestHelper<Stencils::VonNeumann<3, 1> >(&pool, fineGrained).testSplittedTraversal(3);
+        }
+#endif
+    }
+
+    void testThreadPoolStructOfArraysTestCell()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        using std::swap;
+        typedef TestCellSoA TestCellType;
+        typedef SoAGrid<TestCellType, Topologies::Cube<3>::Topology> GridType;
+        typedef UpdateFunctorHelpers::ConcurrencyEnableThreadPool ConcurrencySpec;
+
+        WorkStealingPool pool(3);
+        int nanoSteps = TestCellType::NANO_STEPS;
+        Coord<3> dim(70, 15, 5);
+        CoordBox<3> box(Coord<3>(), dim);
+
+        TestInitializer<TestCellType> init(dim);
+        GridType gridA(box);
+        init.grid(&gridA);
+        GridType gridB = gridA;
+
+        Region<3> region;
+        region << gridA.boundingBox();
+
+        GridType *gridOld = &gridA;
+        GridType *gridNew = &gridB;
+
+        for (int t = 0; t < 4; ++t) {
+            // alternate between coarse and fine grained splits:
+            ConcurrencySpec spec(false, t % 2, &pool);
+
+            for (int s = 0; s < nanoSteps; ++s) {
+                UpdateFunctor<TestCellType, ConcurrencySpec>()(
+                    region, Coord<3>(), Coord<3>(), *gridOld, gridNew, s, spec);
+                int cycle = (init.startStep() + t) * TestCellType::NANO_STEPS + s;
+
+                TS_ASSERT_TEST_GRID2(GridType, *gridOld, cycle, );
+                cycle += 1;
+                TS_ASSERT_TEST_GRID2(GridType, *gridNew, cycle, );
+
+                swap(gridOld, gridNew);
+            }
+        }
+#endif
+    }
+
+    void testThreadPoolLeavesSelfThreadingModelsAlone()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        using std::swap;
+        typedef Grid<SelfThreadingCell, Topologies::Cube<2>::Topology> GridType;
+        typedef UpdateFunctorHelpers::ConcurrencyEnableThreadPool ConcurrencySpec;
+
+        WorkStealingPool pool(3);
+        Coord<2> dim(64, 32);
+        GridType gridA(dim);
+        GridType gridB(dim);
+        GridType *gridOld = &gridA;
+        GridType *gridNew = &gridB;
+
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(1, 1), Coord<2>(62, 30));
+        SelfThreadingCell::mainThread = std::this_thread::get_id();
+        SelfThreadingCell::foreignUpdates = 0;
+
+        for (int t = 0; t < 4; ++t) {
+            UpdateFunctor<SelfThreadingCell, ConcurrencySpec>()(
+                region, Coord<2>(), Coord<2>(), *gridOld, gridNew, 0, ConcurrencySpec(false, true, &pool));
+            swap(gridOld, gridNew);
+        }
+
+        TS_ASSERT_EQUALS(4, gridOld->get(Coord<2>(10, 10)).counter);
+        TS_ASSERT_EQUALS(0, SelfThreadingCell::foreignUpdates.load());
+#endif
+    }
+
+    void testThreadPoolWithFineGrainedCell()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        using std::swap;
+        typedef Grid<FineGrainedCell, Topologies::Cube<2>::Topology> GridType;
+        typedef UpdateFunctorHelpers::ConcurrencyEnableThreadPool ConcurrencySpec;
+
+        Coord<2> dim(64, 32);
+        GridType gridA(dim);
+        GridType gridB(dim);
+        GridType *gridOld = &gridA;
+        GridType *gridNew = &gridB;
+
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(1, 1), Coord<2>(62, 30));
+
+        // the global pool is used by default:
+        for (int t = 0; t < 10; ++t) {
+            UpdateFunctor<FineGrainedCell, ConcurrencySpec>()(
+                region, Coord<2>(), Coord<2>(), *gridOld, gridNew, 0, ConcurrencySpec(false, true));
+            swap(gridOld, gridNew);
+        }
+
+        for (int y = 0; y < dim.y(); ++y) {
+            for (int x = 0; x < dim.x(); ++x) {
+                Coord<2> c(x, y);
+                int expected = region.count(c) ? 10 : 0;
+                TS_ASSERT_EQUALS(expected, gridOld->get(c).counter);
+            }
+        }
+#endif
+    }
+
 private:
     template<typename CELL>
     void checkSelector(const std::string& line, int repeats)
@@ -0,0 +1,140 @@
+#include <libgeodecomp/geometry/floatcoord.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/verletlist.h>
+
+#include <cxxtest/TestSuite.h>
+#include <vector>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class VerletListTest : public CxxTest::TestSuite
+{
+public:
+    class Particle
+    {
+    public:
+        explicit Particle(const FloatCoord<1>& pos = FloatCoord<1>()) :
+            pos(pos)
+        {}
+
+        const FloatCoord<1>& getPos() const
+        {
+            return pos;
+        }
+
+        FloatCoord<1> pos;
+    };
+
+    typedef std::vector<Particle> Container;
+    typedef VerletList<1> VerletListType;
+
+    void setUp()
+    {
+        // three boxes of width 2.0, left to right:
+        containers.resize(3);
+        containers[0].clear();
+        containers[1].clear();
+        containers[2].clear();
+
+        containers[0].push_back(Particle(FloatCoord<1>(0.5)));
+        containers[0].push_back(Particle(FloatCoord<1>(1.5)));
+        containers[1].push_back(Particle(FloatCoord<1>(2.2)));
+        containers[1].push_back(Particle(FloatCoord<1>(3.9)));
+        containers[2].push_back(Particle(FloatCoord<1>(4.1)));
+        containers[2].push_back(Particle(FloatCoord<1>(5.9)));
+
+        for (int i = 0; i < 3; ++i) {
+            containerPointers[i] = &containers[i];
+            listPointers[i] = &oldLists[i];
+        }
+    }
+
+    void testBuild()
+    {
+        VerletListType list;
+        TS_ASSERT(!list.isValid());
+        list.build(containers[1], containerPointers, listPointers, 1.0);
+        TS_ASSERT(list.isValid());
+
+        // particle at 2.2 sees 1.5 and itself:
+        std::vector<int> expected0;
+        expected0 << (0 + 3 * 1)
+                  << (1 + 3 * 0);
+        TS_ASSERT_EQUALS(expected0, std::vector<int>(list.begin(0), list.end(0)));
+
+        // particle at 3.9 sees itself and 4.1:
+        std::vector<int> expected1;
+        expected1 << (1 + 3 * 1)
+                  << (2 + 3 * 0);
+        TS_ASSERT_EQUALS(expected1, std::vector<int>(list.begin(1), list.end(1)));
+        TS_ASSERT_EQUALS(std::size_t(4), list.size());
+    }
+
+    void testNeighborhood()
+    {
+        VerletListType list;
+        list.build(containers[1], containerPointers, listPointers, 1.0);
+
+        typedef VerletListType::Neighborhood<Container, Container> Neighborhood;
+        Neighborhood hood(&containers[1], containerPointers, list.begin(1), list.end(1));
+
+        std::vector<double> positions;
+        for (Neighborhood::Iterator i = hood.begin(); i != hood.end(); ++i) {
+            positions << i->getPos()[0];
+        }
+
+        std::vector<double> expected;
+        expected << 3.9
+                 << 4.1;
+        TS_ASSERT_EQUALS(expected, positions);
+    }
+
+    void testRebuildCriteria()
+    {
+        double halfSkin = 0.25;
+        VerletListType list;
+        TS_ASSERT(list.needsRebuild(listPointers, halfSkin));
+
+        list.build(containers[1], containerPointers, listPointers, 1.0);
+        TS_ASSERT(!list.needsRebuild(listPointers, halfSkin));
+
+        // small movements accumulate...
+        Container moved = containers[2];
+        moved[1].pos[0] += 0.2;
+        oldLists[2].track(moved, containers[2], moved.size());
+        TS_ASSERT_DELTA(0.2, oldLists[2].getTravel(), 1e-9);
+        TS_ASSERT(!list.needsRebuild(listPointers, halfSkin));
+
+        // ...until they exceed half of the skin:
+        Container previous = moved;
+        moved[0].pos[0] -= 0.1;
+        oldLists[2].track(moved, previous, moved.size());
+        TS_ASSERT_DELTA(0.3, oldLists[2].getTravel(), 1e-9);
+        TS_ASSERT(list.needsRebuild(listPointers, halfSkin));
+
+        list.build(containers[1], containerPointers, listPointers, 1.0);
+        TS_ASSERT(!list.needsRebuild(listPointers, halfSkin));
+
+        // reordering any neighbor invalidates the list, too:
+        oldLists[0].markChanged();
+        TS_ASSERT(list.needsRebuild(listPointers, halfSkin));
+        oldLists[0].clearChanged();
+        TS_ASSERT(!list.needsRebuild(listPointers, halfSkin));
+
+        // new particles reset the travel:
+        moved.push_back(Particle(FloatCoord<1>(5.0)));
+        oldLists[2].track(moved, containers[2], containers[2].size());
+        TS_ASSERT(oldLists[2].hasChanged());
+        TS_ASSERT_EQUALS(0.0, oldLists[2].getTravel());
+    }
+
+private:
+    std::vector<Container> containers;
+    VerletListType oldLists[3];
+    const Container *containerPointers[3];
+    const VerletListType *listPointers[3];
+};
+
+}
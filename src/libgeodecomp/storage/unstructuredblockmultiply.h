@@ -0,0 +1,55 @@
+#ifndef LIBGEODECOMP_STORAGE_UNSTRUCTUREDBLOCKMULTIPLY_H
+#define LIBGEODECOMP_STORAGE_UNSTRUCTUREDBLOCKMULTIPLY_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <cstddef>
+
+namespace LibGeoDecomp {
+
+/**
+ * Multiplies the rows of the current chunk of the given adjacency
+ * matrix with HOOD::BLOCK_SIZE vectors at once (multi-vector or
+ * block SpMV). sources[k] needs to point to the first element of the
+ * k-th vector, typically a member of the old grid (e.g.
+ * &hoodOld->rhs()). Results are added to accumulators[k].
+ *
+ * Column indices and weights are loaded (or decoded, depending on
+ * the grid's MatrixType) only once per chunk row and are then reused
+ * for all vectors. This amortizes the matrix bandwidth over multiple
+ * right-hand sides or coupled scalar fields which live on the same
+ * mesh, compared to one traversal per vector. The block size is set
+ * via APITraits::HasSellBlockSize.
+ *
+ * HOOD may be either an UnstructuredSoANeighborhood or its scalar
+ * wrapper handed out by unstructuredLoopPeeler(), SHORT_VEC should
+ * be chosen accordingly. See the tests for a complete example.
+ */
+template<typename SHORT_VEC, typename HOOD, typename VALUE_TYPE>
+inline
+void unstructuredBlockMultiply(
+    HOOD& hood,
+    const VALUE_TYPE *const *sources,
+    SHORT_VEC *accumulators,
+    std::size_t matrixID = 0)
+{
+    const int blockSize = HOOD::BLOCK_SIZE;
+    SHORT_VEC weights;
+    SHORT_VEC values;
+
+    for (const auto& j: hood.weights(matrixID)) {
+        weights.load_aligned(j.second());
+        const int *columns = j.first();
+
+        for (int k = 0; k < blockSize; ++k) {
+            values.gather(sources[k], columns);
+            accumulators[k] += values * weights;
+        }
+    }
+}
+
+}
+
+#endif
+#endif
@@ -31,6 +31,7 @@ public:
     friend class ReorderingUnstructuredGridTest;
 
     typedef WEIGHT_TYPE WeightType;
+    typedef SellCSigmaSparseMatrixContainer<WEIGHT_TYPE, MY_C, MY_SIGMA> MatrixType;
     typedef typename GridBase<ELEMENT_TYPE, 1, WEIGHT_TYPE>::SparseMatrix SparseMatrix;
     typedef std::vector<std::pair<ELEMENT_TYPE, WEIGHT_TYPE> > NeighborList;
     typedef typename std::vector<std::pair<ELEMENT_TYPE, WEIGHT_TYPE> >::iterator NeighborListIterator;
@@ -288,6 +289,32 @@ public:
         return CoordBox<DIM>(Coord<DIM>(origin), dimension);
     }
 
+    void visit(const Region<DIM>& region, GridVisitor<ELEMENT_TYPE, DIM> *visitor)
+    {
+        std::vector<ELEMENT_TYPE> buffer;
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            if (containsStreak(*i)) {
+                visitor->visit(*i, &(*this)[i->origin]);
+            } else {
+                this->visitCopy(*i, visitor, &buffer);
+            }
+        }
+    }
+
+    void visit(const Region<DIM>& region, ConstGridVisitor<ELEMENT_TYPE, DIM> *visitor) const
+    {
+        std::vector<ELEMENT_TYPE> buffer;
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            if (containsStreak(*i)) {
+                visitor->visit(*i, &(*this)[i->origin]);
+            } else {
+                this->visitCopy(*i, visitor, &buffer);
+            }
+        }
+    }
+
     inline void saveRegion(std::vector<ELEMENT_TYPE> *buffer, const Region<DIM>& region, const Coord<1>& offset = Coord<DIM>()) const
     {
         saveRegion(
@@ -300,8 +327,16 @@ public:
     template<typename ITER1, typename ITER2>
     inline void saveRegion(std::vector<ELEMENT_TYPE> *buffer, const ITER1& start, const ITER2& end, int size) const
     {
-        ELEMENT_TYPE *target = buffer->data();
+        saveRegion(buffer->data(), start, end, size);
+    }
 
+    /**
+     * Same as above, but writes to raw memory, e.g. a section of a
+     * larger buffer.
+     */
+    template<typename ITER1, typename ITER2>
+    inline void saveRegion(ELEMENT_TYPE *target, const ITER1& start, const ITER2& end, int /* size */) const
+    {
         for (ITER1 i = start; i != end; ++i) {
             get(*i, target);
             target += i->length();
@@ -320,8 +355,12 @@ public:
     template<typename ITER1, typename ITER2>
     inline void loadRegion(const std::vector<ELEMENT_TYPE>& buffer, const ITER1& start, const ITER2& end, int size)
     {
-        const ELEMENT_TYPE *source = buffer.data();
+        loadRegion(buffer.data(), start, end, size);
+    }
 
+    template<typename ITER1, typename ITER2>
+    inline void loadRegion(const ELEMENT_TYPE *source, const ITER1& start, const ITER2& end, int /* size */)
+    {
         for (ITER1 i = start; i != end; ++i) {
             set(*i, source);
             source += i->length();
@@ -381,6 +420,11 @@ private:
     SellCSigmaSparseMatrixContainer<WEIGHT_TYPE, C, SIGMA> matrices[MATRICES];
     ELEMENT_TYPE edgeElement;
     Coord<DIM> dimension;
+
+    inline bool containsStreak(const Streak<DIM>& streak) const
+    {
+        return (streak.origin.x() >= origin) && (streak.endX <= (origin + dimension.x()));
+    }
 };
 
 template<typename _CharT, typename _Traits, typename ELEMENT_TYPE, std::size_t MATRICES, typename WEIGHT_TYPE, int C, int SIGMA>
@@ -17,6 +17,8 @@ public:
     typedef typename HOOD::ScalarIterator Iterator;
     typedef typename HOOD::SoAAccessor SoAAccessor;
 
+    static const int BLOCK_SIZE = HOOD::BLOCK_SIZE;
+
     inline
     WrappedNeighborhood(HOOD& hood) :
         hood(hood)
@@ -57,6 +59,9 @@ private:
     HOOD& hood;
 };
 
+template<typename HOOD>
+const int WrappedNeighborhood<HOOD>::BLOCK_SIZE;
+
 }
 
 /**
@@ -20,6 +20,7 @@
 #include <vector>
 #include <utility>
 #include <cassert>
+#include <stdexcept>
 
 namespace LibGeoDecomp {
 
@@ -113,13 +114,20 @@ private:
 
 /**
  * A unstructured grid for irregular structures using SoA memory layout.
+ *
+ * MATRIX_TYPE selects the storage backend for the edge weights. Next
+ * to the default SellCSigmaSparseMatrixContainer there are
+ * SellCSigmaDeltaColumnContainer, SellCSigmaDictionaryContainer and
+ * SellCSigmaMatrixFreeContainer, all of which are accessed through
+ * UnstructuredSoANeighborhood in the same way.
  */
 template<
     typename ELEMENT_TYPE,
     std::size_t MATRICES = 1,
     typename WEIGHT_TYPE = double,
     int MY_C = 64,
-    int MY_SIGMA = 1>
+    int MY_SIGMA = 1,
+    typename MATRIX_TYPE = SellCSigmaSparseMatrixContainer<WEIGHT_TYPE, MY_C, MY_SIGMA> >
 class UnstructuredSoAGrid : public GridBase<ELEMENT_TYPE, 1>
 {
 public:
@@ -130,6 +138,7 @@ public:
 
     typedef typename GridBase<ELEMENT_TYPE, 1>::SparseMatrix SparseMatrix;
     typedef WEIGHT_TYPE WeightType;
+    typedef MATRIX_TYPE MatrixType;
     typedef char StorageType;
     const static int DIM = 1;
     const static int SIGMA = MY_SIGMA;
@@ -150,8 +159,7 @@ public:
     {
         // init matrices
         for (std::size_t i = 0; i < MATRICES; ++i) {
-            matrices[i] =
-                SellCSigmaSparseMatrixContainer<WEIGHT_TYPE, C, SIGMA>(dimension.x());
+            matrices[i] = MatrixType(dimension.x());
         }
 
         // the grid size should be padded to the total number of chunks
@@ -191,15 +199,30 @@ public:
         matrices[matrixID].initFromMatrix(matrix);
     }
 
+    /**
+     * Installs a readily set up container, e.g. a
+     * SellCSigmaMatrixFreeContainer whose FUNCTOR carries state and
+     * can't be default constructed along with the grid.
+     */
     inline
-    const SellCSigmaSparseMatrixContainer<WEIGHT_TYPE, C, SIGMA>& getWeights(std::size_t const matrixID) const
+    void setWeights(std::size_t matrixID, const MatrixType& matrix)
+    {
+        assert(matrixID < MATRICES);
+        if (matrix.dim() != std::size_t(dimension.x())) {
+            throw std::invalid_argument("weights container doesn't match grid size");
+        }
+        matrices[matrixID] = matrix;
+    }
+
+    inline
+    const MatrixType& getWeights(std::size_t const matrixID) const
     {
         assert(matrixID < MATRICES);
         return matrices[matrixID];
     }
 
     inline
-    SellCSigmaSparseMatrixContainer<WEIGHT_TYPE, C, SIGMA>& getWeights(std::size_t const matrixID)
+    MatrixType& getWeights(std::size_t const matrixID)
     {
         assert(matrixID < MATRICES);
         return matrices[matrixID];
@@ -380,7 +403,17 @@ public:
     template<typename ITER1, typename ITER2>
     inline void saveRegion(std::vector<char> *target, const ITER1& start, const ITER2& end, int size) const
     {
-        elements.save(start, end, target->data(), size);
+        saveRegion(target->data(), start, end, size);
+    }
+
+    /**
+     * Same as above, but writes to raw memory, e.g. a section of a
+     * larger buffer. target needs to provide room for size cells.
+     */
+    template<typename ITER1, typename ITER2>
+    inline void saveRegion(char *target, const ITER1& start, const ITER2& end, int size) const
+    {
+        elements.save(start, end, target, size);
     }
 
     inline void loadRegion(const std::vector<char>& source, const Region<DIM>& region, const Coord<DIM>& offset = Coord<DIM>())
@@ -395,7 +428,13 @@ public:
     template<typename ITER1, typename ITER2>
     inline void loadRegion(const std::vector<char>& source, const ITER1& start, const ITER2& end, int size)
     {
-        elements.load(start, end, source.data(), size);
+        loadRegion(source.data(), start, end, size);
+    }
+
+    template<typename ITER1, typename ITER2>
+    inline void loadRegion(const char *source, const ITER1& start, const ITER2& end, int size)
+    {
+        elements.load(start, end, source, size);
     }
 
     template<typename ITER1, typename ITER2>
@@ -446,8 +485,7 @@ protected:
 private:
     LibFlatArray::soa_grid<ELEMENT_TYPE> elements;
     int origin;
-    // TODO wrapper for different types of sell c sigma containers
-    SellCSigmaSparseMatrixContainer<WEIGHT_TYPE, C, SIGMA> matrices[MATRICES];
+    MatrixType matrices[MATRICES];
     ELEMENT_TYPE edgeElement;
     Coord<DIM> dimension;
 
@@ -464,10 +502,10 @@ private:
     }
 };
 
-template<typename ELEMENT_TYPE, std::size_t MATRICES, typename WEIGHT_TYPE, int C, int SIGMA>
+template<typename ELEMENT_TYPE, std::size_t MATRICES, typename WEIGHT_TYPE, int C, int SIGMA, typename MATRIX_TYPE>
 inline
 std::ostream& operator<<(std::ostream& os,
-                         const UnstructuredSoAGrid<ELEMENT_TYPE, MATRICES, WEIGHT_TYPE, C, SIGMA>& grid)
+                         const UnstructuredSoAGrid<ELEMENT_TYPE, MATRICES, WEIGHT_TYPE, C, SIGMA, MATRIX_TYPE>& grid)
 {
     os << grid.toString();
     return os;
@@ -8,6 +8,7 @@
 #include <libflatarray/soa_accessor.hpp>
 
 #include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/storage/unstructuredsoagrid.h>
 
 #include <iterator>
@@ -20,12 +21,18 @@ namespace LibGeoDecomp {
  * weights(id) returns a pair of two pointers. One points to the array where
  * the indices for gather are stored and the seconds points the matrix values.
  * Both pointers can be used to load LFA short_vec classes accordingly.
+ * Compressed or matrix-free weight containers (see the grid's
+ * MatrixType) decode into a buffer held by the iterators, so these
+ * pointers are only valid until the iterator is advanced.
  *
  * DIM_X/Y/Z refer to the grid's storage dimensions, INDEX is a fixed
  * offset for the soa_accessor, MATRICES is the number of adjacency
  * matrices (equals 1 for most applications), VALUE_TYPE is the type
  * of the edge weights, C refers to the chunk size and SIGMA is the
- * sorting scope used by the SELL-C-Sigma container.
+ * sorting scope used by the SELL-C-Sigma container. BLOCK_SIZE is
+ * taken from the cell's APITraits (see HasSellBlockSize) and
+ * determines how many vectors unstructuredBlockMultiply() handles
+ * per matrix traversal.
  */
 template<
     typename GRID_TYPE,
@@ -42,6 +49,7 @@ class UnstructuredSoANeighborhood
 {
 public:
     static const int ARITY = C;
+    static const int BLOCK_SIZE = APITraits::SelectSellBlockSize<CELL>::VALUE;
 
     using IteratorPair = std::pair<const int*, const VALUE_TYPE*>;
     using SoAAccessor = LibFlatArray::soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX>;
@@ -55,11 +63,11 @@ public:
     class Iterator : public std::iterator<std::forward_iterator_tag, const IteratorPair>
     {
     public:
-        using Matrix = SellCSigmaSparseMatrixContainer<VALUE_TYPE, C, SIGMA>;
+        using Matrix = typename GRID_TYPE::MatrixType;
 
         inline
-        Iterator(const Matrix& matrix, int offset) :
-            matrix(matrix), offset(offset)
+        Iterator(const Matrix& matrix, int chunk, int offset) :
+            matrix(matrix), chunk(chunk), offset(offset)
         {}
 
         inline
@@ -88,18 +96,20 @@ public:
         inline
         const int *first() const
         {
-            return &matrix.columnVec()[offset];
+            return matrix.columnChunk(chunk, offset, &scratch);
         }
 
         inline
         const VALUE_TYPE *second() const
         {
-            return &matrix.valuesVec()[offset];
+            return matrix.valueChunk(chunk, offset, &scratch);
         }
 
     private:
         const Matrix& matrix;   // Which matrix to use?
-        int offset;             // In which chunk are we right now?
+        int chunk;              // In which chunk are we right now?
+        int offset;             // Where in that chunk?
+        mutable typename Matrix::ScratchSpace scratch; // buffer for compressed matrices
     };
 
     /**
@@ -110,11 +120,12 @@ public:
     class ScalarIterator : public std::iterator<std::forward_iterator_tag, const IteratorPair>
     {
     public:
-        using Matrix = SellCSigmaSparseMatrixContainer<VALUE_TYPE, C, SIGMA>;
+        using Matrix = typename GRID_TYPE::MatrixType;
 
         inline
-        ScalarIterator(const Matrix& matrix, int offset, int scalarOffset) :
+        ScalarIterator(const Matrix& matrix, int chunk, int offset, int scalarOffset) :
             matrix(matrix),
+            chunk(chunk),
             offset(offset),
             scalarOffset(scalarOffset)
         {}
@@ -145,19 +156,21 @@ public:
         inline
         const int *first() const
         {
-            return &matrix.columnVec()[offset] + scalarOffset;
+            return matrix.columnEntry(chunk, offset, scalarOffset, &scratch);
         }
 
         inline
         const VALUE_TYPE *second() const
         {
-            return &matrix.valuesVec()[offset] + scalarOffset;
+            return matrix.valueEntry(chunk, offset, scalarOffset, &scratch);
         }
 
     private:
         const Matrix& matrix;   // Which matrix to use?
-        int offset;             // In which chunk are we right now?
+        int chunk;              // In which chunk are we right now?
+        int offset;             // Where in that chunk?
         int scalarOffset;       // Our offset within the chunk
+        mutable typename Matrix::ScratchSpace scratch; // buffer for compressed matrices
     };
 
     inline
@@ -199,28 +212,28 @@ public:
     Iterator begin() const
     {
         const auto& matrix = grid.getWeights(currentMatrixID);
-        return Iterator(matrix, matrix.chunkOffsetVec()[currentChunk]);
+        return Iterator(matrix, currentChunk, matrix.chunkOffsetVec()[currentChunk]);
     }
 
     inline
     const Iterator end() const
     {
         const auto& matrix = grid.getWeights(currentMatrixID);
-        return Iterator(matrix, matrix.chunkOffsetVec()[currentChunk + 1]);
+        return Iterator(matrix, currentChunk, matrix.chunkOffsetVec()[currentChunk + 1]);
     }
 
     inline
     ScalarIterator beginScalar() const
     {
         const auto& matrix = grid.getWeights(currentMatrixID);
-        return ScalarIterator(matrix, matrix.chunkOffsetVec()[currentChunk], intraChunkOffset);
+        return ScalarIterator(matrix, currentChunk, matrix.chunkOffsetVec()[currentChunk], intraChunkOffset);
     }
 
     inline
     const ScalarIterator endScalar() const
     {
         const auto& matrix = grid.getWeights(currentMatrixID);
-        return ScalarIterator(matrix, matrix.chunkOffsetVec()[currentChunk + 1], intraChunkOffset);
+        return ScalarIterator(matrix, currentChunk, matrix.chunkOffsetVec()[currentChunk + 1], intraChunkOffset);
     }
 
     /**
@@ -289,6 +302,19 @@ template<
     int SIGMA>
 const int UnstructuredSoANeighborhood<GRID_TYPE, CELL, DIM_X, DIM_Y, DIM_Z, INDEX, MATRICES, VALUE_TYPE, C, SIGMA>::ARITY;
 
+template<
+    typename GRID_TYPE,
+    typename CELL,
+    long DIM_X,
+    long DIM_Y,
+    long DIM_Z,
+    long INDEX,
+    std::size_t MATRICES,
+    typename VALUE_TYPE,
+    int C,
+    int SIGMA>
+const int UnstructuredSoANeighborhood<GRID_TYPE, CELL, DIM_X, DIM_Y, DIM_Z, INDEX, MATRICES, VALUE_TYPE, C, SIGMA>::BLOCK_SIZE;
+
 }
 
 #endif
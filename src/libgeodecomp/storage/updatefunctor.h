@@ -388,6 +388,75 @@ private:
     bool enableFineGrainedParallelism;
 };
 
+#ifdef LIBGEODECOMP_WITH_THREADS
+/**
+ * Distributes the update among the threads of a WorkStealingPool,
+ * by default the process-wide one. Regions are bisected recursively
+ * (at plane boundaries where possible). A small per-thread cache
+ * of these splits spares recurring Regions most of the setup
+ * costs, although each lookup still compares the Region against
+ * the cached candidates. With fine-grained
+ * parallelism Streaks are cut according to the model's granularity,
+ * otherwise only very long Streaks are cut.
+ *
+ * Models which thread their update themselves (via OpenMP or HPX)
+ * will be updated sequentially. Those may however use a
+ * WorkStealingPool themselves: as waiting threads help with pending
+ * tasks, nesting is deadlock-free.
+ */
+class ConcurrencyEnableThreadPool
+{
+public:
+    inline
+    ConcurrencyEnableThreadPool(
+        bool /* unused: updatingGhost */,
+        bool enableFineGrainedParallelism,
+        WorkStealingPool *pool = &WorkStealingPool::global()) :
+        enableFineGrainedParallelism(enableFineGrainedParallelism),
+        pool(pool)
+    {}
+
+    bool enableOpenMP() const
+    {
+        return false;
+    }
+
+    bool enableHPX() const
+    {
+        return false;
+    }
+
+    bool preferStaticScheduling() const
+    {
+        return false;
+    }
+
+    bool preferFineGrainedParallelism() const
+    {
+        return enableFineGrainedParallelism;
+    }
+
+    WorkStealingPool *threadPool() const
+    {
+        return pool;
+    }
+
+private:
+    bool enableFineGrainedParallelism;
+    WorkStealingPool *pool;
+};
+
+template<>
+class SelectThreadPool<ConcurrencyEnableThreadPool>
+{
+public:
+    static WorkStealingPool *value(const ConcurrencyEnableThreadPool& concurrencySpec)
+    {
+        return concurrencySpec.threadPool();
+    }
+};
+#endif
+
 }
 
 /**
@@ -3,10 +3,81 @@
 
 #include <libgeodecomp/storage/updatefunctormacrosmsvc.h>
 
+#ifdef LIBGEODECOMP_WITH_THREADS
+
+#include <libgeodecomp/geometry/streak.h>
+#include <libgeodecomp/misc/workstealingpool.h>
+#include <libgeodecomp/storage/regionsplitter.h>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace UpdateFunctorHelpers {
+
+/**
+ * Scratch space for the fine-grained OpenMP update below. Recycling
+ * the buffer per thread keeps the time loop free of allocations
+ * once the capacity matches the largest region. Callers need to
+ * take a reference outside of the parallel region as each OpenMP
+ * thread would otherwise see its own instance.
+ */
+template<int DIM>
+std::vector<Streak<DIM> >& streakBuffer()
+{
+    static thread_local std::vector<Streak<DIM> > buffer;
+    return buffer;
+}
+
+/**
+ * Yields the WorkStealingPool a ConcurrencySpec requests, if any.
+ * Specs with thread pool support need to specialize this template.
+ */
+template<typename CONCURRENCY_SPEC>
+class SelectThreadPool
+{
+public:
+    static WorkStealingPool *value(const CONCURRENCY_SPEC& /* unused */)
+    {
+        return 0;
+    }
+};
+
+template<typename CONCURRENCY_SPEC>
+WorkStealingPool *selectThreadPool(const CONCURRENCY_SPEC& concurrencySpec)
+{
+    return SelectThreadPool<CONCURRENCY_SPEC>::value(concurrencySpec);
+}
+
+}
+
+}
+
+#endif
+
 #ifndef _MSC_BUILD
 
 #ifdef LIBGEODECOMP_WITH_THREADS
 #define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_1                         \
+    if (WorkStealingPool *threadPool =                                  \
+        UpdateFunctorHelpers::selectThreadPool(concurrencySpec)) {      \
+        if (!modelThreadingSpec.hasOpenMP() &&                          \
+            !modelThreadingSpec.hasHPX()) {                             \
+            typename RegionSplitter<DIM>::Ptr splitter =                \
+                RegionSplitter<DIM>::get(                               \
+                    region,                                             \
+                    concurrencySpec.preferFineGrainedParallelism() ?    \
+                    modelThreadingSpec.granularity() : 0,               \
+                    threadPool->numThreads());                          \
+            splitter->forEach(                                          \
+                threadPool,                                             \
+                [&](const Streak<DIM> *begin, const Streak<DIM> *end) { \
+                    for (const Streak<DIM> *i = begin; i != end; ++i) { \
+                        LGD_UPDATE_FUNCTOR_BODY;                        \
+                    }                                                   \
+                });                                                     \
+            return;                                                     \
+        }                                                               \
+    }                                                                   \
     if (concurrencySpec.enableOpenMP() &&                               \
         !modelThreadingSpec.hasOpenMP()) {                              \
         if (concurrencySpec.preferStaticScheduling()) {                 \
@@ -40,7 +111,9 @@
 #define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_3                         \
             } else {                                                    \
                 typedef typename Region<DIM>::StreakIterator Iter;      \
-                std::vector<Streak<DIM> > streaks;                      \
+                std::vector<Streak<DIM> >& streaks =                    \
+                    UpdateFunctorHelpers::streakBuffer<DIM>();          \
+                streaks.clear();                                        \
                 streaks.reserve(region.numStreaks());                   \
                 for (Iter i = region.beginStreak();                     \
                      i != region.endStreak();                           \
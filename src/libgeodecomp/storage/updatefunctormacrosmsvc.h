@@ -9,6 +9,26 @@
 
 #ifdef LIBGEODECOMP_WITH_THREADS
 #define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_1                         \
+    if (WorkStealingPool *threadPool =                                  \
+        UpdateFunctorHelpers::selectThreadPool(concurrencySpec)) {      \
+        if (!modelThreadingSpec.hasOpenMP() &&                          \
+            !modelThreadingSpec.hasHPX()) {                             \
+            typename RegionSplitter<DIM>::Ptr splitter =                \
+                RegionSplitter<DIM>::get(                               \
+                    region,                                             \
+                    concurrencySpec.preferFineGrainedParallelism() ?    \
+                    modelThreadingSpec.granularity() : 0,               \
+                    threadPool->numThreads());                          \
+            splitter->forEach(                                          \
+                threadPool,                                             \
+                [&](const Streak<DIM> *begin, const Streak<DIM> *end) { \
+                    for (const Streak<DIM> *i = begin; i != end; ++i) { \
+                        LGD_UPDATE_FUNCTOR_BODY;                        \
+                    }                                                   \
+                });                                                     \
+            return;                                                     \
+        }                                                               \
+    }                                                                   \
     if (concurrencySpec.enableOpenMP() &&                               \
         !modelThreadingSpec.hasOpenMP()) {                              \
         if (concurrencySpec.preferStaticScheduling()) {                 \
@@ -42,7 +62,9 @@
 #define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_3                         \
             } else {                                                    \
                 typedef typename Region<DIM>::StreakIterator Iter;      \
-                std::vector<Streak<DIM> > streaks;                      \
+                std::vector<Streak<DIM> >& streaks =                    \
+                    UpdateFunctorHelpers::streakBuffer<DIM>();          \
+                streaks.clear();                                        \
                 streaks.reserve(region.numStreaks());                   \
                 for (Iter i = region.beginStreak();                     \
                      i != region.endStreak();                           \
@@ -0,0 +1,275 @@
+#ifndef LIBGEODECOMP_STORAGE_VERLETLIST_H
+#define LIBGEODECOMP_STORAGE_VERLETLIST_H
+
+#include <libgeodecomp/geometry/floatcoord.h>
+#include <libgeodecomp/geometry/stencils.h>
+
+#include <cmath>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * VerletList caches for all particles of one box (e.g. a BoxCell)
+ * those particles in the surrounding boxes which are closer than
+ * cutoff + skin. The lists are stored in compressed sparse row (CSR)
+ * format: the neighbors of particle i are given by
+ * entries[offsets[i]] to entries[offsets[i + 1] - 1], each of which
+ * encodes the box (0 to NUM_BOXES - 1, ordered like the Moore
+ * neighborhood) and the index of the particle within that box.
+ *
+ * Lists remain valid as long as no box in the neighborhood has
+ * reordered its particles and as long as no particle has moved by
+ * more than skin / 2. For the latter each box accumulates an upper
+ * bound for the displacement of its particles ("travel"). This
+ * reduction is confined to the neighborhood, so no global
+ * synchronization is required.
+ */
+template<int DIM>
+class VerletList
+{
+public:
+    static const int NUM_BOXES = Stencils::Moore<DIM, 1>::VOLUME;
+    static const int CENTER = NUM_BOXES / 2;
+
+    /**
+     * Lets a particle traverse its Verlet list just like the
+     * NeighborhoodAdapter of a BoxCell. Particles added via
+     * operator<<() are handed to the container being updated.
+     */
+    template<typename WRITE_CONTAINER, typename CONTAINER>
+    class Neighborhood
+    {
+    public:
+        typedef typename CONTAINER::value_type Particle;
+
+        class Iterator
+        {
+        public:
+            inline Iterator(const CONTAINER *const *containers, const int *entry) :
+                containers(containers),
+                entry(entry)
+            {}
+
+            inline const Particle& operator*() const
+            {
+                return (*containers[*entry % NUM_BOXES])[*entry / NUM_BOXES];
+            }
+
+            inline const Particle *operator->() const
+            {
+                return &**this;
+            }
+
+            inline void operator++()
+            {
+                ++entry;
+            }
+
+            inline bool operator==(const Iterator& other) const
+            {
+                return entry == other.entry;
+            }
+
+            inline bool operator!=(const Iterator& other) const
+            {
+                return entry != other.entry;
+            }
+
+        private:
+            const CONTAINER *const *containers;
+            const int *entry;
+        };
+
+        inline Neighborhood(
+            WRITE_CONTAINER *writeContainer,
+            const CONTAINER *const *containers,
+            const int *begin,
+            const int *end) :
+            writeContainer(writeContainer),
+            myBegin(containers, begin),
+            myEnd(containers, end)
+        {}
+
+        inline const Iterator& begin() const
+        {
+            return myBegin;
+        }
+
+        inline const Iterator& end() const
+        {
+            return myEnd;
+        }
+
+        template<typename PARTICLE>
+        inline void operator<<(const PARTICLE& particle)
+        {
+            (*writeContainer) << particle;
+        }
+
+    private:
+        WRITE_CONTAINER *writeContainer;
+        Iterator myBegin;
+        Iterator myEnd;
+    };
+
+    inline VerletList() :
+        travel(0),
+        changed(false),
+        valid(false)
+    {
+        for (int i = 0; i < NUM_BOXES; ++i) {
+            travelAtBuild[i] = 0;
+        }
+    }
+
+    /**
+     * Needs to be called whenever particles are added to or removed
+     * from the box, or reordered.
+     */
+    inline void markChanged()
+    {
+        changed = true;
+    }
+
+    inline void clearChanged()
+    {
+        changed = false;
+    }
+
+    inline bool hasChanged() const
+    {
+        return changed;
+    }
+
+    inline bool isValid() const
+    {
+        return valid;
+    }
+
+    /**
+     * Upper bound for the distance any particle of the box has
+     * traveled since the box last changed.
+     */
+    inline double getTravel() const
+    {
+        return travel;
+    }
+
+    inline std::size_t size() const
+    {
+        return entries.size();
+    }
+
+    inline const int *begin(std::size_t particle) const
+    {
+        return entries.empty() ? 0 : &entries[0] + offsets[particle];
+    }
+
+    inline const int *end(std::size_t particle) const
+    {
+        return entries.empty() ? 0 : &entries[0] + offsets[particle + 1];
+    }
+
+    /**
+     * lists holds the VerletLists of the surrounding boxes as of the
+     * previous time step (including this box' previous state at
+     * CENTER).
+     */
+    inline bool needsRebuild(const VerletList *const *lists, const double halfSkin) const
+    {
+        if (!valid || changed) {
+            return true;
+        }
+
+        for (int i = 0; i < NUM_BOXES; ++i) {
+            if (lists[i]->changed ||
+                ((lists[i]->travel - travelAtBuild[i]) > halfSkin)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    template<typename CONTAINER>
+    inline void build(
+        const CONTAINER& particles,
+        const CONTAINER *const *containers,
+        const VerletList *const *lists,
+        const double radius)
+    {
+        double radius2 = radius * radius;
+        offsets.resize(particles.size() + 1);
+        entries.clear();
+        offsets[0] = 0;
+
+        for (std::size_t i = 0; i < particles.size(); ++i) {
+            FloatCoord<DIM> pos = particles[i].getPos();
+
+            for (int box = 0; box < NUM_BOXES; ++box) {
+                const CONTAINER& neighbors = *containers[box];
+
+                for (std::size_t j = 0; j < neighbors.size(); ++j) {
+                    FloatCoord<DIM> delta = neighbors[j].getPos() - pos;
+                    if ((delta * delta) < radius2) {
+                        entries.push_back(static_cast<int>(box + NUM_BOXES * j));
+                    }
+                }
+            }
+
+            offsets[i + 1] = static_cast<int>(entries.size());
+        }
+
+        for (int i = 0; i < NUM_BOXES; ++i) {
+            travelAtBuild[i] = lists[i]->travel;
+        }
+        valid = true;
+    }
+
+    /**
+     * Accumulates the maximum displacement of the particles during
+     * the last update (compared to their previous state in
+     * oldParticles). numParticles is the number of particles present
+     * before the update; if particles were added, the box counts as
+     * changed.
+     */
+    template<typename CONTAINER>
+    inline void track(
+        const CONTAINER& particles,
+        const CONTAINER& oldParticles,
+        const std::size_t numParticles)
+    {
+        if (particles.size() != numParticles) {
+            changed = true;
+        }
+
+        if (changed) {
+            travel = 0;
+            return;
+        }
+
+        double maxDistance2 = 0;
+        for (std::size_t i = 0; i < numParticles; ++i) {
+            FloatCoord<DIM> delta = particles[i].getPos() - oldParticles[i].getPos();
+            double distance2 = delta * delta;
+            if (distance2 > maxDistance2) {
+                maxDistance2 = distance2;
+            }
+        }
+
+        travel += std::sqrt(maxDistance2);
+    }
+
+private:
+    std::vector<int> offsets;
+    std::vector<int> entries;
+    double travelAtBuild[NUM_BOXES];
+    double travel;
+    bool changed;
+    bool valid;
+};
+
+}
+
+#endif
@@ -0,0 +1,485 @@
+#ifndef LIBGEODECOMP_TESTBED_PERFORMANCETESTS_BENCHMARKHARNESS_H
+#define LIBGEODECOMP_TESTBED_PERFORMANCETESTS_BENCHMARKHARNESS_H
+
+#include <libgeodecomp/misc/stringops.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include <unistd.h>
+
+namespace LibGeoDecomp {
+
+/**
+ * Aggregated measurements of one benchmark for one set of
+ * dimensions.
+ */
+class BenchmarkResult
+{
+public:
+    std::string revision;
+    std::string date;
+    std::string host;
+    std::string device;
+    std::string order;
+    std::string family;
+    std::string species;
+    std::string dimensions;
+    std::string unit;
+    std::vector<double> samples;
+    double median;
+    double p10;
+    double p90;
+    double min;
+    double max;
+    double mean;
+    double stddev;
+
+    BenchmarkResult() :
+        median(0),
+        p10(0),
+        p90(0),
+        min(0),
+        max(0),
+        mean(0),
+        stddev(0)
+    {}
+
+    /**
+     * Identifies a measurement across runs, e.g. to match it with a
+     * baseline.
+     */
+    std::string key() const
+    {
+        return family + "/" + species + "/" + dimensions;
+    }
+
+    /**
+     * Most benchmarks report a throughput, some report a duration.
+     */
+    bool lowerIsBetter() const
+    {
+        return (unit == "s") || (unit == "ms") || (unit == "us") || (unit == "ns");
+    }
+
+    void computeStatistics()
+    {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        min    = sorted.front();
+        max    = sorted.back();
+        median = percentile(sorted, 0.5);
+        p10    = percentile(sorted, 0.1);
+        p90    = percentile(sorted, 0.9);
+
+        double sum = 0;
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            sum += sorted[i];
+        }
+        mean = sum / sorted.size();
+
+        double squares = 0;
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            squares += (sorted[i] - mean) * (sorted[i] - mean);
+        }
+        stddev = (sorted.size() > 1) ? std::sqrt(squares / (sorted.size() - 1)) : 0;
+    }
+
+    /**
+     * Linear interpolation between the closest ranks.
+     */
+    static double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        double rank = fraction * (sorted.size() - 1);
+        std::size_t lower = rank;
+        std::size_t upper = (std::min)(lower + 1, sorted.size() - 1);
+        double weight = rank - lower;
+
+        return sorted[lower] * (1 - weight) + sorted[upper] * weight;
+    }
+};
+
+/**
+ * Drop-in replacement for LibFlatArray::evaluate which runs each
+ * benchmark multiple times (after some warmup runs) and reports the
+ * median and other statistics. Results can be written as text (the
+ * classic format of LibFlatArray::evaluate), CSV or JSON and can be
+ * compared against a baseline which was stored from a previous run
+ * (JSON or CSV) to flag regressions.
+ */
+class BenchmarkHarness
+{
+public:
+    enum Format {TEXT, CSV, JSON};
+
+    BenchmarkHarness(
+        const std::string& name,
+        const std::string& revision,
+        int warmups = 1,
+        int repetitions = 5,
+        Format format = TEXT,
+        std::ostream *output = &std::cout) :
+        name(name),
+        revision(revision),
+        warmups(warmups),
+        repetitions((std::max)(1, repetitions)),
+        format(format),
+        output(output),
+        threshold(0.05),
+        regressions(0),
+        resultCounter(0)
+    {}
+
+    ~BenchmarkHarness()
+    {
+        if (format == JSON) {
+            *output << "\n]}" << std::endl;
+        }
+    }
+
+    /**
+     * Pins the calling thread to the given CPU. OpenMP threads
+     * should be bound via OMP_PROC_BIND/OMP_PLACES instead as the
+     * runtime has been initialized by now.
+     */
+    static void pin(int cpu)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "WARNING: could not pin to CPU " << cpu << "\n";
+        }
+#else
+        std::cerr << "WARNING: pinning not supported on this platform\n";
+#endif
+    }
+
+    static Format parseFormat(const std::string& string)
+    {
+        if (string == "text") {
+            return TEXT;
+        }
+        if (string == "csv") {
+            return CSV;
+        }
+        if (string == "json") {
+            return JSON;
+        }
+
+        throw std::invalid_argument("unknown output format: " + string);
+    }
+
+    /**
+     * Loads results of a previous run (written in JSON or CSV
+     * format) for comparison. Measurements which differ by more
+     * than threshold (relative to the baseline median) in the
+     * unfavorable direction will be reported as regressions.
+     */
+    void loadBaseline(const std::string& filename, double newThreshold)
+    {
+        threshold = newThreshold;
+        std::ifstream file(filename.c_str());
+        if (!file) {
+            throw std::invalid_argument("could not open baseline " + filename);
+        }
+
+        std::string line;
+        StringVec csvHeader;
+        while (std::getline(file, line)) {
+            if (line.find("\"family\"") != std::string::npos) {
+                addBaselineEntry(
+                    jsonField(line, "family"),
+                    jsonField(line, "species"),
+                    jsonField(line, "dimensions"),
+                    StringOps::atof(jsonField(line, "median")));
+                continue;
+            }
+
+            StringVec fields = StringOps::tokenize(line, ",");
+            if (csvHeader.empty()) {
+                csvHeader = fields;
+                continue;
+            }
+
+            std::map<std::string, std::string> record;
+            for (std::size_t i = 0; (i < fields.size()) && (i < csvHeader.size()); ++i) {
+                record[csvHeader[i]] = fields[i];
+            }
+            if (record.count("median")) {
+                addBaselineEntry(
+                    record["family"],
+                    record["species"],
+                    record["dimensions"],
+                    StringOps::atof(record["median"]));
+            }
+        }
+    }
+
+    void printHeader()
+    {
+        if (format == TEXT) {
+            *output << "#rev              ; date                 ; host                            ; device                                          ; order   ; family                          ; species ; dimensions              ; perf        ; unit" << std::endl;
+        }
+        if (format == CSV) {
+            *output << "revision,date,host,device,order,family,species,dimensions,unit,repetitions,median,p10,p90,min,max,mean,stddev" << std::endl;
+        }
+        if (format == JSON) {
+            *output << "{\"results\": [";
+        }
+    }
+
+    template<class BENCHMARK>
+    void operator()(BENCHMARK benchmark, std::vector<int> dim)
+    {
+        if (benchmark.family().find(name, 0) == std::string::npos) {
+            return;
+        }
+
+        for (int i = 0; i < warmups; ++i) {
+            benchmark.performance(dim);
+        }
+
+        BenchmarkResult result;
+        for (int i = 0; i < repetitions; ++i) {
+            result.samples.push_back(benchmark.performance(dim));
+        }
+        result.computeStatistics();
+
+        result.revision = revision;
+        result.date = now();
+        result.host = hostname();
+        result.device = benchmark.device();
+        result.order = benchmark.order();
+        result.family = benchmark.family();
+        result.species = benchmark.species();
+        result.unit = benchmark.unit();
+
+        std::stringstream buf;
+        for (std::size_t i = 0; i < dim.size(); ++i) {
+            buf << (i ? "x" : "") << dim[i];
+        }
+        result.dimensions = buf.str();
+
+        print(result);
+        compare(result);
+    }
+
+    /**
+     * Runs the benchmark for all dimensions from minDim to maxDim,
+     * scaling all dimensions by factor in each step.
+     */
+    template<class BENCHMARK>
+    void sweep(BENCHMARK benchmark, std::vector<int> minDim, const std::vector<int>& maxDim, int factor)
+    {
+        for (std::vector<int> dim = minDim;;) {
+            for (std::size_t i = 0; i < dim.size(); ++i) {
+                if (dim[i] > maxDim[i]) {
+                    return;
+                }
+            }
+
+            (*this)(benchmark, dim);
+
+            for (std::size_t i = 0; i < dim.size(); ++i) {
+                dim[i] *= factor;
+            }
+        }
+    }
+
+    /**
+     * Number of measurements which were slower than the baseline.
+     */
+    int numRegressions() const
+    {
+        return regressions;
+    }
+
+private:
+    std::string name;
+    std::string revision;
+    int warmups;
+    int repetitions;
+    Format format;
+    std::ostream *output;
+    std::map<std::string, double> baseline;
+    double threshold;
+    int regressions;
+    int resultCounter;
+
+    void addBaselineEntry(
+        const std::string& family,
+        const std::string& species,
+        const std::string& dimensions,
+        double median)
+    {
+        BenchmarkResult entry;
+        entry.family = family;
+        entry.species = species;
+        entry.dimensions = dimensions;
+        baseline[entry.key()] = median;
+    }
+
+    void compare(const BenchmarkResult& result)
+    {
+        std::map<std::string, double>::iterator i = baseline.find(result.key());
+        if (i == baseline.end()) {
+            return;
+        }
+
+        double ratio = result.median / i->second;
+        bool regression = result.lowerIsBetter() ?
+            (ratio > (1 + threshold)) :
+            (ratio < (1 - threshold));
+
+        if (regression) {
+            ++regressions;
+        }
+
+        // report on stderr to keep stdout machine-readable:
+        std::cerr << (regression ? "REGRESSION " : "ok         ")
+                  << std::setw(64) << std::left << result.key()
+                  << " baseline: " << std::setw(12) << i->second
+                  << " current: "  << std::setw(12) << result.median
+                  << " ratio: "    << ratio << " " << result.unit << "\n";
+    }
+
+    void print(const BenchmarkResult& result)
+    {
+        if (format == TEXT) {
+            std::string prettyDim = "(" + StringOps::join(StringOps::tokenize(result.dimensions, "x"), ", ") + ")";
+
+            *output << std::setiosflags(std::ios::left);
+            *output << std::setw(18) << result.revision << "; "
+                    << result.date << " ; "
+                    << std::setw(32) << result.host << "; "
+                    << std::setw(48) << result.device << "; "
+                    << std::setw( 8) << result.order <<  "; "
+                    << std::setw(32) << result.family <<  "; "
+                    << std::setw( 8) << result.species <<  "; "
+                    << std::setw(24) << prettyDim <<  "; "
+                    << std::setw(12) << result.median <<  "; "
+                    << std::setw( 8) << result.unit << std::endl;
+        }
+
+        if (format == CSV) {
+            *output << csvEscape(result.revision) << ","
+                    << csvEscape(result.date) << ","
+                    << csvEscape(result.host) << ","
+                    << csvEscape(result.device) << ","
+                    << csvEscape(result.order) << ","
+                    << csvEscape(result.family) << ","
+                    << csvEscape(result.species) << ","
+                    << result.dimensions << ","
+                    << result.unit << ","
+                    << result.samples.size() << ","
+                    << result.median << ","
+                    << result.p10 << ","
+                    << result.p90 << ","
+                    << result.min << ","
+                    << result.max << ","
+                    << result.mean << ","
+                    << result.stddev << std::endl;
+        }
+
+        if (format == JSON) {
+            // one record per line simplifies reading baselines:
+            *output << (resultCounter ? ",\n" : "\n")
+                    << "  {\"revision\": \"" << jsonEscape(result.revision)
+                    << "\", \"date\": \"" << jsonEscape(result.date)
+                    << "\", \"host\": \"" << jsonEscape(result.host)
+                    << "\", \"device\": \"" << jsonEscape(result.device)
+                    << "\", \"order\": \"" << jsonEscape(result.order)
+                    << "\", \"family\": \"" << jsonEscape(result.family)
+                    << "\", \"species\": \"" << jsonEscape(result.species)
+                    << "\", \"dimensions\": \"" << result.dimensions
+                    << "\", \"unit\": \"" << jsonEscape(result.unit)
+                    << "\", \"repetitions\": " << result.samples.size()
+                    << ", \"median\": " << result.median
+                    << ", \"p10\": " << result.p10
+                    << ", \"p90\": " << result.p90
+                    << ", \"min\": " << result.min
+                    << ", \"max\": " << result.max
+                    << ", \"mean\": " << result.mean
+                    << ", \"stddev\": " << result.stddev
+                    << "}" << std::flush;
+        }
+
+        ++resultCounter;
+    }
+
+    static std::string now()
+    {
+        time_t secondsSinceEpoch = time(0);
+        tm timeSpec;
+        gmtime_r(&secondsSinceEpoch, &timeSpec);
+        char buf[1024];
+        strftime(buf, 1024, "%Y-%b-%d %H:%M:%S", &timeSpec);
+        return buf;
+    }
+
+    static std::string hostname()
+    {
+        std::string ret(2048, ' ');
+        gethostname(&ret[0], ret.size());
+        // cut string at first 0 byte:
+        return std::string(ret.c_str());
+    }
+
+    static std::string csvEscape(std::string string)
+    {
+        std::replace(string.begin(), string.end(), ',', ' ');
+        return string;
+    }
+
+    static std::string jsonEscape(const std::string& string)
+    {
+        std::string ret;
+        for (std::size_t i = 0; i < string.size(); ++i) {
+            if ((string[i] == '"') || (string[i] == '\\')) {
+                ret += '\\';
+            }
+            ret += string[i];
+        }
+        return ret;
+    }
+
+    /**
+     * Extracts the value of the given key from a single-line JSON
+     * record as written by print().
+     */
+    static std::string jsonField(const std::string& line, const std::string& key)
+    {
+        std::string pattern = "\"" + key + "\": ";
+        std::size_t start = line.find(pattern);
+        if (start == std::string::npos) {
+            return "";
+        }
+        start += pattern.size();
+
+        if (line[start] == '"') {
+            ++start;
+            return line.substr(start, line.find('"', start) - start);
+        }
+
+        return line.substr(start, line.find_first_of(",}", start) - start);
+    }
+};
+
+}
+
+#endif
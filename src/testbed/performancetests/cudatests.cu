@@ -6,12 +6,13 @@
 #include <libgeodecomp/storage/soagrid.h>
 
 #include <libflatarray/testbed/gpu_benchmark.hpp>
-#include <libflatarray/testbed/evaluate.hpp>
 
 #include <cuda.h>
 #include <iostream>
 #include <stdexcept>
 
+#include "benchmarkharness.h"
+
 using namespace LibGeoDecomp;
 
 class GPUBenchmark : public LibFlatArray::gpu_benchmark
@@ -602,10 +603,9 @@ public:
     }
 };
 
-void cudaTests(std::string name, std::string revision, int cudaDevice)
+void cudaTests(BenchmarkHarness& eval, int cudaDevice)
 {
     cudaSetDevice(cudaDevice);
-    LibFlatArray::evaluate eval(name, revision);
 
     int increment = 4;
 
@@ -2,18 +2,25 @@
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/io/simpleinitializer.h>
 #include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/misc/random.h>
 #include <libgeodecomp/geometry/convexpolytope.h>
+#include <libgeodecomp/geometry/convexpolytopebuilder.h>
 #include <libgeodecomp/geometry/coord.h>
 #include <libgeodecomp/geometry/floatcoord.h>
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/stencils.h>
+#include <libgeodecomp/geometry/partitions/hilbert3dpartition.h>
 #include <libgeodecomp/geometry/partitions/hindexingpartition.h>
 #include <libgeodecomp/geometry/partitions/hilbertpartition.h>
 #include <libgeodecomp/geometry/partitions/stripingpartition.h>
 #include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+#include <libgeodecomp/storage/boxcell.h>
 #include <libgeodecomp/storage/grid.h>
+#include <libgeodecomp/storage/linearstencil.h>
 #include <libgeodecomp/storage/linepointerassembly.h>
 #include <libgeodecomp/storage/linepointerupdatefunctor.h>
+#include <libgeodecomp/storage/shortvecswitch.h>
+#include <libgeodecomp/storage/soaboxcell.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 #include <libgeodecomp/parallelization/openmpsimulator.h>
 #include <libgeodecomp/parallelization/serialsimulator.h>
@@ -26,8 +33,8 @@
 
 #include <libflatarray/short_vec.hpp>
 #include <libflatarray/testbed/cpu_benchmark.hpp>
-#include <libflatarray/testbed/evaluate.hpp>
 #include <libflatarray/api_traits.hpp>
+#include <libflatarray/loop_peeler.hpp>
 #include <libflatarray/macros.hpp>
 
 #include <emmintrin.h>
@@ -35,10 +42,13 @@
 #include <immintrin.h>
 #endif
 
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <stdio.h>
 
+#include "benchmarkharness.h"
 #include "cpubenchmark.h"
 
 using namespace LibGeoDecomp;
@@ -805,6 +815,102 @@ public:
     }
 };
 
+/**
+ * Builds Voronoi cells, each from a cloud of random points, as
+ * VoronoiMesher would do for every element.
+ */
+class ConvexPolytopeCuttingBase : public CPUBenchmark
+{
+public:
+    typedef ConvexPolytope<FloatCoord<2> > PolytopeType;
+    typedef std::pair<FloatCoord<2>, int> PointType;
+
+    std::string family()
+    {
+        return "ConvexPolytopeCutting";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        int numPolytopes = rawDim[0];
+        int numPoints = rawDim[1];
+        FloatCoord<2> simSpaceDim(1000, 1000);
+
+        Random::seed(47);
+        std::vector<PointType> points;
+        for (int i = 0; i < numPoints; ++i) {
+            points << std::make_pair(
+                FloatCoord<2>(Random::genDouble(simSpaceDim[0]), Random::genDouble(simSpaceDim[1])),
+                i);
+        }
+
+        double seconds = 0;
+        double volume = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            for (int i = 0; i < numPolytopes; ++i) {
+                PolytopeType polytope(points[i % numPoints].first, simSpaceDim);
+                cut(&polytope, points);
+                polytope.updateGeometryData(true);
+                volume += polytope.getLimits().size();
+            }
+        }
+
+        // trick the compiler to not optimize away the loop above
+        if (volume == 4711) {
+            std::cout << "whatever";
+        }
+
+        return seconds;
+    }
+
+    std::string unit()
+    {
+        return "s";
+    }
+
+protected:
+    virtual void cut(PolytopeType *polytope, const std::vector<PointType>& points) = 0;
+};
+
+class ConvexPolytopeCuttingBronze : public ConvexPolytopeCuttingBase
+{
+public:
+    std::string species()
+    {
+        return "bronze";
+    }
+
+protected:
+    void cut(PolytopeType *polytope, const std::vector<PointType>& points)
+    {
+        for (std::vector<PointType>::const_iterator i = points.begin(); i != points.end(); ++i) {
+            if (i->first != polytope->getCenter()) {
+                *polytope << *i;
+            }
+        }
+    }
+};
+
+class ConvexPolytopeCuttingGold : public ConvexPolytopeCuttingBase
+{
+public:
+    std::string species()
+    {
+        return "gold";
+    }
+
+protected:
+    void cut(PolytopeType *polytope, const std::vector<PointType>& points)
+    {
+        builder(polytope, points.begin(), points.end());
+    }
+
+private:
+    ConvexPolytopeBuilder<FloatCoord<2> > builder;
+};
+
 class Jacobi3DVanilla : public CPUBenchmark
 {
 public:
@@ -1547,6 +1653,202 @@ public:
     }
 };
 
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+/**
+ * Picks streaming or cached stores at runtime, based on the size of
+ * the grid and the actual last level cache size.
+ */
+class JacobiCellShortVecSwitch
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasCubeTopology<3>,
+        public APITraits::HasSoA
+    {};
+
+    explicit JacobiCellShortVecSwitch(double t = 0) :
+        temp(t)
+    {}
+
+    template<typename HOOD_OLD, typename HOOD_NEW>
+    static void updateLineX(HOOD_OLD& hoodOld, int indexEnd,
+                            HOOD_NEW& hoodNew, int /* nanoStep */)
+    {
+        // old and new grid are both part of the working set:
+        std::size_t workingSetSize = 2 * HOOD_NEW::DIM_PROD * sizeof(double);
+
+        shortVecSwitch<double, 8>(workingSetSize, [&hoodOld, &hoodNew, indexEnd](auto vec) {
+                typedef decltype(vec) ShortVec;
+
+                // peel with respect to the new grid as streaming stores need to be aligned:
+                LibFlatArray::loop_peeler<ShortVec>(
+                    &hoodNew.index(),
+                    long(indexEnd),
+                    [&hoodOld, &hoodNew](auto realVec, long *index, long end) {
+                        typedef decltype(realVec) RealShortVec;
+                        RealShortVec oneSeventh = 1.0 / 7.0;
+
+                        for (; *index < end; *index += RealShortVec::ARITY, hoodOld.index() += RealShortVec::ARITY) {
+                            RealShortVec buf = &hoodOld[FixedCoord< 0,  0, -1>()].temp();
+                            buf += &hoodOld[FixedCoord< 0, -1,  0>()].temp();
+                            buf += &hoodOld[FixedCoord<-1,  0,  0>()].temp();
+                            buf += &hoodOld[FixedCoord< 0,  0,  0>()].temp();
+                            buf += &hoodOld[FixedCoord< 1,  0,  0>()].temp();
+                            buf += &hoodOld[FixedCoord< 0,  1,  0>()].temp();
+                            buf += &hoodOld[FixedCoord< 0,  0,  1>()].temp();
+                            buf *= oneSeventh;
+                            buf.store(&hoodNew.temp());
+                        }
+                    });
+            });
+    }
+
+    double temp;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    JacobiCellShortVecSwitch,
+    ((double)(temp))
+                          )
+
+class Jacobi3DShortVecSwitch : public CPUBenchmark
+{
+public:
+    std::string family()
+    {
+        return "Jacobi3D";
+    }
+
+    std::string species()
+    {
+        return "shortvecswitch";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        int maxT = 20;
+        SerialSimulator<JacobiCellShortVecSwitch> sim(
+            new NoOpInitializer<JacobiCellShortVecSwitch>(dim, maxT));
+
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            sim.run();
+        }
+
+        if (sim.getGrid()->get(Coord<3>(1, 1, 1)).temp == 4711) {
+            std::cout << "this statement just serves to prevent the compiler from"
+                      << "optimizing away the loops above\n";
+        }
+
+        double updates = 1.0 * maxT * dim.prod();
+        double gLUPS = 1e-9 * updates / seconds;
+
+        return gLUPS;
+    }
+
+    std::string unit()
+    {
+        return "GLUPS";
+    }
+};
+
+#endif
+
+/**
+ * Same kernel as in Jacobi3DStreakUpdateFunctor, but generated by
+ * LinearStencil.
+ */
+class JacobiCellLinearStencil
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasCubeTopology<3>,
+        public APITraits::HasSoA
+    {};
+
+    typedef LinearStencil<
+        StencilWeight< 0,  0, -1, 1, 7>,
+        StencilWeight< 0, -1,  0, 1, 7>,
+        StencilWeight<-1,  0,  0, 1, 7>,
+        StencilWeight< 0,  0,  0, 1, 7>,
+        StencilWeight< 1,  0,  0, 1, 7>,
+        StencilWeight< 0,  1,  0, 1, 7>,
+        StencilWeight< 0,  0,  1, 1, 7> > Jacobi;
+
+    explicit JacobiCellLinearStencil(double t = 0) :
+        temp(t)
+    {}
+
+    template<typename HOOD_OLD, typename HOOD_NEW>
+    static void updateLineX(HOOD_OLD& hoodOld, int indexEnd,
+                            HOOD_NEW& hoodNew, int /* nanoStep */)
+    {
+        Jacobi::updateLineX<LibFlatArray::short_vec<double, 8> >(
+            hoodOld, indexEnd, hoodNew, &JacobiCellLinearStencil::temp);
+    }
+
+    double temp;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    JacobiCellLinearStencil,
+    ((double)(temp))
+                          )
+
+class Jacobi3DLinearStencil : public CPUBenchmark
+{
+public:
+    std::string family()
+    {
+        return "Jacobi3D";
+    }
+
+    std::string species()
+    {
+        return "linearstencil";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        int maxT = 20;
+        SerialSimulator<JacobiCellLinearStencil> sim(
+            new NoOpInitializer<JacobiCellLinearStencil>(dim, maxT));
+
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            sim.run();
+        }
+
+        if (sim.getGrid()->get(Coord<3>(1, 1, 1)).temp == 4711) {
+            std::cout << "this statement just serves to prevent the compiler from"
+                      << "optimizing away the loops above\n";
+        }
+
+        double updates = 1.0 * maxT * dim.prod();
+        double gLUPS = 1e-9 * updates / seconds;
+
+        return gLUPS;
+    }
+
+    std::string unit()
+    {
+        return "GLUPS";
+    }
+};
+
 class LBMCell
 {
 public:
@@ -2073,6 +2375,441 @@ public:
     }
 };
 
+/**
+ * Parameters for the Lennard-Jones benchmarks below (in reduced
+ * units, i.e. epsilon = sigma = 1). Boxes are wider than the cutoff
+ * radius, so all interactions are confined to the Moore neighborhood.
+ */
+class LennardJones
+{
+public:
+    static const int PARTICLES_PER_DIM = 3;
+    static const int PARTICLES_PER_BOX = PARTICLES_PER_DIM * PARTICLES_PER_DIM * PARTICLES_PER_DIM;
+    static const int MAX_PARTICLES_PER_BOX = 64;
+    // a commonly used estimate for the cost of one pair interaction,
+    // including the distance computation and cutoff check
+    static const int FLOPS_PER_INTERACTION = 23;
+
+    static double boxSize()
+    {
+        return 2.5;
+    }
+
+    static double cutoff()
+    {
+        return 2.2;
+    }
+
+    static double cutoff2()
+    {
+        return cutoff() * cutoff();
+    }
+
+    static double deltaT()
+    {
+        return 1e-4;
+    }
+
+    /**
+     * Places the particles on a regular lattice, so that forces
+     * remain small and the particles won't leave their boxes during
+     * the few time steps of a benchmark.
+     */
+    template<typename CELL, typename PARTICLE_FACTORY>
+    static void init(Grid<CELL, typename CELL::Topology> *grid, const CoordBox<3>& box, PARTICLE_FACTORY factory)
+    {
+        FloatCoord<3> boxDim(boxSize(), boxSize(), boxSize());
+        double spacing = boxSize() / PARTICLES_PER_DIM;
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            FloatCoord<3> origin = boxDim.scale(*i);
+            CELL cell(origin, boxDim);
+
+            for (int z = 0; z < PARTICLES_PER_DIM; ++z) {
+                for (int y = 0; y < PARTICLES_PER_DIM; ++y) {
+                    for (int x = 0; x < PARTICLES_PER_DIM; ++x) {
+                        FloatCoord<3> offset(x + 0.5, y + 0.5, z + 0.5);
+                        cell.insert(factory(origin + offset * spacing));
+                    }
+                }
+            }
+
+            (*grid)[*i] = cell;
+        }
+    }
+
+    /**
+     * Number of particle pairs considered per time step (including
+     * those beyond the cutoff).
+     */
+    static double interactions(const CoordBox<3>& box)
+    {
+        CoordBox<3> moore(Coord<3>::diagonal(-1), Coord<3>::diagonal(3));
+        double ret = 0;
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            for (CoordBox<3>::Iterator j = moore.begin(); j != moore.end(); ++j) {
+                if (box.inBounds(*i + *j)) {
+                    ret += 1.0 * PARTICLES_PER_BOX * PARTICLES_PER_BOX;
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    template<typename GRID>
+    static double run(GRID *gridOld, GRID *gridNew, const CoordBox<3>& box, int maxT)
+    {
+        typedef typename GRID::Cell CellType;
+        Region<3> region;
+        region << box;
+
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            for (int step = 0; step < maxT; ++step) {
+                UpdateFunctor<CellType>()(
+                    region,
+                    Coord<3>(),
+                    Coord<3>(),
+                    *gridOld,
+                    gridNew,
+                    0);
+                std::swap(gridOld, gridNew);
+            }
+        }
+
+        return seconds;
+    }
+};
+
+/**
+ * AoS particle for use with BoxCell: each particle iterates through
+ * its neighbors individually.
+ */
+class LJParticle
+{
+public:
+    class API : public APITraits::HasCubeTopology<3>
+    {};
+
+    explicit LJParticle(
+        const FloatCoord<3>& pos = FloatCoord<3>(),
+        const FloatCoord<3>& vel = FloatCoord<3>()) :
+        pos(pos),
+        vel(vel)
+    {}
+
+    template<typename HOOD>
+    void update(const HOOD& hood, int /* nanoStep */)
+    {
+        FloatCoord<3> force;
+
+        for (typename HOOD::Iterator i = hood.begin(); i != hood.end(); ++i) {
+            FloatCoord<3> delta = pos - i->pos;
+            double r2 = delta * delta;
+
+            if ((r2 > 0) && (r2 < LennardJones::cutoff2())) {
+                double inv2 = 1.0 / r2;
+                double inv6 = inv2 * inv2 * inv2;
+                force += delta * (24.0 * inv2 * inv6 * (2.0 * inv6 - 1.0));
+            }
+        }
+
+        vel += force * LennardJones::deltaT();
+        pos += vel * LennardJones::deltaT();
+    }
+
+    const FloatCoord<3>& getPos() const
+    {
+        return pos;
+    }
+
+    FloatCoord<3> pos;
+    FloatCoord<3> vel;
+};
+
+/**
+ * Same as LJParticle, but makes BoxCell cache a Verlet list per
+ * particle, so that update() only visits neighbors within cutoff +
+ * skin.
+ */
+class LJParticleVerlet : public LJParticle
+{
+public:
+    class API :
+        public APITraits::HasCubeTopology<3>,
+        public APITraits::HasVerletList
+    {
+    public:
+        static double verletCutoff()
+        {
+            return LennardJones::cutoff();
+        }
+
+        static double verletSkin()
+        {
+            return LennardJones::boxSize() - LennardJones::cutoff();
+        }
+    };
+
+    explicit LJParticleVerlet(
+        const FloatCoord<3>& pos = FloatCoord<3>(),
+        const FloatCoord<3>& vel = FloatCoord<3>()) :
+        LJParticle(pos, vel)
+    {}
+};
+
+/**
+ * SoA counterpart to LJParticle for use with SoABoxCell: forces are
+ * computed for a whole box at once. The inner loop runs over
+ * contiguous coordinate arrays and is branch-free, so the compiler
+ * can vectorize it.
+ */
+class LJParticleSoA
+{
+public:
+    class API : public APITraits::HasCubeTopology<3>
+    {};
+
+    explicit LJParticleSoA(
+        const FloatCoord<3>& pos = FloatCoord<3>(),
+        const FloatCoord<3>& vel = FloatCoord<3>()) :
+        posX(pos[0]),
+        posY(pos[1]),
+        posZ(pos[2]),
+        velX(vel[0]),
+        velY(vel[1]),
+        velZ(vel[2])
+    {}
+
+    template<typename CONTAINER, typename NEIGHBORS>
+    static void updateBox(CONTAINER& particles, const NEIGHBORS& hood, int /* nanoStep */)
+    {
+        int size = particles.size();
+        if (size == 0) {
+            return;
+        }
+
+        double *posX = &particles[0].posX();
+        double *posY = &particles[0].posY();
+        double *posZ = &particles[0].posZ();
+        double *velX = &particles[0].velX();
+        double *velY = &particles[0].velY();
+        double *velZ = &particles[0].velZ();
+        double cutoff2 = LennardJones::cutoff2();
+
+        double forceX[CONTAINER::SIZE];
+        double forceY[CONTAINER::SIZE];
+        double forceZ[CONTAINER::SIZE];
+        for (int i = 0; i < size; ++i) {
+            forceX[i] = 0;
+            forceY[i] = 0;
+            forceZ[i] = 0;
+        }
+
+        // the innermost loop runs over the box' own particles, so
+        // it doesn't need a horizontal reduction when vectorized:
+        for (std::size_t n = 0; n < hood.size(); ++n) {
+            int otherSize = hood[n].size();
+            if (otherSize == 0) {
+                continue;
+            }
+
+            const double *otherX = &hood[n][0].posX();
+            const double *otherY = &hood[n][0].posY();
+            const double *otherZ = &hood[n][0].posZ();
+
+            for (int j = 0; j < otherSize; ++j) {
+                for (int i = 0; i < size; ++i) {
+                    double deltaX = posX[i] - otherX[j];
+                    double deltaY = posY[i] - otherY[j];
+                    double deltaZ = posZ[i] - otherZ[j];
+                    double r2 = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
+
+                    double mask = ((r2 > 0) & (r2 < cutoff2)) ? 1.0 : 0.0;
+                    double inv2 = mask / (r2 + 1.0 - mask);
+                    double inv6 = inv2 * inv2 * inv2;
+                    double scalar = 24.0 * inv2 * inv6 * (2.0 * inv6 - 1.0);
+
+                    forceX[i] += deltaX * scalar;
+                    forceY[i] += deltaY * scalar;
+                    forceZ[i] += deltaZ * scalar;
+                }
+            }
+        }
+
+        for (int i = 0; i < size; ++i) {
+            velX[i] += forceX[i] * LennardJones::deltaT();
+            velY[i] += forceY[i] * LennardJones::deltaT();
+            velZ[i] += forceZ[i] * LennardJones::deltaT();
+        }
+
+        for (int i = 0; i < size; ++i) {
+            posX[i] += velX[i] * LennardJones::deltaT();
+            posY[i] += velY[i] * LennardJones::deltaT();
+            posZ[i] += velZ[i] * LennardJones::deltaT();
+        }
+    }
+
+    double posX;
+    double posY;
+    double posZ;
+    double velX;
+    double velY;
+    double velZ;
+};
+
+LIBFLATARRAY_REGISTER_SOA(
+    LJParticleSoA,
+    ((double)(posX))
+    ((double)(posY))
+    ((double)(posZ))
+    ((double)(velX))
+    ((double)(velY))
+    ((double)(velZ))
+                          )
+
+template<typename PARTICLE>
+class LJParticleFactory
+{
+public:
+    PARTICLE operator()(const FloatCoord<3>& pos) const
+    {
+        return PARTICLE(pos);
+    }
+};
+
+class LennardJonesBoxCell : public CPUBenchmark
+{
+public:
+    typedef BoxCell<FixedArray<LJParticle, LennardJones::MAX_PARTICLES_PER_BOX> > CellType;
+    typedef Grid<CellType, CellType::Topology> GridType;
+
+    std::string family()
+    {
+        return "LennardJones";
+    }
+
+    std::string species()
+    {
+        return "bronze";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        CoordBox<3> box(Coord<3>(), Coord<3>(rawDim[0], rawDim[1], rawDim[2]));
+        int maxT = 5;
+        GridType gridOld(box.dimensions);
+        GridType gridNew(box.dimensions);
+        LennardJones::init(&gridOld, box, LJParticleFactory<LJParticle>());
+
+        double seconds = LennardJones::run(&gridOld, &gridNew, box, maxT);
+
+        if (gridOld[Coord<3>(1, 1, 1)].size() == 4711) {
+            std::cout << "this statement just serves to prevent the compiler from"
+                      << "optimizing away the loops above\n";
+        }
+
+        double flops = 1.0 * maxT * LennardJones::interactions(box) * LennardJones::FLOPS_PER_INTERACTION;
+        return 1e-9 * flops / seconds;
+    }
+
+    std::string unit()
+    {
+        return "GFLOPS";
+    }
+};
+
+/**
+ * Performance is given relative to the full neighborhood search (as
+ * for the other Lennard-Jones benchmarks) to reflect the reduced
+ * time to solution.
+ */
+class LennardJonesBoxCellVerlet : public CPUBenchmark
+{
+public:
+    typedef BoxCell<FixedArray<LJParticleVerlet, LennardJones::MAX_PARTICLES_PER_BOX> > CellType;
+    typedef Grid<CellType, CellType::Topology> GridType;
+
+    std::string family()
+    {
+        return "LennardJones";
+    }
+
+    std::string species()
+    {
+        return "silver";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        CoordBox<3> box(Coord<3>(), Coord<3>(rawDim[0], rawDim[1], rawDim[2]));
+        int maxT = 5;
+        GridType gridOld(box.dimensions);
+        GridType gridNew(box.dimensions);
+        LennardJones::init(&gridOld, box, LJParticleFactory<LJParticleVerlet>());
+
+        double seconds = LennardJones::run(&gridOld, &gridNew, box, maxT);
+
+        if (gridOld[Coord<3>(1, 1, 1)].size() == 4711) {
+            std::cout << "this statement just serves to prevent the compiler from"
+                      << "optimizing away the loops above\n";
+        }
+
+        double flops = 1.0 * maxT * LennardJones::interactions(box) * LennardJones::FLOPS_PER_INTERACTION;
+        return 1e-9 * flops / seconds;
+    }
+
+    std::string unit()
+    {
+        return "GFLOPS";
+    }
+};
+
+class LennardJonesSoABoxCell : public CPUBenchmark
+{
+public:
+    typedef SoABoxCell<LJParticleSoA, LennardJones::MAX_PARTICLES_PER_BOX> CellType;
+    typedef Grid<CellType, CellType::Topology> GridType;
+
+    std::string family()
+    {
+        return "LennardJones";
+    }
+
+    std::string species()
+    {
+        return "gold";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        CoordBox<3> box(Coord<3>(), Coord<3>(rawDim[0], rawDim[1], rawDim[2]));
+        int maxT = 5;
+        GridType gridOld(box.dimensions);
+        GridType gridNew(box.dimensions);
+        LennardJones::init(&gridOld, box, LJParticleFactory<LJParticleSoA>());
+
+        double seconds = LennardJones::run(&gridOld, &gridNew, box, maxT);
+
+        if (gridOld[Coord<3>(1, 1, 1)].size() == 4711) {
+            std::cout << "this statement just serves to prevent the compiler from"
+                      << "optimizing away the loops above\n";
+        }
+
+        double flops = 1.0 * maxT * LennardJones::interactions(box) * LennardJones::FLOPS_PER_INTERACTION;
+        return 1e-9 * flops / seconds;
+    }
+
+    std::string unit()
+    {
+        return "GFLOPS";
+    }
+};
+
 template<class PARTITION>
 class PartitionBenchmark : public CPUBenchmark
 {
@@ -2093,22 +2830,27 @@ public:
 
     double performance(std::vector<int> rawDim)
     {
-        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
         double duration = 0;
-        Coord<2> accu;
-        Coord<2> realDim(dim.x(), dim.y());
+        Coord<DIM> accu;
+        Coord<DIM> origin;
+        Coord<DIM> realDim;
+        for (int d = 0; d < DIM; ++d) {
+            realDim[d] = rawDim[d];
+        }
+        origin[0] = 100;
+        origin[1] = 200;
 
         {
             ScopedTimer t(&duration);
 
-            PARTITION h(Coord<2>(100, 200), realDim);
+            PARTITION h(origin, realDim);
             typename PARTITION::Iterator end = h.end();
             for (typename PARTITION::Iterator i = h.begin(); i != end; ++i) {
                 accu += *i;
             }
         }
 
-        if (accu == Coord<2>()) {
+        if (accu == Coord<DIM>()) {
             throw std::runtime_error("oops, partition iteration went bad!");
         }
 
@@ -2121,7 +2863,65 @@ public:
     }
 
 private:
+    static const int DIM = PARTITION::DIM;
+
+    std::string name;
+};
+
+/**
+ * Measures the quality of a decomposition: the number of halo cells
+ * per owned cell, averaged over all nodes. Lower is better as it
+ * translates to less ghost zone traffic.
+ */
+template<class PARTITION>
+class PartitionSurfaceBenchmark : public CPUBenchmark
+{
+public:
+    explicit PartitionSurfaceBenchmark(const std::string& name, int numNodes = 64) :
+        name(name),
+        numNodes(numNodes)
+    {}
+
+    std::string species()
+    {
+        return "gold";
+    }
+
+    std::string family()
+    {
+        return name;
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<DIM> dim;
+        for (int d = 0; d < DIM; ++d) {
+            dim[d] = rawDim[d];
+        }
+
+        std::vector<std::size_t> weights(numNodes, dim.prod() / numNodes);
+        weights.back() += dim.prod() - sum(weights);
+        PARTITION partition(Coord<DIM>(), dim, 0, weights);
+
+        double ratio = 0;
+        for (int i = 0; i < numNodes; ++i) {
+            Region<DIM> region = partition.getRegion(i);
+            ratio += 1.0 * (region.expand(1) - region).size() / region.size();
+        }
+
+        return ratio / numNodes;
+    }
+
+    std::string unit()
+    {
+        return "halo/volume";
+    }
+
+private:
+    static const int DIM = PARTITION::DIM;
+
     std::string name;
+    int numNodes;
 };
 
 #ifdef LIBGEODECOMP_WITH_CPP14
@@ -2745,10 +3545,11 @@ public:
 #endif
 #endif
 
+template<typename CONCURRENCY_SPEC>
 class UpdateFunctorThreadingBase : public CPUBenchmark
 {
 public:
-    typedef UpdateFunctorHelpers::ConcurrencyEnableOpenMP MyConcurrencySpec;
+    typedef CONCURRENCY_SPEC MyConcurrencySpec;
     typedef UpdateFunctor<JacobiCellFixedHood, MyConcurrencySpec> MyUpdateFunctor;
 
     std::string family()
@@ -2812,7 +3613,7 @@ private:
     virtual MyConcurrencySpec generateConcurrencySpec() = 0;
 };
 
-class UpdateFunctorThreadingGold : public UpdateFunctorThreadingBase
+class UpdateFunctorThreadingGold : public UpdateFunctorThreadingBase<UpdateFunctorHelpers::ConcurrencyEnableOpenMP>
 {
 public:
 
@@ -2828,7 +3629,7 @@ private:
     }
 };
 
-class UpdateFunctorThreadingSilver : public UpdateFunctorThreadingBase
+class UpdateFunctorThreadingSilver : public UpdateFunctorThreadingBase<UpdateFunctorHelpers::ConcurrencyEnableOpenMP>
 {
 public:
 
@@ -2844,40 +3645,49 @@ private:
     }
 };
 
-#ifdef LIBGEODECOMP_WITH_CUDA
-void cudaTests(std::string name, std::string revision, int cudaDevice);
-#endif
-
-int main(int argc, char **argv)
+#ifdef LIBGEODECOMP_WITH_THREADS
+class UpdateFunctorThreadingWorkStealing : public UpdateFunctorThreadingBase<UpdateFunctorHelpers::ConcurrencyEnableThreadPool>
 {
-    if ((argc < 3) || (argc == 4) || (argc > 5)) {
-        std::cerr << "usage: " << argv[0] << " [-n,--name SUBSTRING] REVISION CUDA_DEVICE \n"
-                  << "  - optional: only run tests whose name contains a SUBSTRING,\n"
-                  << "  - REVISION is purely for output reasons,\n"
-                  << "  - CUDA_DEVICE causes CUDA tests to run on the device with the given ID.\n";
-        return 1;
+public:
+
+    std::string species()
+    {
+        return "workstealing";
     }
 
-    std::string name = "";
-    int argumentIndex = 1;
-    if (argc == 5) {
-        if ((std::string(argv[1]) == "-n") ||
-            (std::string(argv[1]) == "--name")) {
-            name = std::string(argv[2]);
-        }
-        argumentIndex = 3;
+private:
+    MyConcurrencySpec generateConcurrencySpec()
+    {
+        return MyConcurrencySpec(true, false);
     }
-    std::string revision = argv[argumentIndex + 0];
+};
 
-    std::stringstream s;
-    s << argv[argumentIndex + 1];
-    int cudaDevice;
-    s >> cudaDevice;
+class UpdateFunctorThreadingWorkStealingFine : public UpdateFunctorThreadingBase<UpdateFunctorHelpers::ConcurrencyEnableThreadPool>
+{
+public:
 
-    LibFlatArray::evaluate eval(name, revision);
-    eval.print_header();
+    std::string species()
+    {
+        return "workstealingfine";
+    }
+
+private:
+    MyConcurrencySpec generateConcurrencySpec()
+    {
+        return MyConcurrencySpec(true, true);
+    }
+};
+#endif
+
+#ifdef LIBGEODECOMP_WITH_CUDA
+void cudaTests(BenchmarkHarness& harness, int cudaDevice);
+#endif
 
+void runBenchmarks(BenchmarkHarness& eval, int cudaDevice)
+{
     std::vector<Coord<3> > sizes;
+    std::vector<int> minDim = toVector(Coord<3>( 128,  128,  128));
+    std::vector<int> maxDim = toVector(Coord<3>(2048, 2048, 2048));
 
 #ifdef LIBGEODECOMP_WITH_CPP14
     sizes << Coord<3>(10648 , 1, 1)
@@ -2907,37 +3717,21 @@ int main(int argc, char **argv)
     sizes.clear();
 #endif
 
-    eval(RegionCount(), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionCount(), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionCount(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionCount(), minDim, maxDim, 4);
 
-    eval(RegionInsert(), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionInsert(), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionInsert(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionInsert(), minDim, maxDim, 4);
 
-    eval(RegionIntersect(), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionIntersect(), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionIntersect(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionIntersect(), minDim, maxDim, 4);
 
-    eval(RegionSubtract(), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionSubtract(), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionSubtract(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionSubtract(), minDim, maxDim, 4);
 
-    eval(RegionUnion(), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionUnion(), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionUnion(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionUnion(), minDim, maxDim, 4);
 
-    eval(RegionAppend(), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionAppend(), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionAppend(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionAppend(), minDim, maxDim, 4);
 
-    eval(RegionExpand(1), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionExpand(1), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionExpand(1), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionExpand(1), minDim, maxDim, 4);
 
-    eval(RegionExpand(5), toVector(Coord<3>( 128,  128,  128)));
-    eval(RegionExpand(5), toVector(Coord<3>( 512,  512,  512)));
-    eval(RegionExpand(5), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(RegionExpand(5), minDim, maxDim, 4);
 
     {
         std::vector<int> params(4);
@@ -2966,20 +3760,21 @@ int main(int argc, char **argv)
         eval(RegionExpandWithAdjacency(cells), params);
     }
 
-    eval(CoordEnumerationVanilla(), toVector(Coord<3>( 128,  128,  128)));
-    eval(CoordEnumerationVanilla(), toVector(Coord<3>( 512,  512,  512)));
-    eval(CoordEnumerationVanilla(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(CoordEnumerationVanilla(), minDim, maxDim, 4);
 
-    eval(CoordEnumerationBronze(), toVector(Coord<3>( 128,  128,  128)));
-    eval(CoordEnumerationBronze(), toVector(Coord<3>( 512,  512,  512)));
-    eval(CoordEnumerationBronze(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(CoordEnumerationBronze(), minDim, maxDim, 4);
 
-    eval(CoordEnumerationGold(), toVector(Coord<3>( 128,  128,  128)));
-    eval(CoordEnumerationGold(), toVector(Coord<3>( 512,  512,  512)));
-    eval(CoordEnumerationGold(), toVector(Coord<3>(2048, 2048, 2048)));
+    eval.sweep(CoordEnumerationGold(), minDim, maxDim, 4);
 
     eval(FloatCoordAccumulationGold(), toVector(Coord<3>(2048, 2048, 2048)));
 
+    for (int numPoints = 100; numPoints <= 10000; numPoints *= 10) {
+        std::vector<int> params;
+        params << 1000 << numPoints;
+        eval(ConvexPolytopeCuttingBronze(), params);
+        eval(ConvexPolytopeCuttingGold(), params);
+    }
+
     sizes << Coord<3>(22, 22, 22)
           << Coord<3>(64, 64, 64)
           << Coord<3>(68, 68, 68)
@@ -3016,6 +3811,16 @@ int main(int argc, char **argv)
         eval(Jacobi3DStreakUpdateFunctor(), toVector(sizes[i]));
     }
 
+#ifdef LIBGEODECOMP_WITH_CPP14
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        eval(Jacobi3DShortVecSwitch(), toVector(sizes[i]));
+    }
+#endif
+
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        eval(Jacobi3DLinearStencil(), toVector(sizes[i]));
+    }
+
     sizes.clear();
     sizes << Coord<3>(22, 22, 22)
           << Coord<3>(64, 64, 64)
@@ -3033,19 +3838,149 @@ int main(int argc, char **argv)
         eval(LBMSoA(), toVector(sizes[i]));
     }
 
+    sizes.clear();
+    sizes << Coord<3>(8, 8, 8)
+          << Coord<3>(16, 16, 16);
+
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        eval(LennardJonesBoxCell(), toVector(sizes[i]));
+    }
+
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        eval(LennardJonesBoxCellVerlet(), toVector(sizes[i]));
+    }
+
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        eval(LennardJonesSoABoxCell(), toVector(sizes[i]));
+    }
+
     std::vector<int> dim = toVector(Coord<3>(32 * 1024, 32 * 1024, 1));
     eval(PartitionBenchmark<HIndexingPartition   >("PartitionHIndexing"), dim);
     eval(PartitionBenchmark<StripingPartition<2> >("PartitionStriping"),  dim);
     eval(PartitionBenchmark<HilbertPartition     >("PartitionHilbert"),   dim);
     eval(PartitionBenchmark<ZCurvePartition<2>   >("PartitionZCurve"),    dim);
 
+    dim = toVector(Coord<3>(256, 256, 256));
+    eval(PartitionBenchmark<Hilbert3DPartition>("PartitionHilbert3D"), dim);
+    eval(PartitionBenchmark<ZCurvePartition<3> >("PartitionZCurve3D"),  dim);
+
+    dim = toVector(Coord<3>(200, 160, 120));
+    eval(PartitionSurfaceBenchmark<Hilbert3DPartition>("PartitionSurfaceHilbert3D"), dim);
+    eval(PartitionSurfaceBenchmark<ZCurvePartition<3> >("PartitionSurfaceZCurve3D"),  dim);
+
     dim = toVector(Coord<3>(10000, 2000, 0));
     eval(UpdateFunctorThreadingSilver(), dim);
     eval(UpdateFunctorThreadingGold(), dim);
+#ifdef LIBGEODECOMP_WITH_THREADS
+    eval(UpdateFunctorThreadingWorkStealing(), dim);
+    eval(UpdateFunctorThreadingWorkStealingFine(), dim);
+#endif
 
 #ifdef LIBGEODECOMP_WITH_CUDA
-    cudaTests(name, revision, cudaDevice);
+    cudaTests(eval, cudaDevice);
 #endif
+}
+
+void usage(const std::string& program)
+{
+    std::cerr << "usage: " << program << " [OPTIONS] [REVISION [CUDA_DEVICE]]\n"
+              << "  -n, --name SUBSTRING  only run tests whose name contains SUBSTRING,\n"
+              << "  --warmup N            number of untimed runs per test (default: 1),\n"
+              << "  --repeat N            number of timed runs per test (default: 5),\n"
+              << "  --pin CPU             pin the benchmark to the given CPU,\n"
+              << "  --format FORMAT       text, csv or json (default: text),\n"
+              << "  --output FILE         write results to FILE instead of stdout,\n"
+              << "  --compare BASELINE    compare results to a previous run (CSV or JSON)\n"
+              << "                        and exit with 2 if there were any regressions,\n"
+              << "  --threshold FRACTION  tolerated slowdown for --compare (default: 0.05),\n"
+              << "  - REVISION is purely for output reasons,\n"
+              << "  - CUDA_DEVICE causes CUDA tests to run on the device with the given ID.\n";
+}
+
+int main(int argc, char **argv)
+{
+    std::string name = "";
+    std::string revision = "unknown";
+    int cudaDevice = 0;
+    int warmups = 1;
+    int repetitions = 5;
+    BenchmarkHarness::Format format = BenchmarkHarness::TEXT;
+    std::string outputFilename;
+    std::string baselineFilename;
+    double threshold = 0.05;
+    StringVec positionalArguments;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            bool hasValue = (i + 1) < argc;
+
+            if (((argument == "-n") || (argument == "--name")) && hasValue) {
+                name = argv[++i];
+            } else if ((argument == "--warmup") && hasValue) {
+                warmups = StringOps::atoi(argv[++i]);
+            } else if ((argument == "--repeat") && hasValue) {
+                repetitions = StringOps::atoi(argv[++i]);
+            } else if ((argument == "--pin") && hasValue) {
+                BenchmarkHarness::pin(StringOps::atoi(argv[++i]));
+            } else if ((argument == "--format") && hasValue) {
+                format = BenchmarkHarness::parseFormat(argv[++i]);
+            } else if ((argument == "--output") && hasValue) {
+                outputFilename = argv[++i];
+            } else if ((argument == "--compare") && hasValue) {
+                baselineFilename = argv[++i];
+            } else if ((argument == "--threshold") && hasValue) {
+                threshold = StringOps::atof(argv[++i]);
+            } else if ((argument.size() > 0) && (argument[0] == '-')) {
+                usage(argv[0]);
+                return 1;
+            } else {
+                positionalArguments << argument;
+            }
+        }
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << "\n";
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (positionalArguments.size() > 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (positionalArguments.size() > 0) {
+        revision = positionalArguments[0];
+    }
+    if (positionalArguments.size() > 1) {
+        cudaDevice = StringOps::atoi(positionalArguments[1]);
+    }
+
+    std::ofstream outputFile;
+    if (!outputFilename.empty()) {
+        outputFile.open(outputFilename.c_str());
+    }
+
+    int regressions = 0;
+    {
+        BenchmarkHarness eval(
+            name,
+            revision,
+            warmups,
+            repetitions,
+            format,
+            outputFilename.empty() ? &std::cout : &outputFile);
+        if (!baselineFilename.empty()) {
+            eval.loadBaseline(baselineFilename, threshold);
+        }
+        eval.printHeader();
+        runBenchmarks(eval, cudaDevice);
+        regressions = eval.numRegressions();
+    }
+
+    if (regressions > 0) {
+        std::cerr << regressions << " regression(s) detected\n";
+        return 2;
+    }
 
     return 0;
 }
@@ -17,6 +17,10 @@
 #include <libgeodecomp/misc/chronometer.h>
 #include <libgeodecomp/geometry/coord.h>
 #include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/storage/sellcsigmadeltacolumncontainer.h>
+#include <libgeodecomp/storage/sellcsigmadictionarycontainer.h>
+#include <libgeodecomp/storage/sellcsigmamatrixfreecontainer.h>
+#include <libgeodecomp/storage/unstructuredblockmultiply.h>
 #include <libgeodecomp/storage/unstructuredgrid.h>
 #include <libgeodecomp/storage/unstructuredneighborhood.h>
 #include <libgeodecomp/storage/unstructuredsoagrid.h>
@@ -154,6 +158,70 @@ LIBFLATARRAY_REGISTER_SOA(SPMVMSoACell<65536>, ((double)(sum))((double)(value)))
 LIBFLATARRAY_REGISTER_SOA(SPMVMSoACell<131072>, ((double)(sum))((double)(value)))
 LIBFLATARRAY_REGISTER_SOA(SPMVMSoACell<262144>, ((double)(sum))((double)(value)))
 
+/**
+ * Multiplies BLOCK_SIZE vectors with the same matrix, all within a
+ * single traversal of the weights.
+ */
+template<int BLOCK_SIZE>
+class SPMVMBlockSoACell
+{
+public:
+    class API :
+        public APITraits::HasSoA,
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasUnstructuredTopology,
+        public APITraits::HasSellType<double>,
+        public APITraits::HasSellMatrices<1>,
+        public APITraits::HasSellC<C>,
+        public APITraits::HasSellSigma<1>,
+        public APITraits::HasSellBlockSize<BLOCK_SIZE>,
+        public LibFlatArray::api_traits::has_default_1d_sizes
+    {};
+
+    typedef short_vec<double, C> ShortVec;
+
+    inline explicit SPMVMBlockSoACell(double v = 8.0)
+    {
+        for (int k = 0; k < BLOCK_SIZE; ++k) {
+            value[k] = v + k;
+            sum[k] = 0;
+        }
+    }
+
+    template<typename HOOD_NEW, typename HOOD_OLD>
+    static void updateLineX(HOOD_NEW& hoodNew, int indexEnd, HOOD_OLD& hoodOld, unsigned /* nanoStep */)
+    {
+        const long strideOld = HOOD_OLD::SoAAccessor::DIM_PROD;
+        const long strideNew = HOOD_NEW::SoAAccessor::DIM_PROD;
+        const double *sources[BLOCK_SIZE];
+        for (int k = 0; k < BLOCK_SIZE; ++k) {
+            sources[k] = &hoodOld->template value<0>() + k * strideOld;
+        }
+
+        // no loop peeler required here, see SPMVMSoACell
+        for (; hoodNew.index() < indexEnd; hoodNew += C, ++hoodOld) {
+            ShortVec tmp[BLOCK_SIZE];
+            for (int k = 0; k < BLOCK_SIZE; ++k) {
+                tmp[k].load_aligned(&hoodNew->template sum<0>() + k * strideNew);
+            }
+
+            unstructuredBlockMultiply(hoodOld, sources, tmp);
+
+            for (int k = 0; k < BLOCK_SIZE; ++k) {
+                tmp[k].store_aligned(&hoodNew->template sum<0>() + k * strideNew);
+            }
+        }
+    }
+
+    double value[BLOCK_SIZE];
+    double sum[BLOCK_SIZE];
+};
+
+LIBFLATARRAY_REGISTER_SOA(SPMVMBlockSoACell<1>, ((double)(sum)(1))((double)(value)(1)))
+LIBFLATARRAY_REGISTER_SOA(SPMVMBlockSoACell<2>, ((double)(sum)(2))((double)(value)(2)))
+LIBFLATARRAY_REGISTER_SOA(SPMVMBlockSoACell<4>, ((double)(sum)(4))((double)(value)(4)))
+LIBFLATARRAY_REGISTER_SOA(SPMVMBlockSoACell<8>, ((double)(sum)(8))((double)(value)(8)))
+
 #define SPMVM_TESTS(METHOD, MATRIX)                                     \
     do {                                                                \
         eval(METHOD<SPMVMSoACell<1     >, MATRIX, NZ, 1>(), toVector(Coord<3>(DIM, 1, 1))); \
@@ -171,6 +239,58 @@ LIBFLATARRAY_REGISTER_SOA(SPMVMSoACell<262144>, ((double)(sum))((double)(value))
         eval(METHOD<SPMVMSoACell<262144>, MATRIX, NZ, 262144>(), toVector(Coord<3>(DIM, 1, 1))); \
     } while (0)
 
+#define SPMVM_BACKEND_TESTS(METHOD, MATRIX, SIGMA)                      \
+    do {                                                                \
+        eval(METHOD<SPMVMSoACell<SIGMA>, MATRIX, NZ, SIGMA, SellCSigmaDeltaColumnContainer<double, C, SIGMA> >(), toVector(Coord<3>(DIM, 1, 1))); \
+        eval(METHOD<SPMVMSoACell<SIGMA>, MATRIX, NZ, SIGMA, SellCSigmaDictionaryContainer<double, C, SIGMA> >(), toVector(Coord<3>(DIM, 1, 1))); \
+    } while (0)
+
+/**
+ * Maps weight storage backends to a name for the benchmark output.
+ */
+template<typename MATRIX>
+class BackendName;
+
+template<int SIGMA>
+class BackendName<SellCSigmaSparseMatrixContainer<double, C, SIGMA> >
+{
+public:
+    static std::string value()
+    {
+        return "SELL";
+    }
+};
+
+template<int SIGMA>
+class BackendName<SellCSigmaDeltaColumnContainer<double, C, SIGMA> >
+{
+public:
+    static std::string value()
+    {
+        return "SELL_DELTA16";
+    }
+};
+
+template<int SIGMA>
+class BackendName<SellCSigmaDictionaryContainer<double, C, SIGMA> >
+{
+public:
+    static std::string value()
+    {
+        return "SELL_DICT";
+    }
+};
+
+template<typename FUNCTOR>
+class BackendName<SellCSigmaMatrixFreeContainer<double, C, FUNCTOR> >
+{
+public:
+    static std::string value()
+    {
+        return "MATRIX_FREE";
+    }
+};
+
 /**
  * For reference performance of SELL, we also measure the performance of
  * compressed row storage. This class initializes the datastructures needed
@@ -343,11 +463,16 @@ public:
     }
 };
 
-template<typename CELL, std::string& FILENAME, int NZ, int SIGMA>
+template<
+    typename CELL,
+    std::string& FILENAME,
+    int NZ,
+    int SIGMA,
+    typename MATRIX = SellCSigmaSparseMatrixContainer<double, C, SIGMA> >
 class SparseMatrixVectorMultiplicationMM : public CPUBenchmark
 {
 private:
-    typedef UnstructuredSoAGrid<CELL, 1, double, C, SIGMA> Grid;
+    typedef UnstructuredSoAGrid<CELL, 1, double, C, SIGMA, MATRIX> Grid;
 
     void updateFunctor(const Region<1>& region, const Grid& gridOld,
                        Grid *gridNew, unsigned nanoStep)
@@ -365,6 +490,9 @@ public:
     {
         std::stringstream ss;
         ss << "SPMVM: C:" << C << " SIGMA:" << SIGMA;
+        if (BackendName<MATRIX>::value() != "SELL") {
+            ss << " " << BackendName<MATRIX>::value();
+        }
         return ss.str();
     }
 
@@ -384,7 +512,13 @@ public:
         // 2. init grid old
         const int maxT = 1;
         SparseMatrixInitializerMM<CELL, Grid> init(FILENAME, dim, maxT);
-        init.grid(&gridOld);
+        try {
+            init.grid(&gridOld);
+        } catch (const std::logic_error& e) {
+            // compressed backends may reject matrices they can't encode
+            LOG(WARN, "skipping " << family() << " for " << FILENAME << ": " << e.what());
+            return 0;
+        }
 
         // 3. call updateFunctor()
         double seconds = 0;
@@ -411,6 +545,207 @@ public:
     }
 };
 
+/**
+ * Weights of a 1D stencil with 2 * RADIUS + 1 points and non-periodic
+ * boundaries. Serves as a stand-in for stencil-like unstructured
+ * meshes whose weights can be computed instead of loaded.
+ */
+template<int RADIUS>
+class BandedStencilWeights
+{
+public:
+    explicit BandedStencilWeights(int dim = 0) :
+        dim(dim)
+    {}
+
+    inline int rowLength(int row) const
+    {
+        int first = (std::max)(row - RADIUS, 0);
+        int last  = (std::min)(row + RADIUS, dim - 1);
+        return last - first + 1;
+    }
+
+    inline void operator()(int row, int element, int *column, double *weight) const
+    {
+        *column = (std::max)(row - RADIUS, 0) + element;
+        *weight = (*column == row) ? (2.0 * RADIUS) : -1.0;
+    }
+
+    std::vector<std::pair<Coord<2>, double> > matrix() const
+    {
+        std::vector<std::pair<Coord<2>, double> > ret;
+
+        for (int row = 0; row < dim; ++row) {
+            for (int element = 0; element < rowLength(row); ++element) {
+                int column;
+                double weight;
+                (*this)(row, element, &column, &weight);
+                ret << std::make_pair(Coord<2>(row, column), weight);
+            }
+        }
+
+        return ret;
+    }
+
+private:
+    int dim;
+};
+
+/**
+ * Compares SpMV on a banded matrix stored in the given MATRIX
+ * container with the same matrix being computed on the fly by a
+ * SellCSigmaMatrixFreeContainer.
+ */
+template<typename CELL, int RADIUS, typename MATRIX>
+class SparseMatrixVectorMultiplicationStencil : public CPUBenchmark
+{
+private:
+    typedef UnstructuredSoAGrid<CELL, 1, double, C, 1, MATRIX> Grid;
+    typedef BandedStencilWeights<RADIUS> Weights;
+
+    template<typename MATRIX_TYPE>
+    void initWeights(Grid *grid, int dim, const MATRIX_TYPE *)
+    {
+        grid->setWeights(0, Weights(dim).matrix());
+    }
+
+    void initWeights(Grid *grid, int dim, const SellCSigmaMatrixFreeContainer<double, C, Weights> *)
+    {
+        grid->getWeights(0) = SellCSigmaMatrixFreeContainer<double, C, Weights>(dim, Weights(dim));
+    }
+
+    void updateFunctor(const Region<1>& region, const Grid& gridOld,
+                       Grid *gridNew, unsigned nanoStep)
+    {
+        typedef LibGeoDecomp::UpdateFunctorHelpers::ConcurrencyEnableOpenMP ConcurrencySpec;
+        typedef typename APITraits::SelectThreadedUpdate<CELL>::Value ModelThreadingSpec;
+        gridOld.callback(
+            gridNew,
+            UnstructuredUpdateFunctorHelpers::UnstructuredGridSoAUpdateHelper<CELL, Grid, ConcurrencySpec, ModelThreadingSpec>(
+                gridOld, gridNew, region, nanoStep, ConcurrencySpec(true, true), ModelThreadingSpec()));
+    }
+
+public:
+    std::string family()
+    {
+        std::stringstream ss;
+        ss << "SPMVMStencil: C:" << C << " RADIUS:" << RADIUS;
+        return ss.str();
+    }
+
+    std::string species()
+    {
+        return BackendName<MATRIX>::value();
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        const CoordBox<1> size(Coord<1>(0), Coord<1>(rawDim[0]));
+        Grid gridOld(size);
+        Grid gridNew(size);
+        initWeights(&gridOld, size.dimensions.x(), static_cast<MATRIX*>(0));
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>(0), size.dimensions.x());
+
+        const int repeats = 10;
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+            for (int i = 0; i < repeats; ++i) {
+                updateFunctor(region, gridOld, &gridNew, 0);
+            }
+        }
+
+        if (gridNew.get(Coord<1>(1)).sum == 4711) {
+            std::cout << "this statement just serves to prevent the compiler from"
+                      << "optimizing away the loops above\n";
+        }
+
+        const double nonZeros = size.dimensions.x() * (2.0 * RADIUS + 1);
+        const double gflops = 1.0e-9 * 2.0 * nonZeros * repeats / seconds;
+        return gflops;
+    }
+
+    std::string unit()
+    {
+        return "GFLOP/s";
+    }
+};
+
+/**
+ * Block SpMV on a banded matrix: BLOCK_SIZE vectors are being
+ * multiplied per traversal of the weights. Performance is given for
+ * all vectors combined, so BLOCK_SIZE 1 yields the baseline.
+ */
+template<int BLOCK_SIZE, int RADIUS>
+class SparseMatrixVectorMultiplicationBlock : public CPUBenchmark
+{
+private:
+    typedef SPMVMBlockSoACell<BLOCK_SIZE> Cell;
+    typedef UnstructuredSoAGrid<Cell, 1, double, C, 1> Grid;
+
+    void updateFunctor(const Region<1>& region, const Grid& gridOld,
+                       Grid *gridNew, unsigned nanoStep)
+    {
+        typedef LibGeoDecomp::UpdateFunctorHelpers::ConcurrencyEnableOpenMP ConcurrencySpec;
+        typedef typename APITraits::SelectThreadedUpdate<Cell>::Value ModelThreadingSpec;
+        gridOld.callback(
+            gridNew,
+            UnstructuredUpdateFunctorHelpers::UnstructuredGridSoAUpdateHelper<Cell, Grid, ConcurrencySpec, ModelThreadingSpec>(
+                gridOld, gridNew, region, nanoStep, ConcurrencySpec(true, true), ModelThreadingSpec()));
+    }
+
+public:
+    std::string family()
+    {
+        std::stringstream ss;
+        ss << "SPMVMBlock: C:" << C << " RADIUS:" << RADIUS;
+        return ss.str();
+    }
+
+    std::string species()
+    {
+        std::stringstream ss;
+        ss << "k:" << BLOCK_SIZE;
+        return ss.str();
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        const CoordBox<1> size(Coord<1>(0), Coord<1>(rawDim[0]));
+        Grid gridOld(size);
+        Grid gridNew(size);
+        gridOld.setWeights(0, BandedStencilWeights<RADIUS>(size.dimensions.x()).matrix());
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>(0), size.dimensions.x());
+
+        const int repeats = 10;
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+            for (int i = 0; i < repeats; ++i) {
+                updateFunctor(region, gridOld, &gridNew, 0);
+            }
+        }
+
+        if (gridNew.get(Coord<1>(1)).sum[0] == 4711) {
+            std::cout << "this statement just serves to prevent the compiler from"
+                      << "optimizing away the loops above\n";
+        }
+
+        const double nonZeros = size.dimensions.x() * (2.0 * RADIUS + 1);
+        const double gflops = 1.0e-9 * 2.0 * nonZeros * BLOCK_SIZE * repeats / seconds;
+        return gflops;
+    }
+
+    std::string unit()
+    {
+        return "GFLOP/s";
+    }
+};
+
 #ifdef __AVX__
 template<typename CELL, std::string& FILENAME, int NZ, int SIGMA>
 class SparseMatrixVectorMultiplicationMMNative : public CPUBenchmark
@@ -882,6 +1217,25 @@ int main(int argc, char **argv)
     evaluate eval(name, revision);
     eval.print_header();
 
+    // synthetic stencil: stored vs. compressed vs. matrix-free weights
+    {
+        typedef SPMVMSoACell<1> Cell;
+        const int DIM = 1 << 22;
+        eval(SparseMatrixVectorMultiplicationStencil<Cell, 3, SellCSigmaSparseMatrixContainer<double, C, 1> >(), toVector(Coord<3>(DIM, 1, 1)));
+        eval(SparseMatrixVectorMultiplicationStencil<Cell, 3, SellCSigmaDeltaColumnContainer<double, C, 1> >(), toVector(Coord<3>(DIM, 1, 1)));
+        eval(SparseMatrixVectorMultiplicationStencil<Cell, 3, SellCSigmaDictionaryContainer<double, C, 1> >(), toVector(Coord<3>(DIM, 1, 1)));
+        eval(SparseMatrixVectorMultiplicationStencil<Cell, 3, SellCSigmaMatrixFreeContainer<double, C, BandedStencilWeights<3> > >(), toVector(Coord<3>(DIM, 1, 1)));
+    }
+
+    // block SpMV: k vectors per traversal of the weights
+    {
+        const int DIM = 1 << 20;
+        eval(SparseMatrixVectorMultiplicationBlock<1, 3>(), toVector(Coord<3>(DIM, 1, 1)));
+        eval(SparseMatrixVectorMultiplicationBlock<2, 3>(), toVector(Coord<3>(DIM, 1, 1)));
+        eval(SparseMatrixVectorMultiplicationBlock<4, 3>(), toVector(Coord<3>(DIM, 1, 1)));
+        eval(SparseMatrixVectorMultiplicationBlock<8, 3>(), toVector(Coord<3>(DIM, 1, 1)));
+    }
+
     // matrix: RM07R
     {
         const int NZ  = 37464962;
@@ -906,6 +1260,7 @@ int main(int argc, char **argv)
         const int DIM = 2063494;
 
         SPMVM_TESTS(SparseMatrixVectorMultiplicationMM, KKT);
+        SPMVM_BACKEND_TESTS(SparseMatrixVectorMultiplicationMM, KKT, 128);
 
 #ifdef __AVX__
         SPMVM_TESTS(SparseMatrixVectorMultiplicationMMNative, KKT);
@@ -924,6 +1279,7 @@ int main(int argc, char **argv)
         const int DIM = 1447360;
 
         SPMVM_TESTS(SparseMatrixVectorMultiplicationMM, HAM);
+        SPMVM_BACKEND_TESTS(SparseMatrixVectorMultiplicationMM, HAM, 128);
 
 #ifdef __AVX__
         SPMVM_TESTS(SparseMatrixVectorMultiplicationMMNative, HAM);
@@ -942,6 +1298,7 @@ int main(int argc, char **argv)
         const int DIM = 1504002;
 
         SPMVM_TESTS(SparseMatrixVectorMultiplicationMM, ML);
+        SPMVM_BACKEND_TESTS(SparseMatrixVectorMultiplicationMM, ML, 128);
 
 #ifdef __AVX__
         SPMVM_TESTS(SparseMatrixVectorMultiplicationMMNative, ML);